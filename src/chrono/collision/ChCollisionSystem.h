@@ -15,6 +15,9 @@
 #ifndef CH_COLLISIONSYSTEM_H
 #define CH_COLLISIONSYSTEM_H
 
+#include <cassert>
+#include <vector>
+
 #include "chrono/collision/ChCollisionInfo.h"
 #include "chrono/core/ChApiCE.h"
 #include "chrono/core/ChFrame.h"
@@ -49,6 +52,20 @@ class ChApi ChCollisionSystem {
     /// engine (custom data may be deallocated).
     virtual void Remove(ChCollisionModel* model) = 0;
 
+    /// Adds a set of collision models to the collision engine.
+    /// The default implementation adds the models one at a time.
+    virtual void AddModels(const std::vector<ChCollisionModel*>& models) {
+        for (auto model : models)
+            Add(model);
+    }
+
+    /// Removes a set of collision models from the collision engine.
+    /// The default implementation removes the models one at a time.
+    virtual void RemoveModels(const std::vector<ChCollisionModel*>& models) {
+        for (auto model : models)
+            Remove(model);
+    }
+
     /// Removes all collision models from the collision
     /// engine (custom data may be deallocated).
     // virtual void RemoveAll() = 0;
@@ -149,6 +166,24 @@ class ChApi ChCollisionSystem {
                         ChCollisionModel* model,
                         ChRayhitResult& mresult) const = 0;
 
+    /// Perform a batch of ray-hit tests with the collision models.
+    /// The i-th ray goes from from[i] to to[i]; its result is returned in results[i] (resized as needed).
+    /// Return the number of rays that hit a collision model.
+    /// This default implementation performs the ray-hit tests in sequence. Derived classes may override it to
+    /// process the rays in parallel.
+    virtual int RayHitBatch(const std::vector<ChVector<>>& from,
+                            const std::vector<ChVector<>>& to,
+                            std::vector<ChRayhitResult>& results) const {
+        assert(from.size() == to.size());
+        results.resize(from.size());
+        int num_hits = 0;
+        for (size_t i = 0; i < from.size(); i++) {
+            if (RayHit(from[i], to[i], results[i]))
+                num_hits++;
+        }
+        return num_hits;
+    }
+
     /// Method to allow serialization of transient data to archives.
     virtual void ArchiveOUT(ChArchiveOut& marchive) {
         // version number
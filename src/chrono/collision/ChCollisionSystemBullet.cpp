@@ -12,6 +12,9 @@
 // Authors: Alessandro Tasora
 // =============================================================================
 
+#include <algorithm>
+#include <unordered_set>
+
 #include "chrono/collision/ChCollisionSystemBullet.h"
 #include "chrono/collision/ChCollisionModelBullet.h"
 #include "chrono/collision/gimpact/GIMPACT/Bullet/btGImpactCollisionAlgorithm.h"
@@ -25,8 +28,10 @@
 #include "chrono/collision/bullet/BulletCollision/CollisionShapes/bt2DShape.h"
 #include "chrono/collision/bullet/BulletCollision/CollisionShapes/btCEtriangleShape.h"
 #include "chrono/collision/bullet/BulletCollision/CollisionDispatch/btEmptyCollisionAlgorithm.h"
+#include "chrono/parallel/ChOpenMP.h"
 
 extern btScalar gContactBreakingThreshold;
+extern thread_local int gNumManifold;
 
 namespace chrono {
 namespace collision {
@@ -1179,11 +1184,247 @@ class btCEtriangleShapeCollisionAlgorithm : public btActivatingCollisionAlgorith
 ////////////////////////////////////
 ////////////////////////////////////
 
-ChCollisionSystemBullet::ChCollisionSystemBullet(unsigned int max_objects, double scene_size) {
+// Collision dispatcher with optional multithreaded processing of the overlapping pairs.
+// Collision algorithms are created serially; pairs that can be processed concurrently (both shapes convex, or handled
+// by the custom 2D algorithms) are then dispatched to the threads, while all other pairs are processed serially
+// (compound and concave algorithms temporarily replace the shape of the collision object being processed).
+// Manifolds created during the parallel phase are allocated from per-thread pools and appended to the manifold array
+// after the parallel phase, ordered by pair index if deterministic ordering is requested.
+class btCollisionDispatcherMt : public btCollisionDispatcher {
+  public:
+    btCollisionDispatcherMt(btCollisionConfiguration* configuration)
+        : btCollisionDispatcher(configuration), m_num_threads(1), m_deterministic(false), m_parallel_phase(false) {}
+
+    virtual ~btCollisionDispatcherMt() {
+        for (auto& data : m_thread_data)
+            delete data.pool;
+    }
+
+    void setNumThreads(int nthreads) {
+        m_num_threads = nthreads;
+        // existing thread pools are kept, so that manifolds allocated from them can still be released
+        if ((int)m_thread_data.size() < nthreads)
+            m_thread_data.resize(nthreads);
+    }
+
+    void setDeterministic(bool val) { m_deterministic = val; }
+
+    virtual btPersistentManifold* getNewManifold(void* b0, void* b1) override {
+        if (!m_parallel_phase)
+            return btCollisionDispatcher::getNewManifold(b0, b1);
+
+        btCollisionObject* body0 = (btCollisionObject*)b0;
+        btCollisionObject* body1 = (btCollisionObject*)b1;
+
+        btScalar contactBreakingThreshold =
+            (m_dispatcherFlags & btCollisionDispatcher::CD_USE_RELATIVE_CONTACT_BREAKING_THRESHOLD)
+                ? btMin(body0->getCollisionShape()->getContactBreakingThreshold(gContactBreakingThreshold),
+                        body1->getCollisionShape()->getContactBreakingThreshold(gContactBreakingThreshold))
+                : gContactBreakingThreshold;
+        btScalar contactProcessingThreshold =
+            btMin(body0->getContactProcessingThreshold(), body1->getContactProcessingThreshold());
+
+        // Allocate from the pool of the calling thread; the manifold is registered after the parallel phase
+        ThreadData& data = m_thread_data[CHOMPfunctions::GetThreadNum()];
+        if (!data.pool)
+            data.pool = new btPoolAllocator(sizeof(btPersistentManifold), thread_pool_size);
+        void* mem = data.pool->getFreeCount() ? data.pool->allocate(sizeof(btPersistentManifold))
+                                              : btAlignedAlloc(sizeof(btPersistentManifold), 16);
+
+        btPersistentManifold* manifold = new (mem)
+            btPersistentManifold(body0, body1, 0, contactBreakingThreshold, contactProcessingThreshold);
+        data.new_manifolds.push_back(std::make_pair(data.current_pair, manifold));
+        return manifold;
+    }
+
+    // Note: manifolds are not released while processing convex pairs, so thread pools are only freed serially.
+    virtual void releaseManifold(btPersistentManifold* manifold) override {
+        CHOMPscopedLock lock(m_mutex);
+        for (auto& data : m_thread_data) {
+            if (data.pool && data.pool->validPtr(manifold)) {
+                gNumManifold--;
+                clearManifold(manifold);
+                int findIndex = manifold->m_index1a;
+                m_manifoldsPtr.swap(findIndex, m_manifoldsPtr.size() - 1);
+                m_manifoldsPtr[findIndex]->m_index1a = findIndex;
+                m_manifoldsPtr.pop_back();
+                manifold->~btPersistentManifold();
+                data.pool->freeMemory(manifold);
+                return;
+            }
+        }
+        btCollisionDispatcher::releaseManifold(manifold);
+    }
+
+    virtual void* allocateCollisionAlgorithm(int size) override {
+        CHOMPscopedLock lock(m_mutex);
+        return btCollisionDispatcher::allocateCollisionAlgorithm(size);
+    }
+
+    virtual void freeCollisionAlgorithm(void* ptr) override {
+        CHOMPscopedLock lock(m_mutex);
+        btCollisionDispatcher::freeCollisionAlgorithm(ptr);
+    }
+
+    virtual void dispatchAllCollisionPairs(btOverlappingPairCache* pairCache,
+                                           const btDispatcherInfo& dispatchInfo,
+                                           btDispatcher* dispatcher) override {
+        if (m_num_threads < 2 || getNearCallback() != defaultNearCallback ||
+            dispatchInfo.m_dispatchFunc != btDispatcherInfo::DISPATCH_DISCRETE) {
+            btCollisionDispatcher::dispatchAllCollisionPairs(pairCache, dispatchInfo, dispatcher);
+            return;
+        }
+
+        btBroadphasePairArray& pairs = pairCache->getOverlappingPairArray();
+        int num_pairs = pairs.size();
+
+        // Serial pass: create missing collision algorithms, process pairs that cannot be processed concurrently
+        m_parallel_pairs.clear();
+        for (int i = 0; i < num_pairs; i++) {
+            btBroadphasePair& pair = pairs[i];
+            btCollisionObject* colObj0 = (btCollisionObject*)pair.m_pProxy0->m_clientObject;
+            btCollisionObject* colObj1 = (btCollisionObject*)pair.m_pProxy1->m_clientObject;
+            if (!needsCollision(colObj0, colObj1))
+                continue;
+            if (!pair.m_algorithm)
+                pair.m_algorithm = findAlgorithm(colObj0, colObj1);
+            if (!pair.m_algorithm)
+                continue;
+            if (isThreadSafe(colObj0) && isThreadSafe(colObj1)) {
+                m_parallel_pairs.push_back(i);
+            } else {
+                btManifoldResult contactPointResult(colObj0, colObj1);
+                pair.m_algorithm->processCollision(colObj0, colObj1, dispatchInfo, &contactPointResult);
+            }
+        }
+
+        // Parallel pass over the remaining pairs
+        int num_parallel = (int)m_parallel_pairs.size();
+        m_parallel_phase = true;
+
+#pragma omp parallel num_threads(m_num_threads)
+        {
+            int nthreads = CHOMPfunctions::GetNumThreads();
+            int tid = CHOMPfunctions::GetThreadNum();
+            if (m_deterministic) {
+                int start = (int)(((long long)num_parallel * tid) / nthreads);
+                int end = (int)(((long long)num_parallel * (tid + 1)) / nthreads);
+                for (int k = start; k < end; k++)
+                    processPair(pairs[m_parallel_pairs[k]], m_parallel_pairs[k], dispatchInfo);
+            } else {
+#pragma omp for schedule(dynamic, 64)
+                for (int k = 0; k < num_parallel; k++)
+                    processPair(pairs[m_parallel_pairs[k]], m_parallel_pairs[k], dispatchInfo);
+            }
+        }
+
+        m_parallel_phase = false;
+
+        // Register the manifolds created during the parallel pass
+        m_new_manifolds.clear();
+        for (auto& data : m_thread_data) {
+            m_new_manifolds.insert(m_new_manifolds.end(), data.new_manifolds.begin(), data.new_manifolds.end());
+            data.new_manifolds.clear();
+        }
+        if (m_deterministic)
+            std::sort(m_new_manifolds.begin(), m_new_manifolds.end(),
+                      [](const std::pair<int, btPersistentManifold*>& a,
+                         const std::pair<int, btPersistentManifold*>& b) { return a.first < b.first; });
+        for (auto& entry : m_new_manifolds) {
+            entry.second->m_index1a = m_manifoldsPtr.size();
+            m_manifoldsPtr.push_back(entry.second);
+        }
+        gNumManifold += (int)m_new_manifolds.size();
+    }
+
+  private:
+    static const int thread_pool_size = 1024;
+
+    struct ThreadData {
+        ThreadData() : pool(nullptr), current_pair(0) {}
+        btPoolAllocator* pool;                                              // manifold pool of this thread
+        std::vector<std::pair<int, btPersistentManifold*>> new_manifolds;  // manifolds created in the parallel pass
+        int current_pair;                                                   // index of the pair being processed
+    };
+
+    // Return true if pairs involving this object can be processed concurrently with other pairs.
+    static bool isThreadSafe(btCollisionObject* obj) {
+        int type = obj->getCollisionShape()->getShapeType();
+        return btBroadphaseProxy::isConvex(type) || type == ARC_SHAPE_PROXYTYPE || type == SEGMENT_SHAPE_PROXYTYPE;
+    }
+
+    void processPair(btBroadphasePair& pair, int index, const btDispatcherInfo& dispatchInfo) {
+        m_thread_data[CHOMPfunctions::GetThreadNum()].current_pair = index;
+        btCollisionObject* colObj0 = (btCollisionObject*)pair.m_pProxy0->m_clientObject;
+        btCollisionObject* colObj1 = (btCollisionObject*)pair.m_pProxy1->m_clientObject;
+        btManifoldResult contactPointResult(colObj0, colObj1);
+        pair.m_algorithm->processCollision(colObj0, colObj1, dispatchInfo, &contactPointResult);
+    }
+
+    int m_num_threads;
+    bool m_deterministic;
+    bool m_parallel_phase;
+    CHOMPmutex m_mutex;
+    std::vector<ThreadData> m_thread_data;
+    std::vector<int> m_parallel_pairs;
+    std::vector<std::pair<int, btPersistentManifold*>> m_new_manifolds;
+};
+
+// Collision world with optional multithreaded update of the AABBs.
+// The AABBs are computed in parallel, then passed to the broadphase serially.
+class btCollisionWorldMt : public btCollisionWorld {
+  public:
+    btCollisionWorldMt(btDispatcher* dispatcher,
+                       btBroadphaseInterface* broadphase,
+                       btCollisionConfiguration* configuration)
+        : btCollisionWorld(dispatcher, broadphase, configuration), m_num_threads(1) {}
+
+    void setNumThreads(int nthreads) { m_num_threads = nthreads; }
+
+    virtual void updateAabbs() override {
+        if (m_num_threads < 2) {
+            btCollisionWorld::updateAabbs();
+            return;
+        }
+
+        int num_objects = m_collisionObjects.size();
+        m_aabbMin.resize(num_objects);
+        m_aabbMax.resize(num_objects);
+
+#pragma omp parallel for num_threads(m_num_threads) schedule(static)
+        for (int i = 0; i < num_objects; i++) {
+            btCollisionObject* colObj = m_collisionObjects[i];
+            if (m_forceUpdateAllAabbs || colObj->isActive())
+                colObj->getCollisionShape()->getAabb(colObj->getWorldTransform(), m_aabbMin[i], m_aabbMax[i]);
+        }
+
+        btBroadphaseInterface* bp = m_broadphasePairCache;
+        for (int i = 0; i < num_objects; i++) {
+            btCollisionObject* colObj = m_collisionObjects[i];
+            if (!m_forceUpdateAllAabbs && !colObj->isActive())
+                continue;
+            if (colObj->isStaticObject() || (m_aabbMax[i] - m_aabbMin[i]).length2() < btScalar(1e12))
+                bp->setAabb(colObj->getBroadphaseHandle(), m_aabbMin[i], m_aabbMax[i], m_dispatcher1);
+            else
+                updateSingleAabb(colObj);  // let Bullet deal with the overflow
+        }
+    }
+
+  private:
+    int m_num_threads;
+    btAlignedObjectArray<btVector3> m_aabbMin;
+    btAlignedObjectArray<btVector3> m_aabbMax;
+};
+
+////////////////////////////////////
+////////////////////////////////////
+
+ChCollisionSystemBullet::ChCollisionSystemBullet(unsigned int max_objects, double scene_size)
+    : m_num_threads(1), m_deterministic(false) {
     // btDefaultCollisionConstructionInfo conf_info(...); ***TODO***
     bt_collision_configuration = new btDefaultCollisionConfiguration();
 
-    bt_dispatcher = new btCollisionDispatcher(bt_collision_configuration);
+    bt_dispatcher = new btCollisionDispatcherMt(bt_collision_configuration);
     //((btDefaultCollisionConfiguration*)bt_collision_configuration)->setConvexConvexMultipointIterations(4,4);
 
     //***OLD***
@@ -1196,7 +1437,7 @@ ChCollisionSystemBullet::ChCollisionSystemBullet(unsigned int max_objects, doubl
     //***NEW***
     bt_broadphase = new btDbvtBroadphase();
 
-    bt_collision_world = new btCollisionWorld(bt_dispatcher, bt_broadphase, bt_collision_configuration);
+    bt_collision_world = new btCollisionWorldMt(bt_dispatcher, bt_broadphase, bt_collision_configuration);
 
     // custom collision for sphere-sphere case ***OBSOLETE*** // already registered by btDefaultCollisionConfiguration
     // bt_dispatcher->registerCollisionCreateFunc(SPHERE_SHAPE_PROXYTYPE,SPHERE_SHAPE_PROXYTYPE,new
@@ -1282,6 +1523,51 @@ void ChCollisionSystemBullet::Remove(ChCollisionModel* model) {
     }
 }
 
+void ChCollisionSystemBullet::RemoveModels(const std::vector<ChCollisionModel*>& models) {
+    std::vector<btBroadphaseProxy*> proxies;
+    std::unordered_set<btCollisionObject*> removed;
+    proxies.reserve(models.size());
+    removed.reserve(models.size());
+
+    for (auto model : models) {
+        auto bt_object = static_cast<ChCollisionModelBullet*>(model)->GetBulletModel();
+        if (!bt_object->getCollisionShape())
+            continue;
+        if (auto proxy = bt_object->getBroadphaseHandle()) {
+            proxies.push_back(proxy);
+            bt_object->setBroadphaseHandle(0);
+        }
+        removed.insert(bt_object);
+    }
+
+    if (removed.empty())
+        return;
+
+    // Destroy the broadphase proxies, together with all their overlapping pairs
+    static_cast<btDbvtBroadphase*>(bt_broadphase)
+        ->destroyProxies(proxies.data(), (int)proxies.size(), bt_collision_world->getDispatcher());
+
+    // Compact the array of collision objects (preserving the order of the remaining objects)
+    btCollisionObjectArray& objects = bt_collision_world->getCollisionObjectArray();
+    int num_objects = 0;
+    for (int i = 0; i < objects.size(); i++) {
+        if (removed.find(objects[i]) == removed.end())
+            objects[num_objects++] = objects[i];
+    }
+    objects.resize(num_objects);
+}
+
+void ChCollisionSystemBullet::SetNumThreads(int nthreads) {
+    m_num_threads = std::max(nthreads, 1);
+    static_cast<btCollisionDispatcherMt*>(bt_dispatcher)->setNumThreads(m_num_threads);
+    static_cast<btCollisionWorldMt*>(bt_collision_world)->setNumThreads(m_num_threads);
+}
+
+void ChCollisionSystemBullet::SetDeterministic(bool val) {
+    m_deterministic = val;
+    static_cast<btCollisionDispatcherMt*>(bt_dispatcher)->setDeterministic(val);
+}
+
 void ChCollisionSystemBullet::Run() {
     if (bt_collision_world) {
         bt_collision_world->performDiscreteCollisionDetection();
@@ -1301,7 +1587,43 @@ double ChCollisionSystemBullet::GetTimerCollisionNarrow() const {
     return bt_collision_world->timer_collision_narrow();
 }
 
+// Fill the collision information for the given manifold point (the collision models must already be set).
+static void ConvertContactPoint(btManifoldPoint& pt,
+                                double envelopeA,
+                                double envelopeB,
+                                bool compoundA,
+                                bool compoundB,
+                                ChCollisionInfo& icontact) {
+    btVector3 ptA = pt.getPositionWorldOnA();
+    btVector3 ptB = pt.getPositionWorldOnB();
+
+    icontact.vpA.Set(ptA.getX(), ptA.getY(), ptA.getZ());
+    icontact.vpB.Set(ptB.getX(), ptB.getY(), ptB.getZ());
+
+    icontact.vN.Set(-pt.m_normalWorldOnB.getX(), -pt.m_normalWorldOnB.getY(), -pt.m_normalWorldOnB.getZ());
+    icontact.vN.Normalize();
+
+    double ptdist = pt.getDistance();
+
+    icontact.vpA = icontact.vpA - icontact.vN * envelopeA;
+    icontact.vpB = icontact.vpB + icontact.vN * envelopeB;
+    icontact.distance = ptdist + envelopeA + envelopeB;
+
+    icontact.reaction_cache = pt.reactions_cache;
+
+    int indexA = compoundA ? pt.m_index0 : 0;
+    int indexB = compoundB ? pt.m_index1 : 0;
+
+    icontact.shapeA = icontact.modelA->GetShape(indexA).get();
+    icontact.shapeB = icontact.modelB->GetShape(indexB).get();
+}
+
 void ChCollisionSystemBullet::ReportContacts(ChContactContainer* mcontactcontainer) {
+    if (m_num_threads > 1) {
+        ReportContactsParallel(mcontactcontainer);
+        return;
+    }
+
     // This should remove all old contacts (or at least rewind the index)
     mcontactcontainer->BeginAddContact();
 
@@ -1325,6 +1647,9 @@ void ChCollisionSystemBullet::ReportContacts(ChContactContainer* mcontactcontain
         double marginA = icontact.modelA->GetSafeMargin();
         double marginB = icontact.modelB->GetSafeMargin();
 
+        bool compoundA = (obA->getRootCollisionShape()->getShapeType() == COMPOUND_SHAPE_PROXYTYPE);
+        bool compoundB = (obB->getRootCollisionShape()->getShapeType() == COMPOUND_SHAPE_PROXYTYPE);
+
         // Execute custom broadphase callback, if any
         bool do_narrow_contactgeneration = true;
         if (this->broad_callback)
@@ -1338,32 +1663,7 @@ void ChCollisionSystemBullet::ReportContacts(ChContactContainer* mcontactcontain
 
                 // Discard "too far" constraints (the Bullet engine also has its threshold)
                 if (pt.getDistance() < marginA + marginB) {
-                    btVector3 ptA = pt.getPositionWorldOnA();
-                    btVector3 ptB = pt.getPositionWorldOnB();
-
-                    icontact.vpA.Set(ptA.getX(), ptA.getY(), ptA.getZ());
-                    icontact.vpB.Set(ptB.getX(), ptB.getY(), ptB.getZ());
-
-                    icontact.vN.Set(-pt.m_normalWorldOnB.getX(), -pt.m_normalWorldOnB.getY(),
-                                    -pt.m_normalWorldOnB.getZ());
-                    icontact.vN.Normalize();
-
-                    double ptdist = pt.getDistance();
-
-                    icontact.vpA = icontact.vpA - icontact.vN * envelopeA;
-                    icontact.vpB = icontact.vpB + icontact.vN * envelopeB;
-                    icontact.distance = ptdist + envelopeA + envelopeB;
-
-                    icontact.reaction_cache = pt.reactions_cache;
-
-                    bool compoundA = (obA->getRootCollisionShape()->getShapeType() == COMPOUND_SHAPE_PROXYTYPE);
-                    bool compoundB = (obB->getRootCollisionShape()->getShapeType() == COMPOUND_SHAPE_PROXYTYPE);
-
-                    int indexA = compoundA ? pt.m_index0 : 0;
-                    int indexB = compoundB ? pt.m_index1 : 0;
-
-                    icontact.shapeA = icontact.modelA->GetShape(indexA).get();
-                    icontact.shapeB = icontact.modelB->GetShape(indexB).get();
+                    ConvertContactPoint(pt, envelopeA, envelopeB, compoundA, compoundB, icontact);
 
                     // Execute some user custom callback, if any
                     bool add_contact = true;
@@ -1387,6 +1687,97 @@ void ChCollisionSystemBullet::ReportContacts(ChContactContainer* mcontactcontain
     mcontactcontainer->EndAddContact();
 }
 
+void ChCollisionSystemBullet::GenerateContacts(int start, int end, ContactBuffer& buffer) {
+    ChCollisionInfo icontact;
+
+    for (int i = start; i < end; i++) {
+        btPersistentManifold* contactManifold = bt_collision_world->getDispatcher()->getManifoldByIndexInternal(i);
+        btCollisionObject* obA = static_cast<btCollisionObject*>(contactManifold->getBody0());
+        btCollisionObject* obB = static_cast<btCollisionObject*>(contactManifold->getBody1());
+        contactManifold->refreshContactPoints(obA->getWorldTransform(), obB->getWorldTransform());
+
+        icontact.modelA = (ChCollisionModel*)obA->getUserPointer();
+        icontact.modelB = (ChCollisionModel*)obB->getUserPointer();
+
+        double envelopeA = icontact.modelA->GetEnvelope();
+        double envelopeB = icontact.modelB->GetEnvelope();
+
+        double marginA = icontact.modelA->GetSafeMargin();
+        double marginB = icontact.modelB->GetSafeMargin();
+
+        bool compoundA = (obA->getRootCollisionShape()->getShapeType() == COMPOUND_SHAPE_PROXYTYPE);
+        bool compoundB = (obB->getRootCollisionShape()->getShapeType() == COMPOUND_SHAPE_PROXYTYPE);
+
+        int num_contacts = 0;
+        int numContacts = contactManifold->getNumContacts();
+        for (int j = 0; j < numContacts; j++) {
+            btManifoldPoint& pt = contactManifold->getContactPoint(j);
+            if (pt.getDistance() < marginA + marginB) {
+                ConvertContactPoint(pt, envelopeA, envelopeB, compoundA, compoundB, icontact);
+                buffer.contacts.push_back(icontact);
+                num_contacts++;
+            }
+        }
+
+        ContactBuffer::Manifold manifold = {icontact.modelA, icontact.modelB, num_contacts};
+        buffer.manifolds.push_back(manifold);
+    }
+}
+
+void ChCollisionSystemBullet::ReportContactsParallel(ChContactContainer* mcontactcontainer) {
+    int numManifolds = bt_collision_world->getDispatcher()->getNumManifolds();
+
+    if ((int)m_thread_buffers.size() < m_num_threads)
+        m_thread_buffers.resize(m_num_threads);
+    for (auto& buffer : m_thread_buffers) {
+        buffer.manifolds.clear();
+        buffer.contacts.clear();
+    }
+
+    // Generate the contacts of all manifolds in the per-thread buffers
+#pragma omp parallel num_threads(m_num_threads)
+    {
+        int nthreads = CHOMPfunctions::GetNumThreads();
+        int tid = CHOMPfunctions::GetThreadNum();
+        ContactBuffer& buffer = m_thread_buffers[tid];
+        if (m_deterministic) {
+            int start = (int)(((long long)numManifolds * tid) / nthreads);
+            int end = (int)(((long long)numManifolds * (tid + 1)) / nthreads);
+            GenerateContacts(start, end, buffer);
+        } else {
+#pragma omp for schedule(dynamic, 64)
+            for (int i = 0; i < numManifolds; i++)
+                GenerateContacts(i, i + 1, buffer);
+        }
+    }
+
+    // Merge the per-thread buffers into the contact container, invoking the user callbacks (if any)
+    mcontactcontainer->BeginAddContact();
+
+    for (auto& buffer : m_thread_buffers) {
+        auto contact = buffer.contacts.begin();
+        for (const auto& manifold : buffer.manifolds) {
+            bool do_narrow_contactgeneration = true;
+            if (this->broad_callback)
+                do_narrow_contactgeneration = this->broad_callback->OnBroadphase(manifold.modelA, manifold.modelB);
+
+            if (do_narrow_contactgeneration) {
+                for (int j = 0; j < manifold.num_contacts; j++) {
+                    bool add_contact = true;
+                    if (this->narrow_callback)
+                        add_contact = this->narrow_callback->OnNarrowphase(contact[j]);
+                    if (add_contact)
+                        mcontactcontainer->AddContact(contact[j]);
+                }
+            }
+
+            contact += manifold.num_contacts;
+        }
+    }
+
+    mcontactcontainer->EndAddContact();
+}
+
 void ChCollisionSystemBullet::ReportProximities(ChProximityContainer* mproximitycontainer) {
     mproximitycontainer->BeginAddProximities();
     /*
@@ -1421,6 +1812,53 @@ void ChCollisionSystemBullet::ReportProximities(ChProximityContainer* mproximity
     mproximitycontainer->EndAddProximities();
 }
 
+// Fill a Chrono ray-hit result from the result of a Bullet closest-hit ray test.
+static bool ConvertRayResult(const btCollisionWorld::ClosestRayResultCallback& rayCallback,
+                             ChCollisionSystem::ChRayhitResult& mresult) {
+    if (rayCallback.hasHit()) {
+        mresult.hitModel = (ChCollisionModel*)(rayCallback.m_collisionObject->getUserPointer());
+        if (mresult.hitModel) {
+            mresult.hit = true;
+            mresult.abs_hitPoint.Set(rayCallback.m_hitPointWorld.x(), rayCallback.m_hitPointWorld.y(),
+                                     rayCallback.m_hitPointWorld.z());
+            mresult.abs_hitNormal.Set(rayCallback.m_hitNormalWorld.x(), rayCallback.m_hitNormalWorld.y(),
+                                      rayCallback.m_hitNormalWorld.z());
+            mresult.abs_hitNormal.Normalize();
+            mresult.dist_factor = rayCallback.m_closestHitFraction;
+            mresult.abs_hitPoint = mresult.abs_hitPoint - mresult.abs_hitNormal * mresult.hitModel->GetEnvelope();
+            return true;
+        }
+    }
+    mresult.hit = false;
+    return false;
+}
+
+// Check whether ray tests against the given shape can run concurrently.
+// GImpact shapes lock and unlock their child shapes while being queried. For compound shapes, Bullet temporarily
+// replaces the shape of the collision object with each child shape (btCollisionWorld::rayTestSingle).
+static bool IsRayTestThreadSafe(const btCollisionShape* shape) {
+    return shape->getShapeType() != GIMPACT_SHAPE_PROXYTYPE && !shape->isCompound();
+}
+
+// Closest-hit ray callback for parallel ray tests.
+// Collision objects with shapes that cannot be queried concurrently are skipped and the ray is flagged as deferred.
+struct ClosestRayResultCallbackMt : public btCollisionWorld::ClosestRayResultCallback {
+    ClosestRayResultCallbackMt(const btVector3& from, const btVector3& to)
+        : btCollisionWorld::ClosestRayResultCallback(from, to), m_deferred(false) {}
+
+    virtual bool needsCollision(btBroadphaseProxy* proxy0) const override {
+        if (!btCollisionWorld::ClosestRayResultCallback::needsCollision(proxy0))
+            return false;
+        auto object = static_cast<btCollisionObject*>(proxy0->m_clientObject);
+        if (IsRayTestThreadSafe(object->getCollisionShape()))
+            return true;
+        m_deferred = true;
+        return false;
+    }
+
+    mutable bool m_deferred;
+};
+
 bool ChCollisionSystemBullet::RayHit(const ChVector<>& from, const ChVector<>& to, ChRayhitResult& mresult) const {
     return RayHit(from, to, mresult, btBroadphaseProxy::DefaultFilter, btBroadphaseProxy::AllFilter);
 }
@@ -1439,23 +1877,47 @@ bool ChCollisionSystemBullet::RayHit(const ChVector<>& from,
 
     this->bt_collision_world->rayTest(btfrom, btto, rayCallback);
 
-    if (rayCallback.hasHit()) {
-        mresult.hitModel = (ChCollisionModel*)(rayCallback.m_collisionObject->getUserPointer());
-        if (mresult.hitModel) {
-            mresult.hit = true;
-            mresult.abs_hitPoint.Set(rayCallback.m_hitPointWorld.x(), rayCallback.m_hitPointWorld.y(),
-                                     rayCallback.m_hitPointWorld.z());
-            mresult.abs_hitNormal.Set(rayCallback.m_hitNormalWorld.x(), rayCallback.m_hitNormalWorld.y(),
-                                      rayCallback.m_hitNormalWorld.z());
-            mresult.abs_hitNormal.Normalize();
-            mresult.hit = true;
-            mresult.dist_factor = rayCallback.m_closestHitFraction;
-            mresult.abs_hitPoint = mresult.abs_hitPoint - mresult.abs_hitNormal * mresult.hitModel->GetEnvelope();
-            return true;
+    return ConvertRayResult(rayCallback, mresult);
+}
+
+int ChCollisionSystemBullet::RayHitBatch(const std::vector<ChVector<>>& from,
+                                         const std::vector<ChVector<>>& to,
+                                         std::vector<ChRayhitResult>& results) const {
+    if (m_num_threads <= 1)
+        return ChCollisionSystem::RayHitBatch(from, to, results);
+
+    assert(from.size() == to.size());
+    int num_rays = (int)from.size();
+    results.resize(num_rays);
+
+    // Flags for rays to be re-tested serially
+    std::vector<char> deferred(num_rays, 0);
+
+    int num_hits = 0;
+
+#pragma omp parallel for num_threads(m_num_threads) schedule(dynamic, 256) reduction(+ : num_hits)
+    for (int i = 0; i < num_rays; i++) {
+        btVector3 btfrom((btScalar)from[i].x(), (btScalar)from[i].y(), (btScalar)from[i].z());
+        btVector3 btto((btScalar)to[i].x(), (btScalar)to[i].y(), (btScalar)to[i].z());
+
+        ClosestRayResultCallbackMt rayCallback(btfrom, btto);
+        this->bt_collision_world->rayTest(btfrom, btto, rayCallback);
+
+        if (rayCallback.m_deferred) {
+            deferred[i] = 1;
+            continue;
         }
+
+        if (ConvertRayResult(rayCallback, results[i]))
+            num_hits++;
     }
-    mresult.hit = false;
-    return false;
+
+    for (int i = 0; i < num_rays; i++) {
+        if (deferred[i] && RayHit(from[i], to[i], results[i]))
+            num_hits++;
+    }
+
+    return num_hits;
 }
 
 bool ChCollisionSystemBullet::RayHit(const ChVector<>& from,
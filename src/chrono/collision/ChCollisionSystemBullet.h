@@ -15,6 +15,8 @@
 #ifndef CH_COLLISION_SYSTEM_BULLET_H
 #define CH_COLLISION_SYSTEM_BULLET_H
 
+#include <vector>
+
 #include "chrono/collision/ChCollisionSystem.h"
 #include "chrono/collision/bullet/btBulletCollisionCommon.h"
 #include "chrono/core/ChApiCE.h"
@@ -42,6 +44,12 @@ class ChApi ChCollisionSystemBullet : public ChCollisionSystem {
     /// engine (custom data may be deallocated).
     virtual void Remove(ChCollisionModel* model) override;
 
+    /// Removes a set of collision models from the collision engine.
+    /// The overlapping pairs of all models are cleared in a single pass over the broadphase pair cache and the
+    /// world's object array is compacted once, so that the cost does not grow with the product of the number of
+    /// removed models and the number of collision objects.
+    virtual void RemoveModels(const std::vector<ChCollisionModel*>& models) override;
+
     /// Removes all collision models from the collision
     /// engine (custom data may be deallocated).
     // virtual void RemoveAll();
@@ -50,6 +58,30 @@ class ChApi ChCollisionSystemBullet : public ChCollisionSystem {
     /// (Contacts will be managed by the Bullet persistent contact cache).
     virtual void Run() override;
 
+    /// Set the number of threads used for collision detection (default: 1).
+    /// With more than one thread, the AABB update, the narrowphase processing of the overlapping pairs, and the
+    /// generation of contacts in ReportContacts() run in parallel. Each thread allocates new contact manifolds from
+    /// its own pool and writes contacts in its own buffer; the buffers are then merged into the contact container.
+    /// Pairs involving compound or concave shapes (e.g. triangle meshes) are always processed serially, since Bullet
+    /// temporarily modifies the collision objects while processing them. The user broadphase and narrowphase
+    /// callbacks are always invoked serially, during the merge.
+    void SetNumThreads(int nthreads);
+
+    /// Get the number of threads used for collision detection.
+    int GetNumThreads() const { return m_num_threads; }
+
+    /// Enable/disable deterministic ordering in parallel mode (default: false).
+    /// If enabled, work is split in contiguous ranges and per-thread results are merged in a fixed order, so that
+    /// contact manifolds and contacts are reported in an order independent of the number of threads. Note that this
+    /// order differs from the one obtained with a single thread (manifolds of pairs processed in the serial pass, e.g.
+    /// those involving compound or concave shapes, are registered before the manifolds created in the parallel pass).
+    /// If disabled, work is scheduled dynamically for better load balancing, and the order of the reported contacts
+    /// may vary from run to run.
+    void SetDeterministic(bool val);
+
+    /// Return true if deterministic ordering is enabled in parallel mode.
+    bool IsDeterministic() const { return m_deterministic; }
+
     /// Reset timers for collision detection.
     virtual void ResetTimers() override;
 
@@ -88,6 +120,14 @@ class ChApi ChCollisionSystemBullet : public ChCollisionSystem {
                 short int filter_group,
                 short int filter_mask) const;
 
+    /// Perform a batch of ray-hit tests with all collision models.
+    /// If more than one thread is used for collision detection (see SetNumThreads), the rays are processed in
+    /// parallel. Rays that may hit GImpact triangle meshes or compound shapes (collision models with more than one
+    /// shape), which cannot be queried concurrently, are re-tested serially after the parallel pass.
+    virtual int RayHitBatch(const std::vector<ChVector<>>& from,
+                            const std::vector<ChVector<>>& to,
+                            std::vector<ChRayhitResult>& results) const override;
+
     /// Perform a ray-hit test with the specified collision model.
     virtual bool RayHit(const ChVector<>& from,
                         const ChVector<>& to,
@@ -112,6 +152,28 @@ class ChApi ChCollisionSystemBullet : public ChCollisionSystem {
     static void SetContactBreakingThreshold(double threshold);
 
   private:
+    /// Contacts generated in parallel by one thread, to be merged into the contact container.
+    struct ContactBuffer {
+        /// Contact manifold processed by the thread (its contacts are stored contiguously in the buffer).
+        struct Manifold {
+            ChCollisionModel* modelA;
+            ChCollisionModel* modelB;
+            int num_contacts;
+        };
+        std::vector<Manifold> manifolds;
+        std::vector<ChCollisionInfo> contacts;
+    };
+
+    /// Generate contacts from a range of manifolds in the given buffer (used in parallel mode).
+    void GenerateContacts(int start, int end, ContactBuffer& buffer);
+
+    /// Parallel version of ReportContacts().
+    void ReportContactsParallel(ChContactContainer* mcontactcontainer);
+
+    int m_num_threads;                           ///< number of threads for collision detection
+    bool m_deterministic;                        ///< reproducible order of manifolds and contacts in parallel mode
+    std::vector<ContactBuffer> m_thread_buffers;  ///< per-thread contact buffers (parallel mode)
+
     btCollisionConfiguration* bt_collision_configuration;
     btCollisionDispatcher* bt_dispatcher;
     btBroadphaseInterface* bt_broadphase;
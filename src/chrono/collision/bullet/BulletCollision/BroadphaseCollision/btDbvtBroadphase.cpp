@@ -16,6 +16,7 @@ subject to the following restrictions:
 ///btDbvtBroadphase implementation by Nathanael Presson
 
 #include "btDbvtBroadphase.h"
+#include "LinearMath/btHashMap.h"
 
 //
 // Profiling
@@ -203,6 +204,46 @@ void							btDbvtBroadphase::destroyProxy(	btBroadphaseProxy* absproxy,
 	m_needcleanup=true;
 }
 
+void							btDbvtBroadphase::destroyProxies(	btBroadphaseProxy** proxies,
+																int numProxies,
+																btDispatcher* dispatcher)
+{
+	class	RemovePairsCallback : public btOverlapCallback
+	{
+		const btHashMap<btHashPtr,int>&	m_obsoleteProxies;
+
+	public:
+		RemovePairsCallback(const btHashMap<btHashPtr,int>& obsoleteProxies)
+			:m_obsoleteProxies(obsoleteProxies)
+		{
+		}
+		virtual	bool	processOverlap(btBroadphasePair& pair)
+		{
+			return ((m_obsoleteProxies.find(btHashPtr(pair.m_pProxy0)) != 0) ||
+				(m_obsoleteProxies.find(btHashPtr(pair.m_pProxy1)) != 0));
+		}
+	};
+
+	btHashMap<btHashPtr,int>	obsoleteProxies;
+	for(int i=0;i<numProxies;++i)
+		obsoleteProxies.insert(btHashPtr(proxies[i]),i);
+
+	RemovePairsCallback removeCallback(obsoleteProxies);
+	m_paircache->processAllOverlappingPairs(&removeCallback,dispatcher);
+
+	for(int i=0;i<numProxies;++i)
+	{
+		btDbvtProxy*	proxy=(btDbvtProxy*)proxies[i];
+		if(proxy->stage==STAGECOUNT)
+			m_sets[1].remove(proxy->leaf);
+		else
+			m_sets[0].remove(proxy->leaf);
+		listremove(proxy,m_stageRoots[proxy->stage]);
+		btAlignedFree(proxy);
+	}
+	m_needcleanup=true;
+}
+
 void	btDbvtBroadphase::getAabb(btBroadphaseProxy* absproxy,btVector3& aabbMin, btVector3& aabbMax ) const
 {
 	btDbvtProxy*						proxy=(btDbvtProxy*)absproxy;
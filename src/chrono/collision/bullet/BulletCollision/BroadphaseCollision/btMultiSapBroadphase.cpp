@@ -22,7 +22,7 @@ subject to the following restrictions:
 ///	btSapBroadphaseArray	m_sapBroadphases;
 
 ///	btOverlappingPairCache*	m_overlappingPairs;
-extern int gOverlappingPairs;
+extern thread_local int gOverlappingPairs;
 
 /*
 class btMultiSapSortedOverlappingPairCache : public btSortedOverlappingPairCache
@@ -23,11 +23,12 @@ subject to the following restrictions:
 
 #include <stdio.h>
 
-int	gOverlappingPairs = 0;
+// Chrono: statistics counters are thread-local, so that concurrent collision systems do not race on them
+thread_local int	gOverlappingPairs = 0;
 
-int gRemovePairs =0;
-int gAddedPairs =0;
-int gFindPairs =0;
+thread_local int gRemovePairs =0;
+thread_local int gAddedPairs =0;
+thread_local int gFindPairs =0;
 
 
 
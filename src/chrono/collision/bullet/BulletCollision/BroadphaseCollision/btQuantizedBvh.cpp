@@ -107,8 +107,9 @@ btQuantizedBvh::~btQuantizedBvh()
 }
 
 #ifdef DEBUG_TREE_BUILDING
-int gStackDepth = 0;
-int gMaxStackDepth = 0;
+// Chrono: statistics counters are thread-local, so that concurrent collision systems do not race on them
+thread_local int gStackDepth = 0;
+thread_local int gMaxStackDepth = 0;
 #endif //DEBUG_TREE_BUILDING
 
 void	btQuantizedBvh::buildTree	(int startIndex,int endIndex)
@@ -24,7 +24,7 @@ subject to the following restrictions:
 
 #include <new>
 
-extern int gOverlappingPairs;
+extern thread_local int gOverlappingPairs;
 
 void	btSimpleBroadphase::validate()
 {
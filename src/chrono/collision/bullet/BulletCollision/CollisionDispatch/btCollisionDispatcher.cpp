@@ -26,7 +26,8 @@ subject to the following restrictions:
 #include "LinearMath/btPoolAllocator.h"
 #include "BulletCollision/CollisionDispatch/btCollisionConfiguration.h"
 
-int gNumManifold = 0;
+// Chrono: statistics counter is thread-local, so that concurrent collision systems do not race on it
+thread_local int gNumManifold = 0;
 
 #ifdef BT_DEBUG
 #include <stdio.h>
@@ -158,10 +158,11 @@ public:
 	static void	dumpAll();
 
 private:
-	static	CProfileNode			Root;
-	static	CProfileNode *			CurrentNode;
-	static	int						FrameCounter;
-	static	unsigned long int					ResetTime;
+	// Each thread has its own profile tree, so that independent collision worlds can be used concurrently
+	static	thread_local CProfileNode			Root;
+	static	thread_local CProfileNode *			CurrentNode;
+	static	thread_local int						FrameCounter;
+	static	thread_local unsigned long int					ResetTime;
 };
 
 
@@ -12,6 +12,7 @@
 // Authors: Alessandro Tasora
 // =============================================================================
 
+#include <atomic>
 #include <cstdlib>
 #include <iostream>
 #include <cstring>
@@ -29,20 +30,22 @@
 namespace chrono {
 
 //
-// The pointer to the global logger
+// The pointer to the global logger and to the logger of the current thread (if any)
 //
 
-static ChLog* GlobalLog = NULL;
+static std::atomic<ChLog*> GlobalLog(NULL);
+static thread_local ChLog* ThreadLog = NULL;
 
 // Functions to set/get the global logger
 
 ChLog& GetLog() {
-    if (GlobalLog != NULL)
-        return (*GlobalLog);
-    else {
-        static ChLogConsole static_cout_logger;
-        return static_cout_logger;
-    }
+    if (ThreadLog != NULL)
+        return (*ThreadLog);
+    ChLog* log = GlobalLog.load();
+    if (log != NULL)
+        return (*log);
+    static ChLogConsole static_cout_logger;
+    return static_cout_logger;
 }
 
 void SetLog(ChLog& new_logobject) {
@@ -53,6 +56,10 @@ void SetLogDefault() {
     GlobalLog = NULL;
 }
 
+void SetThreadLog(ChLog* new_logobject) {
+    ThreadLog = new_logobject;
+}
+
 //
 // Logger class
 //
@@ -114,6 +114,11 @@ ChApi void SetLog(ChLog& new_logobject);
 /// Global function to set the default ChLogConsole output to std::output.
 ChApi void SetLogDefault();
 
+/// Set a logger for the calling thread only, which then takes precedence over the global logger in GetLog().
+/// Use nullptr to revert to the global logger. This allows simulations running concurrently in different threads
+/// to keep their messages separate (see utils::ChBatchSimulator).
+ChApi void SetThreadLog(ChLog* new_logobject);
+
 }  // end namespace chrono
 
 #endif
@@ -45,21 +45,40 @@ double ChAtan2(double mcos, double msin) {
 
 static long CH_PAseed = 123;
 
+// Private seed of the calling thread, used instead of the global one if enabled (see ChSetThreadRandomSeed).
+static thread_local bool CH_PAseed_private = false;
+static thread_local long CH_PAseed_thread = 123;
+
+static long& ChRandomSeed() {
+    return CH_PAseed_private ? CH_PAseed_thread : CH_PAseed;
+}
+
 void ChSetRandomSeed(long newseed) {
-    if (CH_PAseed)
-        CH_PAseed = newseed;
+    long& seed = ChRandomSeed();
+    if (seed)
+        seed = newseed;
+}
+
+void ChSetThreadRandomSeed(long newseed) {
+    CH_PAseed_private = true;
+    CH_PAseed_thread = newseed;
+}
+
+void ChClearThreadRandomSeed() {
+    CH_PAseed_private = false;
 }
 
 double ChRandom() {
+    long& seed = ChRandomSeed();
     long k;
     double ans;
-    CH_PAseed ^= MASK;
-    k = (CH_PAseed) / IQ;
-    CH_PAseed = IA * (CH_PAseed - k * IQ) - IR * k;
-    if (CH_PAseed < 0)
-        CH_PAseed += IM;
-    ans = AM * (CH_PAseed);
-    CH_PAseed ^= MASK;
+    seed ^= MASK;
+    k = (seed) / IQ;
+    seed = IA * (seed - k * IQ) - IR * k;
+    if (seed < 0)
+        seed += IM;
+    ans = AM * (seed);
+    seed ^= MASK;
     return ans;
 }
 
@@ -49,12 +49,21 @@ ChApi double ChAtan2(double mcos, double msin);
 
 // OTHER
 
-/// Returns random value in (0..1) interval with Park-Miller method
+/// Returns random value in (0..1) interval with Park-Miller method.
+/// All threads share the same sequence, unless a thread uses a private seed (see ChSetThreadRandomSeed).
 ChApi double ChRandom();
 
-/// Sets the seed of the ChRandom function 	(Park-Miller method)
+/// Sets the seed of the ChRandom function 	(Park-Miller method).
+/// If the calling thread uses a private seed, only that seed is changed.
 ChApi void ChSetRandomSeed(long newseed);
 
+/// Use a private seed for the ChRandom function in the calling thread, starting from the given value.
+/// The values returned by ChRandom in this thread then do not depend on other threads (see utils::ChBatchSimulator).
+ChApi void ChSetThreadRandomSeed(long newseed);
+
+/// Revert the calling thread to the global seed of the ChRandom function.
+ChApi void ChClearThreadRandomSeed();
+
 /// Computes a 1D harmonic multi-octave noise
 ChApi double ChNoise(double x, double amp, double freq, int octaves, double amp_ratio);
 
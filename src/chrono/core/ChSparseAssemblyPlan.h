@@ -0,0 +1,197 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+
+#ifndef CHSPARSEASSEMBLYPLAN_H
+#define CHSPARSEASSEMBLYPLAN_H
+
+#include <algorithm>
+#include <vector>
+
+#include "chrono/core/ChMatrix.h"
+
+namespace chrono {
+
+/// @addtogroup chrono_linalg
+/// @{
+
+/// Compiled assembly plan for a sparse matrix with a fixed sparsity pattern.
+/// The plan stores, for each SetElement call issued during the assembly of a compressed row-major matrix, the index of
+/// the destination entry in the matrix value array. The calls are grouped in blocks (e.g., one per variables or
+/// constraint object), so that blocks can be replayed independently (and concurrently).
+/// See ChSparseAssemblyRecorder and ChSparseAssemblyReplayer.
+class ChSparseAssemblyPlan {
+  public:
+    ChSparseAssemblyPlan() : m_valid(false), m_rows(0), m_nnz(0) {}
+
+    /// Discard the current plan.
+    void Reset() {
+        m_valid = false;
+        m_pos.clear();
+        m_blocks.clear();
+    }
+
+    /// Return true if the plan was successfully recorded.
+    bool IsValid() const { return m_valid; }
+
+    /// Return true if the plan is valid and was recorded for a matrix with the same size and number of nonzeros.
+    bool IsValidFor(const ChSparseMatrix& mat) const {
+        return m_valid && mat.isCompressed() && mat.rows() == m_rows && mat.nonZeros() == m_nnz;
+    }
+
+    /// Get the number of recorded blocks.
+    int GetNumBlocks() const { return (int)m_blocks.size() - 1; }
+
+    /// Get the number of recorded entries.
+    int GetNumEntries() const { return (int)m_pos.size(); }
+
+  private:
+    bool m_valid;               ///< was the plan fully recorded?
+    int m_rows;                 ///< number of rows of the target matrix
+    int m_nnz;                  ///< number of nonzeros of the target matrix
+    std::vector<int> m_pos;     ///< destination index in the value array, for each recorded SetElement call
+    std::vector<int> m_blocks;  ///< start of each block in m_pos (with one additional end marker)
+
+    friend class ChSparseAssemblyRecorder;
+    friend class ChSparseAssemblyReplayer;
+};
+
+/// Utility class for recording a ChSparseAssemblyPlan.
+/// Derived from ChSparseMatrix, a ChSparseAssemblyRecorder does not store any elements, but forwards all SetElement
+/// calls to a target compressed matrix, while recording the index of each destination entry in the target value array.
+/// If the target sparsity pattern does not include an element, recording stops, the element is inserted in the target
+/// matrix (which is then no longer compressed), and the plan is left invalid.
+class ChSparseAssemblyRecorder : public Eigen::SparseMatrix<double, Eigen::RowMajor, int> {
+  public:
+    ChSparseAssemblyRecorder(ChSparseMatrix& target, ChSparseAssemblyPlan& plan)
+        : ChSparseMatrix(), m_target(target), m_plan(plan), m_failed(!target.isCompressed()) {
+        m_plan.Reset();
+        m_plan.m_rows = (int)target.rows();
+        m_plan.m_nnz = (int)target.nonZeros();
+        m_plan.m_pos.reserve(target.nonZeros());
+    }
+
+    ~ChSparseAssemblyRecorder() {}
+
+    /// Mark the beginning of a new block of SetElement calls.
+    void BeginBlock() { m_plan.m_blocks.push_back((int)m_plan.m_pos.size()); }
+
+    /// Finish recording. Return true if the plan is valid.
+    bool Finalize() {
+        m_plan.m_blocks.push_back((int)m_plan.m_pos.size());
+        m_plan.m_valid = !m_failed;
+        if (m_failed)
+            m_plan.Reset();
+        return m_plan.m_valid;
+    }
+
+    virtual void SetElement(int row, int col, double val, bool overwrite = true) override {
+        if (!m_failed) {
+            const int* inner = m_target.innerIndexPtr();
+            const int* begin = inner + m_target.outerIndexPtr()[row];
+            const int* end = inner + m_target.outerIndexPtr()[row + 1];
+            const int* it = std::lower_bound(begin, end, col);
+            if (it != end && *it == col) {
+                int pos = (int)(it - inner);
+                overwrite ? m_target.valuePtr()[pos] = val : m_target.valuePtr()[pos] += val;
+                m_plan.m_pos.push_back(pos);
+                return;
+            }
+            m_failed = true;
+        }
+        m_target.SetElement(row, col, val, overwrite);
+    }
+
+  private:
+    ChSparseMatrix& m_target;
+    ChSparseAssemblyPlan& m_plan;
+    bool m_failed;
+};
+
+/// Utility class for replaying a ChSparseAssemblyPlan.
+/// Derived from ChSparseMatrix, a ChSparseAssemblyReplayer does not store any elements, but scatters the values
+/// received through SetElement directly in the value array of the target matrix, at the locations recorded in the plan
+/// for the current block. Each call is checked against the target sparsity pattern; a mismatch (or a different number
+/// of calls in a block) flags the replay as failed, in which case the target matrix must be assembled anew.
+/// Different blocks can be replayed concurrently, using one replayer per thread. If blocks may update the same
+/// entries, accumulation must be performed with atomic updates (see SetAtomic).
+class ChSparseAssemblyReplayer : public Eigen::SparseMatrix<double, Eigen::RowMajor, int> {
+  public:
+    ChSparseAssemblyReplayer(ChSparseMatrix& target, const ChSparseAssemblyPlan& plan)
+        : ChSparseMatrix(),
+          m_values(target.valuePtr()),
+          m_inner(target.innerIndexPtr()),
+          m_outer(target.outerIndexPtr()),
+          m_plan(plan),
+          m_cursor(0),
+          m_end(0),
+          m_atomic(false),
+          m_failed(false) {}
+
+    ~ChSparseAssemblyReplayer() {}
+
+    /// Enable/disable atomic accumulation (default: false).
+    void SetAtomic(bool val) { m_atomic = val; }
+
+    /// Start replaying the specified block.
+    void BeginBlock(int block) {
+        m_cursor = m_plan.m_blocks[block];
+        m_end = m_plan.m_blocks[block + 1];
+    }
+
+    /// Finish replaying the current block. Return false if the replay failed.
+    bool EndBlock() {
+        if (m_cursor != m_end)
+            m_failed = true;
+        return !m_failed;
+    }
+
+    /// Return true if any of the replayed blocks failed.
+    bool Failed() const { return m_failed; }
+
+    virtual void SetElement(int row, int col, double val, bool overwrite = true) override {
+        if (m_cursor >= m_end) {
+            m_failed = true;
+            return;
+        }
+        int pos = m_plan.m_pos[m_cursor++];
+        if (m_inner[pos] != col || pos < m_outer[row] || pos >= m_outer[row + 1]) {
+            m_failed = true;
+            return;
+        }
+        if (overwrite) {
+            m_values[pos] = val;
+        } else if (m_atomic) {
+#pragma omp atomic
+            m_values[pos] += val;
+        } else {
+            m_values[pos] += val;
+        }
+    }
+
+  private:
+    double* m_values;
+    const int* m_inner;
+    const int* m_outer;
+    const ChSparseAssemblyPlan& m_plan;
+    int m_cursor;
+    int m_end;
+    bool m_atomic;
+    bool m_failed;
+};
+
+/// @} chrono_linalg
+
+};  // end namespace chrono
+
+#endif
@@ -35,7 +35,7 @@ struct ChStrainStress3D {
 /// Base class for all finite elements, that can be used in the ChMesh physics item.
 class ChApi ChElementBase {
   public:
-    ChElementBase() {}
+    ChElementBase() : atomic_scatter(true) {}
     virtual ~ChElementBase() {}
 
     /// Gets the number of nodes used by this element.
@@ -127,7 +127,14 @@ class ChApi ChElementBase {
     /// WILL BE DEPRECATED
     virtual void VariablesFbIncrementMq() {}
 
+  protected:
+    /// Return true if contributions to global vectors must be added with atomic updates,
+    /// i.e. if elements sharing nodes can be processed concurrently (see ChMesh::SetAssemblyMode).
+    bool AtomicScatter() const { return atomic_scatter; }
+
   private:
+    bool atomic_scatter;  ///< use atomic updates of global vectors? (set by the owner mesh)
+
     /// Initial setup: This is used mostly to precompute matrices that do not change during the simulation, i.e. the
     /// local stiffness of each element, if any, the mass, etc.
     virtual void SetupInitial(ChSystem* system) {}
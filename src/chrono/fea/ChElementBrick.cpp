@@ -129,6 +129,78 @@ void ChElementBrick::SetStockAlpha(double a1,
 
 // -----------------------------------------------------------------------------
 
+// Calculate the stress (second Piola-Kirchhoff, in vector form) of the 2-parameter Mooney-Rivlin material with
+// penalty for incompressibility, as well as its tangent E_eps(j, k) = d stress(k) / d strain(j), for the given
+// Green-Lagrange strains. Vector forms are ordered as [xx, yy, xy, zz, xz, yz] (engineering shear strains).
+static void MooneyRivlinStress(const ChVectorN<double, 6>& strain,
+                               double C10,
+                               double C01,
+                               ChVectorN<double, 6>& stress,
+                               ChMatrixNM<double, 6, 6>& E_eps) {
+    // Index pairs of the strain components
+    static const int ii[6] = {0, 1, 0, 2, 0, 1};
+    static const int jj[6] = {0, 1, 1, 2, 2, 2};
+
+    // Right Cauchy-Green deformation tensor and its inverse
+    ChMatrix33<> CG;
+    CG(0, 0) = 2.0 * strain(0) + 1.0;
+    CG(1, 1) = 2.0 * strain(1) + 1.0;
+    CG(2, 2) = 2.0 * strain(3) + 1.0;
+    CG(1, 0) = strain(2);
+    CG(0, 1) = CG(1, 0);
+    CG(2, 0) = strain(4);
+    CG(0, 2) = CG(2, 0);
+    CG(2, 1) = strain(5);
+    CG(1, 2) = CG(2, 1);
+    ChMatrix33<> INVCG = CG.inverse();
+
+    // Invariants of the right Cauchy-Green deformation tensor
+    double I1 = CG.trace();
+    double I2 = 0.5 * (I1 * I1 - CG.squaredNorm());
+    double I3 = CG.determinant();
+    double J = sqrt(I3);
+    double I3m13 = pow(I3, -1.0 / 3.0);
+    double I3m23 = I3m13 * I3m13;
+
+    // Bulk modulus
+    double K = 2.0 * (C10 + C01) / (1.0 - 2.0 * 0.49);
+
+    // Stress tensor from the two Mooney-Rivlin terms and from the penalty for incompressibility
+    ChMatrix33<> I1PC = (ChMatrix33<>::Identity() - INVCG * (I1 / 3.0)) * I3m13;
+    ChMatrix33<> I2PC = (ChMatrix33<>::Identity() * I1 - CG - INVCG * (2.0 / 3.0 * I2)) * I3m23;
+    ChMatrix33<> STR = I1PC * (2.0 * C10) + I2PC * (2.0 * C01) + INVCG * (K * J * (J - 1.0));
+
+    for (int k = 0; k < 6; k++)
+        stress(k) = STR(ii[k], jj[k]);
+
+    // Directional derivatives of the stress tensor along each strain component
+    // (strain j only changes the entries (a,b) and (b,a) of CG, by 1 each)
+    for (int j = 0; j < 6; j++) {
+        int a = ii[j];
+        int b = jj[j];
+        ChMatrix33<> dCG = ChMatrix33<>::Zero();
+        dCG(a, b) += 1.0;
+        dCG(b, a) += 1.0;
+        ChMatrix33<> dINVCG = -(INVCG.col(a) * INVCG.col(b).transpose() + INVCG.col(b) * INVCG.col(a).transpose());
+        double trCdC = 2.0 * INVCG(a, b);  // dI3 / I3
+        double dI1 = dCG.trace();
+        double dI2 = I1 * dI1 - 2.0 * CG(a, b);
+        double dJ = 0.5 * J * trCdC;
+
+        ChMatrix33<> dI1PC = I1PC * (-trCdC / 3.0) - (INVCG * (dI1 / 3.0) + dINVCG * (I1 / 3.0)) * I3m13;
+        ChMatrix33<> dI2PC =
+            I2PC * (-2.0 / 3.0 * trCdC) +
+            (ChMatrix33<>::Identity() * dI1 - dCG - INVCG * (2.0 / 3.0 * dI2) - dINVCG * (2.0 / 3.0 * I2)) * I3m23;
+        ChMatrix33<> dSTR = dI1PC * (2.0 * C10) + dI2PC * (2.0 * C01) +
+                            INVCG * (K * (2.0 * J - 1.0) * dJ) + dINVCG * (K * J * (J - 1.0));
+
+        for (int k = 0; k < 6; k++)
+            E_eps(j, k) = dSTR(ii[k], jj[k]);
+    }
+}
+
+// -----------------------------------------------------------------------------
+
 // Internal force, EAS stiffness, and analytical jacobian are calculated
 class Brick_ForceAnalytical : public ChIntegrable3D<ChVectorN<double, 906>> {
   public:
@@ -433,126 +505,10 @@ void Brick_ForceAnalytical::Evaluate(ChVectorN<double, 906>& result, const doubl
 
     // If Mooney-Rivlin Material is selected -> Calculates internal forces and their Jacobian accordingly (new E_eps)
     if (element->m_isMooney) {
-        ChMatrix33<> CG;     // CG: Right Cauchy-Green deformation tensor  C=trans(F)*F
-        ChMatrix33<> INVCG;  // INVCG: Inverse of Right Cauchy-Green deformation tensor  C=trans(F)*F
-        ChMatrix33<> I1PC;   // Stress tensor from first term of Mooney-Rivlin strain energy
-        ChMatrix33<> I2PC;   // Stress tensor from second term of Mooney-Rivlin strain energy
-        ChMatrix33<> JPC;    // Stress tensor from penalty term to ensure incompressibility
-        ChMatrix33<> STR;    // Stress tensor from strain energy (with penalty for incompressibility CCOM3)
-
-        // Same quantities for the numerical calculation of the Jacobian of Mooney-Rivlin forces
-        ChMatrix33<> CGN;     // CG: Right Cauchy-Green deformation tensor  C=trans(F)*F
-        ChMatrix33<> INVCGN;  // INVCG: Inverse of Right Cauchy-Green deformation tensor  C=trans(F)*F
-        ChMatrix33<> I1PCN;   // Stress tensor from first term of Mooney-Rivlin strain energy
-        ChMatrix33<> I2PCN;   // Stress tensor from second term of Mooney-Rivlin strain energy
-        ChMatrix33<> JPCN;    // Stress tensor from penalty term to ensure incompressibility
-        ChMatrix33<> STRN;    // Stress tensor from strain energy (with penalty for incompressibility CCOM3)
-
-        ChVectorN<double, 6> strain_1;
-
-        // Right Cauchy - Green deformation tensor
-        CG(0, 0) = 2.0 * strain(0) + 1.0;
-        CG(1, 1) = 2.0 * strain(1) + 1.0;
-        CG(2, 2) = 2.0 * strain(3) + 1.0;
-        CG(1, 0) = strain(2);
-        CG(0, 1) = CG(1, 0);
-        CG(2, 0) = strain(4);
-        CG(0, 2) = CG(2, 0);
-        CG(2, 1) = strain(5);
-        CG(1, 2) = CG(2, 1);
-
-        INVCG = CG.inverse();
-
-        // Calculation of invariants I1, I2, and I3 and its deviatoric counterparts I1bar, I2bar, and I3bar
-        double Deld = 0.000001;
-        // First invariant of Right Cauchy-Green deformation tensor
-        double I1 = CG(0, 0) + CG(1, 1) + CG(2, 2);
-        // Second invariant of Right Cauchy-Green deformation tensor
-        double I2 = 0.5 * (pow(I1, 2) - (pow(CG(0, 0), 2) + pow(CG(1, 0), 2) + pow(CG(2, 0), 2) + pow(CG(0, 1), 2) +
-                                         pow(CG(1, 1), 2) + pow(CG(2, 1), 2) + pow(CG(0, 2), 2) + pow(CG(1, 2), 2) +
-                                         pow(CG(2, 2), 2)));
-        // Third invariant of Right Cauchy-Green deformation tensor (must be very close to 1 for incompressible
-        // material)
-        double I3 = CG(0, 0) * CG(1, 1) * CG(2, 2) - CG(0, 0) * CG(1, 2) * CG(2, 1) + CG(0, 1) * CG(1, 2) * CG(2, 0) -
-                    CG(0, 1) * CG(1, 0) * CG(2, 2) + CG(0, 2) * CG(1, 0) * CG(2, 1) - CG(2, 0) * CG(1, 1) * CG(0, 2);
-        double I1BAR = I1 / (pow(I3, 1.0 / 3.0));  // First invariant of the deviatoric tensor
-        double I2BAR = I2 / (pow(I3, 2.0 / 3.0));  // Second invariant of the deviatoric tensor
-        double J = sqrt(I3);
-        // double CCOM1 = 551584.0;                                    // C10   not 0.551584
-        // double CCOM2 = 137896.0;                                    // C01   not 0.137896
-        double CCOM3 = 2.0 * (element->CCOM1 + element->CCOM2) / (1.0 - 2.0 * 0.49);  // K:bulk modulus
-        double StockEPS;
-
-        /// Calculation of stress tensor STR term to term: I1PC, I2PC, and JPC.
-
-        // Stress tensor from first term of Mooney-Rivlin strain energy
-        I1PC = (ChMatrix33<>::Identity() - INVCG * (1.0 / 3.0 * I1)) * pow(I3, -1.0 / 3.0);
-        // Stress tensor from second term of Mooney-Rivlin strain energy
-        I2PC = (((ChMatrix33<>::Identity() * I1) - CG) - (INVCG * (2.0 / 3.0) * I2)) * pow(I3, -2.0 / 3.0);
-        // Stress tensor from penalty for incompressibility
-        JPC = INVCG * (J / 2.0);
-        // Definition of stress tensor from strain energy (including penalty for incompressibility CCOM3)
-        STR = I1PC * (element->CCOM1 * 2.0) + I2PC * (element->CCOM2 * 2.0) + JPC * (CCOM3 * (J - 1.0) * 2.0);
-
-        // Put the stress in vector form
+        // Stress and tangent matrix of elastic coefficients (E_eps is necessary for the Jacobian of MR forces)
         ChVectorN<double, 6> TEMP5;
-        TEMP5(0) = STR(0, 0);
-        TEMP5(1) = STR(1, 1);
-        TEMP5(2) = STR(0, 1);
-        TEMP5(3) = STR(2, 2);
-        TEMP5(4) = STR(0, 2);
-        TEMP5(5) = STR(1, 2);
-
-        E_eps.setZero();
-
-        // Compatible plus enhanced assumed strain
-        strain_1 = strain;
-
-        // Loop to obtain our Mooney-Rivling E_eps (tangential matrix of elastic coefficients)
-        // E_eps is necessary for obtaining the Jacobian of MR internal forces
-        ChVectorN<double, 6> TEMP5N;
-        for (int JJJ = 0; JJJ < 6; JJJ++) {
-            StockEPS = strain_1(JJJ);
-            strain_1(JJJ) = StockEPS + Deld;
-            CGN(0, 0) = 2.0 * strain_1(0) + 1.0;
-            CGN(1, 1) = 2.0 * strain_1(1) + 1.0;
-            CGN(2, 2) = 2.0 * strain_1(3) + 1.0;
-            CGN(1, 0) = strain_1(2);
-            CGN(0, 1) = CGN(1, 0);
-            CGN(2, 0) = strain_1(4);
-            CGN(0, 2) = CGN(2, 0);
-            CGN(2, 1) = strain_1(5);
-            CGN(1, 2) = CGN(2, 1);
-            INVCGN = CGN.inverse();
-
-            I1 = CGN(0, 0) + CGN(1, 1) + CGN(2, 2);
-            I2 = 0.5 * (pow(I1, 2) - (pow(CGN(0, 0), 2) + pow(CGN(1, 0), 2) + pow(CGN(2, 0), 2) + pow(CGN(0, 1), 2) +
-                                      pow(CGN(1, 1), 2) + pow(CGN(2, 1), 2) + pow(CGN(0, 2), 2) + pow(CGN(1, 2), 2) +
-                                      pow(CGN(2, 2), 2)));
-            I3 = CGN(0, 0) * CGN(1, 1) * CGN(2, 2) - CGN(0, 0) * CGN(1, 2) * CGN(2, 1) +
-                 CGN(0, 1) * CGN(1, 2) * CGN(2, 0) - CGN(0, 1) * CGN(1, 0) * CGN(2, 2) +
-                 CGN(0, 2) * CGN(1, 0) * CGN(2, 1) - CGN(2, 0) * CGN(1, 1) * CGN(0, 2);
-            J = sqrt(I3);
-            I1BAR = I1 / (pow(I3, 1.0 / 3.0));
-            I2BAR = I2 / (pow(I3, 2.0 / 3.0));
-            I1PCN = (ChMatrix33<>::Identity() - INVCGN * (1.0 / 3.0 * I1)) * pow(I3, -1.0 / 3.0);
-            I2PCN = (((ChMatrix33<>::Identity() * I1) - CGN) - (INVCGN * (2.0 / 3.0) * I2)) * pow(I3, -2.0 / 3.0);
-            JPCN = INVCGN * (J / 2.0);
-            STRN = I1PCN * (element->CCOM1 * 2.0) + I2PCN * (element->CCOM2 * 2.0) + JPCN * (CCOM3 * (J - 1.0) * 2.0);
-            TEMP5N(0) = STRN(0, 0);
-            TEMP5N(1) = STRN(1, 1);
-            TEMP5N(2) = STRN(0, 1);
-            TEMP5N(3) = STRN(2, 2);
-            TEMP5N(4) = STRN(0, 2);
-            TEMP5N(5) = STRN(1, 2);
-            strain_1(JJJ) = StockEPS;
-            E_eps(JJJ, 0) = (TEMP5N(0) - TEMP5(0)) / Deld;
-            E_eps(JJJ, 1) = (TEMP5N(1) - TEMP5(1)) / Deld;
-            E_eps(JJJ, 2) = (TEMP5N(2) - TEMP5(2)) / Deld;
-            E_eps(JJJ, 3) = (TEMP5N(3) - TEMP5(3)) / Deld;
-            E_eps(JJJ, 4) = (TEMP5N(4) - TEMP5(4)) / Deld;
-            E_eps(JJJ, 5) = (TEMP5N(5) - TEMP5(5)) / Deld;
-        }
+        MooneyRivlinStress(strain, element->CCOM1, element->CCOM2, TEMP5, E_eps);
+
         // Add internal forces to Fint and HE1 for Mooney-Rivlin
         temp56 = G.transpose() * E_eps;
         Fint = strainD.transpose() * TEMP5;
@@ -965,108 +921,9 @@ void Brick_ForceNumerical::Evaluate(ChVectorN<double, 330>& result, const double
 
     // m_isMooney == 1 use Iso_Nonlinear_Mooney-Rivlin Material (2-parameters=> 3 inputs)
     if (element->m_isMooney == 1) {
-        ChMatrix33<> CG;  // CG: Right Cauchy-Green tensor  C=trans(F)*F
-        ChMatrix33<> INVCG;
-        ChMatrix33<> I1PC;
-        ChMatrix33<> I2PC;
-        ChMatrix33<> JPC;
-        ChMatrix33<> STR;
-
-        ChMatrix33<> CGN;
-        ChMatrix33<> INVCGN;
-        ChMatrix33<> I1PCN;
-        ChMatrix33<> I2PCN;
-        ChMatrix33<> JPCN;
-        ChMatrix33<> STRN;
-
-        ChVectorN<double, 6> strain_1;
-
-        CG(0, 0) = 2.0 * strain(0) + 1.0;
-        CG(1, 1) = 2.0 * strain(1) + 1.0;
-        CG(2, 2) = 2.0 * strain(3) + 1.0;
-        CG(1, 0) = strain(2);
-        CG(0, 1) = CG(1, 0);
-        CG(2, 0) = strain(4);
-        CG(0, 2) = CG(2, 0);
-        CG(2, 1) = strain(5);
-        CG(1, 2) = CG(2, 1);
-
-        INVCG = CG.inverse();
-
-        double Deld = 0.000001;
-        double I1 = CG(0, 0) + CG(1, 1) + CG(2, 2);
-        double I2 = 0.5 * (pow(I1, 2) - (pow(CG(0, 0), 2) + pow(CG(1, 0), 2) + pow(CG(2, 0), 2) + pow(CG(0, 1), 2) +
-                                         pow(CG(1, 1), 2) + pow(CG(2, 1), 2) + pow(CG(0, 2), 2) + pow(CG(1, 2), 2) +
-                                         pow(CG(2, 2), 2)));
-        double I3 = CG(0, 0) * CG(1, 1) * CG(2, 2) - CG(0, 0) * CG(1, 2) * CG(2, 1) + CG(0, 1) * CG(1, 2) * CG(2, 0) -
-                    CG(0, 1) * CG(1, 0) * CG(2, 2) + CG(0, 2) * CG(1, 0) * CG(2, 1) - CG(2, 0) * CG(1, 1) * CG(0, 2);
-        double I1BAR = I1 / (pow(I3, 1.0 / 3.0));
-        double I2BAR = I2 / (pow(I3, 2.0 / 3.0));
-        double J = sqrt(I3);
-        // double CCOM1 = 551584.0;                                    // C10   not 0.551584
-        // double CCOM2 = 137896.0;                                    // C01   not 0.137896
-        double CCOM3 = 2.0 * (element->CCOM1 + element->CCOM2) / (1.0 - 2.0 * 0.49);  // K:bulk modulus
-        double StockEPS;
-
-        I1PC = (ChMatrix33<>::Identity() - INVCG * (1.0 / 3.0 * I1)) * pow(I3, -1.0 / 3.0);
-        I2PC = (((ChMatrix33<>::Identity() * I1) - CG) - (INVCG * (2.0 / 3.0) * I2)) * pow(I3, -2.0 / 3.0);
-        JPC = INVCG * (J / 2.0);
-
-        STR = I1PC * (element->CCOM1 * 2.0) + I2PC * (element->CCOM2 * 2.0) + JPC * (CCOM3 * (J - 1.0) * 2.0);
-
         ChVectorN<double, 6> TEMP5;
-        TEMP5(0) = STR(0, 0);
-        TEMP5(1) = STR(1, 1);
-        TEMP5(2) = STR(0, 1);
-        TEMP5(3) = STR(2, 2);
-        TEMP5(4) = STR(0, 2);
-        TEMP5(5) = STR(1, 2);
-
-        E_eps.setZero();
-
-        ChVectorN<double, 6> TEMP5N;
-        strain_1 = strain;
-        for (int JJJ = 0; JJJ < 6; JJJ++) {
-            StockEPS = strain_1(JJJ);
-            strain_1(JJJ) = StockEPS + Deld;
-            CGN(0, 0) = 2.0 * strain_1(0) + 1.0;
-            CGN(1, 1) = 2.0 * strain_1(1) + 1.0;
-            CGN(2, 2) = 2.0 * strain_1(3) + 1.0;
-            CGN(1, 0) = strain_1(2);
-            CGN(0, 1) = CGN(1, 0);
-            CGN(2, 0) = strain_1(4);
-            CGN(0, 2) = CGN(2, 0);
-            CGN(2, 1) = strain_1(5);
-            CGN(1, 2) = CGN(2, 1);
-            INVCGN = CGN.inverse();
-            I1 = CGN(0, 0) + CGN(1, 1) + CGN(2, 2);
-            I2 = 0.5 * (pow(I1, 2) - (pow(CGN(0, 0), 2) + pow(CGN(1, 0), 2) + pow(CGN(2, 0), 2) + pow(CGN(0, 1), 2) +
-                                      pow(CGN(1, 1), 2) + pow(CGN(2, 1), 2) + pow(CGN(0, 2), 2) + pow(CGN(1, 2), 2) +
-                                      pow(CGN(2, 2), 2)));
-            I3 = CGN(0, 0) * CGN(1, 1) * CGN(2, 2) - CGN(0, 0) * CGN(1, 2) * CGN(2, 1) +
-                 CGN(0, 1) * CGN(1, 2) * CGN(2, 0) - CGN(0, 1) * CGN(1, 0) * CGN(2, 2) +
-                 CGN(0, 2) * CGN(1, 0) * CGN(2, 1) - CGN(2, 0) * CGN(1, 1) * CGN(0, 2);
-            J = sqrt(I3);
-            I1BAR = I1 / (pow(I3, 1.0 / 3.0));
-            I2BAR = I2 / (pow(I3, 2.0 / 3.0));
-            I1PCN = (ChMatrix33<>::Identity() - INVCGN * (1.0 / 3.0 * I1)) * pow(I3, -1.0 / 3.0);
-            I2PCN = (((ChMatrix33<>::Identity() * I1) - CGN) - (INVCGN * (2.0 / 3.0) * I2)) * pow(I3, -2.0 / 3.0);
-            JPCN = INVCGN * (J / 2.0);
-            STRN = I1PCN * (element->CCOM1 * 2.0) + I2PCN * (element->CCOM2 * 2.0) + JPCN * (CCOM3 * (J - 1.0) * 2.0);
-            TEMP5N(0) = STRN(0, 0);
-            TEMP5N(1) = STRN(1, 1);
-            TEMP5N(2) = STRN(0, 1);
-            TEMP5N(3) = STRN(2, 2);
-            TEMP5N(4) = STRN(0, 2);
-            TEMP5N(5) = STRN(1, 2);
-            strain_1(JJJ) = StockEPS;
-            E_eps(JJJ, 0) = (TEMP5N(0) - TEMP5(0)) / Deld;
-            E_eps(JJJ, 1) = (TEMP5N(1) - TEMP5(1)) / Deld;
-            E_eps(JJJ, 2) = (TEMP5N(2) - TEMP5(2)) / Deld;
-            E_eps(JJJ, 3) = (TEMP5N(3) - TEMP5(3)) / Deld;
-            E_eps(JJJ, 4) = (TEMP5N(4) - TEMP5(4)) / Deld;
-            E_eps(JJJ, 5) = (TEMP5N(5) - TEMP5(5)) / Deld;
-        }
+        MooneyRivlinStress(strain, element->CCOM1, element->CCOM2, TEMP5, E_eps);
+
         temp56 = G.transpose() * E_eps;
         Fint = strainD.transpose() * TEMP5;
         Fint *= detJ0 * (element->GetLengthX() / 2.0) * (element->GetLengthY() / 2.0) * (element->GetLengthZ() / 2.0);
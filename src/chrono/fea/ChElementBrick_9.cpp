@@ -1062,8 +1062,8 @@ void Brick9_Force::Evaluate(ChVectorN<double, 33>& result, const double x, const
                                     double DGamma_A =
                                         (AA * SQRJ2T + eta * PT - eta * hydroPt) / (AA * G + K * eta * etab);
                                     EPBAR = EPBARN - etab * DGamma_A;
-                                    SQRJ2 = SQRJ2T;
-                                    P = PT;
+                                    SQRJ2 = AA * (SQRJ2T - G * DGamma_A);
+                                    P = PT - K * etab * DGamma_A;
                                     devS = devStress;
                                     // obtain "hardening parameter a"=MeanEffP and "first derivative of a" =Hi
                                     m_element->ComputeHardening_a(MeanEffP, Hi, EPBAR, m_element->m_DPVector1,
@@ -1073,31 +1073,20 @@ void Brick9_Force::Evaluate(ChVectorN<double, 33>& result, const double x, const
                                                 (P - hydroPt + MeanEffP) * (P - hydroPt + MeanEffP) +
                                             (sqrt(3.0) * SQRJ2 / CapM) * (sqrt(3.0) * SQRJ2 / CapM) -
                                             MeanEffP * MeanEffP;
-                                    double DGamma_B1;
-                                    double Res11;
                                     double DRes01;
                                     for (int ii = 0; ii < m_element->GetDPIterationNo(); ii++) {
                                         // TransNewtonDifference
 
-                                        //** perturbation for DGAMA_B1
-                                        DGamma_B1 = DGamma_B + 1e-10;
-                                        AA = CapM * CapM / (CapM * CapM + 6.0 * G * DGamma_B1);
-                                        DGamma_A = (AA * SQRJ2T + eta * PT - eta * hydroPt) / (AA * G + K * eta * etab);
-                                        EPBAR = EPBARN - etab * DGamma_A;
-                                        // obtain "hardening parameter a"=MeanEffP and "first derivative of a" =Hi
-                                        m_element->ComputeHardening_a(MeanEffP, Hi, EPBAR, m_element->m_DPVector1,
-                                                                      m_element->m_DPVector2,
-                                                                      m_element->m_DPVector_size);
-                                        // update stresses
-                                        P = PT - K * etab * DGamma_A;
-                                        SQRJ2 = CapM * CapM / (CapM * CapM + 6.0 * G * DGamma_B1) *
-                                                (1.0 - G * DGamma_A / SQRJ2T) * SQRJ2T;
-                                        // Check yield functions
-                                        Res11 = (1.0 / (m_element->m_DPCapBeta * m_element->m_DPCapBeta)) *
-                                                    (P - hydroPt + MeanEffP) * (P - hydroPt + MeanEffP) +
-                                                (sqrt(3.0) * SQRJ2 / CapM) * (sqrt(3.0) * SQRJ2 / CapM) -
-                                                MeanEffP * MeanEffP;
-                                        DRes01 = (Res11 - Res01) / 1e-10;
+                                        // Derivative of the residual w.r.t. DGamma_B (DGamma_A, and hence the
+                                        // hardening parameter, depend on DGamma_B through AA)
+                                        double DAA = -6.0 * G * AA * AA / (CapM * CapM);
+                                        double DDGamma_A = DAA * (SQRJ2T - G * DGamma_A) / (AA * G + K * eta * etab);
+                                        double DMeanEffP = -Hi * etab * DDGamma_A;
+                                        double DP = -K * etab * DDGamma_A;
+                                        double DSQRJ2 = DAA * (SQRJ2T - G * DGamma_A) - AA * G * DDGamma_A;
+                                        DRes01 = (2.0 / (m_element->m_DPCapBeta * m_element->m_DPCapBeta)) *
+                                                     (P - hydroPt + MeanEffP) * (DP + DMeanEffP) +
+                                                 6.0 * SQRJ2 * DSQRJ2 / (CapM * CapM) - 2.0 * MeanEffP * DMeanEffP;
 
                                         if (DRes01 == 0.0) {
                                             printf("Singular for Transition DP/CAP!!\n");
@@ -1613,8 +1602,6 @@ void Brick9_Jacobian::Evaluate(ChMatrixNM<double, 33, 33>& result, const double
                 double J2Rt;
                 // Current value of yield function
                 double YieldFunc;
-                // Flag indicating whether an elastic (0) or plastic (1) step occurs
-                int YieldFlag;
                 // Variation of flow rate
                 double DeltaGamma;
                 // Deviatoric stresses updated
@@ -1661,16 +1648,16 @@ void Brick9_Jacobian::Evaluate(ChMatrixNM<double, 33, 33>& result, const double
                                            (DeltaGamma / qtrial - 1.0 / (3.0 * G + m_element->m_HardeningSlope)) /
                                            (NormSn * NormSn);
 
-                            //// RADU
-                            //// devStressVec never used...
-
+                            // Deviatoric stress, expressed in the same frame as the strains
+                            ChMatrix33<double> devStressT =
+                                devStress.x() * MM1 + devStress.y() * MM2 + devStress.z() * MM3;
                             ChVectorN<double, 6> devStressVec;
-                            devStressVec(0) = devStress.x();
-                            devStressVec(1) = devStress.y();
-                            devStressVec(3) = devStress.z();
-                            devStressVec(2) = 0.0;
-                            devStressVec(4) = 0.0;
-                            devStressVec(5) = 0.0;
+                            devStressVec(0) = devStressT(0, 0);
+                            devStressVec(1) = devStressT(1, 1);
+                            devStressVec(3) = devStressT(2, 2);
+                            devStressVec(2) = devStressT(0, 1);
+                            devStressVec(4) = devStressT(0, 2);
+                            devStressVec(5) = devStressT(1, 2);
 
                             // Obtain matrices DEVPRJ and Dep, necessary for Jacobian of plastic internal forces
                             ChMatrixNM<double, 6, 6> FOID;
@@ -1716,13 +1703,16 @@ void Brick9_Jacobian::Evaluate(ChMatrixNM<double, 33, 33>& result, const double
                             EDNInv = 0.0;
                         }
 
+                        // Unit deviatoric strain direction, expressed in the same frame as the strains (EETD holds
+                        // principal values, in the directions of MM1, MM2, MM3)
+                        ChMatrix33<double> UniDevT = (EETD.x() * MM1 + EETD.y() * MM2 + EETD.z() * MM3) * EDNInv;
                         ChVectorN<double, 6> UniDev;
-                        UniDev(0) = EETD.x() * EDNInv;
-                        UniDev(1) = EETD.y() * EDNInv;
-                        UniDev(3) = EETD.z() * EDNInv;
-                        UniDev(2) = 0.0;
-                        UniDev(4) = 0.0;
-                        UniDev(5) = 0.0;
+                        UniDev(0) = UniDevT(0, 0);
+                        UniDev(1) = UniDevT(1, 1);
+                        UniDev(3) = UniDevT(2, 2);
+                        UniDev(2) = UniDevT(0, 1);
+                        UniDev(4) = UniDevT(0, 2);
+                        UniDev(5) = UniDevT(1, 2);
 
                         double EETV = LogStrain(0) + LogStrain(1) + LogStrain(2);
                         hydroP = K * EETV;
@@ -1858,7 +1848,7 @@ void Brick9_Jacobian::Evaluate(ChMatrixNM<double, 33, 33>& result, const double
                                 for (int ii = 0; ii < 6; ii++) {
                                     for (int jj = 0; jj < 6; jj++) {
                                         Dep(ii, jj) =
-                                            AFact * FOID(ii, jj) + BFact * UniDev(ii) +
+                                            AFact * FOID(ii, jj) + BFact * UniDev(ii) * UniDev(jj) +
                                             CFact * (eta * UniDev(ii) * SOID(jj) + etab * SOID(ii) * UniDev(jj)) +
                                             (DFact - AFact / 3.0) * SOID(ii) * SOID(jj);
                                     }
@@ -1889,13 +1879,16 @@ void Brick9_Jacobian::Evaluate(ChMatrixNM<double, 33, 33>& result, const double
                             EDNInv = 0.0;
                         }
 
+                        // Unit deviatoric strain direction, expressed in the same frame as the strains (EETD holds
+                        // principal values, in the directions of MM1, MM2, MM3)
+                        ChMatrix33<double> UniDevT = (EETD.x() * MM1 + EETD.y() * MM2 + EETD.z() * MM3) * EDNInv;
                         ChVectorN<double, 6> UniDev;
-                        UniDev(0) = EETD.x() * EDNInv;
-                        UniDev(1) = EETD.y() * EDNInv;
-                        UniDev(3) = EETD.z() * EDNInv;
-                        UniDev(2) = 0.0;
-                        UniDev(4) = 0.0;
-                        UniDev(5) = 0.0;
+                        UniDev(0) = UniDevT(0, 0);
+                        UniDev(1) = UniDevT(1, 1);
+                        UniDev(3) = UniDevT(2, 2);
+                        UniDev(2) = UniDevT(0, 1);
+                        UniDev(4) = UniDevT(0, 2);
+                        UniDev(5) = UniDevT(1, 2);
 
                         double EETV = LogStrain(0) + LogStrain(1) + LogStrain(2);
                         hydroP = K * EETV;
@@ -2075,7 +2068,7 @@ void Brick9_Jacobian::Evaluate(ChMatrixNM<double, 33, 33>& result, const double
                                     for (int ii = 0; ii < 6; ii++) {
                                         for (int jj = 0; jj < 6; jj++) {
                                             Dep(ii, jj) =
-                                                AFact * FOID(ii, jj) + BFact * UniDev(ii) +
+                                                AFact * FOID(ii, jj) + BFact * UniDev(ii) * UniDev(jj) +
                                                 CFact * (eta * UniDev(ii) * SOID(jj) + etab * SOID(ii) * UniDev(jj)) +
                                                 (DFact - AFact / 3.0) * SOID(ii) * SOID(jj);
                                         }
@@ -2191,8 +2184,8 @@ void Brick9_Jacobian::Evaluate(ChMatrixNM<double, 33, 33>& result, const double
                                     double AA = CapM * CapM / (CapM * CapM + 6.0 * G * DGamma_B);
                                     DGamma_A = (AA * SQRJ2T + eta * PT - eta * hydroPt) / (AA * G + K * eta * etab);
                                     EPBAR = EPBARN - etab * DGamma_A;
-                                    SQRJ2 = SQRJ2T;
-                                    P = PT;
+                                    SQRJ2 = AA * (SQRJ2T - G * DGamma_A);
+                                    P = PT - K * etab * DGamma_A;
                                     devS = devStress;
                                     // obtain "hardening parameter a"=MeanEffP and "first derivative of a" =Hi
                                     m_element->ComputeHardening_a(MeanEffP, Hi, EPBAR, m_element->m_DPVector1,
@@ -2202,31 +2195,20 @@ void Brick9_Jacobian::Evaluate(ChMatrixNM<double, 33, 33>& result, const double
                                                 (P - hydroPt + MeanEffP) * (P - hydroPt + MeanEffP) +
                                             (sqrt(3.0) * SQRJ2 / CapM) * (sqrt(3.0) * SQRJ2 / CapM) -
                                             MeanEffP * MeanEffP;
-                                    double DGamma_B1;
-                                    double Res11;
                                     double DRes01;
                                     for (int ii = 0; ii < m_element->GetDPIterationNo(); ii++) {
                                         // TransNewtonDifference
 
-                                        //** perturbation for DGAMA_B1
-                                        DGamma_B1 = DGamma_B + 1e-10;
-                                        AA = CapM * CapM / (CapM * CapM + 6.0 * G * DGamma_B1);
-                                        DGamma_A = (AA * SQRJ2T + eta * PT - eta * hydroPt) / (AA * G + K * eta * etab);
-                                        EPBAR = EPBARN - etab * DGamma_A;
-                                        // obtain "hardening parameter a"=MeanEffP and "first derivative of a" =Hi
-                                        m_element->ComputeHardening_a(MeanEffP, Hi, EPBAR, m_element->m_DPVector1,
-                                                                      m_element->m_DPVector2,
-                                                                      m_element->m_DPVector_size);
-                                        // update stresses
-                                        P = PT - K * etab * DGamma_A;
-                                        SQRJ2 = CapM * CapM / (CapM * CapM + 6.0 * G * DGamma_B1) *
-                                                (1.0 - G * DGamma_A / SQRJ2T) * SQRJ2T;
-                                        // Check yield functions
-                                        Res11 = (1.0 / (m_element->m_DPCapBeta * m_element->m_DPCapBeta)) *
-                                                    (P - hydroPt + MeanEffP) * (P - hydroPt + MeanEffP) +
-                                                (sqrt(3.0) * SQRJ2 / CapM) * (sqrt(3.0) * SQRJ2 / CapM) -
-                                                MeanEffP * MeanEffP;
-                                        DRes01 = (Res11 - Res01) / 1e-10;
+                                        // Derivative of the residual w.r.t. DGamma_B (DGamma_A, and hence the
+                                        // hardening parameter, depend on DGamma_B through AA)
+                                        double DAA = -6.0 * G * AA * AA / (CapM * CapM);
+                                        double DDGamma_A = DAA * (SQRJ2T - G * DGamma_A) / (AA * G + K * eta * etab);
+                                        double DMeanEffP = -Hi * etab * DDGamma_A;
+                                        double DP = -K * etab * DDGamma_A;
+                                        double DSQRJ2 = DAA * (SQRJ2T - G * DGamma_A) - AA * G * DDGamma_A;
+                                        DRes01 = (2.0 / (m_element->m_DPCapBeta * m_element->m_DPCapBeta)) *
+                                                     (P - hydroPt + MeanEffP) * (DP + DMeanEffP) +
+                                                 6.0 * SQRJ2 * DSQRJ2 / (CapM * CapM) - 2.0 * MeanEffP * DMeanEffP;
 
                                         if (DRes01 == 0.0) {
                                             printf("Singular for Transition DP/CAP!!\n");
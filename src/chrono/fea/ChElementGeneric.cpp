@@ -25,7 +25,10 @@ void ChElementGeneric::EleIntLoadResidual_F(ChVectorDynamic<>& R, const double c
 
     //// RADU
     //// Attention: this is called from within a parallel OMP for loop.
-    //// Must use atomic increment when updating the global vector R.
+    //// Must use atomic increment when updating the global vector R, unless the owner mesh
+    //// guarantees that no other element sharing nodes with this one is processed concurrently.
+
+    bool atomic = AtomicScatter();
 
     int stride = 0;
     for (int in = 0; in < this->GetNnodes(); in++) {
@@ -33,9 +36,14 @@ void ChElementGeneric::EleIntLoadResidual_F(ChVectorDynamic<>& R, const double c
         // GetLog() << "  in=" << in << "  stride=" << stride << "  nodedofs=" << nodedofs << " offset=" <<
         // GetNodeN(in)->NodeGetOffset_w() << "\n";
         if (!GetNodeN(in)->GetFixed()) {
-            for (int j = 0; j < nodedofs; j++)
+            unsigned int offset = GetNodeN(in)->NodeGetOffset_w();
+            if (atomic) {
+                for (int j = 0; j < nodedofs; j++)
 #pragma omp atomic
-                R(GetNodeN(in)->NodeGetOffset_w() + j) += mFi(stride + j);
+                    R(offset + j) += mFi(stride + j);
+            } else {
+                R.segment(offset, nodedofs) += mFi.segment(stride, nodedofs);
+            }
         }
         stride += nodedofs;
     }
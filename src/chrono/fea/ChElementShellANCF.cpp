@@ -120,6 +120,9 @@ void ChElementShellANCF::SetupInitial(ChSystem* system) {
     // Cache the scaling factor (due to change of integration intervals)
     m_GaussScaling = (m_lenX * m_lenY * m_thickness) / 8;
 
+    // Precompute the Gauss point tables and the (constant) EAS Jacobians
+    CalcLayerTables();
+
     // Compute mass matrix and gravitational forces (constant)
     ComputeMassMatrix();
     ComputeGravityForce(system->Get_G_acc());
@@ -277,291 +280,240 @@ void ChElementShellANCF::ComputeGravityForce(const ChVector<>& g_acc) {
 }
 
 // -----------------------------------------------------------------------------
-// Elastic force calculation
+// Gauss point tables
 // -----------------------------------------------------------------------------
 
-// The class ShellANCF_Force provides the integrand for the calculation of the internal forces
-// for one layer of an ANCF shell element.
-// The first 24 entries in the integrand represent the internal force.
-// The next 5 entries represent the residual of the EAS nonlinear system.
-// The last 25 entries represent the 5x5 Jacobian of the EAS nonlinear system.
-// Capabilities of this class include: application of enhanced assumed strain (EAS) and
-// assumed natural strain (ANS) formulations to avoid thickness and (transverse and in-plane)
-// shear locking. This implementation also features a composite material implementation
-// that allows for selecting a number of layers over the element thickness; each of which
-// has an independent, user-selected fiber angle (direction for orthotropic constitutive behavior)
-class ShellANCF_Force : public ChIntegrable3D<ChVectorN<double, 54>> {
-  public:
-    ShellANCF_Force(ChElementShellANCF* element,     // Containing element
-                    size_t kl,                       // Current layer index
-                    ChVectorN<double, 5>* alpha_eas  // Vector of internal parameters for EAS formulation
-                    )
-        : m_element(element), m_kl(kl), m_alpha_eas(alpha_eas) {}
-    ~ShellANCF_Force() {}
-
-  private:
-    ChElementShellANCF* m_element;
-    size_t m_kl;
-    ChVectorN<double, 5>* m_alpha_eas;
-
-    /// Evaluate (strainD'*strain)  at point x, include ANS and EAS.
-    virtual void Evaluate(ChVectorN<double, 54>& result, const double x, const double y, const double z) override;
-};
-
-void ShellANCF_Force::Evaluate(ChVectorN<double, 54>& result, const double x, const double y, const double z) {
-    // Element shape function
-    ChElementShellANCF::ShapeVector N;
-    m_element->ShapeFunctions(N, x, y, z);
-
-    // Determinant of position vector gradient matrix: Initial configuration
-    ChElementShellANCF::ShapeVector Nx;
-    ChElementShellANCF::ShapeVector Ny;
-    ChElementShellANCF::ShapeVector Nz;
-    ChMatrixNM<double, 1, 3> Nx_d0;
-    ChMatrixNM<double, 1, 3> Ny_d0;
-    ChMatrixNM<double, 1, 3> Nz_d0;
-    double detJ0 = m_element->Calc_detJ0(x, y, z, Nx, Ny, Nz, Nx_d0, Ny_d0, Nz_d0);
-
-    // ANS shape function
-    ChMatrixNM<double, 1, 4> S_ANS;  // Shape function vector for Assumed Natural Strain
-    ChMatrixNM<double, 6, 5> M;      // Shape function vector for Enhanced Assumed Strain
-    m_element->ShapeFunctionANSbilinearShell(S_ANS, x, y);
-    m_element->Basis_M(M, x, y, z);
-
-    // Transformation : Orthogonal transformation (A and J)
-    ChVector<double> G1xG2;  // Cross product of first and second column of
-    double G1dotG1;          // Dot product of first column of position vector gradient
-
-    G1xG2.x() = Nx_d0(1) * Ny_d0(2) - Nx_d0(2) * Ny_d0(1);
-    G1xG2.y() = Nx_d0(2) * Ny_d0(0) - Nx_d0(0) * Ny_d0(2);
-    G1xG2.z() = Nx_d0(0) * Ny_d0(1) - Nx_d0(1) * Ny_d0(0);
-    G1dotG1 = Nx_d0(0) * Nx_d0(0) + Nx_d0(1) * Nx_d0(1) + Nx_d0(2) * Nx_d0(2);
-
-    // Tangent Frame
-    ChVector<double> A1;
-    ChVector<double> A2;
-    ChVector<double> A3;
-    A1.x() = Nx_d0(0);
-    A1.y() = Nx_d0(1);
-    A1.z() = Nx_d0(2);
-    A1 = A1 / sqrt(G1dotG1);
-    A3 = G1xG2.GetNormalized();
-    A2.Cross(A3, A1);
-
-    // Direction for orthotropic material
-    double theta = m_element->GetLayer(m_kl).Get_theta();  // Fiber angle
-    ChVector<double> AA1;
-    ChVector<double> AA2;
-    ChVector<double> AA3;
-    AA1 = A1 * cos(theta) + A2 * sin(theta);
-    AA2 = -A1 * sin(theta) + A2 * cos(theta);
-    AA3 = A3;
-
-    /// Beta
-    ChMatrixNM<double, 3, 3> j0;
-    ChVector<double> j01;
-    ChVector<double> j02;
-    ChVector<double> j03;
-    ChVectorN<double, 9> beta;
-    // Calculates inverse of rd0 (j0) (position vector gradient: Initial Configuration)
-    j0(0, 0) = Ny_d0(1) * Nz_d0(2) - Nz_d0(1) * Ny_d0(2);
-    j0(0, 1) = Ny_d0(2) * Nz_d0(0) - Ny_d0(0) * Nz_d0(2);
-    j0(0, 2) = Ny_d0(0) * Nz_d0(1) - Nz_d0(0) * Ny_d0(1);
-    j0(1, 0) = Nz_d0(1) * Nx_d0(2) - Nx_d0(1) * Nz_d0(2);
-    j0(1, 1) = Nz_d0(2) * Nx_d0(0) - Nx_d0(2) * Nz_d0(0);
-    j0(1, 2) = Nz_d0(0) * Nx_d0(1) - Nz_d0(1) * Nx_d0(0);
-    j0(2, 0) = Nx_d0(1) * Ny_d0(2) - Ny_d0(1) * Nx_d0(2);
-    j0(2, 1) = Ny_d0(0) * Nx_d0(2) - Nx_d0(0) * Ny_d0(2);
-    j0(2, 2) = Nx_d0(0) * Ny_d0(1) - Ny_d0(0) * Nx_d0(1);
-    j0 /= detJ0;
-
-    j01[0] = j0(0, 0);
-    j02[0] = j0(1, 0);
-    j03[0] = j0(2, 0);
-    j01[1] = j0(0, 1);
-    j02[1] = j0(1, 1);
-    j03[1] = j0(2, 1);
-    j01[2] = j0(0, 2);
-    j02[2] = j0(1, 2);
-    j03[2] = j0(2, 2);
-
-    // Coefficients of contravariant transformation
-    beta(0) = Vdot(AA1, j01);
-    beta(1) = Vdot(AA2, j01);
-    beta(2) = Vdot(AA3, j01);
-    beta(3) = Vdot(AA1, j02);
-    beta(4) = Vdot(AA2, j02);
-    beta(5) = Vdot(AA3, j02);
-    beta(6) = Vdot(AA1, j03);
-    beta(7) = Vdot(AA2, j03);
-    beta(8) = Vdot(AA3, j03);
-
-    // Transformation matrix, function of fiber angle
-    const ChMatrixNM<double, 6, 6>& T0 = m_element->GetLayer(m_kl).Get_T0();
-    // Determinant of the initial position vector gradient at the element center
-    double detJ0C = m_element->GetLayer(m_kl).Get_detJ0C();
-
-    // Enhanced Assumed Strain
-    ChMatrixNM<double, 6, 5> G = T0 * M * (detJ0C / detJ0);
-    ChVectorN<double, 6> strain_EAS = G * (*m_alpha_eas);
-
-    ChVectorN<double, 8> ddNx = m_element->m_ddT * Nx.transpose();
-    ChVectorN<double, 8> ddNy = m_element->m_ddT * Ny.transpose();
-    ChVectorN<double, 8> ddNz = m_element->m_ddT * Nz.transpose();
-
-    ChVectorN<double, 8> d0d0Nx = m_element->m_d0d0T * Nx.transpose();
-    ChVectorN<double, 8> d0d0Ny = m_element->m_d0d0T * Ny.transpose();
-    ChVectorN<double, 8> d0d0Nz = m_element->m_d0d0T * Nz.transpose();
-
-    // Strain component
-    ChVectorN<double, 6> strain_til;
-    strain_til(0) = 0.5 * ((Nx * ddNx)(0, 0) - (Nx * d0d0Nx)(0, 0));
-    strain_til(1) = 0.5 * ((Ny * ddNy)(0, 0) - (Ny * d0d0Ny)(0, 0));
-    strain_til(2) = (Nx * ddNy)(0, 0) - (Nx * d0d0Ny)(0, 0);
-    strain_til(3) = N(0) * m_element->m_strainANS(0) + N(2) * m_element->m_strainANS(1) +
-                    N(4) * m_element->m_strainANS(2) + N(6) * m_element->m_strainANS(3);
-    strain_til(4) = S_ANS(0, 2) * m_element->m_strainANS(6) + S_ANS(0, 3) * m_element->m_strainANS(7);
-    strain_til(5) = S_ANS(0, 0) * m_element->m_strainANS(4) + S_ANS(0, 1) * m_element->m_strainANS(5);
-
-    // For orthotropic material
-    ChVectorN<double, 6> strain;
-
-    strain(0) = strain_til(0) * beta(0) * beta(0) + strain_til(1) * beta(3) * beta(3) +
-                strain_til(2) * beta(0) * beta(3) + strain_til(3) * beta(6) * beta(6) +
-                strain_til(4) * beta(0) * beta(6) + strain_til(5) * beta(3) * beta(6);
-    strain(1) = strain_til(0) * beta(1) * beta(1) + strain_til(1) * beta(4) * beta(4) +
-                strain_til(2) * beta(1) * beta(4) + strain_til(3) * beta(7) * beta(7) +
-                strain_til(4) * beta(1) * beta(7) + strain_til(5) * beta(4) * beta(7);
-    strain(2) = strain_til(0) * 2.0 * beta(0) * beta(1) + strain_til(1) * 2.0 * beta(3) * beta(4) +
-                strain_til(2) * (beta(1) * beta(3) + beta(0) * beta(4)) + strain_til(3) * 2.0 * beta(6) * beta(7) +
-                strain_til(4) * (beta(1) * beta(6) + beta(0) * beta(7)) +
-                strain_til(5) * (beta(4) * beta(6) + beta(3) * beta(7));
-    strain(3) = strain_til(0) * beta(2) * beta(2) + strain_til(1) * beta(5) * beta(5) +
-                strain_til(2) * beta(2) * beta(5) + strain_til(3) * beta(8) * beta(8) +
-                strain_til(4) * beta(2) * beta(8) + strain_til(5) * beta(5) * beta(8);
-    strain(4) = strain_til(0) * 2.0 * beta(0) * beta(2) + strain_til(1) * 2.0 * beta(3) * beta(5) +
-                strain_til(2) * (beta(2) * beta(3) + beta(0) * beta(5)) + strain_til(3) * 2.0 * beta(6) * beta(8) +
-                strain_til(4) * (beta(2) * beta(6) + beta(0) * beta(8)) +
-                strain_til(5) * (beta(5) * beta(6) + beta(3) * beta(8));
-    strain(5) = strain_til(0) * 2.0 * beta(1) * beta(2) + strain_til(1) * 2.0 * beta(4) * beta(5) +
-                strain_til(2) * (beta(2) * beta(4) + beta(1) * beta(5)) + strain_til(3) * 2.0 * beta(7) * beta(8) +
-                strain_til(4) * (beta(2) * beta(7) + beta(1) * beta(8)) +
-                strain_til(5) * (beta(5) * beta(7) + beta(4) * beta(8));
-
-    // Strain derivative component
-
-    ChMatrixNM<double, 6, 24> strainD_til;
-
-    ChMatrixNM<double, 1, 24> tempB;
-    ChMatrixNM<double, 1, 3> tempB3;
-    ChMatrixNM<double, 1, 3> tempB31;
+// Calculate the strain transformation matrix (function of fiber angle) for the given
+// coefficients of contravariant transformation (see Yamashita et al, 2015, JCND).
+static void CalcStrainTransformation(const ChVectorN<double, 9>& beta, ChMatrixNM<double, 6, 6>& T) {
+    T(0, 0) = pow(beta(0), 2);
+    T(1, 0) = pow(beta(1), 2);
+    T(2, 0) = 2.0 * beta(0) * beta(1);
+    T(3, 0) = pow(beta(2), 2);
+    T(4, 0) = 2.0 * beta(0) * beta(2);
+    T(5, 0) = 2.0 * beta(1) * beta(2);
+
+    T(0, 1) = pow(beta(3), 2);
+    T(1, 1) = pow(beta(4), 2);
+    T(2, 1) = 2.0 * beta(3) * beta(4);
+    T(3, 1) = pow(beta(5), 2);
+    T(4, 1) = 2.0 * beta(3) * beta(5);
+    T(5, 1) = 2.0 * beta(4) * beta(5);
+
+    T(0, 2) = beta(0) * beta(3);
+    T(1, 2) = beta(1) * beta(4);
+    T(2, 2) = beta(0) * beta(4) + beta(1) * beta(3);
+    T(3, 2) = beta(2) * beta(5);
+    T(4, 2) = beta(0) * beta(5) + beta(2) * beta(3);
+    T(5, 2) = beta(2) * beta(4) + beta(1) * beta(5);
+
+    T(0, 3) = pow(beta(6), 2);
+    T(1, 3) = pow(beta(7), 2);
+    T(2, 3) = 2.0 * beta(6) * beta(7);
+    T(3, 3) = pow(beta(8), 2);
+    T(4, 3) = 2.0 * beta(6) * beta(8);
+    T(5, 3) = 2.0 * beta(7) * beta(8);
+
+    T(0, 4) = beta(0) * beta(6);
+    T(1, 4) = beta(1) * beta(7);
+    T(2, 4) = beta(0) * beta(7) + beta(6) * beta(1);
+    T(3, 4) = beta(2) * beta(8);
+    T(4, 4) = beta(0) * beta(8) + beta(2) * beta(6);
+    T(5, 4) = beta(1) * beta(8) + beta(2) * beta(7);
+
+    T(0, 5) = beta(3) * beta(6);
+    T(1, 5) = beta(4) * beta(7);
+    T(2, 5) = beta(3) * beta(7) + beta(4) * beta(6);
+    T(3, 5) = beta(5) * beta(8);
+    T(4, 5) = beta(3) * beta(8) + beta(6) * beta(5);
+    T(5, 5) = beta(4) * beta(8) + beta(5) * beta(7);
+}
 
-    tempB3 = Nx * m_element->m_d;
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 3; j++) {
-            tempB(0, i * 3 + j) = tempB3(0, j) * Nx(0, i);
-        }
-    }
-    strainD_til.row(0) = tempB;
+// Calculate the quantities at the Gauss points of each layer that depend only on the initial configuration.
+// The integration points are ordered as in ChQuadrature::Integrate3D (order 2) over the layer domain
+// [-1,1] x [-1,1] x [m_GaussZ[kl], m_GaussZ[kl+1]], with the weights scaled by the layer half-thickness
+// and, as in the mass and gravity calculations, by m_GaussScaling.
+void ChElementShellANCF::CalcLayerTables() {
+    const std::vector<double>& roots = ChQuadrature::GetStaticTables()->Lroots[1];
+    const std::vector<double>& weights = ChQuadrature::GetStaticTables()->Weight[1];
 
-    tempB3 = Ny * m_element->m_d;
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 3; j++) {
-            tempB(0, i * 3 + j) = tempB3(0, j) * Ny(0, i);
-        }
-    }
-    strainD_til.row(1) = tempB;
+    m_tables.resize(m_numLayers);
 
-    tempB31 = Nx * m_element->m_d;
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 3; j++) {
-            tempB(0, i * 3 + j) = tempB3(0, j) * Nx(0, i) + tempB31(0, j) * Ny(0, i);
+    for (size_t kl = 0; kl < m_numLayers; kl++) {
+        LayerTables& tables = m_tables[kl];
+
+        // Transformation matrix, function of fiber angle
+        const ChMatrixNM<double, 6, 6>& T0 = m_layers[kl].Get_T0();
+        // Determinant of the initial position vector gradient at the element center
+        double detJ0C = m_layers[kl].Get_detJ0C();
+        // Fiber angle
+        double theta = m_layers[kl].Get_theta();
+        // Matrix of elastic coefficients
+        const ChMatrixNM<double, 6, 6>& E_eps = m_layers[kl].GetMaterial()->Get_E_eps();
+
+        double zc1 = (m_GaussZ[kl + 1] - m_GaussZ[kl]) / 2;
+        double zc2 = (m_GaussZ[kl + 1] + m_GaussZ[kl]) / 2;
+
+        // The EAS Jacobian does not depend on the current configuration
+        m_KalphaEAS[kl].setZero();
+
+        int q = 0;
+        for (int ix = 0; ix < 2; ix++) {
+            for (int iy = 0; iy < 2; iy++) {
+                for (int iz = 0; iz < 2; iz++, q++) {
+                    double x = roots[ix];
+                    double y = roots[iy];
+                    double z = zc1 * roots[iz] + zc2;
+
+                    ShapeVector N;
+                    ShapeFunctions(N, x, y, z);
+
+                    // Determinant of position vector gradient matrix: Initial configuration
+                    ShapeVector Nx;
+                    ShapeVector Ny;
+                    ShapeVector Nz;
+                    ChMatrixNM<double, 1, 3> Nx_d0;
+                    ChMatrixNM<double, 1, 3> Ny_d0;
+                    ChMatrixNM<double, 1, 3> Nz_d0;
+                    double detJ0 = Calc_detJ0(x, y, z, Nx, Ny, Nz, Nx_d0, Ny_d0, Nz_d0);
+
+                    // ANS and EAS shape functions
+                    ChMatrixNM<double, 1, 4> S_ANS;
+                    ChMatrixNM<double, 6, 5> M;
+                    ShapeFunctionANSbilinearShell(S_ANS, x, y);
+                    Basis_M(M, x, y, z);
+
+                    // Tangent frame
+                    ChVector<double> G1xG2;
+                    G1xG2.x() = Nx_d0(1) * Ny_d0(2) - Nx_d0(2) * Ny_d0(1);
+                    G1xG2.y() = Nx_d0(2) * Ny_d0(0) - Nx_d0(0) * Ny_d0(2);
+                    G1xG2.z() = Nx_d0(0) * Ny_d0(1) - Nx_d0(1) * Ny_d0(0);
+                    double G1dotG1 = Nx_d0(0) * Nx_d0(0) + Nx_d0(1) * Nx_d0(1) + Nx_d0(2) * Nx_d0(2);
+
+                    ChVector<double> A1(Nx_d0(0), Nx_d0(1), Nx_d0(2));
+                    ChVector<double> A2;
+                    ChVector<double> A3;
+                    A1 = A1 / sqrt(G1dotG1);
+                    A3 = G1xG2.GetNormalized();
+                    A2.Cross(A3, A1);
+
+                    // Direction for orthotropic material
+                    ChVector<double> AA1 = A1 * cos(theta) + A2 * sin(theta);
+                    ChVector<double> AA2 = -A1 * sin(theta) + A2 * cos(theta);
+                    ChVector<double> AA3 = A3;
+
+                    // Inverse of the initial position vector gradient (j0)
+                    ChMatrixNM<double, 3, 3> j0;
+                    j0(0, 0) = Ny_d0(1) * Nz_d0(2) - Nz_d0(1) * Ny_d0(2);
+                    j0(0, 1) = Ny_d0(2) * Nz_d0(0) - Ny_d0(0) * Nz_d0(2);
+                    j0(0, 2) = Ny_d0(0) * Nz_d0(1) - Nz_d0(0) * Ny_d0(1);
+                    j0(1, 0) = Nz_d0(1) * Nx_d0(2) - Nx_d0(1) * Nz_d0(2);
+                    j0(1, 1) = Nz_d0(2) * Nx_d0(0) - Nx_d0(2) * Nz_d0(0);
+                    j0(1, 2) = Nz_d0(0) * Nx_d0(1) - Nz_d0(1) * Nx_d0(0);
+                    j0(2, 0) = Nx_d0(1) * Ny_d0(2) - Ny_d0(1) * Nx_d0(2);
+                    j0(2, 1) = Ny_d0(0) * Nx_d0(2) - Nx_d0(0) * Ny_d0(2);
+                    j0(2, 2) = Nx_d0(0) * Ny_d0(1) - Ny_d0(0) * Nx_d0(1);
+                    j0 /= detJ0;
+
+                    ChVector<double> j01(j0(0, 0), j0(0, 1), j0(0, 2));
+                    ChVector<double> j02(j0(1, 0), j0(1, 1), j0(1, 2));
+                    ChVector<double> j03(j0(2, 0), j0(2, 1), j0(2, 2));
+
+                    // Coefficients of contravariant transformation
+                    ChVectorN<double, 9> beta;
+                    beta(0) = Vdot(AA1, j01);
+                    beta(1) = Vdot(AA2, j01);
+                    beta(2) = Vdot(AA3, j01);
+                    beta(3) = Vdot(AA1, j02);
+                    beta(4) = Vdot(AA2, j02);
+                    beta(5) = Vdot(AA3, j02);
+                    beta(6) = Vdot(AA1, j03);
+                    beta(7) = Vdot(AA2, j03);
+                    beta(8) = Vdot(AA3, j03);
+
+                    // Load tables
+                    tables.Nx.col(q) = Nx.transpose();
+                    tables.Ny.col(q) = Ny.transpose();
+                    tables.N_ANS.col(q) << N(0), N(2), N(4), N(6);
+                    tables.S_ANS.col(q) = S_ANS.transpose();
+                    tables.strain0(0, q) = Nx * m_d0d0T * Nx.transpose();
+                    tables.strain0(1, q) = Ny * m_d0d0T * Ny.transpose();
+                    tables.strain0(2, q) = Nx * m_d0d0T * Ny.transpose();
+                    tables.weight(q) = weights[ix] * weights[iy] * weights[iz] * zc1 * detJ0 * m_GaussScaling;
+                    CalcStrainTransformation(beta, tables.T[q]);
+                    tables.G[q] = T0 * M * (detJ0C / detJ0);
+                    tables.g[q] = j0.row(0).transpose() * Nx + j0.row(1).transpose() * Ny + j0.row(2).transpose() * Nz;
+
+                    m_KalphaEAS[kl] += (tables.G[q].transpose() * E_eps * tables.G[q]) * tables.weight(q);
+                }
+            }
         }
     }
-    strainD_til.row(2) = tempB;
-
-    tempB.setZero();
-    for (int i = 0; i < 4; i++) {
-        tempB += N(i * 2) * m_element->m_strainANS_D.row(i);
-    }
-    strainD_til.row(3) = tempB;  // strainD for zz
-
-    tempB.setZero();
-    for (int i = 0; i < 2; i++) {
-        tempB += S_ANS(0, i + 2) * m_element->m_strainANS_D.row(i + 6);
-    }
-    strainD_til.row(4) = tempB;  // strainD for xz
-
-    tempB.setZero();
-    for (int i = 0; i < 2; i++) {
-        tempB += S_ANS(0, i) * m_element->m_strainANS_D.row(i + 4);
-    }
-    strainD_til.row(5) = tempB;  // strainD for yz
-
-    // For orthotropic material
-    ChMatrixNM<double, 6, 24> strainD;  // Derivative of the strains w.r.t. the coordinates. Includes orthotropy
-    for (int ii = 0; ii < 24; ii++) {
-        strainD(0, ii) = strainD_til(0, ii) * beta(0) * beta(0) + strainD_til(1, ii) * beta(3) * beta(3) +
-                         strainD_til(2, ii) * beta(0) * beta(3) + strainD_til(3, ii) * beta(6) * beta(6) +
-                         strainD_til(4, ii) * beta(0) * beta(6) + strainD_til(5, ii) * beta(3) * beta(6);
-        strainD(1, ii) = strainD_til(0, ii) * beta(1) * beta(1) + strainD_til(1, ii) * beta(4) * beta(4) +
-                         strainD_til(2, ii) * beta(1) * beta(4) + strainD_til(3, ii) * beta(7) * beta(7) +
-                         strainD_til(4, ii) * beta(1) * beta(7) + strainD_til(5, ii) * beta(4) * beta(7);
-        strainD(2, ii) = strainD_til(0, ii) * 2.0 * beta(0) * beta(1) + strainD_til(1, ii) * 2.0 * beta(3) * beta(4) +
-                         strainD_til(2, ii) * (beta(1) * beta(3) + beta(0) * beta(4)) +
-                         strainD_til(3, ii) * 2.0 * beta(6) * beta(7) +
-                         strainD_til(4, ii) * (beta(1) * beta(6) + beta(0) * beta(7)) +
-                         strainD_til(5, ii) * (beta(4) * beta(6) + beta(3) * beta(7));
-        strainD(3, ii) = strainD_til(0, ii) * beta(2) * beta(2) + strainD_til(1, ii) * beta(5) * beta(5) +
-                         strainD_til(2, ii) * beta(2) * beta(5) + strainD_til(3, ii) * beta(8) * beta(8) +
-                         strainD_til(4, ii) * beta(2) * beta(8) + strainD_til(5) * beta(5) * beta(8);
-        strainD(4, ii) = strainD_til(0, ii) * 2.0 * beta(0) * beta(2) + strainD_til(1, ii) * 2.0 * beta(3) * beta(5) +
-                         strainD_til(2, ii) * (beta(2) * beta(3) + beta(0) * beta(5)) +
-                         strainD_til(3, ii) * 2.0 * beta(6) * beta(8) +
-                         strainD_til(4, ii) * (beta(2) * beta(6) + beta(0) * beta(8)) +
-                         strainD_til(5, ii) * (beta(5) * beta(6) + beta(3) * beta(8));
-        strainD(5, ii) = strainD_til(0, ii) * 2.0 * beta(1) * beta(2) + strainD_til(1, ii) * 2.0 * beta(4) * beta(5) +
-                         strainD_til(2, ii) * (beta(2) * beta(4) + beta(1) * beta(5)) +
-                         strainD_til(3, ii) * 2.0 * beta(7) * beta(8) +
-                         strainD_til(4, ii) * (beta(2) * beta(7) + beta(1) * beta(8)) +
-                         strainD_til(5, ii) * (beta(5) * beta(7) + beta(4) * beta(8));
-    }
+}
 
-    // Enhanced Assumed Strain 2nd
-    strain += strain_EAS;
-
-    // Strain time derivative for structural damping
-    ChVectorN<double, 6> DEPS;
-    DEPS.setZero();
-    for (int ii = 0; ii < 24; ii++) {
-        DEPS(0) += strainD(0, ii) * m_element->m_d_dt(ii);
-        DEPS(1) += strainD(1, ii) * m_element->m_d_dt(ii);
-        DEPS(2) += strainD(2, ii) * m_element->m_d_dt(ii);
-        DEPS(3) += strainD(3, ii) * m_element->m_d_dt(ii);
-        DEPS(4) += strainD(4, ii) * m_element->m_d_dt(ii);
-        DEPS(5) += strainD(5, ii) * m_element->m_d_dt(ii);
+// Calculate the strains and strain derivatives at all Gauss points of the specified layer.
+// The strains (with structural damping, but without the EAS contribution) at the q-th point are
+// returned in the q-th column of 'strain'; the strain derivatives w.r.t. the nodal coordinates
+// are returned in rows 6q to 6q+5 of 'strainD'.
+void ChElementShellANCF::CalcLayerStrains(size_t kl,
+                                          ChMatrixNM<double, 6, 8>& strain,
+                                          ChMatrixNM<double, 48, 24>& strainD) {
+    const LayerTables& tables = m_tables[kl];
+
+    // Current position vector gradients at all points (one column per point)
+    ChMatrixNM<double, 3, 8> dNx = m_d.transpose() * tables.Nx;
+    ChMatrixNM<double, 3, 8> dNy = m_d.transpose() * tables.Ny;
+
+    // Strain components at all points
+    ChMatrixNM<double, 6, 8> strain_til;
+    strain_til.row(0) = 0.5 * (dNx.colwise().squaredNorm() - tables.strain0.row(0));
+    strain_til.row(1) = 0.5 * (dNy.colwise().squaredNorm() - tables.strain0.row(1));
+    strain_til.row(2) = dNx.cwiseProduct(dNy).colwise().sum() - tables.strain0.row(2);
+    strain_til.row(3) = m_strainANS.segment<4>(0).transpose() * tables.N_ANS;
+    strain_til.row(4) = m_strainANS.segment<2>(6).transpose() * tables.S_ANS.bottomRows<2>();
+    strain_til.row(5) = m_strainANS.segment<2>(4).transpose() * tables.S_ANS.topRows<2>();
+
+    // ANS strain derivatives at all points (one row per point)
+    ChMatrixNM<double, 8, 24> strainD_zz = tables.N_ANS.transpose() * m_strainANS_D.topRows<4>();
+    ChMatrixNM<double, 8, 24> strainD_xz = tables.S_ANS.bottomRows<2>().transpose() * m_strainANS_D.middleRows<2>(6);
+    ChMatrixNM<double, 8, 24> strainD_yz = tables.S_ANS.topRows<2>().transpose() * m_strainANS_D.middleRows<2>(4);
+
+    for (int q = 0; q < 8; q++) {
+        // Strain derivative components; entry 3*i+j of the first three rows corresponds to
+        // coordinate j of the i-th nodal vector.
+        ChMatrixNM<double, 6, 24> strainD_til;
+        Eigen::Map<Eigen::Matrix<double, 3, 8>>(strainD_til.row(0).data()) = dNx.col(q) * tables.Nx.col(q).transpose();
+        Eigen::Map<Eigen::Matrix<double, 3, 8>>(strainD_til.row(1).data()) = dNy.col(q) * tables.Ny.col(q).transpose();
+        Eigen::Map<Eigen::Matrix<double, 3, 8>>(strainD_til.row(2).data()) =
+            dNy.col(q) * tables.Nx.col(q).transpose() + dNx.col(q) * tables.Ny.col(q).transpose();
+        strainD_til.row(3) = strainD_zz.row(q);
+        strainD_til.row(4) = strainD_xz.row(q);
+        strainD_til.row(5) = strainD_yz.row(q);
+
+        // For orthotropic material.
+        // Note that, for consistency with previous results, the contribution of the yz component to the
+        // zz row uses the first entry of the yz strain derivatives for all coordinates.
+        const ChMatrixNM<double, 6, 6>& T = tables.T[q];
+        auto D = strainD.middleRows<6>(6 * q);
+        D.noalias() = T * strainD_til;
+        D.row(3) += T(3, 5) * (ChMatrixNM<double, 1, 24>::Constant(strainD_til(0, 5)) - strainD_til.row(5));
+
+        // Add structural damping
+        strain.col(q) = T * strain_til.col(q) + m_Alpha * (D * m_d_dt);
     }
-
-    // Add structural damping
-    strain += DEPS * m_element->m_Alpha;
-
-    // Matrix of elastic coefficients: the input assumes the material *could* be orthotropic
-    const ChMatrixNM<double, 6, 6>& E_eps = m_element->GetLayer(m_kl).GetMaterial()->Get_E_eps();
-
-    // Internal force calculation
-    ChVectorN<double, 24> Fint = (strainD.transpose() * E_eps * strain) * (detJ0 * m_element->m_GaussScaling);
-
-    // EAS terms
-    ChMatrixNM<double, 5, 6> temp56 = G.transpose() * E_eps;
-    ChVectorN<double, 5> HE = (temp56 * strain) * (detJ0 * m_element->m_GaussScaling);     // EAS residual
-    ChMatrixNM<double, 5, 5> KALPHA = (temp56 * G) * (detJ0 * m_element->m_GaussScaling);  // EAS Jacobian
-
-    /// Total result vector
-    result.segment(0, 24) = Fint;
-    result.segment(24, 5) = HE;
-    result.segment(29, 5 * 5) = Eigen::Map<ChVectorN<double, 5 * 5>>(KALPHA.data(), 5 * 5);
 }
 
+// -----------------------------------------------------------------------------
+// Elastic force calculation
+// -----------------------------------------------------------------------------
+
+// The internal forces are evaluated for each layer, by integrating over its Gauss points. The enhanced
+// assumed strain (EAS) and assumed natural strain (ANS) formulations are used to avoid thickness and
+// (transverse and in-plane) shear locking. Each layer has an independent, user-selected fiber angle
+// (direction for orthotropic constitutive behavior).
+// Since the EAS strain is linear in the EAS parameters, the internal force and EAS residual are
+// integrated once (at zero EAS parameters), together with the EAS cross-dependency matrix; the Newton
+// iterations for the EAS parameters then do not require new passes over the integration points.
 void ChElementShellANCF::ComputeInternalForces(ChVectorDynamic<>& Fi) {
     // Current nodal coordinates and velocities
     CalcCoordMatrix(m_d);
@@ -573,30 +525,35 @@ void ChElementShellANCF::ComputeInternalForces(ChVectorDynamic<>& Fi) {
     Fi.setZero();
 
     for (size_t kl = 0; kl < m_numLayers; kl++) {
-        ChVectorN<double, 24> Finternal;
-        ChVectorN<double, 5> HE;
-        ChMatrixNM<double, 5, 5> KALPHA;
+        const LayerTables& tables = m_tables[kl];
+        const ChMatrixNM<double, 6, 6>& E_eps = m_layers[kl].GetMaterial()->Get_E_eps();
 
-        // Initial guess for EAS parameters
-        ChVectorN<double, 5> alphaEAS = m_alphaEAS[kl];
+        ChMatrixNM<double, 6, 8> strain;
+        ChMatrixNM<double, 48, 24> strainD;
+        CalcLayerStrains(kl, strain, strainD);
+
+        // Internal force and EAS residual at zero EAS parameters, and EAS cross-dependency matrix
+        ChVectorN<double, 24> Finternal;
+        ChVectorN<double, 5> HE0;
+        ChMatrixNM<double, 5, 24> GDEPSP;
+        Finternal.setZero();
+        HE0.setZero();
+        GDEPSP.setZero();
+        for (int q = 0; q < 8; q++) {
+            auto D = strainD.middleRows<6>(6 * q);
+            ChMatrixNM<double, 5, 6> temp56 = (tables.G[q].transpose() * E_eps) * tables.weight(q);
+            ChVectorN<double, 6> stress = (E_eps * strain.col(q)) * tables.weight(q);
+            Finternal.noalias() += D.transpose() * stress;
+            HE0.noalias() += temp56 * strain.col(q);
+            GDEPSP.noalias() += temp56 * D;
+        }
 
         // Newton loop for EAS
+        ChVectorN<double, 5> alphaEAS = m_alphaEAS[kl];
+        ChVectorN<double, 5> alpha_eval = alphaEAS;
         for (int count = 0; count < m_maxIterationsEAS; count++) {
-            ShellANCF_Force formula(this, kl, &alphaEAS);
-            ChVectorN<double, 54> result;
-            result.setZero();
-            ChQuadrature::Integrate3D<ChVectorN<double, 54>>(result,                          // result of integration
-                                                             formula,                         // integrand formula
-                                                             -1, 1,                           // x limits
-                                                             -1, 1,                           // y limits
-                                                             m_GaussZ[kl], m_GaussZ[kl + 1],  // z limits
-                                                             2                                // order of integration
-            );
-
-            // Extract vectors and matrices from result of integration
-            Finternal = result.segment(0, 24);
-            HE = result.segment(24, 5);
-            KALPHA = Eigen::Map<ChMatrixNM<double, 5, 5>>(result.segment(29, 5 * 5).data(), 5, 5);
+            alpha_eval = alphaEAS;
+            ChVectorN<double, 5> HE = HE0 + m_KalphaEAS[kl] * alphaEAS;
 
             // Check convergence (residual check)
             double norm_HE = HE.norm();
@@ -604,19 +561,19 @@ void ChElementShellANCF::ComputeInternalForces(ChVectorDynamic<>& Fi) {
                 break;
 
             // Calculate increment and update EAS parameters
-            ChVectorN<double, 5> sol = KALPHA.colPivHouseholderQr().solve(HE);
+            ChVectorN<double, 5> sol = m_KalphaEAS[kl].colPivHouseholderQr().solve(HE);
             alphaEAS -= sol;
 
             if (count >= 2)
                 GetLog() << "  count " << count << "  NormHE " << norm_HE << "\n";
         }
 
-        // Accumulate internal force
+        // Accumulate internal force (including the EAS contribution at the last evaluated parameters)
+        Finternal.noalias() += GDEPSP.transpose() * alpha_eval;
         Fi -= Finternal;
 
-        // Cache alphaEAS and KALPHA for use in Jacobian calculation
+        // Cache alphaEAS for use in Jacobian calculation
         m_alphaEAS[kl] = alphaEAS;
-        m_KalphaEAS[kl] = KALPHA;
 
     }  // Layer Loop
 
@@ -629,351 +586,9 @@ void ChElementShellANCF::ComputeInternalForces(ChVectorDynamic<>& Fi) {
 // Jacobians of internal forces
 // -----------------------------------------------------------------------------
 
-// The class ShellANCF_Jacobian provides the integrand for the calculation of the Jacobians
-// (stiffness and damping matrices) of the internal forces for one layer of an ANCF
-// shell element.
-// The first 576 entries in the integrated vector represent the 24x24 Jacobian
+// For each layer, the integrand at a Gauss point consists of the 24x24 Jacobian
 //      Kfactor * [K] + Rfactor * [R]
-// where K does not include the EAS contribution.
-// The last 120 entries represent the 5x24 cross-dependency matrix.
-class ShellANCF_Jacobian : public ChIntegrable3D<ChVectorN<double, 696>> {
-  public:
-    ShellANCF_Jacobian(ChElementShellANCF* element,  // Containing element
-                       double Kfactor,               // Scaling coefficient for stiffness component
-                       double Rfactor,               // Scaling coefficient for damping component
-                       size_t kl                     // Current layer index
-                       )
-        : m_element(element), m_Kfactor(Kfactor), m_Rfactor(Rfactor), m_kl(kl) {}
-
-  private:
-    ChElementShellANCF* m_element;
-    double m_Kfactor;
-    double m_Rfactor;
-    size_t m_kl;
-
-    // Evaluate integrand at the specified point.
-    virtual void Evaluate(ChVectorN<double, 696>& result, const double x, const double y, const double z) override;
-};
-
-void ShellANCF_Jacobian::Evaluate(ChVectorN<double, 696>& result, const double x, const double y, const double z) {
-    // Element shape function
-    ChElementShellANCF::ShapeVector N;
-    m_element->ShapeFunctions(N, x, y, z);
-
-    // Determinant of position vector gradient matrix: Initial configuration
-    ChElementShellANCF::ShapeVector Nx;
-    ChElementShellANCF::ShapeVector Ny;
-    ChElementShellANCF::ShapeVector Nz;
-    ChMatrixNM<double, 1, 3> Nx_d0;
-    ChMatrixNM<double, 1, 3> Ny_d0;
-    ChMatrixNM<double, 1, 3> Nz_d0;
-    double detJ0 = m_element->Calc_detJ0(x, y, z, Nx, Ny, Nz, Nx_d0, Ny_d0, Nz_d0);
-
-    // ANS shape function
-    ChMatrixNM<double, 1, 4> S_ANS;  // Shape function vector for Assumed Natural Strain
-    ChMatrixNM<double, 6, 5> M;      // Shape function vector for Enhanced Assumed Strain
-    m_element->ShapeFunctionANSbilinearShell(S_ANS, x, y);
-    m_element->Basis_M(M, x, y, z);
-
-    // Transformation : Orthogonal transformation (A and J)
-    ChVector<double> G1xG2;  // Cross product of first and second column of
-    double G1dotG1;          // Dot product of first column of position vector gradient
-
-    G1xG2.x() = Nx_d0(1) * Ny_d0(2) - Nx_d0(2) * Ny_d0(1);
-    G1xG2.y() = Nx_d0(2) * Ny_d0(0) - Nx_d0(0) * Ny_d0(2);
-    G1xG2.z() = Nx_d0(0) * Ny_d0(1) - Nx_d0(1) * Ny_d0(0);
-    G1dotG1 = Nx_d0(0) * Nx_d0(0) + Nx_d0(1) * Nx_d0(1) + Nx_d0(2) * Nx_d0(2);
-
-    // Tangent Frame
-    ChVector<double> A1;
-    ChVector<double> A2;
-    ChVector<double> A3;
-    A1.x() = Nx_d0(0);
-    A1.y() = Nx_d0(1);
-    A1.z() = Nx_d0(2);
-    A1 = A1 / sqrt(G1dotG1);
-    A3 = G1xG2.GetNormalized();
-    A2.Cross(A3, A1);
-
-    // Direction for orthotropic material
-    double theta = m_element->GetLayer(m_kl).Get_theta();  // Fiber angle
-    ChVector<double> AA1;
-    ChVector<double> AA2;
-    ChVector<double> AA3;
-    AA1 = A1 * cos(theta) + A2 * sin(theta);
-    AA2 = -A1 * sin(theta) + A2 * cos(theta);
-    AA3 = A3;
-
-    /// Beta
-    ChMatrixNM<double, 3, 3> j0;
-    ChVector<double> j01;
-    ChVector<double> j02;
-    ChVector<double> j03;
-    // Calculates inverse of rd0 (j0) (position vector gradient: Initial Configuration)
-    j0(0, 0) = Ny_d0(1) * Nz_d0(2) - Nz_d0(1) * Ny_d0(2);
-    j0(0, 1) = Ny_d0(2) * Nz_d0(0) - Ny_d0(0) * Nz_d0(2);
-    j0(0, 2) = Ny_d0(0) * Nz_d0(1) - Nz_d0(0) * Ny_d0(1);
-    j0(1, 0) = Nz_d0(1) * Nx_d0(2) - Nx_d0(1) * Nz_d0(2);
-    j0(1, 1) = Nz_d0(2) * Nx_d0(0) - Nx_d0(2) * Nz_d0(0);
-    j0(1, 2) = Nz_d0(0) * Nx_d0(1) - Nz_d0(1) * Nx_d0(0);
-    j0(2, 0) = Nx_d0(1) * Ny_d0(2) - Ny_d0(1) * Nx_d0(2);
-    j0(2, 1) = Ny_d0(0) * Nx_d0(2) - Nx_d0(0) * Ny_d0(2);
-    j0(2, 2) = Nx_d0(0) * Ny_d0(1) - Ny_d0(0) * Nx_d0(1);
-    j0 /= detJ0;
-
-    j01[0] = j0(0, 0);
-    j02[0] = j0(1, 0);
-    j03[0] = j0(2, 0);
-    j01[1] = j0(0, 1);
-    j02[1] = j0(1, 1);
-    j03[1] = j0(2, 1);
-    j01[2] = j0(0, 2);
-    j02[2] = j0(1, 2);
-    j03[2] = j0(2, 2);
-
-    // Coefficients of contravariant transformation
-    ChVectorN<double, 9> beta;
-    beta(0) = Vdot(AA1, j01);
-    beta(1) = Vdot(AA2, j01);
-    beta(2) = Vdot(AA3, j01);
-    beta(3) = Vdot(AA1, j02);
-    beta(4) = Vdot(AA2, j02);
-    beta(5) = Vdot(AA3, j02);
-    beta(6) = Vdot(AA1, j03);
-    beta(7) = Vdot(AA2, j03);
-    beta(8) = Vdot(AA3, j03);
-
-    // Transformation matrix, function of fiber angle
-    const ChMatrixNM<double, 6, 6>& T0 = m_element->GetLayer(m_kl).Get_T0();
-    // Determinant of the initial position vector gradient at the element center
-    double detJ0C = m_element->GetLayer(m_kl).Get_detJ0C();
-
-    // Enhanced Assumed Strain
-    ChMatrixNM<double, 6, 5> G = T0 * M * (detJ0C / detJ0);
-    ChVectorN<double, 6> strain_EAS = G * m_element->m_alphaEAS[m_kl];
-
-    ChVectorN<double, 8> ddNx = m_element->m_ddT * Nx.transpose();
-    ChVectorN<double, 8> ddNy = m_element->m_ddT * Ny.transpose();
-    ChVectorN<double, 8> ddNz = m_element->m_ddT * Nz.transpose();
-
-    ChVectorN<double, 8> d0d0Nx = m_element->m_d0d0T * Nx.transpose();
-    ChVectorN<double, 8> d0d0Ny = m_element->m_d0d0T * Ny.transpose();
-    ChVectorN<double, 8> d0d0Nz = m_element->m_d0d0T * Nz.transpose();
-
-    // Strain component
-    ChVectorN<double, 6> strain_til;
-    strain_til(0) = 0.5 * ((Nx * ddNx)(0, 0) - (Nx * d0d0Nx)(0, 0));
-    strain_til(1) = 0.5 * ((Ny * ddNy)(0, 0) - (Ny * d0d0Ny)(0, 0));
-    strain_til(2) = (Nx * ddNy)(0, 0) - (Nx * d0d0Ny)(0, 0);
-    strain_til(3) = N(0) * m_element->m_strainANS(0) + N(2) * m_element->m_strainANS(1) +
-                    N(4) * m_element->m_strainANS(2) + N(6) * m_element->m_strainANS(3);
-    strain_til(4) = S_ANS(0, 2) * m_element->m_strainANS(6) + S_ANS(0, 3) * m_element->m_strainANS(7);
-    strain_til(5) = S_ANS(0, 0) * m_element->m_strainANS(4) + S_ANS(0, 1) * m_element->m_strainANS(5);
-
-    // For orthotropic material
-    ChVectorN<double, 6> strain;
-
-    strain(0) = strain_til(0) * beta(0) * beta(0) + strain_til(1) * beta(3) * beta(3) +
-                strain_til(2) * beta(0) * beta(3) + strain_til(3) * beta(6) * beta(6) +
-                strain_til(4) * beta(0) * beta(6) + strain_til(5) * beta(3) * beta(6);
-    strain(1) = strain_til(0) * beta(1) * beta(1) + strain_til(1) * beta(4) * beta(4) +
-                strain_til(2) * beta(1) * beta(4) + strain_til(3) * beta(7) * beta(7) +
-                strain_til(4) * beta(1) * beta(7) + strain_til(5) * beta(4) * beta(7);
-    strain(2) = strain_til(0) * 2.0 * beta(0) * beta(1) + strain_til(1) * 2.0 * beta(3) * beta(4) +
-                strain_til(2) * (beta(1) * beta(3) + beta(0) * beta(4)) + strain_til(3) * 2.0 * beta(6) * beta(7) +
-                strain_til(4) * (beta(1) * beta(6) + beta(0) * beta(7)) +
-                strain_til(5) * (beta(4) * beta(6) + beta(3) * beta(7));
-    strain(3) = strain_til(0) * beta(2) * beta(2) + strain_til(1) * beta(5) * beta(5) +
-                strain_til(2) * beta(2) * beta(5) + strain_til(3) * beta(8) * beta(8) +
-                strain_til(4) * beta(2) * beta(8) + strain_til(5) * beta(5) * beta(8);
-    strain(4) = strain_til(0) * 2.0 * beta(0) * beta(2) + strain_til(1) * 2.0 * beta(3) * beta(5) +
-                strain_til(2) * (beta(2) * beta(3) + beta(0) * beta(5)) + strain_til(3) * 2.0 * beta(6) * beta(8) +
-                strain_til(4) * (beta(2) * beta(6) + beta(0) * beta(8)) +
-                strain_til(5) * (beta(5) * beta(6) + beta(3) * beta(8));
-    strain(5) = strain_til(0) * 2.0 * beta(1) * beta(2) + strain_til(1) * 2.0 * beta(4) * beta(5) +
-                strain_til(2) * (beta(2) * beta(4) + beta(1) * beta(5)) + strain_til(3) * 2.0 * beta(7) * beta(8) +
-                strain_til(4) * (beta(2) * beta(7) + beta(1) * beta(8)) +
-                strain_til(5) * (beta(5) * beta(7) + beta(4) * beta(8));
-
-    // Strain derivative component
-
-    ChMatrixNM<double, 6, 24> strainD_til;
-    strainD_til.setZero();
-
-    ChMatrixNM<double, 1, 24> tempB;
-    ChMatrixNM<double, 1, 3> tempB3;
-    ChMatrixNM<double, 1, 3> tempB31;
-
-    tempB3 = Nx * m_element->m_d;
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 3; j++) {
-            tempB(0, i * 3 + j) = tempB3(0, j) * Nx(0, i);
-        }
-    }
-    strainD_til.row(0) = tempB;
-
-    tempB3 = Ny * m_element->m_d;
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 3; j++) {
-            tempB(0, i * 3 + j) = tempB3(0, j) * Ny(0, i);
-        }
-    }
-    strainD_til.row(1) = tempB;
-
-    tempB31 = Nx * m_element->m_d;
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 3; j++) {
-            tempB(0, i * 3 + j) = tempB3(0, j) * Nx(0, i) + tempB31(0, j) * Ny(0, i);
-        }
-    }
-    strainD_til.row(2) = tempB;
-
-    tempB.setZero();
-    for (int i = 0; i < 4; i++) {
-        tempB += N(i * 2) * m_element->m_strainANS_D.row(i);
-    }
-    strainD_til.row(3) = tempB;  // strainD for zz
-
-    tempB.setZero();
-    for (int i = 0; i < 2; i++) {
-        tempB += S_ANS(0, i + 2) * m_element->m_strainANS_D.row(i + 6);
-    }
-    strainD_til.row(4) = tempB;  // strainD for xz
-
-    tempB.setZero();
-    for (int i = 0; i < 2; i++) {
-        int ij = i + 4;
-        int ij1 = i;
-        tempB += S_ANS(0, i) * m_element->m_strainANS_D.row(i + 4);
-    }
-    strainD_til.row(5) = tempB;  // strainD for yz
-
-    //// For orthotropic material
-    ChMatrixNM<double, 6, 24> strainD;  // Derivative of the strains w.r.t. the coordinates. Includes orthotropy
-    for (int ii = 0; ii < 24; ii++) {
-        strainD(0, ii) = strainD_til(0, ii) * beta(0) * beta(0) + strainD_til(1, ii) * beta(3) * beta(3) +
-                         strainD_til(2, ii) * beta(0) * beta(3) + strainD_til(3, ii) * beta(6) * beta(6) +
-                         strainD_til(4, ii) * beta(0) * beta(6) + strainD_til(5, ii) * beta(3) * beta(6);
-        strainD(1, ii) = strainD_til(0, ii) * beta(1) * beta(1) + strainD_til(1, ii) * beta(4) * beta(4) +
-                         strainD_til(2, ii) * beta(1) * beta(4) + strainD_til(3, ii) * beta(7) * beta(7) +
-                         strainD_til(4, ii) * beta(1) * beta(7) + strainD_til(5, ii) * beta(4) * beta(7);
-        strainD(2, ii) = strainD_til(0, ii) * 2.0 * beta(0) * beta(1) + strainD_til(1, ii) * 2.0 * beta(3) * beta(4) +
-                         strainD_til(2, ii) * (beta(1) * beta(3) + beta(0) * beta(4)) +
-                         strainD_til(3, ii) * 2.0 * beta(6) * beta(7) +
-                         strainD_til(4, ii) * (beta(1) * beta(6) + beta(0) * beta(7)) +
-                         strainD_til(5, ii) * (beta(4) * beta(6) + beta(3) * beta(7));
-        strainD(3, ii) = strainD_til(0, ii) * beta(2) * beta(2) + strainD_til(1, ii) * beta(5) * beta(5) +
-                         strainD_til(2, ii) * beta(2) * beta(5) + strainD_til(3, ii) * beta(8) * beta(8) +
-                         strainD_til(4, ii) * beta(2) * beta(8) + strainD_til(5) * beta(5) * beta(8);
-        strainD(4, ii) = strainD_til(0, ii) * 2.0 * beta(0) * beta(2) + strainD_til(1, ii) * 2.0 * beta(3) * beta(5) +
-                         strainD_til(2, ii) * (beta(2) * beta(3) + beta(0) * beta(5)) +
-                         strainD_til(3, ii) * 2.0 * beta(6) * beta(8) +
-                         strainD_til(4, ii) * (beta(2) * beta(6) + beta(0) * beta(8)) +
-                         strainD_til(5, ii) * (beta(5) * beta(6) + beta(3) * beta(8));
-        strainD(5, ii) = strainD_til(0, ii) * 2.0 * beta(1) * beta(2) + strainD_til(1, ii) * 2.0 * beta(4) * beta(5) +
-                         strainD_til(2, ii) * (beta(2) * beta(4) + beta(1) * beta(5)) +
-                         strainD_til(3, ii) * 2.0 * beta(7) * beta(8) +
-                         strainD_til(4, ii) * (beta(2) * beta(7) + beta(1) * beta(8)) +
-                         strainD_til(5, ii) * (beta(5) * beta(7) + beta(4) * beta(8));
-    }
-
-    /// Gd : Jacobian (w.r.t. coordinates) of the initial position vector gradient matrix
-    ChMatrixNM<double, 9, 24> Gd;
-    Gd.setZero();
-
-    for (int ii = 0; ii < 8; ii++) {
-        Gd(0, 3 * ii) = j0(0, 0) * Nx(0, ii) + j0(1, 0) * Ny(0, ii) + j0(2, 0) * Nz(0, ii);
-        Gd(1, 3 * ii + 1) = j0(0, 0) * Nx(0, ii) + j0(1, 0) * Ny(0, ii) + j0(2, 0) * Nz(0, ii);
-        Gd(2, 3 * ii + 2) = j0(0, 0) * Nx(0, ii) + j0(1, 0) * Ny(0, ii) + j0(2, 0) * Nz(0, ii);
-
-        Gd(3, 3 * ii) = j0(0, 1) * Nx(0, ii) + j0(1, 1) * Ny(0, ii) + j0(2, 1) * Nz(0, ii);
-        Gd(4, 3 * ii + 1) = j0(0, 1) * Nx(0, ii) + j0(1, 1) * Ny(0, ii) + j0(2, 1) * Nz(0, ii);
-        Gd(5, 3 * ii + 2) = j0(0, 1) * Nx(0, ii) + j0(1, 1) * Ny(0, ii) + j0(2, 1) * Nz(0, ii);
-
-        Gd(6, 3 * ii) = j0(0, 2) * Nx(0, ii) + j0(1, 2) * Ny(0, ii) + j0(2, 2) * Nz(0, ii);
-        Gd(7, 3 * ii + 1) = j0(0, 2) * Nx(0, ii) + j0(1, 2) * Ny(0, ii) + j0(2, 2) * Nz(0, ii);
-        Gd(8, 3 * ii + 2) = j0(0, 2) * Nx(0, ii) + j0(1, 2) * Ny(0, ii) + j0(2, 2) * Nz(0, ii);
-    }
-
-    // Enhanced Assumed Strain 2nd
-    strain += strain_EAS;
-
-    // Structural damping
-    // Strain time derivative for structural damping
-    ChVectorN<double, 6> DEPS;
-    DEPS.setZero();
-    for (int ii = 0; ii < 24; ii++) {
-        DEPS(0) += strainD(0, ii) * m_element->m_d_dt(ii);
-        DEPS(1) += strainD(1, ii) * m_element->m_d_dt(ii);
-        DEPS(2) += strainD(2, ii) * m_element->m_d_dt(ii);
-        DEPS(3) += strainD(3, ii) * m_element->m_d_dt(ii);
-        DEPS(4) += strainD(4, ii) * m_element->m_d_dt(ii);
-        DEPS(5) += strainD(5, ii) * m_element->m_d_dt(ii);
-    }
-
-    // Add structural damping
-    strain += DEPS * m_element->m_Alpha;
-
-    // Matrix of elastic coefficients: The input assumes the material *could* be orthotropic
-    const ChMatrixNM<double, 6, 6>& E_eps = m_element->GetLayer(m_kl).GetMaterial()->Get_E_eps();
-
-    // Stress tensor calculation
-    ChVectorN<double, 6> stress = E_eps * strain;
-
-    // Declaration and computation of Sigm, to be removed
-    ChMatrixNM<double, 9, 9> Sigm;  ///< Rearrangement of stress vector (not always needed)
-    Sigm.setZero();
-
-    Sigm(0, 0) = stress(0);  // XX
-    Sigm(1, 1) = stress(0);
-    Sigm(2, 2) = stress(0);
-
-    Sigm(0, 3) = stress(2);  // XY
-    Sigm(1, 4) = stress(2);
-    Sigm(2, 5) = stress(2);
-
-    Sigm(0, 6) = stress(4);  // XZ
-    Sigm(1, 7) = stress(4);
-    Sigm(2, 8) = stress(4);
-
-    Sigm(3, 0) = stress(2);  // XY
-    Sigm(4, 1) = stress(2);
-    Sigm(5, 2) = stress(2);
-
-    Sigm(3, 3) = stress(1);  // YY
-    Sigm(4, 4) = stress(1);
-    Sigm(5, 5) = stress(1);
-
-    Sigm(3, 6) = stress(5);  // YZ
-    Sigm(4, 7) = stress(5);
-    Sigm(5, 8) = stress(5);
-
-    Sigm(6, 0) = stress(4);  // XZ
-    Sigm(7, 1) = stress(4);
-    Sigm(8, 2) = stress(4);
-
-    Sigm(6, 3) = stress(5);  // YZ
-    Sigm(7, 4) = stress(5);
-    Sigm(8, 5) = stress(5);
-
-    Sigm(6, 6) = stress(3);  // ZZ
-    Sigm(7, 7) = stress(3);
-    Sigm(8, 8) = stress(3);
-
-    // Jacobian of internal forces (excluding the EAS contribution).
-    ChMatrixNM<double, 24, 24> KTE;
-    KTE = (strainD.transpose() * E_eps * strainD) * (m_Kfactor + m_Rfactor * m_element->m_Alpha) +
-          (Gd.transpose() * Sigm * Gd) * m_Kfactor;
-    KTE *= detJ0 * m_element->m_GaussScaling;
-
-    // EAS cross-dependency matrix.
-    ChMatrixNM<double, 5, 24> GDEPSP = (G.transpose() * E_eps * strainD) * (detJ0 * m_element->m_GaussScaling);
-
-    // Load result vector (integrand)
-    result.segment(0, 24 * 24) = Eigen::Map<ChVectorN<double, 24 * 24>>(KTE.data(), 24 * 24);
-    result.segment(576, 5 * 24) = Eigen::Map<ChVectorN<double, 5 * 24>>(GDEPSP.data(), 5 * 24);
-}
-
+// where K does not include the EAS contribution, and of the 5x24 EAS cross-dependency matrix.
 void ChElementShellANCF::ComputeInternalJacobians(double Kfactor, double Rfactor) {
     // Note that the matrices with current nodal coordinates and velocities are
     // already available in m_d and m_d_dt (as set in ComputeInternalForces).
@@ -984,22 +599,45 @@ void ChElementShellANCF::ComputeInternalJacobians(double Kfactor, double Rfactor
 
     // Loop over all layers.
     for (size_t kl = 0; kl < m_numLayers; kl++) {
-        ShellANCF_Jacobian formula(this, Kfactor, Rfactor, kl);
-        ChVectorN<double, 696> result;
-        result.setZero();
-        ChQuadrature::Integrate3D<ChVectorN<double, 696>>(result,                          // result of integration
-                                                          formula,                         // integrand formula
-                                                          -1, 1,                           // x limits
-                                                          -1, 1,                           // y limits
-                                                          m_GaussZ[kl], m_GaussZ[kl + 1],  // z limits
-                                                          2                                // order of integration
-        );
+        const LayerTables& tables = m_tables[kl];
+        const ChMatrixNM<double, 6, 6>& E_eps = m_layers[kl].GetMaterial()->Get_E_eps();
+
+        ChMatrixNM<double, 6, 8> strain;
+        ChMatrixNM<double, 48, 24> strainD;
+        CalcLayerStrains(kl, strain, strainD);
 
-        // Extract matrices from result of integration
         ChMatrixNM<double, 24, 24> KTE;
         ChMatrixNM<double, 5, 24> GDEPSP;
-        KTE = Eigen::Map<ChMatrixNM<double, 24, 24>>(result.segment(0, 24 * 24).data(), 24, 24);
-        GDEPSP = Eigen::Map<ChMatrixNM<double, 5, 24>>(result.segment(576, 5 * 24).data(), 5, 24);
+        KTE.setZero();
+        GDEPSP.setZero();
+
+        for (int q = 0; q < 8; q++) {
+            auto D = strainD.middleRows<6>(6 * q);
+            double weight = tables.weight(q);
+
+            // Stress (including the EAS contribution)
+            ChVectorN<double, 6> stress = E_eps * (strain.col(q) + tables.G[q] * m_alphaEAS[kl]);
+
+            // Material stiffness and damping, and EAS cross-dependency matrix
+            ChMatrixNM<double, 6, 24> ED = E_eps * D;
+            KTE.noalias() += (D.transpose() * ED) * (weight * (Kfactor + Rfactor * m_Alpha));
+            GDEPSP.noalias() += (tables.G[q].transpose() * ED) * weight;
+
+            // Geometric stiffness. With Gd the Jacobian of the position vector gradient and Sigm the
+            // rearranged stress, Gd' * Sigm * Gd = kron(g' * S * g, eye(3)), with S the 3x3 stress tensor.
+            ChMatrixNM<double, 3, 3> S;
+            S << stress(0), stress(2), stress(4),  //
+                stress(2), stress(1), stress(5),   //
+                stress(4), stress(5), stress(3);
+            ChMatrixNM<double, 8, 8> gSg = (tables.g[q].transpose() * S * tables.g[q]) * (weight * Kfactor);
+            for (int i = 0; i < 8; i++) {
+                for (int j = 0; j < 8; j++) {
+                    KTE(3 * i + 0, 3 * j + 0) += gSg(i, j);
+                    KTE(3 * i + 1, 3 * j + 1) += gSg(i, j);
+                    KTE(3 * i + 2, 3 * j + 2) += gSg(i, j);
+                }
+            }
+        }
 
         // Include EAS contribution to the stiffness component (hence scaled by Kfactor)
         // EAS = GDEPSP' * KalphaEAS_inv * GDEPSP
@@ -1823,48 +1461,8 @@ void ChElementShellANCF::Layer::SetupInitial() {
     beta(7) = Vdot(AA2, j03);
     beta(8) = Vdot(AA3, j03);
 
-    // Calculate T0: transformation matrix, function of fiber angle (see Yamashita et al, 2015, JCND)
-    m_T0(0, 0) = pow(beta(0), 2);
-    m_T0(1, 0) = pow(beta(1), 2);
-    m_T0(2, 0) = 2.0 * beta(0) * beta(1);
-    m_T0(3, 0) = pow(beta(2), 2);
-    m_T0(4, 0) = 2.0 * beta(0) * beta(2);
-    m_T0(5, 0) = 2.0 * beta(1) * beta(2);
-
-    m_T0(0, 1) = pow(beta(3), 2);
-    m_T0(1, 1) = pow(beta(4), 2);
-    m_T0(2, 1) = 2.0 * beta(3) * beta(4);
-    m_T0(3, 1) = pow(beta(5), 2);
-    m_T0(4, 1) = 2.0 * beta(3) * beta(5);
-    m_T0(5, 1) = 2.0 * beta(4) * beta(5);
-
-    m_T0(0, 2) = beta(0) * beta(3);
-    m_T0(1, 2) = beta(1) * beta(4);
-    m_T0(2, 2) = beta(0) * beta(4) + beta(1) * beta(3);
-    m_T0(3, 2) = beta(2) * beta(5);
-    m_T0(4, 2) = beta(0) * beta(5) + beta(2) * beta(3);
-    m_T0(5, 2) = beta(2) * beta(4) + beta(1) * beta(5);
-
-    m_T0(0, 3) = pow(beta(6), 2);
-    m_T0(1, 3) = pow(beta(7), 2);
-    m_T0(2, 3) = 2.0 * beta(6) * beta(7);
-    m_T0(3, 3) = pow(beta(8), 2);
-    m_T0(4, 3) = 2.0 * beta(6) * beta(8);
-    m_T0(5, 3) = 2.0 * beta(7) * beta(8);
-
-    m_T0(0, 4) = beta(0) * beta(6);
-    m_T0(1, 4) = beta(1) * beta(7);
-    m_T0(2, 4) = beta(0) * beta(7) + beta(6) * beta(1);
-    m_T0(3, 4) = beta(2) * beta(8);
-    m_T0(4, 4) = beta(0) * beta(8) + beta(2) * beta(6);
-    m_T0(5, 4) = beta(1) * beta(8) + beta(2) * beta(7);
-
-    m_T0(0, 5) = beta(3) * beta(6);
-    m_T0(1, 5) = beta(4) * beta(7);
-    m_T0(2, 5) = beta(3) * beta(7) + beta(4) * beta(6);
-    m_T0(3, 5) = beta(5) * beta(8);
-    m_T0(4, 5) = beta(3) * beta(8) + beta(6) * beta(5);
-    m_T0(5, 5) = beta(4) * beta(8) + beta(5) * beta(7);
+    // Calculate T0: transformation matrix, function of fiber angle
+    CalcStrainTransformation(beta, m_T0);
 }
 
 }  // end of namespace fea
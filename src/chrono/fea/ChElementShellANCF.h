@@ -88,8 +88,6 @@ class ChApi ChElementShellANCF : public ChElementShell, public ChLoadableUV, pub
         EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
         friend class ChElementShellANCF;
-        friend class ShellANCF_Force;
-        friend class ShellANCF_Jacobian;
     };
 
     /// Get the number of nodes used by this element.
@@ -244,6 +242,13 @@ class ChApi ChElementShellANCF : public ChElementShell, public ChLoadableUV, pub
     /// Compute the gravitational forces.
     void ComputeGravityForce(const ChVector<>& g_acc);
 
+    // Calculate the tables of reference-configuration quantities at the Gauss points of all layers.
+    void CalcLayerTables();
+
+    // Calculate the strains (without EAS contribution) and the strain derivatives at all Gauss points of the
+    // specified layer, for the current nodal coordinates and velocities.
+    void CalcLayerStrains(size_t kl, ChMatrixNM<double, 6, 8>& strain, ChMatrixNM<double, 48, 24>& strainD);
+
     // [ANS] Shape function for Assumed Naturals Strain (Interpolation of strain and strainD in a thickness direction)
     void ShapeFunctionANSbilinearShell(ChMatrixNM<double, 1, 4>& S_ANS, double x, double y);
 
@@ -350,6 +355,23 @@ class ChApi ChElementShellANCF : public ChElementShell, public ChLoadableUV, pub
     virtual ChVector<> ComputeNormal(const double U, const double V) override;
 
   private:
+    /// Quantities at the 2x2x2 Gauss points of a layer which depend only on the initial configuration.
+    /// Shape function values are stored in SoA form (one column per integration point), so that the current
+    /// position vector gradients and ANS strains at all points of a layer are obtained with a few matrix products.
+    struct LayerTables {
+        ChMatrixNM<double, 8, 8> Nx;       ///< shape function derivatives w.r.t. x
+        ChMatrixNM<double, 8, 8> Ny;       ///< shape function derivatives w.r.t. y
+        ChMatrixNM<double, 4, 8> N_ANS;    ///< bilinear shape functions (interpolation of ANS thickness strain)
+        ChMatrixNM<double, 4, 8> S_ANS;    ///< ANS shape functions (interpolation of ANS transverse shear strains)
+        ChMatrixNM<double, 3, 8> strain0;  ///< in-plane strain terms of the initial configuration
+        ChVectorN<double, 8> weight;       ///< integration weights (including detJ0 and interval scaling)
+        ChMatrixNM<double, 6, 6> T[8];     ///< strain transformation matrices (orthotropy)
+        ChMatrixNM<double, 6, 5> G[8];     ///< EAS matrices T0 * M * detJ0C / detJ0
+        ChMatrixNM<double, 3, 8> g[8];     ///< shape function gradients j0^T * [Nx; Ny; Nz]
+
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    };
+
     /// Initial setup. This is used to precompute matrices that do not change during the simulation, such as the local
     /// stiffness of each element (if any), the mass, etc.
     virtual void SetupInitial(ChSystem* system) override;
@@ -379,6 +401,7 @@ class ChApi ChElementShellANCF : public ChElementShell, public ChLoadableUV, pub
     ChMatrixNM<double, 8, 24> m_strainANS_D;            ///< ANS strain derivatives
     std::vector<ChVectorN<double, 5>> m_alphaEAS;       ///< EAS parameters (5 per layer)
     std::vector<ChMatrixNM<double, 5, 5>> m_KalphaEAS;  ///< EAS Jacobians (a 5x5 matrix per layer)
+    std::vector<LayerTables, Eigen::aligned_allocator<LayerTables>> m_tables;  ///< Gauss point tables (per layer)
     static const double m_toleranceEAS;                 ///< tolerance for nonlinear EAS solver (on residual)
     static const int m_maxIterationsEAS;                ///< maximum number of nonlinear EAS iterations
 
@@ -387,8 +410,6 @@ class ChApi ChElementShellANCF : public ChElementShell, public ChLoadableUV, pub
 
     friend class ShellANCF_Mass;
     friend class ShellANCF_Gravity;
-    friend class ShellANCF_Force;
-    friend class ShellANCF_Jacobian;
 };
 
 /// @} fea_elements
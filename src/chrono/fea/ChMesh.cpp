@@ -18,11 +18,13 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 
 #include "chrono/core/ChMath.h"
 #include "chrono/physics/ChLoad.h"
 #include "chrono/physics/ChObject.h"
 #include "chrono/physics/ChSystem.h"
+#include "chrono/parallel/ChOpenMP.h"
 
 #include "chrono/fea/ChElementTetra_4.h"
 #include "chrono/fea/ChMesh.h"
@@ -46,6 +48,9 @@ ChMesh::ChMesh(const ChMesh& other) : ChIndexedNodes(other) {
     automatic_gravity_load = other.automatic_gravity_load;
     num_points_gravity = other.num_points_gravity;
 
+    assembly_mode = other.assembly_mode;
+    colors_dirty = true;
+
     ncalls_internal_forces = 0;
     ncalls_KRMload = 0;
 }
@@ -94,7 +99,9 @@ void ChMesh::AddNode(std::shared_ptr<ChNodeFEAbase> m_node) {
 }
 
 void ChMesh::AddElement(std::shared_ptr<ChElementBase> m_elem) {
+    m_elem->atomic_scatter = (assembly_mode == AssemblyMode::ATOMIC);
     velements.push_back(m_elem);
+    colors_dirty = true;
 
     // If the mesh is already added to a system, mark the system uninitialized and out-of-date
     if (system) {
@@ -105,6 +112,7 @@ void ChMesh::AddElement(std::shared_ptr<ChElementBase> m_elem) {
 
 void ChMesh::ClearElements() {
     velements.clear();
+    colors_dirty = true;
     vcontactsurfaces.clear();
 
     // If the mesh is already added to a system, mark the system out-of-date
@@ -117,6 +125,7 @@ void ChMesh::ClearNodes() {
     velements.clear();
     vnodes.clear();
     vcontactsurfaces.clear();
+    colors_dirty = true;
 
     // If the mesh is already added to a system, mark the system out-of-date
     if (system) {
@@ -133,6 +142,73 @@ void ChMesh::ClearContactSurfaces() {
     vcontactsurfaces.clear();
 }
 
+void ChMesh::SetAssemblyMode(AssemblyMode mode) {
+    assembly_mode = mode;
+    for (auto& element : velements)
+        element->atomic_scatter = (mode == AssemblyMode::ATOMIC);
+
+    colors.clear();
+    colors_dirty = true;
+    thread_R.clear();
+}
+
+// Greedy (first-fit) coloring of the elements: an element is assigned the first color not already used by any
+// element sharing one of its nodes.
+void ChMesh::UpdateColors() {
+    colors.clear();
+
+    std::unordered_map<ChNodeFEAbase*, std::vector<int>> node_colors;  // colors of the elements using each node
+    std::vector<int> stamp;                                            // last element forbidding each color
+
+    for (int ie = 0; ie < (int)velements.size(); ie++) {
+        auto& element = velements[ie];
+        int nnodes = element->GetNnodes();
+
+        for (int in = 0; in < nnodes; in++) {
+            auto node_color = node_colors.find(element->GetNodeN(in).get());
+            if (node_color != node_colors.end()) {
+                for (auto c : node_color->second)
+                    stamp[c] = ie;
+            }
+        }
+
+        int color = 0;
+        while (color < (int)colors.size() && stamp[color] == ie)
+            color++;
+        if (color == (int)colors.size()) {
+            colors.push_back(std::vector<int>());
+            stamp.push_back(-1);
+        }
+        colors[color].push_back(ie);
+
+        for (int in = 0; in < nnodes; in++)
+            node_colors[element->GetNodeN(in).get()].push_back(color);
+    }
+
+    colors_dirty = false;
+}
+
+void ChMesh::ResetThreadVectors(int size) {
+    int nthreads = CHOMPfunctions::GetMaxThreads();
+    thread_R.resize(nthreads);
+
+#pragma omp parallel num_threads(nthreads)
+    thread_R[CHOMPfunctions::GetThreadNum()].setZero(size);
+}
+
+void ChMesh::ReduceThreadVectors(ChVectorDynamic<>& R) {
+    const int block = 1024;
+    int nblocks = ((int)R.size() + block - 1) / block;
+
+#pragma omp parallel for schedule(static)
+    for (int ib = 0; ib < nblocks; ib++) {
+        int start = ib * block;
+        int len = std::min(block, (int)R.size() - start);
+        for (auto& Rt : thread_R)
+            R.segment(start, len) += Rt.segment(start, len);
+    }
+}
+
 void ChMesh::AddMeshSurface(std::shared_ptr<ChMeshSurface> m_surf) {
     m_surf->SetMesh(this);
     vmeshsurfaces.push_back(m_surf);
@@ -281,35 +357,90 @@ void ChMesh::IntLoadResidual_F(const unsigned int off,
         }
     }
 
+    // Apply gravity loads without the need of adding
+    // a ChLoad object to each element: just instance here a single ChLoad (one per thread, if processing elements
+    // in parallel) and reuse it for all 'volume' objects.
+    ChVector<> G_acc = automatic_gravity_load ? GetSystem()->Get_G_acc() : VNULL;
+    auto load_gravity = [&](ChLoad<ChLoaderGravity>& loader, int ie, ChVectorDynamic<>& Rg) {
+        if (auto mloadable = std::dynamic_pointer_cast<ChLoadableUVW>(velements[ie])) {
+            if (mloadable->GetDensity()) {
+                // temporary set loader target and compute generalized forces term
+                loader.loader.loadable = mloadable;
+                loader.ComputeQ(0, 0);
+                loader.LoadIntLoadResidual_F(Rg, c);
+            }
+        }
+    };
+    auto make_loader = [&]() {
+        auto loader = chrono_types::make_shared<ChLoad<ChLoaderGravity>>(std::shared_ptr<ChLoadableUVW>());
+        loader->loader.Set_G_acc(G_acc);
+        loader->loader.SetNumIntPoints(num_points_gravity);
+        return loader;
+    };
+
     // internal forces
     timer_internal_forces.start();
-#pragma omp parallel for schedule(dynamic, 4)
-    for (int ie = 0; ie < velements.size(); ie++) {
-        velements[ie]->EleIntLoadResidual_F(R, c);
-    }
-    timer_internal_forces.stop();
-    ncalls_internal_forces++;
 
-    // Apply gravity loads without the need of adding
-    // a ChLoad object to each element: just instance here a single ChLoad and reuse
-    // it for all 'volume' objects.
-    if (automatic_gravity_load) {
-        std::shared_ptr<ChLoadableUVW> mloadable;  // still null
-        auto common_gravity_loader = chrono_types::make_shared<ChLoad<ChLoaderGravity>>(mloadable);
-        common_gravity_loader->loader.Set_G_acc(GetSystem()->Get_G_acc());
-        common_gravity_loader->loader.SetNumIntPoints(num_points_gravity);
+    switch (assembly_mode) {
+        case AssemblyMode::ATOMIC: {
+#pragma omp parallel for schedule(dynamic, 4)
+            for (int ie = 0; ie < velements.size(); ie++) {
+                velements[ie]->EleIntLoadResidual_F(R, c);
+            }
+            timer_internal_forces.stop();
 
-        for (unsigned int ie = 0; ie < velements.size(); ie++) {
-            if ((mloadable = std::dynamic_pointer_cast<ChLoadableUVW>(velements[ie]))) {
-                if (mloadable->GetDensity()) {
-                    // temporary set loader target and compute generalized forces term
-                    common_gravity_loader->loader.loadable = mloadable;
-                    common_gravity_loader->ComputeQ(0, 0);
-                    common_gravity_loader->LoadIntLoadResidual_F(R, c);
+            if (automatic_gravity_load) {
+                auto loader = make_loader();
+                for (int ie = 0; ie < velements.size(); ie++)
+                    load_gravity(*loader, ie, R);
+            }
+            break;
+        }
+        case AssemblyMode::COLORING: {
+            if (colors_dirty)
+                UpdateColors();
+            // one gravity loader per thread, reused for all colors
+            std::vector<std::shared_ptr<ChLoad<ChLoaderGravity>>> loaders(CHOMPfunctions::GetMaxThreads());
+            if (automatic_gravity_load) {
+                for (auto& loader : loaders)
+                    loader = make_loader();
+            }
+            for (const auto& color : colors) {
+                int ncolor = (int)color.size();
+#pragma omp parallel num_threads((int)loaders.size())
+                {
+                    auto& loader = loaders[CHOMPfunctions::GetThreadNum()];
+#pragma omp for schedule(dynamic, 4)
+                    for (int i = 0; i < ncolor; i++) {
+                        velements[color[i]]->EleIntLoadResidual_F(R, c);
+                        if (loader)
+                            load_gravity(*loader, color[i], R);
+                    }
                 }
             }
+            timer_internal_forces.stop();
+            break;
+        }
+        case AssemblyMode::REDUCTION: {
+            ResetThreadVectors((int)R.size());
+#pragma omp parallel
+            {
+                auto& Rt = thread_R[CHOMPfunctions::GetThreadNum()];
+                auto loader = automatic_gravity_load ? make_loader() : nullptr;
+#pragma omp for schedule(dynamic, 4)
+                for (int ie = 0; ie < velements.size(); ie++) {
+                    velements[ie]->EleIntLoadResidual_F(Rt, c);
+                    if (loader)
+                        load_gravity(*loader, ie, Rt);
+                }
+            }
+            ReduceThreadVectors(R);
+            timer_internal_forces.stop();
+            break;
         }
     }
+
+    ncalls_internal_forces++;
 }
 
 void ChMesh::ComputeMassProperties(double& mass,           // ChMesh object mass
@@ -325,14 +456,26 @@ void ChMesh::ComputeMassProperties(double& mass,           // ChMesh object mass
         vnodes[j]->m_TotalMass = 0.0;
     }
     // Loop over all elements and calculate contribution to nodal mass
-    for (unsigned int ie = 0; ie < velements.size(); ie++) {
-        velements[ie]->ComputeNodalMass();
+    if (assembly_mode == AssemblyMode::COLORING) {
+        if (colors_dirty)
+            UpdateColors();
+        for (const auto& color : colors) {
+            int ncolor = (int)color.size();
+#pragma omp parallel for
+            for (int i = 0; i < ncolor; i++)
+                velements[color[i]]->ComputeNodalMass();
+        }
+    } else {
+        for (unsigned int ie = 0; ie < velements.size(); ie++) {
+            velements[ie]->ComputeNodalMass();
+        }
     }
     // Loop over all the nodes of the mesh to obtain total object mass
     for (unsigned int j = 0; j < vnodes.size(); j++) {
         mass += vnodes[j]->m_TotalMass;
     }
 }
+
 void ChMesh::IntLoadResidual_Mv(const unsigned int off,      ///< offset in R residual
                                 ChVectorDynamic<>& R,        ///< result: the R residual, R += c*M*v
                                 const ChVectorDynamic<>& w,  ///< the w vector
@@ -348,8 +491,33 @@ void ChMesh::IntLoadResidual_Mv(const unsigned int off,      ///< offset in R re
     }
 
     // internal masses
-    for (unsigned int ie = 0; ie < velements.size(); ie++) {
-        velements[ie]->EleIntLoadResidual_Mv(R, w, c);
+    switch (assembly_mode) {
+        case AssemblyMode::ATOMIC:
+            for (unsigned int ie = 0; ie < velements.size(); ie++) {
+                velements[ie]->EleIntLoadResidual_Mv(R, w, c);
+            }
+            break;
+        case AssemblyMode::COLORING:
+            if (colors_dirty)
+                UpdateColors();
+            for (const auto& color : colors) {
+                int ncolor = (int)color.size();
+#pragma omp parallel for schedule(dynamic, 4)
+                for (int i = 0; i < ncolor; i++)
+                    velements[color[i]]->EleIntLoadResidual_Mv(R, w, c);
+            }
+            break;
+        case AssemblyMode::REDUCTION:
+            ResetThreadVectors((int)R.size());
+#pragma omp parallel
+            {
+                auto& Rt = thread_R[CHOMPfunctions::GetThreadNum()];
+#pragma omp for schedule(dynamic, 4)
+                for (int ie = 0; ie < velements.size(); ie++)
+                    velements[ie]->EleIntLoadResidual_Mv(Rt, w, c);
+            }
+            ReduceThreadVectors(R);
+            break;
     }
 }
 
@@ -38,6 +38,16 @@ namespace fea {
 /// Class which defines a mesh of finite elements of class ChElementBase,
 /// between nodes of class ChNodeFEAbase.
 class ChApi ChMesh : public ChIndexedNodes {
+  public:
+    /// Strategies for the parallel evaluation of element contributions to global vectors
+    /// (internal forces, gravity loads, M*v products).
+    /// Note: skipping the atomic updates (COLORING, REDUCTION) is implemented in ChElementGeneric::EleIntLoadResidual_F.
+    /// Elements that override EleIntLoadResidual_F must check ChElementBase::AtomicScatter themselves.
+    enum class AssemblyMode {
+        ATOMIC,    ///< parallel loop over elements, atomic updates of the global vectors (default)
+        COLORING,  ///< elements grouped in colors with no shared nodes, colors processed in sequence
+        REDUCTION  ///< per-thread partial vectors, summed at the end of the parallel loop
+    };
 
   private:
     std::vector<std::shared_ptr<ChNodeFEAbase>> vnodes;     ///<  nodes
@@ -52,6 +62,11 @@ class ChApi ChMesh : public ChIndexedNodes {
     bool automatic_gravity_load;
     int num_points_gravity;
 
+    AssemblyMode assembly_mode;               ///< element assembly strategy
+    bool colors_dirty;                        ///< element coloring must be recomputed?
+    std::vector<std::vector<int>> colors;     ///< indices of element groups with no shared nodes (COLORING)
+    std::vector<ChVectorDynamic<>> thread_R;  ///< per-thread partial vectors (REDUCTION)
+
     ChTimer<> timer_internal_forces;
     ChTimer<> timer_KRMload;
     int ncalls_internal_forces;
@@ -63,6 +78,8 @@ class ChApi ChMesh : public ChIndexedNodes {
           n_dofs_w(0),
           automatic_gravity_load(true),
           num_points_gravity(1),
+          assembly_mode(AssemblyMode::ATOMIC),
+          colors_dirty(true),
           ncalls_internal_forces(0),
           ncalls_KRMload(0) {}
     ChMesh(const ChMesh& other);
@@ -116,10 +133,30 @@ class ChApi ChMesh : public ChIndexedNodes {
         timer_KRMload.reset();
     }
     /// Get cumulative time for internal force evaluation.
+    /// In COLORING and REDUCTION assembly modes, this includes the automatic gravity loads.
     double GetTimeInternalForces() { return timer_internal_forces(); }
     /// Get cumulative time for Jacobian load calls.
     double GetTimeJacobianLoad() { return timer_KRMload(); }
 
+    /// Set the strategy for the parallel evaluation of element contributions.
+    /// - ATOMIC: all elements are processed in a single parallel loop and their contributions to the internal
+    ///   forces are added with atomic updates. Gravity loads and M*v products are evaluated serially.
+    /// - COLORING: elements are partitioned in groups (colors) such that elements in the same color do not share
+    ///   nodes. Colors are processed in sequence, elements in a color are processed in parallel without atomic
+    ///   updates. This also applies to gravity loads, M*v products, and nodal masses (ComputeMassProperties).
+    /// - REDUCTION: each thread accumulates element contributions in a private vector; the partial vectors are
+    ///   then summed in parallel. Requires additional memory (one vector of system size per thread).
+    /// The loading of element stiffness, damping, and mass matrices is always done in parallel, as each element
+    /// writes only to its own matrix block.
+    void SetAssemblyMode(AssemblyMode mode);
+
+    /// Get the current strategy for the parallel evaluation of element contributions.
+    AssemblyMode GetAssemblyMode() const { return assembly_mode; }
+
+    /// Get the number of element colors (COLORING mode only, 0 otherwise).
+    /// The coloring is (re)computed on first use after changes to the mesh elements.
+    unsigned int GetNumColors() const { return (unsigned int)colors.size(); }
+
     /// Add a contact surface.
     void AddContactSurface(std::shared_ptr<ChContactSurface> m_surf);
 
@@ -279,6 +316,15 @@ class ChApi ChMesh : public ChIndexedNodes {
     /// </pre>
     virtual void SetupInitial() override;
 
+    /// Partition the elements in groups that do not share nodes (greedy coloring).
+    void UpdateColors();
+
+    /// Prepare the per-thread partial vectors (REDUCTION mode).
+    void ResetThreadVectors(int size);
+
+    /// Sum the per-thread partial vectors into R (REDUCTION mode).
+    void ReduceThreadVectors(ChVectorDynamic<>& R);
+
     friend class chrono::ChSystem;
     friend class chrono::ChAssembly;
 };
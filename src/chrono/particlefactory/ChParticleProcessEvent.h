@@ -71,10 +71,11 @@ class ChParticleProcessEventRemove : public ChParticleProcessEvent {
 
     virtual void SetupPreProcess(ChSystem& msystem) { to_delete.clear(); }
 
+    /// Queue the processed particles for removal; they are removed all at once at the next Setup().
     virtual void SetupPostProcess(ChSystem& msystem) {
         std::list<std::shared_ptr<ChBody> >::iterator ibody = to_delete.begin();
         while (ibody != to_delete.end()) {
-            msystem.Remove((*ibody));
+            msystem.RemoveBatch((*ibody));
             ++ibody;
         }
     }
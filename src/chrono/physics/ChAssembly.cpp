@@ -14,6 +14,7 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <unordered_set>
 
 #include "chrono/core/ChGlobal.h"
 #include "chrono/core/ChTransform.h"
@@ -44,7 +45,8 @@ ChAssembly::ChAssembly()
       nsysvars(0),
       nsysvars_w(0),
       nbodies_sleep(0),
-      nbodies_fixed(0) {}
+      nbodies_fixed(0),
+      num_threads(1) {}
 
 ChAssembly::ChAssembly(const ChAssembly& other) : ChPhysicsItem(other) {
     nbodies = other.nbodies;
@@ -62,6 +64,7 @@ ChAssembly::ChAssembly(const ChAssembly& other) : ChPhysicsItem(other) {
     nsysvars_w = other.nsysvars_w;
     nbodies_sleep = other.nbodies_sleep;
     nbodies_fixed = other.nbodies_fixed;
+    num_threads = other.num_threads;
 
     //// RADU
     //// TODO:  deep copy of the object lists (bodylist, linklist, meshlist,  otherphysicslist)
@@ -99,6 +102,7 @@ void swap(ChAssembly& first, ChAssembly& second) {
     swap(first.nsysvars_w, second.nsysvars_w);
     swap(first.nbodies_sleep, second.nbodies_sleep);
     swap(first.nbodies_fixed, second.nbodies_fixed);
+    swap(first.num_threads, second.num_threads);
 
     //// RADU
     //// TODO: deal with all other member variables...
@@ -128,7 +132,8 @@ void ChAssembly::Clear() {
     nbodies_fixed = 0;
 }
 
-// Note: removing items from the assembly incurs linear time cost
+// Note: removing items from the assembly incurs linear time cost.
+// To remove many items at once, use RemoveBatch() which processes all queued items in a single pass.
 
 void ChAssembly::AddBody(std::shared_ptr<ChBody> body) {
     assert(std::find(std::begin(bodylist), std::end(bodylist), body) == bodylist.end());
@@ -243,11 +248,99 @@ void ChAssembly::AddBatch(std::shared_ptr<ChPhysicsItem> item) {
     system->is_updated = false;
 }
 
+void ChAssembly::RemoveBatch(std::shared_ptr<ChPhysicsItem> item) {
+    batch_to_remove.push_back(item);
+
+    system->is_updated = false;
+}
+
 void ChAssembly::FlushBatch() {
+    if (!batch_to_remove.empty())
+        FlushBatchRemove();
+    if (!batch_to_insert.empty())
+        FlushBatchInsert();
+}
+
+// Move the items of the given list that are marked for removal to the 'removed' list.
+// The list is compacted in a single pass, preserving the order of the remaining items.
+template <class T>
+static void CompactList(std::vector<std::shared_ptr<T>>& list,
+                        const std::unordered_set<ChPhysicsItem*>& marked,
+                        std::vector<std::shared_ptr<T>>& removed) {
+    size_t num_kept = 0;
+    for (size_t i = 0; i < list.size(); i++) {
+        if (marked.find(list[i].get()) != marked.end()) {
+            removed.push_back(std::move(list[i]));
+            continue;
+        }
+        if (num_kept != i)
+            list[num_kept] = std::move(list[i]);
+        num_kept++;
+    }
+    list.resize(num_kept);
+}
+
+void ChAssembly::FlushBatchRemove() {
+    std::unordered_set<ChPhysicsItem*> marked;
+    marked.reserve(batch_to_remove.size());
+    for (auto& item : batch_to_remove)
+        marked.insert(item.get());
+    batch_to_remove.clear();
+
+    std::vector<std::shared_ptr<ChBody>> bodies;
+    std::vector<std::shared_ptr<ChLinkBase>> links;
+    std::vector<std::shared_ptr<fea::ChMesh>> meshes;
+    std::vector<std::shared_ptr<ChPhysicsItem>> items;
+    CompactList(bodylist, marked, bodies);
+    CompactList(linklist, marked, links);
+    CompactList(meshlist, marked, meshes);
+    CompactList(otherphysicslist, marked, items);
+
+    // Remove the collision models of all bodies at once, then detach the bodies from the system
+    // (ChBody does not extend SetSystem, which would otherwise remove each collision model again).
+    std::vector<ChCollisionModel*> models;
+    for (auto& body : bodies) {
+        if (body->GetCollide())
+            models.push_back(body->GetCollisionModel().get());
+    }
+    if (!models.empty())
+        system->GetCollisionSystem()->RemoveModels(models);
+    for (auto& body : bodies)
+        body->system = nullptr;
+
+    for (auto& link : links)
+        link->SetSystem(nullptr);
+    for (auto& mesh : meshes)
+        mesh->SetSystem(nullptr);
+    for (auto& item : items)
+        item->SetSystem(nullptr);
+
+    system->is_updated = false;
+}
+
+void ChAssembly::FlushBatchInsert() {
+    // Attach bodies to the system and add their collision models at once; other items are added as in Add().
+    std::vector<ChCollisionModel*> models;
     for (auto& item : batch_to_insert) {
-        Add(item);
+        auto body = std::dynamic_pointer_cast<ChBody>(item);
+        if (!body) {
+            Add(item);
+            continue;
+        }
+        assert(body->GetSystem() == nullptr);  // should remove from other system before adding here
+        body->system = system;
+        if (body->GetCollide()) {
+            body->SyncCollisionModels();
+            models.push_back(body->GetCollisionModel().get());
+        }
+        bodylist.push_back(body);
     }
     batch_to_insert.clear();
+
+    if (!models.empty())
+        system->GetCollisionSystem()->AddModels(models);
+
+    system->is_updated = false;
 }
 
 void ChAssembly::Remove(std::shared_ptr<ChPhysicsItem> item) {
@@ -389,7 +482,9 @@ void ChAssembly::SetSystem(ChSystem* m_system) {
 }
 
 void ChAssembly::SyncCollisionModels() {
-    for (auto& body : bodylist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(bodylist.size()))
+    for (int ip = 0; ip < (int)bodylist.size(); ++ip) {
+        auto& body = bodylist[ip];
         body->SyncCollisionModels();
     }
     for (auto& link : linklist) {
@@ -437,7 +532,7 @@ void ChAssembly::Setup() {
     nmeshes = 0;
     nphysicsitems = 0;
 
-    // Add any items queued for insertion in the assembly's lists.
+    // Process any items queued for removal from or insertion in the assembly's lists.
     this->FlushBatch();
 
     for (auto& body : bodylist) {
@@ -531,13 +626,15 @@ void ChAssembly::Update(double mytime, bool update_assets) {
 // Updates all forces (automatic, as children of bodies)
 // Updates all markers (automatic, as children of bodies).
 void ChAssembly::Update(bool update_assets) {
-    //// NOTE: do not switch these to range for loops (may want to use OMP for)
+    //// NOTE: do not switch these to range for loops (OpenMP parallel for)
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(bodylist.size()))
     for (int ip = 0; ip < (int)bodylist.size(); ++ip) {
         bodylist[ip]->Update(ChTime, update_assets);
     }
     for (int ip = 0; ip < (int)otherphysicslist.size(); ++ip) {
         otherphysicslist[ip]->Update(ChTime, update_assets);
     }
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(linklist.size()))
     for (int ip = 0; ip < (int)linklist.size(); ++ip) {
         linklist[ip]->Update(ChTime, update_assets);
     }
@@ -569,13 +666,19 @@ void ChAssembly::IntStateGather(const unsigned int off_x,
     unsigned int displ_x = off_x - this->offset_x;
     unsigned int displ_v = off_v - this->offset_w;
 
-    for (auto& body : bodylist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(bodylist.size()))
+    for (int ip = 0; ip < (int)bodylist.size(); ++ip) {
+        auto& body = bodylist[ip];
+        double T_item;  // not used (T is set below)
         if (body->IsActive())
-            body->IntStateGather(displ_x + body->GetOffset_x(), x, displ_v + body->GetOffset_w(), v, T);
+            body->IntStateGather(displ_x + body->GetOffset_x(), x, displ_v + body->GetOffset_w(), v, T_item);
     }
-    for (auto& link : linklist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(linklist.size()))
+    for (int ip = 0; ip < (int)linklist.size(); ++ip) {
+        auto& link = linklist[ip];
+        double T_item;  // not used (T is set below)
         if (link->IsActive())
-            link->IntStateGather(displ_x + link->GetOffset_x(), x, displ_v + link->GetOffset_w(), v, T);
+            link->IntStateGather(displ_x + link->GetOffset_x(), x, displ_v + link->GetOffset_w(), v, T_item);
     }
     for (auto& mesh : meshlist) {
         mesh->IntStateGather(displ_x + mesh->GetOffset_x(), x, displ_v + mesh->GetOffset_w(), v, T);
@@ -602,7 +705,9 @@ void ChAssembly::IntStateScatter(const unsigned int off_x,
     unsigned int displ_x = off_x - this->offset_x;
     unsigned int displ_v = off_v - this->offset_w;
 
-    for (auto& body : bodylist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(bodylist.size()))
+    for (int ip = 0; ip < (int)bodylist.size(); ++ip) {
+        auto& body = bodylist[ip];
         if (body->IsActive())
             body->IntStateScatter(displ_x + body->GetOffset_x(), x, displ_v + body->GetOffset_w(), v, T);
         else
@@ -611,7 +716,9 @@ void ChAssembly::IntStateScatter(const unsigned int off_x,
     for (auto& mesh : meshlist) {
         mesh->IntStateScatter(displ_x + mesh->GetOffset_x(), x, displ_v + mesh->GetOffset_w(), v, T);
     }
-    for (auto& link : linklist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(linklist.size()))
+    for (int ip = 0; ip < (int)linklist.size(); ++ip) {
+        auto& link = linklist[ip];
         if (link->IsActive())
             link->IntStateScatter(displ_x + link->GetOffset_x(), x, displ_v + link->GetOffset_w(), v, T);
         else
@@ -626,11 +733,15 @@ void ChAssembly::IntStateScatter(const unsigned int off_x,
 void ChAssembly::IntStateGatherAcceleration(const unsigned int off_a, ChStateDelta& a) {
     unsigned int displ_a = off_a - this->offset_w;
 
-    for (auto& body : bodylist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(bodylist.size()))
+    for (int ip = 0; ip < (int)bodylist.size(); ++ip) {
+        auto& body = bodylist[ip];
         if (body->IsActive())
             body->IntStateGatherAcceleration(displ_a + body->GetOffset_w(), a);
     }
-    for (auto& link : linklist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(linklist.size()))
+    for (int ip = 0; ip < (int)linklist.size(); ++ip) {
+        auto& link = linklist[ip];
         if (link->IsActive())
             link->IntStateGatherAcceleration(displ_a + link->GetOffset_w(), a);
     }
@@ -646,11 +757,15 @@ void ChAssembly::IntStateGatherAcceleration(const unsigned int off_a, ChStateDel
 void ChAssembly::IntStateScatterAcceleration(const unsigned int off_a, const ChStateDelta& a) {
     unsigned int displ_a = off_a - this->offset_w;
 
-    for (auto& body : bodylist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(bodylist.size()))
+    for (int ip = 0; ip < (int)bodylist.size(); ++ip) {
+        auto& body = bodylist[ip];
         if (body->IsActive())
             body->IntStateScatterAcceleration(displ_a + body->GetOffset_w(), a);
     }
-    for (auto& link : linklist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(linklist.size()))
+    for (int ip = 0; ip < (int)linklist.size(); ++ip) {
+        auto& link = linklist[ip];
         if (link->IsActive())
             link->IntStateScatterAcceleration(displ_a + link->GetOffset_w(), a);
     }
@@ -666,11 +781,15 @@ void ChAssembly::IntStateScatterAcceleration(const unsigned int off_a, const ChS
 void ChAssembly::IntStateGatherReactions(const unsigned int off_L, ChVectorDynamic<>& L) {
     unsigned int displ_L = off_L - this->offset_L;
 
-    for (auto& body : bodylist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(bodylist.size()))
+    for (int ip = 0; ip < (int)bodylist.size(); ++ip) {
+        auto& body = bodylist[ip];
         if (body->IsActive())
             body->IntStateGatherReactions(displ_L + body->GetOffset_L(), L);
     }
-    for (auto& link : linklist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(linklist.size()))
+    for (int ip = 0; ip < (int)linklist.size(); ++ip) {
+        auto& link = linklist[ip];
         if (link->IsActive())
             link->IntStateGatherReactions(displ_L + link->GetOffset_L(), L);
     }
@@ -686,11 +805,15 @@ void ChAssembly::IntStateGatherReactions(const unsigned int off_L, ChVectorDynam
 void ChAssembly::IntStateScatterReactions(const unsigned int off_L, const ChVectorDynamic<>& L) {
     unsigned int displ_L = off_L - this->offset_L;
 
-    for (auto& body : bodylist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(bodylist.size()))
+    for (int ip = 0; ip < (int)bodylist.size(); ++ip) {
+        auto& body = bodylist[ip];
         if (body->IsActive())
             body->IntStateScatterReactions(displ_L + body->GetOffset_L(), L);
     }
-    for (auto& link : linklist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(linklist.size()))
+    for (int ip = 0; ip < (int)linklist.size(); ++ip) {
+        auto& link = linklist[ip];
         if (link->IsActive())
             link->IntStateScatterReactions(displ_L + link->GetOffset_L(), L);
     }
@@ -710,12 +833,16 @@ void ChAssembly::IntStateIncrement(const unsigned int off_x,
     unsigned int displ_x = off_x - this->offset_x;
     unsigned int displ_v = off_v - this->offset_w;
 
-    for (auto& body : bodylist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(bodylist.size()))
+    for (int ip = 0; ip < (int)bodylist.size(); ++ip) {
+        auto& body = bodylist[ip];
         if (body->IsActive())
             body->IntStateIncrement(displ_x + body->GetOffset_x(), x_new, x, displ_v + body->GetOffset_w(), Dv);
     }
 
-    for (auto& link : linklist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(linklist.size()))
+    for (int ip = 0; ip < (int)linklist.size(); ++ip) {
+        auto& link = linklist[ip];
         if (link->IsActive())
             link->IntStateIncrement(displ_x + link->GetOffset_x(), x_new, x, displ_v + link->GetOffset_w(), Dv);
     }
@@ -735,7 +862,9 @@ void ChAssembly::IntLoadResidual_F(const unsigned int off,  ///< offset in R res
 {
     unsigned int displ_v = off - this->offset_w;
 
-    for (auto& body : bodylist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(bodylist.size()))
+    for (int ip = 0; ip < (int)bodylist.size(); ++ip) {
+        auto& body = bodylist[ip];
         if (body->IsActive())
             body->IntLoadResidual_F(displ_v + body->GetOffset_w(), R, c);
     }
@@ -758,7 +887,9 @@ void ChAssembly::IntLoadResidual_Mv(const unsigned int off,      ///< offset in
 ) {
     unsigned int displ_v = off - this->offset_w;
 
-    for (auto& body : bodylist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(bodylist.size()))
+    for (int ip = 0; ip < (int)bodylist.size(); ++ip) {
+        auto& body = bodylist[ip];
         if (body->IsActive())
             body->IntLoadResidual_Mv(displ_v + body->GetOffset_w(), R, w, c);
     }
@@ -809,7 +940,9 @@ void ChAssembly::IntLoadConstraint_C(const unsigned int off_L,  ///< offset in Q
         if (body->IsActive())
             body->IntLoadConstraint_C(displ_L + body->GetOffset_L(), Qc, c, do_clamp, recovery_clamp);
     }
-    for (auto& link : linklist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(linklist.size()))
+    for (int ip = 0; ip < (int)linklist.size(); ++ip) {
+        auto& link = linklist[ip];
         if (link->IsActive())
             link->IntLoadConstraint_C(displ_L + link->GetOffset_L(), Qc, c, do_clamp, recovery_clamp);
     }
@@ -831,7 +964,9 @@ void ChAssembly::IntLoadConstraint_Ct(const unsigned int off_L,  ///< offset in
         if (body->IsActive())
             body->IntLoadConstraint_Ct(displ_L + body->GetOffset_L(), Qc, c);
     }
-    for (auto& link : linklist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(linklist.size()))
+    for (int ip = 0; ip < (int)linklist.size(); ++ip) {
+        auto& link = linklist[ip];
         if (link->IsActive())
             link->IntLoadConstraint_Ct(displ_L + link->GetOffset_L(), Qc, c);
     }
@@ -852,12 +987,16 @@ void ChAssembly::IntToDescriptor(const unsigned int off_v,
     unsigned int displ_L = off_L - this->offset_L;
     unsigned int displ_v = off_v - this->offset_w;
 
-    for (auto& body : bodylist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(bodylist.size()))
+    for (int ip = 0; ip < (int)bodylist.size(); ++ip) {
+        auto& body = bodylist[ip];
         if (body->IsActive())
             body->IntToDescriptor(displ_v + body->GetOffset_w(), v, R, displ_L + body->GetOffset_L(), L, Qc);
     }
 
-    for (auto& link : linklist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(linklist.size()))
+    for (int ip = 0; ip < (int)linklist.size(); ++ip) {
+        auto& link = linklist[ip];
         if (link->IsActive())
             link->IntToDescriptor(displ_v + link->GetOffset_w(), v, R, displ_L + link->GetOffset_L(), L, Qc);
     }
@@ -878,12 +1017,16 @@ void ChAssembly::IntFromDescriptor(const unsigned int off_v,
     unsigned int displ_L = off_L - this->offset_L;
     unsigned int displ_v = off_v - this->offset_w;
 
-    for (auto& body : bodylist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(bodylist.size()))
+    for (int ip = 0; ip < (int)bodylist.size(); ++ip) {
+        auto& body = bodylist[ip];
         if (body->IsActive())
             body->IntFromDescriptor(displ_v + body->GetOffset_w(), v, displ_L + body->GetOffset_L(), L);
     }
 
-    for (auto& link : linklist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(linklist.size()))
+    for (int ip = 0; ip < (int)linklist.size(); ++ip) {
+        auto& link = linklist[ip];
         if (link->IsActive())
             link->IntFromDescriptor(displ_v + link->GetOffset_w(), v, displ_L + link->GetOffset_L(), L);
     }
@@ -915,7 +1058,9 @@ void ChAssembly::InjectVariables(ChSystemDescriptor& mdescriptor) {
 }
 
 void ChAssembly::VariablesFbReset() {
-    for (auto& body : bodylist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(bodylist.size()))
+    for (int ip = 0; ip < (int)bodylist.size(); ++ip) {
+        auto& body = bodylist[ip];
         body->VariablesFbReset();
     }
     for (auto& link : linklist) {
@@ -930,7 +1075,9 @@ void ChAssembly::VariablesFbReset() {
 }
 
 void ChAssembly::VariablesFbLoadForces(double factor) {
-    for (auto& body : bodylist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(bodylist.size()))
+    for (int ip = 0; ip < (int)bodylist.size(); ++ip) {
+        auto& body = bodylist[ip];
         body->VariablesFbLoadForces(factor);
     }
     for (auto& link : linklist) {
@@ -960,7 +1107,9 @@ void ChAssembly::VariablesFbIncrementMq() {
 }
 
 void ChAssembly::VariablesQbLoadSpeed() {
-    for (auto& body : bodylist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(bodylist.size()))
+    for (int ip = 0; ip < (int)bodylist.size(); ++ip) {
+        auto& body = bodylist[ip];
         body->VariablesQbLoadSpeed();
     }
     for (auto& link : linklist) {
@@ -975,7 +1124,9 @@ void ChAssembly::VariablesQbLoadSpeed() {
 }
 
 void ChAssembly::VariablesQbSetSpeed(double step) {
-    for (auto& body : bodylist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(bodylist.size()))
+    for (int ip = 0; ip < (int)bodylist.size(); ++ip) {
+        auto& body = bodylist[ip];
         body->VariablesQbSetSpeed(step);
     }
     for (auto& link : linklist) {
@@ -990,7 +1141,9 @@ void ChAssembly::VariablesQbSetSpeed(double step) {
 }
 
 void ChAssembly::VariablesQbIncrementPosition(double dt_step) {
-    for (auto& body : bodylist) {
+#pragma omp parallel for num_threads(num_threads) if (ParallelLoop(bodylist.size()))
+    for (int ip = 0; ip < (int)bodylist.size(); ++ip) {
+        auto& body = bodylist[ip];
         body->VariablesQbIncrementPosition(dt_step);
     }
     for (auto& link : linklist) {
@@ -15,6 +15,7 @@
 #ifndef CHASSEMBLY_H
 #define CHASSEMBLY_H
 
+#include <algorithm>
 #include <cmath>
 #include "chrono/fea/ChMesh.h"
 #include "chrono/physics/ChLinksAll.h"
@@ -74,8 +75,17 @@ class ChApi ChAssembly : public ChPhysicsItem {
     /// at the first Setup() call. This is thread safe.
     void AddBatch(std::shared_ptr<ChPhysicsItem> item);
 
-    /// If some items are queued for addition in the assembly, using AddBatch(), this will
-    /// effectively add them and clean the batch. Called automatically at each Setup().
+    /// Items removed in this way are removed like in the Remove() method, but not instantly,
+    /// they are simply queued in a batch of 'to remove' items, that are removed automatically
+    /// at the first Setup() call. Use this to retire many items at once (e.g. particles leaving
+    /// the domain): the assembly lists are compacted in a single pass and the collision models
+    /// of all removed bodies are removed from the collision system at once. Items that are not
+    /// in the assembly when the batch is flushed are ignored.
+    void RemoveBatch(std::shared_ptr<ChPhysicsItem> item);
+
+    /// If some items are queued for removal or addition in the assembly, using RemoveBatch() or
+    /// AddBatch(), this will effectively remove/add them and clean the batches. Queued removals
+    /// are processed first. Called automatically at each Setup().
     void FlushBatch();
 
     /// Remove a body from this assembly.
@@ -124,6 +134,22 @@ class ChApi ChAssembly : public ChPhysicsItem {
     /// Search a marker by its unique ID.
     std::shared_ptr<ChMarker> SearchMarker(int markID);
 
+    //
+    // PARALLEL EXECUTION
+    //
+
+    /// Set the number of OpenMP threads used for the loops over bodies and links in the assembly passes (default: 1).
+    /// These include the state update, state gather/scatter, loading of residuals and constraint terms, exchange of
+    /// data with the solver descriptor, and synchronization of the collision models. Loops over items shorter than a
+    /// minimum length are always executed serially. Meshes and other physics items are always processed serially.
+    /// Parallel execution assumes that the update of a body or link only modifies data owned by that item (markers and
+    /// forces are owned by their body). In particular, a ChFunction shared by several links must be stateless (e.g.,
+    /// not a ChFunction_Recorder, which caches its last interval).
+    void SetNumThreads(int nthreads) { num_threads = std::max(1, nthreads); }
+
+    /// Get the number of OpenMP threads used in the assembly passes.
+    int GetNumThreads() const { return num_threads; }
+
     //
     // STATISTICS
     //
@@ -295,11 +321,21 @@ class ChApi ChAssembly : public ChPhysicsItem {
   private:
     virtual void SetupInitial() override;
 
+    /// Remove all items queued with RemoveBatch().
+    void FlushBatchRemove();
+
+    /// Insert all items queued with AddBatch().
+    void FlushBatchInsert();
+
+    /// Return true if a loop over the given number of items is to be executed in parallel.
+    bool ParallelLoop(size_t n) const { return num_threads > 1 && n >= 64; }
+
     std::vector<std::shared_ptr<ChBody>> bodylist;                 ///< list of rigid bodies
     std::vector<std::shared_ptr<ChLinkBase>> linklist;             ///< list of joints (links)
     std::vector<std::shared_ptr<fea::ChMesh>> meshlist;            ///< list of meshes
     std::vector<std::shared_ptr<ChPhysicsItem>> otherphysicslist;  ///< list of other physics objects
     std::vector<std::shared_ptr<ChPhysicsItem>> batch_to_insert;   ///< list of items to insert at once
+    std::vector<std::shared_ptr<ChPhysicsItem>> batch_to_remove;   ///< list of items to remove at once
 
     // Statistics:
     int nbodies;        ///< number of bodies (currently active)
@@ -318,6 +354,8 @@ class ChApi ChAssembly : public ChPhysicsItem {
     int nbodies_sleep;  ///< number of bodies that are sleeping
     int nbodies_fixed;  ///< number of bodies that are fixed
 
+    int num_threads;  ///< number of OpenMP threads for the assembly passes
+
     friend class ChSystem;
     friend class ChSystemParallel;
     friend class ChSystemDistributed;
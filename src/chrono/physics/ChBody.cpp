@@ -810,7 +810,7 @@ ChVector<> ChBody::GetContactPointSpeed(const ChVector<>& loc_point,
     ChVector<> loc_omg(state_w.segment(3, 3));
     ChVector<> abs_omg = csys.TransformDirectionLocalToParent(loc_omg);
 
-    return abs_vel + Vcross(abs_omg, loc_point);
+    return abs_vel + Vcross(abs_omg, csys.TransformDirectionLocalToParent(loc_point));
 }
 
 ChVector<> ChBody::GetContactPointSpeed(const ChVector<>& abs_point) {
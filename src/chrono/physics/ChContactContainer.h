@@ -140,56 +140,57 @@ class ChApi ChContactContainer : public ChPhysicsItem {
     ReportContactCallback* report_contact_callback;
 
     /// Utility function to accumulate contact forces from a specified list of contacts.
-    /// This function is templated by the contact type (assumed to be derived from ChContactTuple).
+    /// This function is templated by the type of the contact list (a std::list or a ChContactStorage of pointers to
+    /// contacts, with contact type assumed to be derived from ChContactTuple).
     /// Contact forces are accumulated in a map keyed by the contactable objects.
     /// Derived ChContactContainer classes can use this utility (processing their various lists
     /// of contacts) to cache information used for reporting through GetContactableForce and
     /// GetContactableTorque.
-    template <class Tcont>
-    void SumAllContactForces(std::list<Tcont*>& contactlist,
+    template <class Tlist>
+    void SumAllContactForces(Tlist& contactlist,
                              std::unordered_map<ChContactable*, ForceTorque>& contactforces) {
-        for (auto contact = contactlist.begin(); contact != contactlist.end(); ++contact) {
+        for (auto contact : contactlist) {
             // Extract information for current contact (expressed in global frame)
-            ChMatrix33<> A = (*contact)->GetContactPlane();
-            ChVector<> force_loc = (*contact)->GetContactForce();
+            ChMatrix33<> A = contact->GetContactPlane();
+            ChVector<> force_loc = contact->GetContactForce();
             ChVector<> force = A * force_loc;
-            ChVector<> p1 = (*contact)->GetContactP1();
-            ChVector<> p2 = (*contact)->GetContactP2();
+            ChVector<> p1 = contact->GetContactP1();
+            ChVector<> p2 = contact->GetContactP2();
 
             // Calculate contact torque for first object (expressed in global frame).
             // Recall that -force is applied to the first object.
             ChVector<> torque1(0);
-            if (ChBody* body = dynamic_cast<ChBody*>((*contact)->GetObjA())) {
+            if (ChBody* body = dynamic_cast<ChBody*>(contact->GetObjA())) {
                 torque1 = Vcross(p1 - body->GetPos(), -force);
             }
 
             // If there is already an entry for the first object, accumulate.
             // Otherwise, insert a new entry.
-            auto entry1 = contactforces.find((*contact)->GetObjA());
+            auto entry1 = contactforces.find(contact->GetObjA());
             if (entry1 != contactforces.end()) {
                 entry1->second.force -= force;
                 entry1->second.torque += torque1;
             } else {
                 ForceTorque ft{-force, torque1};
-                contactforces.insert(std::make_pair((*contact)->GetObjA(), ft));
+                contactforces.insert(std::make_pair(contact->GetObjA(), ft));
             }
 
             // Calculate contact torque for second object (expressed in global frame).
             // Recall that +force is applied to the second object.
             ChVector<> torque2(0);
-            if (ChBody* body = dynamic_cast<ChBody*>((*contact)->GetObjB())) {
+            if (ChBody* body = dynamic_cast<ChBody*>(contact->GetObjB())) {
                 torque2 = Vcross(p2 - body->GetPos(), force);
             }
 
             // If there is already an entry for the first object, accumulate.
             // Otherwise, insert a new entry.
-            auto entry2 = contactforces.find((*contact)->GetObjB());
+            auto entry2 = contactforces.find(contact->GetObjB());
             if (entry2 != contactforces.end()) {
                 entry2->second.force += force;
                 entry2->second.torque += torque2;
             } else {
                 ForceTorque ft{force, torque2};
-                contactforces.insert(std::make_pair((*contact)->GetObjB(), ft));
+                contactforces.insert(std::make_pair(contact->GetObjB(), ft));
             }
         }
     }
@@ -15,19 +15,19 @@
 #ifndef CH_CONTACTCONTAINER_NSC_H
 #define CH_CONTACTCONTAINER_NSC_H
 
-#include <list>
-
 #include "chrono/physics/ChContactContainer.h"
 #include "chrono/physics/ChContactNSC.h"
 #include "chrono/physics/ChContactNSCrolling.h"
+#include "chrono/physics/ChContactStorage.h"
 #include "chrono/physics/ChContactable.h"
 
 namespace chrono {
 
 /// Class representing a container of many non-smooth contacts.
-/// Implemented using linked lists of ChContactNSC objects (that is, contacts between two ChContactable objects, with 3
+/// Implemented using lists of ChContactNSC objects (that is, contacts between two ChContactable objects, with 3
 /// reactions). It might also contain ChContactNSCrolling objects (extended versions of ChContactNSC, with 6 reactions,
 /// that account also for rolling and spinning resistance), but also for '6dof vs 6dof' contactables.
+/// Contacts are stored either in linked lists or in pools of contiguous memory (see SetContactStorageMode).
 class ChApi ChContactContainerNSC : public ChContactContainer {
   public:
     typedef ChContactNSC<ChContactable_1vars<6>, ChContactable_1vars<6> > ChContactNSC_6_6;
@@ -44,43 +44,18 @@ class ChApi ChContactContainerNSC : public ChContactContainer {
     typedef ChContactNSCrolling<ChContactable_1vars<6>, ChContactable_1vars<6> > ChContactNSCrolling_6_6;
 
   protected:
-    std::list<ChContactNSC_6_6*> contactlist_6_6;
-    std::list<ChContactNSC_6_3*> contactlist_6_3;
-    std::list<ChContactNSC_3_3*> contactlist_3_3;
-    std::list<ChContactNSC_333_3*> contactlist_333_3;
-    std::list<ChContactNSC_333_6*> contactlist_333_6;
-    std::list<ChContactNSC_333_333*> contactlist_333_333;
-    std::list<ChContactNSC_666_3*> contactlist_666_3;
-    std::list<ChContactNSC_666_6*> contactlist_666_6;
-    std::list<ChContactNSC_666_333*> contactlist_666_333;
-    std::list<ChContactNSC_666_666*> contactlist_666_666;
-
-    std::list<ChContactNSCrolling_6_6*> contactlist_6_6_rolling;
-
-    int n_added_6_6;
-    int n_added_6_3;
-    int n_added_3_3;
-    int n_added_333_3;
-    int n_added_333_6;
-    int n_added_333_333;
-    int n_added_666_3;
-    int n_added_666_6;
-    int n_added_666_333;
-    int n_added_666_666;
-    int n_added_6_6_rolling;
-
-    std::list<ChContactNSC_6_6*>::iterator lastcontact_6_6;
-    std::list<ChContactNSC_6_3*>::iterator lastcontact_6_3;
-    std::list<ChContactNSC_3_3*>::iterator lastcontact_3_3;
-    std::list<ChContactNSC_333_3*>::iterator lastcontact_333_3;
-    std::list<ChContactNSC_333_6*>::iterator lastcontact_333_6;
-    std::list<ChContactNSC_333_333*>::iterator lastcontact_333_333;
-    std::list<ChContactNSC_666_3*>::iterator lastcontact_666_3;
-    std::list<ChContactNSC_666_6*>::iterator lastcontact_666_6;
-    std::list<ChContactNSC_666_333*>::iterator lastcontact_666_333;
-    std::list<ChContactNSC_666_666*>::iterator lastcontact_666_666;
-
-    std::list<ChContactNSCrolling_6_6*>::iterator lastcontact_6_6_rolling;
+    ChContactStorage<ChContactNSC_6_6> contactlist_6_6;
+    ChContactStorage<ChContactNSC_6_3> contactlist_6_3;
+    ChContactStorage<ChContactNSC_3_3> contactlist_3_3;
+    ChContactStorage<ChContactNSC_333_3> contactlist_333_3;
+    ChContactStorage<ChContactNSC_333_6> contactlist_333_6;
+    ChContactStorage<ChContactNSC_333_333> contactlist_333_333;
+    ChContactStorage<ChContactNSC_666_3> contactlist_666_3;
+    ChContactStorage<ChContactNSC_666_6> contactlist_666_6;
+    ChContactStorage<ChContactNSC_666_333> contactlist_666_333;
+    ChContactStorage<ChContactNSC_666_666> contactlist_666_666;
+
+    ChContactStorage<ChContactNSCrolling_6_6> contactlist_6_6_rolling;
 
     std::unordered_map<ChContactable*, ForceTorque> contact_forces;
 
@@ -93,10 +68,17 @@ class ChApi ChContactContainerNSC : public ChContactContainer {
     virtual ChContactContainerNSC* Clone() const override { return new ChContactContainerNSC(*this); }
 
     /// Report the number of added contacts.
-    virtual int GetNcontacts() const override {
-        return n_added_3_3 + n_added_6_3 + n_added_6_6 + n_added_333_3 + n_added_333_6 + n_added_333_333 +
-               n_added_666_3 + n_added_666_6 + n_added_666_333 + n_added_666_666 + n_added_6_6_rolling;
-    }
+    virtual int GetNcontacts() const override;
+
+    /// Set the storage mode for the contact objects (default: ChContactStorageMode::LIST).
+    /// In POOL mode, contacts are allocated in contiguous slabs and recycled across steps, which avoids the heap
+    /// traffic of scenes where contacts frequently appear and disappear and improves the memory locality of the
+    /// per-contact loops. The pool keeps the peak number of contacts allocated until RemoveAllContacts() is called.
+    /// Changing the storage mode removes all existing contacts.
+    void SetContactStorageMode(ChContactStorageMode mode);
+
+    /// Get the current storage mode for the contact objects.
+    ChContactStorageMode GetContactStorageMode() const { return contactlist_6_6.GetMode(); }
 
     /// Remove (delete) all contained contact data.
     virtual void RemoveAllContacts() override;
@@ -129,11 +111,7 @@ class ChApi ChContactContainerNSC : public ChContactContainer {
 
     /// Report the number of scalar unilateral constraints.
     /// Note: friction constraints aren't exactly unilaterals, but they are still counted.
-    virtual int GetDOC_d() override {
-        return 3 * (n_added_3_3 + n_added_6_3 + n_added_6_6 + n_added_333_3 + n_added_333_6 + n_added_333_333 +
-                    n_added_666_3 + n_added_666_6 + n_added_666_333 + n_added_666_666) +
-               6 * (n_added_6_6_rolling);
-    }
+    virtual int GetDOC_d() override;
 
     /// Update state of this contact container: compute jacobians, violations, etc.
     /// and store results in inner structures of contacts.
@@ -46,14 +46,138 @@ class ChContactSMC : public ChContactTuple<Ta, Tb> {
 
   private:
     struct ChContactJacobian {
-        ChKblockGeneric m_KRM;        ///< sum of scaled K and R, with pointers to sparse variables
-        ChMatrixDynamic<double> m_K;  ///< K = dQ/dx
-        ChMatrixDynamic<double> m_R;  ///< R = dQ/dv
+        ChKblockGeneric m_KRM;         ///< sum of scaled K and R, with pointers to sparse variables
+        ChMatrixDynamic<double> m_K;   ///< K = dQ/dx
+        ChMatrixDynamic<double> m_R;   ///< R = dQ/dv
+        ChMatrixDynamic<double> m_Jt;  ///< generalized forces of unit contact forces (one column per direction)
+        ChVectorDynamic<double> m_Q;   ///< work vector for loading the columns of m_Jt
+    };
+
+    /// Stiffness and damping coefficients of the contact force model.
+    /// Each coefficient depends on the overlap as c = c0 * delta^p; the exponents p are used in
+    /// calculating the Jacobians of the contact force.
+    struct ChContactCoefficients {
+        double kn, kt, gn, gt;      ///< normal and tangential stiffness and damping
+        double pkn, pkt, pgn, pgt;  ///< exponents of the overlap in kn, kt, gn, gt
     };
 
     ChVector<> m_force;        ///< contact force on objB
     ChContactJacobian* m_Jac;  ///< contact Jacobian data
 
+    /// Calculate the stiffness and damping coefficients for the current contact force model.
+    ChContactCoefficients CalculateCoefficients(double delta, const ChMaterialCompositeSMC& mat) const {
+        ChSystemSMC* sys = static_cast<ChSystemSMC*>(this->container->GetSystem());
+        bool use_mat_props = sys->UsingMaterialProperties();
+
+        // Effective mass
+        double eff_mass = this->objA->GetContactableMass() * this->objB->GetContactableMass() /
+                          (this->objA->GetContactableMass() + this->objB->GetContactableMass());
+
+        double eps = std::numeric_limits<double>::epsilon();
+
+        ChContactCoefficients c;
+
+        switch (sys->GetContactForceModel()) {
+            case ChSystemSMC::Hooke:
+                if (use_mat_props) {
+                    double tmp_k = (16.0 / 15) * std::sqrt(this->eff_radius) * mat.E_eff;
+                    double v2 = sys->GetCharacteristicImpactVelocity() * sys->GetCharacteristicImpactVelocity();
+                    double loge = (mat.cr_eff < eps) ? std::log(eps) : std::log(mat.cr_eff);
+                    loge = (mat.cr_eff > 1 - eps) ? std::log(1 - eps) : loge;
+                    double tmp_g = 1 + std::pow(CH_C_PI / loge, 2);
+                    c.kn = tmp_k * std::pow(eff_mass * v2 / tmp_k, 1.0 / 5);
+                    c.kt = c.kn;
+                    c.gn = std::sqrt(4 * eff_mass * c.kn / tmp_g);
+                    c.gt = c.gn;
+                } else {
+                    c.kn = mat.kn;
+                    c.kt = mat.kt;
+                    c.gn = eff_mass * mat.gn;
+                    c.gt = eff_mass * mat.gt;
+                }
+                c.pkn = c.pkt = c.pgn = c.pgt = 0;
+
+                break;
+
+            case ChSystemSMC::Hertz:
+                if (use_mat_props) {
+                    double sqrt_Rd = std::sqrt(this->eff_radius * delta);
+                    double Sn = 2 * mat.E_eff * sqrt_Rd;
+                    double St = 8 * mat.G_eff * sqrt_Rd;
+                    double loge = (mat.cr_eff < eps) ? std::log(eps) : std::log(mat.cr_eff);
+                    double beta = loge / std::sqrt(loge * loge + CH_C_PI * CH_C_PI);
+                    c.kn = (2.0 / 3) * Sn;
+                    c.kt = St;
+                    c.gn = -2 * std::sqrt(5.0 / 6) * beta * std::sqrt(Sn * eff_mass);
+                    c.gt = -2 * std::sqrt(5.0 / 6) * beta * std::sqrt(St * eff_mass);
+                    c.pkn = c.pkt = 0.5;
+                    c.pgn = c.pgt = 0.25;
+                } else {
+                    double tmp = this->eff_radius * std::sqrt(delta);
+                    c.kn = tmp * mat.kn;
+                    c.kt = tmp * mat.kt;
+                    c.gn = tmp * eff_mass * mat.gn;
+                    c.gt = tmp * eff_mass * mat.gt;
+                    c.pkn = c.pkt = c.pgn = c.pgt = 0.5;
+                }
+
+                break;
+
+            case ChSystemSMC::Flores:
+                if (use_mat_props) {
+                    double sqrt_Rd = std::sqrt(this->eff_radius * delta);
+                    double Sn = 2 * mat.E_eff * sqrt_Rd;
+                    double St = 8 * mat.G_eff * sqrt_Rd;
+                    double cr_eff = (mat.cr_eff < 0.01) ? 0.01 : mat.cr_eff;
+                    cr_eff = (cr_eff > 1 - eps) ? 1 - eps : cr_eff;
+                    double loge = std::log(cr_eff);
+                    double beta = loge / std::sqrt(loge * loge + CH_C_PI * CH_C_PI);
+                    double char_vel = sys->GetCharacteristicImpactVelocity();
+                    c.kn = (2.0 / 3) * Sn;
+                    c.kt = (2.0 / 3) * St;
+                    c.gn = 8 * (1 - cr_eff) * c.kn * delta / (5 * cr_eff * char_vel);
+                    c.gt = -2 * std::sqrt(5.0 / 6) * beta * std::sqrt(St * eff_mass);
+                    c.pkn = c.pkt = 0.5;
+                    c.pgn = 1.5;
+                    c.pgt = 0.25;
+                } else {
+                    double tmp = this->eff_radius * std::sqrt(delta);
+                    c.kn = tmp * mat.kn;
+                    c.kt = tmp * mat.kt;
+                    c.gn = tmp * eff_mass * mat.gn * delta;
+                    c.gt = tmp * eff_mass * mat.gt;
+                    c.pkn = c.pkt = c.pgt = 0.5;
+                    c.pgn = 1.5;
+                }
+
+                break;
+
+            case ChSystemSMC::PlainCoulomb:
+            default:
+                if (use_mat_props) {
+                    double sqrt_Rd = std::sqrt(delta);
+                    double Sn = 2 * mat.E_eff * sqrt_Rd;
+                    double loge = (mat.cr_eff < eps) ? std::log(eps) : std::log(mat.cr_eff);
+                    double beta = loge / std::sqrt(loge * loge + CH_C_PI * CH_C_PI);
+                    c.kn = (2.0 / 3) * Sn;
+                    c.gn = -2 * std::sqrt(5.0 / 6) * beta * std::sqrt(Sn * eff_mass);
+                    c.pkn = 0.5;
+                    c.pgn = 0.25;
+                } else {
+                    double tmp = std::sqrt(delta);
+                    c.kn = tmp * mat.kn;
+                    c.gn = tmp * mat.gn;
+                    c.pkn = c.pgn = 0.5;
+                }
+                c.kt = c.gt = 0;
+                c.pkt = c.pgt = 0;
+
+                break;
+        }
+
+        return c;
+    }
+
   public:
     ChContactSMC() : m_Jac(NULL) {}
 
@@ -107,6 +231,9 @@ class ChContactSMC : public ChContactTuple<Ta, Tb> {
         if (static_cast<ChSystemSMC*>(this->container->GetSystem())->GetStiffContact()) {
             CreateJacobians();
             CalculateJacobians(mat);
+        } else if (m_Jac) {
+            delete m_Jac;
+            m_Jac = NULL;
         }
     }
 
@@ -126,7 +253,6 @@ class ChContactSMC : public ChContactTuple<Ta, Tb> {
         // Extract parameters from containing system
         ChSystemSMC* sys = static_cast<ChSystemSMC*>(this->container->GetSystem());
         double dT = sys->GetStep();
-        bool use_mat_props = sys->UsingMaterialProperties();
         ChSystemSMC::ContactForceModel contact_model = sys->GetContactForceModel();
         ChSystemSMC::AdhesionForceModel adhesion_model = sys->GetAdhesionForceModel();
         ChSystemSMC::TangentialDisplacementModel tdispl_model = sys->GetTangentialDisplacementModel();
@@ -138,100 +264,30 @@ class ChContactSMC : public ChContactTuple<Ta, Tb> {
         ChVector<> relvel_t = relvel - relvel_n;
         double relvel_t_mag = relvel_t.Length();
 
-        // Calculate effective mass
-        double eff_mass = this->objA->GetContactableMass() * this->objB->GetContactableMass() /
-                          (this->objA->GetContactableMass() + this->objB->GetContactableMass());
-
         // Calculate stiffness and viscous damping coefficients.
         // All models use the following formulas for normal and tangential forces:
         //     Fn = kn * delta_n - gn * v_n
         //     Ft = kt * delta_t - gt * v_t
-        double kn;
-        double kt;
-        double gn;
-        double gt;
-
-        double eps = std::numeric_limits<double>::epsilon();
-
-        switch (contact_model) {
-            case ChSystemSMC::Hooke:
-                if (use_mat_props) {
-                    double tmp_k = (16.0 / 15) * std::sqrt(this->eff_radius) * mat.E_eff;
-                    double v2 = sys->GetCharacteristicImpactVelocity() * sys->GetCharacteristicImpactVelocity();
-                    double loge = (mat.cr_eff < eps) ? std::log(eps) : std::log(mat.cr_eff);
-                    loge = (mat.cr_eff > 1 - eps) ? std::log(1 - eps) : loge;
-                    double tmp_g = 1 + std::pow(CH_C_PI / loge, 2);
-                    kn = tmp_k * std::pow(eff_mass * v2 / tmp_k, 1.0 / 5);
-                    kt = kn;
-                    gn = std::sqrt(4 * eff_mass * kn / tmp_g);
-                    gt = gn;
-                } else {
-                    kn = mat.kn;
-                    kt = mat.kt;
-                    gn = eff_mass * mat.gn;
-                    gt = eff_mass * mat.gt;
-                }
-
-                break;
-
-            case ChSystemSMC::Hertz:
-                if (use_mat_props) {
-                    double sqrt_Rd = std::sqrt(this->eff_radius * delta);
-                    double Sn = 2 * mat.E_eff * sqrt_Rd;
-                    double St = 8 * mat.G_eff * sqrt_Rd;
-                    double loge = (mat.cr_eff < eps) ? std::log(eps) : std::log(mat.cr_eff);
-                    double beta = loge / std::sqrt(loge * loge + CH_C_PI * CH_C_PI);
-                    kn = (2.0 / 3) * Sn;
-                    kt = St;
-                    gn = -2 * std::sqrt(5.0 / 6) * beta * std::sqrt(Sn * eff_mass);
-                    gt = -2 * std::sqrt(5.0 / 6) * beta * std::sqrt(St * eff_mass);
-                } else {
-                    double tmp = this->eff_radius * std::sqrt(delta);
-                    kn = tmp * mat.kn;
-                    kt = tmp * mat.kt;
-                    gn = tmp * eff_mass * mat.gn;
-                    gt = tmp * eff_mass * mat.gt;
-                }
-
-                break;
-
-            case ChSystemSMC::PlainCoulomb:
-                if (use_mat_props) {
-                    double sqrt_Rd = std::sqrt(delta);
-                    double Sn = 2 * mat.E_eff * sqrt_Rd;
-                    double St = 8 * mat.G_eff * sqrt_Rd;
-                    double loge = (mat.cr_eff < eps) ? std::log(eps) : std::log(mat.cr_eff);
-                    double beta = loge / std::sqrt(loge * loge + CH_C_PI * CH_C_PI);
-                    kn = (2.0 / 3) * Sn;
-                    gn = -2 * std::sqrt(5.0 / 6) * beta * std::sqrt(Sn * eff_mass);
-                } else {
-                    double tmp = std::sqrt(delta);
-                    kn = tmp * mat.kn;
-                    gn = tmp * mat.gn;
-                }
-
-                kt = 0;
-                gt = 0;
-
-                {
-                    double forceN = kn * delta - gn * relvel_n_mag;
-                    if (forceN < 0)
-                        forceN = 0;
-                    double forceT = mat.mu_eff * std::tanh(5.0 * relvel_t_mag) * forceN;
-                    switch (adhesion_model) {
-                        case ChSystemSMC::Constant:
-                            forceN -= mat.adhesion_eff;
-                            break;
-                        case ChSystemSMC::DMT:
-                            forceN -= mat.adhesionMultDMT_eff * sqrt(this->eff_radius);
-                            break;
-                    }
-                    ChVector<> force = forceN * normal_dir;
-                    if (relvel_t_mag >= sys->GetSlipVelocityThreshold())
-                        force -= (forceT / relvel_t_mag) * relvel_t;
-
-                    return force;
-                }
+        ChContactCoefficients coeffs = CalculateCoefficients(delta, mat);
+
+        if (contact_model == ChSystemSMC::PlainCoulomb) {
+            double forceN = coeffs.kn * delta - coeffs.gn * relvel_n_mag;
+            if (forceN < 0)
+                forceN = 0;
+            double forceT = mat.mu_eff * std::tanh(5.0 * relvel_t_mag) * forceN;
+            switch (adhesion_model) {
+                case ChSystemSMC::Constant:
+                    forceN -= mat.adhesion_eff;
+                    break;
+                case ChSystemSMC::DMT:
+                    forceN -= mat.adhesionMultDMT_eff * sqrt(this->eff_radius);
+                    break;
+            }
+            ChVector<> force = forceN * normal_dir;
+            if (relvel_t_mag >= sys->GetSlipVelocityThreshold())
+                force -= (forceT / relvel_t_mag) * relvel_t;
+
+            return force;
         }
 
         // Tangential displacement (magnitude)
@@ -249,8 +305,8 @@ class ChContactSMC : public ChContactTuple<Ta, Tb> {
         }
 
         // Calculate the magnitudes of the normal and tangential contact forces
-        double forceN = kn * delta - gn * relvel_n_mag;
-        double forceT = kt * delta_t + gt * relvel_t_mag;
+        double forceN = coeffs.kn * delta - coeffs.gn * relvel_n_mag;
+        double forceT = coeffs.kt * delta_t + coeffs.gt * relvel_t_mag;
 
         // If the resulting normal contact force is negative, the two shapes are moving
         // away from each other so fast that no contact force is generated.
@@ -280,6 +336,108 @@ class ChContactSMC : public ChContactTuple<Ta, Tb> {
         return force;
     }
 
+    /// Calculate the derivatives of the contact force (as returned by CalculateForce) with respect to the
+    /// relative position d = p1 - p2 and relative velocity v = v2 - v1 of the contact points.
+    void CalculateForceDerivatives(
+        double delta,                       ///< overlap in normal direction
+        const ChVector<>& normal_dir,       ///< normal contact direction (expressed in global frame)
+        const ChVector<>& vel1,             ///< velocity of contact point on objA (expressed in global frame)
+        const ChVector<>& vel2,             ///< velocity of contact point on objB (expressed in global frame)
+        const ChMaterialCompositeSMC& mat,  ///< composite material for contact pair
+        ChMatrix33<>& dF_dd,                ///< output derivative with respect to relative position
+        ChMatrix33<>& dF_dv                 ///< output derivative with respect to relative velocity
+    ) {
+        dF_dd.setZero();
+        dF_dv.setZero();
+
+        if (delta <= 0)
+            return;
+
+        // Extract parameters from containing system
+        ChSystemSMC* sys = static_cast<ChSystemSMC*>(this->container->GetSystem());
+        ChSystemSMC::ContactForceModel contact_model = sys->GetContactForceModel();
+        ChSystemSMC::AdhesionForceModel adhesion_model = sys->GetAdhesionForceModel();
+        ChSystemSMC::TangentialDisplacementModel tdispl_model = sys->GetTangentialDisplacementModel();
+        double dT = (tdispl_model == ChSystemSMC::None) ? 0 : sys->GetStep();
+
+        ChContactCoefficients coeffs = CalculateCoefficients(delta, mat);
+
+        // Normal direction n = d / delta and its derivative P / delta, with P = I - n * n^T
+        ChVectorN<double, 3> n = normal_dir.eigen();
+        ChMatrix33<> P = ChMatrix33<>::Identity() - n * n.transpose();
+        ChMatrix33<> n_d = P / delta;
+
+        // Normal and tangential relative velocities and their derivatives
+        ChVectorN<double, 3> v = (vel2 - vel1).eigen();
+        double vn = n.dot(v);
+        ChRowVectorN<double, 3> vn_d = v.transpose() * n_d;
+        ChVectorN<double, 3> vt = v - vn * n;
+        ChMatrix33<> vt_d = -n * vn_d - vn * n_d;
+        double vt_mag = vt.norm();
+
+        // Normal force (without adhesion) and its derivatives
+        double forceN = coeffs.kn * delta - coeffs.gn * vn;
+        ChRowVectorN<double, 3> forceN_d =
+            (coeffs.kn * (1 + coeffs.pkn) - coeffs.pgn * coeffs.gn * vn / delta) * n.transpose() - coeffs.gn * vn_d;
+        ChRowVectorN<double, 3> forceN_v = -coeffs.gn * n.transpose();
+
+        // If the normal contact force is negative, only the (constant) adhesion force remains
+        double adhesion = 0;
+        switch (adhesion_model) {
+            case ChSystemSMC::Constant:
+                adhesion = mat.adhesion_eff;
+                break;
+            case ChSystemSMC::DMT:
+                adhesion = mat.adhesionMultDMT_eff * sqrt(this->eff_radius);
+                break;
+        }
+        if (forceN < 0) {
+            dF_dd = -adhesion * n_d;
+            return;
+        }
+
+        // Normal contribution: F_n = forceN * n
+        dF_dd = n * forceN_d + (forceN - adhesion) * n_d;
+        dF_dv = n * forceN_v;
+
+        if (vt_mag < sys->GetSlipVelocityThreshold())
+            return;
+
+        // Magnitude of the tangential force and its derivatives
+        ChVectorN<double, 3> t = vt / vt_mag;
+        ChRowVectorN<double, 3> vt_mag_d = t.transpose() * vt_d;
+        ChRowVectorN<double, 3> vt_mag_v = t.transpose() * P;
+        double forceT;
+        ChRowVectorN<double, 3> forceT_d;
+        ChRowVectorN<double, 3> forceT_v;
+        if (contact_model == ChSystemSMC::PlainCoulomb) {
+            double th = std::tanh(5.0 * vt_mag);
+            double dth = 5.0 * (1 - th * th);
+            forceT = mat.mu_eff * th * forceN;
+            forceT_d = mat.mu_eff * (dth * forceN * vt_mag_d + th * forceN_d);
+            forceT_v = mat.mu_eff * (dth * forceN * vt_mag_v + th * forceN_v);
+        } else {
+            double ct = coeffs.kt * dT + coeffs.gt;
+            double ct_delta = (coeffs.pkt * coeffs.kt * dT + coeffs.pgt * coeffs.gt) / delta;
+            forceT = ct * vt_mag;
+            double forceT_max = mat.mu_eff * std::abs(forceN - adhesion);
+            if (forceT <= forceT_max) {
+                forceT_d = (ct_delta * vt_mag) * n.transpose() + ct * vt_mag_d;
+                forceT_v = ct * vt_mag_v;
+            } else {
+                double sign = (forceN - adhesion < 0) ? -1 : 1;
+                forceT = forceT_max;
+                forceT_d = (sign * mat.mu_eff) * forceN_d;
+                forceT_v = (sign * mat.mu_eff) * forceN_v;
+            }
+        }
+
+        // Tangential contribution: F_t = -forceT * t, with dt = (I - t * t^T) * dvt / |vt|
+        ChMatrix33<> T = (ChMatrix33<>::Identity() - t * t.transpose()) * (forceT / vt_mag);
+        dF_dd -= t * forceT_d + T * vt_d;
+        dF_dv -= t * forceT_v + T * P;
+    }
+
     /// Compute all forces in a contiguous array.
     /// Used in finite-difference Jacobian approximation.
     void CalculateQ(const ChState& stateA_x,            ///< state positions for objA
@@ -330,10 +488,11 @@ class ChContactSMC : public ChContactTuple<Ta, Tb> {
     }
 
     /// Create the Jacobian matrices.
-    /// These matrices are created/resized as needed.
+    /// The Jacobian data is allocated on first use and then recycled together with this contact object
+    /// (the matrix sizes only depend on the types of the contactable objects).
     void CreateJacobians() {
-        delete m_Jac;
-        m_Jac = new ChContactJacobian;
+        if (!m_Jac)
+            m_Jac = new ChContactJacobian;
 
         // Set variables and resize Jacobian matrices.
         // NOTE: currently, only contactable objects derived from ChContactable_1vars<6>,
@@ -356,82 +515,54 @@ class ChContactSMC : public ChContactTuple<Ta, Tb> {
         ndof_w += this->objB->ContactableGet_ndof_w();
 
         m_Jac->m_KRM.SetVariables(vars);
-        m_Jac->m_K.setZero(ndof_w, ndof_w);
-        m_Jac->m_R.setZero(ndof_w, ndof_w);
+        m_Jac->m_K.resize(ndof_w, ndof_w);
+        m_Jac->m_R.resize(ndof_w, ndof_w);
+        m_Jac->m_Jt.resize(ndof_w, 3);
+        m_Jac->m_Q.setZero(ndof_w);
         assert(m_Jac->m_KRM.Get_K().cols() == ndof_w);
     }
 
     /// Calculate Jacobian of generalized contact forces.
     void CalculateJacobians(const ChMaterialCompositeSMC& mat) {
-        // Compute a finite-difference approximations to the Jacobians of the contact forces and
-        // load dQ/dx into m_Jac->m_K and dQ/dw into m_Jac->m_R.
+        // The contact force F (applied to objB, and -F to objA) depends on the object states only through the
+        // relative position d = p1 - p2 and relative velocity v = v2 - v1 of the contact points.
+        // With Jt the matrix of generalized forces produced by unit contact forces, Q = Jt * F, v = Jt^T * w,
+        // and dd = -Jt^T * dx, so that
+        //     K = -dQ/dx =  Jt * dF/dd * Jt^T
+        //     R = -dQ/dw = -Jt * dF/dv * Jt^T
+        // The variation of Jt itself (i.e., of the contact points) with the object states is neglected.
         // Note that we only calculate these Jacobians whenever the contact force itself is calculated,
         // that is only once per step.  The Jacobian of generalized contact forces will therefore be
         // constant over the time step.
 
-        // Get states for objA
-        int ndofA_x = this->objA->ContactableGet_ndof_x();
+        // Derivatives of the contact force
+        ChMatrix33<> dF_dd;
+        ChMatrix33<> dF_dv;
+        CalculateForceDerivatives(-this->norm_dist, this->normal, this->objA->GetContactPointSpeed(this->p1),
+                                  this->objB->GetContactPointSpeed(this->p2), mat, dF_dd, dF_dv);
+
+        // Get states of the two objects
         int ndofA_w = this->objA->ContactableGet_ndof_w();
-        ChState stateA_x(ndofA_x, NULL);
-        ChStateDelta stateA_w(ndofA_w, NULL);
+        ChState stateA_x(this->objA->ContactableGet_ndof_x(), NULL);
+        ChState stateB_x(this->objB->ContactableGet_ndof_x(), NULL);
         this->objA->ContactableGetStateBlock_x(stateA_x);
-        this->objA->ContactableGetStateBlock_w(stateA_w);
-
-        // Get states for objB
-        int ndofB_x = this->objB->ContactableGet_ndof_x();
-        int ndofB_w = this->objB->ContactableGet_ndof_w();
-        ChState stateB_x(ndofB_x, NULL);
-        ChStateDelta stateB_w(ndofB_w, NULL);
         this->objB->ContactableGetStateBlock_x(stateB_x);
-        this->objB->ContactableGetStateBlock_w(stateB_w);
-
-        // Compute Q at current state
-        ChVectorDynamic<> Q0(ndofA_w + ndofB_w);
-        CalculateQ(stateA_x, stateA_w, stateB_x, stateB_w, mat, Q0);
-
-        // Finite-difference approximation perturbation.
-        // Note that ChState and ChStateDelta are set to 0 on construction.
-        // To accommodate objects with quaternion states, use the method ContactableIncrementState while
-        // calculating Jacobian columns corresponding to position states.
-        double perturbation = 1e-5;
-        ChState stateA_x1(ndofA_x, NULL);
-        ChState stateB_x1(ndofB_x, NULL);
-        ChStateDelta prtrbA(ndofA_w, NULL);
-        ChStateDelta prtrbB(ndofB_w, NULL);
-
-        ChVectorDynamic<> Q1(ndofA_w + ndofB_w);
-
-        // Jacobian w.r.t. variables of objA
-        for (int i = 0; i < ndofA_w; i++) {
-            prtrbA(i) += perturbation;
-            this->objA->ContactableIncrementState(stateA_x, prtrbA, stateA_x1);
-            CalculateQ(stateA_x1, stateA_w, stateB_x, stateB_w, mat, Q1);
-            prtrbA(i) -= perturbation;
-
-            m_Jac->m_K.col(i) = (Q1 - Q0) * (-1 / perturbation);  // note sign change
-
-            stateA_w(i) += perturbation;
-            CalculateQ(stateA_x, stateA_w, stateB_x, stateB_w, mat, Q1);
-            stateA_w(i) -= perturbation;
-
-            m_Jac->m_R.col(i) = (Q1 - Q0) * (-1 / perturbation);  // note sign change
-        }
 
-        // Jacobian w.r.t. variables of objB
-        for (int i = 0; i < ndofB_w; i++) {
-            prtrbB(i) += perturbation;
-            this->objB->ContactableIncrementState(stateB_x, prtrbB, stateB_x1);
-            CalculateQ(stateA_x, stateA_w, stateB_x1, stateB_w, mat, Q1);
-            prtrbB(i) -= perturbation;
-
-            m_Jac->m_K.col(ndofA_w + i) = (Q1 - Q0) * (-1 / perturbation);  // note sign change
-
-            stateB_w(i) += perturbation;
-            CalculateQ(stateA_x, stateA_w, stateB_x, stateB_w, mat, Q1);
-            stateB_w(i) -= perturbation;
-
-            m_Jac->m_R.col(ndofA_w + i) = (Q1 - Q0) * (-1 / perturbation);  // note sign change
+        // Generalized forces of unit contact forces along the absolute frame axes.
+        // Q is cleared for each axis, as some contactables only load part of their generalized forces
+        // (e.g., the translational components for nodes with rotational DOFs).
+        ChVectorDynamic<>& Q = m_Jac->m_Q;
+        for (int k = 0; k < 3; k++) {
+            ChVector<> e(0, 0, 0);
+            e[k] = 1;
+            Q.setZero();
+            this->objA->ContactForceLoadQ(-e, this->p1, stateA_x, Q, 0);
+            this->objB->ContactForceLoadQ(e, this->p2, stateB_x, Q, ndofA_w);
+            m_Jac->m_Jt.col(k) = Q;
         }
+
+        m_Jac->m_K.noalias() = m_Jac->m_Jt * dF_dd * m_Jac->m_Jt.transpose();
+        m_Jac->m_R.noalias() = -m_Jac->m_Jt * dF_dv * m_Jac->m_Jt.transpose();
     }
 
     /// Apply contact forces to the two objects.
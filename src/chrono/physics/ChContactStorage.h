@@ -0,0 +1,196 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Alessandro Tasora, Radu Serban
+// =============================================================================
+
+#ifndef CH_CONTACT_STORAGE_H
+#define CH_CONTACT_STORAGE_H
+
+#include <list>
+#include <vector>
+
+#include "chrono/core/ChMatrix.h"
+#include "chrono/collision/ChCollisionInfo.h"
+
+namespace chrono {
+
+class ChContactContainer;
+
+/// Storage modes for the contact objects of a contact container.
+enum class ChContactStorageMode {
+    LIST,  ///< contacts individually heap-allocated in a linked list; contacts not reused in a step are deleted
+    POOL   ///< contacts allocated in contiguous slabs and recycled across steps without heap traffic
+};
+
+/// Storage for the contacts of a given type, used by contact containers.
+/// Contacts are (re)initialized in a sequence of insertions bracketed by Begin() and End(), as done by the collision
+/// system in ChContactContainer::BeginAddContact() and ChContactContainer::EndAddContact(). Contacts from a previous
+/// step are reused (through their Reset() function) whenever possible. Two storage modes are available:
+/// - in LIST mode, each contact is allocated with 'new' and kept in a linked list; contacts that are not reused by
+///   the end of an insertion sequence are deleted;
+/// - in POOL mode, contacts are constructed in place in fixed-size blocks of contiguous memory; contacts that are not
+///   reused are kept in the pool for later steps, so that no allocation occurs once the pool has grown to the peak
+///   number of contacts, and the per-contact loops run over contiguous memory.
+/// In both modes a contact never moves once created, so pointers to its inner constraints remain valid.
+/// Tcont is the contact type (e.g. a ChContactNSC or ChContactSMC class).
+template <class Tcont>
+class ChContactStorage {
+  public:
+    /// Number of contacts in a pool block.
+    static const size_t block_size = 128;
+
+    /// Forward iterator over the active contacts; dereferencing returns a pointer to the contact.
+    class iterator {
+      public:
+        Tcont* operator*() const { return m_ptr ? m_ptr : *m_iter; }
+
+        iterator& operator++() {
+            if (m_ptr) {
+                ++m_index;
+                ++m_ptr;
+                if (m_index % block_size == 0)
+                    m_ptr = (m_index < m_storage->m_active) ? m_storage->m_blocks[m_index / block_size] : nullptr;
+            } else {
+                ++m_iter;
+            }
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const { return m_index == other.m_index && m_iter == other.m_iter; }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+      private:
+        iterator(const ChContactStorage* storage, typename std::list<Tcont*>::iterator iter, size_t index)
+            : m_storage(storage), m_iter(iter), m_index(index), m_ptr(nullptr) {
+            if (storage->m_mode == ChContactStorageMode::POOL && m_index < storage->m_active)
+                m_ptr = storage->m_blocks[m_index / block_size] + m_index % block_size;
+        }
+
+        const ChContactStorage* m_storage;
+        typename std::list<Tcont*>::iterator m_iter;  ///< current contact (LIST mode)
+        size_t m_index;                               ///< index of current contact (POOL mode)
+        Tcont* m_ptr;                                 ///< current contact (POOL mode), nullptr in LIST mode
+
+        friend class ChContactStorage;
+    };
+
+    ChContactStorage() : m_mode(ChContactStorageMode::LIST), m_active(0), m_constructed(0) {
+        m_last = m_list.begin();
+    }
+
+    ~ChContactStorage() { Clear(); }
+
+    /// Get the current storage mode.
+    ChContactStorageMode GetMode() const { return m_mode; }
+
+    /// Set the storage mode. All existing contacts are deleted.
+    void SetMode(ChContactStorageMode mode) {
+        Clear();
+        m_mode = mode;
+    }
+
+    /// Get the number of active contacts.
+    size_t size() const { return m_active; }
+
+    /// Get the number of contact objects currently allocated (including those kept for reuse in POOL mode).
+    size_t capacity() const { return m_mode == ChContactStorageMode::POOL ? m_constructed : m_list.size(); }
+
+    iterator begin() { return iterator(this, m_mode == ChContactStorageMode::POOL ? m_list.end() : m_list.begin(), 0); }
+    iterator end() { return iterator(this, m_list.end(), m_mode == ChContactStorageMode::POOL ? m_active : 0); }
+
+    /// Start a new sequence of contact insertions. Existing contacts are kept for reuse.
+    void Begin() {
+        m_last = m_list.begin();
+        m_active = 0;
+    }
+
+    /// Add a contact, reusing an existing contact object if possible.
+    template <class Ta, class Tb, class Tmat>
+    void Insert(ChContactContainer* container,           ///< contact container
+                Ta* objA,                                ///< collidable object A
+                Tb* objB,                                ///< collidable object B
+                const collision::ChCollisionInfo& cinfo,  ///< collision information
+                const Tmat& cmat                          ///< composite material
+    ) {
+        if (m_mode == ChContactStorageMode::POOL) {
+            if (m_active < m_constructed) {
+                // reuse old contacts
+                Slot(m_active)->Reset(objA, objB, cinfo, cmat);
+            } else {
+                // construct a new contact in place, growing the pool if needed
+                if (m_constructed == m_blocks.size() * block_size)
+                    m_blocks.push_back(m_allocator.allocate(block_size));
+                new (Slot(m_constructed)) Tcont(container, objA, objB, cinfo, cmat);
+                m_constructed++;
+            }
+        } else {
+            if (m_last != m_list.end()) {
+                // reuse old contacts
+                (*m_last)->Reset(objA, objB, cinfo, cmat);
+                m_last++;
+            } else {
+                // add new contact
+                Tcont* mc = new Tcont(container, objA, objB, cinfo, cmat);
+                m_list.push_back(mc);
+                m_last = m_list.end();
+            }
+        }
+        m_active++;
+    }
+
+    /// Terminate a sequence of contact insertions.
+    /// In LIST mode, contacts that were not reused are deleted. In POOL mode, they are kept for later reuse.
+    void End() {
+        while (m_last != m_list.end()) {
+            delete (*m_last);
+            m_last = m_list.erase(m_last);
+        }
+    }
+
+    /// Delete all contacts and release all memory.
+    void Clear() {
+        for (auto contact : m_list)
+            delete contact;
+        m_list.clear();
+        m_last = m_list.begin();
+
+        for (size_t i = 0; i < m_constructed; i++)
+            Slot(i)->~Tcont();
+        for (auto block : m_blocks)
+            m_allocator.deallocate(block, block_size);
+        m_blocks.clear();
+        m_constructed = 0;
+
+        m_active = 0;
+    }
+
+  private:
+    ChContactStorage(const ChContactStorage&) = delete;
+    ChContactStorage& operator=(const ChContactStorage&) = delete;
+
+    Tcont* Slot(size_t i) const { return m_blocks[i / block_size] + i % block_size; }
+
+    ChContactStorageMode m_mode;
+
+    std::list<Tcont*> m_list;                     ///< contacts (LIST mode)
+    typename std::list<Tcont*>::iterator m_last;  ///< next contact to be reused (LIST mode)
+
+    std::vector<Tcont*> m_blocks;                 ///< blocks of contiguous contacts (POOL mode)
+    Eigen::aligned_allocator<Tcont> m_allocator;  ///< allocator for the pool blocks
+    size_t m_constructed;                         ///< number of contacts constructed in the pool blocks
+
+    size_t m_active;  ///< number of active contacts
+};
+
+}  // end namespace chrono
+
+#endif
@@ -62,6 +62,8 @@ ChSystem::ChSystem()
       stepcount(0),
       solvecount(0),
       setupcount(0),
+      setupcount_total(0),
+      solvecount_total(0),
       dump_matrices(false),
       last_err(false),
       composition_strategy(new ChMaterialCompositionStrategy) {
@@ -97,6 +99,8 @@ ChSystem::ChSystem(const ChSystem& other) {
     stepcount = other.stepcount;
     solvecount = other.solvecount;
     setupcount = other.setupcount;
+    setupcount_total = other.setupcount_total;
+    solvecount_total = other.solvecount_total;
     dump_matrices = other.dump_matrices;
     SetTimestepperType(other.GetTimestepperType());
     tol_force = other.tol_force;
@@ -259,6 +263,7 @@ std::shared_ptr<ChSolver> ChSystem::GetSolver() {
 void ChSystem::SetSystemDescriptor(std::shared_ptr<ChSystemDescriptor> newdescriptor) {
     assert(newdescriptor);
     descriptor = newdescriptor;
+    descriptor->SetNumThreads(GetNumThreads());
 }
 void ChSystem::SetSolver(std::shared_ptr<ChSolver> newsolver) {
     assert(newsolver);
@@ -1078,6 +1083,7 @@ bool ChSystem::StateSolveCorrection(ChStateDelta& Dv,             // result: com
         bool success = GetSolver()->Setup(*descriptor);
         timer_setup.stop();
         setupcount++;
+        setupcount_total++;
         if (!success)
             return false;
     }
@@ -1115,6 +1121,7 @@ bool ChSystem::StateSolveCorrection(ChStateDelta& Dv,             // result: com
     }
 
     solvecount++;
+    solvecount_total++;
 
     return true;
 }
@@ -1338,6 +1345,10 @@ bool ChSystem::Integrate_Y() {
     solvecount = 0;
     setupcount = 0;
 
+    // Process any items queued for removal or insertion, so that the collision system is up to date
+    // (and no contacts are created for removed items).
+    assembly.FlushBatch();
+
     // Compute contacts and create contact constraints
     int ncontacts_old = ncontacts;
     ComputeCollisions();
@@ -263,8 +263,15 @@ class ChApi ChSystem : public ChIntegrableIIorder {
     /// at the first Setup() call. This is thread safe.
     void AddBatch(std::shared_ptr<ChPhysicsItem> item) { assembly.AddBatch(item); }
 
-    /// If some items are queued for addition in the assembly, using AddBatch(), this will
-    /// effectively add them and clean the batch. Called automatically at each Setup().
+    /// Items removed in this way are removed like in the Remove() method, but not instantly,
+    /// they are simply queued in a batch of 'to remove' items, that are removed all at once
+    /// at the beginning of the next step (before collision detection) or Setup() call.
+    /// Use this to retire many items (e.g. particles) efficiently.
+    void RemoveBatch(std::shared_ptr<ChPhysicsItem> item) { assembly.RemoveBatch(item); }
+
+    /// If some items are queued for removal or addition in the assembly, using RemoveBatch() or
+    /// AddBatch(), this will effectively remove/add them and clean the batches.
+    /// Called automatically at the beginning of each step and at each Setup().
     void FlushBatch() { assembly.FlushBatch(); }
 
     /// Remove a body from this assembly.
@@ -619,6 +626,9 @@ class ChApi ChSystem : public ChIntegrableIIorder {
                                   const double c               ///< a scaling factor
                                   ) override;
 
+    /// Update the constraint Jacobians Cq used by LoadResidual_CqL at the current state.
+    virtual void LoadConstraint_Jacobians() override { ConstraintsLoadJacobians(); }
+
     /// Increment a vector Qc with the term C:
     ///    Qc += c*C
     virtual void LoadConstraint_C(ChVectorDynamic<>& Qc,        ///< result: the Qc residual, Qc += c*C
@@ -686,6 +696,17 @@ class ChApi ChSystem : public ChIntegrableIIorder {
     /// Tell if the system will put to sleep the bodies whose motion has almost come to a rest.
     bool GetUseSleeping() const { return use_sleeping; }
 
+    /// Set the number of OpenMP threads used for the loops over bodies and links in the assembly passes (default: 1).
+    /// See ChAssembly::SetNumThreads for the requirements on the modeling elements.
+    /// The same number of threads is used by the system descriptor for the matrix assembly with an assembly plan.
+    void SetNumThreads(int num_threads) {
+        assembly.SetNumThreads(num_threads);
+        descriptor->SetNumThreads(num_threads);
+    }
+
+    /// Get the number of OpenMP threads used in the assembly passes.
+    int GetNumThreads() const { return assembly.GetNumThreads(); }
+
   private:
     /// Put bodies to sleep if possible. Also awakens sleeping bodies, if needed.
     /// Returns true if some body changed from sleep to no sleep or viceversa,
@@ -739,6 +760,22 @@ class ChApi ChSystem : public ChIntegrableIIorder {
     /// This counter is reset at each timestep.
     int GetSolverSetupCount() const { return setupcount; }
 
+    /// Return the total number of calls to the solver's Solve() function
+    /// since the system was created or since the last call to ResetSolverCallsTotal().
+    size_t GetSolverCallsTotal() const { return solvecount_total; }
+
+    /// Return the total number of calls to the solver's Setup() function
+    /// since the system was created or since the last call to ResetSolverCallsTotal().
+    /// The ratio of setup to solve calls measures the amount of factorization reuse
+    /// (e.g., with the modified Newton iteration of the HHT timestepper).
+    size_t GetSolverSetupTotal() const { return setupcount_total; }
+
+    /// Reset to 0 the total numbers of calls to the solver's Setup() and Solve() functions.
+    void ResetSolverCallsTotal() {
+        setupcount_total = 0;
+        solvecount_total = 0;
+    }
+
     /// Set this to "true" to enable automatic saving of solver matrices at each time
     /// step, for debugging purposes. Note that matrices will be saved in the
     /// working directory of the exe, with format 0001_01_H.dat 0002_01_H.dat
@@ -899,6 +936,9 @@ class ChApi ChSystem : public ChIntegrableIIorder {
     int setupcount;  ///< number of calls to the solver's Setup()
     int solvecount;  ///< number of StateSolveCorrection (reset to 0 at each timestep of static analysis)
 
+    size_t setupcount_total;  ///< total number of calls to the solver's Setup()
+    size_t solvecount_total;  ///< total number of calls to the solver's Solve()
+
     bool dump_matrices;  ///< for debugging
 
     int ncontacts;  ///< total number of contacts
@@ -23,6 +23,7 @@ ChDirectSolverLS::ChDirectSolverLS()
     : m_lock(false),
       m_use_learner(true),
       m_force_update(true),
+      m_pattern_changed(true),
       m_null_pivot_detection(false),
       m_use_rhs_sparsity(false),
       m_use_perm(false),
@@ -66,6 +67,9 @@ bool ChDirectSolverLS::Setup(ChSystemDescriptor& sysd) {
         GetLog() << "  CALL reserve:   " << call_reserve << "\n";
     }
 
+    int nnz = (int)m_mat.nonZeros();
+    int dim = (int)m_mat.rows();
+
     if (call_learner) {
         ChSparsityPatternLearner sparsity_pattern(m_dim, m_dim);
         sysd.ConvertToMatrixForm(&sparsity_pattern, nullptr);
@@ -77,12 +81,22 @@ bool ChDirectSolverLS::Setup(ChSystemDescriptor& sysd) {
         m_mat.reserve(Eigen::VectorXi::Constant(m_dim, static_cast<int>(m_dim * density)));
     }
 
-    // Let the system descriptor load the current matrix
-    sysd.ConvertToMatrixForm(&m_mat, nullptr);
+    // Let the system descriptor load the current matrix.
+    // With a locked sparsity pattern, use (and, if needed, record) an assembly plan to scatter the matrix values
+    // directly in the existing pattern.
+    if (m_lock && !call_learner && !call_reserve) {
+        sysd.ConvertToMatrixForm(&m_mat, m_plan);
+    } else {
+        m_plan.Reset();
+        sysd.ConvertToMatrixForm(&m_mat, nullptr);
+    }
 
     // Allow the matrix to be compressed
     m_mat.makeCompressed();
 
+    // Flag a (possible) change in the sparsity pattern, for solvers that reuse a symbolic analysis
+    m_pattern_changed = call_learner || call_reserve || m_mat.nonZeros() != nnz || m_dim != dim;
+
     m_timer_setup_assembly.stop();
 
     // Let the concrete solver perform the facorization
@@ -227,4 +241,110 @@ void ChSolverSparseQR::PrintErrorMessage() {
     }
 }
 
+// ---------------------------------------------------------------------------
+
+ChSolverSparseLDLT::ChSolverSparseLDLT() : m_analyzed(false), m_info(Eigen::Success), m_analysis_call(0) {
+    m_symmetry = MatrixSymmetryType::SYMMETRIC_INDEF;
+}
+
+void ChSolverSparseLDLT::SetMatrixSymmetryType(MatrixSymmetryType symmetry) {
+    if (symmetry != m_symmetry)
+        m_analyzed = false;
+    m_symmetry = symmetry;
+}
+
+void ChSolverSparseLDLT::ResetTimers() {
+    ChDirectSolverLS::ResetTimers();
+    m_timer_analysis.reset();
+}
+
+template <typename Engine>
+Eigen::ComputationInfo ChSolverSparseLDLT::Factorize(Engine& engine) {
+    bool analyze = m_pattern_changed || !m_analyzed;
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (analyze) {
+            m_timer_analysis.start();
+            engine.analyzePattern(m_mat);
+            m_timer_analysis.stop();
+            m_analysis_call++;
+            m_analyzed = (engine.info() == Eigen::Success);
+            if (!m_analyzed)
+                return engine.info();
+        }
+
+        engine.factorize(m_mat);
+        if (engine.info() == Eigen::Success || analyze)
+            break;
+
+        // The factorization failed with a reused analysis; redo the analysis with the current matrix values
+        if (verbose)
+            GetLog() << "  factorization failed with reused analysis; redo analysis\n";
+        analyze = true;
+    }
+
+    return engine.info();
+}
+
+bool ChSolverSparseLDLT::FactorizeMatrix() {
+    switch (m_symmetry) {
+        case MatrixSymmetryType::SYMMETRIC_INDEF:
+            m_info = Factorize(m_engine_ldlt);
+            break;
+        case MatrixSymmetryType::SYMMETRIC_POSDEF:
+            m_info = Factorize(m_engine_llt);
+            break;
+        default:
+            m_engine_lu.compute(m_mat);
+            m_info = m_engine_lu.info();
+            break;
+    }
+
+    if (verbose && m_info == Eigen::Success) {
+        GetLog() << "  symbolic analyses: " << m_analysis_call << " (" << m_timer_analysis.GetTimeSecondsIntermediate()
+                 << "s)\n";
+    }
+
+    return (m_info == Eigen::Success);
+}
+
+bool ChSolverSparseLDLT::SolveSystem() {
+    switch (m_symmetry) {
+        case MatrixSymmetryType::SYMMETRIC_INDEF:
+            m_sol = m_engine_ldlt.solve(m_rhs);
+            m_info = m_engine_ldlt.info();
+            break;
+        case MatrixSymmetryType::SYMMETRIC_POSDEF:
+            m_sol = m_engine_llt.solve(m_rhs);
+            m_info = m_engine_llt.info();
+            break;
+        default:
+            m_sol = m_engine_lu.solve(m_rhs);
+            m_info = m_engine_lu.info();
+            break;
+    }
+    return (m_info == Eigen::Success);
+}
+
+void ChSolverSparseLDLT::PrintErrorMessage() {
+    switch (m_info) {
+        case Eigen::Success:
+            GetLog() << "computation was successful\n";
+            break;
+        case Eigen::NumericalIssue:
+            if (m_symmetry == MatrixSymmetryType::SYMMETRIC_POSDEF)
+                GetLog() << "LLT factorization reported a problem, matrix not positive definite\n";
+            else if (m_symmetry == MatrixSymmetryType::SYMMETRIC_INDEF)
+                GetLog() << "LDLT factorization reported a problem, zero pivot encountered\n";
+            else
+                GetLog() << "LU factorization reported a problem, zero diagonal for instance\n";
+            break;
+        case Eigen::InvalidInput:
+            GetLog() << "inputs are invalid, or the algorithm has been improperly called\n";
+            break;
+        default:
+            break;
+    }
+}
+
 }  // end namespace chrono
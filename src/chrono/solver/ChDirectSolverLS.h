@@ -16,10 +16,14 @@
 #define CH_DIRECTSOLVER_LS_H
 
 #include "chrono/core/ChMatrix.h"
+#include "chrono/core/ChSparseAssemblyPlan.h"
 #include "chrono/core/ChTimer.h"
 #include "chrono/solver/ChSolverLS.h"
 
+#include <vector>
+
 #include <Eigen/SparseLU>
+#include <Eigen/SparseCholesky>
 
 namespace chrono {
 
@@ -80,6 +84,9 @@ class ChApi ChDirectSolverLS : public ChSolverLS {
 
     /// Enable/disable locking the sparsity pattern (default: false).\n
     /// If enabled, the sparsity pattern of the problem matrix is assumed to be unchanged from call to call.
+    /// In that case, the matrix assembly is recorded in an assembly plan, which is used in subsequent calls to scatter
+    /// the matrix values directly in the existing pattern (see ChSystemDescriptor::ConvertToMatrixForm). A change in
+    /// the problem structure is detected and triggers a regular assembly.
     /// Enable this option whenever possible to improve performance.
     void LockSparsityPattern(bool val) { m_lock = val; }
 
@@ -112,7 +119,7 @@ class ChApi ChDirectSolverLS : public ChSolverLS {
     virtual void EnableNullPivotDetection(bool val, double threshold = 0) { m_null_pivot_detection = val; }
 
     /// Reset timers for internal phases in Solve and Setup.
-    void ResetTimers();
+    virtual void ResetTimers();
 
     /// Get cumulative time for assembly operations in Solve phase.
     double GetTimeSolve_Assembly() const { return m_timer_solve_assembly(); }
@@ -165,6 +172,7 @@ class ChApi ChDirectSolverLS : public ChSolverLS {
     virtual bool SolveRequiresMatrix() const override { return false; }
 
     ChSparseMatrix m_mat;           ///< problem matrix
+    ChSparseAssemblyPlan m_plan;    ///< assembly plan for the problem matrix (used with a locked sparsity pattern)
     int m_dim;                      ///< problem size
     MatrixSymmetryType m_symmetry;  ///< symmetry of problem matrix
     double m_sparsity;              ///< user-supplied estimate of matrix sparsity
@@ -174,9 +182,10 @@ class ChApi ChDirectSolverLS : public ChSolverLS {
     int m_solve_call;  ///< counter for calls to Solve
     int m_setup_call;  ///< counter for calls to Setup
 
-    bool m_lock;          ///< is the matrix sparsity pattern locked?
-    bool m_use_learner;   ///< use the sparsity pattern learner?
-    bool m_force_update;  ///< force a call to the sparsity pattern learner?
+    bool m_lock;             ///< is the matrix sparsity pattern locked?
+    bool m_use_learner;      ///< use the sparsity pattern learner?
+    bool m_force_update;     ///< force a call to the sparsity pattern learner?
+    bool m_pattern_changed;  ///< may the sparsity pattern have changed in the current Setup?
 
     bool m_use_perm;              ///< use of the permutation vector?
     bool m_use_rhs_sparsity;      ///< leverage right-hand side sparsity?
@@ -240,6 +249,134 @@ class ChApi ChSolverSparseQR : public ChDirectSolverLS {
     Eigen::SparseQR<ChSparseMatrix, Eigen::COLAMDOrdering<int>> m_engine;  ///< Eigen SparseQR solver
 };
 
+/// Fill-reducing ordering for symmetric saddle-point (KKT) matrices.\n
+/// This is Eigen's approximate minimum degree (AMD) ordering, modified so that any row with a zero diagonal entry (e.g.,
+/// a bilateral constraint without compliance) is eliminated only after all rows it couples to and which have a nonzero
+/// diagonal. For a matrix [H Cq'; Cq 0] with H positive definite and Cq of full row rank, all leading principal
+/// submatrices of the permuted matrix are then nonsingular, so that an LDLT factorization without pivoting exists.
+/// For matrices with no zero diagonal entries, this is identical to Eigen::AMDOrdering.
+template <typename StorageIndex>
+class ChConstrainedAMDOrdering {
+  public:
+    typedef Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, StorageIndex> PermutationType;
+
+    /// Compute the permutation vector from a full (column-major) symmetric sparse matrix.
+    /// As with all Eigen ordering methods, perm.indices()[k] is the original index of the k-th eliminated row.
+    template <typename MatrixType>
+    void operator()(const MatrixType& mat, PermutationType& perm) {
+        Eigen::AMDOrdering<StorageIndex> amd;
+        amd(mat, perm);
+
+        StorageIndex n = (StorageIndex)mat.cols();
+
+        // Identify rows with zero diagonal and count their neighbors with nonzero diagonal
+        std::vector<char> deferred(n, 0);
+        for (StorageIndex j = 0; j < n; j++) {
+            typename MatrixType::Scalar diag = 0;
+            for (typename MatrixType::InnerIterator it(mat, j); it; ++it) {
+                if (it.index() == j)
+                    diag = it.value();
+            }
+            deferred[j] = (diag == 0);
+        }
+        std::vector<StorageIndex> count(n, 0);
+        for (StorageIndex j = 0; j < n; j++) {
+            if (!deferred[j])
+                continue;
+            for (typename MatrixType::InnerIterator it(mat, j); it; ++it) {
+                if (it.index() != j && !deferred[it.index()])
+                    count[j]++;
+            }
+        }
+
+        // Walk the AMD order, holding back each deferred row until all its neighbors were eliminated
+        std::vector<char> reached(n, 0);
+        std::vector<StorageIndex> order;
+        order.reserve(n);
+        for (StorageIndex k = 0; k < n; k++) {
+            StorageIndex i = perm.indices()[k];
+            if (deferred[i]) {
+                reached[i] = 1;
+                if (count[i] == 0)
+                    order.push_back(i);
+                continue;
+            }
+            order.push_back(i);
+            for (typename MatrixType::InnerIterator it(mat, i); it; ++it) {
+                StorageIndex c = (StorageIndex)it.index();
+                if (c != i && deferred[c] && --count[c] == 0 && reached[c])
+                    order.push_back(c);
+            }
+        }
+
+        for (StorageIndex k = 0; k < n; k++)
+            perm.indices()[k] = order[k];
+    }
+};
+
+/// Sparse LDLT direct solver.\n
+/// Interface to Eigen's simplicial sparse Cholesky solvers, for problems with a symmetric matrix (typically, SMC and
+/// FEA problems). The matrix symmetry type (see #SetMatrixSymmetryType) is honored as follows:
+/// - SYMMETRIC_INDEF (default): LDLT factorization, using the ChConstrainedAMDOrdering fill-reducing ordering;
+/// - SYMMETRIC_POSDEF: LLT factorization, using the same ordering (plain AMD for a positive definite matrix);
+/// - GENERAL or STRUCTURAL_SYMMETRIC: the matrix is not symmetric and Eigen's SparseLU solver is used instead.
+///
+/// The symbolic analysis (fill-reducing ordering and elimination tree) is performed only if the sparsity pattern may
+/// have changed: at the first call, at each call if the sparsity pattern is not locked, or after a call to
+/// #ForceSparsityPatternUpdate. Otherwise, only the numerical factorization is performed at each Setup. If the
+/// numerical factorization fails with a reused analysis (for example, because the set of zero diagonal entries has
+/// changed), the analysis is redone once before reporting a failure.\n
+/// The time for the analysis and factorization is included in #GetTimeSetup_SolverCall.\n
+/// Only the lower triangular part of the matrix is used by the LDLT and LLT factorizations.\n
+/// Cannot handle VI and complementarity problems, so it cannot be used with NSC formulations.\n
+/// See ChDirectSolverLS for more details.
+class ChApi ChSolverSparseLDLT : public ChDirectSolverLS {
+  public:
+    ChSolverSparseLDLT();
+    ~ChSolverSparseLDLT() {}
+    virtual Type GetType() const override { return Type::SPARSE_LDLT; }
+
+    /// Set the matrix symmetry type (default: SYMMETRIC_INDEF).
+    virtual void SetMatrixSymmetryType(MatrixSymmetryType symmetry) override;
+
+    /// Reset timers for internal phases in Solve and Setup.
+    virtual void ResetTimers() override;
+
+    /// Get cumulative time for the symbolic analysis in Setup phase (included in GetTimeSetup_SolverCall).
+    double GetTimeSetup_Analysis() const { return m_timer_analysis(); }
+
+    /// Return the number of symbolic analyses performed so far.
+    int GetNumAnalysisCalls() const { return m_analysis_call; }
+
+  private:
+    typedef Eigen::SimplicialLDLT<ChSparseMatrix, Eigen::Lower, ChConstrainedAMDOrdering<int>> LDLTengine;
+    typedef Eigen::SimplicialLLT<ChSparseMatrix, Eigen::Lower, ChConstrainedAMDOrdering<int>> LLTengine;
+
+    /// Factorize the current sparse matrix and return true if successful.
+    virtual bool FactorizeMatrix() override;
+
+    /// Solve the linear system using the current factorization and right-hand side vector.
+    /// Load the solution vector (already of appropriate size) and return true if succesful.
+    virtual bool SolveSystem() override;
+
+    /// Display an error message corresponding to the last failure.
+    /// This function is only called if Factorize or Solve returned false.
+    virtual void PrintErrorMessage() override;
+
+    /// Perform (if needed) the symbolic analysis and the numerical factorization with the given engine.
+    template <typename Engine>
+    Eigen::ComputationInfo Factorize(Engine& engine);
+
+    LDLTengine m_engine_ldlt;                                                 ///< Eigen SimplicialLDLT solver
+    LLTengine m_engine_llt;                                                   ///< Eigen SimplicialLLT solver
+    Eigen::SparseLU<ChSparseMatrix, Eigen::COLAMDOrdering<int>> m_engine_lu;  ///< Eigen SparseLU solver (general case)
+
+    bool m_analyzed;                 ///< is there a symbolic analysis available for reuse?
+    Eigen::ComputationInfo m_info;   ///< result of last factorization or solution
+    int m_analysis_call;             ///< counter for symbolic analyses
+    ChTimer<> m_timer_analysis;      ///< timer for symbolic analysis
+};
+
 /// @} chrono_solver
 
 }  // end namespace chrono
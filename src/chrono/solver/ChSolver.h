@@ -52,6 +52,8 @@ class ChApi ChSolver {
         BICGSTAB,  ///< Bi-conjugate gradient stabilized
         // Other
         CUSTOM,
+        // Direct linear solvers (appended, so that the values of the above types are not changed)
+        SPARSE_LDLT,  ///< Sparse LDLT factorization for symmetric matrices
     };
 
     virtual ~ChSolver() {}
@@ -12,6 +12,9 @@
 // Authors: Alessandro Tasora, Radu Serban
 // =============================================================================
 
+#include <cstdint>
+#include <unordered_map>
+
 #include "chrono/solver/ChSolverPSOR.h"
 #include "chrono/core/ChMathematics.h"
 
@@ -20,7 +23,7 @@ namespace chrono {
 // Register into the object factory, to enable run-time dynamic creation and persistence
 CH_FACTORY_REGISTER(ChSolverPSOR)
 
-ChSolverPSOR::ChSolverPSOR() : maxviolation(0) {}
+ChSolverPSOR::ChSolverPSOR() : maxviolation(0), m_parallel(false) {}
 
 double ChSolverPSOR::Solve(ChSystemDescriptor& sysd) {
     std::vector<ChConstraint*>& mconstraints = sysd.GetConstraintsList();
@@ -29,8 +32,6 @@ double ChSolverPSOR::Solve(ChSystemDescriptor& sysd) {
     m_iterations = 0;
     maxviolation = 0;
     double maxdeltalambda = 0.;
-    int i_friction_comp = 0;
-    double old_lambda_friction[3];
 
     // 1)  Update auxiliary data in all constraints before starting,
     //     that is: g_i=[Cq_i]*[invM_i]*[Cq_i]' and  [Eq_i]=[invM_i]*[Cq_i]'
@@ -75,7 +76,22 @@ double ChSolverPSOR::Solve(ChSystemDescriptor& sysd) {
             mconstraints[ic]->Set_l_i(0.);
     }
 
-    // 4)  Perform the iteration loops
+    // 4)  Partition the constraints in blocks, i.e. single constraints or
+    //     triplets of friction constraints (N,U,V) to be projected together.
+    m_block_start.clear();
+    m_block_size.clear();
+    for (int ic = 0; ic < (int)mconstraints.size();) {
+        int size = (mconstraints[ic]->GetMode() == CONSTRAINT_FRIC) ? 3 : 1;
+        m_block_start.push_back(ic);
+        m_block_size.push_back(size);
+        ic += size;
+    }
+    int nblocks = (int)m_block_start.size();
+
+    if (m_parallel)
+        ColorBlocks(mconstraints, mvariables);
+
+    // 5)  Perform the iteration loops
     //
 
     for (int iter = 0; iter < m_max_iterations; iter++) {
@@ -84,93 +100,37 @@ double ChSolverPSOR::Solve(ChSystemDescriptor& sysd) {
 
         maxviolation = 0;
         maxdeltalambda = 0;
-        i_friction_comp = 0;
-
-        for (unsigned int ic = 0; ic < mconstraints.size(); ic++) {
-            // skip computations if constraint not active.
-            if (mconstraints[ic]->IsActive()) {
-                // compute residual  c_i = [Cq_i]*q + b_i + cfm_i*l_i
-                double mresidual = mconstraints[ic]->Compute_Cq_q() + mconstraints[ic]->Get_b_i() +
-                                   mconstraints[ic]->Get_cfm_i() * mconstraints[ic]->Get_l_i();
-
-                // true constraint violation may be different from 'mresidual' (ex:clamped if unilateral)
-                double candidate_violation = fabs(mconstraints[ic]->Violation(mresidual));
-
-                // compute:  delta_lambda = -(omega/g_i) * ([Cq_i]*q + b_i + cfm_i*l_i )
-                double deltal = (m_omega / mconstraints[ic]->Get_g_i()) * (-mresidual);
-
-                if (mconstraints[ic]->GetMode() == CONSTRAINT_FRIC) {
-                    candidate_violation = 0;
-
-                    // update:   lambda += delta_lambda;
-                    old_lambda_friction[i_friction_comp] = mconstraints[ic]->Get_l_i();
-                    mconstraints[ic]->Set_l_i(old_lambda_friction[i_friction_comp] + deltal);
-                    i_friction_comp++;
-
-                    if (i_friction_comp == 1)
-                        candidate_violation = fabs(ChMin(0.0, mresidual));
-
-                    if (i_friction_comp == 3) {
-                        mconstraints[ic - 2]->Project();  // the N normal component will take care of N,U,V
-                        double new_lambda_0 = mconstraints[ic - 2]->Get_l_i();
-                        double new_lambda_1 = mconstraints[ic - 1]->Get_l_i();
-                        double new_lambda_2 = mconstraints[ic - 0]->Get_l_i();
-                        // Apply the smoothing: lambda= sharpness*lambda_new_projected + (1-sharpness)*lambda_old
-                        if (m_shlambda != 1.0) {
-                            new_lambda_0 = m_shlambda * new_lambda_0 + (1.0 - m_shlambda) * old_lambda_friction[0];
-                            new_lambda_1 = m_shlambda * new_lambda_1 + (1.0 - m_shlambda) * old_lambda_friction[1];
-                            new_lambda_2 = m_shlambda * new_lambda_2 + (1.0 - m_shlambda) * old_lambda_friction[2];
-                            mconstraints[ic - 2]->Set_l_i(new_lambda_0);
-                            mconstraints[ic - 1]->Set_l_i(new_lambda_1);
-                            mconstraints[ic - 0]->Set_l_i(new_lambda_2);
-                        }
-                        double true_delta_0 = new_lambda_0 - old_lambda_friction[0];
-                        double true_delta_1 = new_lambda_1 - old_lambda_friction[1];
-                        double true_delta_2 = new_lambda_2 - old_lambda_friction[2];
-                        mconstraints[ic - 2]->Increment_q(true_delta_0);
-                        mconstraints[ic - 1]->Increment_q(true_delta_1);
-                        mconstraints[ic - 0]->Increment_q(true_delta_2);
-
-                        if (this->record_violation_history) {
-                            maxdeltalambda = ChMax(maxdeltalambda, fabs(true_delta_0));
-                            maxdeltalambda = ChMax(maxdeltalambda, fabs(true_delta_1));
-                            maxdeltalambda = ChMax(maxdeltalambda, fabs(true_delta_2));
-                        }
-                        i_friction_comp = 0;
-                    }
-                } else {
-                    // update:   lambda += delta_lambda;
-                    double old_lambda = mconstraints[ic]->Get_l_i();
-                    mconstraints[ic]->Set_l_i(old_lambda + deltal);
-
-                    // If new lagrangian multiplier does not satisfy inequalities, project
-                    // it into an admissible orthant (or, in general, onto an admissible set)
-                    mconstraints[ic]->Project();
-
-                    // After projection, the lambda may have changed a bit..
-                    double new_lambda = mconstraints[ic]->Get_l_i();
-
-                    // Apply the smoothing: lambda= sharpness*lambda_new_projected + (1-sharpness)*lambda_old
-                    if (m_shlambda != 1.0) {
-                        new_lambda = m_shlambda * new_lambda + (1.0 - m_shlambda) * old_lambda;
-                        mconstraints[ic]->Set_l_i(new_lambda);
-                    }
-
-                    double true_delta = new_lambda - old_lambda;
-
-                    // For all items with variables, add the effect of incremented
-                    // (and projected) lagrangian reactions:
-                    mconstraints[ic]->Increment_q(true_delta);
 
-                    if (this->record_violation_history)
-                        maxdeltalambda = ChMax(maxdeltalambda, fabs(true_delta));
+        if (m_parallel) {
+            // Sweep the colors in sequence, the blocks of a color in parallel
+            int ncolors = GetNumColors();
+#pragma omp parallel
+            {
+                double violation = 0;
+                double deltalambda = 0;
+                for (int color = 0; color < ncolors; color++) {
+#pragma omp for
+                    for (int i = m_color_start[color]; i < m_color_start[color + 1]; i++) {
+                        int ib = m_color_blocks[i];
+                        SweepBlock(&mconstraints[m_block_start[ib]], m_block_size[ib], violation, deltalambda);
+                    }
                 }
-
-                maxviolation = ChMax(maxviolation, fabs(candidate_violation));
-
-            }  // end IsActive()
-
-        }  // end loop on constraints
+#pragma omp critical
+                {
+                    maxviolation = ChMax(maxviolation, violation);
+                    maxdeltalambda = ChMax(maxdeltalambda, deltalambda);
+                }
+            }
+            // Sweep the blocks that could not be colored
+            for (int i = m_color_start[ncolors]; i < nblocks; i++) {
+                int ib = m_color_blocks[i];
+                SweepBlock(&mconstraints[m_block_start[ib]], m_block_size[ib], maxviolation, maxdeltalambda);
+            }
+        } else {
+            for (int ib = 0; ib < nblocks; ib++) {
+                SweepBlock(&mconstraints[m_block_start[ib]], m_block_size[ib], maxviolation, maxdeltalambda);
+            }
+        }
 
         // For recording into violation history, if debugging
         if (this->record_violation_history)
@@ -187,4 +147,187 @@ double ChSolverPSOR::Solve(ChSystemDescriptor& sysd) {
     return maxviolation;
 }
 
+void ChSolverPSOR::SweepBlock(ChConstraint** block, int size, double& violation, double& deltalambda) {
+    // skip computations if constraint not active.
+    if (!block[0]->IsActive())
+        return;
+
+    if (size == 3) {
+        double old_lambda_friction[3];
+
+        for (int k = 0; k < 3; k++) {
+            // compute residual  c_i = [Cq_i]*q + b_i + cfm_i*l_i
+            double mresidual =
+                block[k]->Compute_Cq_q() + block[k]->Get_b_i() + block[k]->Get_cfm_i() * block[k]->Get_l_i();
+
+            // for a friction triplet, only the normal component contributes to the violation
+            if (k == 0)
+                violation = ChMax(violation, fabs(ChMin(0.0, mresidual)));
+
+            // compute:  delta_lambda = -(omega/g_i) * ([Cq_i]*q + b_i + cfm_i*l_i )
+            double deltal = (m_omega / block[k]->Get_g_i()) * (-mresidual);
+
+            // update:   lambda += delta_lambda;
+            old_lambda_friction[k] = block[k]->Get_l_i();
+            block[k]->Set_l_i(old_lambda_friction[k] + deltal);
+        }
+
+        block[0]->Project();  // the N normal component will take care of N,U,V
+        double new_lambda_0 = block[0]->Get_l_i();
+        double new_lambda_1 = block[1]->Get_l_i();
+        double new_lambda_2 = block[2]->Get_l_i();
+        // Apply the smoothing: lambda= sharpness*lambda_new_projected + (1-sharpness)*lambda_old
+        if (m_shlambda != 1.0) {
+            new_lambda_0 = m_shlambda * new_lambda_0 + (1.0 - m_shlambda) * old_lambda_friction[0];
+            new_lambda_1 = m_shlambda * new_lambda_1 + (1.0 - m_shlambda) * old_lambda_friction[1];
+            new_lambda_2 = m_shlambda * new_lambda_2 + (1.0 - m_shlambda) * old_lambda_friction[2];
+            block[0]->Set_l_i(new_lambda_0);
+            block[1]->Set_l_i(new_lambda_1);
+            block[2]->Set_l_i(new_lambda_2);
+        }
+        double true_delta_0 = new_lambda_0 - old_lambda_friction[0];
+        double true_delta_1 = new_lambda_1 - old_lambda_friction[1];
+        double true_delta_2 = new_lambda_2 - old_lambda_friction[2];
+        block[0]->Increment_q(true_delta_0);
+        block[1]->Increment_q(true_delta_1);
+        block[2]->Increment_q(true_delta_2);
+
+        if (this->record_violation_history) {
+            deltalambda = ChMax(deltalambda, fabs(true_delta_0));
+            deltalambda = ChMax(deltalambda, fabs(true_delta_1));
+            deltalambda = ChMax(deltalambda, fabs(true_delta_2));
+        }
+    } else {
+        // compute residual  c_i = [Cq_i]*q + b_i + cfm_i*l_i
+        double mresidual =
+            block[0]->Compute_Cq_q() + block[0]->Get_b_i() + block[0]->Get_cfm_i() * block[0]->Get_l_i();
+
+        // true constraint violation may be different from 'mresidual' (ex:clamped if unilateral)
+        violation = ChMax(violation, fabs(block[0]->Violation(mresidual)));
+
+        // compute:  delta_lambda = -(omega/g_i) * ([Cq_i]*q + b_i + cfm_i*l_i )
+        double deltal = (m_omega / block[0]->Get_g_i()) * (-mresidual);
+
+        // update:   lambda += delta_lambda;
+        double old_lambda = block[0]->Get_l_i();
+        block[0]->Set_l_i(old_lambda + deltal);
+
+        // If new lagrangian multiplier does not satisfy inequalities, project
+        // it into an admissible orthant (or, in general, onto an admissible set)
+        block[0]->Project();
+
+        // After projection, the lambda may have changed a bit..
+        double new_lambda = block[0]->Get_l_i();
+
+        // Apply the smoothing: lambda= sharpness*lambda_new_projected + (1-sharpness)*lambda_old
+        if (m_shlambda != 1.0) {
+            new_lambda = m_shlambda * new_lambda + (1.0 - m_shlambda) * old_lambda;
+            block[0]->Set_l_i(new_lambda);
+        }
+
+        double true_delta = new_lambda - old_lambda;
+
+        // For all items with variables, add the effect of incremented
+        // (and projected) lagrangian reactions:
+        block[0]->Increment_q(true_delta);
+
+        if (this->record_violation_history)
+            deltalambda = ChMax(deltalambda, fabs(true_delta));
+    }
+}
+
+void ChSolverPSOR::ColorBlocks(std::vector<ChConstraint*>& mconstraints, std::vector<ChVariables*>& mvariables) {
+    // Maximum number of colors (one bit per color in the per-variable masks)
+    const int max_colors = 64;
+
+    // Index the active variables. Inactive variables (e.g. those of fixed bodies) are not modified by the solver,
+    // so they do not introduce dependencies between constraints.
+    std::unordered_map<ChVariables*, int> var_index;
+    int nvars = 0;
+    for (auto var : mvariables) {
+        if (var->IsActive())
+            var_index[var] = nvars++;
+    }
+
+    // Greedy coloring: assign to each block the lowest color not yet used by any of its variables.
+    // Blocks whose variables are not known, or which would need more than the maximum number of colors,
+    // are assigned to the serial set (color index 'max_colors').
+    int nblocks = (int)m_block_start.size();
+    std::vector<uint64_t> var_colors(nvars, 0);
+    std::vector<int> block_color(nblocks);
+    std::vector<int> color_count(max_colors + 1, 0);
+    std::vector<ChVariables*> vars;
+    std::vector<int> block_vars;
+
+    for (int ib = 0; ib < nblocks; ib++) {
+        vars.clear();
+        bool known = true;
+        for (int k = 0; k < m_block_size[ib]; k++)
+            known &= mconstraints[m_block_start[ib] + k]->CollectVariables(vars);
+
+        int color = max_colors;
+        if (known) {
+            uint64_t used = 0;
+            block_vars.clear();
+            for (auto var : vars) {
+                auto it = var_index.find(var);
+                if (it != var_index.end()) {
+                    block_vars.push_back(it->second);
+                    used |= var_colors[it->second];
+                }
+            }
+            if (~used) {
+                color = 0;
+                while (used & (uint64_t(1) << color))
+                    color++;
+                for (auto v : block_vars)
+                    var_colors[v] |= (uint64_t(1) << color);
+            }
+        }
+
+        block_color[ib] = color;
+        color_count[color]++;
+    }
+
+    int ncolors = 0;
+    for (int color = 0; color < max_colors; color++) {
+        if (color_count[color] > 0)
+            ncolors = color + 1;
+    }
+
+    // Sort the blocks by color (counting sort), serial set last.
+    m_color_start.assign(ncolors + 1, 0);
+    std::vector<int> offset(max_colors + 1);
+    int start = 0;
+    for (int color = 0; color < ncolors; color++) {
+        m_color_start[color] = start;
+        offset[color] = start;
+        start += color_count[color];
+    }
+    m_color_start[ncolors] = start;
+    offset[max_colors] = start;
+
+    m_color_blocks.resize(nblocks);
+    for (int ib = 0; ib < nblocks; ib++)
+        m_color_blocks[offset[block_color[ib]]++] = ib;
+}
+
+std::vector<int> ChSolverPSOR::GetColorBlocks(int color) const {
+    std::vector<int> blocks;
+    if (color < 0 || color >= GetNumColors())
+        return blocks;
+    for (int i = m_color_start[color]; i < m_color_start[color + 1]; i++)
+        blocks.push_back(m_block_start[m_color_blocks[i]]);
+    return blocks;
+}
+
+std::vector<int> ChSolverPSOR::GetSerialBlocks() const {
+    std::vector<int> blocks;
+    if (m_color_start.empty())
+        return blocks;
+    for (int i = m_color_start.back(); i < (int)m_color_blocks.size(); i++)
+        blocks.push_back(m_block_start[m_color_blocks[i]]);
+    return blocks;
+}
+
 }  // end namespace chrono
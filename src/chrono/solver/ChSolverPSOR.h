@@ -25,7 +25,8 @@ namespace chrono {
 /// An iterative solver based on projective fixed point method, with overrelaxation and immediate variable update as in
 /// SOR methods.\n
 /// See ChSystemDescriptor for more information about the problem formulation and the data structures passed to the
-/// solver.
+/// solver.\n
+/// Optionally, the constraints can be swept in parallel (see EnableParallel).
 
 class ChApi ChSolverPSOR : public ChIterativeSolverVI {
   public:
@@ -44,8 +45,46 @@ class ChApi ChSolverPSOR : public ChIterativeSolverVI {
     /// For the PSOR solver, this is the maximum constraint violation.
     virtual double GetError() const override { return maxviolation; }
 
+    /// Enable/disable the parallel sweep of the constraints (default: false).
+    /// If enabled, the constraint graph is colored at each solve so that no two constraints with the same color act
+    /// on the same (active) ChVariables. The colors are then swept in sequence, while the constraints of each color
+    /// are processed concurrently with OpenMP. Friction triplets (normal and tangential components of a contact) are
+    /// always processed together. Since the order of the constraint updates differs from the sequential sweep,
+    /// results are not identical to those of the sequential version (but converge to the same solution).
+    void EnableParallel(bool val) { m_parallel = val; }
+
+    /// Return true if the parallel sweep is enabled.
+    bool IsParallel() const { return m_parallel; }
+
+    /// Return the number of colors used in the last parallel solve.
+    /// Constraints that could not be colored (too many colors needed, or variables not known) are processed
+    /// sequentially after all colors and are not counted here.
+    int GetNumColors() const { return m_color_start.empty() ? 0 : (int)m_color_start.size() - 1; }
+
+    /// Return the constraint blocks assigned to the specified color (0 <= color < GetNumColors()) in the last parallel
+    /// solve. Each block is identified by the index (in the system descriptor constraint list) of its first
+    /// constraint; a block is either a single constraint or a friction triplet.
+    /// Returns an empty list for an invalid color or before the first parallel solve.
+    std::vector<int> GetColorBlocks(int color) const;
+
+    /// Return the constraint blocks that could not be colored and were processed sequentially in the last parallel
+    /// solve (identified as in GetColorBlocks).
+    std::vector<int> GetSerialBlocks() const;
+
   private:
+    /// Process a block of constraints (a single constraint or a friction triplet).
+    void SweepBlock(ChConstraint** block, int size, double& violation, double& deltalambda);
+
+    /// Partition the constraint blocks in independent sets.
+    void ColorBlocks(std::vector<ChConstraint*>& mconstraints, std::vector<ChVariables*>& mvariables);
+
     double maxviolation;
+    bool m_parallel;
+
+    std::vector<int> m_block_start;  ///< index of first constraint in each block
+    std::vector<int> m_block_size;   ///< number of constraints in each block (1 or 3)
+    std::vector<int> m_color_blocks;  ///< block indices, sorted by color (blocks in serial set last)
+    std::vector<int> m_color_start;   ///< start of each color in m_color_blocks (last entry: start of serial set)
 };
 
 /// @} chrono_solver
@@ -25,7 +25,7 @@ CH_FACTORY_REGISTER(ChSystemDescriptor)
 
 #define CH_SPINLOCK_HASHSIZE 203
 
-ChSystemDescriptor::ChSystemDescriptor() : n_q(0), n_c(0), c_a(1.0), freeze_count(false) {
+ChSystemDescriptor::ChSystemDescriptor() : n_q(0), n_c(0), c_a(1.0), num_threads(1), freeze_count(false) {
     vconstraints.clear();
     vvariables.clear();
     vstiffness.clear();
@@ -264,6 +264,111 @@ void ChSystemDescriptor::ConvertToMatrixForm(ChSparseMatrix* Z, ChVectorDynamic<
     }
 }
 
+void ChSystemDescriptor::ConvertToMatrixForm(ChSparseMatrix* Z, ChSparseAssemblyPlan& plan) {
+    // Collect the active variables and constraints (in the same order as in ConvertToMatrixForm(Z, rhs)).
+    std::vector<ChVariables*> active_variables;
+    std::vector<ChConstraint*> active_constraints;
+    active_variables.reserve(vvariables.size());
+    active_constraints.reserve(vconstraints.size());
+    for (auto var : vvariables) {
+        if (var->IsActive())
+            active_variables.push_back(var);
+    }
+    for (auto con : vconstraints) {
+        if (con->IsActive())
+            active_constraints.push_back(con);
+    }
+
+    n_q = CountActiveVariables();
+    int mn_c = (int)active_constraints.size();
+    int nv = (int)active_variables.size();
+    int nk = (int)vstiffness.size();
+    int nc = mn_c;
+
+    bool same_size = Z->rows() == n_q + mn_c && Z->cols() == n_q + mn_c;
+
+    // Replay the assembly plan, if it is valid for the current matrix and problem structure.
+    // The blocks of the mass matrices and of the constraints write disjoint sets of entries and are replayed
+    // concurrently. The stiffness blocks accumulate in shared entries and use atomic updates when run in parallel.
+    if (same_size && plan.IsValidFor(*Z) && plan.GetNumBlocks() == nv + nk + nc) {
+        std::fill(Z->valuePtr(), Z->valuePtr() + Z->nonZeros(), 0.0);
+
+        int failed = 0;
+
+#pragma omp parallel num_threads(num_threads) if (num_threads > 1 && nv + nk + nc >= 64) reduction(+ : failed)
+        {
+            ChSparseAssemblyReplayer replayer(*Z, plan);
+            replayer.SetAtomic(CHOMPfunctions::GetNumThreads() > 1);
+
+#pragma omp for schedule(static)
+            for (int iv = 0; iv < nv; iv++) {
+                replayer.BeginBlock(iv);
+                active_variables[iv]->Build_M(replayer, active_variables[iv]->GetOffset(),
+                                              active_variables[iv]->GetOffset(), c_a);
+                replayer.EndBlock();
+            }
+
+#pragma omp for schedule(dynamic, 16)
+            for (int ik = 0; ik < nk; ik++) {
+                replayer.BeginBlock(nv + ik);
+                vstiffness[ik]->Build_K(replayer, true);
+                replayer.EndBlock();
+            }
+
+#pragma omp for schedule(static)
+            for (int ic = 0; ic < nc; ic++) {
+                replayer.BeginBlock(nv + nk + ic);
+                active_constraints[ic]->Build_Cq(replayer, n_q + ic);
+                active_constraints[ic]->Build_CqT(replayer, n_q + ic);
+                replayer.SetElement(n_q + ic, n_q + ic, active_constraints[ic]->Get_cfm_i());
+                replayer.EndBlock();
+            }
+
+            failed += replayer.Failed() ? 1 : 0;
+        }
+
+        if (failed == 0)
+            return;
+
+        // The problem structure changed; assemble anew.
+        plan.Reset();
+        ConvertToMatrixForm(Z, nullptr);
+        return;
+    }
+
+    // Without a valid plan, assemble the matrix through the usual path if its sparsity pattern is not available.
+    if (!same_size || !Z->isCompressed()) {
+        plan.Reset();
+        ConvertToMatrixForm(Z, nullptr);
+        return;
+    }
+
+    // Record the assembly plan, while assembling the matrix (one block per variables, stiffness block, and
+    // constraint object).
+    Z->setZeroValues();
+    ChSparseAssemblyRecorder recorder(*Z, plan);
+
+    for (int iv = 0; iv < nv; iv++) {
+        recorder.BeginBlock();
+        active_variables[iv]->Build_M(recorder, active_variables[iv]->GetOffset(), active_variables[iv]->GetOffset(),
+                                      c_a);
+    }
+
+    for (int ik = 0; ik < nk; ik++) {
+        recorder.BeginBlock();
+        vstiffness[ik]->Build_K(recorder, true);
+    }
+
+    for (int ic = 0; ic < nc; ic++) {
+        recorder.BeginBlock();
+        active_constraints[ic]->Build_Cq(recorder, n_q + ic);
+        active_constraints[ic]->Build_CqT(recorder, n_q + ic);
+        recorder.SetElement(n_q + ic, n_q + ic, active_constraints[ic]->Get_cfm_i());
+    }
+
+    recorder.Finalize();
+}
+
 void ChSystemDescriptor::DumpLastMatrices(bool assembled, const char* path) {
     char filename[300];
     try {
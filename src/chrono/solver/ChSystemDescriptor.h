@@ -15,8 +15,10 @@
 #ifndef CHSYSTEMDESCRIPTOR_H
 #define CHSYSTEMDESCRIPTOR_H
 
+#include <algorithm>
 #include <vector>
 
+#include "chrono/core/ChSparseAssemblyPlan.h"
 #include "chrono/parallel/ChOpenMP.h"
 #include "chrono/parallel/ChThreadsSync.h"
 #include "chrono/solver/ChConstraint.h"
@@ -81,6 +83,8 @@ class ChApi ChSystemDescriptor {
 
     double c_a;  // coefficient form M mass matrices in vvariables
 
+    int num_threads;  ///< number of OpenMP threads used when replaying an assembly plan
+
   private:
     int n_q;            ///< number of active variables
     int n_c;            ///< number of active constraints
@@ -150,6 +154,12 @@ class ChApi ChSystemDescriptor {
     /// when performing ShurComplementProduct(), SystemProduct(), ConvertToMatrixForm(),
     virtual double GetMassFactor() { return c_a; }
 
+    /// Set the number of OpenMP threads used when assembling the system matrix with an assembly plan (default: 1).
+    void SetNumThreads(int nthreads) { num_threads = std::max(1, nthreads); }
+
+    /// Get the number of OpenMP threads used when assembling the system matrix with an assembly plan.
+    int GetNumThreads() const { return num_threads; }
+
     // DATA <-> MATH.VECTORS FUNCTIONS
 
     /// Get a vector with all the 'fb' known terms ('forces'etc.) associated to all variables,
@@ -329,6 +339,16 @@ class ChApi ChSystemDescriptor {
                                      ChVectorDynamic<>* rhs  ///< [out] assembled RHS vector
     );
 
+    /// Assemble the system matrix using a compiled assembly plan.
+    /// If the plan is valid for the given matrix, the values provided by the variables, stiffness blocks, and
+    /// constraints are scattered directly in the value array of Z (in parallel, see SetNumThreads). Otherwise, if Z is
+    /// compressed, the plan is recorded while assembling Z. If Z is not compressed, or if the problem structure no
+    /// longer matches the sparsity pattern of Z or the recorded plan, the plan is discarded and Z is assembled as in
+    /// ConvertToMatrixForm(Z, nullptr); in that case, Z may be left uncompressed.
+    virtual void ConvertToMatrixForm(ChSparseMatrix* Z,           ///< [in/out] assembled system matrix
+                                     ChSparseAssemblyPlan& plan  ///< [in/out] assembly plan
+    );
+
     /// Saves to disk the LAST used matrices of the problem.
     /// If assembled == true,
     ///    dump_Z.dat   has the assembled optimization matrix (Matlab sparse format)
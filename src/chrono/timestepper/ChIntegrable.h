@@ -372,6 +372,11 @@ class ChApi ChIntegrableIIorder : public ChIntegrable {
         throw ChException("LoadConstraint_Ct() not implemented, implicit integrators cannot be used. ");
     }
 
+    /// Update the constraint Jacobians Cq used by LoadResidual_CqL at the current state.
+    /// The Jacobians are otherwise updated only when the solver matrix is assembled (see StateSolveCorrection), so
+    /// an integrator that reuses the matrix over several steps must call this before evaluating the residual.
+    virtual void LoadConstraint_Jacobians() {}
+
     //
     // OVERRIDE ChIntegrable BASE MEMBERS TO SUPPORT 1st ORDER INTEGRATORS:
     //
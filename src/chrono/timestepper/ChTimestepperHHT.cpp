@@ -34,7 +34,18 @@ ChTimestepperHHT::ChTimestepperHHT(ChIntegrableIIorder* intgr)
       h_min(1e-10),
       h(1e6),
       num_successful_steps(0),
-      modified_Newton(true) {
+      modified_Newton(true),
+      jacobian_update(JacobianUpdate::EVERY_STEP),
+      max_jacobian_age(20),
+      max_conv_rate(0.5),
+      have_jacobian(false),
+      setup_in_step(false),
+      jacobian_age(0),
+      jacobian_h(0),
+      jacobian_nv(0),
+      jacobian_nc(0),
+      update_nrm(0),
+      conv_rate(0) {
     SetAlpha(-0.2);  // default: some dissipation
 }
 
@@ -103,18 +114,25 @@ void ChTimestepperHHT::Advance(const double dt) {
 
     // Monitor flags controlling whther or not the Newton matrix must be updated.
     // If using modified Newton, a matrix update occurs:
-    //   - at the beginning of a step
+    //   - at the beginning of a step (EVERY_STEP policy) or if the current matrix is stale (AUTOMATIC policy)
     //   - on a stepsize decrease
-    //   - if the Newton iteration does not converge with an out-of-date matrix
+    //   - if the convergence rate degrades (AUTOMATIC policy)
+    //   - if the Newton iteration does not converge with an out-of-date matrix (AUTOMATIC policy)
     // Otherwise, the matrix is updated at each iteration.
     matrix_is_current = false;
-    call_setup = true;
+    call_setup = !modified_Newton || jacobian_update == JacobianUpdate::EVERY_STEP;
 
     // Loop until reaching final time
     while (T < tfinal) {
         double scaling_factor = scaling ? beta * h * h : 1;
         Prepare(mintegrable, scaling_factor);
 
+        if (modified_Newton && jacobian_update == JacobianUpdate::AUTOMATIC && !call_setup)
+            call_setup = JacobianUpdateNeeded(mintegrable);
+        setup_in_step = false;
+        update_nrm = 0;
+        conv_rate = 0;
+
         // Newton-Raphson for state at T+h
         bool converged;
         int it;
@@ -131,6 +149,12 @@ void ChTimestepperHHT::Advance(const double dt) {
             numsolves++;
             if (call_setup) {
                 numsetups++;
+                have_jacobian = true;
+                setup_in_step = true;
+                jacobian_age = 0;
+                jacobian_h = h;
+                jacobian_nv = mintegrable->GetNcoords_v();
+                jacobian_nc = mintegrable->GetNconstr();
             }
 
             // If using modified Newton, do not call Setup again
@@ -140,6 +164,14 @@ void ChTimestepperHHT::Advance(const double dt) {
             converged = CheckConvergence(scaling_factor);
             if (converged)
                 break;
+
+            // If the Newton iteration contracts too slowly with an out-of-date matrix, update the matrix
+            if (modified_Newton && jacobian_update == JacobianUpdate::AUTOMATIC && !setup_in_step &&
+                conv_rate > max_conv_rate) {
+                if (verbose)
+                    GetLog() << " HHT convergence rate " << conv_rate << ". Update matrix.\n";
+                call_setup = true;
+            }
         }
 
         if (converged) {
@@ -169,20 +201,20 @@ void ChTimestepperHHT::Advance(const double dt) {
             A = Anew;
             L = Lnew;
 
-            /*
-            } else if (!matrix_is_current) {
-                // ------ NR did not converge but the matrix was out-of-date
+            jacobian_age++;
 
-                // reset the count of successive successful steps
-                num_successful_steps = 0;
+        } else if (modified_Newton && jacobian_update == JacobianUpdate::AUTOMATIC && !setup_in_step) {
+            // ------ NR did not converge but the matrix was out-of-date
 
-                // re-attempt step with updated matrix
-                if (verbose) {
-                    GetLog() << " HHT re-attempt step with updated matrix.\n";
-                }
+            // reset the count of successive successful steps
+            num_successful_steps = 0;
 
-                call_setup = true;
-            */
+            // re-attempt step with updated matrix
+            if (verbose) {
+                GetLog() << " HHT re-attempt step with updated matrix.\n";
+            }
+
+            call_setup = true;
 
         } else if (!step_control) {
             // ------ NR did not converge and we do not control stepsize
@@ -202,6 +234,8 @@ void ChTimestepperHHT::Advance(const double dt) {
             A = Anew;
             L = Lnew;
 
+            jacobian_age++;
+
         } else {
             // ------ NR did not converge
 
@@ -246,6 +280,10 @@ void ChTimestepperHHT::Advance(const double dt) {
 //   guess (previous step not guaranteed to have converged)
 // - Set the error weight vectors (using solution at current time)
 void ChTimestepperHHT::Prepare(ChIntegrableIIorder* integrable, double scaling_factor) {
+    // With the AUTOMATIC policy, the constraint Jacobians may be several steps old (see Increment)
+    if (modified_Newton && jacobian_update == JacobianUpdate::AUTOMATIC)
+        integrable->LoadConstraint_Jacobians();
+
     switch (mode) {
         case ACCELERATION:
             if (step_control)
@@ -290,6 +328,11 @@ void ChTimestepperHHT::Increment(ChIntegrableIIorder* integrable, double scaling
     // Scatter the current estimate of state at time T+h
     integrable->StateScatter(Xnew, Vnew, T + h);
 
+    // With the AUTOMATIC policy, the Newton matrix (and with it the constraint Jacobians) may be several steps old;
+    // update the Jacobians used in the residual
+    if (modified_Newton && jacobian_update == JacobianUpdate::AUTOMATIC)
+        integrable->LoadConstraint_Jacobians();
+
     // Initialize the two segments of the RHS
     R = Rold;      // terms related to state at time T
     Qc.setZero();  // zero
@@ -378,6 +421,8 @@ bool ChTimestepperHHT::CheckConvergence(double scaling_factor) {
             if ((R_nrm < abstolS && Qc_nrm < abstolL) || (Da_nrm < 1 && Dl_nrm < 1))
                 converged = true;
 
+            UpdateConvergenceRate(std::max(Da_nrm, Dl_nrm));
+
             break;
         }
         case POSITION: {
@@ -398,6 +443,8 @@ bool ChTimestepperHHT::CheckConvergence(double scaling_factor) {
             if (Dx_nrm < 1 && Dl_nrm < 1)
                 converged = true;
 
+            UpdateConvergenceRate(std::max(Dx_nrm, Dl_nrm));
+
             break;
         }
     }
@@ -405,6 +452,20 @@ bool ChTimestepperHHT::CheckConvergence(double scaling_factor) {
     return converged;
 }
 
+// Estimate the convergence rate of the Newton iteration as the ratio of successive update norms.
+void ChTimestepperHHT::UpdateConvergenceRate(double nrm) {
+    conv_rate = (update_nrm > 0) ? nrm / update_nrm : 0;
+    update_nrm = nrm;
+}
+
+// Check whether the Newton matrix must be re-evaluated at the beginning of a step (AUTOMATIC policy).
+// A re-evaluation is required if no matrix is available, if the step size or problem size changed since the
+// last evaluation, or if the matrix was reused over too many steps.
+bool ChTimestepperHHT::JacobianUpdateNeeded(ChIntegrableIIorder* integrable) {
+    return !have_jacobian || h != jacobian_h || jacobian_nv != integrable->GetNcoords_v() ||
+           jacobian_nc != integrable->GetNconstr() || jacobian_age >= max_jacobian_age;
+}
+
 // Calculate the error weight vector corresponding to the specified solution vector x,
 // using the given relative and absolute tolerances.
 void ChTimestepperHHT::CalcErrorWeights(const ChVectorDynamic<>& x, double rtol, double atol, ChVectorDynamic<>& ewt) {
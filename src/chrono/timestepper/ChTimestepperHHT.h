@@ -33,6 +33,12 @@ class ChApi ChTimestepperHHT : public ChTimestepperIIorder, public ChImplicitIte
         POSITION,
     };
 
+    /// Policy for re-evaluating the Newton matrix when using modified Newton.
+    enum class JacobianUpdate {
+        EVERY_STEP,  ///< re-evaluate at the beginning of each step (default)
+        AUTOMATIC    ///< reuse across steps, re-evaluate only when needed
+    };
+
   private:
     double alpha;   ///< HHT method parameter:  -1/3 <= alpha <= 0
     double gamma;   ///< HHT method parameter:   gamma = 1/2 - alpha
@@ -65,6 +71,18 @@ class ChApi ChTimestepperHHT : public ChTimestepperIIorder, public ChImplicitIte
     bool matrix_is_current;  ///< is the Newton matrix up-to-date?
     bool call_setup;         ///< should the solver's Setup function be called?
 
+    JacobianUpdate jacobian_update;  ///< Newton matrix re-evaluation policy (modified Newton only)
+    int max_jacobian_age;            ///< maximum number of steps over which a Newton matrix is reused (AUTOMATIC)
+    double max_conv_rate;            ///< convergence rate triggering a Newton matrix re-evaluation (AUTOMATIC)
+    bool have_jacobian;              ///< was a Newton matrix ever evaluated?
+    bool setup_in_step;              ///< was the Newton matrix evaluated during the current step attempt?
+    int jacobian_age;                ///< number of steps since the last Newton matrix evaluation
+    double jacobian_h;               ///< step size at the last Newton matrix evaluation
+    int jacobian_nv;                 ///< number of coordinates at the last Newton matrix evaluation
+    int jacobian_nc;                 ///< number of constraints at the last Newton matrix evaluation
+    double update_nrm;               ///< norm of the last Newton update
+    double conv_rate;                ///< estimated convergence rate of the Newton iteration
+
     ChVectorDynamic<> ewtS;  ///< vector of error weights (states)
     ChVectorDynamic<> ewtL;  ///< vector of error weights (Lagrange multipliers)
 
@@ -118,6 +136,30 @@ class ChApi ChTimestepperHHT : public ChTimestepperIIorder, public ChImplicitIte
     /// Modified Newton iteration is enabled by default.
     void SetModifiedNewton(bool val) { modified_Newton = val; }
 
+    /// Set the policy for re-evaluating the Newton matrix when using modified Newton.
+    /// With EVERY_STEP (default), the matrix is evaluated at the beginning of each step.
+    /// With AUTOMATIC, the matrix (and its factorization) is reused across steps and re-evaluated only:
+    /// - if the step size or the problem size changed since its last evaluation;
+    /// - if it was reused over more than a given number of steps (see SetMaxJacobianAge);
+    /// - if the convergence rate of the Newton iteration degrades (see SetMaxConvergenceRate);
+    /// - if the Newton iteration does not converge with an out-of-date matrix (the step is then re-attempted
+    ///   with an updated matrix before any stepsize decrease).
+    void SetJacobianUpdateMethod(JacobianUpdate method) { jacobian_update = method; }
+
+    /// Return the current policy for re-evaluating the Newton matrix.
+    JacobianUpdate GetJacobianUpdateMethod() const { return jacobian_update; }
+
+    /// Set the maximum number of steps over which a Newton matrix can be reused (AUTOMATIC policy only).
+    /// Default: 20.
+    void SetMaxJacobianAge(int num_steps) { max_jacobian_age = num_steps; }
+
+    /// Set the convergence rate (ratio of successive Newton update norms) above which the Newton matrix
+    /// is re-evaluated (AUTOMATIC policy only). Default: 0.5.
+    void SetMaxConvergenceRate(double rate) { max_conv_rate = rate; }
+
+    /// Return the convergence rate estimated at the last Newton iteration (0 if not available).
+    double GetConvergenceRate() const { return conv_rate; }
+
     /// Perform an integration timestep.
     virtual void Advance(const double dt  ///< timestep to advance
                          ) override;
@@ -132,6 +174,8 @@ class ChApi ChTimestepperHHT : public ChTimestepperIIorder, public ChImplicitIte
     void Prepare(ChIntegrableIIorder* integrable, double scaling_factor);
     void Increment(ChIntegrableIIorder* integrable, double scaling_factor);
     bool CheckConvergence(double scaling_factor);
+    void UpdateConvergenceRate(double nrm);
+    bool JacobianUpdateNeeded(ChIntegrableIIorder* integrable);
     void CalcErrorWeights(const ChVectorDynamic<>& x, double rtol, double atol, ChVectorDynamic<>& ewt);
 };
 
@@ -0,0 +1,195 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Runner for batches of independent simulations, executed concurrently on a
+// pool of worker threads.
+//
+// =============================================================================
+
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "chrono/core/ChException.h"
+#include "chrono/core/ChLog.h"
+#include "chrono/core/ChMathematics.h"
+#include "chrono/core/ChTimer.h"
+#include "chrono/parallel/ChOpenMP.h"
+#include "chrono/utils/ChBatchSimulator.h"
+
+namespace chrono {
+namespace utils {
+
+// Logger collecting all messages in a string.
+class ChLogString : public ChLog {
+  public:
+    virtual void Output(const char* data, size_t n) override {
+        if (current_level != CHQUIET)
+            m_buffer.append(data, n);
+    }
+
+    std::string m_buffer;
+};
+
+// Queue of scenario indices owned by a worker thread.
+// The owner takes work from the front of its queue; idle workers steal from the back of other queues.
+struct ChWorkQueue {
+    bool Pop(int& index) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_items.empty())
+            return false;
+        index = m_items.front();
+        m_items.pop_front();
+        return true;
+    }
+
+    bool Steal(int& index) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_items.empty())
+            return false;
+        index = m_items.back();
+        m_items.pop_back();
+        return true;
+    }
+
+    std::deque<int> m_items;
+    std::mutex m_mutex;
+};
+
+// -----------------------------------------------------------------------------
+
+ChBatchSimulator::ChBatchSimulator()
+    : m_num_threads(0), m_num_threads_run(1), m_capture_log(true), m_num_threads_used(0), m_wall_time(0) {}
+
+int ChBatchSimulator::AddScenario(std::shared_ptr<Scenario> scenario, double step, double end_time) {
+    RunData run;
+    run.scenario = scenario;
+    run.step = step;
+    run.end_time = end_time;
+    m_runs.push_back(run);
+    return (int)m_runs.size() - 1;
+}
+
+void ChBatchSimulator::Clear() {
+    m_runs.clear();
+}
+
+int ChBatchSimulator::Run() {
+    ChTimer<> timer;
+    timer.start();
+
+    int num_runs = (int)m_runs.size();
+    int num_threads = m_num_threads > 0 ? m_num_threads : (int)std::thread::hardware_concurrency();
+    num_threads = std::max(1, std::min(num_threads, num_runs));
+    m_num_threads_used = num_threads;
+
+    // Distribute the scenarios in a round-robin fashion over the worker queues
+    std::vector<ChWorkQueue> queues(num_threads);
+    for (int i = 0; i < num_runs; i++) {
+        m_runs[i].info = RunInfo();
+        queues[i % num_threads].m_items.push_back(i);
+    }
+
+    // Worker function: process own queue, then steal from the other queues until all are empty.
+    // Since no work is added once started, a worker can exit as soon as it finds all queues empty.
+    auto worker = [this, &queues, num_threads](int thread) {
+        int index;
+        while (true) {
+            bool found = queues[thread].Pop(index);
+            for (int k = 1; !found && k < num_threads; k++)
+                found = queues[(thread + k) % num_threads].Steal(index);
+            if (!found)
+                break;
+            Execute(m_runs[index], thread);
+        }
+    };
+
+    if (num_threads == 1) {
+        worker(0);
+    } else {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < num_threads; t++)
+            threads.push_back(std::thread(worker, t));
+        for (auto& t : threads)
+            t.join();
+    }
+
+    timer.stop();
+    m_wall_time = timer();
+
+    return (int)std::count_if(m_runs.begin(), m_runs.end(), [](const RunData& run) { return run.info.completed; });
+}
+
+void ChBatchSimulator::Execute(RunData& run, int thread) {
+    RunInfo& info = run.info;
+    info.thread = thread;
+
+    ChTimer<> timer;
+    timer.start();
+
+    // Per-run settings for the calling thread
+    ChLogString log;
+    if (m_capture_log)
+        SetThreadLog(&log);
+    int num_threads_omp = CHOMPfunctions::GetMaxThreads();
+    CHOMPfunctions::SetNumThreads(m_num_threads_run);
+    ChSetThreadRandomSeed(123);
+
+    try {
+        run.scenario->Initialize();
+        ChSystem* system = run.scenario->GetSystem();
+        if (!system)
+            throw ChException("Scenario did not create a system");
+        while (system->GetChTime() < run.end_time - 1e-10 * run.step) {
+            run.scenario->Advance(run.step);
+            info.num_steps++;
+            if (run.scenario->Stop())
+                break;
+        }
+        info.sim_time = system->GetChTime();
+        info.completed = true;
+    } catch (const std::exception& e) {
+        info.error = e.what();
+    } catch (...) {
+        info.error = "unknown exception";
+    }
+
+    try {
+        run.scenario->Finalize();
+    } catch (const std::exception& e) {
+        if (info.completed)
+            info.error = e.what();
+        info.completed = false;
+    } catch (...) {
+        if (info.completed)
+            info.error = "unknown exception";
+        info.completed = false;
+    }
+
+    // Restore the settings of the calling thread
+    CHOMPfunctions::SetNumThreads(num_threads_omp);
+    ChClearThreadRandomSeed();
+    if (m_capture_log) {
+        SetThreadLog(nullptr);
+        info.log = log.m_buffer;
+    }
+
+    timer.stop();
+    info.wall_time = timer();
+}
+
+}  // end namespace utils
+}  // end namespace chrono
@@ -0,0 +1,158 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Runner for batches of independent simulations, executed concurrently on a
+// pool of worker threads.
+//
+// =============================================================================
+
+#ifndef CH_BATCH_SIMULATOR_H
+#define CH_BATCH_SIMULATOR_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "chrono/core/ChApiCE.h"
+#include "chrono/physics/ChSystem.h"
+
+namespace chrono {
+namespace utils {
+
+/// @addtogroup chrono_utils
+/// @{
+
+/// Runner for batches of independent simulations (e.g., parameter sweeps).
+/// Each simulation is described by a Scenario object, which owns its ChSystem (and any other model data). All
+/// scenarios of a batch are executed concurrently on a pool of worker threads, with work stealing to balance runs of
+/// different durations. A given scenario is entirely executed (constructed, advanced, finalized) by a single worker
+/// thread, with:
+/// - its own number of OpenMP threads for the parallel loops within the system (1 by default, see
+///   SetNumThreadsPerRun);
+/// - its own logger, so that messages written to GetLog() during a run are captured separately (see RunInfo::log);
+///   if log capture is disabled, all runs write to the global logger;
+/// - its own sequence of ChRandom() values, restarted from the default seed for each scenario (see
+///   ChSetThreadRandomSeed), so that the results do not depend on the assignment of scenarios to threads.
+/// These settings apply to the worker thread only; the global logger and ChRandom() seed are not affected.
+///
+/// Process-wide settings (data paths, default collision envelope and margin, Bullet contact breaking threshold, etc.)
+/// must be set before calling Run() and must not be changed by the scenarios. The built-in profiler (CH_PROFILE)
+/// records into per-thread trees and can be used during a batch.
+class ChApi ChBatchSimulator {
+  public:
+    /// Interface for a simulation in a batch.
+    class ChApi Scenario {
+      public:
+        virtual ~Scenario() {}
+
+        /// Construct the model for this simulation.
+        /// Called from the worker thread executing the simulation, so that all model data is allocated by that thread.
+        virtual void Initialize() = 0;
+
+        /// Return the system simulated in this scenario.
+        /// A run whose scenario does not provide a system after initialization is reported as failed.
+        virtual ChSystem* GetSystem() = 0;
+
+        /// Advance the simulation by one step.
+        /// The default implementation calls DoStepDynamics on the scenario system. A derived class can override this
+        /// function to also advance other components (e.g. driver, terrain, vehicle subsystems).
+        virtual void Advance(double step) { GetSystem()->DoStepDynamics(step); }
+
+        /// Return true to terminate the simulation before reaching the end time (e.g., on a failure criterion).
+        virtual bool Stop() { return false; }
+
+        /// Called at the end of the simulation (also when it failed), from the worker thread that executed it.
+        /// A derived class can override this function to collect outputs and release the model data.
+        virtual void Finalize() {}
+    };
+
+    /// Information on the execution of a scenario.
+    struct RunInfo {
+        RunInfo() : completed(false), num_steps(0), sim_time(0), wall_time(0), thread(-1) {}
+
+        bool completed;     ///< simulation finished (end time reached or stopped) without exceptions
+        std::string error;  ///< exception message, if the simulation failed
+        int num_steps;      ///< number of steps taken
+        double sim_time;    ///< simulation time reached
+        double wall_time;   ///< wall clock time (in seconds) for the simulation, including initialization
+        int thread;         ///< index of the worker thread that executed the simulation
+        std::string log;    ///< messages written to GetLog() during the simulation (if log capture is enabled)
+    };
+
+    ChBatchSimulator();
+    ~ChBatchSimulator() {}
+
+    /// Set the number of worker threads (default: 0, to use the number of hardware threads).
+    void SetNumThreads(int num_threads) { m_num_threads = num_threads; }
+
+    /// Set the number of OpenMP threads used within each simulation (default: 1).
+    void SetNumThreadsPerRun(int num_threads) { m_num_threads_run = num_threads; }
+
+    /// Enable/disable capture of the log messages of each simulation (default: true).
+    /// If disabled, messages go to the global logger and may be interleaved.
+    void SetCaptureLog(bool val) { m_capture_log = val; }
+
+    /// Add a scenario to the batch, to be simulated with the given step size up to the given end time.
+    /// Return the index of the scenario in the batch.
+    int AddScenario(std::shared_ptr<Scenario> scenario, double step, double end_time);
+
+    /// Simulate all scenarios in the batch and return when all simulations are done.
+    /// Exceptions thrown by a scenario are caught and reported in the corresponding RunInfo.
+    /// Return the number of simulations that completed successfully.
+    int Run();
+
+    /// Remove all scenarios from the batch.
+    void Clear();
+
+    /// Get the number of scenarios in the batch.
+    int GetNumScenarios() const { return (int)m_runs.size(); }
+
+    /// Get the scenario with given index.
+    std::shared_ptr<Scenario> GetScenario(int i) const { return m_runs[i].scenario; }
+
+    /// Get execution information for the scenario with given index (available after Run).
+    const RunInfo& GetRunInfo(int i) const { return m_runs[i].info; }
+
+    /// Get the number of worker threads used in the last call to Run.
+    int GetNumThreadsUsed() const { return m_num_threads_used; }
+
+    /// Get the wall clock time (in seconds) of the last call to Run.
+    double GetTotalWallTime() const { return m_wall_time; }
+
+  private:
+    struct RunData {
+        std::shared_ptr<Scenario> scenario;
+        double step;
+        double end_time;
+        RunInfo info;
+    };
+
+    void Execute(RunData& run, int thread);
+
+    int m_num_threads;
+    int m_num_threads_run;
+    bool m_capture_log;
+
+    std::vector<RunData> m_runs;
+
+    int m_num_threads_used;
+    double m_wall_time;
+};
+
+/// @} chrono_utils
+
+}  // end namespace utils
+}  // end namespace chrono
+
+#endif
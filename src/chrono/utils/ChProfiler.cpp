@@ -30,36 +30,110 @@ CODE MODIFIED FROM:
 // Credits: The Clock class was inspired by the Timer classes in 
 // Ogre (www.ogre3d.org).
 
-#include "chrono/core/ChTimer.h"
 #include "chrono/utils/ChProfiler.h"
 
+#include <algorithm>
+#include <cstring>
 #include <ctime>
+#include <fstream>
 #include <ratio>
 #include <chrono>
 #include <cstdio>
+#include <string>
+#include <vector>
 
 namespace chrono {
 namespace utils {
 
 #ifndef CH_NO_PROFILE
 
-static ChTimer<double> gProfileClock;
+static const std::chrono::steady_clock::time_point gProfileEpoch = std::chrono::steady_clock::now();
 
-#define mymin(a,b) (a > b ? a : b)
+inline long long Profile_Get_Ticks()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - gProfileEpoch).count();
+}
+
+
+/***************************************************************************************************
+**
+** Per-thread profile data
+**
+***************************************************************************************************/
+
+// A scope recorded as a trace event
+struct ChProfileEvent {
+	const char *	Name;
+	long long		Start;
+	long long		Duration;
+};
+
+// The profile data of a thread: profile tree and trace events.
+// Records are allocated when a thread is first profiled and pushed (lock-free) in a global singly-linked list.
+// When the thread terminates, its record is marked as finished, so that its data remains available until the next
+// call to ChProfileManager::CleanupMemory, which releases it.
+struct ChProfileThread {
+	ChProfileThread( int id ) : Root( "Root", NULL ), CurrentNode( &Root ), Id( id ), Finished( false ), Next( NULL ) {}
+
+	ChProfileNode					Root;
+	ChProfileNode *					CurrentNode;
+	int								Id;
+	std::vector<ChProfileEvent>		Events;
+	std::atomic<bool>				Finished;
+	ChProfileThread *				Next;
+};
+
+// Handle to the profile data of the calling thread; marks the record as finished when the thread terminates.
+struct ChProfileThreadHandle {
+	~ChProfileThreadHandle() {
+		if ( Thread )
+			Thread->Finished = true;
+	}
+
+	ChProfileThread *	Thread = NULL;
+};
+
+static std::atomic<ChProfileThread*>	gProfileThreads( NULL );
+static std::atomic<int>					gProfileThreadCount( 0 );
+static std::atomic<bool>				gProfileTraceEvents( false );
+static thread_local ChProfileThreadHandle	tProfileThread;
 
-inline void Profile_Get_Ticks(unsigned long int * ticks)
+static ChProfileThread & Profile_Get_Thread()
 {
-	*ticks = (unsigned long)gProfileClock.GetTimeMicrosecondsIntermediate();
+	if ( !tProfileThread.Thread ) {
+		ChProfileThread * thread = new ChProfileThread( gProfileThreadCount++ );
+		ChProfileThread * head = gProfileThreads.load();
+		do {
+			thread->Next = head;
+		} while ( !gProfileThreads.compare_exchange_weak( head, thread ) );
+		tProfileThread.Thread = thread;
+	}
+	return *tProfileThread.Thread;
 }
 
-inline float Profile_Get_Tick_Rate(void)
+// Remove a thread record from the list. Other threads may concurrently push new records at the head of the list.
+static void Profile_Unlink_Thread( ChProfileThread * thread )
 {
-//	return 1000000.f;
-	return 1000.f;
+	ChProfileThread * head = thread;
+	if ( gProfileThreads.compare_exchange_strong( head, thread->Next ) )
+		return;
 
+	// The record is not at the head of the list; find its predecessor
+	ChProfileThread * prev = head;
+	while ( prev->Next != thread )
+		prev = prev->Next;
+	prev->Next = thread->Next;
 }
 
-
+// Collect all thread records, sorted by thread id.
+static std::vector<ChProfileThread*> Profile_Get_Threads()
+{
+	std::vector<ChProfileThread*> threads;
+	for ( ChProfileThread * thread = gProfileThreads.load(); thread; thread = thread->Next )
+		threads.push_back( thread );
+	std::sort( threads.begin(), threads.end(), [](ChProfileThread* a, ChProfileThread* b) { return a->Id < b->Id; } );
+	return threads;
+}
 
 
 /***************************************************************************************************
@@ -93,16 +167,14 @@ ChProfileNode::ChProfileNode( const char * name, ChProfileNode * parent ) :
 
 void	ChProfileNode::CleanupMemory()
 {
-	delete ( Child);
-	Child = NULL;
-	delete ( Sibling);
-	Sibling = NULL;
+	delete ( Child.exchange( NULL ) );
+	delete ( Sibling.exchange( NULL ) );
 }
 
 ChProfileNode::~ChProfileNode( void )
 {
-	delete ( Child);
-	delete ( Sibling);
+	delete ( Child.load() );
+	delete ( Sibling.load() );
 }
 
 
@@ -113,23 +185,25 @@ ChProfileNode::~ChProfileNode( void )
  * WARNINGS:                                                                                   *
  * All profile names are assumed to be static strings so this function uses pointer compares   *
  * to find the named node.                                                                     *
+ * Only the thread owning the tree may add nodes; a new node is fully initialized before it    *
+ * is published, so that other threads can traverse the tree concurrently.                     *
  *=============================================================================================*/
 ChProfileNode * ChProfileNode::Get_Sub_Node( const char * name )
 {
 	// Try to find this sub node
-	ChProfileNode * child = Child;
+	ChProfileNode * child = Get_Child();
 	while ( child ) {
 		if ( child->Name == name ) {
 			return child;
 		}
-		child = child->Sibling;
+		child = child->Get_Sibling();
 	}
 
 	// We didn't find it, so add it
 	
 	ChProfileNode * node = new ChProfileNode( name, this );
-	node->Sibling = Child;
-	Child = node;
+	node->Sibling.store( Get_Child(), std::memory_order_relaxed );
+	Child.store( node, std::memory_order_release );
 	return node;
 }
 
@@ -137,48 +211,60 @@ ChProfileNode * ChProfileNode::Get_Sub_Node( const char * name )
 void	ChProfileNode::Reset( void )
 {
 	TotalCalls = 0;
-	TotalTime = 0.0f;
+	TotalTime = 0;
 	
 
-	if ( Child ) {
-		Child->Reset();
+	if ( Get_Child() ) {
+		Get_Child()->Reset();
 	}
-	if ( Sibling ) {
-		Sibling->Reset();
+	if ( Get_Sibling() ) {
+		Get_Sibling()->Reset();
 	}
 }
 
 
 void	ChProfileNode::Call( void )
 {
-	TotalCalls++;
+	TotalCalls.store( TotalCalls.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
 	if (RecursionCounter++ == 0) {
-		Profile_Get_Ticks(&StartTime);
+		StartTime = Profile_Get_Ticks();
 	}
 }
 
 
 bool	ChProfileNode::Return( void )
 {
-	if ( --RecursionCounter == 0 && TotalCalls != 0 ) { 
-		unsigned long int time;
-		Profile_Get_Ticks(&time);
-		time-=StartTime;
-		TotalTime += (float)time / Profile_Get_Tick_Rate();
+	if ( --RecursionCounter == 0 && Get_Total_Calls() != 0 ) { 
+		long long time = Profile_Get_Ticks() - StartTime;
+		TotalTime.store( TotalTime.load( std::memory_order_relaxed ) + time, std::memory_order_relaxed );
 	}
 	return ( RecursionCounter == 0 );
 }
 
 
+void	ChProfileNode::Accumulate( int calls, long long time_ns )
+{
+	TotalCalls.store( TotalCalls.load( std::memory_order_relaxed ) + calls, std::memory_order_relaxed );
+	TotalTime.store( TotalTime.load( std::memory_order_relaxed ) + time_ns, std::memory_order_relaxed );
+}
+
+
 /***************************************************************************************************
 **
 ** ChProfileIterator
 **
 ***************************************************************************************************/
-ChProfileIterator::ChProfileIterator( ChProfileNode * start )
+ChProfileIterator::ChProfileIterator( ChProfileNode * start, bool owned )
 {
 	CurrentParent = start;
 	CurrentChild = CurrentParent->Get_Child();
+	OwnedRoot = owned ? start : NULL;
+}
+
+
+ChProfileIterator::~ChProfileIterator( void )
+{
+	delete OwnedRoot;
 }
 
 
@@ -230,17 +316,16 @@ void	ChProfileIterator::Enter_Parent( void )
 **
 ***************************************************************************************************/
 
-ChProfileNode	ChProfileManager::Root( "Root", NULL );
-ChProfileNode *	ChProfileManager::CurrentNode = &ChProfileManager::Root;
-int				ChProfileManager::FrameCounter = 0;
-unsigned long int			ChProfileManager::ResetTime = 0;
+std::atomic<int>		ChProfileManager::FrameCounter( 0 );
+std::atomic<long long>	ChProfileManager::ResetTime( 0 );
 
 
 /***********************************************************************************************
  * ChProfileManager::Start_Profile -- Begin a named profile                                    *
  *                                                                                             *
- * Steps one level deeper into the tree, if a child already exists with the specified name     *
- * then it accumulates the profiling; otherwise a new child node is added to the profile tree. *
+ * Steps one level deeper into the tree of the calling thread, if a child already exists with  *
+ * the specified name then it accumulates the profiling; otherwise a new child node is added   *
+ * to the profile tree.                                                                        *
  *                                                                                             *
  * INPUT:                                                                                      *
  * name - name of this profiling record                                                        *
@@ -251,11 +336,13 @@ unsigned long int			ChProfileManager::ResetTime = 0;
  *=============================================================================================*/
 void	ChProfileManager::Start_Profile( const char * name )
 {
-	if (name != CurrentNode->Get_Name()) {
-		CurrentNode = CurrentNode->Get_Sub_Node( name );
+	ChProfileThread & thread = Profile_Get_Thread();
+
+	if (name != thread.CurrentNode->Get_Name()) {
+		thread.CurrentNode = thread.CurrentNode->Get_Sub_Node( name );
 	} 
 	
-	CurrentNode->Call();
+	thread.CurrentNode->Call();
 }
 
 
@@ -264,10 +351,33 @@ void	ChProfileManager::Start_Profile( const char * name )
  *=============================================================================================*/
 void	ChProfileManager::Stop_Profile( void )
 {
+	ChProfileThread & thread = Profile_Get_Thread();
+	ChProfileNode * node = thread.CurrentNode;
+
 	// Return will indicate whether we should back up to our parent (we may
 	// be profiling a recursive function)
-	if (CurrentNode->Return()) {
-		CurrentNode = CurrentNode->Get_Parent();
+	if (node->Return()) {
+		if ( gProfileTraceEvents.load( std::memory_order_relaxed ) ) {
+			ChProfileEvent event = { node->Get_Name(), node->Get_Start_Time(), Profile_Get_Ticks() - node->Get_Start_Time() };
+			thread.Events.push_back( event );
+		}
+		thread.CurrentNode = node->Get_Parent();
+	}
+}
+
+
+void	ChProfileManager::CleanupMemory( void )
+{
+	for ( auto thread : Profile_Get_Threads() ) {
+		if ( thread->Finished ) {
+			Profile_Unlink_Thread( thread );
+			delete thread;
+			continue;
+		}
+		thread->Root.CleanupMemory();
+		thread->CurrentNode = &thread->Root;
+		thread->Events.clear();
+		thread->Events.shrink_to_fit();
 	}
 }
 
@@ -275,16 +385,18 @@ void	ChProfileManager::Stop_Profile( void )
 /***********************************************************************************************
  * ChProfileManager::Reset -- Reset the contents of the profiling system                       *
  *                                                                                             *
- *    This resets everything except for the tree structure.  All of the timing data is reset.  *
+ *    This resets everything except for the tree structure.  All of the timing data and the    *
+ *    trace events of all threads are reset.                                                   *
  *=============================================================================================*/
 void	ChProfileManager::Reset( void )
 { 
-	gProfileClock.reset();
-    gProfileClock.start();
-	Root.Reset();
-    Root.Call();
+	for ( auto thread : Profile_Get_Threads() ) {
+		thread->Root.Reset();
+		thread->Events.clear();
+	}
+	Profile_Get_Thread().Root.Call();
 	FrameCounter = 0;
-	Profile_Get_Ticks(&ResetTime);
+	ResetTime = Profile_Get_Ticks();
 }
 
 
@@ -298,14 +410,68 @@ void ChProfileManager::Increment_Frame_Counter( void )
 
 
 /***********************************************************************************************
- * ChProfileManager::Get_Time_Since_Reset -- returns the elapsed time since last reset         *
+ * ChProfileManager::Get_Time_Since_Reset -- returns the elapsed time (ms) since last reset    *
  *=============================================================================================*/
 float ChProfileManager::Get_Time_Since_Reset( void )
 {
-	unsigned long int time;
-	Profile_Get_Ticks(&time);
-	time -= ResetTime;
-	return (float)time / Profile_Get_Tick_Rate();
+	return (float)((Profile_Get_Ticks() - ResetTime) * 1e-6);
+}
+
+
+ChProfileIterator * ChProfileManager::Get_Iterator( void )
+{
+	return new ChProfileIterator( &Profile_Get_Thread().Root );
+}
+
+
+int ChProfileManager::Get_Thread_Count( void )
+{
+	return (int)Profile_Get_Threads().size();
+}
+
+
+ChProfileIterator * ChProfileManager::Get_Thread_Iterator( int thread )
+{
+	auto threads = Profile_Get_Threads();
+	if ( thread < 0 || thread >= (int)threads.size() )
+		return NULL;
+	return new ChProfileIterator( &threads[thread]->Root );
+}
+
+
+// Sum the sub-tree of 'src' in the sub-tree of 'dst', matching nodes by name.
+static void Profile_Merge( ChProfileNode * dst, ChProfileNode * src )
+{
+	for ( ChProfileNode * child = src->Get_Child(); child; child = child->Get_Sibling() ) {
+		ChProfileNode * node = dst->Get_Child();
+		while ( node && std::strcmp( node->Get_Name(), child->Get_Name() ) != 0 )
+			node = node->Get_Sibling();
+		if ( !node )
+			node = dst->Get_Sub_Node( child->Get_Name() );
+		node->Accumulate( child->Get_Total_Calls(), child->Get_Total_Time_ns() );
+		Profile_Merge( node, child );
+	}
+}
+
+
+ChProfileIterator * ChProfileManager::Get_Merged_Iterator( void )
+{
+	ChProfileNode * root = new ChProfileNode( "Root", NULL );
+	for ( auto thread : Profile_Get_Threads() )
+		Profile_Merge( root, &thread->Root );
+	return new ChProfileIterator( root, true );
+}
+
+
+void ChProfileManager::Set_Trace_Events( bool enable )
+{
+	gProfileTraceEvents = enable;
+}
+
+
+bool ChProfileManager::Get_Trace_Events( void )
+{
+	return gProfileTraceEvents;
 }
 
 
@@ -360,12 +526,81 @@ void	ChProfileManager::dumpRecursive(ChProfileIterator* profileIterator, int spa
 
 void	ChProfileManager::dumpAll()
 {
-	ChProfileIterator* profileIterator = 0;
-	profileIterator = ChProfileManager::Get_Iterator();
+	for ( auto thread : Profile_Get_Threads() ) {
+		printf("==== Thread %d ====\n", thread->Id);
+
+		ChProfileIterator* profileIterator = new ChProfileIterator( &thread->Root );
+
+		dumpRecursive(profileIterator,0);
+
+		ChProfileManager::Release_Iterator(profileIterator);
+	}
+}
+
+
+// Escape a profile name for output in a JSON string.
+static std::string Profile_Json_Escape( const char * name )
+{
+	std::string out;
+	for ( const char * c = name; *c; c++ ) {
+		if ( *c == '"' || *c == '\\' )
+			out += '\\';
+		out += *c;
+	}
+	return out;
+}
+
+
+bool	ChProfileManager::dumpChromeTrace(const char* filename)
+{
+	std::ofstream file( filename );
+	if ( !file.good() )
+		return false;
+
+	// Trace-event timestamps and durations are in microseconds.
+	file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	bool first = true;
+	for ( auto thread : Profile_Get_Threads() ) {
+		file << (first ? "\n" : ",\n");
+		first = false;
+		file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread->Id
+			 << ",\"args\":{\"name\":\"Thread " << thread->Id << "\"}}";
+		for ( const auto & event : thread->Events ) {
+			file << ",\n{\"name\":\"" << Profile_Json_Escape( event.Name ) << "\",\"cat\":\"chrono\",\"ph\":\"X\",\"pid\":0,\"tid\":"
+				 << thread->Id << ",\"ts\":" << event.Start * 1e-3 << ",\"dur\":" << event.Duration * 1e-3 << "}";
+		}
+	}
+	file << "\n]}\n";
+
+	return file.good();
+}
+
+
+// Write one CSV row per node in the sub-tree of 'parent'.
+static void Profile_Dump_CSV( std::ofstream & file, int thread, const std::string & path, ChProfileNode * parent )
+{
+	for ( ChProfileNode * node = parent->Get_Child(); node; node = node->Get_Sibling() ) {
+		std::string node_path = path.empty() ? std::string( node->Get_Name() ) : path + "/" + node->Get_Name();
+		int calls = node->Get_Total_Calls();
+		double time_ms = node->Get_Total_Time_ns() * 1e-6;
+		file << thread << ",\"" << node_path << "\"," << calls << "," << time_ms << ","
+			 << (calls > 0 ? 1e3 * time_ms / calls : 0.0) << "\n";
+		Profile_Dump_CSV( file, thread, node_path, node );
+	}
+}
+
+
+bool	ChProfileManager::dumpCSV(const char* filename)
+{
+	std::ofstream file( filename );
+	if ( !file.good() )
+		return false;
 
-	dumpRecursive(profileIterator,0);
+	file << "thread,path,calls,total_time_ms,time_per_call_us\n";
+	for ( auto thread : Profile_Get_Threads() )
+		Profile_Dump_CSV( file, thread->Id, "", &thread->Root );
 
-	ChProfileManager::Release_Iterator(profileIterator);
+	return file.good();
 }
 
 
@@ -38,10 +38,10 @@ CODE MODIFIED FROM:
 
 #ifndef CH_NO_PROFILE
 
+#include <atomic>
 #include <cstdio>
 #include <new>
 #include <cfloat>
-#include <cfloat>
 #include <ctime>
 #include <ratio>
 #include <chrono>
@@ -52,7 +52,10 @@ namespace utils {
 
 
 
-///A node in the Profile Hierarchy Tree
+///A node in the Profile Hierarchy Tree.
+///Each thread records into its own tree, so nodes are only modified by their owning thread; the call counters,
+///timings and links are atomic so that other threads can safely read (and merge) a tree while it is being recorded.
+///Times are measured in nanoseconds.
 class  ChApi ChProfileNode {
 
 public:
@@ -62,35 +65,45 @@ public:
 	ChProfileNode * Get_Sub_Node( const char * name );
 
 	ChProfileNode * Get_Parent( void )		{ return Parent; }
-	ChProfileNode * Get_Sibling( void )		{ return Sibling; }
-	ChProfileNode * Get_Child( void )			{ return Child; }
+	ChProfileNode * Get_Sibling( void )		{ return Sibling.load(std::memory_order_acquire); }
+	ChProfileNode * Get_Child( void )			{ return Child.load(std::memory_order_acquire); }
 
 	void				CleanupMemory();
 	void				Reset( void );
 	void				Call( void );
 	bool				Return( void );
 
+	/// Add the given number of calls and time (in ns) to this node (used when merging trees).
+	void				Accumulate( int calls, long long time_ns );
+
 	const char *	Get_Name( void )				{ return Name; }
-	int				Get_Total_Calls( void )		{ return TotalCalls; }
-	float				Get_Total_Time( void )		{ return TotalTime; }
+	int				Get_Total_Calls( void )		{ return TotalCalls.load(std::memory_order_relaxed); }
+	/// Total time spent in this node, in ms.
+	float				Get_Total_Time( void )		{ return (float)(Get_Total_Time_ns() * 1e-6); }
+	/// Total time spent in this node, in ns.
+	long long			Get_Total_Time_ns( void )	{ return TotalTime.load(std::memory_order_relaxed); }
+	/// Time stamp (in ns) of the last entry in this node.
+	long long			Get_Start_Time( void )		{ return StartTime; }
 
 protected:
 
 	const char *	Name;
-	int				TotalCalls;
-	float				TotalTime;
-	unsigned long int			StartTime;
+	std::atomic<int>			TotalCalls;
+	std::atomic<long long>		TotalTime;
+	long long			StartTime;
 	int				RecursionCounter;
 
 	ChProfileNode *	Parent;
-	ChProfileNode *	Child;
-	ChProfileNode *	Sibling;
+	std::atomic<ChProfileNode *>	Child;
+	std::atomic<ChProfileNode *>	Sibling;
 };
 
 ///An iterator to navigate through the tree
 class  ChApi  ChProfileIterator
 {
 public:
+	~ChProfileIterator( void );
+
 	// Access all the children of the current parent
 	void				First(void);
 	void				Next(void);
@@ -115,44 +128,70 @@ protected:
 
 	ChProfileNode *	CurrentParent;
 	ChProfileNode *	CurrentChild;
+	ChProfileNode *	OwnedRoot;		// tree owned (and deleted) by this iterator, if any
 
-	ChProfileIterator( ChProfileNode * start );
+	ChProfileIterator( ChProfileNode * start, bool owned = false );
 	friend	class		ChProfileManager;
 };
 
 
-///The Manager for the Profile system
+///The Manager for the Profile system.
+///Every thread that enters a profiled scope gets its own profile tree (registered in a lock-free list the first time
+///the thread is profiled), so CH_PROFILE can be used from OpenMP loops and from several ChSystem objects stepped in
+///different threads. The per-thread trees can be inspected separately (to detect load imbalance) or merged.
+///The profile data of a thread remains available after the thread terminates, until the next call to CleanupMemory.
+///Optionally, each profiled scope can also be recorded as a trace event, for export in the Chrome trace-event format
+///(chrome://tracing or https://ui.perfetto.dev).
+///Functions that traverse or modify the trees of all threads (Reset, CleanupMemory, the merge and dump functions)
+///are meant to be called while the other threads are not profiling, e.g. between simulation steps.
 class  ChApi ChProfileManager {
 public:
 	static	void						Start_Profile( const char * name );
 	static	void						Stop_Profile( void );
 
-	static	void						CleanupMemory(void)
-	{
-		Root.CleanupMemory();
-	}
+	/// Delete the profile trees and trace events of all threads, and release the data of terminated threads.
+	static	void						CleanupMemory(void);
 
 	static	void						Reset( void );
 	static	void						Increment_Frame_Counter( void );
 	static	int						Get_Frame_Count_Since_Reset( void )		{ return FrameCounter; }
 	static	float						Get_Time_Since_Reset( void );
 
-	static	ChProfileIterator *	Get_Iterator( void )	
-	{ 
-		
-		return new ChProfileIterator( &Root ); 
-	}
+	/// Get an iterator on the profile tree of the calling thread.
+	static	ChProfileIterator *	Get_Iterator( void );
+	/// Get the number of threads with profile data.
+	static	int						Get_Thread_Count( void );
+	/// Get an iterator on the profile tree of the given thread (0 <= thread < Get_Thread_Count(), in order of
+	/// registration). Returns nullptr if no such thread.
+	static	ChProfileIterator *	Get_Thread_Iterator( int thread );
+	/// Merge the profile trees of all threads (summing calls and times of nodes with the same path) and return an
+	/// iterator on the merged tree. Each call creates a new merged tree, owned by the returned iterator and deleted
+	/// with it (see Release_Iterator). Merging can be done while other threads are profiling.
+	static	ChProfileIterator *	Get_Merged_Iterator( void );
 	static	void						Release_Iterator( ChProfileIterator * iterator ) { delete ( iterator); }
 
+	/// Enable/disable the recording of trace events (default: false).
+	/// When enabled, every profiled scope is also stored, with its start time and duration, in a per-thread buffer.
+	static	void						Set_Trace_Events( bool enable );
+	static	bool						Get_Trace_Events( void );
+
 	static void	dumpRecursive(ChProfileIterator* profileIterator, int spacing);
 
+	/// Print the profile trees of all threads.
 	static void	dumpAll();
 
+	/// Write the recorded trace events of all threads to the specified file, in Chrome trace-event JSON format.
+	/// Return false if the file could not be written.
+	static bool	dumpChromeTrace(const char* filename);
+
+	/// Write the profile trees of all threads to the specified file, as a flat CSV table with one row per node:
+	/// thread, node path, number of calls, total time (ms), time per call (us).
+	/// Return false if the file could not be written.
+	static bool	dumpCSV(const char* filename);
+
 private:
-	static	ChProfileNode			Root;
-	static	ChProfileNode *			CurrentNode;
-	static	int						FrameCounter;
-	static	unsigned long int					ResetTime;
+	static	std::atomic<int>						FrameCounter;
+	static	std::atomic<long long>				ResetTime;
 };
 
 
@@ -44,7 +44,8 @@ typedef enum MESSAGE_TYPE {
     UPDATE,                /// Update for an existing body on a rank from the owning rank
     FINAL_UPDATE_GIVE,     /// Update which ends in the other rank taking exclusive ownership
     FINAL_UPDATE_TAKE,     /// Update which ends in this rank taking exclusive ownership
-    UPDATE_TRANSFER_SHARE  /// Update which updates the primary rank for the body
+    UPDATE_TRANSFER_SHARE,  /// Update which updates the primary rank for the body
+    UPDATE_OWNER_CHANGE     /// Update of a ghost whose body is handed over to another rank
 } MESSAGE_TYPE;
 /// @} distributed_module
 
@@ -14,8 +14,10 @@
 
 #include <mpi.h>
 #include <omp.h>
+#include <algorithm>
 #include <climits>
-#include <forward_list>
+#include <cmath>
+#include <cstring>
 #include <memory>
 #include <string>
 
@@ -23,6 +25,7 @@
 #include "chrono_distributed/collision/ChCollisionModelDistributed.h"
 #include "chrono_distributed/collision/ChCollisionSystemDistributed.h"
 #include "chrono_distributed/comm/ChCommDistributed.h"
+#include "chrono_distributed/physics/ChDomainDistributed.h"
 #include "chrono_distributed/physics/ChSystemDistributed.h"
 
 #include "chrono_parallel/ChDataManager.h"
@@ -36,12 +39,18 @@
 using namespace chrono;
 using namespace collision;
 
-ChCommDistributed::ChCommDistributed(ChSystemDistributed* my_sys) {
+ChCommDistributed::ChCommDistributed(ChSystemDistributed* my_sys)
+    : neighbors(ChDomainDistributed::NUM_SLOTS), pending(false), update_tol(0), num_skipped_updates(0) {
     this->my_sys = my_sys;
     this->data_manager = my_sys->data_manager;
 
     ddm = my_sys->ddm;
 
+    timer_pack.reset();
+    timer_post.reset();
+    timer_wait.reset();
+    timer_unpack.reset();
+
     /* Create and Commit all custom MPI Data Types */
     // Exchange
     MPI_Datatype type_exchange[4] = {MPI_UNSIGNED, MPI_BYTE, MPI_DOUBLE, MPI_INT};
@@ -58,16 +67,6 @@ ChCommDistributed::ChCommDistributed(ChSystemDistributed* my_sys) {
     MPI_Type_create_resized(temp_type, lb, extent, &BodyExchangeType);
     MPI_Type_commit(&BodyExchangeType);
 
-    // Update
-    MPI_Datatype type_update[3] = {MPI_UNSIGNED, MPI_INT, MPI_DOUBLE};
-    int blocklen_update[3] = {1, 1, 13};
-    MPI_Aint disp_update[3];
-    disp_update[0] = offsetof(BodyUpdate, gid);
-    disp_update[1] = offsetof(BodyUpdate, update_type);
-    disp_update[2] = offsetof(BodyUpdate, pos);
-    MPI_Type_create_struct(3, blocklen_update, disp_update, type_update, &BodyUpdateType);
-    MPI_Type_commit(&BodyUpdateType);
-
     // Shape
     MPI_Datatype type_shape[5] = {MPI_UNSIGNED, MPI_INT, MPI_SHORT, MPI_DOUBLE, MPI_FLOAT};
     int blocklen_shape[5] = {1, 1, 2, 13, 6};
@@ -87,8 +86,32 @@ ChCommDistributed::ChCommDistributed(ChSystemDistributed* my_sys) {
 
 ChCommDistributed::~ChCommDistributed() {}
 
-void ChCommDistributed::ProcessExchanges(int num_recv, BodyExchange* buf, int updown) {
-    if (buf->gid == UINT_MAX) {
+// Reference state of a body without communicated state (all fields are sent in its next update)
+static const BodyUpdate no_state = {UINT_MAX};
+
+// Ghosts of a body added with ChSystemDistributed::AddBody, not yet known: the body has a ghost on every rank whose
+// extended sub-domain contained it when it was added (i.e., at the next exchange)
+static const unsigned int added_ghosts = UINT_MAX;
+
+// Neighbor slot of this rank
+static const int self_slot = ChDomainDistributed::SELF_SLOT;
+
+// Append n values to a byte buffer.
+template <typename T>
+static void Append(std::vector<char>& buf, const T* data, int n) {
+    const char* bytes = reinterpret_cast<const char*>(data);
+    buf.insert(buf.end(), bytes, bytes + n * sizeof(T));
+}
+
+// Extract n values from a byte buffer, starting at the given offset (advanced past the extracted values).
+template <typename T>
+static void Extract(const std::vector<char>& buf, size_t& offset, T* data, int n) {
+    std::memcpy(data, buf.data() + offset, n * sizeof(T));
+    offset += n * sizeof(T);
+}
+
+void ChCommDistributed::ProcessExchanges(int num_recv, BodyExchange* buf, int rank) {
+    if (num_recv == 0) {
         return;
     }
 
@@ -119,7 +142,7 @@ void ChCommDistributed::ProcessExchanges(int num_recv, BodyExchange* buf, int up
         UnpackExchange(buf + n, body);
 
         // Add the new body
-        distributed::COMM_STATUS status = (updown == 1) ? distributed::GHOST_UP : distributed::GHOST_DOWN;
+        distributed::COMM_STATUS status = (rank > my_sys->my_rank) ? distributed::GHOST_UP : distributed::GHOST_DOWN;
         if (ddm->first_empty == data_manager->num_rigid_bodies) {
             my_sys->AddBodyExchange(body, status);  // NOTE: Does not call colsys::add
         } else {
@@ -128,56 +151,124 @@ void ChCommDistributed::ProcessExchanges(int num_recv, BodyExchange* buf, int up
             ddm->gid_to_localid[body->GetGid()] = body->GetId();
             ddm->global_id[body->GetId()] = body->GetGid();
         }
+
+        // Initialize the reference state for the delta-encoded updates of this ghost
+        if (last_state.size() <= body->GetId())
+            last_state.resize(body->GetId() + 1, no_state);
+        if (ghost_slots.size() <= body->GetId())
+            ghost_slots.resize(body->GetId() + 1, 0);
+        ghost_slots[body->GetId()] = 0;
+        BodyUpdate& state = last_state[body->GetId()];
+        state.gid = (buf + n)->gid;
+        state.update_type = distributed::UPDATE;
+        std::copy((buf + n)->pos, (buf + n)->pos + 3, state.pos);
+        std::copy((buf + n)->rot, (buf + n)->rot + 4, state.rot);
+        std::copy((buf + n)->vel, (buf + n)->vel + 6, state.vel);
+
         // NOTE: At this point, the body has collide == false and it has not touched the collision system
     }
 }
 
-void ChCommDistributed::ProcessUpdates(int num_recv, BodyUpdate* buf) {
-    // If the buffer is empty
-    if (buf->gid == UINT_MAX) {
-        return;
-    }
+// Plain updates are only recorded in last_state; they are applied to the ghosts once all updates were processed
+// (see CompleteExchange), together with the ghosts for which no update was sent.
+void ChCommDistributed::ProcessUpdates(const std::vector<char>& buf, int rank) {
+    size_t offset = 0;
     std::shared_ptr<ChBody> body;
-    for (int n = 0; n < num_recv; n++) {
+    int my_rank = my_sys->my_rank;
+    while (offset < buf.size()) {
+        BodyUpdate upd;
+        unsigned char fields = DecodeUpdate(buf, offset, upd);
+        uint gid = upd.gid;
+        int update_type = upd.update_type;
+
+        // Ownership changes are followed by the list of the other ranks which have a ghost of the body
+        bool take_over =
+            (update_type == distributed::FINAL_UPDATE_GIVE || update_type == distributed::UPDATE_TRANSFER_SHARE);
+        std::vector<int> ghost_ranks;
+        if (take_over) {
+            int num_ghosts;
+            Extract(buf, offset, &num_ghosts, 1);
+            ghost_ranks.resize(num_ghosts);
+            Extract(buf, offset, ghost_ranks.data(), num_ghosts);
+        }
+
+        // Updates of ghosts whose body is handed over to another rank are followed by the rank of the new owner
+        int owner_rank = rank;
+        if (update_type == distributed::UPDATE_OWNER_CHANGE)
+            Extract(buf, offset, &owner_rank, 1);
+
         // Find the existing body
-        int index = ddm->GetLocalIndex((buf + n)->gid);
+        int index = ddm->GetLocalIndex(gid);
 
         if (index != -1 && ddm->comm_status[index] != distributed::EMPTY) {
             if (ddm->comm_status[index] != distributed::GHOST_UP &&
                 ddm->comm_status[index] != distributed::GHOST_DOWN) {
                 my_sys->ErrorAbort(std::string("Trying to update a non-ghost body on rank ") +
-                                   std::to_string(my_sys->my_rank) + std::string("GID ") +
-                                   std::to_string((buf + n)->gid) + std::string("\n"));
+                                   std::to_string(my_sys->my_rank) + std::string("GID ") + std::to_string(gid) +
+                                   std::string("\n"));
+            }
+
+            // Apply the changed fields to the last received state
+            BodyUpdate& state = last_state[index];
+            if (state.gid != gid && fields != FIELD_ALL) {
+                my_sys->ErrorAbort(std::string("Partial update without reference state for GID ") +
+                                   std::to_string(gid) + " on rank " + std::to_string(my_sys->my_rank) + "\n");
             }
+            MergeUpdate(state, upd, fields);
+
             body = (*data_manager->body_list)[index];
-            UnpackUpdate(buf + n, body);
-            if ((buf + n)->update_type == distributed::FINAL_UPDATE_GIVE) {
-                GetLog() << "GIVE " << ddm->global_id[index] << " to rank " << my_sys->my_rank << "\n";
-                ddm->comm_status[index] = distributed::OWNED;
-            } else if ((buf + n)->update_type == distributed::UPDATE_TRANSFER_SHARE) {
-                ddm->comm_status[index] = (ddm->comm_status[index] == distributed::GHOST_UP) ? distributed::SHARED_UP
-                                                                                             : distributed::SHARED_DOWN;
+            if (take_over) {
+                if (update_type == distributed::FINAL_UPDATE_GIVE)
+                    GetLog() << "GIVE " << ddm->global_id[index] << " to rank " << my_rank << "\n";
+                UnpackUpdate(&state, body);
+
+                // This rank now simulates the body and is responsible for its ghosts
+                unsigned int slots = 0;
+                bool up = false;
+                for (int r : ghost_ranks) {
+                    int slot = my_sys->domain->GetNeighborSlot(r);
+                    if (slot < 0 || slot == self_slot) {
+                        my_sys->ErrorAbort(std::string("Ghost of GID ") + std::to_string(gid) + " on rank " +
+                                           std::to_string(r) + " not adjacent to rank " + std::to_string(my_rank) +
+                                           "\n");
+                    }
+                    slots |= 1u << slot;
+                    up = up || r > my_rank;
+                }
+                if ((int)ghost_slots.size() <= index)
+                    ghost_slots.resize(index + 1, 0);
+                ghost_slots[index] = slots;
+                if (slots == 0) {
+                    state = no_state;
+                    ddm->comm_status[index] = distributed::OWNED;
+                } else {
+                    ddm->comm_status[index] = up ? distributed::SHARED_UP : distributed::SHARED_DOWN;
+                }
+            } else {
+                // The body may have been handed over to another rank since the ghost was created
+                ddm->comm_status[index] = (owner_rank > my_rank) ? distributed::GHOST_UP : distributed::GHOST_DOWN;
             }
         } else {
-            GetLog() << "GID " << (buf + n)->gid << " NOT found rank " << my_sys->my_rank << "\n";
+            GetLog() << "GID " << gid << " NOT found rank " << my_sys->my_rank << "\n";
             my_sys->ErrorAbort("Body to be updated not found\n");
         }
     }
 }
 
 void ChCommDistributed::ProcessTakes(int num_recv, uint* buf) {
-    if (buf[0] == UINT_MAX) {
+    if (num_recv == 0) {
         return;
     }
     for (int i = 0; i < num_recv; i++) {
         int index = ddm->GetLocalIndex(buf[i]);
+        last_state[index] = no_state;
         my_sys->RemoveBodyExchange(index);
     }
 }
 
 // TODO might be able to do in parallel if check the number of shapes per body in a first pass
 void ChCommDistributed::ProcessShapes(int num_recv, Shape* buf) {
-    if (buf->gid == UINT_MAX) {
+    if (num_recv == 0) {
         return;
     }
 
@@ -266,450 +357,363 @@ void ChCommDistributed::ProcessShapes(int num_recv, Shape* buf) {
 
 // Handle all necessary communication
 void ChCommDistributed::Exchange() {
+    PostExchange();
+    CompleteExchange();
+}
+
+void ChCommDistributed::PostExchange() {
+    if (pending) {
+        my_sys->ErrorAbort("PostExchange called with an exchange still pending\n");
+    }
+
     int my_rank = my_sys->my_rank;
-    int num_ranks = my_sys->num_ranks;
-    std::forward_list<int> exchanges_up;
-    std::forward_list<int> exchanges_down;
+    ChDomainDistributed* domain = my_sys->domain;
+
+    timer_pack.reset();
+    timer_post.reset();
+    timer_wait.reset();
+    timer_unpack.reset();
+
+    timer_pack.start();
+
+    for (int slot = 0; slot < ChDomainDistributed::NUM_SLOTS; slot++) {
+        NeighborData& nb = neighbors[slot];
+        nb.rank = (slot == self_slot) ? -1 : domain->GetNeighborRank(slot);
+        nb.exchange_send.clear();
+        nb.update_send.clear();
+        nb.take_send.clear();
+        nb.shape_send.clear();
+        nb.new_ghosts.clear();
+        for (int m = 0; m <= COUNTS; m++) {
+            nb.send_rq[m] = MPI_REQUEST_NULL;
+            nb.recv_rq[m] = MPI_REQUEST_NULL;
+        }
+    }
 
     // Saves a reference copy for consistency in the threads.
     ddm->curr_status = ddm->comm_status;
-    std::vector<BodyExchange> exchange_up_buf;
-    std::vector<BodyExchange> exchange_down_buf;
-    std::vector<BodyUpdate> update_up_buf;
-    std::vector<BodyUpdate> update_down_buf;
-    std::vector<Shape> shapes_up;
-    std::vector<Shape> shapes_down;
-    std::vector<uint> update_take_up;
-    std::vector<uint> update_take_down;
-
-    // Send Counts
-    int num_exchange_up = 0;
-    int num_exchange_down = 0;
-    int num_update_up = 0;
-    int num_update_down = 0;
-    int num_shapes_up = 0;
-    int num_shapes_down = 0;
-    int num_take_up = 0;
-    int num_take_down = 0;
-
-#pragma omp parallel sections
-    {
-// Exchange Loop
-#pragma omp section
-        {
-            for (uint i = 0; i < data_manager->num_rigid_bodies; i++) {
-                // Skip empty bodies or those that this rank isn't responsible for
-                int curr_status = ddm->curr_status[i];
-                if (curr_status != distributed::OWNED)
-                    continue;
-                int location = my_sys->domain->GetBodyRegion(i);
-
-                // If the body now affects the next sub-domain
-                // If the body is being marked as shared for the first time, the whole
-                // body must be packed to create a ghost on another rank
-                if ((location == distributed::GHOST_UP || location == distributed::SHARED_UP)) {
-                    BodyExchange b_ex = {};
-                    PackExchange(&b_ex, i);
-                    exchange_up_buf.push_back(b_ex);
-
-                    num_exchange_up++;  // TODO might be able to eliminate
-                    ddm->comm_status[i] = distributed::SHARED_UP;
-                    exchanges_up.push_front(i);
-                }
-
-                // If the body now affects the previous sub-domain:
-                // If the body is being
-                // marked as shared for the first time, the whole
-                // body must be packed to create a ghost on another rank
-                else if ((location == distributed::GHOST_DOWN || location == distributed::SHARED_DOWN)) {
-                    BodyExchange b_ex = {};
-                    PackExchange(&b_ex, i);
-                    exchange_down_buf.push_back(b_ex);
-
-                    num_exchange_down++;  // TODO might be able to eliminate
-                    ddm->comm_status[i] = distributed::SHARED_DOWN;
-                    exchanges_down.push_front(i);
-                }
-            }
-        }  // end of exchange section
-
-        // Update Loop
-#pragma omp section
-        {
-            // PACKING and UPDATING comm_status of existing bodies
-            for (uint i = 0; i < data_manager->num_rigid_bodies; i++) {
-                // Skip empty bodies or those that this rank isn't responsible for
-                int curr_status = ddm->curr_status[i];
-                int location = my_sys->domain->GetBodyRegion(i);
-
-                if (curr_status != distributed::SHARED_UP && curr_status != distributed::SHARED_DOWN)
-                    continue;
-
-                // If the body has already been shared, it need only update its
-                // corresponding ghost
-                if (location == distributed::SHARED_UP && curr_status == distributed::SHARED_UP) {
-                    BodyUpdate b_upd = {};
-                    PackUpdate(&b_upd, i, distributed::UPDATE);
-                    update_up_buf.push_back(b_upd);
-
-                    num_update_up++;  // TODO might be able to eliminate
-                } else if (location == distributed::GHOST_UP && curr_status == distributed::SHARED_UP) {
-                    BodyUpdate b_upd = {};
-                    PackUpdate(&b_upd, i, distributed::UPDATE_TRANSFER_SHARE);
-                    update_up_buf.push_back(b_upd);
-
-                    ddm->comm_status[i] = distributed::GHOST_UP;
-                    num_update_up++;  // TODO might be able to eliminate
-                }
+    uint num_bodies = data_manager->num_rigid_bodies;
+    last_state.resize(num_bodies, no_state);
+    ghost_slots.resize(num_bodies, added_ghosts);
+
+    // Locate the bodies simulated by this rank: neighbor slot of the rank whose sub-domain contains the body (-1 if it
+    // is not adjacent to this one) and neighbor slots of the ranks whose extended sub-domain contains the body.
+    std::vector<int> owner_slot(num_bodies, self_slot);
+    std::vector<unsigned int> range_slots(num_bodies, 0);
+#pragma omp parallel for
+    for (int i = 0; i < (signed)num_bodies; i++) {
+        int curr_status = ddm->curr_status[i];
+        if (curr_status != distributed::OWNED && curr_status != distributed::SHARED_UP &&
+            curr_status != distributed::SHARED_DOWN)
+            continue;
+        real3 pos = data_manager->host_data.pos_rigid[i];
+        ChVector<double> p(pos.x, pos.y, pos.z);
+        owner_slot[i] = domain->GetNeighborSlot(domain->GetRank(p));
+        range_slots[i] = domain->GetNeighborMask(p);
+    }
 
-                // If the body has already been shared, it need only update its
-                // corresponding ghost
-                else if (location == distributed::SHARED_DOWN && curr_status == distributed::SHARED_DOWN) {
-                    BodyUpdate b_upd = {};
-                    PackUpdate(&b_upd, i, distributed::UPDATE);
-                    update_down_buf.push_back(b_upd);
-
-                    num_update_down++;  // TODO might be able to eliminate
-                } else if (location == distributed::GHOST_DOWN && curr_status == distributed::SHARED_DOWN) {
-                    BodyUpdate b_upd = {};
-                    PackUpdate(&b_upd, i, distributed::UPDATE_TRANSFER_SHARE);
-                    update_down_buf.push_back(b_upd);
-
-                    ddm->comm_status[i] = distributed::GHOST_DOWN;
-                    num_update_down++;  // TODO might be able to eliminate
-                }
-                // If is shared up/down AND
-                // If the body is no longer involved with this rank, it must be removed from
-                // this rank
-                else if ((location == distributed::UNOWNED_UP || location == distributed::UNOWNED_DOWN) &&
-                         (ddm->comm_status[i] == distributed::SHARED_UP ||
-                          ddm->comm_status[i] == distributed::SHARED_DOWN)) {
-                    int up;
-                    if (location == distributed::UNOWNED_UP && my_rank != num_ranks - 1) {
-                        GetLog() << "GIVE " << ddm->global_id[i] << " from rank " << my_rank << "\n";
-                        BodyUpdate b_upd = {};
-                        PackUpdate(&b_upd, i, distributed::FINAL_UPDATE_GIVE);
-                        update_up_buf.push_back(b_upd);
-                        num_update_up++;  // TODO might be able to eliminate
-                        up = 1;
-                    } else if (location == distributed::UNOWNED_DOWN && my_rank != 0) {
-                        GetLog() << "GIVE " << ddm->global_id[i] << " from rank " << my_rank << "\n";
-                        BodyUpdate b_upd = {};
-                        PackUpdate(&b_upd, i, distributed::FINAL_UPDATE_GIVE);
-                        update_down_buf.push_back(b_upd);
-
-                        num_update_down++;  // TODO might be able to eliminate
-                        up = -1;
+    // PACKING and UPDATING comm_status of the bodies simulated by this rank
+    int num_skipped = 0;
+    std::vector<char> update;
+    std::vector<int> given;
+    for (uint i = 0; i < num_bodies; i++) {
+        int curr_status = ddm->curr_status[i];
+        if (curr_status != distributed::OWNED && curr_status != distributed::SHARED_UP &&
+            curr_status != distributed::SHARED_DOWN)
+            continue;
+
+        unsigned int& ghosts = ghost_slots[i];
+        unsigned int in_range = range_slots[i] & ~(1u << self_slot);
+        if (ghosts == added_ghosts)
+            ghosts = (curr_status == distributed::OWNED) ? 0 : in_range;
+
+        // If the body entered the sub-domain of a rank which has a ghost of it, hand it over to that rank, along with
+        // the list of the ranks which have a ghost of it
+        int owner = owner_slot[i];
+        if (owner != self_slot && owner != -1 && ((ghosts >> owner) & 1u)) {
+            bool keep = (range_slots[i] >> self_slot) & 1u;
+            NeighborData& nb_owner = neighbors[owner];
+
+            BodyUpdate b_upd = {};
+            PackUpdate(&b_upd, i, keep ? distributed::UPDATE_TRANSFER_SHARE : distributed::FINAL_UPDATE_GIVE);
+            EncodeUpdate(nb_owner.update_send, b_upd, last_state[i], update_tol);
+
+            // The body must have a ghost on each other rank whose extended sub-domain contains it. The missing ghosts
+            // are created, and the ghosts on ranks which the body no longer affects are removed.
+            unsigned int others = in_range & ~(1u << owner);
+            unsigned int added = others & ~ghosts;
+            unsigned int removed = ghosts & ~in_range;
+
+            if (added != 0) {
+                BodyExchange b_ex = {};
+                PackExchange(&b_ex, i);
+                for (int slot = 0; slot < ChDomainDistributed::NUM_SLOTS; slot++) {
+                    if ((added >> slot) & 1u) {
+                        neighbors[slot].exchange_send.push_back(b_ex);
+                        neighbors[slot].new_ghosts.push_back(i);
                     }
-
-                    my_sys->RemoveBodyExchange(i);
                 }
-            }  // End of packing for loop
-        }      // End of update section
-
-        // Update Take Loop
-#pragma omp section
-        {
-            // PACKING and UPDATING comm_status of existing bodies
-            for (uint i = 0; i < data_manager->num_rigid_bodies; i++) {
-                // Skip empty bodies or those that this rank isn't responsible for
-                int curr_status = ddm->curr_status[i];
-                if (curr_status != distributed::SHARED_DOWN && curr_status != distributed::SHARED_UP)
-                    continue;
+            }
 
-                int location = my_sys->domain->GetBodyRegion(i);
-
-                // If the body is no longer involved with either neighbor, remove it from
-                // the other rank and take ownership on this rank
-                if (location == distributed::OWNED) {
-                    if (curr_status == distributed::SHARED_UP) {
-                        uint b_ut;
-                        PackUpdateTake(&b_ut, i);
-                        update_take_up.push_back(b_ut);
-                        num_take_up++;  // TODO might be able to eliminate
-
-                    } else if (curr_status == distributed::SHARED_DOWN) {
-                        uint b_ut;
-                        PackUpdateTake(&b_ut, i);
-                        update_take_down.push_back(b_ut);
-                        num_take_down++;  // TODO might be able to eliminate
-                    }
-                    ddm->comm_status[i] = distributed::OWNED;
+            if (removed != 0) {
+                uint b_ut;
+                PackUpdateTake(&b_ut, i);
+                for (int slot = 0; slot < ChDomainDistributed::NUM_SLOTS; slot++) {
+                    if ((removed >> slot) & 1u)
+                        neighbors[slot].take_send.push_back(b_ut);
                 }
-            }  // End of packing for loop
-        }      // End of update take loop
-    }          // End of parallel sections
-
-    // MPI_Status status_exchange_up;
-    // MPI_Status status_exchange_down;
-    // MPI_Status status_update_up;
-    // MPI_Status status_update_down;
-    // MPI_Status status_take_up;
-    // MPI_Status status_take_down;
-    // MPI_Status status_shapes_up;
-    // MPI_Status status_shapes_down;
-
-    MPI_Request rq_exchange_up;
-    MPI_Request rq_exchange_down;
-    MPI_Request rq_update_up;
-    MPI_Request rq_update_down;
-    MPI_Request rq_take_up;
-    MPI_Request rq_take_down;
-    MPI_Request rq_shapes_up;
-    MPI_Request rq_shapes_down;
-
-    MPI_Status recv_status_exchange_up;
-    MPI_Status recv_status_exchange_down;
-    MPI_Status recv_status_update_up;
-    MPI_Status recv_status_update_down;
-    MPI_Status recv_status_take_up;
-    MPI_Status recv_status_take_down;
-    MPI_Status recv_status_shapes_up;
-    MPI_Status recv_status_shapes_down;
-
-    int num_recv_exchange_up;
-    int num_recv_exchange_down;
-    int num_recv_update_up;
-    int num_recv_update_down;
-    int num_recv_take_up;
-    int num_recv_take_down;
-    int num_recv_shapes_up;
-    int num_recv_shapes_down;
-
-    BodyExchange* recv_exchange_down = NULL;
-    BodyExchange* recv_exchange_up = NULL;
-    BodyUpdate* recv_update_down = NULL;
-    BodyUpdate* recv_update_up = NULL;
-    uint* recv_take_down = NULL;
-    uint* recv_take_up = NULL;
-    Shape* recv_shapes_down = NULL;
-    Shape* recv_shapes_up = NULL;
-
-#pragma omp parallel sections
-    {
-// Send/Recv
-#pragma omp section
-        {
-            // SENDING - TODO sequential for now
-
-            // Send empty message if there is nothing to send
-            if (num_exchange_up == 0) {
-                BodyExchange b_e = {};
-                b_e.gid = UINT_MAX;
-                exchange_up_buf.push_back(b_e);
-                num_exchange_up = 1;
-            }
-            if (num_exchange_down == 0) {
-                BodyExchange b_e = {};
-                b_e.gid = UINT_MAX;
-                exchange_down_buf.push_back(b_e);
-                num_exchange_down = 1;
-            }
-            if (num_update_up == 0) {
-                BodyUpdate b_u = {};
-                b_u.gid = UINT_MAX;
-                update_up_buf.push_back(b_u);
-                num_update_up = 1;
-            }
-            if (num_update_down == 0) {
-                BodyUpdate b_u = {};
-                b_u.gid = UINT_MAX;
-                update_down_buf.push_back(b_u);
-                num_update_down = 1;
-            }
-            if (num_take_up == 0) {
-                update_take_up.push_back(UINT_MAX);
-                num_take_up = 1;
-            }
-            if (num_take_down == 0) {
-                update_take_down.push_back(UINT_MAX);
-                num_take_down = 1;
             }
 
-            // Send Exchanges
-            if (my_rank != num_ranks - 1) {
-                MPI_Isend(&(exchange_up_buf[0]), num_exchange_up, BodyExchangeType, my_rank + 1, 1, my_sys->world,
-                          &rq_exchange_up);
-            }
-            if (my_rank != 0) {
-                MPI_Isend(&(exchange_down_buf[0]), num_exchange_down, BodyExchangeType, my_rank - 1, 2, my_sys->world,
-                          &rq_exchange_down);
+            // All other ghosts (including the new ones) receive the exact state, which is the reference state of the
+            // new owner, followed by the rank of the new owner
+            std::vector<int> ghost_ranks;
+            if (keep)
+                ghost_ranks.push_back(my_rank);
+            b_upd.update_type = distributed::UPDATE_OWNER_CHANGE;
+            for (int slot = 0; slot < ChDomainDistributed::NUM_SLOTS; slot++) {
+                if (!((others >> slot) & 1u))
+                    continue;
+                BodyUpdate ref = no_state;
+                EncodeUpdate(neighbors[slot].update_send, b_upd, ref, update_tol);
+                Append(neighbors[slot].update_send, &nb_owner.rank, 1);
+                ghost_ranks.push_back(neighbors[slot].rank);
             }
 
-            // Recv Exchanges
-            if (my_rank != 0) {
-                MPI_Probe(my_rank - 1, 1, my_sys->world, &recv_status_exchange_down);
-                MPI_Get_count(&recv_status_exchange_down, BodyExchangeType, &num_recv_exchange_down);
-                recv_exchange_down = new BodyExchange[num_recv_exchange_down];
-                MPI_Recv(recv_exchange_down, num_recv_exchange_down, BodyExchangeType, my_rank - 1, 1, my_sys->world,
-                         &recv_status_exchange_down);
-            }
-            if (my_rank != num_ranks - 1) {
-                MPI_Probe(my_rank + 1, 2, my_sys->world, &recv_status_exchange_up);
-                MPI_Get_count(&recv_status_exchange_up, BodyExchangeType, &num_recv_exchange_up);
-                recv_exchange_up = new BodyExchange[num_recv_exchange_up];
-                MPI_Recv(recv_exchange_up, num_recv_exchange_up, BodyExchangeType, my_rank + 1, 2, my_sys->world,
-                         &recv_status_exchange_up);
-            }
+            int num_ghosts = (int)ghost_ranks.size();
+            Append(nb_owner.update_send, &num_ghosts, 1);
+            Append(nb_owner.update_send, ghost_ranks.data(), num_ghosts);
 
-            // Send Updates
-            if (my_rank != num_ranks - 1) {
-                MPI_Isend(&(update_up_buf[0]), num_update_up, BodyUpdateType, my_rank + 1, 3, my_sys->world,
-                          &rq_update_up);
-            }
-            if (my_rank != 0) {
-                MPI_Isend(&(update_down_buf[0]), num_update_down, BodyUpdateType, my_rank - 1, 4, my_sys->world,
-                          &rq_update_down);
+            ghosts = 0;
+            if (keep) {
+                ddm->comm_status[i] = (nb_owner.rank > my_rank) ? distributed::GHOST_UP : distributed::GHOST_DOWN;
+            } else {
+                // The body is removed once the shapes of its new ghosts are packed
+                GetLog() << "GIVE " << ddm->global_id[i] << " from rank " << my_rank << "\n";
+                last_state[i] = no_state;
+                given.push_back(i);
             }
+            continue;
+        }
 
-            // Recv Updates
-            if (my_rank != 0) {
-                MPI_Probe(my_rank - 1, 3, my_sys->world, &recv_status_update_down);
-                MPI_Get_count(&recv_status_update_down, BodyUpdateType, &num_recv_update_down);
-                recv_update_down = new BodyUpdate[num_recv_update_down];
-                MPI_Recv(recv_update_down, num_recv_update_down, BodyUpdateType, my_rank - 1, 3, my_sys->world,
-                         &recv_status_update_down);
-            }
-            if (my_rank != num_ranks - 1) {
-                MPI_Probe(my_rank + 1, 4, my_sys->world, &recv_status_update_up);
-                MPI_Get_count(&recv_status_update_up, BodyUpdateType, &num_recv_update_up);
-                recv_update_up = new BodyUpdate[num_recv_update_up];
-                MPI_Recv(recv_update_up, num_recv_update_up, BodyUpdateType, my_rank + 1, 4, my_sys->world,
-                         &recv_status_update_up);
+        // Otherwise, this rank keeps simulating the body. It must have a ghost on each neighbor rank whose extended
+        // sub-domain contains it.
+        unsigned int added = in_range & ~ghosts;
+        unsigned int kept = in_range & ghosts;
+        unsigned int removed = ghosts & ~in_range;
+
+        // If the body is being shared for the first time, its state is the reference for the delta encoding of the
+        // updates
+        if (ghosts == 0 && added != 0)
+            PackUpdate(&last_state[i], i, distributed::UPDATE);
+
+        // New ghosts: the whole body must be packed
+        if (added != 0) {
+            BodyExchange b_ex = {};
+            PackExchange(&b_ex, i);
+            for (int slot = 0; slot < ChDomainDistributed::NUM_SLOTS; slot++) {
+                if ((added >> slot) & 1u) {
+                    neighbors[slot].exchange_send.push_back(b_ex);
+                    neighbors[slot].new_ghosts.push_back(i);
+                }
             }
+        }
 
-            // Send Takes
-            if (my_rank != num_ranks - 1) {
-                MPI_Isend(&(update_take_up[0]), num_take_up, MPI_UNSIGNED, my_rank + 1, 5, my_sys->world, &rq_take_up);
-            }
-            if (my_rank != 0) {
-                MPI_Isend(&(update_take_down[0]), num_take_down, MPI_UNSIGNED, my_rank - 1, 6, my_sys->world,
-                          &rq_take_down);
+        // Existing ghosts: update them (if the state of the body changed)
+        if (kept != 0) {
+            BodyUpdate b_upd = {};
+            PackUpdate(&b_upd, i, distributed::UPDATE);
+            update.clear();
+            if (EncodeUpdate(update, b_upd, last_state[i], update_tol)) {
+                for (int slot = 0; slot < ChDomainDistributed::NUM_SLOTS; slot++) {
+                    if ((kept >> slot) & 1u)
+                        neighbors[slot].update_send.insert(neighbors[slot].update_send.end(), update.begin(),
+                                                           update.end());
+                }
+            } else {
+                num_skipped++;
             }
+        }
 
-            // Recv Takes
-            if (my_rank != 0) {
-                MPI_Probe(my_rank - 1, 5, my_sys->world, &recv_status_take_down);
-                MPI_Get_count(&recv_status_take_down, MPI_UNSIGNED, &num_recv_take_down);
-                recv_take_down = new uint[num_recv_take_down];
-                MPI_Recv(recv_take_down, num_recv_take_down, MPI_UNSIGNED, my_rank - 1, 5, my_sys->world,
-                         &recv_status_take_down);
-            }
-            if (my_rank != num_ranks - 1) {
-                MPI_Probe(my_rank + 1, 6, my_sys->world, &recv_status_take_up);
-                MPI_Get_count(&recv_status_take_up, MPI_UNSIGNED, &num_recv_take_up);
-                recv_take_up = new uint[num_recv_take_up];
-                MPI_Recv(recv_take_up, num_recv_take_up, MPI_UNSIGNED, my_rank + 1, 6, my_sys->world,
-                         &recv_status_take_up);
+        // Ghosts on ranks which the body no longer affects: remove them
+        if (removed != 0) {
+            uint b_ut;
+            PackUpdateTake(&b_ut, i);
+            for (int slot = 0; slot < ChDomainDistributed::NUM_SLOTS; slot++) {
+                if ((removed >> slot) & 1u)
+                    neighbors[slot].take_send.push_back(b_ut);
             }
+        }
 
-            // Make sure all non-blocking communications are done.
-            if (my_rank != num_ranks - 1) {
-                MPI_Wait(&rq_exchange_up, MPI_STATUS_IGNORE);
-                MPI_Wait(&rq_update_up, MPI_STATUS_IGNORE);
-                MPI_Wait(&rq_take_up, MPI_STATUS_IGNORE);
-            }
-            if (my_rank != 0) {
-                MPI_Wait(&rq_exchange_down, MPI_STATUS_IGNORE);
-                MPI_Wait(&rq_update_down, MPI_STATUS_IGNORE);
-                MPI_Wait(&rq_take_down, MPI_STATUS_IGNORE);
-            }
-        }  // End of send/recv section
-
-// TODO could do in parallel if counting the spaces in the buffers in the first pass
-// Pack Shapes Up
-#pragma omp section
-        {
-            for (auto itr_up = exchanges_up.begin(); itr_up != exchanges_up.end(); itr_up++) {
-                num_shapes_up += PackShapes(&shapes_up, *itr_up);
+        ghosts = in_range;
+        if (in_range == 0) {
+            if (curr_status != distributed::OWNED)
+                last_state[i] = no_state;
+            ddm->comm_status[i] = distributed::OWNED;
+        } else {
+            bool up = false;
+            for (int slot = 0; slot < ChDomainDistributed::NUM_SLOTS; slot++) {
+                if (((in_range >> slot) & 1u) && neighbors[slot].rank > my_rank)
+                    up = true;
             }
+            ddm->comm_status[i] = up ? distributed::SHARED_UP : distributed::SHARED_DOWN;
+        }
+    }
 
-            if (num_shapes_up == 0) {
-                Shape shape;
-                shape.gid = UINT_MAX;
-                shapes_up.push_back(shape);
-                num_shapes_up = 1;
-            }
-        }  // End of pack shapes up section
+    num_skipped_updates = num_skipped;
 
-// Pack Shapes Down
-#pragma omp section
-        {
-            for (auto itr_down = exchanges_down.begin(); itr_down != exchanges_down.end(); itr_down++) {
-                num_shapes_down += PackShapes(&shapes_down, *itr_down);
-            }
-            if (num_shapes_down == 0) {
-                Shape shape;
-                shape.gid = UINT_MAX;
-                shapes_down.push_back(shape);
-                num_shapes_down = 1;
-            }
-        }  // End of pack shapes down section
-    }      // End of parallel sections
-
-    // TODO sections?
-    if (my_rank != 0)
-        ProcessExchanges(num_recv_exchange_down, recv_exchange_down, 0);
-    if (my_rank != num_ranks - 1)
-        ProcessExchanges(num_recv_exchange_up, recv_exchange_up, 1);
-
-    if (my_rank != 0)
-        ProcessUpdates(num_recv_update_down, recv_update_down);
-    if (my_rank != num_ranks - 1)
-        ProcessUpdates(num_recv_update_up, recv_update_up);
-
-    if (my_rank != 0)
-        ProcessTakes(num_recv_take_down, recv_take_down);
-    if (my_rank != num_ranks - 1)
-        ProcessTakes(num_recv_take_up, recv_take_up);
-
-    // Send Shapes
-    if (my_rank != num_ranks - 1) {
-        MPI_Isend(&(shapes_up[0]), num_shapes_up, ShapeType, my_rank + 1, 7, my_sys->world, &rq_shapes_up);
+    // Pack the collision shapes of the new ghosts
+#pragma omp parallel for
+    for (int slot = 0; slot < ChDomainDistributed::NUM_SLOTS; slot++) {
+        for (auto index : neighbors[slot].new_ghosts) {
+            PackShapes(&neighbors[slot].shape_send, index);
+        }
     }
-    if (my_rank != 0) {
-        MPI_Isend(&(shapes_down[0]), num_shapes_down, ShapeType, my_rank - 1, 8, my_sys->world, &rq_shapes_down);
+
+    for (auto index : given) {
+        my_sys->RemoveBodyExchange(index);
     }
 
-    // Recv Shapes
-    if (my_rank != 0) {
-        MPI_Probe(my_rank - 1, 7, my_sys->world, &recv_status_shapes_down);
-        MPI_Get_count(&recv_status_shapes_down, ShapeType, &num_recv_shapes_down);
-        recv_shapes_down = new Shape[num_recv_shapes_down];
-        MPI_Recv(recv_shapes_down, num_recv_shapes_down, ShapeType, my_rank - 1, 7, my_sys->world,
-                 &recv_status_shapes_down);
+    timer_pack.stop();
+
+    // Post all sends and the receives of the message sizes. There is at most one message of each kind between two
+    // ranks in an exchange; the kind of message defines the tag.
+    timer_post.start();
+    for (int slot = 0; slot < ChDomainDistributed::NUM_SLOTS; slot++) {
+        NeighborData& nb = neighbors[slot];
+        if (nb.rank < 0)
+            continue;
+
+        nb.send_counts[EXCHANGES] = (int)nb.exchange_send.size();
+        nb.send_counts[UPDATES] = (int)nb.update_send.size();
+        nb.send_counts[TAKES] = (int)nb.take_send.size();
+        nb.send_counts[SHAPES] = (int)nb.shape_send.size();
+
+        MPI_Irecv(nb.recv_counts, 4, MPI_INT, nb.rank, COUNTS + 1, my_sys->world, &nb.recv_rq[COUNTS]);
+        MPI_Isend(nb.send_counts, 4, MPI_INT, nb.rank, COUNTS + 1, my_sys->world, &nb.send_rq[COUNTS]);
+
+        MPI_Isend(nb.exchange_send.data(), nb.send_counts[EXCHANGES], BodyExchangeType, nb.rank, EXCHANGES + 1,
+                  my_sys->world, &nb.send_rq[EXCHANGES]);
+        MPI_Isend(nb.update_send.data(), nb.send_counts[UPDATES], MPI_BYTE, nb.rank, UPDATES + 1, my_sys->world,
+                  &nb.send_rq[UPDATES]);
+        MPI_Isend(nb.take_send.data(), nb.send_counts[TAKES], MPI_UNSIGNED, nb.rank, TAKES + 1, my_sys->world,
+                  &nb.send_rq[TAKES]);
+        MPI_Isend(nb.shape_send.data(), nb.send_counts[SHAPES], ShapeType, nb.rank, SHAPES + 1, my_sys->world,
+                  &nb.send_rq[SHAPES]);
     }
-    if (my_rank != num_ranks - 1) {
-        MPI_Probe(my_rank + 1, 8, my_sys->world, &recv_status_shapes_up);
-        MPI_Get_count(&recv_status_shapes_up, ShapeType, &num_recv_shapes_up);
-        ////GetLog() << "num_recv_shapes_up" << num_recv_shapes_up << "\n";
-        recv_shapes_up = new Shape[num_recv_shapes_up];
-        MPI_Recv(recv_shapes_up, num_recv_shapes_up, ShapeType, my_rank + 1, 8, my_sys->world, &recv_status_shapes_up);
+    timer_post.stop();
+
+    pending = true;
+}
+
+void ChCommDistributed::CompleteExchange() {
+    if (!pending)
+        return;
+
+    const int num_slots = ChDomainDistributed::NUM_SLOTS;
+
+    // Post the payload receives of each neighbor as soon as its message sizes arrive
+    std::vector<MPI_Request> count_rq(num_slots);
+    for (int slot = 0; slot < num_slots; slot++)
+        count_rq[slot] = neighbors[slot].recv_rq[COUNTS];
+    while (true) {
+        int slot;
+        timer_wait.start();
+        MPI_Waitany(num_slots, count_rq.data(), &slot, MPI_STATUS_IGNORE);
+        timer_wait.stop();
+        if (slot == MPI_UNDEFINED)
+            break;
+        neighbors[slot].recv_rq[COUNTS] = MPI_REQUEST_NULL;
+        timer_post.start();
+        PostReceives(slot);
+        timer_post.stop();
     }
 
-    if (my_rank != 0)
-        ProcessShapes(num_recv_shapes_down, recv_shapes_down);
-    if (my_rank != num_ranks - 1)
-        ProcessShapes(num_recv_shapes_up, recv_shapes_up);
+    // Process the incoming data in the same order on all ranks, waiting for each message only when it is needed.
+    // New ghosts must exist before their shapes are added, and all new ghosts are created before any ghost is removed.
+    for (int slot = 0; slot < num_slots; slot++) {
+        NeighborData& nb = neighbors[slot];
+        if (nb.rank < 0)
+            continue;
+        WaitReceive(slot, EXCHANGES);
+        timer_unpack.start();
+        ProcessExchanges(nb.recv_counts[EXCHANGES], nb.exchange_recv.data(), nb.rank);
+        timer_unpack.stop();
+    }
 
-    if (my_rank != num_ranks - 1) {
-        MPI_Wait(&rq_shapes_up, MPI_STATUS_IGNORE);
+    for (int slot = 0; slot < num_slots; slot++) {
+        NeighborData& nb = neighbors[slot];
+        if (nb.rank < 0)
+            continue;
+        WaitReceive(slot, UPDATES);
+        timer_unpack.start();
+        ProcessUpdates(nb.update_recv, nb.rank);
+        timer_unpack.stop();
     }
-    if (my_rank != 0) {
-        MPI_Wait(&rq_shapes_down, MPI_STATUS_IGNORE);
+
+    for (int slot = 0; slot < num_slots; slot++) {
+        NeighborData& nb = neighbors[slot];
+        if (nb.rank < 0)
+            continue;
+        WaitReceive(slot, TAKES);
+        timer_unpack.start();
+        ProcessTakes(nb.recv_counts[TAKES], nb.take_recv.data());
+        timer_unpack.stop();
     }
 
-    // Free all dynamic memory used for recving
-    delete[] recv_exchange_down;
-    delete[] recv_exchange_up;
-    delete[] recv_update_down;
-    delete[] recv_update_up;
-    delete[] recv_take_down;
-    delete[] recv_take_up;
-    delete[] recv_shapes_down;
-    delete[] recv_shapes_up;
+    // Set all remaining ghosts to the last state received from their owner. Ghosts whose state did not change were not
+    // sent an update, but they were integrated on this rank during the step.
+    timer_unpack.start();
+    std::vector<std::shared_ptr<ChBody>>& body_list = *data_manager->body_list;
+#pragma omp parallel for
+    for (int i = 0; i < (signed)data_manager->num_rigid_bodies; i++) {
+        if ((ddm->comm_status[i] == distributed::GHOST_UP || ddm->comm_status[i] == distributed::GHOST_DOWN) &&
+            last_state[i].gid == ddm->global_id[i])
+            UnpackUpdate(&last_state[i], body_list[i]);
+    }
+    timer_unpack.stop();
+
+    for (int slot = 0; slot < num_slots; slot++) {
+        NeighborData& nb = neighbors[slot];
+        if (nb.rank < 0)
+            continue;
+        WaitReceive(slot, SHAPES);
+        timer_unpack.start();
+        ProcessShapes(nb.recv_counts[SHAPES], nb.shape_recv.data());
+        timer_unpack.stop();
+    }
 
+    // Make sure all non-blocking sends are done.
+    timer_wait.start();
+    for (int slot = 0; slot < num_slots; slot++)
+        MPI_Waitall(5, neighbors[slot].send_rq, MPI_STATUSES_IGNORE);
     MPI_Barrier(my_sys->world);
+    timer_wait.stop();
+
+    pending = false;
+}
+
+void ChCommDistributed::PostReceives(int slot) {
+    NeighborData& nb = neighbors[slot];
+
+    nb.exchange_recv.resize(nb.recv_counts[EXCHANGES]);
+    nb.update_recv.resize(nb.recv_counts[UPDATES]);
+    nb.take_recv.resize(nb.recv_counts[TAKES]);
+    nb.shape_recv.resize(nb.recv_counts[SHAPES]);
+
+    MPI_Irecv(nb.exchange_recv.data(), nb.recv_counts[EXCHANGES], BodyExchangeType, nb.rank, EXCHANGES + 1,
+              my_sys->world, &nb.recv_rq[EXCHANGES]);
+    MPI_Irecv(nb.update_recv.data(), nb.recv_counts[UPDATES], MPI_BYTE, nb.rank, UPDATES + 1, my_sys->world,
+              &nb.recv_rq[UPDATES]);
+    MPI_Irecv(nb.take_recv.data(), nb.recv_counts[TAKES], MPI_UNSIGNED, nb.rank, TAKES + 1, my_sys->world,
+              &nb.recv_rq[TAKES]);
+    MPI_Irecv(nb.shape_recv.data(), nb.recv_counts[SHAPES], ShapeType, nb.rank, SHAPES + 1, my_sys->world,
+              &nb.recv_rq[SHAPES]);
+}
+
+void ChCommDistributed::WaitReceive(int slot, int message) {
+    timer_wait.start();
+    MPI_Wait(&neighbors[slot].recv_rq[message], MPI_STATUS_IGNORE);
+    timer_wait.stop();
 }
 
 void ChCommDistributed::PackExchange(BodyExchange* buf, int index) {
@@ -822,6 +826,81 @@ void ChCommDistributed::PackUpdate(BodyUpdate* buf, int index, int update_type)
     buf->vel[5] = omega.z();
 }
 
+// Return true if any of the n values differs from its reference value by more than the tolerance.
+static bool Differ(const double* val, const double* ref, int n, double tol) {
+    for (int i = 0; i < n; i++) {
+        if (!(std::abs(val[i] - ref[i]) <= tol))
+            return true;
+    }
+    return false;
+}
+
+// Encoded update: gid, update type, field flags, followed by the flagged fields.
+// Only the sent fields are copied to the reference state, so that it remains identical to the state of the ghost on
+// the receiving rank: the ghost lags behind the shared body by at most the tolerance, and by nothing for a zero
+// tolerance. All fields are sent for ownership changes and for bodies without a reference state (e.g. ghosts created
+// when the body was added).
+bool ChCommDistributed::EncodeUpdate(std::vector<char>& buf, const BodyUpdate& upd, BodyUpdate& last, double tol) {
+    unsigned char fields = FIELD_ALL;
+    if (upd.update_type == distributed::UPDATE && last.gid == upd.gid) {
+        fields = 0;
+        if (Differ(upd.pos, last.pos, 3, tol))
+            fields |= FIELD_POS;
+        if (Differ(upd.rot, last.rot, 4, tol))
+            fields |= FIELD_ROT;
+        if (Differ(upd.vel, last.vel, 3, tol))
+            fields |= FIELD_LIN_VEL;
+        if (Differ(upd.vel + 3, last.vel + 3, 3, tol))
+            fields |= FIELD_ANG_VEL;
+        if (fields == 0)
+            return false;
+    }
+
+    Append(buf, &upd.gid, 1);
+    Append(buf, &upd.update_type, 1);
+    Append(buf, &fields, 1);
+    if (fields & FIELD_POS)
+        Append(buf, upd.pos, 3);
+    if (fields & FIELD_ROT)
+        Append(buf, upd.rot, 4);
+    if (fields & FIELD_LIN_VEL)
+        Append(buf, upd.vel, 3);
+    if (fields & FIELD_ANG_VEL)
+        Append(buf, upd.vel + 3, 3);
+
+    MergeUpdate(last, upd, fields);
+    return true;
+}
+
+unsigned char ChCommDistributed::DecodeUpdate(const std::vector<char>& buf, size_t& offset, BodyUpdate& upd) {
+    unsigned char fields;
+    Extract(buf, offset, &upd.gid, 1);
+    Extract(buf, offset, &upd.update_type, 1);
+    Extract(buf, offset, &fields, 1);
+    if (fields & FIELD_POS)
+        Extract(buf, offset, upd.pos, 3);
+    if (fields & FIELD_ROT)
+        Extract(buf, offset, upd.rot, 4);
+    if (fields & FIELD_LIN_VEL)
+        Extract(buf, offset, upd.vel, 3);
+    if (fields & FIELD_ANG_VEL)
+        Extract(buf, offset, upd.vel + 3, 3);
+    return fields;
+}
+
+void ChCommDistributed::MergeUpdate(BodyUpdate& state, const BodyUpdate& upd, unsigned char fields) {
+    state.gid = upd.gid;
+    state.update_type = upd.update_type;
+    if (fields & FIELD_POS)
+        std::copy(upd.pos, upd.pos + 3, state.pos);
+    if (fields & FIELD_ROT)
+        std::copy(upd.rot, upd.rot + 4, state.rot);
+    if (fields & FIELD_LIN_VEL)
+        std::copy(upd.vel, upd.vel + 3, state.vel);
+    if (fields & FIELD_ANG_VEL)
+        std::copy(upd.vel + 3, upd.vel + 6, state.vel + 3);
+}
+
 void ChCommDistributed::UnpackUpdate(BodyUpdate* buf, std::shared_ptr<ChBody> body) {
     // Position
     body->SetPos(ChVector<double>(buf->pos[0], buf->pos[1], buf->pos[2]));
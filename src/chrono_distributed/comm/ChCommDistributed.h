@@ -15,7 +15,9 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
+#include "chrono/core/ChTimer.h"
 #include "chrono/physics/ChBody.h"
 
 #include "chrono_parallel/ChDataManager.h"
@@ -93,15 +95,45 @@ typedef struct Shape {
 ///
 /// Actions:
 ///
-/// A body with an OWNED comm_status will be packed for exchange to create a ghost body on another rank when it
-/// passes into one of this rank's shared regions, at which point the body is given a SHARED comm_status on this rank.
+/// The rank which simulates a body (i.e., whose sub-domain contained the body at the previous exchange) is
+/// responsible for it and keeps track of the neighbor ranks which have a ghost of it. At each exchange, for each body
+/// with an OWNED or SHARED comm_status:
 ///
-/// A body with a SHARED comm_status will become OWNED when it moves into the owned region on this rank.
-/// A body with a SHARED comm_status will become GHOST when it crosses subhi or sublo and the other rank will change its
-/// comm_status for the body to SHARED.
+/// If the body is still in the sub-domain of this rank, or if it entered the sub-domain of a rank which has no ghost
+/// of it, this rank keeps simulating it. A ghost is created (by sending the whole body and its collision shapes) on
+/// every neighbor rank whose extended sub-domain (see ChDomainDistributed) now contains the body and which has no ghost
+/// of it, the existing ghosts on these ranks are updated, and the ghosts on the other ranks are removed. The body
+/// becomes SHARED if it has ghosts, and OWNED otherwise.
 ///
-/// A body with a GHOST comm_status will become OWNED when it moves into the owned region of this rank.
-/// A body with a GHOST comm_status will be removed when it moves into the one of this rank's unowned regions.
+/// If the body entered the sub-domain of a rank which has a ghost of it, the body is handed over to that rank, along
+/// with the list of the ranks which have a ghost of it. The body becomes a GHOST on this rank if it is still in its
+/// extended sub-domain, and is removed otherwise. Before the handover, the ghosts are created and removed as above, so
+/// that the new owner receives the exact list of ranks whose extended sub-domain contains the body. Its ghosts are
+/// updated with the exact state of the body and told the rank of its new owner.
+///
+/// With a split of the domain along a single axis, a body can only be shared with the lower or upper neighbor rank.
+/// With a split along several axes, a body close to an edge or a corner of a sub-domain can have ghosts on up to 7
+/// neighbor ranks. Messages are exchanged with all adjacent sub-domains (up to 26).
+///
+/// Communication:
+///
+/// An exchange is done in two phases. PostExchange packs all outgoing data (new ghosts, ghost updates, takes and
+/// collision shapes) and posts all sends and receives with the neighbor ranks. CompleteExchange waits for the
+/// incoming messages and processes each of them as soon as it arrives, so that the processing of early messages
+/// overlaps with the transfer of later ones. At each step, ChSystemDistributed posts the exchange, detects the
+/// contacts between the bodies it simulates and calculates their forces while the messages are in transit, and
+/// completes the exchange before detecting the contacts involving ghosts (see
+/// ChSystemDistributed::RunCollisionDetection). The time spent in CompleteExchange waiting for messages (GetTimeWait)
+/// is therefore reduced by the time spent on these local computations.
+///
+/// Ghost updates are delta encoded: both ranks keep the last state communicated for each shared body, only the
+/// changed fields (position, rotation, linear and angular velocity) are sent, and no message is sent for a shared
+/// body whose state did not change. A field is considered changed if any of its components differs from the last
+/// communicated value by more than the update tolerance (see SetUpdateTolerance). Updates are sent as raw bytes, which
+/// assumes the same data representation on all ranks.
+///
+/// While an exchange is pending, the ghosts may be updated, removed, or added at any time and must not be used. The
+/// states, collision shapes, and local indices of all other bodies are not changed by CompleteExchange.
 class CH_DISTR_API ChCommDistributed {
   public:
     ChCommDistributed(ChSystemDistributed* my_sys);
@@ -113,14 +145,72 @@ class CH_DISTR_API ChCommDistributed {
     ///	- need to update their comm_status
     /// Sends updates via mpi to the appropriate rank
     /// Processes incoming updates from other ranks
+    /// Equivalent to PostExchange followed by CompleteExchange.
     void Exchange();
 
+    /// Packs all outgoing data and posts the sends and receives with the neighbor ranks.
+    /// Updates the comm_status of the bodies leaving this rank's responsibility.
+    /// The system must not be modified or advanced until CompleteExchange is called.
+    void PostExchange();
+
+    /// Waits for the incoming data and processes it, then waits for the completion of all sends.
+    /// Does nothing if no exchange is pending.
+    void CompleteExchange();
+
+    /// Returns true if an exchange was posted and not yet completed.
+    bool IsExchangePending() const { return pending; }
+
+    /// Time (in seconds) spent packing the outgoing data in the last exchange.
+    double GetTimePack() const { return timer_pack.GetTimeSeconds(); }
+
+    /// Time (in seconds) spent posting sends and receives in the last exchange.
+    double GetTimePost() const { return timer_post.GetTimeSeconds(); }
+
+    /// Time (in seconds) spent waiting for the completion of messages in the last exchange.
+    double GetTimeWait() const { return timer_wait.GetTimeSeconds(); }
+
+    /// Time (in seconds) spent processing the incoming data in the last exchange.
+    double GetTimeUnpack() const { return timer_unpack.GetTimeSeconds(); }
+
+    /// Number of shared bodies for which no update was sent in the last exchange (unchanged state).
+    int GetNumSkippedUpdates() const { return num_skipped_updates; }
+
+    /// Set the tolerance for the delta encoding of ghost updates (default: 0).
+    /// With the default value, any change in the state of a shared body is sent and the ghosts reproduce exactly the
+    /// state of the shared bodies. With a positive tolerance, changes in a field (position, rotation quaternion, linear
+    /// or angular velocity) are only sent once one of its components differs from the last communicated value by more
+    /// than the tolerance, so that ghost states lag behind by at most the tolerance. Ownership changes always transfer
+    /// the exact state. Must be the same on all ranks.
+    void SetUpdateTolerance(double tol) { update_tol = tol; }
+
+    /// Return the tolerance for the delta encoding of ghost updates.
+    double GetUpdateTolerance() const { return update_tol; }
+
+    /// Flags of the fields present in a delta-encoded body update.
+    enum UpdateField : unsigned char {
+        FIELD_POS = 1,
+        FIELD_ROT = 2,
+        FIELD_LIN_VEL = 4,
+        FIELD_ANG_VEL = 8,
+        FIELD_ALL = 15
+    };
+
+    /// Appends the fields of upd that differ from the reference state last by more than tol to buf, and copies them
+    /// to last. Plain updates with no changed fields are skipped; returns false in that case.
+    static bool EncodeUpdate(std::vector<char>& buf, const BodyUpdate& upd, BodyUpdate& last, double tol);
+
+    /// Extracts the update starting at the given offset in buf (advanced past the update) into upd.
+    /// Only the fields present in the update are set. Returns the flags of these fields.
+    static unsigned char DecodeUpdate(const std::vector<char>& buf, size_t& offset, BodyUpdate& upd);
+
+    /// Copies the gid, the update type, and the flagged fields of upd to state.
+    static void MergeUpdate(BodyUpdate& state, const BodyUpdate& upd, unsigned char fields);
+
   protected:
     ChSystemDistributed* my_sys;
 
-    /// MPI Data Types for sending 1) new body 2) body update 3) new collision shape
+    /// MPI Data Types for sending 1) new body 2) new collision shape
     MPI_Datatype BodyExchangeType;
-    MPI_Datatype BodyUpdateType;
     MPI_Datatype ShapeType;
 
     /// Pointer to underlying chrono::parallel data
@@ -130,11 +220,36 @@ class CH_DISTR_API ChCommDistributed {
     ChDistributedDataManager* ddm;
 
   private:
+    /// Kinds of messages sent to each neighbor (also used to define the message tags).
+    enum Message { EXCHANGES = 0, UPDATES = 1, TAKES = 2, SHAPES = 3, COUNTS = 4 };
+
+    /// Outgoing and incoming data for one neighbor rank.
+    struct NeighborData {
+        int rank;  ///< rank of the neighbor (-1 if there is no sub-domain in this direction)
+
+        std::vector<BodyExchange> exchange_send;  ///< new ghosts
+        std::vector<char> update_send;            ///< delta-encoded ghost updates
+        std::vector<uint> take_send;              ///< gids of ghosts to remove
+        std::vector<Shape> shape_send;            ///< collision shapes of new ghosts
+        std::vector<int> new_ghosts;              ///< local indices of the new ghosts (for packing their shapes)
+
+        std::vector<BodyExchange> exchange_recv;
+        std::vector<char> update_recv;
+        std::vector<uint> take_recv;
+        std::vector<Shape> shape_recv;
+
+        int send_counts[4];  ///< sizes of the outgoing messages (indexed by Message)
+        int recv_counts[4];  ///< sizes of the incoming messages (indexed by Message)
+
+        MPI_Request send_rq[5];  ///< requests of the outgoing messages (indexed by Message)
+        MPI_Request recv_rq[5];  ///< requests of the incoming messages (indexed by Message)
+    };
+
     /// Helper function for processing incoming exchange messages.
-    void ProcessExchanges(int num_recv, BodyExchange* buf, int updown);
+    void ProcessExchanges(int num_recv, BodyExchange* buf, int rank);
 
-    /// Helper function for processing incoming update messages.
-    void ProcessUpdates(int num_recv, BodyUpdate* buf);
+    /// Helper function for processing incoming (delta-encoded) update messages.
+    void ProcessUpdates(const std::vector<char>& buf, int rank);
 
     /// Helper function for processing incoming take messages.
     void ProcessTakes(int num_recv, uint* buf);
@@ -142,6 +257,12 @@ class CH_DISTR_API ChCommDistributed {
     /// Helper function for processing incoming shape messages.
     void ProcessShapes(int num_recv, Shape* buf);
 
+    /// Posts the receives for the payload messages from the specified neighbor, once their sizes are known.
+    void PostReceives(int slot);
+
+    /// Waits for the specified incoming message from the specified neighbor.
+    void WaitReceive(int slot, int message);
+
     /// Packages the body data into buf.
     /// Returns the number of elements which the body took in the buffer
     void PackExchange(BodyExchange* buf, int index);
@@ -161,6 +282,24 @@ class CH_DISTR_API ChCommDistributed {
     /// Packs all shapes for the body at index into buf and returns
     /// the number of shapes that it has packed.
     int PackShapes(std::vector<Shape>* buf, int index);
+
+    /// Data of the neighbor ranks, indexed by neighbor slot (see ChDomainDistributed::NUM_SLOTS).
+    std::vector<NeighborData> neighbors;
+    bool pending;  ///< true between PostExchange and CompleteExchange
+
+    /// Neighbor slots of the ranks which have a ghost of each body simulated by this rank (bit mask, indexed by local
+    /// body index).
+    std::vector<unsigned int> ghost_slots;
+
+    /// Last state communicated for each shared body or ghost (indexed by local body index), used for delta encoding.
+    std::vector<BodyUpdate> last_state;
+    double update_tol;  ///< tolerance for the delta encoding of ghost updates
+    int num_skipped_updates;
+
+    ChTimer<double> timer_pack;    ///< packing of outgoing data
+    ChTimer<double> timer_post;    ///< posting of sends and receives
+    ChTimer<double> timer_wait;    ///< waiting for message completion
+    ChTimer<double> timer_unpack;  ///< processing of incoming data
 };
 /// @} distributed_comm
 
@@ -22,16 +22,33 @@
 
 #include <mpi.h>
 #include <stdlib.h>
+#include <algorithm>
+#include <cfloat>
 #include <iostream>
 #include <memory>
+#include <numeric>
 
 using namespace chrono;
 
+const int ChDomainDistributed::NUM_SLOTS;
+const int ChDomainDistributed::SELF_SLOT;
+
 ChDomainDistributed::ChDomainDistributed(ChSystemDistributed* sys) {
     this->my_sys = sys;
     split_axis = 0;
     split = false;
     axis_set = false;
+    grid_set = false;
+    for (int i = 0; i < 3; i++) {
+        num_sub[i] = 1;
+        sub_coords[i] = 0;
+    }
+    balance_interval = 0;
+    balance_metric = LoadMetric::BODY_COUNT;
+    max_shift = 0.5;
+    balance_steps = 0;
+    balance_time = 0;
+    load_imbalance = 1;
 }
 
 ChDomainDistributed::~ChDomainDistributed() {}
@@ -41,11 +58,27 @@ void ChDomainDistributed::SetSplitAxis(int i) {
     if (i == 0 || i == 1 || i == 2) {
         split_axis = i;
         axis_set = true;
+        grid_set = false;
     } else {
         GetLog() << "Invalid axis\n";
     }
 }
 
+void ChDomainDistributed::SetNumSubdomains(int nx, int ny, int nz) {
+    assert(!split);
+    if (nx < 1 || ny < 1 || nz < 1 || nx * ny * nz != my_sys->num_ranks) {
+        GetLog() << "Invalid number of sub-domains\n";
+        return;
+    }
+    num_sub[0] = nx;
+    num_sub[1] = ny;
+    num_sub[2] = nz;
+    split_axis = (nx >= ny) ? 0 : 1;
+    split_axis = (nz > num_sub[split_axis]) ? 2 : split_axis;
+    axis_set = true;
+    grid_set = true;
+}
+
 void ChDomainDistributed::SetSimDomain(double xlo, double xhi, double ylo, double yhi, double zlo, double zhi) {
     assert(!split);
 
@@ -68,95 +101,273 @@ void ChDomainDistributed::SetSimDomain(double xlo, double xhi, double ylo, doubl
     SplitDomain();
 }
 
+void ChDomainDistributed::SetLoadBalancing(int interval, LoadMetric metric) {
+    balance_interval = std::max(interval, 0);
+    balance_metric = metric;
+    balance_steps = 0;
+    balance_time = 0;
+}
+
+void ChDomainDistributed::SetMaxBoundaryShift(double fraction) {
+    if (fraction > 0 && fraction < 1) {
+        max_shift = fraction;
+    } else {
+        GetLog() << "Invalid boundary shift\n";
+    }
+}
+
 void ChDomainDistributed::SplitDomain() {
-    // Length of this subdomain along the long axis
-    double sub_len = (boxhi[split_axis] - boxlo[split_axis]) / my_sys->num_ranks;
+    if (!grid_set) {
+        for (int i = 0; i < 3; i++) {
+            num_sub[i] = (i == split_axis) ? my_sys->num_ranks : 1;
+        }
+    }
+    GetSubdomainCoords(my_sys->my_rank, sub_coords);
 
+    // Equal lengths of the sub-domains along each axis
     for (int i = 0; i < 3; i++) {
-        if (split_axis == i) {
-            sublo[i] = boxlo[i] + my_sys->my_rank * sub_len;
-            subhi[i] = sublo[i] + sub_len;
-        } else {
-            sublo[i] = boxlo[i];
-            subhi[i] = boxhi[i];
+        int n = num_sub[i];
+        double sub_len = (boxhi[i] - boxlo[i]) / n;
+
+        boundaries[i].resize(n + 1);
+        for (int j = 0; j < n; j++) {
+            boundaries[i][j] = boxlo[i] + j * sub_len;
         }
+        boundaries[i][n] = boxhi[i];
     }
+
+    SetSubDomain();
     split = true;
 }
 
+void ChDomainDistributed::SetSubDomain() {
+    for (int i = 0; i < 3; i++) {
+        sublo[i] = boundaries[i][sub_coords[i]];
+        subhi[i] = boundaries[i][sub_coords[i] + 1];
+    }
+}
+
+void ChDomainDistributed::GetSubdomainCoords(int rank, int coords[3]) const {
+    coords[0] = rank % num_sub[0];
+    coords[1] = (rank / num_sub[0]) % num_sub[1];
+    coords[2] = rank / (num_sub[0] * num_sub[1]);
+}
+
 int ChDomainDistributed::GetRank(ChVector<double> pos) {
-    double sub_len = subhi[split_axis] - sublo[split_axis];
-    double pt = pos[split_axis] - boxlo[split_axis];
+    // Sub-domain i along each axis spans [boundaries[i], boundaries[i + 1])
+    int coords[3];
+    for (int i = 0; i < 3; i++) {
+        auto itr = std::upper_bound(boundaries[i].begin() + 1, boundaries[i].end() - 1, pos[i]);
+        coords[i] = (int)(itr - (boundaries[i].begin() + 1));
+    }
+    return coords[0] + num_sub[0] * (coords[1] + num_sub[1] * coords[2]);
+}
 
-    return (int)(pt / sub_len);
+int ChDomainDistributed::GetNeighborRank(int slot) const {
+    int offset[3] = {slot % 3 - 1, (slot / 3) % 3 - 1, slot / 9 - 1};
+    int coords[3];
+    for (int i = 0; i < 3; i++) {
+        coords[i] = sub_coords[i] + offset[i];
+        if (coords[i] < 0 || coords[i] >= num_sub[i])
+            return -1;
+    }
+    return coords[0] + num_sub[0] * (coords[1] + num_sub[1] * coords[2]);
 }
 
-distributed::COMM_STATUS ChDomainDistributed::GetRegion(double pos) {
-    int num_ranks = my_sys->num_ranks;
-    if (num_ranks == 1) {
-        return distributed::OWNED;
+int ChDomainDistributed::GetNeighborSlot(int rank) const {
+    int coords[3];
+    GetSubdomainCoords(rank, coords);
+    int slot = 0;
+    for (int i = 2; i >= 0; i--) {
+        int offset = coords[i] - sub_coords[i];
+        if (offset < -1 || offset > 1)
+            return -1;
+        slot = 3 * slot + offset + 1;
     }
-    int my_rank = my_sys->my_rank;
+    return slot;
+}
+
+unsigned int ChDomainDistributed::GetNeighborMask(const ChVector<double>& pos) const {
     double ghost_layer = my_sys->GetGhostLayer();
-    double high = subhi[split_axis];
-    double low = sublo[split_axis];
 
-    if (my_rank != 0 && my_rank != num_ranks - 1) {
-        if (pos >= low + ghost_layer && pos < high - ghost_layer) {
-            return distributed::OWNED;
-        } else if (pos >= high && pos < high + ghost_layer) {
-            return distributed::GHOST_UP;
-        } else if (pos >= high - ghost_layer && pos < high) {
-            return distributed::SHARED_UP;
-        } else if (pos >= low && pos < low + ghost_layer) {
-            return distributed::SHARED_DOWN;
-        } else if (pos >= low - ghost_layer && pos < low) {
-            return distributed::GHOST_DOWN;
-        } else if (pos >= high + ghost_layer) {
-            return distributed::UNOWNED_UP;
-        } else if (pos < low - ghost_layer) {
-            return distributed::UNOWNED_DOWN;
+    // Offsets (bits 0, 1, 2 for -1, 0, 1) of the neighbor sub-domains containing pos along each axis
+    unsigned int axis_mask[3];
+    for (int i = 0; i < 3; i++) {
+        axis_mask[i] = 0;
+        for (int offset = -1; offset <= 1; offset++) {
+            int c = sub_coords[i] + offset;
+            if (c < 0 || c >= num_sub[i])
+                continue;
+            const std::vector<double>& b = boundaries[i];
+            if ((c == 0 || pos[i] >= b[c] - ghost_layer) && (c == num_sub[i] - 1 || pos[i] < b[c + 1] + ghost_layer))
+                axis_mask[i] |= 1u << (offset + 1);
         }
     }
 
-    else if (my_rank == 0) {
-        if (pos >= low && pos < high - ghost_layer) {
-            return distributed::OWNED;
-        } else if (pos >= high && pos < high + ghost_layer) {
-            return distributed::GHOST_UP;
-        } else if (pos >= high - ghost_layer && pos < high) {
-            return distributed::SHARED_UP;
-        } else if (pos >= high + ghost_layer) {
-            return distributed::UNOWNED_UP;
-        } else if (pos < low) {
-            return distributed::UNOWNED_DOWN;
+    unsigned int mask = 0;
+    for (int slot = 0; slot < NUM_SLOTS; slot++) {
+        if ((axis_mask[0] >> (slot % 3)) & (axis_mask[1] >> ((slot / 3) % 3)) & (axis_mask[2] >> (slot / 9)) & 1u)
+            mask |= 1u << slot;
+    }
+    return mask;
+}
+
+int ChDomainDistributed::GetClosestFace(const ChVector<double>& pos) {
+    int face = 0;
+    double dist = DBL_MAX;
+    for (int i = 0; i < 3; i++) {
+        if (sub_coords[i] > 0 && pos[i] - sublo[i] < dist) {
+            dist = pos[i] - sublo[i];
+            face = 2 * i;
+        }
+        if (sub_coords[i] < num_sub[i] - 1 && subhi[i] - pos[i] < dist) {
+            dist = subhi[i] - pos[i];
+            face = 2 * i + 1;
         }
     }
+    return face;
+}
+
+void ChDomainDistributed::Balance(double step_time) {
+    if (balance_interval <= 0 || my_sys->num_ranks == 1) {
+        return;
+    }
+
+    balance_time += step_time;
+    if (++balance_steps < balance_interval) {
+        return;
+    }
+
+    double load = 0;
+    switch (balance_metric) {
+        case LoadMetric::STEP_TIME:
+            load = balance_time;
+            break;
+        case LoadMetric::BODY_COUNT:
+            for (uint i = 0; i < my_sys->data_manager->num_rigid_bodies; i++) {
+                distributed::COMM_STATUS status = my_sys->ddm->comm_status[i];
+                if (status != distributed::EMPTY && status != distributed::GLOBAL) {
+                    load += 1;
+                }
+            }
+            break;
+    }
+
+    std::vector<double> loads(my_sys->num_ranks);
+    MPI_Allgather(&load, 1, MPI_DOUBLE, loads.data(), 1, MPI_DOUBLE, my_sys->world);
+
+    balance_steps = 0;
+    balance_time = 0;
+
+    Rebalance(loads);
+}
 
-    else if (my_rank == num_ranks - 1) {
-        if (pos >= low + ghost_layer && pos < high) {
+void ChDomainDistributed::Rebalance(const std::vector<double>& loads) {
+    int num_ranks = my_sys->num_ranks;
+    double total = std::accumulate(loads.begin(), loads.end(), 0.0);
+    if (total <= 0) {
+        return;
+    }
+    load_imbalance = *std::max_element(loads.begin(), loads.end()) * num_ranks / total;
+
+    // Balance the loads of the slabs of sub-domains along each split axis
+    for (int i = 0; i < 3; i++) {
+        if (num_sub[i] == 1)
+            continue;
+        std::vector<double> slab_loads(num_sub[i], 0.0);
+        for (int r = 0; r < num_ranks; r++) {
+            int coords[3];
+            GetSubdomainCoords(r, coords);
+            slab_loads[coords[i]] += loads[r];
+        }
+        RebalanceAxis(i, slab_loads);
+    }
+
+    SetSubDomain();
+}
+
+bool ChDomainDistributed::RebalanceAxis(int axis, const std::vector<double>& loads) {
+    std::vector<double>& bnd = boundaries[axis];
+    int num = num_sub[axis];
+    double total = std::accumulate(loads.begin(), loads.end(), 0.0);
+    if (total <= 0) {
+        return false;
+    }
+
+    // Boundaries which split the total load equally, assuming that the load is uniformly distributed within each
+    // slab
+    std::vector<double> target(bnd);
+    double cumulative = 0;
+    int r = 0;
+    for (int i = 1; i < num; i++) {
+        double goal = total * i / num;
+        while (r < num - 1 && cumulative + loads[r] < goal) {
+            cumulative += loads[r];
+            r++;
+        }
+        double frac = (loads[r] > 0) ? (goal - cumulative) / loads[r] : 0;
+        frac = std::min(std::max(frac, 0.0), 1.0);
+        target[i] = bnd[r] + frac * (bnd[r + 1] - bnd[r]);
+    }
+
+    // Keep the sub-domains at least twice as wide as the ghost layer
+    double min_width = 2 * my_sys->GetGhostLayer();
+    for (int i = 1; i < num; i++) {
+        target[i] = std::max(target[i], target[i - 1] + min_width);
+    }
+    for (int i = num - 1; i > 0; i--) {
+        target[i] = std::min(target[i], target[i + 1] - min_width);
+    }
+    for (int i = 1; i <= num; i++) {
+        if (target[i] - target[i - 1] < min_width * (1 - 1e-9)) {
+            return false;
+        }
+    }
+
+    // Move the boundaries towards the targets, limiting the displacement so that bodies change region by at most
+    // one layer (see ChCommDistributed::Exchange)
+    double shift = max_shift * my_sys->GetGhostLayer();
+    for (int i = 1; i < num; i++) {
+        bnd[i] = std::min(std::max(target[i], bnd[i] - shift), bnd[i] + shift);
+    }
+    return true;
+}
+
+distributed::COMM_STATUS ChDomainDistributed::GetRegion(const ChVector<double>& pos) {
+    int num_ranks = my_sys->num_ranks;
+    if (num_ranks == 1) {
+        return distributed::OWNED;
+    }
+    int my_rank = my_sys->my_rank;
+    int owner = GetRank(pos);
+    unsigned int mask = GetNeighborMask(pos);
+
+    if (owner == my_rank) {
+        unsigned int others = mask & ~(1u << SELF_SLOT);
+        if (others == 0) {
             return distributed::OWNED;
-        } else if (pos >= low && pos < low + ghost_layer) {
-            return distributed::SHARED_DOWN;
-        } else if (pos >= low - ghost_layer && pos < low) {
-            return distributed::GHOST_DOWN;
-        } else if (pos >= high) {
-            return distributed::UNOWNED_UP;
-        } else if (pos < low - ghost_layer) {
-            return distributed::UNOWNED_DOWN;
         }
+        for (int slot = 0; slot < NUM_SLOTS; slot++) {
+            if (((others >> slot) & 1u) && GetNeighborRank(slot) > my_rank) {
+                return distributed::SHARED_UP;
+            }
+        }
+        return distributed::SHARED_DOWN;
     }
 
-    GetLog() << "Error classifying body\n";
-    return distributed::UNDEFINED;
+    if ((mask >> SELF_SLOT) & 1u) {
+        return (owner > my_rank) ? distributed::GHOST_UP : distributed::GHOST_DOWN;
+    }
+    return (owner > my_rank) ? distributed::UNOWNED_UP : distributed::UNOWNED_DOWN;
 }
 
 distributed::COMM_STATUS ChDomainDistributed::GetBodyRegion(int index) {
-    return GetRegion(my_sys->data_manager->host_data.pos_rigid[index][split_axis]);
+    real3 pos = my_sys->data_manager->host_data.pos_rigid[index];
+    return GetRegion(ChVector<double>(pos.x, pos.y, pos.z));
 }
 
 distributed::COMM_STATUS ChDomainDistributed::GetBodyRegion(std::shared_ptr<ChBody> body) {
-    return GetRegion(body->GetPos()[split_axis]);
+    return GetRegion(body->GetPos());
 }
 
 void ChDomainDistributed::PrintDomain() {
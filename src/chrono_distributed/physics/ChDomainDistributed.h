@@ -15,6 +15,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "chrono/core/ChVector.h"
 #include "chrono/physics/ChBody.h"
@@ -31,11 +32,26 @@ class ChSystemDistributed;
 /// @{
 
 /// This class maps sub-domains of the global simulation domain to each MPI rank.
-/// The global domain is split along the longest axis.
-/// Within each sub-domain, there are layers of ownership:
-///
-///
-/// 0 < RANK < NUM_RANKS - 1:
+/// By default, the global domain is split along the longest axis (or the axis set with SetSplitAxis) into one slab
+/// per rank. Alternatively, it can be split along several axes into a grid of sub-domains (see SetNumSubdomains).
+/// Sub-domain i along each axis spans [boundaries[i], boundaries[i + 1]); the sub-domains at the ends of an axis
+/// extend without limit beyond the global domain, so that every position belongs to exactly one sub-domain.
+///
+/// The sub-domain of a rank, extended by the ghost layer on the faces it shares with other sub-domains, is the region
+/// in which the rank keeps a copy of the bodies. With respect to a rank, a body is:
+///
+/// ** Owned: in the sub-domain of this rank, and in the extended sub-domain of no other rank.
+/// 		The body is simulated on this rank only.
+/// ** Shared_up/Shared_down: in the sub-domain of this rank, and in the extended sub-domains of other ranks.
+/// 		The body is simulated on this rank and sent to update its ghosts on these ranks every timestep.
+/// 		Shared_up if one of these ranks has a higher index than this rank.
+/// ** Ghost_up/Ghost_down: in the extended sub-domain of this rank, but in the sub-domain of another rank.
+/// 		The body is a proxy for a body simulated on the other rank and is updated by it every timestep.
+/// 		Ghost_up if the other rank has a higher index than this rank.
+/// ** Unowned_up/Unowned_down: outside of the extended sub-domain of this rank.
+/// 		Bodies in these regions do not interact with this rank.
+///
+/// With a split along a single axis, these regions are the layers:
 ///
 /// Unowned_up (high + ghostlayer <= pos)
 /// Ghost_up (high <= pos < high + ghostlayer)
@@ -45,68 +61,43 @@ class ChSystemDistributed;
 /// Ghost_down (low - ghost_layer <= pos < low)
 /// Unowned_down (pos < low - ghostlayer)
 ///
+/// where the layers beyond the first and last boundaries do not exist on the first and last ranks.
 ///
-/// RANK = 0:
-///
-/// Unowned_up (high + ghostlayer <= pos)
-/// Ghost_up (high <= pos < high + ghostlayer)
-/// Shared_up (high - ghostlayer <= pos < high)
-/// Owned (low <= pos < high - ghostlayer)
-/// Unowned_down (pos < low)
-///
-///
-/// RANK = NUM_RANKS - 1:
-///
-/// Unowned_up (high <= pos)
-/// Owned (low + ghostlayer <= pos < high)
-/// Shared_down (low <= pos < low + ghostlayer)
-/// Ghost_down (low - ghost_layer <= pos < low)
-/// Unowned_down (pos < low - ghostlayer)
-///
-///
-/// At AddBody:
-/// ** Unowned_up/Unowned_down:
-/// 		Bodies in this region do not interact with this rank
-/// ** Ghost_up/Ghost_down:
-/// 		Bodies in these regions are added to this rank, and expect to be updated
-/// 		by a neighbor rank every timestep
-/// ** Shared_up/Shared_down:
-/// 		Bodies in these regions are added to this rank, and send updates to a neighbor
-/// 		rank every timestep
-/// ** Owned:
-/// 		Bodies in this region are added to this rank only and have no interaction with other ranks.
-///
+/// At AddBody, a body is added to all ranks on which it is not unowned. Mid-simulation, the region of a body is
+/// only evaluated by the rank which simulates it, which creates, updates, and removes its ghosts on the other ranks and
+/// hands the body over to the rank whose sub-domain it enters (see ChCommDistributed). Bodies are assumed to move by
+/// less than the ghost layer at each step.
 ///
-/// Mid-Simulation:
-/// ** Unowned_up/Unowned_down:
-/// 		Bodies in these regions do not interact with this rank
-/// ** Ghost_up/Ghost_down:
-/// 		--If a body in one of these regions was most recently in this rank, it will be simulated on this
-/// 		rank and sent to update a ghost body on a neighbor rank every timestep.
-/// 		--If a body in one of these regions was most recently in another rank, it will be simulated on this
-/// 		rank and will be updated by a neighbor rank every timestep.
-/// ** Shared_up/Shared_down:
-/// 		--If a body in one of these regions was most recently in this rank, it will be simulated on this
-/// 		rank and sent to update a ghost body on a neighbor rank every timestep.
-/// 		--If a body in one of these regions was most recently in another rank, it will be simulated on this
-/// 		rank and will be updated by a neighbor rank every timestep.
-/// ** Owned:
-/// 		Bodies in this region are simulated only on this rank.
 ///
+/// Load balancing:
 ///
-/// Actions:
+/// By default, the sub-domains have equal lengths along each split axis. If load balancing is enabled (see
+/// SetLoadBalancing), the boundaries between sub-domains are periodically moved so that all ranks carry the same
+/// load, measured either as the number of bodies simulated on each rank or as the time spent in each rank's
+/// dynamics step. The sub-domains always form a grid: along each split axis, the boundaries are moved so that the
+/// slabs of sub-domains between consecutive boundaries carry the same total load. At each rebalancing, a boundary
+/// moves by at most a fraction of the ghost layer (see SetMaxBoundaryShift), so that the bodies affected by the move
+/// change region in the same way as bodies moving across a fixed boundary and are migrated by the regular exchange
+/// at the beginning of the next step (see ChSystemDistributed::RunCollisionDetection). Sub-domains are never
+/// narrower than twice the ghost layer.
 ///
-/// A body with an OWNED comm_status will be packed for exchange to create a ghost body on another rank when it
-/// passes into one of this rank's shared regions, at which point the body is given a SHARED comm_status on this rank.
-///
-/// A body with a SHARED comm_status will become OWNED when it moves into the owned region on this rank.
-/// A body with a SHARED comm_status will become GHOST when it moves outside of [sublo, subhi), the other rank
-/// updates its comm_status for that body to SHARED and takes charge of updating the body.
-///
-/// A body with a GHOST comm_status will become OWNED when it moves into the owned region of this rank.
-/// A body with a GHOST comm_status will be removed when it moves into the one of this rank's unowned regions.
+/// Because the sub-domains change during the simulation, fixed bodies are added to all ranks when load balancing is
+/// enabled (see ChSystemDistributed::AddBody).
 class CH_DISTR_API ChDomainDistributed {
   public:
+    /// Measure of the load of a rank, used for load balancing.
+    enum class LoadMetric {
+        BODY_COUNT,  ///< number of bodies simulated on the rank (owned, shared, and ghost bodies)
+        STEP_TIME    ///< wall clock time of the rank's dynamics steps (excluding inter-rank communication)
+    };
+
+    /// Number of neighbor slots of a sub-domain. The sub-domain offset by (dx, dy, dz) in the grid of sub-domains,
+    /// with each offset in {-1, 0, 1}, is in slot (dx + 1) + 3 * (dy + 1) + 9 * (dz + 1).
+    static const int NUM_SLOTS = 27;
+
+    /// Neighbor slot of the sub-domain itself.
+    static const int SELF_SLOT = 13;
+
     ChDomainDistributed(ChSystemDistributed* sys);
     virtual ~ChDomainDistributed();
 
@@ -134,17 +125,66 @@ class CH_DISTR_API ChDomainDistributed {
     /// Sets the axis along which the domain will be split x=0, y=1, z=2
     void SetSplitAxis(int i);
     /// x = 0, y = 1, z = 2
+    /// With a split along several axes, the axis with the largest number of sub-domains.
     int GetSplitAxis() { return split_axis; }
 
+    /// Sets the number of sub-domains along each axis, for a split of the domain along several axes (2D or 3D
+    /// decomposition). The product must be equal to the number of ranks. Must be called before SetSimDomain.
+    void SetNumSubdomains(int nx, int ny, int nz);
+
+    /// Returns the number of sub-domains along the specified axis.
+    int GetNumSubdomains(int axis) const { return num_sub[axis]; }
+
+    /// Returns the coordinates of the sub-domain of the specified rank in the grid of sub-domains.
+    void GetSubdomainCoords(int rank, int coords[3]) const;
+
     /// Returns the rank which has ownership of a body with the given position
     int GetRank(ChVector<double> pos);
 
+    /// Returns the rank of the sub-domain in the specified neighbor slot, or -1 if there is no such sub-domain.
+    int GetNeighborRank(int slot) const;
+
+    /// Returns the neighbor slot of the sub-domain of the specified rank, or -1 if it is not adjacent to this one.
+    int GetNeighborSlot(int rank) const;
+
+    /// Returns the neighbor slots of the sub-domains (including this one) whose extension by the ghost layer contains
+    /// the given position, as a bit mask.
+    unsigned int GetNeighborMask(const ChVector<double>& pos) const;
+
+    /// Returns the index of the face of this sub-domain closest to the given position, among the faces which separate
+    /// it from other sub-domains: 2 * axis for the lower face and 2 * axis + 1 for the upper face along an axis.
+    int GetClosestFace(const ChVector<double>& pos);
+
     /// Returns true if the domain has been set.
     bool IsSplit() { return split; }
 
     /// Prints basic information about the domain decomposition
     virtual void PrintDomain();
 
+    /// Enable load balancing, performed every 'interval' steps using the specified load measure.
+    /// An interval of 0 (default) disables load balancing. Must be set on all ranks, before adding bodies.
+    /// With load balancing enabled, fixed bodies added with ChSystemDistributed::AddBody are kept on all ranks.
+    void SetLoadBalancing(int interval, LoadMetric metric = LoadMetric::BODY_COUNT);
+
+    /// Return true if load balancing is enabled.
+    bool IsLoadBalancing() const { return balance_interval > 0; }
+
+    /// Set the maximum displacement of a sub-domain boundary at each rebalancing, as a fraction of the ghost layer
+    /// (default: 0.5). Must be in (0, 1); larger values risk moving bodies across more than one region per step.
+    void SetMaxBoundaryShift(double fraction);
+
+    /// Return the boundaries of the sub-domains along the specified axis (number of sub-domains along the axis + 1
+    /// values). Sub-domain i along the axis spans [boundaries[i], boundaries[i + 1]).
+    const std::vector<double>& GetBoundaries(int axis) const { return boundaries[axis]; }
+
+    /// Return the ratio between the maximum and the average rank load at the last rebalancing (1: perfect balance).
+    double GetLoadImbalance() const { return load_imbalance; }
+
+    /// Called by the system after each dynamics step, with the time spent in that step.
+    /// Every 'interval' steps, gathers the loads of all ranks and moves the sub-domain boundaries.
+    /// Collective call: must be called on all ranks.
+    virtual void Balance(double step_time);
+
     ChVector<double> boxlo;  ///< Lower coordinates of the global domain
     ChVector<double> boxhi;  ///< Upper coordinates of the global domain
 
@@ -156,16 +196,39 @@ class CH_DISTR_API ChDomainDistributed {
     int split_axis;  ///< Index of the dimension of the longest edge of the global domain
 
     /// Divides the domain into equal-volume, orthogonal, axis-aligned regions along
-    /// the longest axis. Needs to be called right after the system is created so that
-    /// bodies are added correctly.
+    /// the longest axis (or along the axes set with SetNumSubdomains). Needs to be called right after the system is
+    /// created so that bodies are added correctly.
     virtual void SplitDomain();
     bool split;     ///< Flag indicating that the domain has been divided into sub-domains.
     bool axis_set;  ///< Flag indicating that the splitting axis has been set.
+    bool grid_set;  ///< Flag indicating that the number of sub-domains along each axis has been set.
+
+    /// Compute new sub-domain boundaries from the loads of all ranks.
+    virtual void Rebalance(const std::vector<double>& loads);
+
+    /// Compute new sub-domain boundaries along the specified axis from the loads of the slabs of sub-domains.
+    /// Returns false (and leaves the boundaries unchanged) if the sub-domains cannot be balanced.
+    bool RebalanceAxis(int axis, const std::vector<double>& loads);
+
+    /// Set the bounds of this sub-domain from the boundaries along each axis.
+    void SetSubDomain();
+
+    int num_sub[3];     ///< number of sub-domains along each axis
+    int sub_coords[3];  ///< coordinates of this sub-domain in the grid of sub-domains
+
+    std::vector<double> boundaries[3];  ///< sub-domain boundaries along each axis
+
+    int balance_interval;       ///< number of steps between rebalancings (0: no load balancing)
+    LoadMetric balance_metric;  ///< measure of rank load
+    double max_shift;           ///< maximum boundary displacement, as a fraction of the ghost layer
+    int balance_steps;          ///< steps since the last rebalancing
+    double balance_time;        ///< accumulated step time since the last rebalancing
+    double load_imbalance;      ///< ratio of maximum to average load at the last rebalancing
 
   private:
     /// Helper function that is called by the public GetRegion methods to get
     /// the region classification for a body based on the center position.
-    distributed::COMM_STATUS GetRegion(double pos);
+    distributed::COMM_STATUS GetRegion(const ChVector<double>& pos);
 };
 /// @} distributed_physics
 
@@ -15,6 +15,7 @@
 #include <cstdlib>
 
 #include <mpi.h>
+#include <algorithm>
 #include <cfloat>
 #include <climits>
 #include <cmath>
@@ -26,6 +27,7 @@
 #include <string>
 
 #include "chrono/collision/ChCollisionSystem.h"
+#include "chrono/core/ChTimer.h"
 #include "chrono/physics/ChBody.h"
 
 #include "chrono_distributed/ChDistributedDataManager.h"
@@ -36,7 +38,9 @@
 
 #include "chrono_parallel/ChDataManager.h"
 #include "chrono_parallel/ChParallelDefines.h"
+#include "chrono_parallel/collision/ChCollision.h"
 #include "chrono_parallel/collision/ChCollisionSystemParallel.h"
+#include "chrono_parallel/solver/ChIterativeSolverParallel.h"
 
 using namespace chrono;
 using namespace collision;
@@ -66,6 +70,7 @@ ChSystemDistributed::ChSystemDistributed(MPI_Comm communicator, double ghostlaye
     comm = new ChCommDistributed(this);
 
     data_manager->system_timer.AddTimer("Exchange");
+    data_manager->system_timer.AddTimer("Balance");
 
     // Reserve starting space
     int init = maxobjects;  // / num_ranks;
@@ -112,24 +117,24 @@ ChSystemDistributed::~ChSystemDistributed() {
 }
 
 bool ChSystemDistributed::InSub(const ChVector<double>& pos) const {
-    int split_axis = domain->GetSplitAxis();
-
-    double pos_axis = pos[split_axis];
-    double lo = domain->sublo[split_axis];
-    double hi = domain->subhi[split_axis];
-
-    return (pos_axis >= lo - this->ghost_layer) && (pos_axis <= hi + this->ghost_layer);
+    return (domain->GetNeighborMask(pos) >> ChDomainDistributed::SELF_SLOT) & 1u;
 }
 
 bool ChSystemDistributed::Integrate_Y() {
     assert(domain->IsSplit());
     ddm->initial_add = false;
 
+    ChTimer<double> step_timer;
+    step_timer.start();
     bool ret = ChSystemParallelSMC::Integrate_Y();
+    step_timer.stop();
+
     if (num_ranks != 1) {
-        data_manager->system_timer.start("Exchange");
-        comm->Exchange();
-        data_manager->system_timer.stop("Exchange");
+        // Move the sub-domain boundaries (if needed). The affected bodies are migrated by the exchange at the beginning
+        // of the next step.
+        data_manager->system_timer.start("Balance");
+        domain->Balance(step_timer.GetTimeSeconds() - data_manager->system_timer.GetTime("Exchange"));
+        data_manager->system_timer.stop("Balance");
     }
 #ifdef DistrProfile
     PrintEfficiency();
@@ -137,6 +142,138 @@ bool ChSystemDistributed::Integrate_Y() {
     return ret;
 }
 
+void ChSystemDistributed::ContactStorage::Swap(ChParallelDataManager* dm) {
+    norm.swap(dm->host_data.norm_rigid_rigid);
+    cpta.swap(dm->host_data.cpta_rigid_rigid);
+    cptb.swap(dm->host_data.cptb_rigid_rigid);
+    dpth.swap(dm->host_data.dpth_rigid_rigid);
+    erad.swap(dm->host_data.erad_rigid_rigid);
+    bids.swap(dm->host_data.bids_rigid_rigid);
+    pairs.swap(dm->host_data.contact_pairs);
+}
+
+// Appends the entries of src with the given indices to dst.
+template <typename T>
+static void AppendContacts(custom_vector<T>& dst, const custom_vector<T>& src, const std::vector<uint>& indices) {
+    dst.reserve(dst.size() + indices.size());
+    for (auto i : indices)
+        dst.push_back(src[i]);
+}
+
+void ChSystemDistributed::RunCollisionDetection() {
+    if (num_ranks == 1) {
+        ChSystemParallelSMC::RunCollisionDetection();
+        return;
+    }
+
+    custom_vector<char>& collide = data_manager->host_data.collide_rigid;
+    const custom_vector<uint>& shape_body = data_manager->shape_data.id_rigid;
+
+    data_manager->system_timer.start("Exchange");
+    comm->PostExchange();
+    data_manager->system_timer.stop("Exchange");
+
+    // Bodies simulated by this rank. The exchange does not change their states, their collision shapes, or their local
+    // index; it only affects the ghosts and adds new ghosts.
+    uint num_bodies = data_manager->num_rigid_bodies;
+    std::vector<char> local(num_bodies);
+#pragma omp parallel for
+    for (int i = 0; i < (signed)num_bodies; i++) {
+        distributed::COMM_STATUS status = ddm->comm_status[i];
+        local[i] = status != distributed::EMPTY && status != distributed::GHOST_UP && status != distributed::GHOST_DOWN;
+    }
+
+    // 1. Contacts between local bodies, and their forces, while the exchange is in transit.
+#pragma omp parallel for
+    for (int i = 0; i < (signed)num_bodies; i++) {
+        collide[i] = collide[i] && local[i];
+    }
+    collision_system->Run();
+    collision_system->ReportContacts(contact_container.get());
+    std::static_pointer_cast<ChIterativeSolverParallelSMC>(solver)->PrecomputeContactForces();
+    uint num_local_contacts = data_manager->num_rigid_contacts;
+    local_contacts.Swap(data_manager);
+
+    // 2. Complete the exchange and load the new and updated ghosts (and the new number of bodies) in the data manager.
+    data_manager->system_timer.start("Exchange");
+    comm->CompleteExchange();
+    data_manager->system_timer.stop("Exchange");
+    Setup();
+    Update();
+
+    // 3. Contacts involving the bodies which were not local in the first pass (ghosts, including those that became
+    // local in the exchange). A local body takes part in this pass only if one of its shapes overlaps the bounding box
+    // of these bodies near one of the faces of this sub-domain. Contacts between two local bodies, already found in the
+    // first pass, are discarded.
+    auto deferred = [&](int i) { return i >= (signed)num_bodies || !local[i]; };
+
+    data_manager->aabb_generator->GenerateAABB();
+    const custom_vector<real3>& aabb_min = data_manager->host_data.aabb_min;
+    const custom_vector<real3>& aabb_max = data_manager->host_data.aabb_max;
+    const custom_vector<real3>& pos = data_manager->host_data.pos_rigid;
+
+    real3 face_min[6];
+    real3 face_max[6];
+    bool face_used[6] = {false, false, false, false, false, false};
+    for (uint s = 0; s < data_manager->num_rigid_shapes; s++) {
+        uint b = shape_body[s];
+        if (b == UINT_MAX || !collide[b] || !deferred(b))
+            continue;
+        int f = domain->GetClosestFace(ChVector<>(pos[b].x, pos[b].y, pos[b].z));
+        face_min[f] = face_used[f] ? Min(face_min[f], aabb_min[s]) : aabb_min[s];
+        face_max[f] = face_used[f] ? Max(face_max[f], aabb_max[s]) : aabb_max[s];
+        face_used[f] = true;
+    }
+
+    std::vector<uint> ghost_contacts;
+    if (std::find(face_used, face_used + 6, true) != face_used + 6) {
+        std::vector<char> near_ghosts(data_manager->num_rigid_bodies, 0);
+#pragma omp parallel for
+        for (int s = 0; s < (signed)data_manager->num_rigid_shapes; s++) {
+            uint b = shape_body[s];
+            if (b == UINT_MAX || deferred(b))
+                continue;
+            for (int f = 0; f < 6; f++) {
+                if (face_used[f] && aabb_min[s].x <= face_max[f].x && face_min[f].x <= aabb_max[s].x &&
+                    aabb_min[s].y <= face_max[f].y && face_min[f].y <= aabb_max[s].y &&
+                    aabb_min[s].z <= face_max[f].z && face_min[f].z <= aabb_max[s].z) {
+                    near_ghosts[b] = 1;
+                }
+            }
+        }
+
+        custom_vector<char> collide_all(collide);
+#pragma omp parallel for
+        for (int i = 0; i < (signed)data_manager->num_rigid_bodies; i++) {
+            collide[i] = collide[i] && (deferred(i) || near_ghosts[i]);
+        }
+        collision_system->Run();
+        collide.swap(collide_all);
+
+        const custom_vector<vec2>& bids = data_manager->host_data.bids_rigid_rigid;
+        for (uint k = 0; k < data_manager->num_rigid_contacts; k++) {
+            if (deferred(bids[k].x) || deferred(bids[k].y))
+                ghost_contacts.push_back(k);
+        }
+    }
+
+    // Append the contacts involving ghosts to the contacts between local bodies, whose forces were already calculated.
+    AppendContacts(local_contacts.norm, data_manager->host_data.norm_rigid_rigid, ghost_contacts);
+    AppendContacts(local_contacts.cpta, data_manager->host_data.cpta_rigid_rigid, ghost_contacts);
+    AppendContacts(local_contacts.cptb, data_manager->host_data.cptb_rigid_rigid, ghost_contacts);
+    AppendContacts(local_contacts.dpth, data_manager->host_data.dpth_rigid_rigid, ghost_contacts);
+    AppendContacts(local_contacts.erad, data_manager->host_data.erad_rigid_rigid, ghost_contacts);
+    AppendContacts(local_contacts.bids, data_manager->host_data.bids_rigid_rigid, ghost_contacts);
+    AppendContacts(local_contacts.pairs, data_manager->host_data.contact_pairs, ghost_contacts);
+    local_contacts.Swap(data_manager);
+    data_manager->num_rigid_contacts = num_local_contacts + (uint)ghost_contacts.size();
+
+    collision_system->ReportContacts(contact_container.get());
+    for (size_t ic = 0; ic < collision_callbacks.size(); ic++) {
+        collision_callbacks[ic]->OnCustomCollision(this);
+    }
+}
+
 void ChSystemDistributed::UpdateRigidBodies() {
     this->ChSystemParallel::UpdateRigidBodies();
 
@@ -191,15 +328,18 @@ void ChSystemDistributed::AddBody(std::shared_ptr<ChBody> newbody) {
     // Increment global body ID counter.
     num_bodies_global++;
 
+    // With load balancing, the sub-domains change during the simulation; keep fixed bodies on all ranks.
+    bool global = newbody->GetBodyFixed() && domain->IsLoadBalancing();
+
     // Add body on the rank whose sub-domain contains the current body position.
-    if (!InSub(newbody->GetPos())) {
+    if (!global && !InSub(newbody->GetPos())) {
         return;
     }
 
-    distributed::COMM_STATUS status = domain->GetBodyRegion(newbody);
+    distributed::COMM_STATUS status = global ? distributed::GLOBAL : domain->GetBodyRegion(newbody);
 
     // Check for collision with this sub-domain
-    if (newbody->GetBodyFixed()) {
+    if (newbody->GetBodyFixed() && !global) {
         ChVector<double> body_min;
         ChVector<double> body_max;
         ChVector<double> sublo(domain->GetSubLo());
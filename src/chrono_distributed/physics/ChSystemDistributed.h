@@ -80,7 +80,8 @@ class CH_DISTR_API ChSystemDistributed : public ChSystemParallelSMC {
     /// Return the current global number of bodies in the system.
     unsigned int GetNumBodiesGlobal() const { return num_bodies_global; }
 
-    /// Return true if pos is within this rank's sub-domain.
+    /// Return true if pos is within this rank's sub-domain, extended by the ghost layer on the faces shared with other
+    /// sub-domains.
     bool InSub(const ChVector<double>& pos) const;
 
     /// Create a new body, consistent with the contact method and collision model used by this system.
@@ -94,6 +95,10 @@ class CH_DISTR_API ChSystemDistributed : public ChSystemParallelSMC {
     /// Add a body to the system. 
     /// This function should be called *on all ranks*.
     /// AddBody classifies the body and decides whether or not to keep it on each rank.
+    /// A fixed body kept on a rank is made global (i.e., never exchanged) if its collision model overlaps the
+    /// sub-domain of the rank. With load balancing enabled (see ChDomainDistributed::SetLoadBalancing), the sub-domains
+    /// change during the simulation, and fixed bodies are instead made global on all ranks, regardless of their
+    /// location.
     virtual void AddBody(std::shared_ptr<ChBody> newbody) override;
 
     /// Add a body to the system on all ranks, regardless of its location.
@@ -106,10 +111,16 @@ class CH_DISTR_API ChSystemDistributed : public ChSystemParallelSMC {
     /// that the correct body is found and removed where it exists.
     virtual void RemoveBody(std::shared_ptr<ChBody> body) override;
 
-    /// Wraps the super-class Integrate_Y call and introduces a call that carries
-    /// out all inter-rank communication.
+    /// Wraps the super-class Integrate_Y call and rebalances the sub-domains (if enabled) after each step.
+    /// The inter-rank communication is carried out during the collision detection (see RunCollisionDetection).
     virtual bool Integrate_Y() override;
 
+    /// Exchanges bodies and ghost states with the neighbor ranks, overlapped with the collision detection.
+    /// The exchange is posted first; while it is in transit, the contacts between the bodies simulated by this rank
+    /// (i.e., all bodies except ghosts) are detected and their forces are calculated. Once the exchange is complete,
+    /// the contacts involving ghosts are detected, considering only the ghosts and the bodies close to them.
+    virtual void RunCollisionDetection() override;
+
     /// Wraps super-class UpdateRigidBodies and adds a gid update.
     virtual void UpdateRigidBodies() override;
 
@@ -246,6 +257,24 @@ class CH_DISTR_API ChSystemDistributed : public ChSystemParallelSMC {
     /// Type for internally sending contact forces
     MPI_Datatype InternalForceType;
 
+    /// Storage for the narrowphase output (see ChParallelDataManager), used to keep the contacts between local bodies
+    /// while the contacts involving ghosts are detected.
+    struct ContactStorage {
+        custom_vector<real3> norm;
+        custom_vector<real3> cpta;
+        custom_vector<real3> cptb;
+        custom_vector<real> dpth;
+        custom_vector<real> erad;
+        custom_vector<vec2> bids;
+        custom_vector<long long> pairs;
+
+        /// Exchange the contents of this storage with the narrowphase output in the data manager.
+        void Swap(ChParallelDataManager* dm);
+    };
+
+    /// Contacts between local bodies (see RunCollisionDetection).
+    ContactStorage local_contacts;
+
     friend class ChCommDistributed;
     friend class ChDomainDistributed;
 };
@@ -27,6 +27,7 @@
 
 // Chrono::Parallel headers
 #include "chrono_parallel/ChTimerParallel.h"
+#include "chrono_parallel/ChThreadTuner.h"
 #include "chrono_parallel/ChParallelDefines.h"
 #include "chrono_parallel/ChSettings.h"
 #include "chrono_parallel/ChMeasures.h"
@@ -465,6 +466,8 @@ class CH_PARALLEL_API ChParallelDataManager {
     bool Fc_current;
     /// This object hold all of the timers for the system.
     ChTimerParallel system_timer;
+    /// Per-phase thread configuration and autotuner.
+    ChThreadTuner thread_tuner;
     /// Structure that contains all settings for the system, collision detection and the solver.
     settings_container settings;
     measures_container measures;
@@ -45,6 +45,9 @@ class collision_measures {
         number_of_contacts_possible = 0;
         number_of_bins_active = 0;
         number_of_bin_intersections = 0;
+        number_of_pairs_reused = 0;
+        number_of_pairs_new = 0;
+        number_of_shapes_rebinned = 0;
 
         rigid_min_bounding_point = real3(0);
         rigid_max_bounding_point = real3(0);
@@ -69,6 +72,9 @@ class collision_measures {
     uint number_of_bins_active;        ///< Number of active bins (containing 1+ AABBs)
     uint number_of_bin_intersections;  ///< Number of AABB bin intersections
     uint number_of_contacts_possible;  ///< Number of contacts possible from broadphase
+    uint number_of_pairs_reused;       ///< Number of broadphase pairs reused from the pair cache
+    uint number_of_pairs_new;          ///< Number of broadphase pairs found by binning shapes
+    uint number_of_shapes_rebinned;    ///< Number of shapes rebinned since the last pair cache rebuild
 
     real3 rigid_min_bounding_point;
     real3 rigid_max_bounding_point;
@@ -95,6 +101,7 @@ class solver_measures {
   public:
     solver_measures() {
         total_iteration = 0;
+        refinement_iteration = 0;
         residual = 0;
         objective_value = 0;
 
@@ -106,6 +113,7 @@ class solver_measures {
         lambda_max = 0;
     }
     int total_iteration;       ///< The total number of iterations performed, this variable accumulates
+    int refinement_iteration;  ///< Number of full-precision refinement iterations (mixed-precision mode)
     real residual;             ///< Current residual for the solver
     real objective_value;      ///< Current objective value for the solver
     real old_objective_value;  ///< Objective value from the previous iter
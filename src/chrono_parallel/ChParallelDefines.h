@@ -144,6 +144,21 @@ enum class SystemType {
     SYSTEM_SMC   ///< system using smooth (penalty) contact
 };
 
+/// Enumeration of methods for accumulating the SMC contact forces on bodies.
+enum class ContactForceReduction {
+    SORT,      ///< sort the per-contact forces by body and reduce them
+    PARTITION  ///< bucket the per-contact forces by body (counting sort) and reduce each bucket
+};
+
+/// Enumeration of the simulation phases with a separately tuned number of OpenMP threads.
+enum class ThreadPhase {
+    BROADPHASE,          ///< AABB generation and broadphase collision detection
+    NARROWPHASE,         ///< narrowphase collision detection
+    SCHUR_PRODUCT,       ///< Schur complement products in the iterative solvers (NSC)
+    FORCE_ACCUMULATION,  ///< calculation and accumulation of contact forces (SMC)
+    NUM_PHASES           ///< number of phases (not a phase)
+};
+
 /// Enumeration for bilateral constraint types.
 enum BilateralType {
     BODY_BODY,          ///< constraints between two rigid bodies
@@ -55,6 +55,9 @@ class collision_settings {
         narrowphase_algorithm = NarrowPhaseType::NARROWPHASE_HYBRID_MPR;
         grid_density = 5;
         fixed_bins = true;
+        incremental_broadphase = false;
+        broadphase_skin = 0;
+        broadphase_rebuild_fraction = 0.1;
     }
 
     real3 min_bounding_point, max_bounding_point;
@@ -85,6 +88,18 @@ class collision_settings {
     real grid_density;
     /// Use fixed number of bins instead of tuning them.
     bool fixed_bins;
+    /// Use the incremental broadphase (only for systems with rigid shapes only).
+    /// In this mode, the shape AABBs are inflated by the broadphase skin and the list of pairs of overlapping
+    /// inflated AABBs is cached and reused at subsequent steps. Only shapes whose AABB moves outside of its inflated
+    /// AABB are rebinned. This is most effective for dense granular flows where the pair set changes little from step
+    /// to step.
+    bool incremental_broadphase;
+    /// Amount by which the shape AABBs are inflated in the incremental broadphase.
+    /// A value of the order of the distance travelled by a shape in a few steps is a good starting point (default: 0).
+    real broadphase_skin;
+    /// The grid and pair cache of the incremental broadphase are rebuilt when the fraction of shapes rebinned since the
+    /// last rebuild exceeds this value (default: 0.1).
+    real broadphase_rebuild_fraction;
 };
 
 /// Chrono::Parallel solver_settings.
@@ -122,6 +137,10 @@ class solver_settings {
         min_slip_vel = 1e-4;
         min_roll_vel = 1e-4;
         min_spin_vel = 1e-4;
+        contact_force_reduction = ContactForceReduction::SORT;
+        use_mixed_precision = false;
+        max_iteration_refinement = 20;
+        use_matrix_free = false;
         cache_step_length = false;
         precondition = false;
         use_power_iteration = false;
@@ -190,6 +209,29 @@ class solver_settings {
     real min_slip_vel;
     real min_roll_vel;
     real min_spin_vel;
+    /// Method for accumulating the SMC contact forces on bodies (default: SORT).
+    /// With PARTITION, the per-contact entries are bucketed by body with a parallel counting sort on the body IDs and
+    /// each body accumulates the forces in its bucket, which avoids sorting the per-contact forces. This is typically
+    /// faster for large numbers of contacts. It uses a scratch buffer of (number of threads x number of bodies)
+    /// integers. The two methods may produce results that differ by roundoff.
+    ContactForceReduction contact_force_reduction;
+    /// Use single-precision Schur products in the NSC solver (default: false).
+    /// The constraint matrices are copied to single precision once per step and the products with the full set of
+    /// constraints use these copies, while the right-hand side, the multipliers and the body states remain in the
+    /// precision of 'real'. Each solve is followed by refinement iterations with full-precision products (at most
+    /// max_iteration_refinement), so that the solver tolerance is evaluated with full-precision products.
+    /// This mode brings no benefit if Chrono::Parallel is built with single precision.
+    bool use_mixed_precision;
+    /// Maximum number of full-precision refinement iterations after each mixed-precision solve.
+    uint max_iteration_refinement;
+
+    /// Apply the Jacobian of the rigid contacts matrix-free in the NSC solver (default: false).
+    /// The contact rows of the constraint matrices are not assembled; the Schur products, the right-hand side, the
+    /// velocity update and the contact forces are evaluated directly from the contact normals, contact points and
+    /// body inverse mass matrices. Bilateral constraints are still assembled. This option is ignored (and the
+    /// constraint matrices fully assembled) if compute_N or update_rhs is set, with the Jacobi and Gauss-Seidel
+    /// solvers, or if the system contains fluid or FEA nodes. It takes precedence over use_mixed_precision.
+    bool use_matrix_free;
 
     /// Along with setting the solver mode, the total number of iterations for each
     /// type of constraints can be performed.
@@ -236,6 +278,7 @@ class settings_container {
         /// I don't really check to see if max_threads is > than min_threads
         /// not sure if that is a huge issue.
         perform_thread_tuning = ((min_threads == max_threads) ? false : true);
+        perform_phase_tuning = false;
         system_type = SystemType::SYSTEM_NSC;
         step_size = .01;
     }
@@ -251,6 +294,11 @@ class settings_container {
     /// it changes the number of threads, if not, it decreases the number of threads
     /// back to the original value.
     bool perform_thread_tuning;
+    /// If set to true, the number of threads of each phase (broadphase, narrowphase, Schur products, SMC force
+    /// accumulation) is tuned separately from measured phase times, within [min_threads, max_threads].
+    /// See ChThreadTuner (accessible through ChSystemParallel::GetThreadTuner) for details and for saving and
+    /// reloading a tuned configuration.
+    bool perform_phase_tuning;
     /// The minimum number of threads that will ever be used by this simulation.
     /// If you know a good number of threads for your simulation set the minimum so
     /// that the simulation is running optimally from the start.
@@ -0,0 +1,202 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2016 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Description: per-phase selection and online tuning of the number of OpenMP
+// threads used in Chrono::Parallel.
+//
+// =============================================================================
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "chrono/parallel/ChOpenMP.h"
+
+#include "chrono_parallel/ChThreadTuner.h"
+
+namespace chrono {
+
+// Maximum exponent for the wait after a rejected trial (wait = window * 2^backoff steps).
+static const int max_backoff = 6;
+
+static const char* phase_names[] = {"broadphase", "narrowphase", "schur_product", "force_accumulation"};
+
+ChThreadTuner::PhaseData::PhaseData()
+    : threads(0),
+      base_threads(0),
+      prev_threads(0),
+      direction(+1),
+      backoff(0),
+      wait(0),
+      window_steps(0),
+      window_time(0),
+      base_time(0),
+      last_time(0),
+      active(false) {
+    timer.reset();
+}
+
+void ChThreadTuner::PhaseData::Settle(int num_threads, int wait_steps) {
+    threads = num_threads;
+    base_threads = 0;
+    backoff = (num_threads > 0) ? max_backoff : 0;
+    wait = (num_threads > 0) ? wait_steps : 0;
+    window_steps = 0;
+    window_time = 0;
+}
+
+ChThreadTuner::ChThreadTuner() : window(10), hysteresis(0.05) {}
+
+const char* ChThreadTuner::GetPhaseName(ThreadPhase phase) {
+    return phase_names[Index(phase)];
+}
+
+void ChThreadTuner::SetNumThreads(ThreadPhase phase, int num_threads) {
+    PhaseData& data = phases[Index(phase)];
+    data.Settle(std::max(num_threads, 0), 0);
+    data.backoff = 0;
+}
+
+void ChThreadTuner::Begin(ThreadPhase phase) {
+    PhaseData& data = phases[Index(phase)];
+    data.active = true;
+    data.prev_threads = CHOMPfunctions::GetMaxThreads();
+    if (data.threads > 0 && data.threads != data.prev_threads)
+        CHOMPfunctions::SetNumThreads(data.threads);
+    data.timer.start();
+}
+
+void ChThreadTuner::End(ThreadPhase phase) {
+    PhaseData& data = phases[Index(phase)];
+    data.timer.stop();
+    if (data.threads > 0 && data.threads != data.prev_threads)
+        CHOMPfunctions::SetNumThreads(data.prev_threads);
+}
+
+void ChThreadTuner::Advance(bool tune, int min_threads, int max_threads) {
+    min_threads = std::max(min_threads, 1);
+    max_threads = std::max(max_threads, min_threads);
+
+    for (auto& data : phases) {
+        data.last_time = data.active ? data.timer.GetTimeSeconds() : 0;
+        data.timer.reset();
+        // Phases not executed in this step (e.g. no contacts) provide no measurement
+        if (tune && data.active)
+            Tune(data, min_threads, max_threads);
+        data.active = false;
+    }
+}
+
+void ChThreadTuner::Tune(PhaseData& data, int min_threads, int max_threads) {
+    // Start from the current OpenMP setting; restart if the allowed range changed
+    if (data.threads == 0)
+        data.threads = std::min(std::max(CHOMPfunctions::GetMaxThreads(), min_threads), max_threads);
+    if (data.threads < min_threads || data.threads > max_threads) {
+        data.Settle(std::min(std::max(data.threads, min_threads), max_threads), 0);
+        data.backoff = 0;
+    }
+
+    if (data.wait > 0) {
+        data.wait--;
+        return;
+    }
+
+    data.window_time += data.last_time;
+    data.window_steps++;
+    if (data.window_steps < window)
+        return;
+
+    double mean_time = data.window_time / data.window_steps;
+    data.window_time = 0;
+    data.window_steps = 0;
+
+    if (data.base_threads == 0) {
+        // Measured the accepted setting; start a trial in the current direction (or the other one, if at a bound)
+        data.base_time = mean_time;
+        int trial = data.direction > 0 ? std::min(2 * data.threads, max_threads)
+                                       : std::max(data.threads / 2, min_threads);
+        if (trial == data.threads) {
+            data.direction = -data.direction;
+            trial = data.direction > 0 ? std::min(2 * data.threads, max_threads)
+                                       : std::max(data.threads / 2, min_threads);
+        }
+        if (trial == data.threads) {
+            // Nothing to try (min_threads == max_threads)
+            data.backoff = max_backoff;
+            data.wait = window << max_backoff;
+            return;
+        }
+        data.base_threads = data.threads;
+        data.threads = trial;
+        return;
+    }
+
+    // Measured a trial setting; keep it only if it is clearly faster
+    if (mean_time < (1 - hysteresis) * data.base_time) {
+        data.backoff = 0;
+    } else {
+        data.threads = data.base_threads;
+        data.direction = -data.direction;
+        data.backoff = std::min(data.backoff + 1, max_backoff);
+        data.wait = window << data.backoff;
+    }
+    data.base_threads = 0;
+}
+
+bool ChThreadTuner::Save(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open())
+        return false;
+
+    // Save the accepted setting of phases running a trial
+    for (int i = 0; i < Index(ThreadPhase::NUM_PHASES); i++) {
+        const PhaseData& data = phases[i];
+        file << phase_names[i] << " " << (data.base_threads > 0 ? data.base_threads : data.threads) << "\n";
+    }
+
+    return file.good();
+}
+
+bool ChThreadTuner::Load(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open())
+        return false;
+
+    int threads[static_cast<int>(ThreadPhase::NUM_PHASES)];
+    for (int i = 0; i < Index(ThreadPhase::NUM_PHASES); i++)
+        threads[i] = phases[i].threads;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        std::string name;
+        int num_threads;
+        if (!(iss >> name) || name[0] == '#')
+            continue;
+        if (!(iss >> num_threads) || num_threads < 0)
+            return false;
+        auto phase = std::find_if(std::begin(phase_names), std::end(phase_names),
+                                  [&name](const char* phase_name) { return name == phase_name; });
+        if (phase == std::end(phase_names))
+            return false;
+        threads[phase - std::begin(phase_names)] = num_threads;
+    }
+
+    for (int i = 0; i < Index(ThreadPhase::NUM_PHASES); i++)
+        phases[i].Settle(threads[i], window << max_backoff);
+
+    return true;
+}
+
+}  // end namespace chrono
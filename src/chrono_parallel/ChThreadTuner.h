@@ -0,0 +1,134 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2016 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Description: per-phase selection and online tuning of the number of OpenMP
+// threads used in Chrono::Parallel.
+//
+// =============================================================================
+
+#pragma once
+
+#include <string>
+
+#include "chrono/core/ChTimer.h"
+
+#include "chrono_parallel/ChApiParallel.h"
+#include "chrono_parallel/ChParallelDefines.h"
+
+namespace chrono {
+
+/// @addtogroup parallel_module
+/// @{
+
+/// Per-phase thread configuration and autotuner for Chrono::Parallel.
+/// Each phase (see ThreadPhase) can run with its own number of OpenMP threads. A value of 0 (default) means that the
+/// phase uses the current OpenMP setting (e.g. as set by the global thread tuning).
+///
+/// If tuning is enabled, the number of threads of each phase is adjusted from the measured phase times:
+/// - the phase time at the current setting is averaged over a window of steps;
+/// - a trial setting (twice or half the current number of threads, alternating) is then measured over a window;
+/// - the trial setting is kept only if it reduces the phase time by more than the hysteresis fraction;
+/// - after each rejected trial, the wait before the next trial is doubled (up to a maximum), so that the
+///   configuration settles during long runs and is re-validated only occasionally.
+///
+/// A tuned configuration can be saved and reloaded at the beginning of a later run (see Save and Load). A loaded
+/// configuration is used as is if tuning is disabled, or as a settled starting point if tuning is enabled.
+class CH_PARALLEL_API ChThreadTuner {
+  public:
+    ChThreadTuner();
+
+    /// Set the number of steps over which phase times are averaged (default: 10).
+    void SetWindow(int num_steps) { window = num_steps; }
+
+    /// Set the minimum relative improvement for accepting a trial setting (default: 0.05).
+    void SetHysteresis(double fraction) { hysteresis = fraction; }
+
+    /// Set the number of threads for the specified phase (0: use current OpenMP setting).
+    /// This resets the tuning state for that phase.
+    void SetNumThreads(ThreadPhase phase, int num_threads);
+
+    /// Get the number of threads for the specified phase (0: use current OpenMP setting).
+    int GetNumThreads(ThreadPhase phase) const { return phases[Index(phase)].threads; }
+
+    /// Get the time (in seconds) spent in the specified phase during the last step.
+    double GetTime(ThreadPhase phase) const { return phases[Index(phase)].last_time; }
+
+    /// Return true if the specified phase is currently running a trial setting.
+    bool IsTrial(ThreadPhase phase) const { return phases[Index(phase)].base_threads > 0; }
+
+    /// Mark the beginning of the specified phase.
+    /// Sets the number of OpenMP threads for the phase (if specified) and starts the phase timer.
+    void Begin(ThreadPhase phase);
+
+    /// Mark the end of the specified phase.
+    /// Stops the phase timer and restores the previous number of OpenMP threads.
+    void End(ThreadPhase phase);
+
+    /// Collect the phase times of the current step and, if requested, update the tuning of all phases.
+    /// Called once at the end of each step. The tuned numbers of threads are kept in [min_threads, max_threads].
+    void Advance(bool tune, int min_threads, int max_threads);
+
+    /// Write the current configuration (one line "<phase name> <number of threads>" per phase) to the given file.
+    /// Return false if the file cannot be written.
+    bool Save(const std::string& filename) const;
+
+    /// Read a configuration written by Save.
+    /// Return false if the file cannot be read or contains an unknown phase name; in this case, the current
+    /// configuration is not modified.
+    bool Load(const std::string& filename);
+
+    /// Return the name of the specified phase (as used in configuration files).
+    static const char* GetPhaseName(ThreadPhase phase);
+
+    /// Utility class for scoping a phase: calls Begin at construction and End at destruction.
+    class Scope {
+      public:
+        Scope(ChThreadTuner& tuner, ThreadPhase phase) : m_tuner(tuner), m_phase(phase) { m_tuner.Begin(m_phase); }
+        ~Scope() { m_tuner.End(m_phase); }
+
+      private:
+        ChThreadTuner& m_tuner;
+        ThreadPhase m_phase;
+    };
+
+  private:
+    struct PhaseData {
+        PhaseData();
+        void Settle(int num_threads, int wait_steps);
+
+        int threads;          ///< current number of threads (0: not set)
+        int base_threads;     ///< accepted setting while a trial is measured (0: no trial)
+        int prev_threads;     ///< OpenMP setting to restore at the end of the phase
+        int direction;        ///< direction of the next trial (+1: more threads, -1: fewer threads)
+        int backoff;          ///< exponent of the wait after a rejected trial
+        int wait;             ///< steps to wait before resuming measurements
+        int window_steps;     ///< steps measured in the current window
+        double window_time;   ///< accumulated phase time over the current window
+        double base_time;     ///< average phase time at the accepted setting
+        double last_time;     ///< phase time in the last step
+        ChTimer<double> timer;  ///< phase timer (accumulates over the current step)
+        bool active;            ///< phase executed in the current step
+    };
+
+    static int Index(ThreadPhase phase) { return static_cast<int>(phase); }
+    void Tune(PhaseData& data, int min_threads, int max_threads);
+
+    int window;
+    double hysteresis;
+    PhaseData phases[static_cast<int>(ThreadPhase::NUM_PHASES)];
+};
+
+/// @} parallel_module
+
+}  // end namespace chrono
@@ -20,11 +20,13 @@
 #include "chrono_parallel/physics/Ch3DOFContainer.h"
 
 //#include <thrust/host_vector.h>
+#include <thrust/copy.h>
 #include <thrust/transform.h>
 #include <thrust/transform_reduce.h>
 #include <thrust/sort.h>
 #include <thrust/sequence.h>
 #include <thrust/iterator/constant_iterator.h>
+#include <thrust/iterator/counting_iterator.h>
 
 #if defined(CHRONO_OPENMP_ENABLED)
 #include <thrust/system/omp/execution_policy.h>
@@ -173,13 +175,35 @@ void ChCBroadphase::DetermineBoundingBox() {
         max_point = Max(max_point, data_manager->measures.collision.tet_max_bounding_point);
     }
 
-    // Inflate the overall bounding box by a small percentage.
-    // This takes care of corner cases where a degenerate object bounding box is on the
-    // boundary of the overall bounding box.
-    real fraction = 1e-3;
-    real3 size = max_point - min_point;
-    min_point = min_point - fraction * size;
-    max_point = max_point + fraction * size;
+    // For the incremental broadphase, the grid must contain the inflated AABBs.
+    // The cached grid is kept for as long as it contains all inflated AABBs.
+    bool keep_grid = false;
+    if (UseIncremental()) {
+        real skin = data_manager->settings.collision.broadphase_skin;
+        min_point = min_point - skin;
+        max_point = max_point + skin;
+        keep_grid = cache_valid &&                                                           //
+                    min_point.x >= cache_min_point.x && max_point.x <= cache_max_point.x &&  //
+                    min_point.y >= cache_min_point.y && max_point.y <= cache_max_point.y &&  //
+                    min_point.z >= cache_min_point.z && max_point.z <= cache_max_point.z;
+    }
+
+    if (keep_grid) {
+        min_point = cache_min_point;
+        max_point = cache_max_point;
+    } else {
+        // Inflate the overall bounding box by a small percentage.
+        // This takes care of corner cases where a degenerate object bounding box is on the
+        // boundary of the overall bounding box.
+        real fraction = 1e-3;
+        real3 size = max_point - min_point;
+        min_point = min_point - fraction * size;
+        max_point = max_point + fraction * size;
+
+        cache_valid = false;
+        cache_min_point = min_point;
+        cache_max_point = max_point;
+    }
 
     data_manager->measures.collision.min_bounding_point = min_point;
     data_manager->measures.collision.max_bounding_point = max_point;
@@ -232,7 +256,7 @@ void ChCBroadphase::ComputeTopLevelResolution() {
 }
 
 // =========================================================================================================
-ChCBroadphase::ChCBroadphase() {
+ChCBroadphase::ChCBroadphase() : cache_valid(false) {
     data_manager = 0;
 }
 // =========================================================================================================
@@ -240,21 +264,38 @@ ChCBroadphase::ChCBroadphase() {
 // let user define their own narrow-phase collision detection
 void ChCBroadphase::DispatchRigid() {
     if (data_manager->num_rigid_shapes != 0) {
-        OneLevelBroadphase();
+        if (UseIncremental())
+            IncrementalBroadphase();
+        else
+            OneLevelBroadphase();
         data_manager->num_rigid_contacts = data_manager->measures.collision.number_of_contacts_possible;
     }
     return;
 }
 
+bool ChCBroadphase::UseIncremental() const {
+    return data_manager->settings.collision.incremental_broadphase && data_manager->num_fluid_bodies == 0 &&
+           data_manager->num_fea_tets == 0;
+}
+
 void ChCBroadphase::OneLevelBroadphase() {
     LOG(TRACE) << "ChCBroadphase::OneLevelBroadphase()";
-    const custom_vector<real3>& aabb_min = data_manager->host_data.aabb_min;
-    const custom_vector<real3>& aabb_max = data_manager->host_data.aabb_max;
+    OneLevelBroadphase(data_manager->host_data.aabb_min, data_manager->host_data.aabb_max,
+                       data_manager->host_data.contact_pairs);
+
+    data_manager->measures.collision.number_of_pairs_reused = 0;
+    data_manager->measures.collision.number_of_pairs_new = data_manager->measures.collision.number_of_contacts_possible;
+    data_manager->measures.collision.number_of_shapes_rebinned = 0;
+    cache_valid = false;
+}
+
+void ChCBroadphase::OneLevelBroadphase(const custom_vector<real3>& aabb_min,
+                                       const custom_vector<real3>& aabb_max,
+                                       custom_vector<long long>& contact_pairs) {
     const custom_vector<short2>& fam_data = data_manager->shape_data.fam_rigid;
     const custom_vector<char>& obj_active = data_manager->host_data.active_rigid;
     const custom_vector<char>& obj_collide = data_manager->host_data.collide_rigid;
     const custom_vector<uint>& obj_data_id = data_manager->shape_data.id_rigid;
-    custom_vector<long long>& contact_pairs = data_manager->host_data.contact_pairs;
 
     custom_vector<uint>& bin_intersections = data_manager->host_data.bin_intersections;
     custom_vector<uint>& bin_number = data_manager->host_data.bin_number;
@@ -306,6 +347,7 @@ void ChCBroadphase::OneLevelBroadphase() {
 
     if (number_of_bins_active <= 0) {
         number_of_contacts_possible = 0;
+        contact_pairs.clear();
         return;
     }
 
@@ -341,5 +383,336 @@ void ChCBroadphase::OneLevelBroadphase() {
     LOG(TRACE) << "Number of unique collisions: " << number_of_contacts_possible;
 }
 
+// Incremental broadphase ==================================================================================
+
+// Predicate for the cached pairs that can be reused: pairs of shapes that were not rebinned since the last rebuild and
+// with overlapping AABBs.
+struct PairReuse {
+    PairReuse(const custom_vector<char>* rebinned,
+              const custom_vector<real3>* aabb_min,
+              const custom_vector<real3>* aabb_max)
+        : m_rebinned(rebinned), m_aabb_min(aabb_min), m_aabb_max(aabb_max) {}
+    bool operator()(const long long pair) const {
+        uint shapeA = uint(pair >> 32);
+        uint shapeB = uint(pair & 0xffffffff);
+        return !(*m_rebinned)[shapeA] && !(*m_rebinned)[shapeB] &&
+               overlap((*m_aabb_min)[shapeA], (*m_aabb_max)[shapeA], (*m_aabb_min)[shapeB], (*m_aabb_max)[shapeB]);
+    }
+    const custom_vector<char>* m_rebinned;
+    const custom_vector<real3>* m_aabb_min;
+    const custom_vector<real3>* m_aabb_max;
+};
+
+// Count (if pairs is NULL) or store the pairs between the given rebinned shape and the shapes in a grid.
+// The grid is described by its sorted active bins, the (local) indices of the shapes in each bin, and the AABBs used to
+// bin these shapes. If shape_map is provided, the grid contains rebinned shapes (and local indices are mapped to
+// global shape indices); only pairs with shapeA < shapeB are then considered. Otherwise, the grid is the cached grid
+// and rebinned shapes in it are ignored. A pair is reported only once, for the bin containing the lower corner of the
+// intersection of the current AABB of the rebinned shape and the binned AABB of the other shape.
+static uint f_Grid_AABB_Intersection(const uint shapeA,
+                                     const real3& inv_bin_size,
+                                     const vec3& bins_per_axis,
+                                     const custom_vector<real3>& aabb_min,
+                                     const custom_vector<real3>& aabb_max,
+                                     const custom_vector<real3>& grid_aabb_min,
+                                     const custom_vector<real3>& grid_aabb_max,
+                                     const custom_vector<uint>& bin_number,
+                                     const uint num_bins,
+                                     const custom_vector<uint>& bin_aabb_number,
+                                     const custom_vector<uint>& bin_start_index,
+                                     const uint* shape_map,
+                                     const custom_vector<char>& rebinned,
+                                     const custom_vector<short2>& fam_data,
+                                     const custom_vector<char>& body_active,
+                                     const custom_vector<char>& body_collide,
+                                     const custom_vector<uint>& body_id,
+                                     long long* pairs) {
+    real3 Amin = aabb_min[shapeA];
+    real3 Amax = aabb_max[shapeA];
+    short2 famA = fam_data[shapeA];
+    uint bodyA = body_id[shapeA];
+
+    vec3 max_clamp = bins_per_axis - vec3(1);
+    vec3 gmin = Clamp(HashMin(Amin, inv_bin_size), vec3(0), max_clamp);
+    vec3 gmax = Clamp(HashMax(Amax, inv_bin_size), vec3(0), max_clamp);
+
+    auto bins_begin = bin_number.begin();
+    auto bins_end = bin_number.begin() + num_bins;
+
+    uint count = 0;
+    for (int i = gmin.x; i <= gmax.x; i++) {
+        for (int j = gmin.y; j <= gmax.y; j++) {
+            for (int k = gmin.z; k <= gmax.z; k++) {
+                uint hash = Hash_Index(vec3(i, j, k), bins_per_axis);
+                auto bin = std::lower_bound(bins_begin, bins_end, hash);
+                if (bin == bins_end || *bin != hash)
+                    continue;
+                uint index = (uint)(bin - bins_begin);
+                for (uint e = bin_start_index[index]; e < bin_start_index[index + 1]; e++) {
+                    uint local = bin_aabb_number[e];
+                    uint shapeB = shape_map ? shape_map[local] : local;
+                    if (shape_map ? shapeB <= shapeA : rebinned[shapeB] != 0)
+                        continue;
+                    uint bodyB = body_id[shapeB];
+                    if (bodyB == UINT_MAX)
+                        continue;
+                    if (bodyA == bodyB)
+                        continue;
+                    if (body_collide[bodyB] == 0)
+                        continue;
+                    if (!body_active[bodyA] && !body_active[bodyB])
+                        continue;
+                    if (!collide(famA, fam_data[shapeB]))
+                        continue;
+                    if (!overlap(Amin, Amax, aabb_min[shapeB], aabb_max[shapeB]))
+                        continue;
+                    if (!current_bin(Amin, Amax, grid_aabb_min[local], grid_aabb_max[local], inv_bin_size,
+                                     bins_per_axis, hash))
+                        continue;
+                    if (pairs) {
+                        pairs[count] = shapeA < shapeB ? ((long long)shapeA << 32 | (long long)shapeB)
+                                                       : ((long long)shapeB << 32 | (long long)shapeA);
+                    }
+                    count++;
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+void ChCBroadphase::IncrementalBroadphase() {
+    LOG(TRACE) << "ChCBroadphase::IncrementalBroadphase()";
+    const custom_vector<real3>& aabb_min = data_manager->host_data.aabb_min;
+    const custom_vector<real3>& aabb_max = data_manager->host_data.aabb_max;
+    const custom_vector<char>& obj_collide = data_manager->host_data.collide_rigid;
+    const custom_vector<uint>& obj_data_id = data_manager->shape_data.id_rigid;
+    custom_vector<long long>& contact_pairs = data_manager->host_data.contact_pairs;
+
+    const int num_shapes = data_manager->num_rigid_shapes;
+    const real skin = data_manager->settings.collision.broadphase_skin;
+    const real rebuild_fraction = data_manager->settings.collision.broadphase_rebuild_fraction;
+
+    collision_measures& measures = data_manager->measures.collision;
+
+    bool rebuild = !cache_valid || !CheckCache();
+
+    if (!rebuild) {
+        // Rebin the shapes whose current AABB is not contained in their inflated AABB.
+#pragma omp parallel for
+        for (int i = 0; i < num_shapes; i++) {
+            uint id = obj_data_id[i];
+            if (id == UINT_MAX || obj_collide[id] == 0)
+                continue;
+            const real3& Amin = aabb_min[i];
+            const real3& Amax = aabb_max[i];
+            const real3& Fmin = fat_aabb_min[i];
+            const real3& Fmax = fat_aabb_max[i];
+            if (Amin.x < Fmin.x || Amin.y < Fmin.y || Amin.z < Fmin.z ||  //
+                Amax.x > Fmax.x || Amax.y > Fmax.y || Amax.z > Fmax.z) {
+                fat_aabb_min[i] = Amin - skin;
+                fat_aabb_max[i] = Amax + skin;
+                rebinned[i] = 1;
+            }
+        }
+
+        uint num_rebinned = (uint)Thrust_Count(rebinned, 1);
+        rebuild = num_rebinned > rebuild_fraction * num_shapes;
+        if (!rebuild) {
+            rebinned_list.resize(num_rebinned);
+            thrust::copy_if(THRUST_PAR thrust::counting_iterator<uint>(0), thrust::counting_iterator<uint>(num_shapes),
+                            rebinned.begin(), rebinned_list.begin(), thrust::identity<char>());
+        }
+    }
+
+    if (rebuild) {
+        RebuildCache();
+        contact_pairs.resize(cache_pairs.size());
+        auto end = thrust::copy_if(THRUST_PAR cache_pairs.begin(), cache_pairs.end(), contact_pairs.begin(),
+                                   PairReuse(&rebinned, &aabb_min, &aabb_max));
+        contact_pairs.resize(end - contact_pairs.begin());
+
+        measures.number_of_pairs_reused = 0;
+        measures.number_of_pairs_new = (uint)contact_pairs.size();
+        measures.number_of_shapes_rebinned = num_shapes;
+    } else {
+        // Reuse the cached pairs of shapes that were not rebinned and find all pairs involving rebinned shapes.
+        custom_vector<long long> new_pairs;
+        FindRebinnedPairs(new_pairs);
+
+        contact_pairs.resize(cache_pairs.size() + new_pairs.size());
+        auto end = thrust::copy_if(THRUST_PAR cache_pairs.begin(), cache_pairs.end(), contact_pairs.begin(),
+                                   PairReuse(&rebinned, &aabb_min, &aabb_max));
+        uint num_reused = (uint)(end - contact_pairs.begin());
+        thrust::copy(THRUST_PAR new_pairs.begin(), new_pairs.end(), end);
+        contact_pairs.resize(num_reused + new_pairs.size());
+
+        measures.number_of_pairs_reused = num_reused;
+        measures.number_of_pairs_new = (uint)new_pairs.size();
+        measures.number_of_shapes_rebinned = (uint)rebinned_list.size();
+    }
+
+    measures.number_of_contacts_possible = (uint)contact_pairs.size();
+    LOG(TRACE) << "Number of possible collisions: " << measures.number_of_contacts_possible << " (reused "
+               << measures.number_of_pairs_reused << ", new " << measures.number_of_pairs_new << ")";
+}
+
+bool ChCBroadphase::CheckCache() {
+    const custom_vector<short2>& fam_data = data_manager->shape_data.fam_rigid;
+    const custom_vector<uint>& obj_data_id = data_manager->shape_data.id_rigid;
+    const custom_vector<char>& obj_active = data_manager->host_data.active_rigid;
+    const custom_vector<char>& obj_collide = data_manager->host_data.collide_rigid;
+    const vec3& bins_per_axis = data_manager->settings.collision.bins_per_axis;
+
+    const int num_shapes = data_manager->num_rigid_shapes;
+    const int num_bodies = (int)obj_active.size();
+
+    if ((int)cache_id.size() != num_shapes || (int)cache_active.size() != num_bodies)
+        return false;
+    if (bins_per_axis.x != cache_bins_per_axis.x || bins_per_axis.y != cache_bins_per_axis.y ||
+        bins_per_axis.z != cache_bins_per_axis.z)
+        return false;
+
+    // The cached pairs remain valid only if the data used in filtering pairs did not change.
+    bool valid = true;
+#pragma omp parallel for reduction(&& : valid)
+    for (int i = 0; i < num_shapes; i++) {
+        valid = valid && obj_data_id[i] == cache_id[i] && fam_data[i].x == cache_fam[i].x &&
+                fam_data[i].y == cache_fam[i].y;
+    }
+#pragma omp parallel for reduction(&& : valid)
+    for (int i = 0; i < num_bodies; i++) {
+        valid = valid && obj_active[i] == cache_active[i] && obj_collide[i] == cache_collide[i];
+    }
+
+    return valid;
+}
+
+void ChCBroadphase::RebuildCache() {
+    LOG(TRACE) << "ChCBroadphase::RebuildCache()";
+    const custom_vector<real3>& aabb_min = data_manager->host_data.aabb_min;
+    const custom_vector<real3>& aabb_max = data_manager->host_data.aabb_max;
+
+    const int num_shapes = data_manager->num_rigid_shapes;
+    const real skin = data_manager->settings.collision.broadphase_skin;
+
+    fat_aabb_min.resize(num_shapes);
+    fat_aabb_max.resize(num_shapes);
+#pragma omp parallel for
+    for (int i = 0; i < num_shapes; i++) {
+        fat_aabb_min[i] = aabb_min[i] - skin;
+        fat_aabb_max[i] = aabb_max[i] + skin;
+    }
+
+    // Bin the inflated AABBs and find all pairs of overlapping inflated AABBs.
+    // The bins stored in the data manager are kept (and used to process rebinned shapes) until the next rebuild.
+    OneLevelBroadphase(fat_aabb_min, fat_aabb_max, cache_pairs);
+
+    rebinned.assign(num_shapes, 0);
+    rebinned_list.clear();
+
+    cache_id = data_manager->shape_data.id_rigid;
+    cache_fam = data_manager->shape_data.fam_rigid;
+    cache_active = data_manager->host_data.active_rigid;
+    cache_collide = data_manager->host_data.collide_rigid;
+    cache_bins_per_axis = data_manager->settings.collision.bins_per_axis;
+    cache_valid = true;
+}
+
+void ChCBroadphase::FindRebinnedPairs(custom_vector<long long>& pairs) {
+    const custom_vector<real3>& aabb_min = data_manager->host_data.aabb_min;
+    const custom_vector<real3>& aabb_max = data_manager->host_data.aabb_max;
+    const custom_vector<short2>& fam_data = data_manager->shape_data.fam_rigid;
+    const custom_vector<char>& obj_active = data_manager->host_data.active_rigid;
+    const custom_vector<char>& obj_collide = data_manager->host_data.collide_rigid;
+    const custom_vector<uint>& obj_data_id = data_manager->shape_data.id_rigid;
+
+    // Cached grid (inflated AABBs at the last rebuild)
+    const custom_vector<uint>& bin_number_out = data_manager->host_data.bin_number_out;
+    const custom_vector<uint>& bin_aabb_number = data_manager->host_data.bin_aabb_number;
+    const custom_vector<uint>& bin_start_index = data_manager->host_data.bin_start_index;
+    const uint number_of_bins_active = data_manager->measures.collision.number_of_bins_active;
+
+    const vec3& bins_per_axis = data_manager->settings.collision.bins_per_axis;
+    const real3& inv_bin_size = data_manager->measures.collision.inv_bin_size;
+
+    const uint num_rebinned = (uint)rebinned_list.size();
+
+    pairs.clear();
+    if (num_rebinned == 0)
+        return;
+
+    // Bin the current AABBs of the rebinned shapes
+    custom_vector<real3> rb_aabb_min(num_rebinned);
+    custom_vector<real3> rb_aabb_max(num_rebinned);
+#pragma omp parallel for
+    for (int i = 0; i < (signed)num_rebinned; i++) {
+        rb_aabb_min[i] = aabb_min[rebinned_list[i]];
+        rb_aabb_max[i] = aabb_max[rebinned_list[i]];
+    }
+
+    custom_vector<uint> rb_bin_intersections(num_rebinned + 1);
+    rb_bin_intersections[num_rebinned] = 0;
+#pragma omp parallel for
+    for (int i = 0; i < (signed)num_rebinned; i++) {
+        f_Count_AABB_BIN_Intersection(i, inv_bin_size, rb_aabb_min, rb_aabb_max, rb_bin_intersections);
+    }
+
+    Thrust_Exclusive_Scan(rb_bin_intersections);
+    uint rb_number_of_bin_intersections = rb_bin_intersections.back();
+
+    custom_vector<uint> rb_bin_number(rb_number_of_bin_intersections);
+    custom_vector<uint> rb_bin_number_out(rb_number_of_bin_intersections);
+    custom_vector<uint> rb_bin_aabb_number(rb_number_of_bin_intersections);
+    custom_vector<uint> rb_bin_start_index(rb_number_of_bin_intersections);
+
+#pragma omp parallel for
+    for (int i = 0; i < (signed)num_rebinned; i++) {
+        f_Store_AABB_BIN_Intersection(i, bins_per_axis, inv_bin_size, rb_aabb_min, rb_aabb_max, rb_bin_intersections,
+                                      rb_bin_number, rb_bin_aabb_number);
+    }
+
+    Thrust_Sort_By_Key(rb_bin_number, rb_bin_aabb_number);
+    uint rb_number_of_bins_active = (uint)(Run_Length_Encode(rb_bin_number, rb_bin_number_out, rb_bin_start_index));
+
+    rb_bin_start_index.resize(rb_number_of_bins_active + 1);
+    rb_bin_start_index[rb_number_of_bins_active] = 0;
+    Thrust_Exclusive_Scan(rb_bin_start_index);
+
+    // Count and store, for each rebinned shape, the pairs with shapes in the cached grid and in the rebinned grid
+    custom_vector<uint> num_pairs(num_rebinned + 1);
+    num_pairs[num_rebinned] = 0;
+
+#pragma omp parallel for
+    for (int i = 0; i < (signed)num_rebinned; i++) {
+        uint shape = rebinned_list[i];
+        num_pairs[i] = f_Grid_AABB_Intersection(shape, inv_bin_size, bins_per_axis, aabb_min, aabb_max, fat_aabb_min,
+                                                fat_aabb_max, bin_number_out, number_of_bins_active, bin_aabb_number,
+                                                bin_start_index, NULL, rebinned, fam_data, obj_active, obj_collide,
+                                                obj_data_id, NULL) +
+                       f_Grid_AABB_Intersection(shape, inv_bin_size, bins_per_axis, aabb_min, aabb_max, rb_aabb_min,
+                                                rb_aabb_max, rb_bin_number_out, rb_number_of_bins_active,
+                                                rb_bin_aabb_number, rb_bin_start_index, rebinned_list.data(), rebinned,
+                                                fam_data, obj_active, obj_collide, obj_data_id, NULL);
+    }
+
+    Thrust_Exclusive_Scan(num_pairs);
+    pairs.resize(num_pairs.back());
+
+#pragma omp parallel for
+    for (int i = 0; i < (signed)num_rebinned; i++) {
+        uint shape = rebinned_list[i];
+        long long* out = pairs.data() + num_pairs[i];
+        out += f_Grid_AABB_Intersection(shape, inv_bin_size, bins_per_axis, aabb_min, aabb_max, fat_aabb_min,
+                                        fat_aabb_max, bin_number_out, number_of_bins_active, bin_aabb_number,
+                                        bin_start_index, NULL, rebinned, fam_data, obj_active, obj_collide, obj_data_id,
+                                        out);
+        f_Grid_AABB_Intersection(shape, inv_bin_size, bins_per_axis, aabb_min, aabb_max, rb_aabb_min, rb_aabb_max,
+                                 rb_bin_number_out, rb_number_of_bins_active, rb_bin_aabb_number, rb_bin_start_index,
+                                 rebinned_list.data(), rebinned, fam_data, obj_active, obj_collide, obj_data_id, out);
+    }
+}
+
 } // end namespace collision
 } // end namespace chrono
@@ -42,11 +42,15 @@ class CH_PARALLEL_API ChCAABBGenerator {
 };
 
 /// Class for performing broad-phase collision detection.
+/// If enabled in the collision settings (and only for systems without fluid or FEA tetrahedral elements), the rigid
+/// shapes are processed incrementally: the grid and the list of pairs of overlapping inflated AABBs are cached, and
+/// only the shapes whose AABB moved outside its inflated AABB are rebinned at subsequent steps.
 class CH_PARALLEL_API ChCBroadphase {
   public:
     ChCBroadphase();
     void DispatchRigid();
     void OneLevelBroadphase();
+    void IncrementalBroadphase();
     void DetermineBoundingBox();
     void OffsetAABB();
     void ComputeTopLevelResolution();
@@ -56,6 +60,36 @@ class CH_PARALLEL_API ChCBroadphase {
     ChParallelDataManager* data_manager;
 
   private:
+    /// Return true if the incremental broadphase can be used for the current system.
+    bool UseIncremental() const;
+
+    /// Find all pairs of overlapping AABBs with the one-level grid.
+    void OneLevelBroadphase(const custom_vector<real3>& aabb_min,
+                            const custom_vector<real3>& aabb_max,
+                            custom_vector<long long>& pairs);
+
+    /// Check whether the cached pairs are still consistent with the current shape and body data.
+    bool CheckCache();
+
+    /// Rebuild the grid and the pair cache from the inflated AABBs of all shapes.
+    void RebuildCache();
+
+    /// Find all pairs involving rebinned shapes.
+    void FindRebinnedPairs(custom_vector<long long>& pairs);
+
+    bool cache_valid;                      ///< cached grid and pairs are valid
+    real3 cache_min_point;                 ///< cached grid lower corner
+    real3 cache_max_point;                 ///< cached grid upper corner
+    vec3 cache_bins_per_axis;              ///< cached grid resolution
+    custom_vector<real3> fat_aabb_min;     ///< inflated AABBs (lower corners)
+    custom_vector<real3> fat_aabb_max;     ///< inflated AABBs (upper corners)
+    custom_vector<char> rebinned;          ///< flags for shapes rebinned since the last rebuild
+    custom_vector<uint> rebinned_list;     ///< list of shapes rebinned since the last rebuild
+    custom_vector<long long> cache_pairs;  ///< pairs of overlapping inflated AABBs at the last rebuild
+    custom_vector<uint> cache_id;          ///< shape body IDs at the last rebuild
+    custom_vector<short2> cache_fam;       ///< shape families at the last rebuild
+    custom_vector<char> cache_active;      ///< body active flags at the last rebuild
+    custom_vector<char> cache_collide;     ///< body collide flags at the last rebuild
 };
 
 /// Class for performing narrow-phase collision detection.
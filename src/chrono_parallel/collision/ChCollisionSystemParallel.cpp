@@ -225,6 +225,7 @@ void ChCollisionSystemParallel::Run() {
         }
     }
     data_manager->system_timer.start("collision_broad");
+    data_manager->thread_tuner.Begin(ThreadPhase::BROADPHASE);
     data_manager->aabb_generator->GenerateAABB();
 
     // Compute the bounding box of things
@@ -234,9 +235,11 @@ void ChCollisionSystemParallel::Run() {
     // Everything is offset and ready to go!
     data_manager->broadphase->DispatchRigid();
 
+    data_manager->thread_tuner.End(ThreadPhase::BROADPHASE);
     data_manager->system_timer.stop("collision_broad");
 
     data_manager->system_timer.start("collision_narrow");
+    data_manager->thread_tuner.Begin(ThreadPhase::NARROWPHASE);
     if (data_manager->num_fluid_bodies != 0) {
         data_manager->narrowphase->DispatchFluid();
     }
@@ -253,6 +256,7 @@ void ChCollisionSystemParallel::Run() {
         data_manager->num_rigid_fluid_contacts = 0;
     }
 
+    data_manager->thread_tuner.End(ThreadPhase::NARROWPHASE);
     data_manager->system_timer.stop("collision_narrow");
 }
 
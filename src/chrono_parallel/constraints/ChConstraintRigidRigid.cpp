@@ -30,7 +30,7 @@ using namespace chrono;
 // -----------------------------------------------------------------------------
 
 ChConstraintRigidRigid::ChConstraintRigidRigid()
-    : data_manager(nullptr), offset(3), inv_h(0), inv_hpa(0), inv_hhpa(0) {}
+    : data_manager(nullptr), offset(3), matrix_free(false), inv_h(0), inv_hpa(0), inv_hhpa(0) {}
 
 void ChConstraintRigidRigid::func_Project_normal(int index, const vec2* ids, const real* cohesion, real* gamma) {
     real gamma_x = gamma[index * 1 + 0];
@@ -174,6 +174,26 @@ void ChConstraintRigidRigid::Setup(ChParallelDataManager* dm) {
     inv_hpa = 1 / (data_manager->settings.step_size + data_manager->settings.solver.alpha);
     inv_hhpa = inv_h * inv_hpa;
 
+    if (matrix_free) {
+        // Lists of contacts for each body, in increasing order of contact index
+        const auto& bids = data_manager->host_data.bids_rigid_rigid;
+        uint num_bodies = data_manager->num_rigid_bodies;
+        body_contact_start.assign(num_bodies + 1, 0);
+        for (uint i = 0; i < num_contacts; i++) {
+            body_contact_start[bids[i].x + 1]++;
+            body_contact_start[bids[i].y + 1]++;
+        }
+        for (uint b = 0; b < num_bodies; b++) {
+            body_contact_start[b + 1] += body_contact_start[b];
+        }
+        custom_vector<uint> next(body_contact_start.begin(), body_contact_start.end() - 1);
+        body_contacts.resize(2 * num_contacts);
+        for (uint i = 0; i < num_contacts; i++) {
+            body_contacts[next[bids[i].x]++] = 2 * i + 0;
+            body_contacts[next[bids[i].y]++] = 2 * i + 1;
+        }
+    }
+
     if (num_contacts <= 0) {
         return;
     }
@@ -396,6 +416,10 @@ void ChConstraintRigidRigid::Build_E() {
 
 void ChConstraintRigidRigid::Build_D() {
     LOG(INFO) << "ChConstraintRigidRigid::Build_D";
+    if (matrix_free) {
+        return;
+    }
+
     real3* norm = data_manager->host_data.norm_rigid_rigid.data();
     real3* ptA = data_manager->host_data.cpta_rigid_rigid.data();
     real3* ptB = data_manager->host_data.cptb_rigid_rigid.data();
@@ -468,6 +492,14 @@ void ChConstraintRigidRigid::GenerateSparsity() {
 
     CompressedMatrix<real>& D_T = data_manager->host_data.D_T;
 
+    if (matrix_free) {
+        // The contact rows are left empty
+        for (uint row = 0; row < data_manager->num_unilaterals; row++) {
+            D_T.finalize(row);
+        }
+        return;
+    }
+
     const vec2* ids = data_manager->host_data.bids_rigid_rigid.data();
 
     for (int index = 0; index < (signed)data_manager->num_rigid_contacts; index++) {
@@ -537,154 +569,134 @@ void ChConstraintRigidRigid::GenerateSparsity() {
     }
 }
 
-void ChConstraintRigidRigid::Dx(const DynamicVector<real>& gam, DynamicVector<real>& XYZUVW) {
-    const int& num_rigid_contacts = data_manager->num_rigid_contacts;
-    custom_vector<char>& active_rigid = data_manager->host_data.active_rigid;
-    real3* norm = data_manager->host_data.norm_rigid_rigid.data();
-    real3* ptA = data_manager->host_data.cpta_rigid_rigid.data();
-    real3* ptB = data_manager->host_data.cptb_rigid_rigid.data();
-    real3* pos = data_manager->host_data.pos_rigid.data();
-    vec2* bids_rigid_rigid = data_manager->host_data.bids_rigid_rigid.data();
-    quaternion* rot = data_manager->host_data.rot_rigid.data();
+void ChConstraintRigidRigid::BodyDx(int body,
+                                    const DynamicVector<real>& x,
+                                    SolverMode mode,
+                                    real3& force,
+                                    real3& torque) const {
+    const real3* norm = data_manager->host_data.norm_rigid_rigid.data();
+    uint num_contacts = data_manager->num_rigid_contacts;
 
-#pragma omp parallel for
-    for (int i = 0; i < num_rigid_contacts; i++) {
-        real3 U = real3(norm[i]), V, W;
+    force = real3(0);
+    torque = real3(0);
+
+    for (uint k = body_contact_start[body]; k < body_contact_start[body + 1]; k++) {
+        uint i = body_contacts[k] >> 1;
+        bool side_b = (body_contacts[k] & 1) != 0;
+        const real3_int& sbar = side_b ? rotated_point_b[i] : rotated_point_a[i];
+        const quaternion& q = side_b ? quat_b[i] : quat_a[i];
+
+        real3 U = norm[i], V, W;
         Orthogonalize(U, V, W);
-        // int id_a = bids_rigid_rigid[i].x;
-        // int id_b = bids_rigid_rigid[i].y;
 
-        real3 T3, T4, T5, T6, T7, T8;
-        real3 g = real3(gam[i], gam[num_rigid_contacts + i * 2 + 0], gam[num_rigid_contacts + i * 2 + 1]);
-        {
-            real3_int sbar = rotated_point_a[i];
-            quaternion q_a = quat_a[i];
-            T3 = Cross(Rotate(U, q_a), sbar.v);
-            T4 = Cross(Rotate(V, q_a), sbar.v);
-            T5 = Cross(Rotate(W, q_a), sbar.v);
-
-            // if (active_rigid[id_a] != 0)
-
-            real3 res = -U * g.x - V * g.y - W * g.z;
-
-#pragma omp atomic
-            XYZUVW[sbar.i * 6 + 0] += res.x;
-#pragma omp atomic
-            XYZUVW[sbar.i * 6 + 1] += res.y;
-#pragma omp atomic
-            XYZUVW[sbar.i * 6 + 2] += res.z;
-
-            res = T3 * g.x + T4 * g.y + T5 * g.z;
-
-#pragma omp atomic
-            XYZUVW[sbar.i * 6 + 3] += res.x;
-#pragma omp atomic
-            XYZUVW[sbar.i * 6 + 4] += res.y;
-#pragma omp atomic
-            XYZUVW[sbar.i * 6 + 5] += res.z;
+        // Contact impulse (world frame) and its moment about the body center (body frame).
+        // The impulse acts with a positive sign on body B and with a negative sign on body A.
+        real3 impulse = U * x[i];
+        if (mode == SolverMode::SLIDING || mode == SolverMode::SPINNING) {
+            impulse += V * x[num_contacts + i * 2 + 0] + W * x[num_contacts + i * 2 + 1];
         }
+        real3 moment = Cross(Rotate(impulse, q), sbar.v);
 
-        {
-            real3_int sbar = rotated_point_b[i];
-            quaternion q_b = quat_b[i];
-            T6 = Cross(Rotate(U, q_b), sbar.v);
-            T7 = Cross(Rotate(V, q_b), sbar.v);
-            T8 = Cross(Rotate(W, q_b), sbar.v);
-
-            // if (active_rigid[id_b] != 0)
-
-            real3 res = U * g.x + V * g.y + W * g.z;
-
-#pragma omp atomic
-            XYZUVW[sbar.i * 6 + 0] += res.x;
-#pragma omp atomic
-            XYZUVW[sbar.i * 6 + 1] += res.y;
-#pragma omp atomic
-            XYZUVW[sbar.i * 6 + 2] += res.z;
-
-            res = -T6 * g.x - T7 * g.y - T8 * g.z;
-
-#pragma omp atomic
-            XYZUVW[sbar.i * 6 + 3] += res.x;
-#pragma omp atomic
-            XYZUVW[sbar.i * 6 + 4] += res.y;
-#pragma omp atomic
-            XYZUVW[sbar.i * 6 + 5] += res.z;
+        if (side_b) {
+            force += impulse;
+            torque -= moment;
+        } else {
+            force -= impulse;
+            torque += moment;
+        }
+
+        if (mode == SolverMode::SPINNING) {
+            uint off = 3 * num_contacts + i * 3;
+            real3 spin = Rotate(U * x[off + 0] + V * x[off + 1] + W * x[off + 2], q);
+            if (side_b) {
+                torque += spin;
+            } else {
+                torque -= spin;
+            }
         }
     }
 }
 
-void ChConstraintRigidRigid::D_Tx(const DynamicVector<real>& XYZUVW, DynamicVector<real>& out_vector) {
-    const int& num_rigid_contacts = data_manager->num_rigid_contacts;
-    custom_vector<char>& active_rigid = data_manager->host_data.active_rigid;
-    real3* norm = data_manager->host_data.norm_rigid_rigid.data();
-    real3* ptA = data_manager->host_data.cpta_rigid_rigid.data();
-    real3* ptB = data_manager->host_data.cptb_rigid_rigid.data();
-    real3* pos = data_manager->host_data.pos_rigid.data();
-    vec2* bids_rigid_rigid = data_manager->host_data.bids_rigid_rigid.data();
-    quaternion* rot = data_manager->host_data.rot_rigid.data();
-
+void ChConstraintRigidRigid::Dx(const DynamicVector<real>& x, DynamicVector<real>& output, SolverMode mode) {
 #pragma omp parallel for
-    for (int i = 0; i < num_rigid_contacts; i++) {
-        real3 U = real3(norm[i]), V, W;
-        Orthogonalize(U, V, W);
-        real temp[3] = {0, 0, 0};
+    for (int b = 0; b < (signed)data_manager->num_rigid_bodies; b++) {
+        real3 force, torque;
+        BodyDx(b, x, mode, force, torque);
+        output[b * 6 + 0] = force.x;
+        output[b * 6 + 1] = force.y;
+        output[b * 6 + 2] = force.z;
+        output[b * 6 + 3] = torque.x;
+        output[b * 6 + 4] = torque.y;
+        output[b * 6 + 5] = torque.z;
+    }
+}
 
-        // real3 pA = ptA[i];
-        // int id_a = bids_rigid_rigid[i].x;
-        // if (active_rigid[id_a] != 0)
-        {
-            real3_int sbar = rotated_point_a[i];
-            quaternion quaternion_conjugate = quat_a[i];
+void ChConstraintRigidRigid::M_invDx(const DynamicVector<real>& x,
+                                     const DynamicVector<real>& u,
+                                     DynamicVector<real>& output,
+                                     SolverMode mode) {
+    const CompressedMatrix<real>& M_inv = data_manager->host_data.M_inv;
+    bool add_u = u.size() > 0;
 
-            real3 XYZ(XYZUVW[sbar.i * 6 + 0], XYZUVW[sbar.i * 6 + 1], XYZUVW[sbar.i * 6 + 2]);
-            real3 UVW(XYZUVW[sbar.i * 6 + 3], XYZUVW[sbar.i * 6 + 4], XYZUVW[sbar.i * 6 + 5]);
+#pragma omp parallel for
+    for (int b = 0; b < (signed)data_manager->num_rigid_bodies; b++) {
+        real3 force, torque;
+        BodyDx(b, x, mode, force, torque);
+        real f[6] = {force.x, force.y, force.z, torque.x, torque.y, torque.z};
+        if (add_u) {
+            for (int j = 0; j < 6; j++) {
+                f[j] += u[b * 6 + j];
+            }
+        }
+        // The rows of M_inv for this body only have entries in the columns of the same body
+        for (int j = 0; j < 6; j++) {
+            real sum = 0;
+            for (auto it = M_inv.cbegin(b * 6 + j); it != M_inv.cend(b * 6 + j); ++it) {
+                sum += it->value() * f[it->index() - b * 6];
+            }
+            output[b * 6 + j] = sum;
+        }
+    }
+}
 
-            real3 T1 = Cross(Rotate(U, quaternion_conjugate), sbar.v);
-            real3 T2 = Cross(Rotate(V, quaternion_conjugate), sbar.v);
-            real3 T3 = Cross(Rotate(W, quaternion_conjugate), sbar.v);
+void ChConstraintRigidRigid::D_Tx(const DynamicVector<real>& x, DynamicVector<real>& output, SolverMode mode) {
+    const real3* norm = data_manager->host_data.norm_rigid_rigid.data();
+    uint num_contacts = data_manager->num_rigid_contacts;
 
-            temp[0] = Dot(XYZ, -U) + Dot(UVW, T1);
-            temp[1] = Dot(XYZ, -V) + Dot(UVW, T2);
-            temp[2] = Dot(XYZ, -W) + Dot(UVW, T3);
+#pragma omp parallel for
+    for (int i = 0; i < (signed)num_contacts; i++) {
+        real3 U = norm[i], V, W;
+        Orthogonalize(U, V, W);
 
-            // Jacobian<false>(rot[id_a], U, V, W, ptA[i] - pos[id_a], &XYZUVW[id_a * 6 + 0], temp);
-        }
+        const real3_int& sbar_a = rotated_point_a[i];
+        const real3_int& sbar_b = rotated_point_b[i];
+        int a = sbar_a.i;
+        int b = sbar_b.i;
 
-        // real3 pB = ptB[i];
-        // int id_b = bids_rigid_rigid[i].y;
-        // if (active_rigid[id_b] != 0)
-        {
-            real3_int sbar = rotated_point_b[i];
-            quaternion quaternion_conjugate = quat_b[i];
+        real3 XYZ_a(x[a * 6 + 0], x[a * 6 + 1], x[a * 6 + 2]);
+        real3 UVW_a(x[a * 6 + 3], x[a * 6 + 4], x[a * 6 + 5]);
+        real3 XYZ_b(x[b * 6 + 0], x[b * 6 + 1], x[b * 6 + 2]);
+        real3 UVW_b(x[b * 6 + 3], x[b * 6 + 4], x[b * 6 + 5]);
 
-            real3 XYZ(XYZUVW[sbar.i * 6 + 0], XYZUVW[sbar.i * 6 + 1], XYZUVW[sbar.i * 6 + 2]);
-            real3 UVW(XYZUVW[sbar.i * 6 + 3], XYZUVW[sbar.i * 6 + 4], XYZUVW[sbar.i * 6 + 5]);
+        // Relative velocity at the contact point (world frame).
+        // Note that quat_a and quat_b store the conjugates of the body orientations.
+        real3 vel = (XYZ_b - Rotate(Cross(sbar_b.v, UVW_b), ~quat_b[i])) -  //
+                    (XYZ_a - Rotate(Cross(sbar_a.v, UVW_a), ~quat_a[i]));
 
-            real3 T1 = Cross(Rotate(U, quaternion_conjugate), sbar.v);
-            real3 T2 = Cross(Rotate(V, quaternion_conjugate), sbar.v);
-            real3 T3 = Cross(Rotate(W, quaternion_conjugate), sbar.v);
+        output[i] = Dot(U, vel);
 
-            temp[0] += Dot(XYZ, U) + Dot(UVW, -T1);
-            temp[1] += Dot(XYZ, V) + Dot(UVW, -T2);
-            temp[2] += Dot(XYZ, W) + Dot(UVW, -T3);
+        if (mode == SolverMode::SLIDING || mode == SolverMode::SPINNING) {
+            output[num_contacts + i * 2 + 0] = Dot(V, vel);
+            output[num_contacts + i * 2 + 1] = Dot(W, vel);
         }
 
-        out_vector[i] = temp[0];
-        out_vector[num_rigid_contacts + i * 2 + 0] = temp[1];
-        out_vector[num_rigid_contacts + i * 2 + 1] = temp[2];
-
-        //            out_vector[CONTACT + 3] = temp[3];
-        //            out_vector[CONTACT + 4] = temp[4];
-        //            out_vector[CONTACT + 5] = temp[5];
+        if (mode == SolverMode::SPINNING) {
+            // Relative angular velocity (world frame)
+            real3 omega = Rotate(UVW_b, ~quat_b[i]) - Rotate(UVW_a, ~quat_a[i]);
+            uint off = 3 * num_contacts + i * 3;
+            output[off + 0] = Dot(U, omega);
+            output[off + 1] = Dot(V, omega);
+            output[off + 2] = Dot(W, omega);
+        }
     }
-
-    //    // data_manager->PrintMatrix(data_manager->host_data.D);
-
-    //    DynamicVector<real> compare =
-    //            data_manager->host_data.D_T * data_manager->host_data.D * data_manager->host_data.gamma;
-    //    std::cout << "nconstr " << compare.size() << std::endl;
-    //    for (int i = 0; i < compare.size(); i++) {
-    //        std::cout << compare[i] << " " << out_vector[i] << std::endl;
-    //    }
 }
@@ -40,8 +40,21 @@ class CH_PARALLEL_API ChConstraintRigidRigid {
     void func_Project_normal(int index, const vec2* ids, const real* cohesion, real* gam);
     void func_Project_sliding(int index, const vec2* ids, const real3* fric, const real* cohesion, real* gam);
     void func_Project_spinning(int index, const vec2* ids, const real3* fric, real* gam);
-    void Dx(const DynamicVector<real>& x, DynamicVector<real>& output);
-    void D_Tx(const DynamicVector<real>& x, DynamicVector<real>& output);
+
+    /// Matrix-free product with the contact Jacobian: output = D * x.
+    /// Only the contact multipliers in x for the given solver mode are used and only the rigid body entries of
+    /// output are set (output must have at least 6 * num_rigid_bodies entries).
+    void Dx(const DynamicVector<real>& x, DynamicVector<real>& output, SolverMode mode);
+    /// Matrix-free product with the contact Jacobian, premultiplied by the inverse mass matrix:
+    /// output = M_inv * (u + D * x). The vector u holds additional generalized forces (e.g. from the bilateral
+    /// constraints) and can be empty. Only the rigid body entries of output are set.
+    void M_invDx(const DynamicVector<real>& x,
+                 const DynamicVector<real>& u,
+                 DynamicVector<real>& output,
+                 SolverMode mode);
+    /// Matrix-free product with the transposed contact Jacobian: output = D_T * x.
+    /// Only the contact rows for the given solver mode are set.
+    void D_Tx(const DynamicVector<real>& x, DynamicVector<real>& output, SolverMode mode);
 
     /// Compute the vector of corrections.
     void Build_b();
@@ -57,7 +70,14 @@ class CH_PARALLEL_API ChConstraintRigidRigid {
 
     int offset;
 
+    /// If true, the contact rows of the Jacobian are not assembled and products with the contact Jacobian are
+    /// evaluated matrix-free (see Dx, M_invDx, D_Tx). Set by the solver before Setup at each step.
+    bool matrix_free;
+
   protected:
+    /// Accumulate the generalized contact force on the specified body, for the contact multipliers in x.
+    void BodyDx(int body, const DynamicVector<real>& x, SolverMode mode, real3& force, real3& torque) const;
+
     custom_vector<bool2> contact_active_pairs;
 
     real inv_h;     ///< reciprocal of time step, 1/h
@@ -67,6 +87,11 @@ class CH_PARALLEL_API ChConstraintRigidRigid {
     custom_vector<real3_int> rotated_point_a, rotated_point_b;
     custom_vector<quaternion> quat_a, quat_b;
 
+    // Contacts of each body (matrix-free mode): entries body_contact_start[b] to body_contact_start[b+1] of
+    // body_contacts hold 2 * contact index + side (0: body A, 1: body B).
+    custom_vector<uint> body_contact_start;
+    custom_vector<uint> body_contacts;
+
     ChParallelDataManager* data_manager;  ///< Pointer to the system's data manager
 };
 
@@ -124,11 +124,7 @@ bool ChSystemParallel::Integrate_Y() {
     data_manager->system_timer.stop("update");
 
     data_manager->system_timer.start("collision");
-    collision_system->Run();
-    collision_system->ReportContacts(this->contact_container.get());
-    for (size_t ic = 0; ic < collision_callbacks.size(); ic++) {
-        collision_callbacks[ic]->OnCustomCollision(this);
-    }
+    RunCollisionDetection();
     data_manager->system_timer.stop("collision");
 
     data_manager->system_timer.start("advance");
@@ -226,10 +222,20 @@ bool ChSystemParallel::Integrate_Y() {
     if (data_manager->settings.perform_thread_tuning) {
         RecomputeThreads();
     }
+    data_manager->thread_tuner.Advance(data_manager->settings.perform_phase_tuning,
+                                       data_manager->settings.min_threads, data_manager->settings.max_threads);
 
     return true;
 }
 
+void ChSystemParallel::RunCollisionDetection() {
+    collision_system->Run();
+    collision_system->ReportContacts(this->contact_container.get());
+    for (size_t ic = 0; ic < collision_callbacks.size(); ic++) {
+        collision_callbacks[ic]->OnCustomCollision(this);
+    }
+}
+
 //
 // Add the specified body to the system.
 // A unique identifier is assigned to each body for indexing purposes.
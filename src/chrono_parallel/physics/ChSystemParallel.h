@@ -76,6 +76,10 @@ class CH_PARALLEL_API ChSystemParallel : public ChSystem {
     virtual void Update3DOFBodies();
     void RecomputeThreads();
 
+    /// Run the collision detection and report the contacts (including those added by custom collision callbacks).
+    /// Called at each time step, after the system update.
+    virtual void RunCollisionDetection();
+
     virtual ChBody* NewBody() override;
     virtual ChBodyAuxRef* NewBodyAuxRef() override;
 
@@ -146,6 +150,9 @@ class CH_PARALLEL_API ChSystemParallel : public ChSystem {
 
     settings_container* GetSettings();
 
+    /// Access the per-phase thread configuration (e.g., to save or load a tuned configuration).
+    ChThreadTuner* GetThreadTuner() { return &data_manager->thread_tuner; }
+
     // Based on the specified logging level and the state of that level, enable or
     // disable logging level.
     void SetLoggingLevel(LoggingLevel level, bool state = true);
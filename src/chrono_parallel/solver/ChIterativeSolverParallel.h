@@ -92,6 +92,16 @@ class CH_PARALLEL_API ChIterativeSolverParallelNSC : public ChIterativeSolverPar
     void ChangeSolverType(SolverType type);
 
   private:
+    /// Solve for the constraints of the current local solver mode, with the given iteration limit.
+    /// In mixed-precision mode, the iterations with single-precision Schur products are followed by refinement
+    /// iterations with full-precision products.
+    uint SolveConstraints(uint max_iteration);
+
+    /// Return true if the contact Jacobian can be applied matrix-free in the current step.
+    /// This requires the matrix-free option and a problem with rigid contacts and bilateral constraints only, solved
+    /// with a solver that accesses the constraint matrices only through Schur products.
+    bool UseMatrixFree() const;
+
     ChShurProduct ShurProductFull;
     ChProjectConstraints ProjectFull;
 };
@@ -99,7 +109,7 @@ class CH_PARALLEL_API ChIterativeSolverParallelNSC : public ChIterativeSolverPar
 /// Iterative solver for SMC (penalty-based) problems.
 class CH_PARALLEL_API ChIterativeSolverParallelSMC : public ChIterativeSolverParallel {
   public:
-    ChIterativeSolverParallelSMC(ChParallelDataManager* dc) : ChIterativeSolverParallel(dc) {}
+    ChIterativeSolverParallelSMC(ChParallelDataManager* dc) : ChIterativeSolverParallel(dc), num_precomputed(0) {}
 
     virtual void RunTimeStep();
     virtual void ComputeImpulses();
@@ -113,16 +123,49 @@ class CH_PARALLEL_API ChIterativeSolverParallelSMC : public ChIterativeSolverPar
 
     void ProcessContacts();
 
+    /// Calculate the forces of the current contacts ahead of the time step.
+    /// The contacts found afterwards must be appended to the current ones, which must be kept (with their composite
+    /// material data) at the same indices. The next time step then only calculates the forces of the appended
+    /// contacts. This allows calculating the forces of part of the contacts while other data is not yet available
+    /// (e.g., in Chrono::Distributed, while the states of the ghost bodies are being communicated).
+    void PrecomputeContactForces();
+
   private:
-    void host_CalcContactForces(custom_vector<int>& ext_body_id,
+    /// Calculate the per-contact forces and torques of the contacts not processed yet.
+    void CalcContactForces();
+
+    void host_CalcContactForces(uint start,
+                                custom_vector<int>& ext_body_id,
                                 custom_vector<real3>& ext_body_force,
                                 custom_vector<real3>& ext_body_torque,
                                 custom_vector<vec2>& shape_pairs,
                                 custom_vector<char>& shear_touch);
 
+    /// Accumulate the per-contact forces on bodies, by sorting on body IDs.
+    uint host_ReduceContactForcesSort();
+
+    /// Accumulate the per-contact forces on bodies, after bucketing the per-contact entries by body.
+    uint host_ReduceContactForcesPartition();
+
     void host_AddContactForces(uint ct_body_count, const custom_vector<int>& ct_body_id);
 
     void host_SetContactForcesMap(uint ct_body_count, const custom_vector<int>& ct_body_id);
+
+    // Scratch buffers, persistent across steps.
+    custom_vector<int> ext_body_id;         ///< body IDs (two per contact)
+    custom_vector<real3> ext_body_force;    ///< body forces (two per contact)
+    custom_vector<real3> ext_body_torque;   ///< body torques (two per contact)
+    custom_vector<int> ct_body_id;          ///< IDs of bodies involved in contacts
+    custom_vector<uint> body_num_contacts;  ///< number of contacts per body (PARTITION)
+    custom_vector<real3> body_force;        ///< accumulated contact force per body (PARTITION)
+    custom_vector<real3> body_torque;       ///< accumulated contact torque per body (PARTITION)
+    custom_vector<int> body_ext_start;      ///< start of the bucket of each body in ext_order (PARTITION)
+    custom_vector<int> ext_order;           ///< per-contact entry indices, bucketed by body (PARTITION)
+    custom_vector<int> chunk_body_count;    ///< per-chunk bucket sizes, then offsets (PARTITION)
+    custom_vector<vec2> shape_pairs;        ///< shape IDs (one pair per contact, MultiStep)
+    custom_vector<char> shear_touch;        ///< flags of persistent contacts in the shear history (MultiStep)
+
+    uint num_precomputed;  ///< number of contacts with forces calculated ahead of the time step
 };
 
 /// @} parallel_solver
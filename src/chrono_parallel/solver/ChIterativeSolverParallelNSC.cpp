@@ -62,6 +62,7 @@ void ChIterativeSolverParallelNSC::RunTimeStep() {
     data_manager->host_data.gamma.reset();
 
     // Perform any setup tasks for all constraint types
+    data_manager->rigid_rigid->matrix_free = UseMatrixFree();
     data_manager->rigid_rigid->Setup(data_manager);
     data_manager->bilateral->Setup(data_manager);
     data_manager->node_container->Setup(data_manager->num_unilaterals + data_manager->num_bilaterals);
@@ -71,6 +72,7 @@ void ChIterativeSolverParallelNSC::RunTimeStep() {
     solver->current_iteration = 0;
     bilateral_solver->current_iteration = 0;
     data_manager->measures.solver.total_iteration = 0;
+    data_manager->measures.solver.refinement_iteration = 0;
     data_manager->measures.solver.maxd_hist.clear();
     data_manager->measures.solver.maxdeltalambda_hist.clear();
 
@@ -95,15 +97,23 @@ void ChIterativeSolverParallelNSC::RunTimeStep() {
 
     if (data_manager->num_constraints > 0) {
         // Rhs should be updated with latest velocity after presolve
-        data_manager->host_data.R_full =
-            -data_manager->host_data.b -
-            data_manager->host_data.D_T *
-                (data_manager->host_data.v + data_manager->host_data.M_inv * data_manager->host_data.hf);
+        DynamicVector<real> v_free =
+            data_manager->host_data.v + data_manager->host_data.M_inv * data_manager->host_data.hf;
+        data_manager->host_data.R_full = -data_manager->host_data.b - data_manager->host_data.D_T * v_free;
+        if (data_manager->rigid_rigid->matrix_free) {
+            DynamicVector<real> D_Tv(data_manager->num_constraints, 0.0);
+            data_manager->rigid_rigid->D_Tx(v_free, D_Tv, data_manager->settings.solver.solver_mode);
+            data_manager->host_data.R_full -= D_Tv;
+        }
     }
     ShurProductFull.Setup(data_manager);
     ShurProductBilateral.Setup(data_manager);
     ShurProductFEM.Setup(data_manager);
     ProjectFull.Setup(data_manager);
+    if (data_manager->settings.solver.use_mixed_precision && !data_manager->rigid_rigid->matrix_free &&
+        data_manager->num_constraints > 0) {
+        ShurProductFull.SetupSinglePrecision();
+    }
 
     PerformStabilization();
 
@@ -115,12 +125,7 @@ void ChIterativeSolverParallelNSC::RunTimeStep() {
             SetR();
             LOG(INFO) << "ChIterativeSolverParallelNSC::RunTimeStep - Solve Normal";
             data_manager->measures.solver.total_iteration +=
-                solver->Solve(ShurProductFull,                                     //
-                              ProjectFull,                                         //
-                              data_manager->settings.solver.max_iteration_normal,  //
-                              data_manager->num_constraints,                       //
-                              data_manager->host_data.R,                           //
-                              data_manager->host_data.gamma);                      //
+                SolveConstraints(data_manager->settings.solver.max_iteration_normal);
         }
     }
     if (data_manager->settings.solver.solver_mode == SolverMode::SLIDING ||
@@ -130,12 +135,7 @@ void ChIterativeSolverParallelNSC::RunTimeStep() {
             SetR();
             LOG(INFO) << "ChIterativeSolverParallelNSC::RunTimeStep - Solve Sliding";
             data_manager->measures.solver.total_iteration +=
-                solver->Solve(ShurProductFull,                                      //
-                              ProjectFull,                                          //
-                              data_manager->settings.solver.max_iteration_sliding,  //
-                              data_manager->num_constraints,                        //
-                              data_manager->host_data.R,                            //
-                              data_manager->host_data.gamma);                       //
+                SolveConstraints(data_manager->settings.solver.max_iteration_sliding);
         }
     }
     if (data_manager->settings.solver.solver_mode == SolverMode::SPINNING) {
@@ -144,41 +144,10 @@ void ChIterativeSolverParallelNSC::RunTimeStep() {
             SetR();
             LOG(INFO) << "ChIterativeSolverParallelNSC::RunTimeStep - Solve Spinning";
             data_manager->measures.solver.total_iteration +=
-                solver->Solve(ShurProductFull,                                       //
-                              ProjectFull,                                           //
-                              data_manager->settings.solver.max_iteration_spinning,  //
-                              data_manager->num_constraints,                         //
-                              data_manager->host_data.R,                             //
-                              data_manager->host_data.gamma);                        //
+                SolveConstraints(data_manager->settings.solver.max_iteration_spinning);
         }
     }
 
-    //    DynamicVector<real> temp(data_manager->num_rigid_bodies * 6, 0.0);
-    //    DynamicVector<real> output(data_manager->num_rigid_contacts * 3, 0.0);
-    //
-    //    // DynamicVector<real> temp(data_manager->num_fluid_bodies * 3, 0.0);
-    //    // DynamicVector<real> output(data_manager->num_fluid_bodies, 0.0);
-    //
-    //    /////
-    //    double t1 = 0;
-    //    {
-    //        ChTimer<> timer;
-    //        timer.start();
-    //        rigid_rigid.Dx(data_manager->host_data.gamma, temp);
-    //        rigid_rigid.D_Tx(temp, output);
-    //        // data_manager->node_container->Dx(data_manager->host_data.gamma, temp);
-    //        // data_manager->node_container->D_Tx(temp, output);
-    //        timer.stop();
-    //        t1 = timer();
-    //    }
-    //    ChTimer<> timer;
-    //    timer.start();
-    //    DynamicVector<real> compare =
-    //        data_manager->host_data.D_T * data_manager->host_data.D * data_manager->host_data.gamma;
-    //    timer.stop();
-    //    std::cout << "time1: " << t1 << " time2: " << timer() << std::endl;
-    //    /////
-
     data_manager->Fc_current = false;
     data_manager->node_container->PostSolve();
     data_manager->fea_container->PostSolve();
@@ -240,6 +209,11 @@ void ChIterativeSolverParallelNSC::ComputeD() {
     int nnz_total = nnz_bilaterals + nnz_fluid_fluid + nnz_fem;
     int num_rows = num_bilaterals + num_fluid_fluid + num_fem;
 
+    // Contact rows are left empty in matrix-free mode
+    if (data_manager->rigid_rigid->matrix_free) {
+        nnz_normal = nnz_tangential = nnz_spinning = 0;
+    }
+
     switch (data_manager->settings.solver.solver_mode) {
         case SolverMode::NORMAL:
             nnz_total += nnz_normal;
@@ -334,6 +308,52 @@ void ChIterativeSolverParallelNSC::ComputeR() {
     data_manager->system_timer.stop("ChIterativeSolverParallel_R");
 }
 
+bool ChIterativeSolverParallelNSC::UseMatrixFree() const {
+    const auto& settings = data_manager->settings.solver;
+    if (!settings.use_matrix_free || settings.compute_N || settings.update_rhs) {
+        return false;
+    }
+
+    // Jacobi and Gauss-Seidel access the entries of the Schur complement matrix
+    if (settings.solver_type == SolverType::JACOBI || settings.solver_type == SolverType::GAUSS_SEIDEL) {
+        return false;
+    }
+
+    if (settings.solver_mode != SolverMode::NORMAL && settings.solver_mode != SolverMode::SLIDING &&
+        settings.solver_mode != SolverMode::SPINNING) {
+        return false;
+    }
+
+    // Constraints and contacts involving fluid or FEA nodes are always assembled
+    return data_manager->num_fluid_bodies == 0 && data_manager->num_fea_nodes == 0 &&
+           data_manager->node_container->GetNumConstraints() == 0 &&
+           data_manager->fea_container->GetNumConstraints() == 0;
+}
+
+uint ChIterativeSolverParallelNSC::SolveConstraints(uint max_iteration) {
+    // Mixed precision only applies to solves for the full set of constraints (see ChShurProduct) and is not used
+    // together with matrix-free products
+    if (!data_manager->settings.solver.use_mixed_precision || data_manager->rigid_rigid->matrix_free ||
+        data_manager->settings.solver.local_solver_mode != data_manager->settings.solver.solver_mode) {
+        return solver->Solve(ShurProductFull, ProjectFull, max_iteration, data_manager->num_constraints,
+                             data_manager->host_data.R, data_manager->host_data.gamma);
+    }
+
+    ShurProductFull.use_single_precision = true;
+    uint iterations = solver->Solve(ShurProductFull, ProjectFull, max_iteration, data_manager->num_constraints,
+                                    data_manager->host_data.R, data_manager->host_data.gamma);
+    ShurProductFull.use_single_precision = false;
+
+    // Refinement, warm-started from the single-precision solution. The solver stops as soon as the residual
+    // evaluated with full-precision products is below the requested tolerance.
+    uint refinement =
+        solver->Solve(ShurProductFull, ProjectFull, data_manager->settings.solver.max_iteration_refinement,
+                      data_manager->num_constraints, data_manager->host_data.R, data_manager->host_data.gamma);
+    data_manager->measures.solver.refinement_iteration += refinement;
+
+    return iterations + refinement;
+}
+
 void ChIterativeSolverParallelNSC::ComputeN() {
     if (data_manager->settings.solver.compute_N == false) {
         return;
@@ -414,6 +434,13 @@ void ChIterativeSolverParallelNSC::ComputeImpulses() {
     if (data_manager->num_constraints > 0) {
         // Compute new velocity based on the lagrange multipliers
         v = v + M_inv * hf + data_manager->host_data.M_invD * gamma;
+        if (data_manager->rigid_rigid->matrix_free) {
+            // Contribution of the contact impulses, not included in M_invD
+            DynamicVector<real> dv(data_manager->num_rigid_bodies * 6);
+            data_manager->rigid_rigid->M_invDx(gamma, DynamicVector<real>(), dv,
+                                               data_manager->settings.solver.solver_mode);
+            subvector(v, 0, data_manager->num_rigid_bodies * 6) += dv;
+        }
     } else {
         // When there are no constraints we need to still apply gravity and other
         // body forces!
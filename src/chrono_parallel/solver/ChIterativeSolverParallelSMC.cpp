@@ -29,10 +29,14 @@
 //// case. Is there a solution?
 
 #include <algorithm>
+#include <thrust/copy.h>
+#include <thrust/scan.h>
 #include <thrust/sort.h>
+#include <thrust/iterator/counting_iterator.h>
 
 #include "chrono/physics/ChSystemSMC.h"
 #include "chrono/physics/ChMaterialSurfaceSMC.h"
+#include "chrono/parallel/ChOpenMP.h"
 #include "chrono_parallel/solver/ChIterativeSolverParallel.h"
 
 #if defined(CHRONO_OPENMP_ENABLED)
@@ -554,16 +558,18 @@ void function_CalcContactForces(
 }
 
 // -----------------------------------------------------------------------------
-// Calculate contact forces and torques for all contact pairs.
+// Calculate contact forces and torques for all contact pairs, starting at the
+// specified index.
 // -----------------------------------------------------------------------------
 
-void ChIterativeSolverParallelSMC::host_CalcContactForces(custom_vector<int>& ext_body_id,
+void ChIterativeSolverParallelSMC::host_CalcContactForces(uint start,
+                                                          custom_vector<int>& ext_body_id,
                                                           custom_vector<real3>& ext_body_force,
                                                           custom_vector<real3>& ext_body_torque,
                                                           custom_vector<vec2>& shape_pairs,
                                                           custom_vector<char>& shear_touch) {
 #pragma omp parallel for
-    for (int index = 0; index < (signed)data_manager->num_rigid_contacts; index++) {
+    for (int index = (signed)start; index < (signed)data_manager->num_rigid_contacts; index++) {
         function_CalcContactForces(
             index,                                                  // index of this contact pair
             data_manager->host_data.bids_rigid_rigid.data(),        // indices of the body pair in contact
@@ -648,54 +654,14 @@ struct sum_tuples {
 };
 
 // -----------------------------------------------------------------------------
-// Process contact information reported by the narrowphase collision detection,
-// generate contact forces, and update the (linear and rotational) impulses for
-// all bodies involved in at least one contact.
+// Accumulate contact forces and torques per body, by sorting the per-contact
+// forces and torques on body IDs and reducing them.
 // -----------------------------------------------------------------------------
-void ChIterativeSolverParallelSMC::ProcessContacts() {
-    // 1. Calculate contact forces and torques - per contact basis
-    //    For each pair of contact shapes that overlap, we calculate and store the
-    //    IDs of the two corresponding bodies and the resulting contact forces and
-    //    torques on the two bodies.
-    custom_vector<int> ext_body_id(2 * data_manager->num_rigid_contacts);
-    custom_vector<real3> ext_body_force(2 * data_manager->num_rigid_contacts);
-    custom_vector<real3> ext_body_torque(2 * data_manager->num_rigid_contacts);
-    custom_vector<vec2> shape_pairs;
-    custom_vector<char> shear_touch;
-
-    if (data_manager->settings.solver.tangential_displ_mode == ChSystemSMC::TangentialDisplacementModel::MultiStep) {
-        shape_pairs.resize(data_manager->num_rigid_contacts);
-        shear_touch.resize(max_shear * data_manager->num_rigid_bodies);
-        Thrust_Fill(shear_touch, false);
-#pragma omp parallel for
-        for (int i = 0; i < (signed)data_manager->num_rigid_contacts; i++) {
-            vec2 pair = I2(int(data_manager->host_data.contact_pairs[i] >> 32),
-                           int(data_manager->host_data.contact_pairs[i] & 0xffffffff));
-            shape_pairs[i] = pair;
-        }
-    }
-
-    host_CalcContactForces(ext_body_id, ext_body_force, ext_body_torque, shape_pairs, shear_touch);
-
-    if (data_manager->settings.solver.tangential_displ_mode == ChSystemSMC::TangentialDisplacementModel::MultiStep) {
-#pragma omp parallel for
-        for (int index = 0; index < (signed)data_manager->num_rigid_bodies; index++) {
-            for (int i = 0; i < max_shear; i++) {
-                if (shear_touch[max_shear * index + i] == false)
-                    data_manager->host_data.shear_neigh[max_shear * index + i].x = -1;
-            }
-        }
-    }
-
-    // 2. Calculate contact forces and torques - per body basis
-    //    Accumulate the contact forces and torques for all bodies that are
-    //    involved in at least one contact, by reducing the contact forces and
-    //    torques from all contacts these bodies are involved in. The number of
-    //    bodies that experience at least one contact is 'ct_body_count'.
+uint ChIterativeSolverParallelSMC::host_ReduceContactForcesSort() {
     thrust::sort_by_key(THRUST_PAR ext_body_id.begin(), ext_body_id.end(),
                         thrust::make_zip_iterator(thrust::make_tuple(ext_body_force.begin(), ext_body_torque.begin())));
 
-    custom_vector<int> ct_body_id(data_manager->num_rigid_bodies);
+    ct_body_id.resize(data_manager->num_rigid_bodies);
     custom_vector<real3>& ct_body_force = data_manager->host_data.ct_body_force;
     custom_vector<real3>& ct_body_torque = data_manager->host_data.ct_body_torque;
 
@@ -724,6 +690,146 @@ void ChIterativeSolverParallelSMC::ProcessContacts() {
     ct_body_force.resize(ct_body_count);
     ct_body_torque.resize(ct_body_count);
 
+    return ct_body_count;
+}
+
+// -----------------------------------------------------------------------------
+// Accumulate contact forces and torques per body, without sorting the forces.
+// The per-contact entries are bucketed by body with a stable parallel counting
+// sort on the body IDs: the entries are split in contiguous chunks (one per
+// thread), the bucket sizes of each chunk give the position of its entries in
+// each bucket, and the entry indices are then scattered concurrently. Each body
+// then accumulates the entries in its bucket (in contact order, so that results
+// do not depend on the number of threads). The bodies involved in at least one
+// contact are then collected in increasing ID order.
+// -----------------------------------------------------------------------------
+uint ChIterativeSolverParallelSMC::host_ReduceContactForcesPartition() {
+    const int num_bodies = (int)data_manager->num_rigid_bodies;
+    const int num_ext = (int)ext_body_id.size();
+    const int num_chunks = CHOMPfunctions::GetMaxThreads();
+
+    custom_vector<real3>& ct_body_force = data_manager->host_data.ct_body_force;
+    custom_vector<real3>& ct_body_torque = data_manager->host_data.ct_body_torque;
+
+    body_num_contacts.resize(num_bodies);
+    body_force.resize(num_bodies);
+    body_torque.resize(num_bodies);
+    body_ext_start.resize(num_bodies + 1);
+    ext_order.resize(num_ext);
+
+    // The per-chunk counts are reallocated only if the number of bodies (or threads) changed.
+    if (chunk_body_count.size() != (size_t)num_chunks * num_bodies)
+        chunk_body_count.resize((size_t)num_chunks * num_bodies);
+
+    // Count the entries of each chunk in each bucket.
+#pragma omp parallel for schedule(static, 1)
+    for (int c = 0; c < num_chunks; c++) {
+        int* count = chunk_body_count.data() + (size_t)c * num_bodies;
+        std::fill(count, count + num_bodies, 0);
+        int end = (int)(((long long)num_ext * (c + 1)) / num_chunks);
+        for (int i = (int)(((long long)num_ext * c) / num_chunks); i < end; i++)
+            count[ext_body_id[i]]++;
+    }
+
+    // Bucket sizes, and offset of each chunk within each bucket.
+#pragma omp parallel for
+    for (int b = 0; b < num_bodies; b++) {
+        int offset = 0;
+        for (int c = 0; c < num_chunks; c++) {
+            int& count = chunk_body_count[(size_t)c * num_bodies + b];
+            int n = count;
+            count = offset;
+            offset += n;
+        }
+        body_num_contacts[b] = offset;
+    }
+
+    // Start of each bucket.
+    body_ext_start[0] = 0;
+    thrust::inclusive_scan(THRUST_PAR body_num_contacts.begin(), body_num_contacts.end(), body_ext_start.begin() + 1);
+
+    // Scatter the entry indices in the buckets, preserving their order.
+#pragma omp parallel for schedule(static, 1)
+    for (int c = 0; c < num_chunks; c++) {
+        int* offset = chunk_body_count.data() + (size_t)c * num_bodies;
+        int end = (int)(((long long)num_ext * (c + 1)) / num_chunks);
+        for (int i = (int)(((long long)num_ext * c) / num_chunks); i < end; i++) {
+            int b = ext_body_id[i];
+            ext_order[body_ext_start[b] + offset[b]++] = i;
+        }
+    }
+
+    // Accumulate the entries of each bucket.
+#pragma omp parallel for
+    for (int b = 0; b < num_bodies; b++) {
+        real3 force(0);
+        real3 torque(0);
+        for (int k = body_ext_start[b]; k < body_ext_start[b + 1]; k++) {
+            force += ext_body_force[ext_order[k]];
+            torque += ext_body_torque[ext_order[k]];
+        }
+        body_force[b] = force;
+        body_torque[b] = torque;
+    }
+
+    // Collect the bodies involved in at least one contact.
+    ct_body_id.resize(num_bodies);
+    uint ct_body_count =
+        (uint)(thrust::copy_if(THRUST_PAR thrust::counting_iterator<int>(0), thrust::counting_iterator<int>(num_bodies),
+                               body_num_contacts.begin(), ct_body_id.begin(), thrust::identity<uint>()) -
+               ct_body_id.begin());
+
+    ct_body_force.resize(ct_body_count);
+    ct_body_torque.resize(ct_body_count);
+
+#pragma omp parallel for
+    for (int index = 0; index < (signed)ct_body_count; index++) {
+        ct_body_force[index] = body_force[ct_body_id[index]];
+        ct_body_torque[index] = body_torque[ct_body_id[index]];
+    }
+
+    return ct_body_count;
+}
+
+// -----------------------------------------------------------------------------
+// Process contact information reported by the narrowphase collision detection,
+// generate contact forces, and update the (linear and rotational) impulses for
+// all bodies involved in at least one contact.
+// -----------------------------------------------------------------------------
+void ChIterativeSolverParallelSMC::ProcessContacts() {
+    // 1. Calculate contact forces and torques - per contact basis
+    //    For each pair of contact shapes that overlap, we calculate and store the
+    //    IDs of the two corresponding bodies and the resulting contact forces and
+    //    torques on the two bodies.
+    CalcContactForces();
+    num_precomputed = 0;
+
+    if (data_manager->settings.solver.tangential_displ_mode == ChSystemSMC::TangentialDisplacementModel::MultiStep) {
+#pragma omp parallel for
+        for (int index = 0; index < (signed)data_manager->num_rigid_bodies; index++) {
+            for (int i = 0; i < max_shear; i++) {
+                if (shear_touch[max_shear * index + i] == false)
+                    data_manager->host_data.shear_neigh[max_shear * index + i].x = -1;
+            }
+        }
+    }
+
+    // 2. Calculate contact forces and torques - per body basis
+    //    Accumulate the contact forces and torques for all bodies that are
+    //    involved in at least one contact, by reducing the contact forces and
+    //    torques from all contacts these bodies are involved in. The number of
+    //    bodies that experience at least one contact is 'ct_body_count'.
+    uint ct_body_count;
+    switch (data_manager->settings.solver.contact_force_reduction) {
+        default:
+        case ContactForceReduction::SORT:
+            ct_body_count = host_ReduceContactForcesSort();
+            break;
+        case ContactForceReduction::PARTITION:
+            ct_body_count = host_ReduceContactForcesPartition();
+            break;
+    }
+
     // 3. Add contact forces and torques to existing forces (impulses):
     //    For all bodies involved in a contact, update the body forces and torques
     //    (scaled by the integration time step).
@@ -786,6 +892,49 @@ void ChIterativeSolverParallelSMC::ComputeR() {
         -data_manager->host_data.b - data_manager->host_data.D_T * data_manager->host_data.M_invk;
 }
 
+// -----------------------------------------------------------------------------
+// Calculate the per-contact forces and torques of the contacts with index in
+// [num_precomputed, num_rigid_contacts). The entries of the precomputed contacts
+// in the output arrays and the flags of the shear history are preserved.
+// -----------------------------------------------------------------------------
+void ChIterativeSolverParallelSMC::CalcContactForces() {
+    uint start = num_precomputed;
+    uint num_contacts = data_manager->num_rigid_contacts;
+
+    ext_body_id.resize(2 * num_contacts);
+    ext_body_force.resize(2 * num_contacts);
+    ext_body_torque.resize(2 * num_contacts);
+
+    if (data_manager->settings.solver.tangential_displ_mode == ChSystemSMC::TangentialDisplacementModel::MultiStep) {
+        shape_pairs.resize(num_contacts);
+        if (start == 0) {
+            shear_touch.resize(max_shear * data_manager->num_rigid_bodies);
+            Thrust_Fill(shear_touch, false);
+        } else {
+            // Bodies may have been added since the precomputation
+            shear_touch.resize(max_shear * data_manager->num_rigid_bodies, false);
+        }
+#pragma omp parallel for
+        for (int i = (signed)start; i < (signed)num_contacts; i++) {
+            vec2 pair = I2(int(data_manager->host_data.contact_pairs[i] >> 32),
+                           int(data_manager->host_data.contact_pairs[i] & 0xffffffff));
+            shape_pairs[i] = pair;
+        }
+    }
+
+    host_CalcContactForces(start, ext_body_id, ext_body_force, ext_body_torque, shape_pairs, shear_touch);
+}
+
+void ChIterativeSolverParallelSMC::PrecomputeContactForces() {
+    num_precomputed = 0;
+    if (data_manager->num_rigid_contacts > 0) {
+        data_manager->system_timer.start("ChIterativeSolverParallelSMC_ProcessContact");
+        CalcContactForces();
+        data_manager->system_timer.stop("ChIterativeSolverParallelSMC_ProcessContact");
+    }
+    num_precomputed = data_manager->num_rigid_contacts;
+}
+
 // -----------------------------------------------------------------------------
 // This is the main function for advancing the system state in time. On entry,
 // geometric contact information is available as calculated by the narrowphase
@@ -804,9 +953,12 @@ void ChIterativeSolverParallelSMC::RunTimeStep() {
 
     if (data_manager->num_rigid_contacts > 0) {
         data_manager->system_timer.start("ChIterativeSolverParallelSMC_ProcessContact");
+        data_manager->thread_tuner.Begin(ThreadPhase::FORCE_ACCUMULATION);
         ProcessContacts();
+        data_manager->thread_tuner.End(ThreadPhase::FORCE_ACCUMULATION);
         data_manager->system_timer.stop("ChIterativeSolverParallelSMC_ProcessContact");
     }
+    num_precomputed = 0;
 
     // Generate the mass matrix and compute M_inv_k
     ComputeInvMassMatrix();
@@ -16,11 +16,69 @@
 
 using namespace chrono;
 
+void ChSparseMatrixFloat::Assign(const CompressedMatrix<real>& A) {
+    rows = A.rows();
+    columns = A.columns();
+
+    row_start.resize(rows + 1);
+    row_start[0] = 0;
+    for (size_t i = 0; i < rows; i++) {
+        row_start[i + 1] = row_start[i] + (unsigned int)A.nonZeros(i);
+    }
+    col_index.resize(row_start[rows]);
+    values.resize(row_start[rows]);
+
+#pragma omp parallel for
+    for (int i = 0; i < (signed)rows; i++) {
+        unsigned int k = row_start[i];
+        for (auto it = A.cbegin(i); it != A.cend(i); ++it, ++k) {
+            col_index[k] = (unsigned int)it->index();
+            values[k] = (float)it->value();
+        }
+    }
+}
+
+template <typename T>
+static void MultiplyFloat(const ChSparseMatrixFloat& A, const float* x, T* y) {
+#pragma omp parallel for
+    for (int i = 0; i < (signed)A.rows; i++) {
+        double sum = 0;
+        for (unsigned int k = A.row_start[i]; k < A.row_start[i + 1]; k++) {
+            sum += (double)A.values[k] * x[A.col_index[k]];
+        }
+        y[i] = (T)sum;
+    }
+}
+
+void ChSparseMatrixFloat::Multiply(const std::vector<float>& x, std::vector<float>& y) const {
+    y.resize(rows);
+    MultiplyFloat(*this, x.data(), y.data());
+}
+
+void ChSparseMatrixFloat::Multiply(const std::vector<float>& x, DynamicVector<real>& y) const {
+    y.resize(rows);
+    MultiplyFloat(*this, x.data(), y.data());
+}
+
+// -----------------------------------------------------------------------------
+
 ChShurProduct::ChShurProduct() {
     data_manager = 0;
+    use_single_precision = false;
 }
+
+void ChShurProduct::SetupSinglePrecision() {
+    if (data_manager->settings.solver.compute_N) {
+        Nshur_f.Assign(data_manager->host_data.Nshur);
+    } else {
+        D_T_f.Assign(data_manager->host_data.D_T);
+        M_invD_f.Assign(data_manager->host_data.M_invD);
+    }
+}
+
 void ChShurProduct::operator()(const DynamicVector<real>& x, DynamicVector<real>& output) {
     data_manager->system_timer.start("ShurProduct");
+    data_manager->thread_tuner.Begin(ThreadPhase::SCHUR_PRODUCT);
 
     const DynamicVector<real>& E = data_manager->host_data.E;
 
@@ -33,7 +91,23 @@ void ChShurProduct::operator()(const DynamicVector<real>& x, DynamicVector<real>
     const CompressedMatrix<real>& D_T = data_manager->host_data.D_T;
     const CompressedMatrix<real>& Nshur = data_manager->host_data.Nshur;
 
-    if (data_manager->settings.solver.local_solver_mode == data_manager->settings.solver.solver_mode) {
+    if (data_manager->rigid_rigid->matrix_free &&
+        data_manager->settings.solver.local_solver_mode != SolverMode::BILATERAL) {
+        ProductMatrixFree(x, output);
+
+    } else if (data_manager->settings.solver.local_solver_mode == data_manager->settings.solver.solver_mode &&
+               use_single_precision) {
+        // Products with the single-precision matrices; the compliance term is added in full precision
+        x_f.assign(x.begin(), x.end());
+        if (data_manager->settings.solver.compute_N) {
+            Nshur_f.Multiply(x_f, output);
+        } else {
+            M_invD_f.Multiply(x_f, tmp_f);
+            D_T_f.Multiply(tmp_f, output);
+        }
+        output += E * x;
+
+    } else if (data_manager->settings.solver.local_solver_mode == data_manager->settings.solver.solver_mode) {
         if (data_manager->settings.solver.compute_N) {
             output = Nshur * x + E * x;
         } else {
@@ -101,9 +175,56 @@ void ChShurProduct::operator()(const DynamicVector<real>& x, DynamicVector<real>
             } break;
         }
     }
+    data_manager->thread_tuner.End(ThreadPhase::SCHUR_PRODUCT);
     data_manager->system_timer.stop("ShurProduct");
 }
 
+void ChShurProduct::ProductMatrixFree(const DynamicVector<real>& x, DynamicVector<real>& output) {
+    const DynamicVector<real>& E = data_manager->host_data.E;
+    const CompressedMatrix<real>& M_inv = data_manager->host_data.M_inv;
+    SolverMode mode = data_manager->settings.solver.local_solver_mode;
+
+    uint num_rigid_contacts = data_manager->num_rigid_contacts;
+    uint num_unilaterals = data_manager->num_unilaterals;
+    uint num_bilaterals = data_manager->num_bilaterals;
+    uint num_rigid_dof = _num_rigid_dof_;
+    uint num_other_dof = _num_shaft_dof_ + _num_motor_dof_;
+
+    // Velocity changes v = M_inv * D * x, with the contact part of D applied matrix-free
+    v_mf.resize(num_rigid_dof + num_other_dof);
+    if (num_bilaterals > 0) {
+        const SubMatrixType& D_b_T = _DBT_;
+        ConstSubVectorType x_b = subvector(x, num_unilaterals, num_bilaterals);
+        u_mf = trans(D_b_T) * x_b;
+        if (num_other_dof > 0) {
+            subvector(v_mf, num_rigid_dof, num_other_dof) =
+                submatrix(M_inv, num_rigid_dof, num_rigid_dof, num_other_dof, num_other_dof) *
+                subvector(u_mf, num_rigid_dof, num_other_dof);
+        }
+    } else {
+        u_mf.clear();
+        subvector(v_mf, num_rigid_dof, num_other_dof) = 0;
+    }
+    data_manager->rigid_rigid->M_invDx(x, u_mf, v_mf, mode);
+
+    // Constraint rows: D_T * v + E * x (only the rows for the current solver mode)
+    data_manager->rigid_rigid->D_Tx(v_mf, output, mode);
+    if (num_bilaterals > 0) {
+        const SubMatrixType& D_b_T = _DBT_;
+        subvector(output, num_unilaterals, num_bilaterals) = D_b_T * v_mf;
+    }
+
+    uint num_rows = num_rigid_contacts;
+    if (mode == SolverMode::SLIDING) {
+        num_rows = 3 * num_rigid_contacts;
+    } else if (mode == SolverMode::SPINNING) {
+        num_rows = 6 * num_rigid_contacts;
+    }
+    subvector(output, 0, num_rows) += subvector(E, 0, num_rows) * subvector(x, 0, num_rows);
+    subvector(output, num_unilaterals, num_bilaterals) +=
+        subvector(E, num_unilaterals, num_bilaterals) * subvector(x, num_unilaterals, num_bilaterals);
+}
+
 void ChShurProductBilateral::Setup(ChParallelDataManager* data_container_) {
     ChShurProduct::Setup(data_container_);
     if (data_manager->num_bilaterals == 0) {
@@ -55,6 +55,29 @@ class CH_PARALLEL_API ChProjectNone : public ChProjectConstraints {
     virtual void operator()(real* data) {}
 };
 
+/// Single-precision copy of a row-major sparse matrix, in CSR format with 32-bit indices.
+/// A nonzero takes 8 bytes instead of the 16 bytes of a CompressedMatrix<double> entry, which halves the memory
+/// traffic of sparse matrix-vector products. Products are accumulated in double precision.
+class CH_PARALLEL_API ChSparseMatrixFloat {
+  public:
+    ChSparseMatrixFloat() : rows(0), columns(0) {}
+
+    /// Set this matrix to a single-precision copy of the given matrix.
+    void Assign(const CompressedMatrix<real>& A);
+
+    /// Compute y = A * x.
+    void Multiply(const std::vector<float>& x, std::vector<float>& y) const;
+
+    /// Compute y = A * x.
+    void Multiply(const std::vector<float>& x, DynamicVector<real>& y) const;
+
+    size_t rows;
+    size_t columns;
+    std::vector<unsigned int> row_start;
+    std::vector<unsigned int> col_index;
+    std::vector<float> values;
+};
+
 /// Functor class for calculating the Shur product of the matrix of unilateral constraints.
 class CH_PARALLEL_API ChShurProduct {
   public:
@@ -63,10 +86,32 @@ class CH_PARALLEL_API ChShurProduct {
 
     virtual void Setup(ChParallelDataManager* data_container_) { data_manager = data_container_; }
 
+    /// Update the single-precision copies of the constraint matrices (mixed-precision mode).
+    /// Must be called after the matrices have been computed and before enabling single-precision products.
+    void SetupSinglePrecision();
+
     //. Perform the Shur Product.
     virtual void operator()(const DynamicVector<real>& x, DynamicVector<real>& AX);
 
     ChParallelDataManager* data_manager;  ///< Pointer to the system's data manager
+
+    /// If true, products with the full set of constraints use the single-precision matrices.
+    /// Products on a subset of the constraints (see solver_settings::local_solver_mode) are always performed in the
+    /// precision of 'real'.
+    bool use_single_precision;
+
+  private:
+    /// Schur product with the contact Jacobian evaluated matrix-free (see ChConstraintRigidRigid::matrix_free).
+    void ProductMatrixFree(const DynamicVector<real>& x, DynamicVector<real>& output);
+
+    DynamicVector<real> u_mf;  ///< generalized forces from bilateral constraints (matrix-free product)
+    DynamicVector<real> v_mf;  ///< velocity changes (matrix-free product)
+
+    ChSparseMatrixFloat D_T_f;
+    ChSparseMatrixFloat M_invD_f;
+    ChSparseMatrixFloat Nshur_f;
+    std::vector<float> x_f;
+    std::vector<float> tmp_f;
 };
 
 /// Functor class for performing the Shur product of the matrix of bilateral constraints.
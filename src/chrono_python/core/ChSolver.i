@@ -43,6 +43,7 @@ using namespace chrono;
 %shared_ptr(chrono::ChSolverPJacobi)
 %shared_ptr(chrono::ChSolverSparseLU)
 %shared_ptr(chrono::ChSolverSparseQR)
+%shared_ptr(chrono::ChSolverSparseLDLT)
 
 %include "../../chrono/solver/ChSolver.h"
 %include "../../chrono/solver/ChSolverVI.h"
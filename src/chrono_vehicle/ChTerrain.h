@@ -19,6 +19,8 @@
 #ifndef CH_TERRAIN_H
 #define CH_TERRAIN_H
 
+#include <vector>
+
 #include "chrono/core/ChVector.h"
 
 #include "chrono_vehicle/ChApiVehicle.h"
@@ -54,6 +56,19 @@ class CH_VEHICLE_API ChTerrain {
     /// with other objects (including tire models that do not explicitly use it).
     virtual float GetCoefficientFriction(const ChVector<>& loc) const = 0;
 
+    /// Get the terrain height, normal, and coefficient of friction at the point below the specified location.
+    /// The default implementation calls GetHeight, GetNormal, and GetCoefficientFriction. Terrain models which
+    /// can evaluate all these quantities with a single query should override this function.
+    virtual void GetProperties(const ChVector<>& loc, double& height, ChVector<>& normal, float& friction) const;
+
+    /// Get the terrain height, normal, and coefficient of friction at the points below the specified locations.
+    /// The output vectors are resized to match the number of query locations.
+    /// The default implementation calls GetProperties for each location in turn.
+    virtual void GetProperties(const std::vector<ChVector<>>& loc,
+                               std::vector<double>& height,
+                               std::vector<ChVector<>>& normal,
+                               std::vector<float>& friction) const;
+
     /// Class to be used as a functor interface for location-dependent coefficient of friction.
     class CH_VEHICLE_API FrictionFunctor {
       public:
@@ -492,6 +492,11 @@ void RigidTerrain::Initialize() {
     if (m_patches.empty())
         return;
 
+    // Build the acceleration structures for terrain queries on the patches
+    for (auto patch : m_patches) {
+        patch->Initialize();
+    }
+
     if (m_patches.size() > 1) {
         for (auto patch : m_patches) {
             // Add all patches to the same collision family
@@ -518,7 +523,8 @@ void RigidTerrain::Initialize() {
 // -----------------------------------------------------------------------------
 // Functions for obtaining the terrain height, normal, and coefficient of
 // friction  at the specified location.
-// This is done by casting vertical rays into each patch collision model.
+// This is done by intersecting a vertical ray with each patch (for mesh patches,
+// using the grid of triangles built at initialization).
 // -----------------------------------------------------------------------------
 double RigidTerrain::GetHeight(const ChVector<>& loc) const {
     double height;
@@ -553,6 +559,15 @@ float RigidTerrain::GetCoefficientFriction(const ChVector<>& loc) const {
     return hit ? friction : 0.8f;
 }
 
+void RigidTerrain::GetProperties(const ChVector<>& loc, double& height, ChVector<>& normal, float& friction) const {
+    bool hit = FindPoint(loc, height, normal, friction);
+
+    if (!hit)
+        height = 0.0;
+    if (m_friction_fun)
+        friction = (*m_friction_fun)(loc);
+}
+
 bool RigidTerrain::FindPoint(const ChVector<> loc, double& height, ChVector<>& normal, float& friction) const {
     bool hit = false;
     height = std::numeric_limits<double>::lowest();
@@ -590,7 +605,128 @@ bool RigidTerrain::BoxPatch::FindPoint(const ChVector<>& loc, double& height, Ch
     return std::abs(Cl.x()) <= m_hlength && std::abs(Cl.y()) <= m_hwidth;
 }
 
+// -----------------------------------------------------------------------------
+// Initialize the grid of a mesh patch.
+// The (non-vertical) triangles are expressed in the ISO frame and each triangle is
+// added to all grid cells overlapped by its bounding box in the horizontal plane.
+// The grid cell size is chosen so that there are about as many cells as triangles.
+// -----------------------------------------------------------------------------
+void RigidTerrain::MeshPatch::Initialize() {
+    const auto& vertices = m_trimesh->getCoordsVertices();
+    const auto& faces = m_trimesh->getIndicesVertexes();
+    int num_faces = (int)faces.size();
+
+    m_grid_vertices.resize(3 * num_faces);
+    m_grid_normals.resize(num_faces);
+    m_grid_cell_start.clear();
+    m_grid_triangles.clear();
+    if (num_faces == 0)
+        return;
+
+    // Triangle vertices and normals, and horizontal extent of the mesh (ISO frame)
+    std::vector<bool> active(num_faces, false);
+    double xmin = std::numeric_limits<double>::max();
+    double ymin = std::numeric_limits<double>::max();
+    double xmax = std::numeric_limits<double>::lowest();
+    double ymax = std::numeric_limits<double>::lowest();
+    for (int it = 0; it < num_faces; it++) {
+        ChVector<>* v = &m_grid_vertices[3 * it];
+        for (int k = 0; k < 3; k++) {
+            v[k] = ChWorldFrame::ToISO(m_body->TransformPointLocalToParent(vertices[faces[it][k]]));
+            xmin = std::min(xmin, v[k].x());
+            ymin = std::min(ymin, v[k].y());
+            xmax = std::max(xmax, v[k].x());
+            ymax = std::max(ymax, v[k].y());
+        }
+        ChVector<> nrm = Vcross(v[1] - v[0], v[2] - v[0]);
+        double len = nrm.Length();
+        if (len == 0)
+            continue;
+        nrm /= (nrm.z() < 0) ? -len : len;
+        m_grid_normals[it] = ChWorldFrame::FromISO(nrm);
+        // Vertical triangles cannot be hit by a vertical ray
+        active[it] = nrm.z() > 1e-6;
+    }
+
+    double area = (xmax - xmin) * (ymax - ymin);
+    m_grid_delta = (area > 0) ? std::sqrt(area / num_faces) : std::max(xmax - xmin, ymax - ymin);
+    if (m_grid_delta <= 0)
+        m_grid_delta = 1;
+    m_grid_xmin = xmin;
+    m_grid_ymin = ymin;
+    m_grid_nx = (int)std::floor((xmax - xmin) / m_grid_delta) + 1;
+    m_grid_ny = (int)std::floor((ymax - ymin) / m_grid_delta) + 1;
+
+    // Count triangles in each cell, then fill the cell lists
+    m_grid_cell_start.assign(m_grid_nx * m_grid_ny + 1, 0);
+    for (int pass = 0; pass < 2; pass++) {
+        std::vector<int> cell_next;
+        if (pass == 1) {
+            for (int ic = 0; ic < m_grid_nx * m_grid_ny; ic++)
+                m_grid_cell_start[ic + 1] += m_grid_cell_start[ic];
+            m_grid_triangles.resize(m_grid_cell_start.back());
+            cell_next.assign(m_grid_cell_start.begin(), m_grid_cell_start.end() - 1);
+        }
+        for (int it = 0; it < num_faces; it++) {
+            if (!active[it])
+                continue;
+            const ChVector<>* v = &m_grid_vertices[3 * it];
+            int ix0 = (int)std::floor((std::min({v[0].x(), v[1].x(), v[2].x()}) - xmin) / m_grid_delta);
+            int iy0 = (int)std::floor((std::min({v[0].y(), v[1].y(), v[2].y()}) - ymin) / m_grid_delta);
+            int ix1 = (int)std::floor((std::max({v[0].x(), v[1].x(), v[2].x()}) - xmin) / m_grid_delta);
+            int iy1 = (int)std::floor((std::max({v[0].y(), v[1].y(), v[2].y()}) - ymin) / m_grid_delta);
+            for (int iy = iy0; iy <= std::min(iy1, m_grid_ny - 1); iy++) {
+                for (int ix = ix0; ix <= std::min(ix1, m_grid_nx - 1); ix++) {
+                    int ic = iy * m_grid_nx + ix;
+                    if (pass == 0)
+                        m_grid_cell_start[ic + 1]++;
+                    else
+                        m_grid_triangles[cell_next[ic]++] = it;
+                }
+            }
+        }
+    }
+}
+
 bool RigidTerrain::MeshPatch::FindPoint(const ChVector<>& loc, double& height, ChVector<>& normal) const {
+    if (m_grid_cell_start.empty())
+        return FindPointRayCast(loc, height, normal);
+
+    // Locate the grid cell below the query point
+    ChVector<> p = ChWorldFrame::ToISO(loc);
+    int ix = (int)std::floor((p.x() - m_grid_xmin) / m_grid_delta);
+    int iy = (int)std::floor((p.y() - m_grid_ymin) / m_grid_delta);
+    if (ix < 0 || ix >= m_grid_nx || iy < 0 || iy >= m_grid_ny)
+        return false;
+    int ic = iy * m_grid_nx + ix;
+
+    // Find the highest triangle (in the current cell) containing the projection of the query point.
+    // As with a vertical ray cast, the reported normal is the triangle normal.
+    const double eps = 1e-10;
+    bool hit = false;
+    for (int k = m_grid_cell_start[ic]; k < m_grid_cell_start[ic + 1]; k++) {
+        int it = m_grid_triangles[k];
+        const ChVector<>& a = m_grid_vertices[3 * it + 0];
+        const ChVector<>& b = m_grid_vertices[3 * it + 1];
+        const ChVector<>& c = m_grid_vertices[3 * it + 2];
+        double det = (b.y() - c.y()) * (a.x() - c.x()) + (c.x() - b.x()) * (a.y() - c.y());
+        double l1 = ((b.y() - c.y()) * (p.x() - c.x()) + (c.x() - b.x()) * (p.y() - c.y())) / det;
+        double l2 = ((c.y() - a.y()) * (p.x() - c.x()) + (a.x() - c.x()) * (p.y() - c.y())) / det;
+        double l3 = 1 - l1 - l2;
+        if (l1 < -eps || l2 < -eps || l3 < -eps)
+            continue;
+        double z = l1 * a.z() + l2 * b.z() + l3 * c.z();
+        if (!hit || z > height) {
+            hit = true;
+            height = z;
+            normal = m_grid_normals[it];
+        }
+    }
+
+    return hit;
+}
+
+bool RigidTerrain::MeshPatch::FindPointRayCast(const ChVector<>& loc, double& height, ChVector<>& normal) const {
     ChVector<> from = loc + (m_radius + 1000) * ChWorldFrame::Vertical();
     ChVector<> to = loc - (m_radius + 1000) * ChWorldFrame::Vertical();
 
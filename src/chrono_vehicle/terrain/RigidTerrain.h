@@ -70,6 +70,7 @@ class CH_VEHICLE_API RigidTerrain : public ChTerrain {
         std::shared_ptr<ChBody> GetGroundBody() const { return m_body; }
 
       protected:
+        virtual void Initialize() {}
         virtual bool FindPoint(const ChVector<>& loc, double& height, ChVector<>& normal) const = 0;
         virtual void ExportMeshPovray(const std::string& out_dir, bool smoothed = false) {}
 
@@ -165,11 +166,20 @@ class CH_VEHICLE_API RigidTerrain : public ChTerrain {
     /// See UseLocationDependentFriction.
     virtual float GetCoefficientFriction(const ChVector<>& loc) const override;
 
+    /// Get the terrain height, normal, and coefficient of friction at the point below the specified location.
+    /// All quantities are obtained with a single query into the terrain patches. As with GetCoefficientFriction,
+    /// the coefficient of friction is provided by the user-specified functor, if one was registered.
+    virtual void GetProperties(const ChVector<>& loc, double& height, ChVector<>& normal, float& friction) const override;
+
+    using ChTerrain::GetProperties;
+
     /// Export all patch meshes as macros in PovRay include files.
     void ExportMeshPovray(const std::string& out_dir, bool smoothed = false);
 
     /// Find the terrain height, normal, and coefficient of friction at the point below the specified location.
-    /// The point on the terrain surface is obtained through ray casting into the terrain contact model.
+    /// For box patches, the point on the terrain surface is obtained by intersecting a vertical ray with the top plane.
+    /// For mesh patches, the point is located using a grid over the patch triangles, built at initialization (if
+    /// Initialize was not called, a vertical ray is cast into the patch contact model).
     /// The return value is 'true' if the ray intersection succeeded and 'false' otherwise (in which case
     /// the output is set to heigh=0, normal=[0,0,1], and friction=0.8).
     bool FindPoint(const ChVector<> loc, double& height, ChVector<>& normal, float& friction) const;
@@ -189,10 +199,26 @@ class CH_VEHICLE_API RigidTerrain : public ChTerrain {
     };
 
     /// Patch represented as a mesh.
+    /// At initialization, the mesh triangles are binned in a uniform 2D grid over the horizontal plane of the world
+    /// frame, so that the triangles below a given location can be found without a ray cast into the collision system.
+    /// Terrain queries then report points on the mesh surface itself (i.e., not offset by the collision envelope).
     struct CH_VEHICLE_API MeshPatch : public Patch {
         std::shared_ptr<geometry::ChTriangleMeshConnected> m_trimesh;  ///< associated mesh
         std::string m_mesh_name;                                       ///< name of associated mesh
+
+        std::vector<ChVector<>> m_grid_vertices;  ///< triangle vertices, expressed in the ISO frame (3 per triangle)
+        std::vector<ChVector<>> m_grid_normals;   ///< triangle normals (upward), expressed in the world frame
+        std::vector<int> m_grid_cell_start;       ///< start of the list of triangles of each cell (size ncells + 1)
+        std::vector<int> m_grid_triangles;        ///< indices of the triangles overlapping each grid cell
+        double m_grid_xmin;                       ///< minimum x coordinate of grid (ISO frame)
+        double m_grid_ymin;                       ///< minimum y coordinate of grid (ISO frame)
+        double m_grid_delta;                      ///< grid cell size
+        int m_grid_nx;                            ///< number of grid cells in x direction
+        int m_grid_ny;                            ///< number of grid cells in y direction
+
+        virtual void Initialize() override;
         virtual bool FindPoint(const ChVector<>& loc, double& height, ChVector<>& normal) const override;
+        bool FindPointRayCast(const ChVector<>& loc, double& height, ChVector<>& normal) const;
         virtual void ExportMeshPovray(const std::string& out_dir, bool smoothed = false) override;
     };
 
@@ -17,9 +17,11 @@
 //
 // =============================================================================
 
+#include <algorithm>
 #include <cstdio>
 #include <cmath>
 #include <queue>
+#include <unordered_set>
 
 #include "chrono/physics/ChMaterialSurfaceNSC.h"
 #include "chrono/physics/ChMaterialSurfaceSMC.h"
@@ -189,6 +191,11 @@ void SCMDeformableTerrain::Initialize(double height, double sizeX, double sizeY,
     m_ground->Initialize(height, sizeX, sizeY, divX, divY);
 }
 
+// Initialize the terrain as a flat structured grid with sparse storage
+void SCMDeformableTerrain::InitializeGrid(double height, double sizeX, double sizeY, double delta) {
+    m_ground->InitializeGrid(height, sizeX, sizeY, delta);
+}
+
 // Initialize the terrain from a specified .obj mesh file.
 void SCMDeformableTerrain::Initialize(const std::string& mesh_file) {
     m_ground->Initialize(mesh_file);
@@ -230,6 +237,8 @@ void SCMDeformableTerrain::PrintStepStatistics(std::ostream& os) const {
     os << "   Number vertices:         " << m_ground->m_num_vertices << std::endl;
     os << "   Number ray-casts:        " << m_ground->m_num_ray_casts << std::endl;
     os << "   Number faces:            " << m_ground->m_num_faces << std::endl;
+    if (m_ground->m_grid)
+        os << "   Number grid tiles:       " << m_ground->m_num_tiles << std::endl;
     if (m_ground->do_refinement)
         os << "   Number faces refinement: " << m_ground->m_num_marked_faces << std::endl;
 }
@@ -238,8 +247,11 @@ void SCMDeformableTerrain::PrintStepStatistics(std::ostream& os) const {
 // Implementation of SCMDeformableSoil
 // -----------------------------------------------------------------------------
 
+// Number of grid nodes on the side of a tile (structured grid storage).
+static const int tile_size = 16;
+
 // Constructor.
-SCMDeformableSoil::SCMDeformableSoil(ChSystem* system) : m_soil_fun(nullptr) {
+SCMDeformableSoil::SCMDeformableSoil(ChSystem* system) : m_grid(false), m_delta(0), m_soil_fun(nullptr) {
     this->SetSystem(system);
 
     // Create the default mesh asset
@@ -283,10 +295,15 @@ SCMDeformableSoil::SCMDeformableSoil(ChSystem* system) : m_soil_fun(nullptr) {
     last_t = 0;
 
     m_moving_patch = false;
+
+    m_num_tiles = 0;
 }
 
 // Initialize the terrain as a flat grid
 void SCMDeformableSoil::Initialize(double height, double sizeX, double sizeY, int nX, int nY) {
+    m_grid = false;
+    m_tiles.clear();
+    m_touched_tiles.clear();
     m_trimesh_shape->GetMesh()->Clear();
     // Readability aliases
     auto trimesh = m_trimesh_shape->GetMesh();
@@ -350,6 +367,9 @@ void SCMDeformableSoil::Initialize(double height, double sizeX, double sizeY, in
 
 // Initialize the terrain from a specified .obj mesh file.
 void SCMDeformableSoil::Initialize(const std::string& mesh_file) {
+    m_grid = false;
+    m_tiles.clear();
+    m_touched_tiles.clear();
     m_trimesh_shape->GetMesh()->Clear();
     m_trimesh_shape->GetMesh()->LoadWavefrontMesh(mesh_file, true, true);
 
@@ -364,6 +384,9 @@ void SCMDeformableSoil::Initialize(const std::string& heightmap_file,
                                    double sizeY,
                                    double hMin,
                                    double hMax) {
+    m_grid = false;
+    m_tiles.clear();
+    m_touched_tiles.clear();
     auto trimesh = m_trimesh_shape->GetMesh();
     trimesh->Clear();
 
@@ -476,6 +499,42 @@ void SCMDeformableSoil::Initialize(const std::string& heightmap_file,
     SetupAuxData();
 }
 
+// Initialize the terrain as a flat structured grid with sparse storage.
+// No mesh data is created here: grid tiles (and their visualization) are allocated as nodes get deformed.
+void SCMDeformableSoil::InitializeGrid(double height, double sizeX, double sizeY, double delta) {
+    m_grid = true;
+    m_height = height;
+    m_delta = delta;
+    m_ix_min = (int)std::ceil(-0.5 * sizeX / delta);
+    m_ix_max = (int)std::floor(0.5 * sizeX / delta);
+    m_iy_min = (int)std::ceil(-0.5 * sizeY / delta);
+    m_iy_max = (int)std::floor(0.5 * sizeY / delta);
+    m_tiles.clear();
+    m_touched_tiles.clear();
+
+    // Release all data used by the mesh storage
+    m_trimesh_shape->GetMesh()->Clear();
+    std::vector<ChVector<>>().swap(p_vertices_initial);
+    std::vector<ChVector<>>().swap(p_speeds);
+    std::vector<double>().swap(p_level);
+    std::vector<double>().swap(p_level_initial);
+    std::vector<double>().swap(p_hit_level);
+    std::vector<double>().swap(p_sinkage);
+    std::vector<double>().swap(p_sinkage_plastic);
+    std::vector<double>().swap(p_sinkage_elastic);
+    std::vector<double>().swap(p_step_plastic_flow);
+    std::vector<double>().swap(p_kshear);
+    std::vector<double>().swap(p_area);
+    std::vector<double>().swap(p_sigma);
+    std::vector<double>().swap(p_sigma_yeld);
+    std::vector<double>().swap(p_tau);
+    std::vector<double>().swap(p_massremainder);
+    std::vector<int>().swap(p_id_island);
+    std::vector<bool>().swap(p_erosion);
+    std::vector<std::set<int>>().swap(connected_vertexes);
+    std::vector<std::array<int, 4>>().swap(tri_map);
+}
+
 // Set up auxiliary data structures.
 void SCMDeformableSoil::SetupAuxData() {
     // better readability:
@@ -520,8 +579,214 @@ void SCMDeformableSoil::SetupAuxData() {
     m_trimesh_shape->GetMesh()->ComputeNeighbouringTriangleMap(this->tri_map);
 }
 
+// Apply a force at the given point on the contactable object and accumulate it in the map of contact forces.
+void SCMDeformableSoil::AddContactForce(ChContactable* contactable, const ChVector<>& point, const ChVector<>& force) {
+    if (ChBody* rigidbody = dynamic_cast<ChBody*>(contactable)) {
+        // [](){} Trick: no deletion for this shared ptr, since 'rigidbody' was not a new ChBody()
+        // object, but an already used pointer because mrayhit_result.hitModel->GetPhysicsItem()
+        // cannot return it as shared_ptr, as needed by the ChLoadBodyForce:
+        std::shared_ptr<ChBody> srigidbody(rigidbody, [](ChBody*) {});
+        std::shared_ptr<ChLoadBodyForce> mload(new ChLoadBodyForce(srigidbody, force, false, point, false));
+        this->Add(mload);
+
+        // Accumulate contact force for this rigid body.
+        // The resultant force is assumed to be applied at the body COM.
+        // All components of the generalized terrain force are expressed in the global frame.
+        auto itr = m_contact_forces.find(contactable);
+        if (itr == m_contact_forces.end()) {
+            // Create new entry and initialize generalized force.
+            TerrainForce frc;
+            frc.point = srigidbody->GetPos();
+            frc.force = force;
+            frc.moment = Vcross(Vsub(point, srigidbody->GetPos()), force);
+            m_contact_forces.insert(std::make_pair(contactable, frc));
+        } else {
+            // Update generalized force.
+            itr->second.force += force;
+            itr->second.moment += Vcross(Vsub(point, srigidbody->GetPos()), force);
+        }
+    } else if (ChLoadableUV* surf = dynamic_cast<ChLoadableUV*>(contactable)) {
+        // [](){} Trick: no deletion for this shared ptr
+        std::shared_ptr<ChLoadableUV> ssurf(surf, [](ChLoadableUV*) {});
+        std::shared_ptr<ChLoad<ChLoaderForceOnSurface>> mload(new ChLoad<ChLoaderForceOnSurface>(ssurf));
+        mload->loader.SetForce(force);
+        mload->loader.SetApplication(0.5, 0.5);  //***TODO*** set UV, now just in middle
+        this->Add(mload);
+
+        // Accumulate contact forces for this surface.
+        //// TODO
+    }
+}
+
+// -----------------------------------------------------------------------------
+// SCM soil model, shared by the mesh and grid storage modes
+// -----------------------------------------------------------------------------
+
+SCMDeformableSoil::NodeState SCMDeformableSoil::GetMeshNodeState(int i) {
+    return {p_level[i],          p_level_initial[i], p_hit_level[i], p_sinkage[i],
+            p_sinkage_plastic[i], p_sinkage_elastic[i], p_step_plastic_flow[i], p_kshear[i],
+            p_sigma[i],          p_sigma_yeld[i],    p_tau[i],       p_massremainder[i]};
+}
+
+SCMDeformableSoil::NodeState SCMDeformableSoil::GetGridNodeState(NodeRecord& node) {
+    return {node.level,           node.level_initial,   node.hit_level,         node.sinkage,
+            node.sinkage_plastic, node.sinkage_elastic, node.step_plastic_flow, node.kshear,
+            node.sigma,           node.sigma_yeld,      node.tau,               node.massremainder};
+}
+
+SCMDeformableSoil::SoilParameters SCMDeformableSoil::GetSoilParameters(const ChVector<>& loc_point) const {
+    if (!m_soil_fun) {
+        return {m_Bekker_Kphi,    m_Bekker_Kc,    m_Bekker_n,  m_Mohr_cohesion,
+                m_Mohr_friction,  m_Janosi_shear, m_elastic_K, m_damping_R};
+    }
+
+    m_soil_fun->Set(loc_point.x(), loc_point.y());
+    return {m_soil_fun->m_Bekker_Kphi,   m_soil_fun->m_Bekker_Kc,    m_soil_fun->m_Bekker_n,
+            m_soil_fun->m_Mohr_cohesion, m_soil_fun->m_Mohr_friction, m_soil_fun->m_Janosi_shear,
+            m_soil_fun->m_elastic_K,     m_soil_fun->m_damping_R};
+}
+
+// Calculate area and perimeter of the convex hull of the patch points.
+double SCMDeformableSoil::CalcPatchOOB(std::vector<ChVector2<>>& points) {
+    utils::ChConvexHull2D ch(points);
+    double area = ch.GetArea();
+    if (area < 1e-6)
+        return 0;
+    return ch.GetPerimeter() / (2 * area);
+}
+
+// Use the SCM soil contact model as described in the paper:
+// "Parameter Identification of a Planetary Rover Wheel-Soil
+// Contact Model via a Bayesian Approach", A.Gallina, R. Krenn et al.
+bool SCMDeformableSoil::CalcNodeForce(NodeState node,
+                                      const SoilParameters& soil,
+                                      double oob,
+                                      const ChVector<>& speed,
+                                      double area,
+                                      const ChVector<>& N,
+                                      ChVector<>& force) {
+    double hit_offset = -node.hit_level + node.level_initial;
+
+    ChVector<> T = -speed;
+    T = plane.TransformDirectionParentToLocal(T);
+    double Vn = -T.z();
+    T.z() = 0;
+    T = plane.TransformDirectionLocalToParent(T);
+    T.Normalize();
+
+    // Elastic try:
+    node.sigma = soil.elastic_K * (hit_offset - node.sinkage_plastic);
+
+    // Handle unilaterality:
+    if (node.sigma < 0) {
+        node.sigma = 0;
+        return false;
+    }
+
+    node.sinkage = hit_offset;
+    node.level = node.hit_level;
+
+    // Accumulate shear for Janosi-Hanamoto
+    node.kshear += Vdot(speed, -T) * GetSystem()->GetStep();
+
+    // Plastic correction:
+    if (node.sigma > node.sigma_yeld) {
+        // Bekker formula
+        node.sigma = (oob * soil.Bekker_Kc + soil.Bekker_Kphi) * pow(node.sinkage, soil.Bekker_n);
+        node.sigma_yeld = node.sigma;
+        double old_sinkage_plastic = node.sinkage_plastic;
+        node.sinkage_plastic = node.sinkage - node.sigma / soil.elastic_K;
+        node.step_plastic_flow = (node.sinkage_plastic - old_sinkage_plastic) / GetSystem()->GetStep();
+    }
+
+    node.sinkage_elastic = node.sinkage - node.sinkage_plastic;
+
+    // add compressive speed-proportional damping (not clamped by pressure yield)
+    node.sigma += -Vn * soil.damping_R;
+
+    // Mohr-Coulomb
+    double tau_max = soil.Mohr_cohesion + node.sigma * tan(soil.Mohr_friction * CH_C_DEG_TO_RAD);
+
+    // Janosi-Hanamoto
+    node.tau = tau_max * (1.0 - exp(-(node.kshear / soil.Janosi_shear)));
+
+    ChVector<> Fn = N * area * node.sigma;
+    ChVector<> Ft = T * area * node.tau;
+    force = Fn + Ft;
+
+    return true;
+}
+
+// Clamp the upward correction as it might invalidate the ceiling constraint, if collision is nearby.
+double SCMDeformableSoil::RaiseNode(NodeState node, double d_y) {
+    double clamped_d_y = d_y;
+    if (d_y > node.hit_level - node.level) {
+        node.massremainder += d_y - (node.hit_level - node.level);
+        clamped_d_y = node.hit_level - node.level;
+    }
+    node.level += clamped_d_y;
+    node.level_initial += clamped_d_y;
+    return clamped_d_y;
+}
+
+double SCMDeformableSoil::LowerNode(NodeState node, double d_y) {
+    double clamped_d_y = d_y;
+    if (node.massremainder > -d_y) {
+        node.massremainder -= -d_y;
+        clamped_d_y = 0;
+    } else if ((node.massremainder < -d_y) && (node.massremainder > 0)) {
+        node.massremainder = 0;
+        clamped_d_y = d_y + node.massremainder;
+    }
+    node.level += clamped_d_y;
+    node.level_initial += clamped_d_y;
+    return clamped_d_y;
+}
+
+void SCMDeformableSoil::ErodeNodes(NodeState ni,
+                                   NodeState nc,
+                                   double area_i,
+                                   double area_c,
+                                   double nbr_fraction,
+                                   double dist,
+                                   double& d_y_i,
+                                   double& d_y_c) const {
+    d_y_i = 0;
+    d_y_c = 0;
+
+    // flow remainder material (if i higher than c: raise c, lower i)
+    if (ni.massremainder > nc.massremainder) {
+        double d_y = (ni.massremainder - nc.massremainder) * nbr_fraction * area_i / (area_i + area_c);
+        d_y_c += RaiseNode(nc, d_y);
+        d_y_i += LowerNode(ni, -d_y * area_c / area_i);
+    }
+
+    // smooth
+    if (nc.sigma == 0) {
+        double dy = ni.level + ni.massremainder - nc.level - nc.massremainder;
+        double dy_lim = dist * tan(bulldozing_erosion_angle * CH_C_DEG_TO_RAD);
+        if (fabs(dy) > dy_lim) {
+            double d_y = (fabs(dy) - dy_lim) * nbr_fraction * area_i / (area_i + area_c);
+            if (dy > 0) {
+                // if i higher than c: raise c, lower i
+                d_y_c += RaiseNode(nc, d_y);
+                d_y_i += LowerNode(ni, -d_y * area_c / area_i);
+            } else {
+                // if c higher than i: raise i, lower c
+                d_y_i += RaiseNode(ni, d_y);
+                d_y_c += LowerNode(nc, -d_y * area_i / area_c);
+            }
+        }
+    }
+}
+
 // Reset the list of forces, and fills it with forces from a soil contact model.
 void SCMDeformableSoil::ComputeInternalForces() {
+    if (m_grid) {
+        ComputeInternalForcesGrid();
+        return;
+    }
+
     m_timer_calc_areas.reset();
     m_timer_ray_casting.reset();
     m_timer_refinement.reset();
@@ -578,7 +843,6 @@ void SCMDeformableSoil::ComputeInternalForces() {
     //
 
     m_timer_ray_casting.start();
-    m_num_ray_casts = 0;
 
     // If enabled, update the extent of the moving patches (no ray-hit tests performed outside)
     if (m_moving_patch) {
@@ -597,14 +861,10 @@ void SCMDeformableSoil::ComputeInternalForces() {
     // Loop through all vertices.
     // - set default SCM quantities (in case no ray-hit)
     // - skip vertices outside moving patch (if option enabled)
-    // - cast ray and record result in a map (key: vertex index)
-    // - initialize patch id to -1 (not set)
-    struct HitRecord {
-        ChContactable* contactable;  // pointer to hit object
-        ChVector<> abs_point;        // hit point, expressed in global frame
-        int patch_id;                // index of associated patch id
-    };
-    std::unordered_map<int, HitRecord> hits;
+    // - collect the ray to be cast from the vertex
+    std::vector<int> ray_vertices;
+    std::vector<ChVector<>> ray_from;
+    std::vector<ChVector<>> ray_to;
 
     for (int i = 0; i < vertices.size(); ++i) {
         auto v = plane.TransformParentToLocal(vertices[i]);
@@ -630,15 +890,33 @@ void SCMDeformableSoil::ComputeInternalForces() {
                 continue;
         }
 
-        // Perform ray casting from current vertex
-        collision::ChCollisionSystem::ChRayhitResult mrayhit_result;
+        // Ray to be cast from current vertex
         ChVector<> to = vertices[i] + N * test_high_offset;
         ChVector<> from = to - N * test_low_offset;
-        this->GetSystem()->GetCollisionSystem()->RayHit(from, to, mrayhit_result);
-        m_num_ray_casts++;
+        ray_vertices.push_back(i);
+        ray_from.push_back(from);
+        ray_to.push_back(to);
+    }
+
+    // Cast all rays in a single batch (processed in parallel if supported by the collision system)
+    std::vector<collision::ChCollisionSystem::ChRayhitResult> ray_results;
+    this->GetSystem()->GetCollisionSystem()->RayHitBatch(ray_from, ray_to, ray_results);
+    m_num_ray_casts = ray_vertices.size();
+
+    // Record ray-hit results in a map (key: vertex index).
+    // Initialize patch id to -1 (not set).
+    struct HitRecord {
+        ChContactable* contactable;  // pointer to hit object
+        ChVector<> abs_point;        // hit point, expressed in global frame
+        int patch_id;                // index of associated patch id
+    };
+    std::unordered_map<int, HitRecord> hits;
+
+    for (size_t k = 0; k < ray_vertices.size(); ++k) {
+        const auto& mrayhit_result = ray_results[k];
         if (mrayhit_result.hit) {
             HitRecord record = {mrayhit_result.hitModel->GetContactable(), mrayhit_result.abs_hitPoint, -1};
-            hits.insert(std::make_pair(i, record));
+            hits.insert(std::make_pair(ray_vertices[k], record));
         }
     }
 
@@ -674,8 +952,6 @@ void SCMDeformableSoil::ComputeInternalForces() {
     // Collect hit vertices assigned to each patch.
     struct PatchRecord {
         std::vector<ChVector2<>> points;  // points in patch (projected on reference plane)
-        double area;                      // patch area
-        double perimeter;                 // patch perimeter
         double oob;                       // approximate value of 1/b
     };
     std::vector<PatchRecord> patches(num_patches);
@@ -684,156 +960,31 @@ void SCMDeformableSoil::ComputeInternalForces() {
         patches[h.second.patch_id].points.push_back(ChVector2<>(v.x(), v.y()));
     }
 
-    // Calculate area and perimeter of each patch.
     // Calculate approximation to Beker term 1/b.
-    for (auto& p : patches) {
-        utils::ChConvexHull2D ch(p.points);
-        p.area = ch.GetArea();
-        p.perimeter = ch.GetPerimeter();
-        if (p.area < 1e-6) {
-            p.oob = 0;
-        } else {
-            p.oob = p.perimeter / (2 * p.area);
-        }
-    }
-
-    // Initialize local values for the soil parameters
-    double Bekker_Kphi = m_Bekker_Kphi;
-    double Bekker_Kc = m_Bekker_Kc;
-    double Bekker_n = m_Bekker_n;
-    double Mohr_cohesion = m_Mohr_cohesion;
-    double Mohr_friction = m_Mohr_friction;
-    double Janosi_shear = m_Janosi_shear;
-    double elastic_K = m_elastic_K;
-    double damping_R = m_damping_R;
+    for (auto& p : patches)
+        p.oob = CalcPatchOOB(p.points);
 
     // Process only hit vertices
     for (auto& h : hits) {
         int i = h.first;
         ChContactable* contactable = h.second.contactable;
-        const ChVector<>& abs_point = h.second.abs_point;
         int patch_id = h.second.patch_id;
 
-        auto loc_point = plane.TransformParentToLocal(abs_point);
-
-        if (m_soil_fun) {
-            m_soil_fun->Set(loc_point.x(), loc_point.y());
-
-            Bekker_Kphi = m_soil_fun->m_Bekker_Kphi;
-            Bekker_Kc = m_soil_fun->m_Bekker_Kc;
-            Bekker_n = m_soil_fun->m_Bekker_n;
-            Mohr_cohesion = m_soil_fun->m_Mohr_cohesion;
-            Mohr_friction = m_soil_fun->m_Mohr_friction;
-            Janosi_shear = m_soil_fun->m_Janosi_shear;
-            elastic_K = m_soil_fun->m_elastic_K;
-            damping_R = m_soil_fun->m_damping_R;
-        }
+        auto loc_point = plane.TransformParentToLocal(h.second.abs_point);
+        SoilParameters soil = GetSoilParameters(loc_point);
 
         p_hit_level[i] = loc_point.z();
-        double p_hit_offset = -p_hit_level[i] + p_level_initial[i];
-
         p_speeds[i] = contactable->GetContactPointSpeed(vertices[i]);
 
-        ChVector<> T = -p_speeds[i];
-        T = plane.TransformDirectionParentToLocal(T);
-        double Vn = -T.z();
-        T.z() = 0;
-        T = plane.TransformDirectionLocalToParent(T);
-        T.Normalize();
-
-        // Compute i-th force:
-        ChVector<> Fn;
-        ChVector<> Ft;
+        ChVector<> force;
+        if (!CalcNodeForce(GetMeshNodeState(i), soil, patches[patch_id].oob, p_speeds[i], p_area[i], N, force))
+            continue;
 
-        // Elastic try:
-        p_sigma[i] = elastic_K * (p_hit_offset - p_sinkage_plastic[i]);
+        AddContactForce(contactable, vertices[i], force);
 
-        // Handle unilaterality:
-        if (p_sigma[i] < 0) {
-            p_sigma[i] = 0;
-        } else {
-            // add compressive speed-proportional damping
-            ////if (Vn < 0) {
-            ////    p_sigma[i] += -Vn * this->damping_R;
-            ////}
-
-            p_sinkage[i] = p_hit_offset;
-            p_level[i] = p_hit_level[i];
-
-            // Accumulate shear for Janosi-Hanamoto
-            p_kshear[i] += Vdot(p_speeds[i], -T) * GetSystem()->GetStep();
-
-            // Plastic correction:
-            if (p_sigma[i] > p_sigma_yeld[i]) {
-                // Bekker formula
-                p_sigma[i] = (patches[patch_id].oob * Bekker_Kc + Bekker_Kphi) * pow(p_sinkage[i], Bekker_n);
-                p_sigma_yeld[i] = p_sigma[i];
-                double old_sinkage_plastic = p_sinkage_plastic[i];
-                p_sinkage_plastic[i] = p_sinkage[i] - p_sigma[i] / elastic_K;
-                p_step_plastic_flow[i] = (p_sinkage_plastic[i] - old_sinkage_plastic) / GetSystem()->GetStep();
-            }
-
-            p_sinkage_elastic[i] = p_sinkage[i] - p_sinkage_plastic[i];
-
-            // add compressive speed-proportional damping (not clamped by pressure yield)
-            ////if (Vn < 0) {
-            p_sigma[i] += -Vn * damping_R;
-            ////}
-
-            // Mohr-Coulomb
-            double tau_max = Mohr_cohesion + p_sigma[i] * tan(Mohr_friction * CH_C_DEG_TO_RAD);
-
-            // Janosi-Hanamoto
-            p_tau[i] = tau_max * (1.0 - exp(-(p_kshear[i] / Janosi_shear)));
-
-            Fn = N * p_area[i] * p_sigma[i];
-            Ft = T * p_area[i] * p_tau[i];
-
-            if (ChBody* rigidbody = dynamic_cast<ChBody*>(contactable)) {
-                // [](){} Trick: no deletion for this shared ptr, since 'rigidbody' was not a new ChBody()
-                // object, but an already used pointer because mrayhit_result.hitModel->GetPhysicsItem()
-                // cannot return it as shared_ptr, as needed by the ChLoadBodyForce:
-                std::shared_ptr<ChBody> srigidbody(rigidbody, [](ChBody*) {});
-                std::shared_ptr<ChLoadBodyForce> mload(
-                    new ChLoadBodyForce(srigidbody, Fn + Ft, false, vertices[i], false));
-                this->Add(mload);
-
-                // Accumulate contact force for this rigid body.
-                // The resultant force is assumed to be applied at the body COM.
-                // All components of the generalized terrain force are expressed in the global frame.
-                auto itr = m_contact_forces.find(contactable);
-                if (itr == m_contact_forces.end()) {
-                    // Create new entry and initialize generalized force.
-                    ChVector<> force = Fn + Ft;
-                    TerrainForce frc;
-                    frc.point = srigidbody->GetPos();
-                    frc.force = force;
-                    frc.moment = Vcross(Vsub(vertices[i], srigidbody->GetPos()), force);
-                    m_contact_forces.insert(std::make_pair(contactable, frc));
-                } else {
-                    // Update generalized force.
-                    ChVector<> force = Fn + Ft;
-                    itr->second.force += force;
-                    itr->second.moment += Vcross(Vsub(vertices[i], srigidbody->GetPos()), force);
-                }
-            } else if (ChLoadableUV* surf = dynamic_cast<ChLoadableUV*>(contactable)) {
-                // [](){} Trick: no deletion for this shared ptr
-                std::shared_ptr<ChLoadableUV> ssurf(surf, [](ChLoadableUV*) {});
-                std::shared_ptr<ChLoad<ChLoaderForceOnSurface>> mload(new ChLoad<ChLoaderForceOnSurface>(ssurf));
-                mload->loader.SetForce(Fn + Ft);
-                mload->loader.SetApplication(0.5, 0.5);  //***TODO*** set UV, now just in middle
-                this->Add(mload);
-
-                // Accumulate contact forces for this surface.
-                //// TODO
-            }
-
-            // Update mesh representation
-            vertices[i] = p_vertices_initial[i] - N * p_sinkage[i];
-
-        }  // end positive contact force
-
-    }  // end loop on ray hits
+        // Update mesh representation
+        vertices[i] = p_vertices_initial[i] - N * p_sinkage[i];
+    }
 
     m_timer_ray_casting.stop();
 
@@ -1004,13 +1155,7 @@ void SCMDeformableSoil::ComputeInternalForces() {
             for (const auto& ibv : boundary) {
                 double d_y = bulldozing_flow_factor *
                              ((p_area[ibv] / tot_area_boundary) * (1 / p_area[ibv]) * tot_step_flow_island);
-                double clamped_d_y = d_y;  // ChMin(d_y, ChMin(p_hit_level[ibv]-p_level[ibv], test_high_offset) );
-                if (d_y > p_hit_level[ibv] - p_level[ibv]) {
-                    p_massremainder[ibv] += d_y - (p_hit_level[ibv] - p_level[ibv]);
-                    clamped_d_y = p_hit_level[ibv] - p_level[ibv];
-                }
-                p_level[ibv] += clamped_d_y;
-                p_level_initial[ibv] += clamped_d_y;
+                double clamped_d_y = RaiseNode(GetMeshNodeState(ibv), d_y);
                 vertices[ibv] += N * clamped_d_y;
                 p_vertices_initial[ibv] += N * clamped_d_y;
             }
@@ -1029,7 +1174,7 @@ void SCMDeformableSoil::ComputeInternalForces() {
         for (const auto& ie : domain_boundaries)
             p_erosion[ie] = true;
         std::set<int> front_erosion = domain_boundaries;
-        for (int iloop = 0; iloop < 10; ++iloop) {
+        for (int iloop = 0; iloop < bulldozing_erosion_n_propagations; ++iloop) {
             std::set<int> front_erosion2;
             for (const auto& is : front_erosion) {
                 for (const auto& ivconnect : connected_vertexes[is]) {
@@ -1043,111 +1188,21 @@ void SCMDeformableSoil::ComputeInternalForces() {
             front_erosion = front_erosion2;
         }
         // Erosion smoothing algorithm on domain
-        for (int ismo = 0; ismo < 3; ++ismo) {
+        for (int ismo = 0; ismo < bulldozing_erosion_n_iterations; ++ismo) {
             for (const auto& is : domain_erosion) {
                 for (const auto& ivc : connected_vertexes[is]) {
-                    ChVector<> vis = this->plane.TransformParentToLocal(vertices[is]);
-                    // flow remainder material
-                    if (true) {
-                        if (p_massremainder[is] > p_massremainder[ivc]) {
-                            double clamped_d_y_i;
-                            double clamped_d_y_c;
-
-                            // if i higher than c: clamp c upward correction as it might invalidate
-                            // the ceiling constraint, if collision is nearby
-                            double d_y_c = (p_massremainder[is] - p_massremainder[ivc]) *
-                                           (1 / (double)connected_vertexes[is].size()) * p_area[is] /
-                                           (p_area[is] + p_area[ivc]);
-                            clamped_d_y_c = d_y_c;
-                            if (d_y_c > p_hit_level[ivc] - p_level[ivc]) {
-                                p_massremainder[ivc] += d_y_c - (p_hit_level[ivc] - p_level[ivc]);
-                                clamped_d_y_c = p_hit_level[ivc] - p_level[ivc];
-                            }
-                            double d_y_i = -d_y_c * p_area[ivc] / p_area[is];
-                            clamped_d_y_i = d_y_i;
-                            if (p_massremainder[is] > -d_y_i) {
-                                p_massremainder[is] -= -d_y_i;
-                                clamped_d_y_i = 0;
-                            } else if ((p_massremainder[is] < -d_y_i) && (p_massremainder[is] > 0)) {
-                                p_massremainder[is] = 0;
-                                clamped_d_y_i = d_y_i + p_massremainder[is];
-                            }
-
-                            // correct vertexes
-                            p_level[ivc] += clamped_d_y_c;
-                            p_level_initial[ivc] += clamped_d_y_c;
-                            vertices[ivc] += N * clamped_d_y_c;
-                            p_vertices_initial[ivc] += N * clamped_d_y_c;
-
-                            p_level[is] += clamped_d_y_i;
-                            p_level_initial[is] += clamped_d_y_i;
-                            vertices[is] += N * clamped_d_y_i;
-                            p_vertices_initial[is] += N * clamped_d_y_i;
-                        }
-                    }
-                    // smooth
-                    if (p_sigma[ivc] == 0) {
-                        ChVector<> vic = this->plane.TransformParentToLocal(vertices[ivc]);
-                        ChVector<> vdist = vic - vis;
-                        vdist.z() = 0;
-                        double ddist = vdist.Length();
-                        double dy = p_level[is] + p_massremainder[is] - p_level[ivc] - p_massremainder[ivc];
-                        double dy_lim = ddist * tan(bulldozing_erosion_angle * CH_C_DEG_TO_RAD);
-                        if (fabs(dy) > dy_lim) {
-                            double clamped_d_y_i;
-                            double clamped_d_y_c;
-                            if (dy > 0) {
-                                // if i higher than c: clamp c upward correction as it might invalidate
-                                // the ceiling constraint, if collision is nearby
-                                double d_y_c = (fabs(dy) - dy_lim) * (1 / (double)connected_vertexes[is].size()) *
-                                               p_area[is] / (p_area[is] + p_area[ivc]);
-                                clamped_d_y_c = d_y_c;  // clamped_d_y_c = ChMin(d_y_c, p_hit_level[ivc]-p_level[ivc] );
-                                if (d_y_c > p_hit_level[ivc] - p_level[ivc]) {
-                                    p_massremainder[ivc] += d_y_c - (p_hit_level[ivc] - p_level[ivc]);
-                                    clamped_d_y_c = p_hit_level[ivc] - p_level[ivc];
-                                }
-                                double d_y_i = -d_y_c * p_area[ivc] / p_area[is];
-                                clamped_d_y_i = d_y_i;
-                                if (p_massremainder[is] > -d_y_i) {
-                                    p_massremainder[is] -= -d_y_i;
-                                    clamped_d_y_i = 0;
-                                } else if ((p_massremainder[is] < -d_y_i) && (p_massremainder[is] > 0)) {
-                                    p_massremainder[is] = 0;
-                                    clamped_d_y_i = d_y_i + p_massremainder[is];
-                                }
-                            } else {
-                                // if c higher than i: clamp i upward correction as it might invalidate
-                                // the ceiling constraint, if collision is nearby
-                                double d_y_i = (fabs(dy) - dy_lim) * (1 / (double)connected_vertexes[is].size()) *
-                                               p_area[is] / (p_area[is] + p_area[ivc]);
-                                clamped_d_y_i = d_y_i;
-                                if (d_y_i > p_hit_level[is] - p_level[is]) {
-                                    p_massremainder[is] += d_y_i - (p_hit_level[is] - p_level[is]);
-                                    clamped_d_y_i = p_hit_level[is] - p_level[is];
-                                }
-                                double d_y_c = -d_y_i * p_area[is] / p_area[ivc];
-                                clamped_d_y_c = d_y_c;
-                                if (p_massremainder[ivc] > -d_y_c) {
-                                    p_massremainder[ivc] -= -d_y_c;
-                                    clamped_d_y_c = 0;
-                                } else if ((p_massremainder[ivc] < -d_y_c) && (p_massremainder[ivc] > 0)) {
-                                    p_massremainder[ivc] = 0;
-                                    clamped_d_y_c = d_y_c + p_massremainder[ivc];
-                                }
-                            }
-
-                            // correct vertexes
-                            p_level[ivc] += clamped_d_y_c;
-                            p_level_initial[ivc] += clamped_d_y_c;
-                            vertices[ivc] += N * clamped_d_y_c;
-                            p_vertices_initial[ivc] += N * clamped_d_y_c;
-
-                            p_level[is] += clamped_d_y_i;
-                            p_level_initial[is] += clamped_d_y_i;
-                            vertices[is] += N * clamped_d_y_i;
-                            p_vertices_initial[is] += N * clamped_d_y_i;
-                        }
-                    }
+                    ChVector<> vdist = this->plane.TransformDirectionParentToLocal(vertices[ivc] - vertices[is]);
+                    vdist.z() = 0;
+                    double d_y_i;
+                    double d_y_c;
+                    ErodeNodes(GetMeshNodeState(is), GetMeshNodeState(ivc), p_area[is], p_area[ivc],
+                               1 / (double)connected_vertexes[is].size(), vdist.Length(), d_y_i, d_y_c);
+
+                    // correct vertexes
+                    vertices[ivc] += N * d_y_c;
+                    p_vertices_initial[ivc] += N * d_y_c;
+                    vertices[is] += N * d_y_i;
+                    p_vertices_initial[is] += N * d_y_i;
                 }
             }
         }
@@ -1267,5 +1322,550 @@ void SCMDeformableSoil::ComputeInternalForces() {
     //  ChPhysicsItem::Update(0, true);
 }
 
+// -----------------------------------------------------------------------------
+// Structured grid storage
+// -----------------------------------------------------------------------------
+
+// Key of a grid tile (or grid node) in a hash map.
+static unsigned long long GridKey(int i, int j) {
+    return ((unsigned long long)(unsigned int)i << 32) | (unsigned int)j;
+}
+
+// Index of the tile containing the grid node with given index (floor division).
+static int TileIndex(int i) {
+    return (i >= 0) ? i / tile_size : -((-i + tile_size - 1) / tile_size);
+}
+
+// Offsets to the neighbors of a grid node.
+// These are the neighbors of a vertex in a regular grid triangulated along the (1,1) diagonal, as in the mesh created
+// by SCMDeformableTerrain::Initialize, listed in the same order as the (sorted) adjacent vertices of a mesh vertex.
+static const int grid_nbr[6][2] = {{-1, -1}, {0, -1}, {-1, 0}, {1, 0}, {0, 1}, {1, 1}};
+
+// Order of grid nodes matching the order of the vertex indices in the mesh created by SCMDeformableTerrain::Initialize.
+static bool GridNodeLess(const ChVector2<int>& a, const ChVector2<int>& b) {
+    return a.y() < b.y() || (a.y() == b.y() && a.x() < b.x());
+}
+
+SCMDeformableSoil::NodeRecord* SCMDeformableSoil::FindGridNode(int ix, int iy) const {
+    int tx = TileIndex(ix);
+    int ty = TileIndex(iy);
+    auto itr = m_tiles.find(GridKey(tx, ty));
+    if (itr == m_tiles.end())
+        return nullptr;
+    return &itr->second->nodes[(iy - ty * tile_size) * tile_size + (ix - tx * tile_size)];
+}
+
+SCMDeformableSoil::NodeRecord& SCMDeformableSoil::GetGridNode(int ix, int iy) {
+    int tx = TileIndex(ix);
+    int ty = TileIndex(iy);
+    auto& tile = m_tiles[GridKey(tx, ty)];
+
+    if (!tile) {
+        // Allocate a new tile, with all nodes in their undeformed state
+        NodeRecord node;
+        node.level = m_height;
+        node.level_initial = m_height;
+        node.hit_level = 1e9;
+        node.sinkage = 0;
+        node.sinkage_plastic = 0;
+        node.sinkage_elastic = 0;
+        node.step_plastic_flow = 0;
+        node.kshear = 0;
+        node.sigma = 0;
+        node.sigma_yeld = 0;
+        node.tau = 0;
+        node.massremainder = 0;
+        node.id_island = 0;
+        node.erosion = false;
+
+        tile = std::unique_ptr<GridTile>(new GridTile);
+        tile->tx = tx;
+        tile->ty = ty;
+        tile->touched = false;
+        tile->nodes.resize(tile_size * tile_size, node);
+
+        // Append the tile to the visualization mesh. The tile mesh also covers the cells to the next tiles in the X
+        // and Y directions, so that (tile_size+1) x (tile_size+1) vertices are used.
+        auto trimesh = m_trimesh_shape->GetMesh();
+        std::vector<ChVector<>>& vertices = trimesh->getCoordsVertices();
+        std::vector<ChVector<int>>& idx_vertices = trimesh->getIndicesVertexes();
+        std::vector<ChVector<int>>& idx_normals = trimesh->getIndicesNormals();
+
+        int nv = tile_size + 1;
+        tile->vis_offset = (int)vertices.size();
+        vertices.resize(vertices.size() + nv * nv);
+        trimesh->getCoordsNormals().resize(vertices.size());
+        for (int b = 0; b < nv - 1; b++) {
+            for (int a = 0; a < nv - 1; a++) {
+                int v0 = tile->vis_offset + b * nv + a;
+                idx_vertices.push_back(ChVector<int>(v0, v0 + nv + 1, v0 + nv));
+                idx_normals.push_back(ChVector<int>(v0, v0 + nv + 1, v0 + nv));
+                idx_vertices.push_back(ChVector<int>(v0, v0 + 1, v0 + nv + 1));
+                idx_normals.push_back(ChVector<int>(v0, v0 + 1, v0 + nv + 1));
+            }
+        }
+    }
+
+    if (!tile->touched) {
+        tile->touched = true;
+        m_touched_tiles.push_back(tile.get());
+    }
+
+    return tile->nodes[(iy - ty * tile_size) * tile_size + (ix - tx * tile_size)];
+}
+
+// Update the vertices, normals, and colors of the visualization mesh for the given tile.
+// Vertex normals are evaluated with central differences of the node levels.
+void SCMDeformableSoil::UpdateGridTileVisualization(const GridTile& tile) {
+    auto trimesh = m_trimesh_shape->GetMesh();
+    std::vector<ChVector<>>& vertices = trimesh->getCoordsVertices();
+    std::vector<ChVector<>>& normals = trimesh->getCoordsNormals();
+    std::vector<ChVector<float>>& colors = trimesh->getCoordsColors();
+
+    auto level = [this](int ix, int iy) {
+        const NodeRecord* node = FindGridNode(ix, iy);
+        return node ? node->level : m_height;
+    };
+
+    int nv = tile_size + 1;
+    for (int b = 0; b < nv; b++) {
+        for (int a = 0; a < nv; a++) {
+            int ix = tile.tx * tile_size + a;
+            int iy = tile.ty * tile_size + b;
+            int iv = tile.vis_offset + b * nv + a;
+            const NodeRecord* node = FindGridNode(ix, iy);
+            double z = node ? node->level : m_height;
+
+            vertices[iv] = plane * ChVector<>(ix * m_delta, iy * m_delta, z);
+
+            double dzdx = (level(ix + 1, iy) - level(ix - 1, iy)) / (2 * m_delta);
+            double dzdy = (level(ix, iy + 1) - level(ix, iy - 1)) / (2 * m_delta);
+            normals[iv] = plane.TransformDirectionLocalToParent(ChVector<>(-dzdx, -dzdy, 1).GetNormalized());
+
+            if (plot_type == SCMDeformableTerrain::PLOT_NONE)
+                continue;
+
+            ChColor mcolor(0, 0, 1);
+            if (node) {
+                switch (plot_type) {
+                    case SCMDeformableTerrain::PLOT_LEVEL:
+                        mcolor = ChColor::ComputeFalseColor(node->level, plot_v_min, plot_v_max);
+                        break;
+                    case SCMDeformableTerrain::PLOT_LEVEL_INITIAL:
+                        mcolor = ChColor::ComputeFalseColor(node->level_initial, plot_v_min, plot_v_max);
+                        break;
+                    case SCMDeformableTerrain::PLOT_SINKAGE:
+                        mcolor = ChColor::ComputeFalseColor(node->sinkage, plot_v_min, plot_v_max);
+                        break;
+                    case SCMDeformableTerrain::PLOT_SINKAGE_ELASTIC:
+                        mcolor = ChColor::ComputeFalseColor(node->sinkage_elastic, plot_v_min, plot_v_max);
+                        break;
+                    case SCMDeformableTerrain::PLOT_SINKAGE_PLASTIC:
+                        mcolor = ChColor::ComputeFalseColor(node->sinkage_plastic, plot_v_min, plot_v_max);
+                        break;
+                    case SCMDeformableTerrain::PLOT_STEP_PLASTIC_FLOW:
+                        mcolor = ChColor::ComputeFalseColor(node->step_plastic_flow, plot_v_min, plot_v_max);
+                        break;
+                    case SCMDeformableTerrain::PLOT_K_JANOSI:
+                        mcolor = ChColor::ComputeFalseColor(node->kshear, plot_v_min, plot_v_max);
+                        break;
+                    case SCMDeformableTerrain::PLOT_PRESSURE:
+                        mcolor = ChColor::ComputeFalseColor(node->sigma, plot_v_min, plot_v_max);
+                        break;
+                    case SCMDeformableTerrain::PLOT_PRESSURE_YELD:
+                        mcolor = ChColor::ComputeFalseColor(node->sigma_yeld, plot_v_min, plot_v_max);
+                        break;
+                    case SCMDeformableTerrain::PLOT_SHEAR:
+                        mcolor = ChColor::ComputeFalseColor(node->tau, plot_v_min, plot_v_max);
+                        break;
+                    case SCMDeformableTerrain::PLOT_MASSREMAINDER:
+                        mcolor = ChColor::ComputeFalseColor(node->massremainder, plot_v_min, plot_v_max);
+                        break;
+                    case SCMDeformableTerrain::PLOT_ISLAND_ID:
+                        if (node->erosion)
+                            mcolor = ChColor(1, 1, 1);
+                        if (node->id_island > 0)
+                            mcolor = ChColor::ComputeFalseColor(4 + (node->id_island % 8), 0, 12);
+                        if (node->id_island < 0)
+                            mcolor = ChColor(0, 0, 0);
+                        break;
+                    case SCMDeformableTerrain::PLOT_IS_TOUCHED:
+                        if (node->sigma > 0)
+                            mcolor = ChColor(1, 0, 0);
+                        break;
+                }
+            } else {
+                switch (plot_type) {
+                    case SCMDeformableTerrain::PLOT_LEVEL:
+                    case SCMDeformableTerrain::PLOT_LEVEL_INITIAL:
+                        mcolor = ChColor::ComputeFalseColor(m_height, plot_v_min, plot_v_max);
+                        break;
+                    case SCMDeformableTerrain::PLOT_ISLAND_ID:
+                    case SCMDeformableTerrain::PLOT_IS_TOUCHED:
+                        break;
+                    default:
+                        mcolor = ChColor::ComputeFalseColor(0, plot_v_min, plot_v_max);
+                        break;
+                }
+            }
+            colors[iv] = {mcolor.R, mcolor.G, mcolor.B};
+        }
+    }
+}
+
+// Reset the list of forces, and fills it with forces from a soil contact model (structured grid storage).
+// This follows the same steps as the mesh-based implementation, except that grid neighbors are implicit and only
+// nodes in the moving patches (or, if none is defined, in the entire grid) are processed. Only the tiles modified
+// during the previous or current step need to be reset and visualized.
+void SCMDeformableSoil::ComputeInternalForcesGrid() {
+    m_timer_calc_areas.reset();
+    m_timer_ray_casting.reset();
+    m_timer_refinement.reset();
+    m_timer_bulldozing.reset();
+    m_timer_visualization.reset();
+
+    //
+    // Reset the load list and map of contact forces
+    //
+
+    this->GetLoadList().clear();
+    m_contact_forces.clear();
+
+    //
+    // Reset the SCM quantities at the nodes of the tiles modified during the last step
+    //
+
+    std::vector<GridTile*> prev_tiles;
+    prev_tiles.swap(m_touched_tiles);
+    for (auto tile : prev_tiles) {
+        tile->touched = false;
+        for (auto& node : tile->nodes) {
+            node.sigma = 0;
+            node.sinkage_elastic = 0;
+            node.step_plastic_flow = 0;
+            node.erosion = false;
+            node.hit_level = 1e9;
+            node.id_island = 0;
+        }
+    }
+
+    // The area associated with each grid node is constant
+    double area = m_delta * m_delta;
+
+    ChVector<> N = plane.TransformDirectionLocalToParent(ChVector<>(0, 0, 1));
+
+    //
+    // Perform ray casting test to detect the contact point sinkage
+    //
+
+    m_timer_ray_casting.start();
+
+    // Collect the ranges of grid nodes to be ray-cast (moving patches, if any, else the entire grid)
+    struct GridRange {
+        int ix_min, ix_max, iy_min, iy_max;
+    };
+    std::vector<GridRange> ranges;
+    if (m_moving_patch) {
+        for (auto& p : m_patches) {
+            ChVector<> center_abs = p.m_body->GetFrame_REF_to_abs().TransformPointLocalToParent(p.m_point);
+            ChVector<> center_loc = plane.TransformPointParentToLocal(center_abs);
+
+            p.m_min.x() = center_loc.x() - p.m_dim.x() / 2;
+            p.m_min.y() = center_loc.y() - p.m_dim.y() / 2;
+            p.m_max.x() = center_loc.x() + p.m_dim.x() / 2;
+            p.m_max.y() = center_loc.y() + p.m_dim.y() / 2;
+
+            GridRange r;
+            r.ix_min = std::max(m_ix_min, (int)std::ceil(p.m_min.x() / m_delta));
+            r.ix_max = std::min(m_ix_max, (int)std::floor(p.m_max.x() / m_delta));
+            r.iy_min = std::max(m_iy_min, (int)std::ceil(p.m_min.y() / m_delta));
+            r.iy_max = std::min(m_iy_max, (int)std::floor(p.m_max.y() / m_delta));
+            ranges.push_back(r);
+        }
+    } else {
+        ranges.push_back({m_ix_min, m_ix_max, m_iy_min, m_iy_max});
+    }
+
+    // Collect the rays to be cast from the grid nodes (without duplicates if patches overlap)
+    std::vector<ChVector2<int>> ray_nodes;
+    std::vector<ChVector<>> ray_from;
+    std::vector<ChVector<>> ray_to;
+    std::unordered_set<unsigned long long> ray_keys;
+
+    for (const auto& r : ranges) {
+        for (int iy = r.iy_min; iy <= r.iy_max; iy++) {
+            for (int ix = r.ix_min; ix <= r.ix_max; ix++) {
+                if (ranges.size() > 1 && !ray_keys.insert(GridKey(ix, iy)).second)
+                    continue;
+                const NodeRecord* node = FindGridNode(ix, iy);
+                ChVector<> vertex = plane * ChVector<>(ix * m_delta, iy * m_delta, node ? node->level : m_height);
+                ChVector<> to = vertex + N * test_high_offset;
+                ChVector<> from = to - N * test_low_offset;
+                ray_nodes.push_back(ChVector2<int>(ix, iy));
+                ray_from.push_back(from);
+                ray_to.push_back(to);
+            }
+        }
+    }
+
+    // Cast all rays in a single batch (processed in parallel if supported by the collision system)
+    std::vector<collision::ChCollisionSystem::ChRayhitResult> ray_results;
+    this->GetSystem()->GetCollisionSystem()->RayHitBatch(ray_from, ray_to, ray_results);
+    m_num_ray_casts = ray_nodes.size();
+
+    // Record ray-hit results in a map (key: grid node).
+    // Initialize patch id to -1 (not set).
+    struct HitRecord {
+        ChContactable* contactable;  // pointer to hit object
+        ChVector<> abs_point;        // hit point, expressed in global frame
+        ChVector2<int> index;        // grid node indices
+        int patch_id;                // index of associated patch id
+    };
+    std::unordered_map<unsigned long long, HitRecord> hits;
+
+    for (size_t k = 0; k < ray_nodes.size(); ++k) {
+        const auto& mrayhit_result = ray_results[k];
+        if (mrayhit_result.hit) {
+            const auto& index = ray_nodes[k];
+            HitRecord record = {mrayhit_result.hitModel->GetContactable(), mrayhit_result.abs_hitPoint, index, -1};
+            hits.insert(std::make_pair(GridKey(index.x(), index.y()), record));
+        }
+    }
+
+    // Loop through all hit nodes and determine to which contact patch they belong.
+    // Use a queue-based flood-filling algorithm over the implicit grid neighbors.
+    int num_patches = 0;
+    for (auto& h : hits) {
+        if (h.second.patch_id != -1)  // move on if node already assigned to a patch
+            continue;
+        std::queue<HitRecord*> todo;
+        h.second.patch_id = num_patches++;  // assign this node to a new patch
+        todo.push(&h.second);               // add node to end of queue
+        while (!todo.empty()) {
+            auto crt = todo.front();  // current node is first element in queue
+            todo.pop();               // remove first element of queue
+            for (int k = 0; k < 6; k++) {
+                auto nbr = hits.find(GridKey(crt->index.x() + grid_nbr[k][0], crt->index.y() + grid_nbr[k][1]));
+                if (nbr == hits.end() || nbr->second.patch_id != -1)  // move on if not hit or already assigned
+                    continue;
+                nbr->second.patch_id = crt->patch_id;  // assign neighbor to same patch
+                todo.push(&nbr->second);               // add neighbor to end of queue
+            }
+        }
+    }
+
+    // Collect hit nodes assigned to each patch.
+    struct PatchRecord {
+        std::vector<ChVector2<>> points;  // points in patch (projected on reference plane)
+        double oob;                       // approximate value of 1/b
+    };
+    std::vector<PatchRecord> patches(num_patches);
+    for (auto& h : hits) {
+        patches[h.second.patch_id].points.push_back(
+            ChVector2<>(h.second.index.x() * m_delta, h.second.index.y() * m_delta));
+    }
+
+    // Calculate approximation to Beker term 1/b.
+    for (auto& p : patches)
+        p.oob = CalcPatchOOB(p.points);
+
+    // Contact nodes (positive pressure)
+    std::vector<ChVector2<int>> contact_nodes;
+
+    // Process only hit nodes
+    for (auto& h : hits) {
+        int ix = h.second.index.x();
+        int iy = h.second.index.y();
+        ChContactable* contactable = h.second.contactable;
+        int patch_id = h.second.patch_id;
+
+        auto loc_point = plane.TransformParentToLocal(h.second.abs_point);
+        SoilParameters soil = GetSoilParameters(loc_point);
+
+        NodeRecord& node = GetGridNode(ix, iy);
+        ChVector<> vertex = plane * ChVector<>(ix * m_delta, iy * m_delta, node.level);
+
+        node.hit_level = loc_point.z();
+        ChVector<> speed = contactable->GetContactPointSpeed(vertex);
+
+        ChVector<> force;
+        if (!CalcNodeForce(GetGridNodeState(node), soil, patches[patch_id].oob, speed, area, N, force))
+            continue;
+
+        AddContactForce(contactable, vertex, force);
+
+        // Update grid representation
+        node.level = node.level_initial - node.sinkage;
+
+        contact_nodes.push_back(h.second.index);
+    }
+
+    m_timer_ray_casting.stop();
+
+    //
+    // Flow material to the side of rut, using heuristics
+    //
+
+    m_timer_bulldozing.start();
+
+    if (do_bulldozing) {
+        // Check if the grid node with given indices is within the terrain extent
+        auto in_grid = [this](int ix, int iy) {
+            return ix >= m_ix_min && ix <= m_ix_max && iy >= m_iy_min && iy <= m_iy_max;
+        };
+
+        std::vector<ChVector2<int>> domain_erosion;
+
+        // Compute contact islands (and their displaced material) by flood-filling the grid.
+        // Seed the islands in the same order as the mesh vertices, so that the two storage modes give the same results.
+        std::sort(contact_nodes.begin(), contact_nodes.end(), GridNodeLess);
+        int id_island = 0;
+        for (const auto& seed : contact_nodes) {
+            NodeRecord& seed_node = GetGridNode(seed.x(), seed.y());
+            if (seed_node.sigma <= 0 || seed_node.id_island != 0)
+                continue;
+
+            // new island:
+            ++id_island;
+            std::vector<ChVector2<int>> fill_front;
+            std::vector<ChVector2<int>> boundary;
+            double tot_area_boundary = 0;
+            double tot_step_flow_island = area * seed_node.step_plastic_flow * this->GetSystem()->GetStep();
+
+            fill_front.push_back(seed);
+            seed_node.id_island = id_island;
+            while (fill_front.size() > 0) {
+                // fill next front
+                std::vector<ChVector2<int>> fill_front_2;
+                for (const auto& ifront : fill_front) {
+                    for (int k = 0; k < 6; k++) {
+                        int ix = ifront.x() + grid_nbr[k][0];
+                        int iy = ifront.y() + grid_nbr[k][1];
+                        if (!in_grid(ix, iy))
+                            continue;
+                        NodeRecord& nbr = GetGridNode(ix, iy);
+                        if ((nbr.sigma > 0) && (nbr.id_island == 0)) {
+                            tot_step_flow_island += area * nbr.step_plastic_flow * this->GetSystem()->GetStep();
+                            fill_front_2.push_back(ChVector2<int>(ix, iy));
+                            nbr.id_island = id_island;
+                        } else if ((nbr.sigma == 0) && (nbr.id_island <= 0) && (nbr.id_island != -id_island)) {
+                            tot_area_boundary += area;
+                            nbr.id_island = -id_island;  // negative to mark as boundary
+                            boundary.push_back(ChVector2<int>(ix, iy));
+                        }
+                    }
+                }
+                // advance to next front
+                fill_front.swap(fill_front_2);
+            }
+
+            // Raise the boundary because of material flow (it gives a sharp spike around the
+            // island boundary, but later we'll use the erosion algorithm to smooth it out)
+            for (const auto& ibv : boundary) {
+                NodeRecord& bnode = GetGridNode(ibv.x(), ibv.y());
+                double d_y = bulldozing_flow_factor * ((area / tot_area_boundary) * (1 / area) * tot_step_flow_island);
+                RaiseNode(GetGridNodeState(bnode), d_y);
+
+                // Island boundaries are the seeds of the erosion domain
+                if (!bnode.erosion) {
+                    bnode.erosion = true;
+                    domain_erosion.push_back(ibv);
+                }
+            }
+        }  // end for islands
+
+        // Erosion domain area select, by topologically dilation of all the boundaries of the islands
+        std::vector<ChVector2<int>> front_erosion = domain_erosion;
+        for (int iloop = 0; iloop < bulldozing_erosion_n_propagations; ++iloop) {
+            std::vector<ChVector2<int>> front_erosion2;
+            for (const auto& is : front_erosion) {
+                for (int k = 0; k < 6; k++) {
+                    int ix = is.x() + grid_nbr[k][0];
+                    int iy = is.y() + grid_nbr[k][1];
+                    if (!in_grid(ix, iy))
+                        continue;
+                    NodeRecord& nbr = GetGridNode(ix, iy);
+                    if ((nbr.id_island == 0) && !nbr.erosion) {
+                        front_erosion2.push_back(ChVector2<int>(ix, iy));
+                        nbr.erosion = true;
+                    }
+                }
+            }
+            domain_erosion.insert(domain_erosion.end(), front_erosion2.begin(), front_erosion2.end());
+            front_erosion.swap(front_erosion2);
+        }
+
+        // Erosion smoothing algorithm on domain (all grid nodes have the same area and 6 neighbors).
+        // The nodes are processed in the same order as the mesh vertices.
+        std::sort(domain_erosion.begin(), domain_erosion.end(), GridNodeLess);
+        double nbr_fraction = 1.0 / 6;
+        for (int ismo = 0; ismo < bulldozing_erosion_n_iterations; ++ismo) {
+            for (const auto& is : domain_erosion) {
+                NodeRecord& ni = GetGridNode(is.x(), is.y());
+                for (int k = 0; k < 6; k++) {
+                    int ix = is.x() + grid_nbr[k][0];
+                    int iy = is.y() + grid_nbr[k][1];
+                    if (!in_grid(ix, iy))
+                        continue;
+                    NodeRecord& nc = GetGridNode(ix, iy);
+                    double ddist = (ix == is.x() || iy == is.y() ? 1 : CH_C_SQRT_2) * m_delta;
+                    double d_y_i;
+                    double d_y_c;
+                    ErodeNodes(GetGridNodeState(ni), GetGridNodeState(nc), area, area, nbr_fraction, ddist, d_y_i,
+                               d_y_c);
+                }
+            }
+        }
+
+    }  // end bulldozing flow
+
+    m_timer_bulldozing.stop();
+
+    //
+    // Update the visualization mesh of the tiles modified during the last or the current step
+    // (including adjacent tiles, as they share border vertices with the modified tiles)
+    //
+
+    m_timer_visualization.start();
+
+    auto trimesh = m_trimesh_shape->GetMesh();
+    std::vector<ChVector<float>>& colors = trimesh->getCoordsColors();
+    size_t num_vis_vertices = trimesh->getCoordsVertices().size();
+
+    bool vis_all = false;
+    if (plot_type == SCMDeformableTerrain::PLOT_NONE) {
+        colors.clear();
+    } else {
+        vis_all = colors.empty();  // colors not yet set, visualize all tiles
+        colors.resize(num_vis_vertices);
+    }
+
+    std::unordered_set<GridTile*> vis_tiles;
+    if (vis_all) {
+        for (auto& t : m_tiles)
+            vis_tiles.insert(t.second.get());
+    } else {
+        prev_tiles.insert(prev_tiles.end(), m_touched_tiles.begin(), m_touched_tiles.end());
+        for (auto tile : prev_tiles) {
+            for (int j = -1; j <= 1; j++) {
+                for (int i = -1; i <= 1; i++) {
+                    auto itr = m_tiles.find(GridKey(tile->tx + i, tile->ty + j));
+                    if (itr != m_tiles.end())
+                        vis_tiles.insert(itr->second.get());
+                }
+            }
+        }
+    }
+
+    for (auto tile : vis_tiles)
+        UpdateGridTileVisualization(*tile);
+
+    m_timer_visualization.stop();
+
+    m_num_tiles = m_tiles.size();
+    m_num_vertices = m_num_tiles * tile_size * tile_size;
+    m_num_faces = trimesh->getIndicesVertexes().size();
+}
+
 }  // end namespace vehicle
 }  // end namespace chrono
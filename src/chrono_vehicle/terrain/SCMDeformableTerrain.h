@@ -20,10 +20,12 @@
 #ifndef SCM_DEFORMABLE_TERRAIN_H
 #define SCM_DEFORMABLE_TERRAIN_H
 
+#include <memory>
 #include <set>
 #include <string>
 #include <unordered_map>
 #include <ostream>
+#include <vector>
 
 #include "chrono/assets/ChColorAsset.h"
 #include "chrono/assets/ChTriangleMeshShape.h"
@@ -145,6 +147,8 @@ class CH_VEHICLE_API SCMDeformableTerrain : public ChTerrain {
     /// If no patches are defined, ray-casting is performed for every single node of the underlying SCM mesh.
     /// If at least one patch is defined, ray-casting is performed only for mesh nodes within the patch areas
     /// (that is, nodes that are within the specified range from the given point on the associated body).
+    /// All rays are cast in a single batch, processed in parallel if the collision system uses multiple threads
+    /// (see ChCollisionSystemBullet::SetNumThreads).
     void AddMovingPatch(std::shared_ptr<ChBody> body,     ///< [in] monitored body
                         const ChVector<>& point_on_body,  ///< [in] patch center, relative to body
                         double dimX,                      ///< [in] patch X dimension
@@ -206,6 +210,18 @@ class CH_VEHICLE_API SCMDeformableTerrain : public ChTerrain {
                     int divY        ///< [in] number of divisions in the Y direction
     );
 
+    /// Initialize the terrain system (flat, structured grid).
+    /// This version uses a regular grid of nodes with the given spacing, over an area centered at the origin of the
+    /// reference plane. Grid neighbors are implicit and the per-node SCM state is stored in square tiles which are
+    /// allocated only when one of their nodes is first deformed, so that memory use is proportional to the deformed
+    /// area rather than to the terrain extent. Use together with AddMovingPatch for very long courses.
+    /// Automatic mesh refinement is not available in this mode, and only the allocated tiles are visualized.
+    void InitializeGrid(double height,  ///< [in] terrain height
+                        double sizeX,   ///< [in] terrain dimension in the X direction
+                        double sizeY,   ///< [in] terrain dimension in the Y direction
+                        double delta    ///< [in] grid spacing
+    );
+
     /// Initialize the terrain system (mesh).
     /// The initial undeformed mesh is provided via a Wavefront .obj file.
     void Initialize(const std::string& mesh_file  ///< [in] filename of the input mesh (.OBJ file in Wavefront format)
@@ -247,6 +263,18 @@ class CH_VEHICLE_API SCMDeformableSoil : public ChLoadContainer {
                     int divY        ///< [in] number of divisions in the Y direction
     );
 
+    /// Initialize the terrain system (flat, structured grid).
+    /// This version uses a regular grid of nodes with the given spacing, over an area centered at the origin of the
+    /// reference plane. Grid neighbors are implicit and the per-node SCM state is stored in square tiles which are
+    /// allocated only when one of their nodes is first deformed, so that memory use is proportional to the deformed
+    /// area rather than to the terrain extent. Use together with AddMovingPatch for very long courses.
+    /// Automatic mesh refinement is not available in this mode, and only the allocated tiles are visualized.
+    void InitializeGrid(double height,  ///< [in] terrain height
+                        double sizeX,   ///< [in] terrain dimension in the X direction
+                        double sizeY,   ///< [in] terrain dimension in the Y direction
+                        double delta    ///< [in] grid spacing
+    );
+
     /// Initialize the terrain system (mesh).
     /// The initial undeformed mesh is provided via a Wavefront .obj file.
     void Initialize(const std::string& mesh_file  ///< [in] filename of the input mesh (.OBJ file in Wavefront format)
@@ -263,6 +291,62 @@ class CH_VEHICLE_API SCMDeformableSoil : public ChLoadContainer {
     );
 
   private:
+    // SCM state at a node of the structured grid
+    struct NodeRecord {
+        double level;              // current level
+        double level_initial;      // initial level
+        double hit_level;          // level of ray hit (1e9 if no hit)
+        double sinkage;            // total sinkage
+        double sinkage_plastic;    // plastic sinkage
+        double sinkage_elastic;    // elastic sinkage
+        double step_plastic_flow;  // plastic flow during last step
+        double kshear;             // Janosi-Hanamoto shear accumulator
+        double sigma;              // normal pressure
+        double sigma_yeld;         // yield pressure
+        double tau;                // shear stress
+        double massremainder;      // material not yet redistributed by bulldozing
+        int id_island;             // contact island (negative for island boundaries)
+        bool erosion;              // node in erosion domain
+    };
+
+    // Square block of grid nodes, allocated when one of its nodes is first deformed
+    struct GridTile {
+        int tx;                         // tile index in X direction
+        int ty;                         // tile index in Y direction
+        int vis_offset;                 // index of first tile vertex in the visualization mesh
+        bool touched;                   // tile modified during current step?
+        std::vector<NodeRecord> nodes;  // tile nodes, row after row
+    };
+
+    // References to the SCM state of a node, stored either in the mesh arrays or in a grid NodeRecord.
+    // This allows the mesh and grid storage modes to share the soil model.
+    struct NodeState {
+        double& level;
+        double& level_initial;
+        double& hit_level;
+        double& sinkage;
+        double& sinkage_plastic;
+        double& sinkage_elastic;
+        double& step_plastic_flow;
+        double& kshear;
+        double& sigma;
+        double& sigma_yeld;
+        double& tau;
+        double& massremainder;
+    };
+
+    // Soil parameters at a given location
+    struct SoilParameters {
+        double Bekker_Kphi;
+        double Bekker_Kc;
+        double Bekker_n;
+        double Mohr_cohesion;
+        double Mohr_friction;
+        double Janosi_shear;
+        double elastic_K;
+        double damping_R;
+    };
+
     // Updates the forces and the geometry, at the beginning of each timestep
     virtual void Setup() override {
         // GetLog() << " Setup update soil t= "<< this->ChTime << "\n";
@@ -287,6 +371,61 @@ class CH_VEHICLE_API SCMDeformableSoil : public ChLoadContainer {
     // each IntLoadResidual_F() for performance reason, not at each Update() that might be overkill).
     void ComputeInternalForces();
 
+    // Implementation of ComputeInternalForces for the structured grid storage.
+    void ComputeInternalForcesGrid();
+
+    // Apply a force at the given point on the contactable object and accumulate it in the map of contact forces.
+    void AddContactForce(ChContactable* contactable, const ChVector<>& point, const ChVector<>& force);
+
+    // Return the grid node with given indices, or nullptr if its tile was not allocated.
+    NodeRecord* FindGridNode(int ix, int iy) const;
+
+    // Return the grid node with given indices, allocating its tile if needed. The tile is marked as touched.
+    NodeRecord& GetGridNode(int ix, int iy);
+
+    // Update the visualization mesh of the given tile.
+    void UpdateGridTileVisualization(const GridTile& tile);
+
+    // Return the SCM state of the mesh vertex with given index.
+    NodeState GetMeshNodeState(int i);
+
+    // Return the SCM state of the given grid node.
+    static NodeState GetGridNodeState(NodeRecord& node);
+
+    // Return the soil parameters at the given point (expressed in the frame of the terrain plane).
+    SoilParameters GetSoilParameters(const ChVector<>& loc_point) const;
+
+    // Return the approximation of the Bekker term 1/b for a contact patch with given points (in the terrain plane).
+    static double CalcPatchOOB(std::vector<ChVector2<>>& points);
+
+    // Evaluate the SCM soil model at a node hit by a ray (the hit level of the node must be set).
+    // Update the node state and return the force applied to the hit object in 'force', or false if not in contact.
+    bool CalcNodeForce(NodeState node,
+                       const SoilParameters& soil,
+                       double oob,
+                       const ChVector<>& speed,
+                       double area,
+                       const ChVector<>& N,
+                       ChVector<>& force);
+
+    // Raise a node, without exceeding its ray-hit level (the excess is kept as material remainder).
+    // Return the actual level increment.
+    static double RaiseNode(NodeState node, double d_y);
+
+    // Lower a node (d_y < 0), using its material remainder first. Return the actual level increment.
+    static double LowerNode(NodeState node, double d_y);
+
+    // Erosion between a node of the erosion domain and one of its neighbors: flow of the material remainder and
+    // smoothing of slopes steeper than the erosion angle. Return the level increments of the two nodes.
+    void ErodeNodes(NodeState ni,
+                    NodeState nc,
+                    double area_i,
+                    double area_c,
+                    double nbr_fraction,
+                    double dist,
+                    double& d_y_i,
+                    double& d_y_c) const;
+
     // Override the ChLoadContainer method for computing the generalized force F term:
     virtual void IntLoadResidual_F(const unsigned int off,  ///< offset in R residual
                                    ChVectorDynamic<>& R,    ///< result: the R residual, R += c*F
@@ -341,6 +480,14 @@ class CH_VEHICLE_API SCMDeformableSoil : public ChLoadContainer {
     std::vector<std::set<int>> connected_vertexes;
     std::vector<std::array<int, 4>> tri_map;
 
+    // structured grid storage
+    bool m_grid;                             // structured grid storage enabled?
+    double m_delta;                          // grid spacing
+    int m_ix_min, m_ix_max;                  // range of grid node indices in X direction
+    int m_iy_min, m_iy_max;                  // range of grid node indices in Y direction
+    std::vector<GridTile*> m_touched_tiles;  // tiles modified during current step
+    std::unordered_map<unsigned long long, std::unique_ptr<GridTile>> m_tiles;  // allocated tiles (key: tile indices)
+
     bool do_bulldozing;
     double bulldozing_flow_factor;
     double bulldozing_erosion_angle;
@@ -379,6 +526,7 @@ class CH_VEHICLE_API SCMDeformableSoil : public ChLoadContainer {
     size_t m_num_faces;
     size_t m_num_ray_casts;
     size_t m_num_marked_faces;
+    size_t m_num_tiles;
 
     std::unordered_map<ChContactable*, TerrainForce> m_contact_forces;
 
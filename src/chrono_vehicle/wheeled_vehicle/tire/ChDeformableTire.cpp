@@ -20,6 +20,14 @@
 //// Todo: extend this and derived classes to allow use in a double-wheel setup.
 ////       in particular, check how the tire FEA mesh is attached to the rim.
 
+#include <algorithm>
+
+#include "chrono/motion_functions/ChFunctionPosition_XYZfunctions.h"
+#include "chrono/motion_functions/ChFunctionRotation_axis.h"
+#include "chrono/motion_functions/ChFunction_Ramp.h"
+#include "chrono/solver/ChDirectSolverLS.h"
+
+#include "chrono_vehicle/ChWorldFrame.h"
 #include "chrono_vehicle/wheeled_vehicle/tire/ChDeformableTire.h"
 
 namespace chrono {
@@ -37,7 +45,9 @@ ChDeformableTire::ChDeformableTire(const std::string& name)
       m_contact_type(NODE_CLOUD),
       m_contact_node_radius(0.001),
       m_contact_face_thickness(0.0),
-      m_pressure(-1) {}
+      m_pressure(-1),
+      m_multirate(false),
+      m_mr_terrain(nullptr) {}
 
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
@@ -47,12 +57,51 @@ void ChDeformableTire::Initialize(std::shared_ptr<ChWheel> wheel) {
     ChSystemSMC* system = dynamic_cast<ChSystemSMC*>(wheel->GetSpindle()->GetSystem());
     assert(system);
 
+    m_rim = wheel->GetSpindle();
+
+    // With multi-rate integration, the tire is connected to a rim body in a separate system.
+    // The motion of this body relative to a fixed ground body is imposed from the state of the wheel spindle.
+    if (m_multirate) {
+        m_mr_system = chrono_types::make_shared<ChSystemSMC>();
+        m_mr_system->Set_G_acc(system->Get_G_acc());
+        m_mr_system->SetChTime(system->GetChTime());
+
+        auto solver = chrono_types::make_shared<ChSolverSparseLU>();
+        solver->LockSparsityPattern(true);
+        m_mr_system->SetSolver(solver);
+        m_mr_system->SetTimestepperType(ChTimestepper::Type::EULER_IMPLICIT_LINEARIZED);
+
+        auto spindle = wheel->GetSpindle();
+
+        auto ground = std::shared_ptr<ChBody>(m_mr_system->NewBody());
+        ground->SetNameString(m_name + "_ground");
+        ground->SetBodyFixed(true);
+        m_mr_system->AddBody(ground);
+
+        m_rim = std::shared_ptr<ChBody>(m_mr_system->NewBody());
+        m_rim->SetNameString(m_name + "_rim");
+        m_rim->SetMass(spindle->GetMass());
+        m_rim->SetInertia(spindle->GetInertia());
+        m_rim->SetPos(spindle->GetPos());
+        m_rim->SetRot(spindle->GetRot());
+        m_rim->SetPos_dt(spindle->GetPos_dt());
+        m_rim->SetWvel_loc(spindle->GetWvel_loc());
+        m_mr_system->AddBody(m_rim);
+
+        m_mr_motion = chrono_types::make_shared<ChLinkMotionImposed>();
+        m_mr_motion->SetNameString(m_name + "_rim_motion");
+        m_mr_motion->Initialize(m_rim, ground, true, ChFrame<>(), ChFrame<>(spindle->GetPos(), spindle->GetRot()));
+        m_mr_system->AddLink(m_mr_motion);
+
+        system = m_mr_system.get();
+    }
+
     // Create the tire mesh
     m_mesh = chrono_types::make_shared<ChMesh>();
     system->Add(m_mesh);
 
     // Create the FEA nodes and elements
-    CreateMesh(*(wheel->GetSpindle().get()), wheel->GetSide());
+    CreateMesh(*(m_rim.get()), wheel->GetSide());
 
     // Create a load container
     m_load_container = chrono_types::make_shared<ChLoadContainer>();
@@ -71,15 +120,29 @@ void ChDeformableTire::Initialize(std::shared_ptr<ChWheel> wheel) {
     // Enable tire contact
     if (m_contact_enabled) {
         // Let the derived class create the contact surface and add it to the mesh.
+        // With multi-rate integration, contact forces are applied directly to the mesh nodes.
         CreateContactMaterial();
         assert(m_contact_mat && m_contact_mat->GetContactMethod() == ChContactMethod::SMC);
-        CreateContactSurface();
+        if (!m_multirate)
+            CreateContactSurface();
     }
 
     // Enable tire connection to rim
     if (m_connection_enabled) {
         // Let the derived class create the constraints and add them to the system.
-        CreateRimConnections(wheel->GetSpindle());
+        CreateRimConnections(m_rim);
+    }
+
+    if (m_multirate) {
+        for (auto& node : m_mesh->GetNodes()) {
+            if (auto node_xyz = std::dynamic_pointer_cast<ChNodeFEAxyz>(node))
+                m_mr_nodes.push_back(node_xyz);
+            else if (auto node_rot = std::dynamic_pointer_cast<ChNodeFEAxyzrot>(node))
+                m_mr_nodes_rot.push_back(node_rot);
+        }
+        m_mr_tire_force.point = wheel->GetSpindle()->GetPos();
+        m_mr_tire_force.force = ChVector<>(0, 0, 0);
+        m_mr_tire_force.moment = ChVector<>(0, 0, 0);
     }
 }
 
@@ -101,7 +164,7 @@ void ChDeformableTire::RemoveVisualizationAssets() {
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 std::shared_ptr<ChContactSurface> ChDeformableTire::GetContactSurface() const {
-    if (m_contact_enabled) {
+    if (m_contact_enabled && !m_multirate) {
         return m_mesh->GetContactSurface(0);
     }
 
@@ -123,6 +186,9 @@ double ChDeformableTire::GetTireMass() const {
 // -----------------------------------------------------------------------------
 // -----------------------------------------------------------------------------
 TerrainForce ChDeformableTire::GetTireForce() const {
+    if (m_multirate)
+        return m_mr_tire_force;
+
     TerrainForce tire_force;
     tire_force.point = m_wheel->GetPos();
     tire_force.force = ChVector<>(0, 0, 0);
@@ -131,20 +197,26 @@ TerrainForce ChDeformableTire::GetTireForce() const {
 }
 
 TerrainForce ChDeformableTire::ReportTireForce(ChTerrain* terrain) const {
-    TerrainForce tire_force;
+    TerrainForce tire_force = CalculateRimForce();
     tire_force.point = m_wheel->GetPos();
+    return tire_force;
+}
+
+// Calculate the resultant of all reaction forces and torques in the tire-wheel connections,
+// as applied at the center of mass of the body connected to the tire.
+// These encapsulate the tire-terrain interaction forces and the inertia of the tire itself.
+TerrainForce ChDeformableTire::CalculateRimForce() const {
+    TerrainForce tire_force;
+    tire_force.point = m_rim->GetPos();
     tire_force.force = ChVector<>(0, 0, 0);
     tire_force.moment = ChVector<>(0, 0, 0);
 
-    // Calculate and return the resultant of all reaction forces and torques in the
-    // tire-wheel connections, as applied at the wheel body center of mass.
-    // These encapsulate the tire-terrain interaction forces and the inertia of the tire itself.
     ChVector<> force;
     ChVector<> moment;
     for (size_t ic = 0; ic < m_connections.size(); ic++) {
         ChCoordsys<> csys = m_connections[ic]->GetLinkAbsoluteCoords();
         ChVector<> react = csys.TransformDirectionLocalToParent(m_connections[ic]->GetReactionOnBody());
-        m_wheel->GetSpindle()->To_abs_forcetorque(react, csys.pos, false, force, moment);
+        m_rim->To_abs_forcetorque(react, csys.pos, false, force, moment);
         tire_force.force += force;
         tire_force.moment += moment;
     }
@@ -158,7 +230,7 @@ TerrainForce ChDeformableTire::ReportTireForce(ChTerrain* terrain) const {
     for (size_t ic = 0; ic < m_connectionsF.size(); ic++) {
         ChCoordsys<> csys = m_connectionsF[ic]->GetLinkAbsoluteCoords();
         ChVector<> react = csys.TransformDirectionLocalToParent(m_connectionsF[ic]->Get_react_force());
-        m_wheel->GetSpindle()->To_abs_forcetorque(react, csys.pos, false, force, moment);
+        m_rim->To_abs_forcetorque(react, csys.pos, false, force, moment);
         tire_force.force += force;
         tire_force.moment += moment;
         ChVector<> reactMoment = csys.TransformDirectionLocalToParent(m_connectionsF[ic]->Get_react_torque());
@@ -168,5 +240,131 @@ TerrainForce ChDeformableTire::ReportTireForce(ChTerrain* terrain) const {
     return tire_force;
 }
 
+// -----------------------------------------------------------------------------
+// Multi-rate integration.
+// At each vehicle step, the motion imposed on the rim body starts from the current state of
+// the wheel spindle and continues with constant linear and angular velocities while the tire
+// system is advanced with the tire step size. Tire-terrain contact forces are evaluated at the start
+// of each tire step and held constant during that step.
+// -----------------------------------------------------------------------------
+void ChDeformableTire::Synchronize(double time, const ChTerrain& terrain) {
+    ChTire::Synchronize(time, terrain);
+
+    if (!m_multirate)
+        return;
+
+    m_mr_terrain = &terrain;
+
+    // The tire force is reported at the spindle center (i.e., the start position of the rim body center of mass)
+    auto spindle = m_wheel->GetSpindle();
+    m_mr_tire_force.point = spindle->GetPos();
+
+    // Reset the rim body to the current state of the spindle
+    m_rim->SetPos(spindle->GetPos());
+    m_rim->SetRot(spindle->GetRot());
+    m_rim->SetPos_dt(spindle->GetPos_dt());
+    m_rim->SetWvel_loc(spindle->GetWvel_loc());
+    m_mr_system->SetChTime(time);
+
+    // Impose the rim motion relative to the current spindle frame: translation with the spindle linear velocity
+    // (expressed in the spindle frame) and rotation about the spindle angular velocity, both starting at this time.
+    m_mr_motion->GetFrame2() = ChFrame<>(spindle->GetPos(), spindle->GetRot());
+
+    ChVector<> vel_loc = spindle->TransformDirectionParentToLocal(spindle->GetPos_dt());
+    auto position = chrono_types::make_shared<ChFunctionPosition_XYZfunctions>();
+    position->SetFunctionX(chrono_types::make_shared<ChFunction_Ramp>(-vel_loc.x() * time, vel_loc.x()));
+    position->SetFunctionY(chrono_types::make_shared<ChFunction_Ramp>(-vel_loc.y() * time, vel_loc.y()));
+    position->SetFunctionZ(chrono_types::make_shared<ChFunction_Ramp>(-vel_loc.z() * time, vel_loc.z()));
+    m_mr_motion->SetPositionFunction(position);
+
+    ChVector<> wvel_loc = spindle->GetWvel_loc();
+    double omega = wvel_loc.Length();
+    auto rotation = chrono_types::make_shared<ChFunctionRotation_axis>();
+    if (omega > 0)
+        rotation->SetAxis(wvel_loc / omega);
+    rotation->SetFunctionAngle(chrono_types::make_shared<ChFunction_Ramp>(-omega * time, omega));
+    m_mr_motion->SetRotationFunction(rotation);
+}
+
+void ChDeformableTire::Advance(double step) {
+    if (!m_multirate)
+        return;
+
+    ChVector<> force(0, 0, 0);
+    ChVector<> moment(0, 0, 0);
+
+    double t = 0;
+    while (t < step) {
+        double h = std::min<>(m_stepsize, step - t);
+
+        ApplyTerrainForces();
+        m_mr_system->DoStepDynamics(h);
+        t += h;
+
+        // Transfer the moment from the current rim center of mass to the reported application point
+        TerrainForce rim_force = CalculateRimForce();
+        force += rim_force.force * h;
+        moment += (rim_force.moment + Vcross(rim_force.point - m_mr_tire_force.point, rim_force.force)) * h;
+    }
+
+    m_mr_tire_force.force = force / step;
+    m_mr_tire_force.moment = moment / step;
+}
+
+// Penalty contact between the mesh nodes (treated as spheres of radius equal to the contact
+// node radius or the contact face thickness) and the terrain, represented locally by the plane
+// through the terrain point below each node. The normal force uses the stiffness and damping
+// coefficients of the tire contact material; the tangential force is a regularized Coulomb
+// friction force based on the terrain coefficient of friction.
+void ChDeformableTire::ApplyTerrainForces() {
+    size_t num_nodes = m_mr_nodes.size() + m_mr_nodes_rot.size();
+
+    if (!m_contact_enabled || !m_mr_terrain) {
+        for (auto& node : m_mr_nodes)
+            node->SetForce(VNULL);
+        for (auto& node : m_mr_nodes_rot)
+            node->SetForce(VNULL);
+        return;
+    }
+
+    m_mr_loc.resize(num_nodes);
+    for (size_t i = 0; i < m_mr_nodes.size(); i++)
+        m_mr_loc[i] = m_mr_nodes[i]->GetPos();
+    for (size_t i = 0; i < m_mr_nodes_rot.size(); i++)
+        m_mr_loc[m_mr_nodes.size() + i] = m_mr_nodes_rot[i]->GetPos();
+
+    m_mr_terrain->GetProperties(m_mr_loc, m_mr_height, m_mr_normal, m_mr_friction);
+
+    double radius = (m_contact_type == NODE_CLOUD) ? m_contact_node_radius : m_contact_face_thickness;
+    double kn = m_contact_mat->GetKn();
+    double gn = m_contact_mat->GetGn();
+    const double v_slip = 0.01;  // velocity for regularization of the Coulomb friction force
+
+    for (size_t i = 0; i < num_nodes; i++) {
+        bool is_rot = i >= m_mr_nodes.size();
+        size_t j = is_rot ? i - m_mr_nodes.size() : i;
+
+        const ChVector<>& n = m_mr_normal[i];
+        double depth = radius - (ChWorldFrame::Height(m_mr_loc[i]) - m_mr_height[i]) * Vdot(ChWorldFrame::Vertical(), n);
+
+        ChVector<> f(0, 0, 0);
+        if (depth > 0) {
+            ChVector<> v = is_rot ? m_mr_nodes_rot[j]->GetPos_dt() : m_mr_nodes[j]->GetPos_dt();
+            double vn = Vdot(v, n);
+            ChVector<> vt = v - vn * n;
+            double fn = std::max(kn * depth - gn * vn, 0.0);
+            double vt_len = vt.Length();
+            f = fn * n;
+            if (vt_len > 0)
+                f -= (m_mr_friction[i] * fn * std::min(vt_len / v_slip, 1.0) / vt_len) * vt;
+        }
+
+        if (is_rot)
+            m_mr_nodes_rot[j]->SetForce(f);
+        else
+            m_mr_nodes[j]->SetForce(f);
+    }
+}
+
 }  // end namespace vehicle
 }  // end namespace chrono
@@ -23,6 +23,7 @@
 #include "chrono/physics/ChLoadContainer.h"
 #include "chrono/physics/ChSystemSMC.h"
 #include "chrono/physics/ChLinkMate.h"
+#include "chrono/physics/ChLinkMotionImposed.h"
 
 #include "chrono/fea/ChContactSurfaceMesh.h"
 #include "chrono/fea/ChContactSurfaceNodeCloud.h"
@@ -30,6 +31,8 @@
 #include "chrono/fea/ChLinkPointFrame.h"
 #include "chrono/fea/ChMesh.h"
 #include "chrono/fea/ChNodeFEAbase.h"
+#include "chrono/fea/ChNodeFEAxyz.h"
+#include "chrono/fea/ChNodeFEAxyzrot.h"
 #include "chrono/fea/ChVisualizationFEAmesh.h"
 
 #include "chrono_vehicle/wheeled_vehicle/ChTire.h"
@@ -81,6 +84,25 @@ class CH_VEHICLE_API ChDeformableTire : public ChTire {
     void EnableRimConnection(bool val) { m_connection_enabled = val; }
     bool IsRimConnectionEnabled() const { return m_connection_enabled; }
 
+    /// Enable/disable multi-rate integration of the tire dynamics (default: false).
+    /// If enabled, the tire is simulated in a separate Chrono system, advanced with the tire step size (see
+    /// SetStepsize) and coupled to the vehicle system only at the vehicle step. The tire mesh is connected to a rim
+    /// body whose motion is imposed from the state of the associated wheel at the beginning of each vehicle step (with
+    /// constant linear and angular velocities over the step), and the resultant of the tire-rim reaction
+    /// forces (averaged over the vehicle step) is applied as an external force to the wheel spindle.
+    /// In this mode, tire-terrain contact is evaluated at the mesh nodes from the terrain height and normal (i.e., the
+    /// terrain is treated as a rigid height field), using the stiffness and damping coefficients of the tire contact
+    /// material and the terrain coefficient of friction.
+    /// This function must be called before Initialize.
+    void EnableMultirate(bool val) { m_multirate = val; }
+    bool IsMultirateEnabled() const { return m_multirate; }
+
+    /// Get the Chrono system in which the tire is simulated when multi-rate integration is enabled.
+    /// By default, this system uses a sparse direct linear solver (with locked sparsity pattern) and the linearized
+    /// implicit Euler integrator. Use this to change the solver and integrator for the tire dynamics.
+    /// Returns a null pointer if multi-rate integration is not enabled or before initialization.
+    ChSystem* GetMultirateSystem() const { return m_mr_system.get(); }
+
     /// Get a handle to the mesh visualization.
     fea::ChVisualizationFEAmesh* GetMeshVisualization() const { return m_visualization.get(); }
 
@@ -88,7 +110,7 @@ class CH_VEHICLE_API ChDeformableTire : public ChTire {
     std::shared_ptr<fea::ChMesh> GetMesh() const { return m_mesh; }
 
     /// Get the mesh contact surface.
-    /// If contact is not enabled, an empty shared pointer is returned.
+    /// If contact is not enabled (or if multi-rate integration is enabled), an empty shared pointer is returned.
     std::shared_ptr<fea::ChContactSurface> GetContactSurface() const;
 
     /// Get the load container associated with this tire.
@@ -126,6 +148,14 @@ class CH_VEHICLE_API ChDeformableTire : public ChTire {
     /// Remove visualization assets for the rigid tire subsystem.
     virtual void RemoveVisualizationAssets() override final;
 
+    /// Update the state of this tire system at the current time.
+    /// With multi-rate integration, this synchronizes the rim body with the state of the associated wheel.
+    virtual void Synchronize(double time, const ChTerrain& terrain) override;
+
+    /// Advance the state of this tire by the specified time step.
+    /// With multi-rate integration, this advances the tire system to the end of the step using the tire step size.
+    virtual void Advance(double step) override;
+
   private:
     /// The following two functions are marked as final.
     /// The mass properties of a deformable tire are implicitly included through
@@ -138,10 +168,17 @@ class CH_VEHICLE_API ChDeformableTire : public ChTire {
     virtual void Initialize(std::shared_ptr<ChWheel> wheel) override;
 
     /// Get the tire force and moment.
-    /// A ChDeformableTire always returns zero forces and moments since tire forces
-    /// are implicitly applied to the associated wheel through the tire-wheel connections.
+    /// A ChDeformableTire returns zero forces and moments since tire forces are implicitly applied to the associated
+    /// wheel through the tire-wheel connections. With multi-rate integration, this returns the tire-rim reaction
+    /// forces, averaged over the last step, with the moment taken about the spindle center (the reported point).
     virtual TerrainForce GetTireForce() const override;
 
+    /// Calculate the resultant of the reaction forces and torques in the tire-rim connections.
+    TerrainForce CalculateRimForce() const;
+
+    /// Apply the tire-terrain contact forces to the mesh nodes (multi-rate integration only).
+    void ApplyTerrainForces();
+
   protected:
     /// Return the default tire pressure.
     virtual double GetDefaultPressure() const = 0;
@@ -190,6 +227,21 @@ class CH_VEHICLE_API ChDeformableTire : public ChTire {
 
     std::shared_ptr<ChMaterialSurfaceSMC> m_contact_mat;           ///< tire contact material
     std::shared_ptr<fea::ChVisualizationFEAmesh> m_visualization;  ///< tire mesh visualization
+
+    std::shared_ptr<ChBody> m_rim;  ///< body connected to the tire (wheel spindle, or rim body if multi-rate)
+
+  private:
+    bool m_multirate;                             ///< enable multi-rate integration
+    std::shared_ptr<ChSystemSMC> m_mr_system;     ///< system for multi-rate integration of the tire
+    const ChTerrain* m_mr_terrain;                ///< terrain system (multi-rate integration only)
+    std::shared_ptr<ChLinkMotionImposed> m_mr_motion;  ///< imposed motion of the rim body (multi-rate only)
+    TerrainForce m_mr_tire_force;                 ///< tire force, averaged over the last step
+    std::vector<std::shared_ptr<fea::ChNodeFEAxyz>> m_mr_nodes;        ///< mesh nodes (xyz type)
+    std::vector<std::shared_ptr<fea::ChNodeFEAxyzrot>> m_mr_nodes_rot;  ///< mesh nodes (xyzrot type)
+    std::vector<ChVector<>> m_mr_loc;             ///< node locations (terrain query points)
+    std::vector<double> m_mr_height;              ///< terrain heights below nodes
+    std::vector<ChVector<>> m_mr_normal;          ///< terrain normals below nodes
+    std::vector<float> m_mr_friction;             ///< terrain coefficients of friction below nodes
 };
 
 /// @} vehicle_wheeled_tire
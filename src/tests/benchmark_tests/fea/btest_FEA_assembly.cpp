@@ -0,0 +1,218 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Benchmark test for the parallel assembly of element contributions in ChMesh
+// (internal forces, M*v products, KRM matrix loading), for the different
+// ChMesh assembly modes and various numbers of OpenMP threads.
+//
+// Two meshes are considered: a plate of ANCF shell elements and a block of
+// ANCF brick elements, with automatic gravity loads.
+//
+// =============================================================================
+
+#include "chrono/ChConfig.h"
+#include "chrono/utils/ChBenchmark.h"
+
+#include "chrono/parallel/ChOpenMP.h"
+#include "chrono/physics/ChSystemSMC.h"
+#include "chrono/solver/ChIterativeSolverLS.h"
+
+#include "chrono/fea/ChElementBrick.h"
+#include "chrono/fea/ChElementShellANCF.h"
+#include "chrono/fea/ChMesh.h"
+
+using namespace chrono;
+using namespace chrono::fea;
+
+// Mesh with N x N ANCF shell elements.
+class ShellMesh {
+  public:
+    static void Create(std::shared_ptr<ChMesh> mesh, int N) {
+        double length = 1;
+        double thickness = 0.01;
+        double dx = length / N;
+
+        double rho = 500;
+        ChVector<> E(2.1e7, 2.1e7, 2.1e7);
+        ChVector<> nu(0.3, 0.3, 0.3);
+        ChVector<> G(8.0769231e6, 8.0769231e6, 8.0769231e6);
+        auto mat = chrono_types::make_shared<ChMaterialShellANCF>(rho, E, nu, G);
+
+        ChVector<> dir(0, 1, 0);
+        std::vector<std::shared_ptr<ChNodeFEAxyzD>> nodes;
+        for (int j = 0; j <= N; j++) {
+            for (int i = 0; i <= N; i++) {
+                auto node = chrono_types::make_shared<ChNodeFEAxyzD>(ChVector<>(i * dx, 0, j * dx), dir);
+                node->SetFixed(i == 0);
+                mesh->AddNode(node);
+                nodes.push_back(node);
+            }
+        }
+
+        for (int j = 0; j < N; j++) {
+            for (int i = 0; i < N; i++) {
+                int n0 = j * (N + 1) + i;
+                auto element = chrono_types::make_shared<ChElementShellANCF>();
+                element->SetNodes(nodes[n0], nodes[n0 + 1], nodes[n0 + N + 2], nodes[n0 + N + 1]);
+                element->SetDimensions(dx, dx);
+                element->AddLayer(thickness, 0 * CH_C_DEG_TO_RAD, mat);
+                element->SetAlphaDamp(0.0);
+                element->SetGravityOn(false);
+                mesh->AddElement(element);
+            }
+        }
+    }
+};
+
+// Mesh with N x N x 2 ANCF brick elements.
+class BrickMesh {
+  public:
+    static void Create(std::shared_ptr<ChMesh> mesh, int N) {
+        double length = 1;
+        double dx = length / N;
+        int NZ = 2;
+
+        auto mat = chrono_types::make_shared<ChContinuumElastic>();
+        mat->Set_RayleighDampingK(0.0);
+        mat->Set_RayleighDampingM(0.0);
+        mat->Set_density(500);
+        mat->Set_E(2.1e7);
+        mat->Set_G(2.1e7 / (2 + 2 * 0.3));
+        mat->Set_v(0.3);
+
+        std::vector<std::shared_ptr<ChNodeFEAxyz>> nodes;
+        for (int k = 0; k <= NZ; k++) {
+            for (int j = 0; j <= N; j++) {
+                for (int i = 0; i <= N; i++) {
+                    auto node = chrono_types::make_shared<ChNodeFEAxyz>(ChVector<>(i * dx, j * dx, k * dx));
+                    node->SetMass(0.0);
+                    node->SetFixed(i == 0);
+                    mesh->AddNode(node);
+                    nodes.push_back(node);
+                }
+            }
+        }
+
+        ChVectorN<double, 3> dims(dx, dx, dx);
+        int layer = (N + 1) * (N + 1);
+        for (int k = 0; k < NZ; k++) {
+            for (int j = 0; j < N; j++) {
+                for (int i = 0; i < N; i++) {
+                    int n0 = k * layer + j * (N + 1) + i;
+                    int n4 = n0 + layer;
+                    auto element = chrono_types::make_shared<ChElementBrick>();
+                    element->SetInertFlexVec(dims);
+                    element->SetNodes(nodes[n0], nodes[n0 + 1], nodes[n0 + N + 2], nodes[n0 + N + 1],  //
+                                      nodes[n4], nodes[n4 + 1], nodes[n4 + N + 2], nodes[n4 + N + 1]);
+                    element->SetMaterial(mat);
+                    element->SetElemNum((int)mesh->GetNelements());
+                    element->SetGravityOn(false);
+                    element->SetMooneyRivlin(false);
+                    element->SetStockAlpha(0, 0, 0, 0, 0, 0, 0, 0, 0);
+                    mesh->AddElement(element);
+                }
+            }
+        }
+    }
+};
+
+// Fixture for the mesh assembly benchmarks.
+// Benchmark arguments: assembly mode (0: ATOMIC, 1: COLORING, 2: REDUCTION) and number of threads.
+template <typename MESH, int N>
+class AssemblyFixture : public ::benchmark::Fixture {
+  public:
+    void SetUp(const ::benchmark::State& st) override {
+        m_system = new ChSystemSMC();
+        m_system->Set_G_acc(ChVector<>(0, -9.8, 0));
+
+        auto solver = chrono_types::make_shared<ChSolverMINRES>();
+        solver->SetMaxIterations(10);
+        m_system->SetSolver(solver);
+
+        m_mesh = chrono_types::make_shared<ChMesh>();
+        MESH::Create(m_mesh, N);
+        m_mesh->SetAssemblyMode(static_cast<ChMesh::AssemblyMode>(st.range(0)));
+        m_system->Add(m_mesh);
+
+        // Initialize the system
+        m_system->DoStepDynamics(1e-4);
+
+        m_R.setZero(m_system->GetNcoords_w());
+        m_w.setOnes(m_system->GetNcoords_w());
+
+        m_num_threads = CHOMPfunctions::GetMaxThreads();
+        CHOMPfunctions::SetNumThreads((int)st.range(1));
+    }
+
+    void TearDown(const ::benchmark::State&) override {
+        CHOMPfunctions::SetNumThreads(m_num_threads);
+        delete m_system;
+    }
+
+    void Report(benchmark::State& st) {
+        st.counters["Elements"] = m_mesh->GetNelements();
+        st.counters["Colors"] = m_mesh->GetNumColors();
+    }
+
+  protected:
+    ChSystemSMC* m_system;
+    std::shared_ptr<ChMesh> m_mesh;
+    ChVectorDynamic<> m_R;
+    ChVectorDynamic<> m_w;
+    int m_num_threads;
+};
+
+// Benchmark arguments: all assembly modes, with 1, 2, 4, and 8 threads.
+static void AssemblyArgs(benchmark::internal::Benchmark* b) {
+    for (int mode = 0; mode < 3; mode++)
+        for (int threads = 1; threads <= 8; threads *= 2)
+            b->Args({mode, threads});
+}
+
+#define BM_ASSEMBLY(TEST_NAME, MESH, N)                                                             \
+    BENCHMARK_TEMPLATE_DEFINE_F(AssemblyFixture, TEST_NAME##_F, MESH, N)(benchmark::State & st) {   \
+        while (st.KeepRunning()) {                                                                  \
+            m_mesh->IntLoadResidual_F(0, m_R, 1.0);                                                 \
+        }                                                                                           \
+        Report(st);                                                                                 \
+    }                                                                                               \
+    BENCHMARK_REGISTER_F(AssemblyFixture, TEST_NAME##_F)                                            \
+        ->Unit(benchmark::kMillisecond)                                                             \
+        ->ArgNames({"mode", "threads"})                                                             \
+        ->Apply(AssemblyArgs);                                                                      \
+    BENCHMARK_TEMPLATE_DEFINE_F(AssemblyFixture, TEST_NAME##_Mv, MESH, N)(benchmark::State & st) {  \
+        while (st.KeepRunning()) {                                                                  \
+            m_mesh->IntLoadResidual_Mv(0, m_R, m_w, 1.0);                                           \
+        }                                                                                           \
+        Report(st);                                                                                 \
+    }                                                                                               \
+    BENCHMARK_REGISTER_F(AssemblyFixture, TEST_NAME##_Mv)                                           \
+        ->Unit(benchmark::kMillisecond)                                                             \
+        ->ArgNames({"mode", "threads"})                                                             \
+        ->Apply(AssemblyArgs);                                                                      \
+    BENCHMARK_TEMPLATE_DEFINE_F(AssemblyFixture, TEST_NAME##_KRM, MESH, N)(benchmark::State & st) { \
+        while (st.KeepRunning()) {                                                                  \
+            m_mesh->KRMmatricesLoad(1.0, 1.0, 1.0);                                                 \
+        }                                                                                           \
+        Report(st);                                                                                 \
+    }                                                                                               \
+    BENCHMARK_REGISTER_F(AssemblyFixture, TEST_NAME##_KRM)                                          \
+        ->Unit(benchmark::kMillisecond)                                                             \
+        ->ArgNames({"mode", "threads"})                                                             \
+        ->Apply(AssemblyArgs);
+
+BM_ASSEMBLY(ANCFshell32, ShellMesh, 32)
+BM_ASSEMBLY(ANCFbrick16, BrickMesh, 16)
+
+BENCHMARK_MAIN();
@@ -150,6 +150,21 @@ class SystemFixture : public ::benchmark::Fixture {
     }                                                                                 \
     BENCHMARK_REGISTER_F(SystemFixture, TEST_NAME)->Unit(benchmark::kMillisecond);
 
+#define BM_SOLVER_LDLT(TEST_NAME, N, WITH_LEARNER)                                    \
+    BENCHMARK_TEMPLATE_DEFINE_F(SystemFixture, TEST_NAME, N)(benchmark::State & st) { \
+        auto solver = chrono_types::make_shared<ChSolverSparseLDLT>();                \
+        solver->UseSparsityPatternLearner(WITH_LEARNER);                              \
+        solver->LockSparsityPattern(true);                                            \
+        solver->SetVerbose(false);                                                    \
+        m_system->SetSolver(solver);                                                  \
+        while (st.KeepRunning()) {                                                    \
+            m_system->DoStaticLinear();                                               \
+        }                                                                             \
+        Report(st);                                                                   \
+        st.counters["LS_Analysis"] = solver->GetNumAnalysisCalls();                   \
+    }                                                                                 \
+    BENCHMARK_REGISTER_F(SystemFixture, TEST_NAME)->Unit(benchmark::kMillisecond);
+
 #ifdef CHRONO_MKL
 BM_SOLVER_MKL(MKL_learner_500, 500, true)
 BM_SOLVER_MKL(MKL_no_learner_500, 500, false)
@@ -186,3 +201,9 @@ BM_SOLVER_QR(QR_learner_4000, 4000, true)
 BM_SOLVER_QR(QR_no_learner_4000, 4000, false)
 BM_SOLVER_QR(QR_learner_8000, 8000, true)
 BM_SOLVER_QR(QR_no_learner_8000, 8000, false)
+
+BM_SOLVER_LDLT(LDLT_learner_500, 500, true)
+BM_SOLVER_LDLT(LDLT_learner_1000, 1000, true)
+BM_SOLVER_LDLT(LDLT_learner_2000, 2000, true)
+BM_SOLVER_LDLT(LDLT_learner_4000, 4000, true)
+BM_SOLVER_LDLT(LDLT_learner_8000, 8000, true)
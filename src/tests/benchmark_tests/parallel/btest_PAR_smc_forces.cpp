@@ -0,0 +1,122 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Benchmark test for the reduction of SMC contact forces to per-body forces in
+// Chrono::Parallel. The sort-based and the partitioned (sort-free) reductions
+// are compared for various numbers of OpenMP threads.
+//
+// The model is a settled granular bed of spheres in a box container. Each
+// benchmark iteration is a full simulation step; the time spent in contact
+// force processing is reported separately (counter "ProcessContact", in ms).
+//
+// =============================================================================
+
+#include "chrono/ChConfig.h"
+#include "chrono/utils/ChBenchmark.h"
+#include "chrono/utils/ChUtilsCreators.h"
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+using namespace chrono;
+
+// Fixture for the SMC force reduction benchmarks.
+// Benchmark arguments: reduction method (0: sort, 1: partition) and number of threads.
+template <int N>
+class SMCForcesFixture : public ::benchmark::Fixture {
+  public:
+    void SetUp(const ::benchmark::State& st) override {
+        int threads = (int)st.range(1);
+        CHOMPfunctions::SetNumThreads(threads);
+
+        m_system = new ChSystemParallelSMC();
+        m_system->Set_G_acc(ChVector<>(0, 0, -9.81));
+        m_system->GetSettings()->max_threads = threads;
+        m_system->GetSettings()->solver.contact_force_model = ChSystemSMC::Hertz;
+        m_system->GetSettings()->solver.tangential_displ_mode = ChSystemSMC::OneStep;
+        m_system->GetSettings()->solver.contact_force_reduction =
+            st.range(0) == 0 ? ContactForceReduction::SORT : ContactForceReduction::PARTITION;
+        m_system->GetSettings()->collision.bins_per_axis = vec3(20, 20, 10);
+
+        auto mat = chrono_types::make_shared<ChMaterialSurfaceSMC>();
+        mat->SetYoungModulus(1e7f);
+        mat->SetFriction(0.4f);
+        mat->SetRestitution(0.1f);
+
+        // Container and N x N x N spheres, initially on a slightly perturbed lattice
+        double radius = 0.05;
+        double hdim = N * radius + 0.1;
+        utils::CreateBoxContainer(m_system, -1, mat, ChVector<>(hdim, hdim, 2 * hdim), 0.1, ChVector<>(0, 0, 0),
+                                  QUNIT, true, false, true, false);
+
+        int id = 0;
+        for (int ix = 0; ix < N; ix++) {
+            for (int iy = 0; iy < N; iy++) {
+                for (int iz = 0; iz < N; iz++) {
+                    auto ball = std::shared_ptr<ChBody>(m_system->NewBody());
+                    ball->SetIdentifier(id++);
+                    ball->SetMass(1);
+                    ball->SetInertiaXX(0.4 * radius * radius * ChVector<>(1, 1, 1));
+                    ball->SetPos(ChVector<>((2 * ix - N + 1) * radius + 0.01 * radius * (iz % 3),
+                                            (2 * iy - N + 1) * radius, (2 * iz + 1.1) * radius));
+                    ball->SetCollide(true);
+                    ball->GetCollisionModel()->ClearModel();
+                    utils::AddSphereGeometry(ball.get(), mat, radius);
+                    ball->GetCollisionModel()->BuildModel();
+                    m_system->AddBody(ball);
+                }
+            }
+        }
+
+        // Let the granular material settle
+        for (int i = 0; i < 200; i++)
+            m_system->DoStepDynamics(m_step);
+    }
+
+    void TearDown(const ::benchmark::State&) override { delete m_system; }
+
+    void Report(benchmark::State& st, double time_contact) {
+        st.counters["Bodies"] = (double)m_system->Get_bodylist().size();
+        st.counters["Contacts"] = (double)m_system->GetNcontacts();
+        st.counters["ProcessContact"] = 1e3 * time_contact / st.iterations();
+    }
+
+  protected:
+    ChSystemParallelSMC* m_system;
+    double m_step = 1e-4;
+};
+
+// Benchmark arguments: both reduction methods, with 1, 2, 4, and 8 threads.
+static void SMCForcesArgs(benchmark::internal::Benchmark* b) {
+    for (int method = 0; method <= 1; method++)
+        for (int threads = 1; threads <= 8; threads *= 2)
+            b->Args({method, threads});
+}
+
+#define BM_SMC_FORCES(TEST_NAME, N)                                          \
+    BENCHMARK_TEMPLATE_DEFINE_F(SMCForcesFixture, TEST_NAME, N)              \
+    (benchmark::State & st) {                                                \
+        double time_contact = 0;                                             \
+        while (st.KeepRunning()) {                                           \
+            m_system->DoStepDynamics(m_step);                                \
+            time_contact += m_system->GetTimerProcessContact();              \
+        }                                                                    \
+        Report(st, time_contact);                                            \
+    }                                                                        \
+    BENCHMARK_REGISTER_F(SMCForcesFixture, TEST_NAME)                        \
+        ->Unit(benchmark::kMillisecond)                                      \
+        ->ArgNames({"partition", "threads"})                                 \
+        ->Apply(SMCForcesArgs);
+
+BM_SMC_FORCES(Spheres10, 10)
+BM_SMC_FORCES(Spheres20, 20)
@@ -0,0 +1,148 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Benchmark test for the parallel assembly passes in ChAssembly (state update,
+// state gather/scatter, loading of residuals and constraint terms, collision
+// model synchronization), for various numbers of OpenMP threads. The collision
+// benchmark includes the (serial) collision detection.
+//
+// The model consists of a set of pendulum chains, with bodies connected through
+// spherical joints. All bodies have a collision model.
+//
+// =============================================================================
+
+#include "chrono/ChConfig.h"
+#include "chrono/utils/ChBenchmark.h"
+
+#include "chrono/physics/ChBodyEasy.h"
+#include "chrono/physics/ChLinkLock.h"
+#include "chrono/physics/ChSystemSMC.h"
+
+using namespace chrono;
+
+// Fixture for the assembly benchmarks.
+// Benchmark argument: number of threads.
+template <int M, int N>
+class AssemblyFixture : public ::benchmark::Fixture {
+  public:
+    void SetUp(const ::benchmark::State& st) override {
+        m_system = new ChSystemSMC();
+        m_system->Set_G_acc(ChVector<>(0, -9.8, 0));
+        m_system->SetNumThreads((int)st.range(0));
+
+        auto mat = chrono_types::make_shared<ChMaterialSurfaceSMC>();
+
+        // Create M chains, each with N bodies
+        for (int i = 0; i < M; i++) {
+            auto ground = chrono_types::make_shared<ChBody>();
+            ground->SetBodyFixed(true);
+            ground->SetPos(ChVector<>(0, 0, i));
+            m_system->AddBody(ground);
+
+            std::shared_ptr<ChBody> prev = ground;
+            for (int j = 1; j <= N; j++) {
+                auto body = chrono_types::make_shared<ChBodyEasySphere>(0.1, 1000, true, false, mat);
+                body->SetPos(ChVector<>(0.5 * j, 0, i));
+                m_system->AddBody(body);
+
+                auto joint = chrono_types::make_shared<ChLinkLockSpherical>();
+                joint->Initialize(prev, body, ChCoordsys<>(ChVector<>(0.5 * j - 0.25, 0, i)));
+                m_system->AddLink(joint);
+
+                prev = body;
+            }
+        }
+
+        // Initialize the system
+        m_system->DoStepDynamics(1e-4);
+
+        m_x.setZero(m_system->GetNcoords_x(), m_system);
+        m_v.setZero(m_system->GetNcoords_w(), m_system);
+        m_R.setZero(m_system->GetNcoords_w());
+        m_Qc.setZero(m_system->GetNconstr());
+        m_system->StateGather(m_x, m_v, m_T);
+    }
+
+    void TearDown(const ::benchmark::State&) override { delete m_system; }
+
+    void Report(benchmark::State& st) {
+        st.counters["Bodies"] = (double)m_system->Get_bodylist().size();
+        st.counters["Links"] = (double)m_system->Get_linklist().size();
+    }
+
+  protected:
+    ChSystemSMC* m_system;
+    ChState m_x;
+    ChStateDelta m_v;
+    ChVectorDynamic<> m_R;
+    ChVectorDynamic<> m_Qc;
+    double m_T;
+};
+
+// Benchmark arguments: 1, 2, 4, and 8 threads.
+static void AssemblyArgs(benchmark::internal::Benchmark* b) {
+    for (int threads = 1; threads <= 8; threads *= 2)
+        b->Args({threads});
+}
+
+#define BM_ASSEMBLY(TEST_NAME, M, N)                                              \
+    BENCHMARK_TEMPLATE_DEFINE_F(AssemblyFixture, TEST_NAME##_Update, M, N)        \
+    (benchmark::State & st) {                                                     \
+        while (st.KeepRunning()) {                                                \
+            m_system->Update(false);                                              \
+        }                                                                         \
+        Report(st);                                                               \
+    }                                                                             \
+    BENCHMARK_REGISTER_F(AssemblyFixture, TEST_NAME##_Update)                     \
+        ->Unit(benchmark::kMicrosecond)                                           \
+        ->ArgNames({"threads"})                                                   \
+        ->Apply(AssemblyArgs);                                                    \
+    BENCHMARK_TEMPLATE_DEFINE_F(AssemblyFixture, TEST_NAME##_GatherScatter, M, N) \
+    (benchmark::State & st) {                                                     \
+        while (st.KeepRunning()) {                                                \
+            m_system->IntStateGather(0, m_x, 0, m_v, m_T);                        \
+            m_system->IntStateScatter(0, m_x, 0, m_v, m_T);                       \
+        }                                                                         \
+        Report(st);                                                               \
+    }                                                                             \
+    BENCHMARK_REGISTER_F(AssemblyFixture, TEST_NAME##_GatherScatter)              \
+        ->Unit(benchmark::kMicrosecond)                                           \
+        ->ArgNames({"threads"})                                                   \
+        ->Apply(AssemblyArgs);                                                    \
+    BENCHMARK_TEMPLATE_DEFINE_F(AssemblyFixture, TEST_NAME##_Residual, M, N)      \
+    (benchmark::State & st) {                                                     \
+        while (st.KeepRunning()) {                                                \
+            m_system->LoadResidual_F(m_R, 1.0);                                   \
+            m_system->LoadConstraint_C(m_Qc, 1.0);                                \
+        }                                                                         \
+        Report(st);                                                               \
+    }                                                                             \
+    BENCHMARK_REGISTER_F(AssemblyFixture, TEST_NAME##_Residual)                   \
+        ->Unit(benchmark::kMicrosecond)                                           \
+        ->ArgNames({"threads"})                                                   \
+        ->Apply(AssemblyArgs);                                                    \
+    BENCHMARK_TEMPLATE_DEFINE_F(AssemblyFixture, TEST_NAME##_Collision, M, N)     \
+    (benchmark::State & st) {                                                     \
+        while (st.KeepRunning()) {                                                \
+            m_system->ComputeCollisions();                                        \
+        }                                                                         \
+        Report(st);                                                               \
+    }                                                                             \
+    BENCHMARK_REGISTER_F(AssemblyFixture, TEST_NAME##_Collision)                  \
+        ->Unit(benchmark::kMicrosecond)                                           \
+        ->ArgNames({"threads"})                                                   \
+        ->Apply(AssemblyArgs);
+
+BM_ASSEMBLY(Chains10x100, 10, 100)
+BM_ASSEMBLY(Chains100x100, 100, 100)
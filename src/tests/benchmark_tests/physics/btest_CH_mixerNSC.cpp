@@ -13,6 +13,9 @@
 // =============================================================================
 //
 // Benchmark test for contact simulation using NSC contact.
+// The mixer scenes are run with both storage modes of the NSC contact container
+// (linked lists of individually allocated contacts vs. pools of recycled contacts)
+// and with serial and multithreaded Bullet collision detection.
 //
 // =============================================================================
 
@@ -20,8 +23,10 @@
 #include "chrono/utils/ChBenchmark.h"
 
 #include "chrono/physics/ChSystemNSC.h"
+#include "chrono/physics/ChContactContainerNSC.h"
 #include "chrono/physics/ChBodyEasy.h"
 #include "chrono/physics/ChLinkMotorRotationSpeed.h"
+#include "chrono/collision/ChCollisionSystemBullet.h"
 
 #ifdef CHRONO_IRRLICHT
 #include "chrono_irrlicht/ChIrrApp.h"
@@ -31,7 +36,7 @@ using namespace chrono;
 
 // =============================================================================
 
-template <int N>
+template <int N, ChContactStorageMode M = ChContactStorageMode::LIST, int T = 1>
 class MixerTestNSC : public utils::ChBenchmarkTest {
   public:
     MixerTestNSC();
@@ -47,8 +52,13 @@ class MixerTestNSC : public utils::ChBenchmarkTest {
     double m_step;
 };
 
-template <int N>
-MixerTestNSC<N>::MixerTestNSC() : m_system(new ChSystemNSC()), m_step(0.02) {
+template <int N, ChContactStorageMode M, int T>
+MixerTestNSC<N, M, T>::MixerTestNSC() : m_system(new ChSystemNSC()), m_step(0.02) {
+    std::static_pointer_cast<ChContactContainerNSC>(m_system->GetContactContainer())->SetContactStorageMode(M);
+    auto collsys = std::static_pointer_cast<collision::ChCollisionSystemBullet>(m_system->GetCollisionSystem());
+    collsys->SetNumThreads(T);
+    collsys->SetDeterministic(true);
+
     auto mat = chrono_types::make_shared<ChMaterialSurfaceNSC>();
 
     for (int bi = 0; bi < N; bi++) {
@@ -101,8 +111,8 @@ MixerTestNSC<N>::MixerTestNSC() : m_system(new ChSystemNSC()), m_step(0.02) {
     m_system->AddLink(my_motor);
 }
 
-template <int N>
-void MixerTestNSC<N>::SimulateVis() {
+template <int N, ChContactStorageMode M, int T>
+void MixerTestNSC<N, M, T>::SimulateVis() {
 #ifdef CHRONO_IRRLICHT
     irrlicht::ChIrrApp application(m_system, L"Rigid contacts", irr::core::dimension2d<irr::u32>(800, 600), false, true);
     application.AddTypicalLogo();
@@ -130,6 +140,14 @@ void MixerTestNSC<N>::SimulateVis() {
 CH_BM_SIMULATION_LOOP(MixerNSC032, MixerTestNSC<32>,  NUM_SKIP_STEPS, NUM_SIM_STEPS, 10);
 CH_BM_SIMULATION_LOOP(MixerNSC064, MixerTestNSC<64>,  NUM_SKIP_STEPS, NUM_SIM_STEPS, 10);
 
+using MixerTestNSC032pool = MixerTestNSC<32, ChContactStorageMode::POOL>;
+using MixerTestNSC064pool = MixerTestNSC<64, ChContactStorageMode::POOL>;
+CH_BM_SIMULATION_LOOP(MixerNSC032pool, MixerTestNSC032pool, NUM_SKIP_STEPS, NUM_SIM_STEPS, 10);
+CH_BM_SIMULATION_LOOP(MixerNSC064pool, MixerTestNSC064pool, NUM_SKIP_STEPS, NUM_SIM_STEPS, 10);
+
+using MixerTestNSC064mt4 = MixerTestNSC<64, ChContactStorageMode::POOL, 4>;
+CH_BM_SIMULATION_LOOP(MixerNSC064mt4, MixerTestNSC064mt4, NUM_SKIP_STEPS, NUM_SIM_STEPS, 10);
+
 // =============================================================================
 
 int main(int argc, char* argv[]) {
@@ -0,0 +1,115 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Benchmark test for implicit integration of SMC contact.
+// A column of spheres settles in a box container, using the HHT integrator
+// with the sparse LDLT direct solver. With stiff contact enabled, the Jacobians
+// of the contact forces are included in the Newton iteration matrix.
+//
+// =============================================================================
+
+#include "chrono/ChConfig.h"
+#include "chrono/utils/ChBenchmark.h"
+
+#include "chrono/physics/ChSystemSMC.h"
+#include "chrono/physics/ChBodyEasy.h"
+#include "chrono/solver/ChDirectSolverLS.h"
+#include "chrono/timestepper/ChTimestepperHHT.h"
+
+using namespace chrono;
+
+// =============================================================================
+
+template <int N, bool STIFF = true>
+class ColumnTestSMC : public utils::ChBenchmarkTest {
+  public:
+    ColumnTestSMC();
+    ~ColumnTestSMC() { delete m_system; }
+
+    ChSystem* GetSystem() override { return m_system; }
+    void ExecuteStep() override { m_system->DoStepDynamics(m_step); }
+
+  private:
+    ChSystemSMC* m_system;
+    double m_step;
+};
+
+template <int N, bool STIFF>
+ColumnTestSMC<N, STIFF>::ColumnTestSMC() : m_system(new ChSystemSMC()), m_step(1e-3) {
+    m_system->Set_G_acc(ChVector<>(0, 0, -9.81));
+    m_system->SetContactForceModel(ChSystemSMC::Hertz);
+    m_system->SetStiffContact(STIFF);
+
+    auto solver = chrono_types::make_shared<ChSolverSparseLDLT>();
+    solver->LockSparsityPattern(false);
+    m_system->SetSolver(solver);
+
+    m_system->SetTimestepperType(ChTimestepper::Type::HHT);
+    auto integrator = std::static_pointer_cast<ChTimestepperHHT>(m_system->GetTimestepper());
+    integrator->SetAlpha(-0.2);
+    integrator->SetMaxiters(50);
+    integrator->SetAbsTolerances(1e-4);
+    integrator->SetMode(ChTimestepperHHT::ACCELERATION);
+    integrator->SetScaling(true);
+
+    auto mat = chrono_types::make_shared<ChMaterialSurfaceSMC>();
+    mat->SetYoungModulus(1e7f);
+    mat->SetRestitution(0.1f);
+    mat->SetFriction(0.4f);
+
+    // Container
+    double hx = 0.35;
+    double hz = 0.3 * N;
+    auto floor = chrono_types::make_shared<ChBodyEasyBox>(2 * hx, 2 * hx, 0.1, 1000, false, true, mat);
+    floor->SetPos(ChVector<>(0, 0, -0.05));
+    floor->SetBodyFixed(true);
+    m_system->Add(floor);
+
+    for (int i = 0; i < 4; i++) {
+        double angle = i * CH_C_PI_2;
+        auto wall = chrono_types::make_shared<ChBodyEasyBox>(0.1, 2 * hx + 0.2, 2 * hz, 1000, false, true, mat);
+        wall->SetPos(ChVector<>((hx + 0.05) * std::cos(angle), (hx + 0.05) * std::sin(angle), hz));
+        wall->SetRot(Q_from_AngZ(angle));
+        wall->SetBodyFixed(true);
+        m_system->Add(wall);
+    }
+
+    // Column of spheres (3 x 3 per layer), slightly perturbed from a regular lattice
+    double radius = 0.1;
+    for (int iz = 0; iz < N; iz++) {
+        for (int ix = -1; ix <= 1; ix++) {
+            for (int iy = -1; iy <= 1; iy++) {
+                auto ball = chrono_types::make_shared<ChBodyEasySphere>(radius, 1000, false, true, mat);
+                ball->SetPos(ChVector<>(2.1 * radius * ix + 0.01 * (iz % 2), 2.1 * radius * iy,
+                                        radius + 2.1 * radius * iz));
+                m_system->Add(ball);
+            }
+        }
+    }
+}
+
+// =============================================================================
+
+#define NUM_SKIP_STEPS 200  // number of steps for hot start
+#define NUM_SIM_STEPS 200   // number of simulation steps for each benchmark
+
+CH_BM_SIMULATION_LOOP(ColumnSMC04, ColumnTestSMC<4>, NUM_SKIP_STEPS, NUM_SIM_STEPS, 10);
+CH_BM_SIMULATION_LOOP(ColumnSMC08, ColumnTestSMC<8>, NUM_SKIP_STEPS, NUM_SIM_STEPS, 10);
+
+using ColumnTestSMC08nonstiff = ColumnTestSMC<8, false>;
+CH_BM_SIMULATION_LOOP(ColumnSMC08nonstiff, ColumnTestSMC08nonstiff, NUM_SKIP_STEPS, NUM_SIM_STEPS, 10);
+
+// =============================================================================
+
+BENCHMARK_MAIN();
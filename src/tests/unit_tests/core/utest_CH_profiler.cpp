@@ -0,0 +1,154 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Tests for the per-thread profiler.
+// Nested scopes are profiled from several OpenMP threads. The merged tree must
+// report the total number of calls and the sum of the per-thread times, and so
+// must the CSV and trace-event outputs. The data of a terminated thread must be
+// released by CleanupMemory.
+//
+// =============================================================================
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "chrono/parallel/ChOpenMP.h"
+#include "chrono/utils/ChProfiler.h"
+
+using namespace chrono;
+using namespace chrono::utils;
+
+const int num_outer = 50;
+const int num_inner = 3;
+
+// Profile nested scopes from 'num_threads' OpenMP threads. Return the number of threads actually used.
+static int ProfileThreads(int num_threads) {
+    int used_threads = 1;
+#pragma omp parallel num_threads(num_threads)
+    {
+#pragma omp master
+        used_threads = CHOMPfunctions::GetNumThreads();
+        for (int i = 0; i < num_outer; i++) {
+            CH_PROFILE("outer");
+            for (int j = 0; j < num_inner; j++) {
+                CH_PROFILE("inner");
+                volatile double x = 0;
+                for (int k = 0; k < 1000; k++)
+                    x = x + std::sqrt((double)k);
+            }
+        }
+    }
+    return used_threads;
+}
+
+// Move the iterator to the child node with the given name. Return false if no such child.
+static bool EnterChild(ChProfileIterator* it, const std::string& name) {
+    int index = 0;
+    for (it->First(); !it->Is_Done(); it->Next(), index++) {
+        if (name == it->Get_Current_Name()) {
+            it->Enter_Child(index);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Count the occurrences of a string in a file.
+static int CountInFile(const std::string& filename, const std::string& str) {
+    std::ifstream file(filename);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    int count = 0;
+    for (size_t pos = contents.find(str); pos != std::string::npos; pos = contents.find(str, pos + str.size()))
+        count++;
+    return count;
+}
+
+TEST(ChProfileManager, threads) {
+    ChProfileManager::CleanupMemory();
+    ChProfileManager::Set_Trace_Events(true);
+    ChProfileManager::Reset();
+
+    int nthreads = ProfileThreads(4);
+    ASSERT_GE(ChProfileManager::Get_Thread_Count(), nthreads);
+
+    // Sum the per-thread calls and times of the outer scope
+    int outer_calls = 0;
+    double outer_time = 0;
+    for (int i = 0; i < ChProfileManager::Get_Thread_Count(); i++) {
+        ChProfileIterator* it = ChProfileManager::Get_Thread_Iterator(i);
+        ASSERT_NE(it, nullptr);
+        if (EnterChild(it, "outer")) {
+            outer_calls += it->Get_Current_Parent_Total_Calls();
+            outer_time += it->Get_Current_Parent_Total_Time();
+        }
+        ChProfileManager::Release_Iterator(it);
+    }
+    EXPECT_EQ(outer_calls, nthreads * num_outer);
+    EXPECT_EQ(ChProfileManager::Get_Thread_Iterator(ChProfileManager::Get_Thread_Count()), nullptr);
+
+    // Two merged trees can be used at the same time, and outlive each other
+    ChProfileIterator* merged1 = ChProfileManager::Get_Merged_Iterator();
+    ChProfileIterator* merged2 = ChProfileManager::Get_Merged_Iterator();
+    ASSERT_TRUE(EnterChild(merged1, "outer"));
+    ChProfileManager::Release_Iterator(merged1);
+
+    ASSERT_TRUE(EnterChild(merged2, "outer"));
+    EXPECT_EQ(merged2->Get_Current_Parent_Total_Calls(), nthreads * num_outer);
+    EXPECT_NEAR(merged2->Get_Current_Parent_Total_Time(), outer_time, 1e-3 * outer_time);
+    ASSERT_TRUE(EnterChild(merged2, "inner"));
+    EXPECT_EQ(merged2->Get_Current_Parent_Total_Calls(), nthreads * num_outer * num_inner);
+    ChProfileManager::Release_Iterator(merged2);
+
+    // CSV output: one row per thread and node, with the number of calls
+    std::string csv_file = "utest_CH_profiler.csv";
+    ASSERT_TRUE(ChProfileManager::dumpCSV(csv_file.c_str()));
+    EXPECT_EQ(CountInFile(csv_file, ",\"outer\"," + std::to_string(num_outer) + ","), nthreads);
+    EXPECT_EQ(CountInFile(csv_file, ",\"outer/inner\"," + std::to_string(num_outer * num_inner) + ","), nthreads);
+    std::remove(csv_file.c_str());
+
+    // Trace output: one event per profiled scope
+    std::string trace_file = "utest_CH_profiler.json";
+    ASSERT_TRUE(ChProfileManager::dumpChromeTrace(trace_file.c_str()));
+    EXPECT_EQ(CountInFile(trace_file, "{\"name\":\"outer\""), nthreads * num_outer);
+    EXPECT_EQ(CountInFile(trace_file, "{\"name\":\"inner\""), nthreads * num_outer * num_inner);
+    std::remove(trace_file.c_str());
+
+    ChProfileManager::Set_Trace_Events(false);
+}
+
+TEST(ChProfileManager, release_threads) {
+    ChProfileManager::CleanupMemory();
+    ChProfileManager::Reset();
+    int count = ChProfileManager::Get_Thread_Count();
+
+    // The data of a terminated thread remains available until CleanupMemory
+    std::thread worker([]() {
+        CH_PROFILE("worker");
+    });
+    worker.join();
+    EXPECT_EQ(ChProfileManager::Get_Thread_Count(), count + 1);
+
+    ChProfileIterator* merged = ChProfileManager::Get_Merged_Iterator();
+    ASSERT_TRUE(EnterChild(merged, "worker"));
+    EXPECT_EQ(merged->Get_Current_Parent_Total_Calls(), 1);
+    ChProfileManager::Release_Iterator(merged);
+
+    ChProfileManager::CleanupMemory();
+    EXPECT_EQ(ChProfileManager::Get_Thread_Count(), count);
+}
@@ -0,0 +1,130 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2016 projectchrono.org
+// All right reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Unit test for load balancing in Chrono::Distributed.
+// A pile of spheres is created in a corner of the domain, so that with an equal
+// split of the domain most ranks have no bodies. The test checks that the load
+// imbalance decreases and that no body is lost or duplicated while bodies are
+// migrated between ranks. On 4 ranks, the domain is split along x and y (2 x 2
+// sub-domains); otherwise, it is split along x.
+//
+// To be run on 4 MPI ranks (e.g. mpirun -np 4 utest_DISTR_balance).
+//
+// =============================================================================
+
+#include <mpi.h>
+#include <iostream>
+#include <memory>
+
+#include "chrono/physics/ChBody.h"
+
+#include "chrono_distributed/collision/ChCollisionModelDistributed.h"
+#include "chrono_distributed/physics/ChSystemDistributed.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+// Count the bodies for which this rank is responsible (owned or shared) on all ranks.
+static int CountBodies(ChSystemDistributed& sys) {
+    int count = 0;
+    for (uint i = 0; i < sys.data_manager->num_rigid_bodies; i++) {
+        distributed::COMM_STATUS status = sys.ddm->comm_status[i];
+        if (status == distributed::OWNED || status == distributed::SHARED_UP || status == distributed::SHARED_DOWN)
+            count++;
+    }
+    int total = 0;
+    MPI_Allreduce(&count, &total, 1, MPI_INT, MPI_SUM, sys.GetCommunicator());
+    return total;
+}
+
+int main(int argc, char* argv[]) {
+    MPI_Init(&argc, &argv);
+
+    double radius = 0.1;
+    ChSystemDistributed sys(MPI_COMM_WORLD, 2 * radius, 10000);
+    sys.Set_G_acc(ChVector<double>(0, 0, -9.8));
+    sys.GetSettings()->solver.contact_force_model = ChSystemSMC::ContactForceModel::Hertz;
+    sys.GetSettings()->collision.bins_per_axis = vec3(10, 10, 10);
+
+    if (sys.GetCommSize() == 4)
+        sys.GetDomain()->SetNumSubdomains(2, 2, 1);
+    else
+        sys.GetDomain()->SetSplitAxis(0);
+    sys.GetDomain()->SetSimDomain(0, 20, 0, 4, -1, 5);
+    sys.GetDomain()->SetLoadBalancing(10, ChDomainDistributed::LoadMetric::BODY_COUNT);
+
+    auto material = chrono_types::make_shared<ChMaterialSurfaceSMC>();
+
+    // Fixed ground plate spanning the whole domain
+    auto ground = std::shared_ptr<ChBody>(sys.NewBody());
+    ground->SetBodyFixed(true);
+    ground->SetPos(ChVector<>(10, 2, -0.5));
+    ground->GetCollisionModel()->ClearModel();
+    ground->GetCollisionModel()->AddBox(material, 10, 2, 0.5);
+    ground->GetCollisionModel()->BuildModel();
+    ground->SetCollide(true);
+    sys.AddBody(ground);
+
+    // Spheres, all in a corner of the domain
+    int num_balls = 0;
+    for (int ix = 0; ix < 20; ix++) {
+        for (int iy = 0; iy < 8; iy++) {
+            for (int iz = 0; iz < 4; iz++) {
+                ChVector<> pos(0.3 + 2.2 * radius * ix, 0.2 + 2.2 * radius * iy, radius + 2.2 * radius * iz);
+                auto ball = std::shared_ptr<ChBody>(sys.NewBody());
+                ball->SetMass(1);
+                ball->SetInertiaXX(0.4 * radius * radius * ChVector<>(1, 1, 1));
+                ball->SetPos(pos);
+                ball->GetCollisionModel()->ClearModel();
+                ball->GetCollisionModel()->AddSphere(material, radius);
+                ball->GetCollisionModel()->BuildModel();
+                ball->SetCollide(true);
+                sys.AddBody(ball);
+                num_balls++;
+            }
+        }
+    }
+
+    bool passed = true;
+    double initial_imbalance = -1;
+    for (int i = 0; i < 2000; i++) {
+        sys.DoStepDynamics(1e-4);
+        if (i == 10)
+            initial_imbalance = sys.GetDomain()->GetLoadImbalance();
+        if (i % 100 == 0 && CountBodies(sys) != num_balls) {
+            passed = false;
+            break;
+        }
+    }
+
+    double final_imbalance = sys.GetDomain()->GetLoadImbalance();
+    if (sys.GetCommSize() > 1 && !(final_imbalance < initial_imbalance))
+        passed = false;
+
+    if (sys.OnMaster()) {
+        std::cout << "Load imbalance: " << initial_imbalance << " -> " << final_imbalance << std::endl;
+        for (int axis = 0; axis < 3; axis++) {
+            if (sys.GetDomain()->GetNumSubdomains(axis) == 1)
+                continue;
+            std::cout << "Boundaries along axis " << axis << ":";
+            for (auto b : sys.GetDomain()->GetBoundaries(axis))
+                std::cout << " " << b;
+            std::cout << std::endl;
+        }
+        std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    }
+
+    MPI_Finalize();
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,292 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2016 projectchrono.org
+// All right reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Unit test for the ghost exchange in Chrono::Distributed.
+// The delta encoding and decoding of ghost updates is first checked on each
+// rank. Spheres rolling across the sub-domain boundaries are then simulated.
+// The exchange is carried out during the collision detection of each step;
+// once the contacts are found (i.e., in a custom collision callback), the state
+// of every ghost must match the state of the corresponding shared body on its
+// owner rank, and no contact may be reported twice. Finally, exchanges are
+// posted and completed explicitly; after the first one, the body states do not
+// change and no ghost update must be sent.
+//
+// On an even number of ranks (4 or more), the domain is split along x and y, so
+// that the bodies near the edges of the sub-domains have ghosts on up to 3 ranks.
+//
+// To be run on 2 or more MPI ranks (e.g. mpirun -np 4 utest_DISTR_exchange).
+//
+// =============================================================================
+
+#include <mpi.h>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "chrono/physics/ChBody.h"
+
+#include "chrono_distributed/collision/ChCollisionModelDistributed.h"
+#include "chrono_distributed/comm/ChCommDistributed.h"
+#include "chrono_distributed/physics/ChSystemDistributed.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+// Encode an update against the reference state of the sender, decode it into the reference state of the receiver.
+// Return the flags of the sent fields (0 if no update was sent).
+static unsigned char SendUpdate(const BodyUpdate& upd, BodyUpdate& sender, BodyUpdate& receiver, double tol) {
+    std::vector<char> buf;
+    if (!ChCommDistributed::EncodeUpdate(buf, upd, sender, tol))
+        return buf.empty() ? 0 : 0xFF;
+    size_t offset = 0;
+    BodyUpdate msg;
+    unsigned char fields = ChCommDistributed::DecodeUpdate(buf, offset, msg);
+    if (offset != buf.size())
+        return 0xFF;
+    ChCommDistributed::MergeUpdate(receiver, msg, fields);
+    return fields;
+}
+
+static bool Equal(const BodyUpdate& a, const BodyUpdate& b) {
+    return a.gid == b.gid && std::memcmp(a.pos, b.pos, sizeof(a.pos)) == 0 &&
+           std::memcmp(a.rot, b.rot, sizeof(a.rot)) == 0 && std::memcmp(a.vel, b.vel, sizeof(a.vel)) == 0;
+}
+
+// Check the delta encoding and decoding of ghost updates.
+static bool TestDeltaEncoding() {
+    BodyUpdate upd = {7, distributed::UPDATE, {1, 2, 3}, {1, 0, 0, 0}, {0.1, 0.2, 0.3, 0.4, 0.5, 0.6}};
+    BodyUpdate sender = {UINT_MAX};
+    BodyUpdate receiver = {UINT_MAX};
+    bool passed = true;
+
+    // No reference state: all fields are sent
+    passed &= SendUpdate(upd, sender, receiver, 0) == ChCommDistributed::FIELD_ALL;
+    passed &= Equal(receiver, upd) && Equal(sender, upd);
+
+    // Unchanged state: no update
+    passed &= SendUpdate(upd, sender, receiver, 0) == 0;
+
+    // Changed angular velocity only
+    upd.vel[4] = -0.5;
+    passed &= SendUpdate(upd, sender, receiver, 0) == ChCommDistributed::FIELD_ANG_VEL;
+    passed &= Equal(receiver, upd) && Equal(sender, upd);
+
+    // Changes below the tolerance are not sent, and the reference states are not modified
+    upd.pos[0] += 5e-4;
+    passed &= SendUpdate(upd, sender, receiver, 1e-3) == 0;
+    passed &= Equal(receiver, sender) && receiver.pos[0] == 1;
+
+    // Accumulated changes above the tolerance are sent
+    upd.pos[0] += 1e-3;
+    upd.rot[1] = 1e-4;
+    passed &= SendUpdate(upd, sender, receiver, 1e-3) == ChCommDistributed::FIELD_POS;
+    passed &= Equal(receiver, sender) && receiver.pos[0] == upd.pos[0] && receiver.rot[1] == 0;
+
+    // Ownership changes send all fields
+    upd.update_type = distributed::FINAL_UPDATE_GIVE;
+    passed &= SendUpdate(upd, sender, receiver, 1e-3) == ChCommDistributed::FIELD_ALL;
+    passed &= Equal(receiver, upd) && receiver.update_type == distributed::FINAL_UPDATE_GIVE;
+
+    return passed;
+}
+
+// Pack the state of the given body (gid, position, rotation, linear and angular velocity).
+static void PackState(std::vector<double>& buf, unsigned int gid, const ChBody& body) {
+    ChVector<> pos = body.GetPos();
+    ChQuaternion<> rot = body.GetRot();
+    ChVector<> vel = body.GetPos_dt();
+    ChVector<> omg = body.GetWvel_par();
+    double state[14] = {(double)gid, pos.x(), pos.y(), pos.z(), rot.e0(), rot.e1(), rot.e2(),
+                        rot.e3(),    vel.x(), vel.y(), vel.z(), omg.x(), omg.y(), omg.z()};
+    buf.insert(buf.end(), state, state + 14);
+}
+
+// Check that the state of every ghost matches the state of the shared body on its owner rank.
+// Return the number of ghosts on all ranks, or -1 if any ghost state does not match.
+static int CheckGhosts(ChSystemDistributed& sys) {
+    std::vector<double> shared;
+    std::vector<double> ghosts;
+    for (uint i = 0; i < sys.data_manager->num_rigid_bodies; i++) {
+        distributed::COMM_STATUS status = sys.ddm->comm_status[i];
+        const auto& body = *(*sys.data_manager->body_list)[i];
+        if (status == distributed::SHARED_UP || status == distributed::SHARED_DOWN)
+            PackState(shared, sys.ddm->global_id[i], body);
+        else if (status == distributed::GHOST_UP || status == distributed::GHOST_DOWN)
+            PackState(ghosts, sys.ddm->global_id[i], body);
+    }
+
+    // Collect the states of the shared bodies from all ranks
+    int num_ranks = sys.GetCommSize();
+    int count = (int)shared.size();
+    std::vector<int> counts(num_ranks);
+    std::vector<int> displs(num_ranks, 0);
+    MPI_Allgather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, sys.GetCommunicator());
+    for (int r = 1; r < num_ranks; r++)
+        displs[r] = displs[r - 1] + counts[r - 1];
+    std::vector<double> all_shared(displs[num_ranks - 1] + counts[num_ranks - 1]);
+    MPI_Allgatherv(shared.data(), count, MPI_DOUBLE, all_shared.data(), counts.data(), displs.data(), MPI_DOUBLE,
+                   sys.GetCommunicator());
+
+    std::map<unsigned int, const double*> owner_state;
+    for (size_t k = 0; k < all_shared.size(); k += 14)
+        owner_state[(unsigned int)all_shared[k]] = &all_shared[k];
+
+    int mismatch = 0;
+    for (size_t k = 0; k < ghosts.size(); k += 14) {
+        auto it = owner_state.find((unsigned int)ghosts[k]);
+        if (it == owner_state.end()) {
+            mismatch++;
+            continue;
+        }
+        // Exact match for position, rotation and linear velocity; the angular velocity of the ghost is converted to
+        // and from its local frame
+        if (std::memcmp(it->second, &ghosts[k], 11 * sizeof(double)) != 0)
+            mismatch++;
+        for (int j = 11; j < 14; j++) {
+            if (std::abs(it->second[j] - ghosts[k + j]) > 1e-12)
+                mismatch++;
+        }
+    }
+
+    int num_ghosts = (int)ghosts.size() / 14;
+    int totals[2] = {num_ghosts, mismatch};
+    MPI_Allreduce(MPI_IN_PLACE, totals, 2, MPI_INT, MPI_SUM, sys.GetCommunicator());
+    return totals[1] == 0 ? totals[0] : -1;
+}
+
+// Check the ghost states and the contacts at the end of the collision detection of each step.
+class CheckContacts : public ChSystem::CustomCollisionCallback {
+  public:
+    CheckContacts() : max_ghosts(0), passed(true) {}
+
+    virtual void OnCustomCollision(ChSystem* msys) override {
+        auto sys = static_cast<ChSystemDistributed*>(msys);
+        int num_ghosts = CheckGhosts(*sys);
+        if (num_ghosts < 0)
+            passed = false;
+        max_ghosts = std::max(max_ghosts, num_ghosts);
+
+        // The contacts between local bodies and those involving ghosts are found in separate passes
+        const auto& pairs = sys->data_manager->host_data.contact_pairs;
+        std::vector<long long> sorted(pairs.begin(), pairs.begin() + sys->data_manager->num_rigid_contacts);
+        std::sort(sorted.begin(), sorted.end());
+        if (std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end())
+            passed = false;
+    }
+
+    int max_ghosts;
+    bool passed;
+};
+
+int main(int argc, char* argv[]) {
+    MPI_Init(&argc, &argv);
+
+    double radius = 0.1;
+    ChSystemDistributed sys(MPI_COMM_WORLD, 2 * radius, 10000);
+    sys.Set_G_acc(ChVector<double>(0, 0, -9.8));
+    sys.GetSettings()->solver.contact_force_model = ChSystemSMC::ContactForceModel::Hertz;
+    sys.GetSettings()->collision.bins_per_axis = vec3(10, 10, 10);
+
+    int num_ranks = sys.GetCommSize();
+    if (num_ranks >= 4 && num_ranks % 2 == 0)
+        sys.GetDomain()->SetNumSubdomains(num_ranks / 2, 2, 1);
+    else
+        sys.GetDomain()->SetSplitAxis(0);
+    sys.GetDomain()->SetSimDomain(0, 4, 0, 2, -1, 5);
+
+    bool passed = TestDeltaEncoding();
+
+    auto material = chrono_types::make_shared<ChMaterialSurfaceSMC>();
+
+    // Fixed ground plate spanning the whole domain
+    auto ground = std::shared_ptr<ChBody>(sys.NewBody());
+    ground->SetBodyFixed(true);
+    ground->SetPos(ChVector<>(2, 1, -0.5));
+    ground->GetCollisionModel()->ClearModel();
+    ground->GetCollisionModel()->AddBox(material, 2, 1, 0.5);
+    ground->GetCollisionModel()->BuildModel();
+    ground->SetCollide(true);
+    sys.AddBody(ground);
+
+    // Spheres moving in both directions along x and y, across the sub-domain boundaries
+    for (int ix = 0; ix < 16; ix++) {
+        for (int iy = 0; iy < 8; iy++) {
+            auto ball = std::shared_ptr<ChBody>(sys.NewBody());
+            ball->SetMass(1);
+            ball->SetInertiaXX(0.4 * radius * radius * ChVector<>(1, 1, 1));
+            ball->SetPos(ChVector<>(0.25 * ix + 0.125, 0.25 * iy + 0.125, radius));
+            ball->SetPos_dt(ChVector<>((iy % 2) ? 3.0 : -3.0, (ix % 2) ? 1.0 : -1.0, 0));
+            ball->GetCollisionModel()->ClearModel();
+            ball->GetCollisionModel()->AddSphere(material, radius);
+            ball->GetCollisionModel()->BuildModel();
+            ball->SetCollide(true);
+            sys.AddBody(ball);
+        }
+    }
+
+    auto check = chrono_types::make_shared<CheckContacts>();
+    sys.RegisterCustomCollisionCallback(check);
+
+    for (int i = 0; i < 500; i++) {
+        sys.DoStepDynamics(1e-4);
+        if (!check->passed) {
+            if (sys.OnMaster())
+                std::cout << "Ghost state mismatch or duplicate contact at step " << i << std::endl;
+            passed = false;
+            break;
+        }
+    }
+    int max_ghosts = check->max_ghosts;
+    if (sys.GetCommSize() > 1 && max_ghosts == 0)
+        passed = false;
+
+    // Explicit exchange of the states at the end of the last step
+    auto comm = sys.GetComm();
+    comm->PostExchange();
+    if (!comm->IsExchangePending())
+        passed = false;
+    comm->CompleteExchange();
+    if (CheckGhosts(sys) < 0)
+        passed = false;
+
+    // Explicit exchange with unchanged body states: all ghost updates are skipped
+    comm->PostExchange();
+    int num_shared = 0;
+    for (uint i = 0; i < sys.data_manager->num_rigid_bodies; i++) {
+        distributed::COMM_STATUS status = sys.ddm->comm_status[i];
+        if (status == distributed::SHARED_UP || status == distributed::SHARED_DOWN)
+            num_shared++;
+    }
+    comm->CompleteExchange();
+    if (comm->IsExchangePending() || comm->GetNumSkippedUpdates() != num_shared || CheckGhosts(sys) < 0)
+        passed = false;
+
+    int all_passed = passed ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &all_passed, 1, MPI_INT, MPI_MIN, sys.GetCommunicator());
+
+    if (sys.OnMaster()) {
+        std::cout << "Maximum number of ghosts: " << max_ghosts << std::endl;
+        std::cout << "Timing of last exchange (pack/post/wait/unpack): " << comm->GetTimePack() << " "
+                  << comm->GetTimePost() << " " << comm->GetTimeWait() << " " << comm->GetTimeUnpack() << std::endl;
+        std::cout << (all_passed ? "PASSED" : "FAILED") << std::endl;
+    }
+
+    MPI_Finalize();
+    return all_passed ? 0 : 1;
+}
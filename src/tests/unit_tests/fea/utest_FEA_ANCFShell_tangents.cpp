@@ -0,0 +1,239 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Test for the internal forces and Jacobians of the ANCF shell element.
+// A single curved element with three layers (two orthotropic layers with
+// different fiber angles around an isotropic one) and structural damping is
+// deformed so that the EAS parameters are active. Its internal forces and the
+// products of its Jacobians with a fixed vector are compared against reference
+// values obtained with the previous (per integration point) implementation of
+// the element:
+// - internal forces, at nonzero nodal velocities
+// - stiffness matrix (Kfactor = 1)
+// - damping and mass matrices (Rfactor = Mfactor = 1)
+// The stiffness matrix is also compared against a central finite-difference
+// approximation of the derivatives of the internal forces, at zero nodal
+// velocities. The element Jacobian omits some of the terms proportional to the
+// stresses, so that it differs from the exact tangent by a relative amount of
+// the order of the strains; it is checked at the above state and at a state
+// with 100 times smaller displacements.
+//
+// =============================================================================
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+#include "chrono/fea/ChElementShellANCF.h"
+#include "chrono/fea/ChMesh.h"
+#include "chrono/physics/ChSystemSMC.h"
+
+using namespace chrono;
+using namespace chrono::fea;
+
+// System that exposes the initial setup of its FEA elements.
+class TestSystem : public ChSystemSMC {
+  public:
+    using ChSystem::SetupInitial;
+};
+
+// Reference configuration: cylindrical patch of the given radius, spanning the given arc along x, and the given width
+// along y
+static const double radius = 1.0;
+static const double arc = 0.4;
+static const double width = 0.3;
+
+// Reference position and direction vector of a node (counterclockwise numbering).
+static void ReferenceNode(int i, ChVector<>& pos, ChVector<>& dir) {
+    static const double sx[4] = {0, 1, 1, 0};
+    static const double sy[4] = {0, 0, 1, 1};
+    double theta = sx[i] * arc;
+    pos = ChVector<>(radius * std::sin(theta), sy[i] * width, radius * (1 - std::cos(theta)));
+    dir = ChVector<>(-std::sin(theta), 0, std::cos(theta));
+}
+
+// Deformed configuration (24 nodal coordinates: position and direction vector of each node).
+// The displacements from the reference configuration are multiplied by the given scale (strains of a few percent for a
+// scale of 1).
+static ChVectorDynamic<> DeformedState(double scale = 1) {
+    ChVectorDynamic<> q(24);
+    for (int i = 0; i < 4; i++) {
+        ChVector<> pos, dir;
+        ReferenceNode(i, pos, dir);
+        ChVector<> dx(0.03 * pos.x() + 0.04 * pos.y() + 0.002 * std::sin(7.0 * i),
+                      -0.02 * pos.y() + 0.05 * pos.z() + 0.001 * std::cos(5.0 * i),
+                      0.06 * pos.x() * pos.y() + 0.002 * std::sin(3.0 * i));
+        ChVector<> dd(0.03 * std::cos(2.0 * i), 0.02 * std::sin(4.0 * i), -0.03 * dir.z() + 0.01 * i);
+        q.segment(6 * i, 3) = (pos + scale * dx).eigen();
+        q.segment(6 * i + 3, 3) = (dir + scale * dd).eigen();
+    }
+    return q;
+}
+
+// Maximum difference between two matrices, relative to the largest entry of the first one.
+static double RelativeDifference(const ChMatrixDynamic<>& A, const ChMatrixDynamic<>& B) {
+    return (A - B).cwiseAbs().maxCoeff() / A.cwiseAbs().maxCoeff();
+}
+
+// -----------------------------------------------------------------------------
+
+// Single laminated ANCF shell element.
+class LaminatedShell {
+  public:
+    // Create the element in its reference configuration, then move its nodes to the given state, optionally with
+    // nonzero nodal velocities.
+    LaminatedShell(const ChVectorDynamic<>& q, bool moving);
+
+    // Internal forces (starting from zero EAS parameters).
+    ChVectorDynamic<> Forces();
+
+    // Jacobian at the state of the last evaluation of the internal forces.
+    ChMatrixDynamic<> Jacobian(double Kfactor, double Rfactor, double Mfactor);
+
+    TestSystem sys;
+    std::shared_ptr<ChElementShellANCF> element;
+};
+
+LaminatedShell::LaminatedShell(const ChVectorDynamic<>& q, bool moving) {
+    sys.Set_G_acc(ChVector<>(0, 0, 0));
+
+    auto mesh = chrono_types::make_shared<ChMesh>();
+    std::vector<std::shared_ptr<ChNodeFEAxyzD>> nodes;
+    for (int i = 0; i < 4; i++) {
+        ChVector<> pos, dir;
+        ReferenceNode(i, pos, dir);
+        auto node = chrono_types::make_shared<ChNodeFEAxyzD>(pos, dir);
+        mesh->AddNode(node);
+        nodes.push_back(node);
+    }
+
+    auto mat_ort = chrono_types::make_shared<ChMaterialShellANCF>(500, ChVector<>(2e8, 1e8, 1e8),
+                                                                  ChVector<>(0.3, 0.3, 0.3),
+                                                                  ChVector<>(3.8e7, 3.8e7, 3.8e7));
+    auto mat_iso = chrono_types::make_shared<ChMaterialShellANCF>(800, 5e7, 0.35);
+
+    element = chrono_types::make_shared<ChElementShellANCF>();
+    element->SetNodes(nodes[0], nodes[1], nodes[2], nodes[3]);
+    element->SetDimensions(radius * arc, width);
+    element->AddLayer(0.01, 20 * CH_C_DEG_TO_RAD, mat_ort);
+    element->AddLayer(0.005, 0, mat_iso);
+    element->AddLayer(0.01, -35 * CH_C_DEG_TO_RAD, mat_ort);
+    element->SetAlphaDamp(0.05);
+    element->SetGravityOn(false);
+    mesh->AddElement(element);
+    mesh->SetAutomaticGravity(false);
+
+    sys.Add(mesh);
+    sys.SetupInitial();
+
+    for (int i = 0; i < 4; i++) {
+        nodes[i]->SetPos(ChVector<>(q(6 * i + 0), q(6 * i + 1), q(6 * i + 2)));
+        nodes[i]->SetD(ChVector<>(q(6 * i + 3), q(6 * i + 4), q(6 * i + 5)));
+        if (moving) {
+            nodes[i]->SetPos_dt(ChVector<>(0.1 * std::sin(1.0 + i), 0.2 * std::cos(2.0 + i), -0.1 * i));
+            nodes[i]->SetD_dt(ChVector<>(0.05 * std::cos(3.0 * i), -0.04 * i, 0.03 * std::sin(2.0 * i)));
+        }
+    }
+}
+
+ChVectorDynamic<> LaminatedShell::Forces() {
+    ChVectorDynamic<> F(24);
+    std::static_pointer_cast<ChElementBase>(element)->ComputeInternalForces(F);
+    return F;
+}
+
+ChMatrixDynamic<> LaminatedShell::Jacobian(double Kfactor, double Rfactor, double Mfactor) {
+    ChMatrixDynamic<> K(24, 24);
+    std::static_pointer_cast<ChElementBase>(element)->ComputeKRMmatricesGlobal(K, Kfactor, Rfactor, Mfactor);
+    return K;
+}
+
+// -----------------------------------------------------------------------------
+
+TEST(ChElementShellANCF, reference_values) {
+    // Reference values, from the previous implementation of the element
+    double F_ref[24] = {
+        2.2262686400563929e+04,  6.7280505386877721e+03,  -2.2282405951909022e+03,  //
+        1.8367538374240240e+01,  9.6758861564975336e+02,  2.9392304742946487e+02,   //
+        -1.5011357866856517e+04, 1.5476317869300228e+03,  -6.8002342378623925e+03,  //
+        2.6824368591644614e+01,  5.9924741239100899e+02,  4.0234980993910767e+01,   //
+        -2.6132643361776903e+04, -5.8635363971742263e+03, -2.8880411981191569e+03,  //
+        -7.7141426470531712e+01, 5.8697671832107289e+02,  -2.9454962362369264e+02,  //
+        1.8881314828069491e+04,  -2.4121459284435678e+03, 1.1916516031172450e+04,   //
+        -2.4201077468103904e+02, 9.6895410265219766e+02,  -5.6631704671102932e+02   //
+    };
+    double Kv_ref[24] = {
+        1.7212338456350015e+06,  1.7370992336428268e+06,  7.9205898697938770e+04,   //
+        7.4841818397754789e+04,  -2.4833037515743326e+04, -1.8139693184965890e+04,  //
+        -6.2343526401567482e+05, 1.8903733885381413e+06,  5.6734268806242931e+05,   //
+        1.0172732267555283e+05,  -3.1138879178546522e+04, -3.8105224846858771e+04,  //
+        -2.3552669163214494e+06, -2.6318028472084664e+06, -3.7908523844291316e+05,  //
+        8.0692215430992670e+04,  -3.1542230590301686e+04, -1.8748448035177855e+04,  //
+        1.2574683347021230e+06,  -9.9566977497250191e+05, -2.6746334831745503e+05,  //
+        6.0457308758981308e+04,  -2.2961685591998132e+04, -5.7043578428873778e+04   //
+    };
+    double RMv_ref[24] = {
+        8.1670991302184761e+04,  9.1163774883489183e+04,  6.8079101177836164e+03,   //
+        3.3711031174058558e+03,  -1.2564947694426596e+03, -5.4893422556914320e+03,  //
+        -2.7091278829259991e+04, 1.1637181622911899e+05,  2.5416057125917760e+04,   //
+        7.2233183103974698e+03,  -1.5369934504427047e+03, -7.3113491924726659e+03,  //
+        -1.4112821029824892e+05, -1.5407008929734575e+05, -2.7234583264246281e+04,  //
+        6.2297659524099890e+03,  -1.7352712870959772e+03, -6.2646705267581992e+03,  //
+        8.6548710805996991e+04,  -5.3465560700455928e+04, -4.9896870358883425e+03,  //
+        2.5460216878302958e+03,  -1.1742374018953417e+03, -9.8853379103744464e+03   //
+    };
+
+    // Fixed vector multiplying the Jacobians
+    ChVectorDynamic<> v(24);
+    for (int j = 0; j < 24; j++)
+        v(j) = std::cos(1.0 + 0.7 * j);
+
+    LaminatedShell shell(DeformedState(), true);
+    ChVectorDynamic<> F = shell.Forces();
+    ChVectorDynamic<> Kv = shell.Jacobian(1, 0, 0) * v;
+    ChVectorDynamic<> RMv = shell.Jacobian(0, 1, 1) * v;
+
+    EXPECT_LT(RelativeDifference(Eigen::Map<ChVectorDynamic<>>(F_ref, 24), F), 1e-10);
+    EXPECT_LT(RelativeDifference(Eigen::Map<ChVectorDynamic<>>(Kv_ref, 24), Kv), 1e-10);
+    EXPECT_LT(RelativeDifference(Eigen::Map<ChVectorDynamic<>>(RMv_ref, 24), RMv), 1e-10);
+}
+
+// Central finite-difference approximation of the stiffness matrix at the given state (at zero nodal velocities).
+// Each evaluation of the internal forces starts from a new element, so that the EAS parameters are solved for from
+// zero.
+static ChMatrixDynamic<> StiffnessFD(const ChVectorDynamic<>& q) {
+    double h = 1e-7;
+    ChMatrixDynamic<> K_fd(24, 24);
+    for (int j = 0; j < 24; j++) {
+        ChVectorDynamic<> qp = q;
+        ChVectorDynamic<> qm = q;
+        qp(j) += h;
+        qm(j) -= h;
+        ChVectorDynamic<> Fp = LaminatedShell(qp, false).Forces();
+        ChVectorDynamic<> Fm = LaminatedShell(qm, false).Forces();
+        K_fd.col(j) = -(Fp - Fm) / (2 * h);
+    }
+    return K_fd;
+}
+
+TEST(ChElementShellANCF, stiffness_fd) {
+    // The difference with the exact tangent is proportional to the deformation
+    for (double scale : {1.0, 0.01}) {
+        ChVectorDynamic<> q = DeformedState(scale);
+        LaminatedShell shell(q, false);
+        shell.Forces();
+        ChMatrixDynamic<> K = shell.Jacobian(1, 0, 0);
+        EXPECT_LT(RelativeDifference(K, StiffnessFD(q)), 2.5e-2 * scale);
+    }
+}
@@ -0,0 +1,143 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Test for the element assembly modes of ChMesh.
+// A deformed block of hexahedral elements, with automatic gravity loads, is
+// evaluated with a single thread (reference) and with several threads in each
+// assembly mode. The residual (internal forces and gravity loads) and the
+// stiffness matrix must match the serial ones.
+//
+// =============================================================================
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+#include "chrono/fea/ChElementHexa_8.h"
+#include "chrono/fea/ChMesh.h"
+#include "chrono/parallel/ChOpenMP.h"
+#include "chrono/physics/ChSystemSMC.h"
+
+using namespace chrono;
+using namespace chrono::fea;
+
+// System that exposes the initial setup and the descriptor construction.
+class TestSystem : public ChSystemSMC {
+  public:
+    using ChSystem::DescriptorPrepareInject;
+    using ChSystem::SetupInitial;
+};
+
+// Evaluate the residual and the stiffness matrix of a deformed block with the given assembly mode and number of
+// threads. The block has n x n x n hexahedral elements.
+static void Evaluate(ChMesh::AssemblyMode mode,
+                     int num_threads,
+                     ChVectorDynamic<>& R,
+                     ChSparseMatrix& K,
+                     unsigned int& num_colors) {
+    const int n = 4;
+    const double h = 0.1;
+
+    TestSystem sys;
+    sys.Set_G_acc(ChVector<>(0, -9.81, 0));
+
+    auto material = chrono_types::make_shared<ChContinuumElastic>();
+    material->Set_E(1e7);
+    material->Set_v(0.3);
+    material->Set_density(1000);
+
+    auto mesh = chrono_types::make_shared<ChMesh>();
+    mesh->SetAutomaticGravity(true, 2);
+    mesh->SetAssemblyMode(mode);
+
+    std::vector<std::shared_ptr<ChNodeFEAxyz>> nodes;
+    for (int i = 0; i <= n; i++) {
+        for (int j = 0; j <= n; j++) {
+            for (int k = 0; k <= n; k++) {
+                auto node = chrono_types::make_shared<ChNodeFEAxyz>(ChVector<>(i * h, j * h, k * h));
+                node->SetFixed(j == 0);
+                mesh->AddNode(node);
+                nodes.push_back(node);
+            }
+        }
+    }
+    auto node = [&](int i, int j, int k) { return nodes[(i * (n + 1) + j) * (n + 1) + k]; };
+
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            for (int k = 0; k < n; k++) {
+                auto element = chrono_types::make_shared<ChElementHexa_8>();
+                element->SetNodes(node(i, j, k), node(i, j, k + 1), node(i + 1, j, k + 1), node(i + 1, j, k),
+                                  node(i, j + 1, k), node(i, j + 1, k + 1), node(i + 1, j + 1, k + 1),
+                                  node(i + 1, j + 1, k));
+                element->SetMaterial(material);
+                mesh->AddElement(element);
+            }
+        }
+    }
+    sys.Add(mesh);
+
+    sys.SetupInitial();
+
+    // Deform the block
+    for (size_t i = 0; i < nodes.size(); i++) {
+        ChVector<> disp(std::sin(1.0 * i), std::cos(2.0 * i), std::sin(3.0 * i));
+        if (!nodes[i]->GetFixed())
+            nodes[i]->SetPos(nodes[i]->GetX0() + 1e-3 * disp);
+    }
+
+    int max_threads = CHOMPfunctions::GetMaxThreads();
+    CHOMPfunctions::SetNumThreads(num_threads);
+
+    sys.Setup();
+    sys.Update();
+
+    R.setZero(sys.GetNcoords_w());
+    sys.LoadResidual_F(R, 1.0);
+
+    sys.DescriptorPrepareInject(*sys.GetSystemDescriptor());
+    sys.GetStiffnessMatrix(&K);
+
+    num_colors = mesh->GetNumColors();
+
+    CHOMPfunctions::SetNumThreads(max_threads);
+}
+
+TEST(ChMesh, assembly_modes) {
+    ChVectorDynamic<> R_ref;
+    ChSparseMatrix K_ref;
+    unsigned int num_colors;
+    Evaluate(ChMesh::AssemblyMode::ATOMIC, 1, R_ref, K_ref, num_colors);
+    ASSERT_GT(R_ref.norm(), 0);
+    ASSERT_GT(K_ref.norm(), 0);
+
+    ChMesh::AssemblyMode modes[] = {ChMesh::AssemblyMode::ATOMIC, ChMesh::AssemblyMode::COLORING,
+                                    ChMesh::AssemblyMode::REDUCTION};
+    for (auto mode : modes) {
+        ChVectorDynamic<> R;
+        ChSparseMatrix K;
+        Evaluate(mode, 4, R, K, num_colors);
+        if (mode == ChMesh::AssemblyMode::COLORING) {
+            EXPECT_GT(num_colors, 1);
+        }
+
+        ASSERT_EQ(R.size(), R_ref.size());
+        EXPECT_LT((R - R_ref).norm(), 1e-12 * R_ref.norm()) << "mode " << (int)mode;
+
+        ASSERT_EQ(K.rows(), K_ref.rows());
+        ASSERT_EQ(K.cols(), K_ref.cols());
+        ChSparseMatrix diff = K - K_ref;
+        EXPECT_LT(diff.norm(), 1e-12 * K_ref.norm()) << "mode " << (int)mode;
+    }
+}
@@ -0,0 +1,336 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Test for the analytical Jacobians of the brick elements with nonlinear
+// materials. The stiffness matrix of a single deformed element is compared
+// against a central finite-difference approximation of the derivatives of its
+// internal forces:
+// - ChElementBrick with Mooney-Rivlin material (hyperelastic state)
+// - ChElementBrick_9 with Hencky strain and Drucker-Prager-Cap plasticity, at
+//   a state below the yield surfaces and at a state yielding on the cap.
+// The Brick_9 Jacobian linearizes the Hencky strains and the Kirchhoff stress
+// about the current configuration, so that it differs from the exact tangent
+// by terms of the order of the strains; the tolerances reflect this. At the
+// yielding state, the Jacobian must use the consistent elastoplastic tangent,
+// and therefore be much closer to the finite-difference one than the elastic
+// stiffness is.
+// Elastoplastic internal forces depend on the plastic state at the integration
+// points, which they also update. Therefore, all Brick_9 evaluations start
+// from a new element, with no previous plastic deformation.
+//
+// =============================================================================
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+#include "chrono/fea/ChElementBrick.h"
+#include "chrono/fea/ChElementBrick_9.h"
+#include "chrono/fea/ChMesh.h"
+#include "chrono/physics/ChSystemSMC.h"
+
+using namespace chrono;
+using namespace chrono::fea;
+
+// System that exposes the initial setup of its FEA elements.
+class TestSystem : public ChSystemSMC {
+  public:
+    using ChSystem::SetupInitial;
+};
+
+// Element dimensions
+static const ChVector<> dims(0.1, 0.08, 0.06);
+
+// Reference positions of the corner nodes (with the node ordering of both brick elements).
+static ChVector<> CornerPosition(int i) {
+    static const double sx[8] = {0, 1, 1, 0, 0, 1, 1, 0};
+    static const double sy[8] = {0, 0, 1, 1, 0, 0, 1, 1};
+    static const double sz[8] = {0, 0, 0, 0, 1, 1, 1, 1};
+    return ChVector<>(sx[i] * dims.x(), sy[i] * dims.y(), sz[i] * dims.z());
+}
+
+// Maximum difference between two matrices, relative to the largest entry of the first one.
+static double RelativeDifference(const ChMatrixDynamic<>& K, const ChMatrixDynamic<>& K_fd) {
+    return (K - K_fd).cwiseAbs().maxCoeff() / K.cwiseAbs().maxCoeff();
+}
+
+// -----------------------------------------------------------------------------
+
+// Single ChElementBrick with Mooney-Rivlin material.
+class MooneyRivlinBrick {
+  public:
+    MooneyRivlinBrick();
+
+    // Set the nodal positions (24 coordinates).
+    void SetState(const ChVectorDynamic<>& q);
+
+    // Internal forces, evaluated with the EAS parameters starting from zero.
+    ChVectorDynamic<> Forces();
+
+    TestSystem sys;
+    std::shared_ptr<ChElementBrick> element;
+    std::vector<std::shared_ptr<ChNodeFEAxyz>> nodes;
+};
+
+MooneyRivlinBrick::MooneyRivlinBrick() {
+    sys.Set_G_acc(ChVector<>(0, 0, 0));
+
+    auto mesh = chrono_types::make_shared<ChMesh>();
+    for (int i = 0; i < 8; i++) {
+        auto node = chrono_types::make_shared<ChNodeFEAxyz>(CornerPosition(i));
+        mesh->AddNode(node);
+        nodes.push_back(node);
+    }
+
+    auto material = chrono_types::make_shared<ChContinuumElastic>();
+    material->Set_density(1000);
+    material->Set_E(5e6);
+    material->Set_v(0.3);
+
+    element = chrono_types::make_shared<ChElementBrick>();
+    element->SetInertFlexVec(dims);
+    element->SetNodes(nodes[0], nodes[1], nodes[2], nodes[3], nodes[4], nodes[5], nodes[6], nodes[7]);
+    element->SetMaterial(material);
+    element->SetElemNum(0);
+    element->SetGravityOn(false);
+    element->SetMooneyRivlin(true);
+    element->SetMRCoefficients(551584.0, 137896.0);
+    element->SetStockAlpha(0, 0, 0, 0, 0, 0, 0, 0, 0);
+    mesh->AddElement(element);
+
+    sys.Add(mesh);
+    sys.SetupInitial();
+}
+
+void MooneyRivlinBrick::SetState(const ChVectorDynamic<>& q) {
+    for (int i = 0; i < 8; i++)
+        nodes[i]->SetPos(ChVector<>(q(3 * i + 0), q(3 * i + 1), q(3 * i + 2)));
+}
+
+ChVectorDynamic<> MooneyRivlinBrick::Forces() {
+    ChVectorDynamic<> F(24);
+    element->SetStockAlpha(0, 0, 0, 0, 0, 0, 0, 0, 0);
+    std::static_pointer_cast<ChElementBase>(element)->ComputeInternalForces(F);
+    return F;
+}
+
+TEST(ChElementBrick, mooney_rivlin_tangent) {
+    // Deformed configuration (large stretches and shears)
+    ChVectorDynamic<> q(24);
+    for (int i = 0; i < 8; i++) {
+        ChVector<> X = CornerPosition(i);
+        ChVector<> x(1.10 * X.x() + 0.15 * X.y() + 0.02 * std::sin(7.0 * i),  //
+                     0.92 * X.y() - 0.10 * X.z() + 0.01 * std::cos(5.0 * i),  //
+                     0.05 * X.x() + 1.05 * X.z() + 0.01 * std::sin(3.0 * i));
+        q.segment(3 * i, 3) = x.eigen();
+    }
+
+    // Analytical Jacobian (assembled during the evaluation of the internal forces)
+    MooneyRivlinBrick brick;
+    brick.SetState(q);
+    brick.Forces();
+    ChMatrixDynamic<> K(24, 24);
+    std::static_pointer_cast<ChElementBase>(brick.element)->ComputeKRMmatricesGlobal(K, 1.0);
+
+    // Central finite differences of the internal forces
+    double h = 1e-7;
+    ChMatrixDynamic<> K_fd(24, 24);
+    for (int j = 0; j < 24; j++) {
+        ChVectorDynamic<> qp = q;
+        ChVectorDynamic<> qm = q;
+        qp(j) += h;
+        qm(j) -= h;
+        brick.SetState(qp);
+        ChVectorDynamic<> Fp = brick.Forces();
+        brick.SetState(qm);
+        ChVectorDynamic<> Fm = brick.Forces();
+        K_fd.col(j) = -(Fp - Fm) / (2 * h);
+    }
+
+    EXPECT_LT(RelativeDifference(K, K_fd), 1e-5);
+}
+
+// -----------------------------------------------------------------------------
+
+// Single ChElementBrick_9 with Hencky strain and Drucker-Prager-Cap plasticity, with no plastic deformation.
+class CapBrick9 {
+  public:
+    // Create the element in its reference configuration, then move its nodes to the given state
+    // (24 corner coordinates, followed by the 9 curvature coordinates of the central node).
+    CapBrick9(const ChVectorDynamic<>& q);
+
+    // Internal forces (this updates the plastic state).
+    ChVectorDynamic<> Forces();
+
+    // Analytical Jacobian, evaluated with no previous plastic deformation (elastoplastic tangent, or elastic
+    // stiffness if plasticity is disabled).
+    ChMatrixDynamic<> Jacobian(bool plasticity = true);
+
+    TestSystem sys;
+    std::shared_ptr<ChElementBrick_9> element;
+};
+
+CapBrick9::CapBrick9(const ChVectorDynamic<>& q) {
+    sys.Set_G_acc(ChVector<>(0, 0, 0));
+
+    auto mesh = chrono_types::make_shared<ChMesh>();
+    std::vector<std::shared_ptr<ChNodeFEAxyz>> nodes;
+    for (int i = 0; i < 8; i++) {
+        auto node = chrono_types::make_shared<ChNodeFEAxyz>(CornerPosition(i));
+        mesh->AddNode(node);
+        nodes.push_back(node);
+    }
+    auto central = chrono_types::make_shared<ChNodeFEAcurv>(VNULL, VNULL, VNULL);
+    mesh->AddNode(central);
+
+    auto material = chrono_types::make_shared<ChContinuumElastic>();
+    material->Set_density(2149);
+    material->Set_E(54.1e6);
+    material->Set_v(0.293021);
+
+    // Linear hardening law (first segment of data/fea/CapHardeningInformation_TriaxialAxial.INP),
+    // modified as in demo_FEA_Brick9 for consistency with ABAQUS.
+    double tan_phi = std::tan(51.7848 * CH_C_DEG_TO_RAD);
+    ChVectorDynamic<double> DPVector1(2);
+    ChVectorDynamic<double> DPVector2(2);
+    DPVector1 << 0, 0.1;
+    DPVector2 << 358000, 1828708.087;
+    for (int i = 0; i < 2; i++)
+        DPVector2(i) = (DPVector2(i) + 210926.0 / tan_phi) / (0.5 * tan_phi + 1.0);
+
+    ChMatrixNM<double, 9, 8> CCPInitial;
+    CCPInitial.setZero();
+    for (int k = 0; k < 8; k++) {
+        CCPInitial(0, k) = 1;
+        CCPInitial(4, k) = 1;
+        CCPInitial(8, k) = 1;
+    }
+
+    element = chrono_types::make_shared<ChElementBrick_9>();
+    element->SetNodes(nodes[0], nodes[1], nodes[2], nodes[3], nodes[4], nodes[5], nodes[6], nodes[7], central);
+    element->SetDimensions(dims);
+    element->SetMaterial(material);
+    element->SetAlphaDamp(0.0);
+    element->SetGravityOn(false);
+    element->SetDPIterationNo(50);
+    element->SetDPYieldTol(1e-10);
+    element->SetStrainFormulation(ChElementBrick_9::Hencky);
+    element->SetPlasticityFormulation(ChElementBrick_9::DruckerPrager_Cap);
+    element->SetPlasticity(true);
+    element->SetYieldStress(210926.0);
+    element->SetHardeningSlope(0.0);
+    element->SetCCPInitial(CCPInitial);
+    element->SetFriction(51.7848);
+    element->SetDilatancy(51.7848);
+    element->SetDPType(3);
+    element->SetDPVector1(DPVector1);
+    element->SetDPVector2(DPVector2);
+    element->SetDPVectorSize(2);
+    element->SetDPCapBeta(0.5 * tan_phi);
+    mesh->AddElement(element);
+
+    sys.Add(mesh);
+    sys.SetupInitial();
+
+    for (int i = 0; i < 8; i++)
+        nodes[i]->SetPos(ChVector<>(q(3 * i + 0), q(3 * i + 1), q(3 * i + 2)));
+    central->SetCurvatureXX(ChVector<>(q(24), q(25), q(26)));
+    central->SetCurvatureYY(ChVector<>(q(27), q(28), q(29)));
+    central->SetCurvatureZZ(ChVector<>(q(30), q(31), q(32)));
+}
+
+// Note that the Brick_9 element implements the ChElementBase interface privately.
+ChVectorDynamic<> CapBrick9::Forces() {
+    ChVectorDynamic<> F(33);
+    std::static_pointer_cast<ChElementBase>(element)->ComputeInternalForces(F);
+    return F;
+}
+
+ChMatrixDynamic<> CapBrick9::Jacobian(bool plasticity) {
+    // The Jacobian uses the nodal coordinates cached by the force evaluation.
+    // Evaluate the forces without plasticity, so that the plastic state is not modified.
+    element->SetPlasticity(false);
+    Forces();
+    element->SetPlasticity(plasticity);
+
+    ChMatrixDynamic<> K(33, 33);
+    std::static_pointer_cast<ChElementBase>(element)->ComputeKRMmatricesGlobal(K, 1.0);
+    return K;
+}
+
+// Deformed configuration of the Brick_9 element, obtained by applying the given (constant) deformation gradient.
+static ChVectorDynamic<> Brick9State(const ChMatrix33<>& F) {
+    ChVectorDynamic<> q(33);
+    for (int i = 0; i < 8; i++)
+        q.segment(3 * i, 3) = (F * CornerPosition(i)).eigen();
+    q.segment(24, 9).setZero();
+    // Small curvatures, so that the strain varies over the element
+    q(24) = 0.01;
+    q(28) = -0.02;
+    q(32) = 0.015;
+    return q;
+}
+
+// Central finite-difference approximation of the Jacobian of the Brick_9 internal forces at the given state.
+static ChMatrixDynamic<> Brick9JacobianFD(const ChVectorDynamic<>& q) {
+    double h = 1e-8;
+    ChMatrixDynamic<> K_fd(33, 33);
+    for (int j = 0; j < 33; j++) {
+        ChVectorDynamic<> qp = q;
+        ChVectorDynamic<> qm = q;
+        qp(j) += h;
+        qm(j) -= h;
+        ChVectorDynamic<> Fp = CapBrick9(qp).Forces();
+        ChVectorDynamic<> Fm = CapBrick9(qm).Forces();
+        K_fd.col(j) = -(Fp - Fm) / (2 * h);
+    }
+    return K_fd;
+}
+
+TEST(ChElementBrick_9, cap_tangent_elastic) {
+    // Small deformation, below the Drucker-Prager and cap yield surfaces (strains of order 1e-3, mostly from the
+    // curvatures)
+    ChMatrix33<> F;
+    F << 1 - 2e-4, 1e-4, 0,  //
+        0, 1 + 1e-4, -5e-5,  //
+        2e-5, 0, 1 - 1e-4;
+    ChVectorDynamic<> q = Brick9State(F);
+
+    ChMatrixDynamic<> K = CapBrick9(q).Jacobian();
+    EXPECT_LT(RelativeDifference(K, Brick9JacobianFD(q)), 2e-3);
+}
+
+TEST(ChElementBrick_9, cap_tangent_yielding) {
+    // Volumetric compression with shear (strains of order 5e-3), beyond the cap yield surface
+    ChMatrix33<> F;
+    F << 1 - 6e-3, 5e-4, 0,  //
+        0, 1 - 5e-3, -2e-4,  //
+        1e-4, 0, 1 - 4e-3;
+    ChVectorDynamic<> q = Brick9State(F);
+
+    // The state must be yielding (the return mapping changes the internal forces)
+    CapBrick9 elastic(q);
+    elastic.element->SetPlasticity(false);
+    ChVectorDynamic<> F_elastic = elastic.Forces();
+    ChMatrixDynamic<> K_elastic = elastic.Jacobian(false);
+    ChVectorDynamic<> F_plastic = CapBrick9(q).Forces();
+    ASSERT_GT((F_elastic - F_plastic).norm(), 1e-3 * F_elastic.norm());
+
+    ChMatrixDynamic<> K_fd = Brick9JacobianFD(q);
+    ChMatrixDynamic<> K = CapBrick9(q).Jacobian();
+
+    double diff = RelativeDifference(K, K_fd);
+    EXPECT_LT(diff, 3e-2);
+    EXPECT_LT(diff, 0.1 * RelativeDifference(K_elastic, K_fd));
+}
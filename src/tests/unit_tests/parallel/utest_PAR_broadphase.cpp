@@ -0,0 +1,102 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Unit test for the incremental broadphase.
+// The same granular settling problem is simulated with the default broadphase
+// and with the incremental broadphase. The test checks that the two systems
+// produce the same sets of contacts at each step and that cached broadphase
+// pairs are reused.
+//
+// =============================================================================
+
+#include <algorithm>
+
+#include "chrono/utils/ChUtilsCreators.h"
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "unit_testing.h"
+
+using namespace chrono;
+
+// Create a box container and a set of spheres, initially stacked in columns.
+static void CreateModel(ChSystemParallelSMC& system, bool incremental) {
+    CHOMPfunctions::SetNumThreads(1);
+    system.GetSettings()->max_threads = 1;
+    system.Set_G_acc(ChVector<>(0, 0, -9.81));
+    system.GetSettings()->solver.contact_force_model = ChSystemSMC::Hooke;
+    system.GetSettings()->solver.tangential_displ_mode = ChSystemSMC::OneStep;
+    system.GetSettings()->collision.bins_per_axis = vec3(10, 10, 10);
+    system.GetSettings()->collision.incremental_broadphase = incremental;
+    system.GetSettings()->collision.broadphase_skin = 0.02;
+
+    auto mat = chrono_types::make_shared<ChMaterialSurfaceSMC>();
+    mat->SetYoungModulus(1e6f);
+    mat->SetFriction(0.4f);
+    mat->SetRestitution(0.1f);
+
+    utils::CreateBoxContainer(&system, -1, mat, ChVector<>(1, 1, 1), 0.1, ChVector<>(0, 0, 0), QUNIT, true, false,
+                              true, false);
+
+    double radius = 0.1;
+    int id = 0;
+    for (int ix = -3; ix <= 3; ix++) {
+        for (int iy = -3; iy <= 3; iy++) {
+            for (int iz = 0; iz < 4; iz++) {
+                auto ball = std::shared_ptr<ChBody>(system.NewBody());
+                ball->SetIdentifier(id++);
+                ball->SetMass(1);
+                ball->SetInertiaXX(0.4 * radius * radius * ChVector<>(1, 1, 1));
+                ball->SetPos(ChVector<>(2 * radius * ix + 0.01 * iz, 2 * radius * iy, radius + 2 * radius * iz));
+                ball->SetCollide(true);
+                ball->GetCollisionModel()->ClearModel();
+                utils::AddSphereGeometry(ball.get(), mat, radius);
+                ball->GetCollisionModel()->BuildModel();
+                system.AddBody(ball);
+            }
+        }
+    }
+}
+
+// Return the sorted list of contact shape pairs.
+static std::vector<long long> GetPairs(ChSystemParallelSMC& system) {
+    const auto& pairs = system.data_manager->host_data.contact_pairs;
+    std::vector<long long> sorted(pairs.begin(), pairs.begin() + system.data_manager->num_rigid_contacts);
+    std::sort(sorted.begin(), sorted.end());
+    return sorted;
+}
+
+TEST(ChronoParallel, incremental_broadphase) {
+    ChSystemParallelSMC system_full;
+    ChSystemParallelSMC system_incr;
+    CreateModel(system_full, false);
+    CreateModel(system_incr, true);
+
+    double step = 1e-4;
+    unsigned int num_reused = 0;
+    for (int i = 0; i < 500; i++) {
+        system_full.DoStepDynamics(step);
+        system_incr.DoStepDynamics(step);
+
+        ASSERT_EQ(system_incr.data_manager->num_rigid_contacts, system_full.data_manager->num_rigid_contacts);
+        ASSERT_EQ(GetPairs(system_incr), GetPairs(system_full));
+
+        const auto& measures = system_incr.data_manager->measures.collision;
+        ASSERT_EQ(measures.number_of_pairs_reused + measures.number_of_pairs_new,
+                  measures.number_of_contacts_possible);
+        num_reused += measures.number_of_pairs_reused;
+    }
+
+    ASSERT_GT(num_reused, 0u);
+}
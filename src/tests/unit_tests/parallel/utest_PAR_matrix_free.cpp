@@ -0,0 +1,119 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Unit test for the matrix-free contact Jacobian in the NSC solver.
+// A granular settling problem (with one sphere attached to the container
+// through a spherical joint) is simulated with assembled constraint matrices
+// and with matrix-free contact products. The test checks that the contact rows
+// are not assembled and that the body states and contact forces of the two
+// systems remain close.
+//
+// =============================================================================
+
+#include "chrono/physics/ChLinkLock.h"
+#include "chrono/utils/ChUtilsCreators.h"
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "unit_testing.h"
+
+using namespace chrono;
+
+// Create a box container and a set of spheres, initially stacked in columns.
+static void CreateModel(ChSystemParallelNSC& system, SolverMode mode, bool matrix_free) {
+    CHOMPfunctions::SetNumThreads(1);
+    system.GetSettings()->max_threads = 1;
+    system.Set_G_acc(ChVector<>(0, 0, -9.81));
+    system.GetSettings()->solver.solver_mode = mode;
+    system.GetSettings()->solver.max_iteration_normal = 0;
+    system.GetSettings()->solver.max_iteration_sliding = (mode == SolverMode::SLIDING) ? 100 : 0;
+    system.GetSettings()->solver.max_iteration_spinning = (mode == SolverMode::SPINNING) ? 100 : 0;
+    system.GetSettings()->solver.max_iteration_bilateral = 0;
+    system.GetSettings()->solver.tolerance = 1e-6;
+    system.GetSettings()->solver.use_matrix_free = matrix_free;
+    system.GetSettings()->collision.bins_per_axis = vec3(10, 10, 10);
+    system.ChangeSolverType(SolverType::APGD);
+
+    auto mat = chrono_types::make_shared<ChMaterialSurfaceNSC>();
+    mat->SetFriction(0.4f);
+    mat->SetRollingFriction(0.01f);
+    mat->SetSpinningFriction(0.01f);
+
+    auto container = utils::CreateBoxContainer(&system, -1, mat, ChVector<>(1, 1, 1), 0.1, ChVector<>(0, 0, 0), QUNIT,
+                                               true, false, true, false);
+
+    double radius = 0.1;
+    int id = 0;
+    for (int ix = -2; ix <= 2; ix++) {
+        for (int iy = -2; iy <= 2; iy++) {
+            for (int iz = 0; iz < 3; iz++) {
+                auto ball = std::shared_ptr<ChBody>(system.NewBody());
+                ball->SetIdentifier(id++);
+                ball->SetMass(1);
+                ball->SetInertiaXX(0.4 * radius * radius * ChVector<>(1, 1, 1));
+                ball->SetPos(ChVector<>(2 * radius * ix + 0.01 * iz, 2 * radius * iy, radius + 2 * radius * iz));
+                ball->SetCollide(true);
+                ball->GetCollisionModel()->ClearModel();
+                utils::AddSphereGeometry(ball.get(), mat, radius);
+                ball->GetCollisionModel()->BuildModel();
+                system.AddBody(ball);
+
+                // Attach the sphere at the center of the top layer to the container
+                if (ix == 0 && iy == 0 && iz == 2) {
+                    auto joint = chrono_types::make_shared<ChLinkLockSpherical>();
+                    joint->Initialize(ball, container, ChCoordsys<>(ball->GetPos()));
+                    system.AddLink(joint);
+                }
+            }
+        }
+    }
+}
+
+static void Compare(SolverMode mode) {
+    ChSystemParallelNSC system_asm;
+    ChSystemParallelNSC system_mf;
+    CreateModel(system_asm, mode, false);
+    CreateModel(system_mf, mode, true);
+
+    double step = 1e-3;
+    for (int i = 0; i < 50; i++) {
+        system_asm.DoStepDynamics(step);
+        system_mf.DoStepDynamics(step);
+
+        ASSERT_EQ(system_mf.data_manager->num_rigid_contacts, system_asm.data_manager->num_rigid_contacts);
+        ASSERT_TRUE(system_mf.data_manager->rigid_rigid->matrix_free);
+        ASSERT_FALSE(system_asm.data_manager->rigid_rigid->matrix_free);
+        ASSERT_EQ(system_mf.data_manager->host_data.D_T.nonZeros(), system_mf.data_manager->nnz_bilaterals);
+    }
+
+    system_asm.CalculateContactForces();
+    system_mf.CalculateContactForces();
+
+    const auto& bodies_asm = system_asm.Get_bodylist();
+    const auto& bodies_mf = system_mf.Get_bodylist();
+    for (size_t i = 0; i < bodies_asm.size(); i++) {
+        ASSERT_LT((bodies_asm[i]->GetPos() - bodies_mf[i]->GetPos()).Length(), 1e-4);
+        ASSERT_LT((bodies_asm[i]->GetPos_dt() - bodies_mf[i]->GetPos_dt()).Length(), 1e-3);
+        ASSERT_LT(Length(system_asm.GetBodyContactForce((uint)i) - system_mf.GetBodyContactForce((uint)i)), 1e-1);
+        ASSERT_LT(Length(system_asm.GetBodyContactTorque((uint)i) - system_mf.GetBodyContactTorque((uint)i)), 1e-2);
+    }
+}
+
+TEST(ChronoParallel, matrix_free_sliding) {
+    Compare(SolverMode::SLIDING);
+}
+
+TEST(ChronoParallel, matrix_free_spinning) {
+    Compare(SolverMode::SPINNING);
+}
@@ -0,0 +1,102 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Unit test for the mixed-precision NSC solver mode.
+// A granular settling problem is simulated with full-precision and with
+// mixed-precision Schur products. The test checks that refinement iterations
+// are performed and that the body states of the two systems remain close.
+//
+// =============================================================================
+
+#include "chrono/utils/ChUtilsCreators.h"
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "unit_testing.h"
+
+using namespace chrono;
+
+// Create a box container and a set of spheres, initially stacked in columns.
+static void CreateModel(ChSystemParallelNSC& system, SolverType solver_type, bool mixed) {
+    CHOMPfunctions::SetNumThreads(1);
+    system.GetSettings()->max_threads = 1;
+    system.Set_G_acc(ChVector<>(0, 0, -9.81));
+    system.GetSettings()->solver.solver_mode = SolverMode::SLIDING;
+    system.GetSettings()->solver.max_iteration_normal = 0;
+    system.GetSettings()->solver.max_iteration_sliding = 100;
+    system.GetSettings()->solver.max_iteration_spinning = 0;
+    system.GetSettings()->solver.max_iteration_bilateral = 0;
+    system.GetSettings()->solver.tolerance = 1e-5;
+    system.GetSettings()->solver.use_mixed_precision = mixed;
+    system.GetSettings()->solver.max_iteration_refinement = 50;
+    system.GetSettings()->collision.bins_per_axis = vec3(10, 10, 10);
+    system.ChangeSolverType(solver_type);
+
+    auto mat = chrono_types::make_shared<ChMaterialSurfaceNSC>();
+    mat->SetFriction(0.4f);
+
+    utils::CreateBoxContainer(&system, -1, mat, ChVector<>(1, 1, 1), 0.1, ChVector<>(0, 0, 0), QUNIT, true, false,
+                              true, false);
+
+    double radius = 0.1;
+    int id = 0;
+    for (int ix = -2; ix <= 2; ix++) {
+        for (int iy = -2; iy <= 2; iy++) {
+            for (int iz = 0; iz < 3; iz++) {
+                auto ball = std::shared_ptr<ChBody>(system.NewBody());
+                ball->SetIdentifier(id++);
+                ball->SetMass(1);
+                ball->SetInertiaXX(0.4 * radius * radius * ChVector<>(1, 1, 1));
+                ball->SetPos(ChVector<>(2 * radius * ix, 2 * radius * iy, radius + 2 * radius * iz));
+                ball->SetCollide(true);
+                ball->GetCollisionModel()->ClearModel();
+                utils::AddSphereGeometry(ball.get(), mat, radius);
+                ball->GetCollisionModel()->BuildModel();
+                system.AddBody(ball);
+            }
+        }
+    }
+}
+
+static void Compare(SolverType solver_type) {
+    ChSystemParallelNSC system_full;
+    ChSystemParallelNSC system_mixed;
+    CreateModel(system_full, solver_type, false);
+    CreateModel(system_mixed, solver_type, true);
+
+    double step = 1e-3;
+    int num_refinement = 0;
+    for (int i = 0; i < 100; i++) {
+        system_full.DoStepDynamics(step);
+        system_mixed.DoStepDynamics(step);
+        num_refinement += system_mixed.data_manager->measures.solver.refinement_iteration;
+        ASSERT_EQ(system_full.data_manager->measures.solver.refinement_iteration, 0);
+    }
+    ASSERT_GT(num_refinement, 0);
+
+    const auto& bodies_full = system_full.Get_bodylist();
+    const auto& bodies_mixed = system_mixed.Get_bodylist();
+    for (size_t i = 0; i < bodies_full.size(); i++) {
+        ASSERT_LT((bodies_full[i]->GetPos() - bodies_mixed[i]->GetPos()).Length(), 5e-3);
+        ASSERT_LT((bodies_full[i]->GetPos_dt() - bodies_mixed[i]->GetPos_dt()).Length(), 5e-2);
+    }
+}
+
+TEST(ChronoParallel, mixed_precision_APGD) {
+    Compare(SolverType::APGD);
+}
+
+TEST(ChronoParallel, mixed_precision_BB) {
+    Compare(SolverType::BB);
+}
@@ -0,0 +1,114 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Author: Radu Serban
+// =============================================================================
+//
+// Unit test for the accumulation of SMC contact forces on bodies.
+// The same granular scene (spheres dropped in a container) is simulated with
+// the SORT and the PARTITION contact force reductions. The per-body contact
+// forces and torques must agree at every step. A body is added during the
+// simulation, so that the reduction buffers must follow the number of bodies.
+//
+// =============================================================================
+
+#include "chrono/ChConfig.h"
+#include "chrono/utils/ChUtilsCreators.h"
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "unit_testing.h"
+
+using namespace chrono;
+
+// Granular scene with the given contact force reduction method.
+class SMCScene {
+  public:
+    SMCScene(ContactForceReduction reduction);
+
+    void AddBall(const ChVector<>& pos);
+
+    ChSystemParallelSMC system;
+    std::shared_ptr<ChMaterialSurfaceSMC> material;
+    std::vector<std::shared_ptr<ChBody>> bodies;
+};
+
+SMCScene::SMCScene(ContactForceReduction reduction) {
+    system.Set_G_acc(ChVector<>(0, 0, -9.81));
+    system.GetSettings()->perform_thread_tuning = false;
+    system.GetSettings()->solver.contact_force_model = ChSystemSMC::Hertz;
+    system.GetSettings()->solver.tangential_displ_mode = ChSystemSMC::OneStep;
+    system.GetSettings()->solver.contact_force_reduction = reduction;
+    system.GetSettings()->collision.bins_per_axis = vec3(10, 10, 10);
+
+    material = chrono_types::make_shared<ChMaterialSurfaceSMC>();
+    material->SetYoungModulus(1e7f);
+    material->SetFriction(0.4f);
+    material->SetRestitution(0.1f);
+
+    auto container = utils::CreateBoxContainer(&system, -1, material, ChVector<>(0.6, 0.6, 1), 0.1,
+                                               ChVector<>(0, 0, 0), QUNIT, true, false, true, false);
+    bodies.push_back(container);
+
+    // Spheres on a slightly perturbed lattice, touching the container bottom
+    for (int ix = 0; ix < 5; ix++) {
+        for (int iy = 0; iy < 5; iy++) {
+            for (int iz = 0; iz < 4; iz++) {
+                AddBall(ChVector<>(0.1 * (ix - 2) + 0.001 * (iz % 3), 0.1 * (iy - 2), 0.05 + 0.099 * iz));
+            }
+        }
+    }
+}
+
+void SMCScene::AddBall(const ChVector<>& pos) {
+    double radius = 0.05;
+    auto ball = std::shared_ptr<ChBody>(system.NewBody());
+    ball->SetMass(1);
+    ball->SetInertiaXX(0.4 * radius * radius * ChVector<>(1, 1, 1));
+    ball->SetPos(pos);
+    ball->SetCollide(true);
+    ball->GetCollisionModel()->ClearModel();
+    utils::AddSphereGeometry(ball.get(), material, radius);
+    ball->GetCollisionModel()->BuildModel();
+    system.AddBody(ball);
+    bodies.push_back(ball);
+}
+
+TEST(ChronoParallel, smc_reduction) {
+    CHOMPfunctions::SetNumThreads(4);
+
+    SMCScene sort(ContactForceReduction::SORT);
+    SMCScene partition(ContactForceReduction::PARTITION);
+
+    double step = 1e-4;
+    for (int i = 0; i < 400; i++) {
+        // Drop one more ball on top of the others
+        if (i == 200) {
+            sort.AddBall(ChVector<>(0.02, 0.01, 0.5));
+            partition.AddBall(ChVector<>(0.02, 0.01, 0.5));
+        }
+
+        sort.system.DoStepDynamics(step);
+        partition.system.DoStepDynamics(step);
+
+        ASSERT_EQ(sort.system.GetNcontacts(), partition.system.GetNcontacts()) << "step " << i;
+        ASSERT_GT(sort.system.GetNcontacts(), 0) << "step " << i;
+
+        for (size_t j = 0; j < sort.bodies.size(); j++) {
+            real3 f_sort = sort.system.GetBodyContactForce(sort.bodies[j]);
+            real3 f_part = partition.system.GetBodyContactForce(partition.bodies[j]);
+            real3 t_sort = sort.system.GetBodyContactTorque(sort.bodies[j]);
+            real3 t_part = partition.system.GetBodyContactTorque(partition.bodies[j]);
+            ASSERT_NEAR(Length(f_sort - f_part), 0, 1e-8 * (1 + Length(f_sort))) << "step " << i << " body " << j;
+            ASSERT_NEAR(Length(t_sort - t_part), 0, 1e-8 * (1 + Length(t_sort))) << "step " << i << " body " << j;
+        }
+    }
+}
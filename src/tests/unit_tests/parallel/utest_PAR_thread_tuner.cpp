@@ -0,0 +1,103 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Unit test for the per-phase thread configuration and autotuner.
+// Checks saving and loading of a thread configuration and that tuning during
+// a granular simulation keeps the phase settings within the allowed range and
+// restores the OpenMP setting outside of the tuned phases.
+//
+// =============================================================================
+
+#include <cstdio>
+
+#include "chrono/utils/ChUtilsCreators.h"
+
+#include "chrono_parallel/physics/ChSystemParallel.h"
+
+#include "unit_testing.h"
+
+using namespace chrono;
+
+TEST(ChronoParallel, thread_tuner_save_load) {
+    ChThreadTuner tuner;
+    tuner.SetNumThreads(ThreadPhase::BROADPHASE, 2);
+    tuner.SetNumThreads(ThreadPhase::NARROWPHASE, 4);
+    tuner.SetNumThreads(ThreadPhase::SCHUR_PRODUCT, 1);
+    tuner.SetNumThreads(ThreadPhase::FORCE_ACCUMULATION, 3);
+    ASSERT_TRUE(tuner.Save("thread_tuner.txt"));
+
+    ChThreadTuner tuner_loaded;
+    ASSERT_TRUE(tuner_loaded.Load("thread_tuner.txt"));
+    for (int i = 0; i < static_cast<int>(ThreadPhase::NUM_PHASES); i++) {
+        auto phase = static_cast<ThreadPhase>(i);
+        ASSERT_EQ(tuner_loaded.GetNumThreads(phase), tuner.GetNumThreads(phase));
+    }
+
+    // Invalid phase names are rejected and do not modify the configuration
+    FILE* file = fopen("thread_tuner_bad.txt", "w");
+    fprintf(file, "broadphase 8\ncontacts 8\n");
+    fclose(file);
+    ASSERT_FALSE(tuner_loaded.Load("thread_tuner_bad.txt"));
+    ASSERT_EQ(tuner_loaded.GetNumThreads(ThreadPhase::BROADPHASE), 2);
+    ASSERT_FALSE(tuner_loaded.Load("thread_tuner_missing.txt"));
+
+    remove("thread_tuner.txt");
+    remove("thread_tuner_bad.txt");
+}
+
+TEST(ChronoParallel, thread_tuner_run) {
+    CHOMPfunctions::SetNumThreads(1);
+
+    ChSystemParallelSMC system;
+    system.Set_G_acc(ChVector<>(0, 0, -9.81));
+    system.GetSettings()->perform_thread_tuning = false;
+    system.GetSettings()->perform_phase_tuning = true;
+    system.GetSettings()->min_threads = 1;
+    system.GetSettings()->max_threads = 2;
+    system.GetSettings()->collision.bins_per_axis = vec3(10, 10, 10);
+    system.GetThreadTuner()->SetWindow(5);
+
+    auto mat = chrono_types::make_shared<ChMaterialSurfaceSMC>();
+    utils::CreateBoxContainer(&system, -1, mat, ChVector<>(1, 1, 1), 0.1, ChVector<>(0, 0, 0), QUNIT, true, false,
+                              true, false);
+
+    double radius = 0.1;
+    for (int ix = -3; ix <= 3; ix++) {
+        for (int iy = -3; iy <= 3; iy++) {
+            auto ball = std::shared_ptr<ChBody>(system.NewBody());
+            ball->SetMass(1);
+            ball->SetInertiaXX(0.4 * radius * radius * ChVector<>(1, 1, 1));
+            ball->SetPos(ChVector<>(2 * radius * ix, 2 * radius * iy, radius));
+            ball->SetCollide(true);
+            ball->GetCollisionModel()->ClearModel();
+            utils::AddSphereGeometry(ball.get(), mat, radius);
+            ball->GetCollisionModel()->BuildModel();
+            system.AddBody(ball);
+        }
+    }
+
+    auto tuner = system.GetThreadTuner();
+    for (int i = 0; i < 200; i++) {
+        system.DoStepDynamics(1e-4);
+        ASSERT_EQ(CHOMPfunctions::GetMaxThreads(), 1);
+        ASSERT_GT(tuner->GetTime(ThreadPhase::BROADPHASE), 0);
+        ASSERT_GT(tuner->GetTime(ThreadPhase::FORCE_ACCUMULATION), 0);
+        for (auto phase : {ThreadPhase::BROADPHASE, ThreadPhase::NARROWPHASE, ThreadPhase::FORCE_ACCUMULATION}) {
+            ASSERT_GE(tuner->GetNumThreads(phase), 1);
+            ASSERT_LE(tuner->GetNumThreads(phase), 2);
+        }
+        // The Schur product is not used by the SMC solver
+        ASSERT_EQ(tuner->GetNumThreads(ThreadPhase::SCHUR_PRODUCT), 0);
+    }
+}
@@ -0,0 +1,153 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Test for the assembly of the system matrix with a compiled assembly plan.
+// A chain of pendulums (bodies and revolute joints) and a chain of FEA springs
+// is simulated with a direct sparse solver with locked sparsity pattern. At
+// each step, the matrix assembled with the assembly plan (serial and parallel)
+// must match the matrix assembled through the regular path. A change in the
+// problem structure must be detected and trigger a regular assembly, followed
+// by a new recording of the plan.
+//
+// =============================================================================
+
+#include "gtest/gtest.h"
+
+#include "chrono/fea/ChElementSpring.h"
+#include "chrono/fea/ChMesh.h"
+#include "chrono/physics/ChLinkLock.h"
+#include "chrono/physics/ChSystemSMC.h"
+#include "chrono/solver/ChDirectSolverLS.h"
+
+using namespace chrono;
+using namespace chrono::fea;
+
+class AssemblyPlanTest : public ::testing::TestWithParam<int> {
+  protected:
+    AssemblyPlanTest();
+
+    // Assemble the system matrix with the given plan and compare against the regular assembly
+    double Compare(ChSparseMatrix& Z, ChSparseAssemblyPlan& plan);
+
+    ChSystemSMC sys;
+    std::vector<std::shared_ptr<ChBody>> bodies;
+    std::vector<std::shared_ptr<ChLinkLockRevolute>> links;
+};
+
+AssemblyPlanTest::AssemblyPlanTest() {
+    sys.Set_G_acc(ChVector<>(0, 0, -9.81));
+    sys.SetTimestepperType(ChTimestepper::Type::EULER_IMPLICIT_LINEARIZED);
+    auto solver = chrono_types::make_shared<ChSolverSparseLU>();
+    solver->LockSparsityPattern(true);
+    sys.SetSolver(solver);
+
+    auto ground = chrono_types::make_shared<ChBody>();
+    ground->SetBodyFixed(true);
+    sys.AddBody(ground);
+
+    int num_bodies = 40;
+    auto prev = ground;
+    for (int i = 0; i < num_bodies; i++) {
+        auto body = chrono_types::make_shared<ChBody>();
+        body->SetMass(1);
+        body->SetInertiaXX(ChVector<>(0.1, 0.1, 0.1));
+        body->SetPos(ChVector<>(0.5 * i + 0.25, 0, 0));
+        sys.AddBody(body);
+        bodies.push_back(body);
+
+        auto link = chrono_types::make_shared<ChLinkLockRevolute>();
+        link->Initialize(prev, body, ChCoordsys<>(ChVector<>(0.5 * i, 0, 0), Q_from_AngX(CH_C_PI_2)));
+        sys.AddLink(link);
+        links.push_back(link);
+        prev = body;
+    }
+
+    auto mesh = chrono_types::make_shared<ChMesh>();
+    int num_nodes = 40;
+    std::shared_ptr<ChNodeFEAxyz> prev_node;
+    for (int i = 0; i < num_nodes; i++) {
+        auto node = chrono_types::make_shared<ChNodeFEAxyz>(ChVector<>(0.1 * i, 1, 0));
+        node->SetMass(0.1);
+        node->SetFixed(i == 0);
+        mesh->AddNode(node);
+        if (prev_node) {
+            auto spring = chrono_types::make_shared<ChElementSpring>();
+            spring->SetNodes(prev_node, node);
+            spring->SetSpringK(1e4);
+            spring->SetDamperR(10);
+            mesh->AddElement(spring);
+        }
+        prev_node = node;
+    }
+    sys.Add(mesh);
+
+    sys.GetSystemDescriptor()->SetNumThreads(GetParam());
+}
+
+double AssemblyPlanTest::Compare(ChSparseMatrix& Z, ChSparseAssemblyPlan& plan) {
+    auto descriptor = sys.GetSystemDescriptor();
+    descriptor->ConvertToMatrixForm(&Z, plan);
+    Z.makeCompressed();
+
+    ChSparseMatrix Z_ref;
+    descriptor->ConvertToMatrixForm(&Z_ref, nullptr);
+
+    ChSparseMatrix diff = Z - Z_ref;
+    return diff.norm() / Z_ref.norm();
+}
+
+TEST_P(AssemblyPlanTest, replay) {
+    ChSparseMatrix Z;
+    ChSparseAssemblyPlan plan;
+
+    // Initialize the sparsity pattern of Z
+    sys.DoStepDynamics(1e-3);
+    auto descriptor = sys.GetSystemDescriptor();
+    descriptor->ConvertToMatrixForm(&Z, nullptr);
+    Z.makeCompressed();
+    ASSERT_FALSE(plan.IsValid());
+
+    // First call records the plan, subsequent calls replay it
+    for (int i = 0; i < 10; i++) {
+        EXPECT_LT(Compare(Z, plan), 1e-14);
+        ASSERT_TRUE(plan.IsValidFor(Z));
+        sys.DoStepDynamics(1e-3);
+    }
+
+    // Replace one of the joints; the problem size is unchanged, but the constraint rows are reordered, so replaying
+    // the stale plan fails and the matrix is assembled anew
+    sys.RemoveLink(links[10]);
+    auto link = chrono_types::make_shared<ChLinkLockRevolute>();
+    link->Initialize(bodies[9], bodies[10], ChCoordsys<>(ChVector<>(5, 0, 0), Q_from_AngX(CH_C_PI_2)));
+    sys.AddLink(link);
+    sys.DoStepDynamics(1e-3);
+
+    EXPECT_LT(Compare(Z, plan), 1e-14);
+    EXPECT_FALSE(plan.IsValid());
+
+    // The plan is recorded again for the new structure
+    EXPECT_LT(Compare(Z, plan), 1e-14);
+    EXPECT_TRUE(plan.IsValid());
+    for (int i = 0; i < 5; i++) {
+        sys.DoStepDynamics(1e-3);
+        EXPECT_LT(Compare(Z, plan), 1e-14);
+        ASSERT_TRUE(plan.IsValidFor(Z));
+    }
+
+    auto solver = std::static_pointer_cast<ChDirectSolverLS>(sys.GetSolver());
+    std::cout << "Setup calls: " << solver->GetNumSetupCalls()
+              << "  assembly time: " << solver->GetTimeSetup_Assembly() << " s" << std::endl;
+}
+
+INSTANTIATE_TEST_CASE_P(ChSystemDescriptor, AssemblyPlanTest, ::testing::Values(1, 2));
@@ -0,0 +1,148 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Test for the parallel assembly passes in ChAssembly.
+// A set of pendulum chains (bodies connected through revolute and spherical
+// joints) is created in two systems, one using a single thread and one using
+// 4 threads. The state, residual, and constraint terms loaded by the two
+// systems must be identical, and so must be the simulation results.
+//
+// =============================================================================
+
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+#include "chrono/physics/ChLinkLock.h"
+#include "chrono/physics/ChSystemSMC.h"
+#include "chrono/solver/ChDirectSolverLS.h"
+
+using namespace chrono;
+
+// Set of M pendulum chains, each with N bodies.
+struct Chains {
+    Chains(int num_threads, int M, int N);
+
+    ChSystemSMC sys;
+};
+
+Chains::Chains(int num_threads, int M, int N) {
+    sys.Set_G_acc(ChVector<>(0, -9.81, 0));
+    sys.SetTimestepperType(ChTimestepper::Type::EULER_IMPLICIT_LINEARIZED);
+    sys.SetSolver(chrono_types::make_shared<ChSolverSparseLU>());
+    sys.SetNumThreads(num_threads);
+
+    for (int i = 0; i < M; i++) {
+        auto ground = chrono_types::make_shared<ChBody>();
+        ground->SetBodyFixed(true);
+        ground->SetPos(ChVector<>(0, 0, i));
+        sys.AddBody(ground);
+
+        std::shared_ptr<ChBody> prev = ground;
+        for (int j = 1; j <= N; j++) {
+            auto body = chrono_types::make_shared<ChBody>();
+            body->SetMass(1 + 0.1 * j);
+            body->SetInertiaXX(ChVector<>(0.1, 0.2, 0.1));
+            body->SetPos(ChVector<>(0.5 * j, 0, i));
+            body->SetPos_dt(ChVector<>(0, 0.1 * i, 0));
+            body->SetWvel_loc(ChVector<>(0, 0, 0.2 * j));
+            sys.AddBody(body);
+
+            ChCoordsys<> csys(ChVector<>(0.5 * j - 0.25, 0, i));
+            if (j % 2) {
+                auto joint = chrono_types::make_shared<ChLinkLockRevolute>();
+                joint->Initialize(prev, body, csys);
+                sys.AddLink(joint);
+            } else {
+                auto joint = chrono_types::make_shared<ChLinkLockSpherical>();
+                joint->Initialize(prev, body, csys);
+                sys.AddLink(joint);
+            }
+
+            prev = body;
+        }
+    }
+
+    sys.Setup();
+    sys.Update();
+}
+
+// Maximum absolute difference between two vectors.
+static double MaxDiff(const ChVectorDynamic<>& a, const ChVectorDynamic<>& b) {
+    return (a - b).lpNorm<Eigen::Infinity>();
+}
+
+TEST(ChAssembly, num_threads) {
+    Chains serial(1, 10, 20);
+    Chains parallel(4, 10, 20);
+    ASSERT_EQ(parallel.sys.GetNumThreads(), 4);
+
+    int nx = serial.sys.GetNcoords_x();
+    int nv = serial.sys.GetNcoords_w();
+    int nc = serial.sys.GetNconstr();
+    ASSERT_EQ(nv, parallel.sys.GetNcoords_w());
+    ASSERT_EQ(nc, parallel.sys.GetNconstr());
+
+    // State gather
+    ChState x1(nx, &serial.sys), x4(nx, &parallel.sys);
+    ChStateDelta v1(nv, &serial.sys), v4(nv, &parallel.sys);
+    double T1, T4;
+    serial.sys.StateGather(x1, v1, T1);
+    parallel.sys.StateGather(x4, v4, T4);
+    EXPECT_EQ(MaxDiff(x1, x4), 0);
+    EXPECT_EQ(MaxDiff(v1, v4), 0);
+
+    // Residual terms
+    ChVectorDynamic<> w(nv);
+    ChVectorDynamic<> L(nc);
+    for (int i = 0; i < nv; i++)
+        w(i) = std::sin(0.1 * i);
+    for (int i = 0; i < nc; i++)
+        L(i) = std::cos(0.1 * i);
+
+    ChVectorDynamic<> R1(nv), R4(nv);
+    R1.setConstant(1);
+    R4.setConstant(1);
+    serial.sys.LoadResidual_F(R1, 0.5);
+    parallel.sys.LoadResidual_F(R4, 0.5);
+    EXPECT_EQ(MaxDiff(R1, R4), 0);
+    serial.sys.LoadResidual_Mv(R1, w, -2.0);
+    parallel.sys.LoadResidual_Mv(R4, w, -2.0);
+    EXPECT_EQ(MaxDiff(R1, R4), 0);
+    serial.sys.LoadResidual_CqL(R1, L, 3.0);
+    parallel.sys.LoadResidual_CqL(R4, L, 3.0);
+    EXPECT_EQ(MaxDiff(R1, R4), 0);
+
+    // Constraint terms
+    ChVectorDynamic<> Qc1(nc), Qc4(nc);
+    Qc1.setConstant(1);
+    Qc4.setConstant(1);
+    serial.sys.LoadConstraint_C(Qc1, 2.0, true, 0.1);
+    parallel.sys.LoadConstraint_C(Qc4, 2.0, true, 0.1);
+    EXPECT_EQ(MaxDiff(Qc1, Qc4), 0);
+    serial.sys.LoadConstraint_Ct(Qc1, -1.0);
+    parallel.sys.LoadConstraint_Ct(Qc4, -1.0);
+    EXPECT_EQ(MaxDiff(Qc1, Qc4), 0);
+
+    // Simulation results
+    for (int i = 0; i < 100; i++) {
+        serial.sys.DoStepDynamics(1e-3);
+        parallel.sys.DoStepDynamics(1e-3);
+    }
+    serial.sys.StateGather(x1, v1, T1);
+    parallel.sys.StateGather(x4, v4, T4);
+    EXPECT_EQ(T1, T4);
+    EXPECT_LT(MaxDiff(x1, x4), 1e-12);
+    EXPECT_LT(MaxDiff(v1, v4), 1e-10);
+}
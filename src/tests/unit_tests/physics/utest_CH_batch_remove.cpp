@@ -0,0 +1,82 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Test for batched removal of bodies from a system.
+// Half of a set of colliding spheres is queued for removal; after the next
+// step, the remaining bodies must preserve their relative order and the
+// collision system must only contain the collision models of those bodies.
+//
+// =============================================================================
+
+#include "gtest/gtest.h"
+
+#include "chrono/collision/ChCollisionSystemBullet.h"
+#include "chrono/physics/ChBodyEasy.h"
+#include "chrono/physics/ChSystemNSC.h"
+
+using namespace chrono;
+
+TEST(ChAssembly, batch_remove) {
+    ChSystemNSC sys;
+    auto mat = chrono_types::make_shared<ChMaterialSurfaceNSC>();
+
+    auto floor = chrono_types::make_shared<ChBodyEasyBox>(10, 10, 1, 1000, false, true, mat);
+    floor->SetPos(ChVector<>(0, 0, -0.5));
+    floor->SetBodyFixed(true);
+    sys.AddBody(floor);
+
+    int num_balls = 50;
+    std::vector<std::shared_ptr<ChBody>> balls;
+    for (int i = 0; i < num_balls; i++) {
+        auto ball = chrono_types::make_shared<ChBodyEasySphere>(0.1, 1000, false, true, mat);
+        ball->SetPos(ChVector<>(0.25 * (i % 10) - 1, 0.25 * (i / 10) - 1, 0.1));
+        ball->SetIdentifier(i);
+        sys.AddBatch(ball);
+        balls.push_back(ball);
+    }
+
+    sys.DoStepDynamics(1e-3);
+    ASSERT_EQ((int)sys.Get_bodylist().size(), num_balls + 1);
+    ASSERT_GT(sys.GetNcontacts(), 0);
+
+    auto coll_sys = std::static_pointer_cast<collision::ChCollisionSystemBullet>(sys.GetCollisionSystem());
+    ASSERT_EQ(coll_sys->GetBulletCollisionWorld()->getNumCollisionObjects(), num_balls + 1);
+
+    // Queue every other ball for removal (one of them twice)
+    for (int i = 0; i < num_balls; i += 2)
+        sys.RemoveBatch(balls[i]);
+    sys.RemoveBatch(balls[0]);
+    ASSERT_EQ((int)sys.Get_bodylist().size(), num_balls + 1);
+
+    sys.DoStepDynamics(1e-3);
+    ASSERT_EQ((int)sys.Get_bodylist().size(), num_balls / 2 + 1);
+    ASSERT_EQ(coll_sys->GetBulletCollisionWorld()->getNumCollisionObjects(), num_balls / 2 + 1);
+    ASSERT_GT(sys.GetNcontacts(), 0);
+
+    // Remaining bodies keep their relative order
+    const auto& bodies = sys.Get_bodylist();
+    EXPECT_EQ(bodies[0], floor);
+    for (int i = 1; i <= num_balls / 2; i++) {
+        EXPECT_EQ(bodies[i]->GetIdentifier(), 2 * i - 1);
+    }
+
+    // Removed bodies are detached and can be added again
+    for (int i = 0; i < num_balls; i += 2) {
+        EXPECT_EQ(balls[i]->GetSystem(), nullptr);
+        sys.AddBatch(balls[i]);
+    }
+    sys.DoStepDynamics(1e-3);
+    ASSERT_EQ((int)sys.Get_bodylist().size(), num_balls + 1);
+    ASSERT_EQ(coll_sys->GetBulletCollisionWorld()->getNumCollisionObjects(), num_balls + 1);
+}
@@ -0,0 +1,185 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Test for the batch simulator: a set of pendulums with different lengths is
+// simulated concurrently and results are compared with a serial execution.
+// Each scenario must draw the same ChRandom values, without affecting the
+// global ChRandom sequence.
+//
+// =============================================================================
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "chrono/core/ChLog.h"
+#include "chrono/core/ChMathematics.h"
+#include "chrono/physics/ChBody.h"
+#include "chrono/physics/ChLinkLock.h"
+#include "chrono/physics/ChSystemNSC.h"
+#include "chrono/utils/ChBatchSimulator.h"
+
+using namespace chrono;
+using namespace chrono::utils;
+
+// Simple pendulum, with given length.
+class Pendulum : public ChBatchSimulator::Scenario {
+  public:
+    Pendulum(double length, bool fail = false) : m_length(length), m_fail(fail) {}
+
+    virtual void Initialize() override {
+        if (m_fail)
+            throw ChException("invalid pendulum");
+
+        m_system = std::unique_ptr<ChSystemNSC>(new ChSystemNSC);
+        m_system->Set_G_acc(ChVector<>(0, -9.81, 0));
+
+        auto ground = chrono_types::make_shared<ChBody>();
+        ground->SetBodyFixed(true);
+        m_system->AddBody(ground);
+
+        m_pend = chrono_types::make_shared<ChBody>();
+        m_pend->SetPos(ChVector<>(m_length, 0, 0));
+        m_pend->SetMass(1);
+        m_pend->SetInertiaXX(ChVector<>(0.1, 0.1, 0.1));
+        m_system->AddBody(m_pend);
+
+        auto rev = chrono_types::make_shared<ChLinkLockRevolute>();
+        rev->Initialize(ground, m_pend, ChCoordsys<>(VNULL, QUNIT));
+        m_system->AddLink(rev);
+    }
+
+    virtual ChSystem* GetSystem() override { return m_system.get(); }
+
+    virtual void Finalize() override {
+        if (m_system) {
+            m_pos = m_pend->GetPos();
+            GetLog() << "pendulum " << m_length << " done\n";
+        }
+        m_pend.reset();
+        m_system.reset();
+    }
+
+    ChVector<> m_pos;
+
+  private:
+    double m_length;
+    bool m_fail;
+    std::unique_ptr<ChSystemNSC> m_system;
+    std::shared_ptr<ChBody> m_pend;
+};
+
+// Invalid scenario, which does not create a system.
+class NoSystem : public ChBatchSimulator::Scenario {
+  public:
+    virtual void Initialize() override {}
+    virtual ChSystem* GetSystem() override { return nullptr; }
+};
+
+// Scenario that draws random values at initialization.
+class RandomValues : public ChBatchSimulator::Scenario {
+  public:
+    virtual void Initialize() override {
+        m_system = std::unique_ptr<ChSystemNSC>(new ChSystemNSC);
+        for (int i = 0; i < 3; i++)
+            m_values.push_back(ChRandom());
+    }
+
+    virtual ChSystem* GetSystem() override { return m_system.get(); }
+
+    std::vector<double> m_values;
+
+  private:
+    std::unique_ptr<ChSystemNSC> m_system;
+};
+
+TEST(ChBatchSimulator, pendulums) {
+    int num_runs = 16;
+    double step = 1e-3;
+    double end_time = 0.5;
+
+    std::vector<std::shared_ptr<Pendulum>> serial;
+    std::vector<std::shared_ptr<Pendulum>> batch;
+
+    ChBatchSimulator runner_serial;
+    runner_serial.SetNumThreads(1);
+    ChBatchSimulator runner;
+    runner.SetNumThreads(4);
+
+    for (int i = 0; i < num_runs; i++) {
+        double length = 0.5 + 0.1 * i;
+        serial.push_back(std::make_shared<Pendulum>(length));
+        batch.push_back(std::make_shared<Pendulum>(length));
+        runner_serial.AddScenario(serial.back(), step, end_time);
+        runner.AddScenario(batch.back(), step, end_time);
+    }
+    runner.AddScenario(std::make_shared<Pendulum>(1.0, true), step, end_time);
+    runner.AddScenario(std::make_shared<NoSystem>(), step, end_time);
+
+    ASSERT_EQ(runner_serial.Run(), num_runs);
+    ASSERT_EQ(runner.Run(), num_runs);
+    ASSERT_EQ(runner.GetNumThreadsUsed(), 4);
+
+    for (int i = 0; i < num_runs; i++) {
+        const auto& info = runner.GetRunInfo(i);
+        ASSERT_TRUE(info.completed);
+        ASSERT_EQ(info.num_steps, runner_serial.GetRunInfo(i).num_steps);
+        ASSERT_NEAR(info.sim_time, end_time, 1e-10);
+        ASSERT_EQ(batch[i]->m_pos, serial[i]->m_pos);
+        ASSERT_NE(info.log.find("done"), std::string::npos);
+    }
+
+    const auto& info_fail = runner.GetRunInfo(num_runs);
+    ASSERT_FALSE(info_fail.completed);
+    ASSERT_EQ(info_fail.error, "invalid pendulum");
+
+    const auto& info_nosys = runner.GetRunInfo(num_runs + 1);
+    ASSERT_FALSE(info_nosys.completed);
+    ASSERT_EQ(info_nosys.num_steps, 0);
+}
+
+TEST(ChBatchSimulator, random_seed) {
+    // Reference sequences from the default seed and from a user seed
+    std::vector<double> values_default;
+    ChSetRandomSeed(123);
+    for (int i = 0; i < 3; i++)
+        values_default.push_back(ChRandom());
+    std::vector<double> values_user;
+    ChSetRandomSeed(77);
+    for (int i = 0; i < 4; i++)
+        values_user.push_back(ChRandom());
+
+    // The seed is shared by all threads
+    ChSetRandomSeed(77);
+    std::thread other([]() { ChRandom(); });
+    other.join();
+    ASSERT_EQ(ChRandom(), values_user[1]);
+
+    // Each scenario restarts from the default seed, without affecting the global sequence
+    ChSetRandomSeed(77);
+    ChRandom();
+
+    std::vector<std::shared_ptr<RandomValues>> scenarios;
+    ChBatchSimulator runner;
+    runner.SetNumThreads(4);
+    for (int i = 0; i < 8; i++) {
+        scenarios.push_back(std::make_shared<RandomValues>());
+        runner.AddScenario(scenarios.back(), 1e-3, 1e-2);
+    }
+    ASSERT_EQ(runner.Run(), 8);
+
+    for (const auto& scenario : scenarios)
+        ASSERT_EQ(scenario->m_values, values_default);
+    ASSERT_EQ(ChRandom(), values_user[1]);
+}
@@ -0,0 +1,171 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Test for the multithreaded mode of the Bullet collision system.
+// A pile of overlapping bodies (spheres, boxes, cylinders, and compound bodies
+// with two shapes) on a floor is processed with 1 and with 4 collision threads.
+// The same set of contacts must be generated in both cases. In deterministic
+// mode, the contacts must also be reported in the same order for 2 and 4
+// threads.
+//
+// =============================================================================
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "chrono/collision/ChCollisionSystemBullet.h"
+#include "chrono/physics/ChBodyEasy.h"
+#include "chrono/physics/ChSystemNSC.h"
+
+using namespace chrono;
+
+// A contact, identified by the two bodies in contact.
+struct Contact {
+    int idA;
+    int idB;
+    ChVector<> pA;
+    ChVector<> pB;
+    double distance;
+};
+
+// Collect all contacts in the system, with the bodies in each contact sorted by identifier.
+class ContactCollector : public ChContactContainer::ReportContactCallback {
+  public:
+    virtual bool OnReportContact(const ChVector<>& pA,
+                                 const ChVector<>& pB,
+                                 const ChMatrix33<>& plane_coord,
+                                 const double& distance,
+                                 const double& eff_radius,
+                                 const ChVector<>& react_forces,
+                                 const ChVector<>& react_torques,
+                                 ChContactable* contactobjA,
+                                 ChContactable* contactobjB) override {
+        int idA = dynamic_cast<ChBody*>(contactobjA)->GetIdentifier();
+        int idB = dynamic_cast<ChBody*>(contactobjB)->GetIdentifier();
+        if (idA < idB)
+            contacts.push_back({idA, idB, pA, pB, distance});
+        else
+            contacts.push_back({idB, idA, pB, pA, distance});
+        return true;
+    }
+
+    std::vector<Contact> contacts;
+};
+
+// Create the pile of bodies, run collision detection, and return the contacts (in the order they were reported).
+static std::vector<Contact> GetContacts(int num_threads, bool deterministic) {
+    ChSystemNSC sys;
+    auto collsys = std::static_pointer_cast<collision::ChCollisionSystemBullet>(sys.GetCollisionSystem());
+    collsys->SetNumThreads(num_threads);
+    collsys->SetDeterministic(deterministic);
+
+    auto mat = chrono_types::make_shared<ChMaterialSurfaceNSC>();
+
+    auto floor = chrono_types::make_shared<ChBodyEasyBox>(10, 10, 1, 1000, false, true, mat);
+    floor->SetPos(ChVector<>(0, 0, -0.5));
+    floor->SetBodyFixed(true);
+    floor->SetIdentifier(0);
+    sys.AddBody(floor);
+
+    int id = 1;
+    for (int ix = 0; ix < 6; ix++) {
+        for (int iy = 0; iy < 6; iy++) {
+            for (int iz = 0; iz < 4; iz++) {
+                ChVector<> pos(0.38 * ix - 1, 0.38 * iy - 1, 0.19 + 0.36 * iz);
+                std::shared_ptr<ChBody> body;
+                switch (id % 4) {
+                    case 0:
+                        body = chrono_types::make_shared<ChBodyEasySphere>(0.2, 1000, false, true, mat);
+                        break;
+                    case 1:
+                        body = chrono_types::make_shared<ChBodyEasyBox>(0.38, 0.36, 0.4, 1000, false, true, mat);
+                        break;
+                    case 2:
+                        body = chrono_types::make_shared<ChBodyEasyCylinder>(0.2, 0.4, 1000, false, true, mat);
+                        break;
+                    case 3:
+                        body = chrono_types::make_shared<ChBody>();
+                        body->GetCollisionModel()->ClearModel();
+                        body->GetCollisionModel()->AddSphere(mat, 0.12, ChVector<>(0, -0.08, 0));
+                        body->GetCollisionModel()->AddSphere(mat, 0.12, ChVector<>(0, +0.08, 0));
+                        body->GetCollisionModel()->BuildModel();
+                        body->SetCollide(true);
+                        break;
+                }
+                body->SetPos(pos);
+                body->SetRot(Q_from_AngZ(0.1 * id));
+                body->SetIdentifier(id++);
+                sys.AddBody(body);
+            }
+        }
+    }
+
+    sys.Setup();
+    sys.Update();
+    sys.ComputeCollisions();
+
+    auto collector = chrono_types::make_shared<ContactCollector>();
+    sys.GetContactContainer()->ReportAllContacts(collector);
+    return collector->contacts;
+}
+
+static bool operator<(const Contact& a, const Contact& b) {
+    if (a.idA != b.idA)
+        return a.idA < b.idA;
+    if (a.idB != b.idB)
+        return a.idB < b.idB;
+    if (a.pA.x() != b.pA.x())
+        return a.pA.x() < b.pA.x();
+    if (a.pA.y() != b.pA.y())
+        return a.pA.y() < b.pA.y();
+    return a.pA.z() < b.pA.z();
+}
+
+static void CompareContacts(const std::vector<Contact>& c1, const std::vector<Contact>& c2) {
+    ASSERT_EQ(c1.size(), c2.size());
+    for (size_t i = 0; i < c1.size(); i++) {
+        ASSERT_EQ(c1[i].idA, c2[i].idA) << "contact " << i;
+        ASSERT_EQ(c1[i].idB, c2[i].idB) << "contact " << i;
+        EXPECT_NEAR((c1[i].pA - c2[i].pA).Length(), 0, 1e-12) << "contact " << i;
+        EXPECT_NEAR((c1[i].pB - c2[i].pB).Length(), 0, 1e-12) << "contact " << i;
+        EXPECT_NEAR(c1[i].distance, c2[i].distance, 1e-12) << "contact " << i;
+    }
+}
+
+TEST(ChCollisionSystemBullet, num_threads) {
+    auto contacts1 = GetContacts(1, false);
+    auto contacts4 = GetContacts(4, false);
+    ASSERT_GT(contacts1.size(), 100);
+
+    std::sort(contacts1.begin(), contacts1.end());
+    std::sort(contacts4.begin(), contacts4.end());
+    CompareContacts(contacts1, contacts4);
+}
+
+TEST(ChCollisionSystemBullet, deterministic) {
+    auto contacts1 = GetContacts(1, false);
+    auto contacts2 = GetContacts(2, true);
+    auto contacts4 = GetContacts(4, true);
+    ASSERT_GT(contacts2.size(), 100);
+
+    // Same order for any number of threads
+    CompareContacts(contacts2, contacts4);
+
+    // Same set as with a single thread
+    std::sort(contacts1.begin(), contacts1.end());
+    std::sort(contacts4.begin(), contacts4.end());
+    CompareContacts(contacts1, contacts4);
+}
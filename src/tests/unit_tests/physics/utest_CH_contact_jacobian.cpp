@@ -0,0 +1,172 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Unit test for the Jacobians of SMC contact forces.
+// The analytical stiffness and damping matrices of a body-body contact are
+// compared against finite-difference approximations of the derivatives of the
+// generalized contact forces, for the different contact force models, with and
+// without material properties, and in both stick and slip regimes.
+//
+// =============================================================================
+
+#include <tuple>
+
+#include "chrono/physics/ChBody.h"
+#include "chrono/physics/ChContactSMC.h"
+#include "chrono/physics/ChSystemSMC.h"
+
+#include "gtest/gtest.h"
+
+using namespace chrono;
+
+typedef ChContactSMC<ChContactable_1vars<6>, ChContactable_1vars<6>> ContactBodyBody;
+
+class ContactJacobianTest
+    : public ::testing::TestWithParam<std::tuple<ChSystemSMC::ContactForceModel, bool>> {};
+
+// Compute finite-difference approximations of K = -dQ/dx and R = -dQ/dw.
+static void CalculateJacobiansFD(ContactBodyBody& contact,
+                                 ChContactable_1vars<6>& bodyA,
+                                 ChContactable_1vars<6>& bodyB,
+                                 const ChMaterialCompositeSMC& mat,
+                                 ChMatrixDynamic<>& K,
+                                 ChMatrixDynamic<>& R) {
+    ChState xA(7, NULL), xB(7, NULL);
+    ChStateDelta wA(6, NULL), wB(6, NULL);
+    bodyA.ContactableGetStateBlock_x(xA);
+    bodyA.ContactableGetStateBlock_w(wA);
+    bodyB.ContactableGetStateBlock_x(xB);
+    bodyB.ContactableGetStateBlock_w(wB);
+
+    double h = 1e-7;
+    ChState x1(7, NULL), x2(7, NULL);
+    ChStateDelta dx(6, NULL);
+    dx.setZero(6, NULL);
+    ChVectorDynamic<> Q1(12), Q2(12);
+
+    K.resize(12, 12);
+    R.resize(12, 12);
+
+    for (int i = 0; i < 12; i++) {
+        ChContactable_1vars<6>& body = (i < 6) ? bodyA : bodyB;
+        ChState& x = (i < 6) ? xA : xB;
+        ChStateDelta& w = (i < 6) ? wA : wB;
+        int j = i % 6;
+
+        dx(j) = h;
+        body.ContactableIncrementState(x, dx, x1);
+        dx(j) = -h;
+        body.ContactableIncrementState(x, dx, x2);
+        dx(j) = 0;
+        if (i < 6) {
+            contact.CalculateQ(x1, wA, xB, wB, mat, Q1);
+            contact.CalculateQ(x2, wA, xB, wB, mat, Q2);
+        } else {
+            contact.CalculateQ(xA, wA, x1, wB, mat, Q1);
+            contact.CalculateQ(xA, wA, x2, wB, mat, Q2);
+        }
+        K.col(i) = (Q2 - Q1) / (2 * h);
+
+        w(j) += h;
+        contact.CalculateQ(xA, wA, xB, wB, mat, Q1);
+        w(j) -= 2 * h;
+        contact.CalculateQ(xA, wA, xB, wB, mat, Q2);
+        w(j) += h;
+        R.col(i) = (Q2 - Q1) / (2 * h);
+    }
+}
+
+TEST_P(ContactJacobianTest, body_body) {
+    auto model = std::get<0>(GetParam());
+    bool use_mat_props = std::get<1>(GetParam());
+
+    ChSystemSMC sys;
+    sys.SetContactForceModel(model);
+    sys.UseMaterialProperties(use_mat_props);
+    sys.SetTangentialDisplacementModel(ChSystemSMC::OneStep);
+    sys.SetStiffContact(true);
+    sys.SetStep(1e-3);
+
+    // Two bodies, with the contact points offset from the centers of mass
+    ChBody bodyA;
+    bodyA.SetMass(1);
+    bodyA.SetInertiaXX(ChVector<>(0.1, 0.2, 0.3));
+    bodyA.SetPos(ChVector<>(0, 0, 0));
+    bodyA.SetRot(Q_from_AngX(0.2));
+    bodyA.SetPos_dt(ChVector<>(0.1, 0, 0.2));
+    bodyA.SetWvel_par(ChVector<>(0, 0.3, 0.1));
+
+    ChBody bodyB;
+    bodyB.SetMass(2);
+    bodyB.SetInertiaXX(ChVector<>(0.2, 0.2, 0.4));
+    bodyB.SetPos(ChVector<>(0.1, 0, 1));
+    bodyB.SetRot(Q_from_AngY(-0.3));
+    bodyB.SetPos_dt(ChVector<>(-0.1, 0.05, 0.1));
+    bodyB.SetWvel_par(ChVector<>(0.2, 0, 0));
+
+    double delta = 1e-3;
+    collision::ChCollisionInfo cinfo;
+    cinfo.vN = ChVector<>(0, 0, 1);
+    cinfo.vpA = ChVector<>(0.05, 0.02, 0.5);
+    cinfo.vpB = cinfo.vpA - delta * cinfo.vN;
+    cinfo.distance = -delta;
+    cinfo.eff_radius = 0.25;
+
+    auto matA = chrono_types::make_shared<ChMaterialSurfaceSMC>();
+    auto matB = chrono_types::make_shared<ChMaterialSurfaceSMC>();
+    for (auto mat : {matA, matB}) {
+        mat->SetYoungModulus(1e7f);
+        mat->SetPoissonRatio(0.3f);
+        mat->SetRestitution(0.5f);
+        mat->SetKn(2e5f);
+        mat->SetKt(1e5f);
+        mat->SetGn(40);
+        mat->SetGt(20);
+    }
+
+    // Stick (large friction) and slip (small friction) regimes
+    for (float friction : {0.8f, 0.02f}) {
+        matA->SetFriction(friction);
+        matB->SetFriction(friction);
+        ChMaterialCompositionStrategy strategy;
+        ChMaterialCompositeSMC mat(&strategy, matA, matB);
+
+        ContactBodyBody contact(sys.GetContactContainer().get(), &bodyA, &bodyB, cinfo, mat);
+        ASSERT_TRUE(contact.GetJacobianK() != nullptr);
+        ASSERT_GT(contact.GetContactForceAbs().Length(), 0);
+
+        ChMatrixDynamic<> K_fd;
+        ChMatrixDynamic<> R_fd;
+        CalculateJacobiansFD(contact, bodyA, bodyB, mat, K_fd, R_fd);
+
+        const auto& K = *contact.GetJacobianK();
+        const auto& R = *contact.GetJacobianR();
+
+        // The analytical Jacobians neglect the (small) variation of the contact points with the body states
+        double errK = (K - K_fd).norm() / K_fd.norm();
+        double errR = (R - R_fd).norm() / R_fd.norm();
+        std::cout << "model " << model << (use_mat_props ? " (mat props)" : "")
+                  << "  mu = " << friction << "  errK = " << errK << "  errR = " << errR << std::endl;
+        EXPECT_LT(errK, 1e-2);
+        EXPECT_LT(errR, 1e-6);
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(ChronoSMC,
+                        ContactJacobianTest,
+                        ::testing::Combine(::testing::Values(ChSystemSMC::Hooke,
+                                                             ChSystemSMC::Hertz,
+                                                             ChSystemSMC::Flores,
+                                                             ChSystemSMC::PlainCoulomb),
+                                           ::testing::Bool()));
@@ -0,0 +1,126 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Test for the automatic Newton matrix update policy of the HHT integrator.
+// A double pendulum is simulated with modified Newton, re-evaluating the Newton
+// matrix at every step and with the AUTOMATIC policy. The trajectories must
+// agree, with fewer matrix evaluations for the AUTOMATIC policy, and the
+// convergence-rate trigger must not cause more than one matrix evaluation in
+// a step.
+//
+// =============================================================================
+
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+#include "chrono/physics/ChLinkLock.h"
+#include "chrono/physics/ChSystemSMC.h"
+#include "chrono/solver/ChDirectSolverLS.h"
+#include "chrono/timestepper/ChTimestepperHHT.h"
+
+using namespace chrono;
+
+// Double pendulum model integrated with HHT and modified Newton.
+struct DoublePendulum {
+    DoublePendulum(ChTimestepperHHT::JacobianUpdate update);
+
+    ChSystemSMC sys;
+    std::shared_ptr<ChBody> body2;
+    std::shared_ptr<ChTimestepperHHT> integrator;
+};
+
+DoublePendulum::DoublePendulum(ChTimestepperHHT::JacobianUpdate update) {
+    sys.Set_G_acc(ChVector<>(0, 0, -9.81));
+
+    auto solver = chrono_types::make_shared<ChSolverSparseLU>();
+    solver->LockSparsityPattern(true);
+    sys.SetSolver(solver);
+
+    sys.SetTimestepperType(ChTimestepper::Type::HHT);
+    integrator = std::static_pointer_cast<ChTimestepperHHT>(sys.GetTimestepper());
+    integrator->SetAlpha(-0.2);
+    integrator->SetMaxiters(20);
+    integrator->SetAbsTolerances(1e-8);
+    integrator->SetStepControl(false);
+    integrator->SetModifiedNewton(true);
+    integrator->SetJacobianUpdateMethod(update);
+
+    auto ground = chrono_types::make_shared<ChBody>();
+    ground->SetBodyFixed(true);
+    sys.AddBody(ground);
+
+    auto body1 = chrono_types::make_shared<ChBody>();
+    body1->SetMass(2);
+    body1->SetInertiaXX(ChVector<>(0.1, 0.1, 0.1));
+    body1->SetPos(ChVector<>(0.5, 0, 0));
+    sys.AddBody(body1);
+
+    body2 = chrono_types::make_shared<ChBody>();
+    body2->SetMass(1);
+    body2->SetInertiaXX(ChVector<>(0.05, 0.05, 0.05));
+    body2->SetPos(ChVector<>(1.5, 0, 0));
+    sys.AddBody(body2);
+
+    auto rev1 = chrono_types::make_shared<ChLinkLockRevolute>();
+    rev1->Initialize(ground, body1, ChCoordsys<>(ChVector<>(0, 0, 0), Q_from_AngX(CH_C_PI_2)));
+    sys.AddLink(rev1);
+
+    auto rev2 = chrono_types::make_shared<ChLinkLockRevolute>();
+    rev2->Initialize(body1, body2, ChCoordsys<>(ChVector<>(1, 0, 0), Q_from_AngX(CH_C_PI_2)));
+    sys.AddLink(rev2);
+}
+
+TEST(ChTimestepperHHT, automatic_jacobian_update) {
+    double step = 1e-3;
+    int num_steps = 500;
+
+    DoublePendulum model_ref(ChTimestepperHHT::JacobianUpdate::EVERY_STEP);
+    DoublePendulum model(ChTimestepperHHT::JacobianUpdate::AUTOMATIC);
+    model.integrator->SetMaxJacobianAge(20);
+
+    int setups_ref = 0;
+    int setups = 0;
+    double max_err = 0;
+    for (int i = 0; i < num_steps; i++) {
+        model_ref.sys.DoStepDynamics(step);
+        model.sys.DoStepDynamics(step);
+        setups_ref += model_ref.integrator->GetNumSetupCalls();
+        setups += model.integrator->GetNumSetupCalls();
+        max_err = std::max(max_err, (model.body2->GetPos() - model_ref.body2->GetPos()).Length());
+    }
+
+    std::cout << "EVERY_STEP setups: " << setups_ref << "   AUTOMATIC setups: " << setups
+              << "   max position difference: " << max_err << std::endl;
+    EXPECT_EQ(setups_ref, num_steps);
+    EXPECT_LT(setups, num_steps / 2);
+    EXPECT_GE(setups, num_steps / 20);  // at least one evaluation every 20 steps (maximum age)
+    EXPECT_LT(max_err, 1e-5);
+}
+
+TEST(ChTimestepperHHT, convergence_rate_trigger) {
+    // With a zero convergence-rate threshold, any iteration with an out-of-date matrix which does not converge
+    // triggers a matrix update; the updated matrix must then be kept for the rest of the step.
+    DoublePendulum model(ChTimestepperHHT::JacobianUpdate::AUTOMATIC);
+    model.integrator->SetMaxJacobianAge(1000);
+    model.integrator->SetMaxConvergenceRate(0);
+
+    int setups = 0;
+    for (int i = 0; i < 200; i++) {
+        model.sys.DoStepDynamics(1e-3);
+        setups += model.integrator->GetNumSetupCalls();
+        EXPECT_LE(model.integrator->GetNumSetupCalls(), 1) << "step " << i;
+    }
+    EXPECT_GT(setups, 1);
+}
@@ -0,0 +1,134 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Test for the graph-colored parallel sweep of the PSOR solver.
+// A chain of pendulums (bilateral constraints) and a set of spheres resting on
+// a floor (frictional contacts) are simulated with the sequential and with the
+// parallel PSOR sweep. The coloring must not assign two constraint blocks
+// sharing active variables to the same color, and both sweeps must converge to
+// the same solution.
+//
+// =============================================================================
+
+#include <set>
+
+#include "gtest/gtest.h"
+
+#include "chrono/physics/ChBodyEasy.h"
+#include "chrono/physics/ChLinkLock.h"
+#include "chrono/physics/ChSystemNSC.h"
+#include "chrono/solver/ChSolverPSOR.h"
+
+using namespace chrono;
+
+static void CreateModel(ChSystemNSC& sys, bool parallel) {
+    sys.Set_G_acc(ChVector<>(0, 0, -9.81));
+
+    auto solver = chrono_types::make_shared<ChSolverPSOR>();
+    solver->EnableParallel(parallel);
+    solver->SetMaxIterations(10000);
+    solver->SetTolerance(1e-12);
+    solver->EnableWarmStart(false);
+    sys.SetSolver(solver);
+
+    auto mat = chrono_types::make_shared<ChMaterialSurfaceNSC>();
+    mat->SetFriction(0.4f);
+
+    auto floor = chrono_types::make_shared<ChBodyEasyBox>(20, 4, 1, 1000, false, true, mat);
+    floor->SetPos(ChVector<>(5, 0, -0.5));
+    floor->SetBodyFixed(true);
+    sys.AddBody(floor);
+
+    // Pendulum chain, attached to the (fixed) floor body
+    std::shared_ptr<ChBody> prev = floor;
+    for (int i = 0; i < 10; i++) {
+        auto body = chrono_types::make_shared<ChBody>();
+        body->SetMass(1);
+        body->SetInertiaXX(ChVector<>(0.1, 0.1, 0.1));
+        body->SetPos(ChVector<>(0.5 * i + 0.25, 1, 2));
+        sys.AddBody(body);
+
+        auto link = chrono_types::make_shared<ChLinkLockRevolute>();
+        link->Initialize(prev, body, ChCoordsys<>(ChVector<>(0.5 * i, 1, 2), Q_from_AngX(CH_C_PI_2)));
+        sys.AddLink(link);
+        prev = body;
+    }
+
+    // Spheres resting on the floor (slightly penetrating)
+    for (int i = 0; i < 10; i++) {
+        auto ball = chrono_types::make_shared<ChBodyEasySphere>(0.2, 1000, false, true, mat);
+        ball->SetPos(ChVector<>(i, -1, 0.199));
+        ball->SetPos_dt(ChVector<>(0.1 * i, 0, 0));
+        sys.AddBody(ball);
+    }
+}
+
+TEST(ChSolverPSOR, parallel_coloring) {
+    ChSystemNSC sys_serial;
+    ChSystemNSC sys_parallel;
+    CreateModel(sys_serial, false);
+    CreateModel(sys_parallel, true);
+
+    // No coloring before the first solve
+    auto solver = std::static_pointer_cast<ChSolverPSOR>(sys_parallel.GetSolver());
+    EXPECT_EQ(solver->GetNumColors(), 0);
+    EXPECT_TRUE(solver->GetColorBlocks(0).empty());
+    EXPECT_TRUE(solver->GetSerialBlocks().empty());
+
+    sys_serial.DoStepDynamics(1e-3);
+    sys_parallel.DoStepDynamics(1e-3);
+
+    auto& constraints = sys_parallel.GetSystemDescriptor()->GetConstraintsList();
+    ASSERT_GT(solver->GetNumColors(), 1);
+
+    // Check the coloring: blocks of the same color do not share active variables
+    int num_blocks = 0;
+    int num_triplets = 0;
+    for (int color = 0; color < solver->GetNumColors(); color++) {
+        auto blocks = solver->GetColorBlocks(color);
+        num_blocks += (int)blocks.size();
+        std::set<ChVariables*> color_vars;
+        for (auto ic : blocks) {
+            int size = (constraints[ic]->GetMode() == CONSTRAINT_FRIC) ? 3 : 1;
+            num_triplets += (size == 3);
+            std::vector<ChVariables*> vars;
+            for (int k = 0; k < size; k++)
+                ASSERT_TRUE(constraints[ic + k]->CollectVariables(vars));
+            std::set<ChVariables*> block_vars;
+            for (auto var : vars) {
+                if (var->IsActive())
+                    block_vars.insert(var);
+            }
+            for (auto var : block_vars)
+                EXPECT_TRUE(color_vars.insert(var).second) << "color " << color << " constraint " << ic;
+        }
+    }
+    EXPECT_TRUE(solver->GetColorBlocks(solver->GetNumColors()).empty());
+    for (auto ic : solver->GetSerialBlocks()) {
+        num_blocks++;
+        num_triplets += (constraints[ic]->GetMode() == CONSTRAINT_FRIC);
+    }
+    EXPECT_EQ(num_triplets, 10);
+    EXPECT_EQ(num_blocks, (int)constraints.size() - 2 * num_triplets);
+
+    // Check that both sweeps converged to the same solution
+    EXPECT_LT(solver->GetError(), 1e-10);
+    auto& bodies_serial = sys_serial.Get_bodylist();
+    auto& bodies_parallel = sys_parallel.Get_bodylist();
+    ASSERT_EQ(bodies_serial.size(), bodies_parallel.size());
+    for (size_t i = 0; i < bodies_serial.size(); i++) {
+        EXPECT_NEAR((bodies_serial[i]->GetPos_dt() - bodies_parallel[i]->GetPos_dt()).Length(), 0, 1e-8);
+        EXPECT_NEAR((bodies_serial[i]->GetWvel_par() - bodies_parallel[i]->GetWvel_par()).Length(), 0, 1e-8);
+    }
+}
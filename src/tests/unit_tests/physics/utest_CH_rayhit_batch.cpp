@@ -0,0 +1,127 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Test for batched ray-hit tests with the Bullet collision system.
+// A grid of rays is cast at bodies with multiple collision shapes (compound
+// shapes) and at bodies with a single shape, using several threads. The results
+// must match those of serial ray-hit tests, and the collision shapes of the
+// bodies must be left unchanged.
+//
+// =============================================================================
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "chrono/collision/ChCollisionModelBullet.h"
+#include "chrono/collision/ChCollisionSystemBullet.h"
+#include "chrono/collision/bullet/btBulletCollisionCommon.h"
+#include "chrono/physics/ChBodyEasy.h"
+#include "chrono/physics/ChSystemNSC.h"
+
+using namespace chrono;
+using namespace chrono::collision;
+
+// Bullet collision model that provides access to the current shape of its collision object.
+class TestCollisionModel : public ChCollisionModelBullet {
+  public:
+    btCollisionShape* GetBulletShape() const { return bt_collision_object->getCollisionShape(); }
+    btCompoundShape* GetCompoundShape() const { return bt_compound_shape.get(); }
+};
+
+TEST(ChCollisionSystemBullet, rayhit_batch) {
+    ChSystemNSC sys;
+    auto collsys = std::static_pointer_cast<ChCollisionSystemBullet>(sys.GetCollisionSystem());
+    collsys->SetNumThreads(4);
+
+    auto mat = chrono_types::make_shared<ChMaterialSurfaceNSC>();
+
+    // Bodies with several collision shapes
+    std::vector<std::shared_ptr<TestCollisionModel>> models;
+    for (int ix = 0; ix < 3; ix++) {
+        for (int iy = 0; iy < 3; iy++) {
+            auto model = chrono_types::make_shared<TestCollisionModel>();
+            auto body = chrono_types::make_shared<ChBody>(model);
+            body->SetPos(ChVector<>(ix - 1.0, iy - 1.0, 0));
+            body->SetRot(Q_from_AngZ(0.3 * (ix + 3 * iy)));
+            body->SetBodyFixed(true);
+            model->ClearModel();
+            model->AddSphere(mat, 0.2, ChVector<>(-0.2, 0, 0));
+            model->AddSphere(mat, 0.15, ChVector<>(+0.2, 0, 0.1));
+            model->AddBox(mat, 0.1, 0.3, 0.05, ChVector<>(0, 0, -0.1));
+            model->BuildModel();
+            body->SetCollide(true);
+            sys.AddBody(body);
+            models.push_back(model);
+        }
+    }
+
+    // Bodies with a single collision shape
+    for (int i = 0; i < 2; i++) {
+        auto body = chrono_types::make_shared<ChBodyEasySphere>(0.2, 1000, false, true, mat);
+        body->SetPos(ChVector<>(i - 0.5, -0.5, 0));
+        body->SetBodyFixed(true);
+        sys.AddBody(body);
+    }
+
+    std::vector<btCollisionShape*> shapes;
+    for (const auto& model : models) {
+        ASSERT_NE(model->GetCompoundShape(), nullptr);
+        ASSERT_EQ(model->GetBulletShape(), model->GetCompoundShape());
+        shapes.push_back(model->GetBulletShape());
+    }
+
+    sys.Setup();
+    sys.Update();
+    sys.ComputeCollisions();
+
+    // Grid of vertical rays, repeated so that several threads query the same bodies concurrently
+    std::vector<ChVector<>> from;
+    std::vector<ChVector<>> to;
+    for (int rep = 0; rep < 4; rep++) {
+        for (int ix = 0; ix < 100; ix++) {
+            for (int iy = 0; iy < 100; iy++) {
+                ChVector<> p(-1.6 + 0.032 * ix, -1.6 + 0.032 * iy, 0);
+                from.push_back(p + ChVector<>(0, 0, 1));
+                to.push_back(p - ChVector<>(0, 0, 1));
+            }
+        }
+    }
+
+    std::vector<ChCollisionSystem::ChRayhitResult> results;
+    int num_hits = collsys->RayHitBatch(from, to, results);
+    ASSERT_EQ(results.size(), from.size());
+    EXPECT_GT(num_hits, 1000);
+
+    // The collision objects must still use their compound shapes
+    for (size_t i = 0; i < models.size(); i++) {
+        EXPECT_EQ(models[i]->GetBulletShape(), shapes[i]) << "model " << i;
+        EXPECT_EQ(models[i]->GetCompoundShape()->getNumChildShapes(), 3) << "model " << i;
+    }
+
+    // Same results as serial ray-hit tests
+    int num_hits_serial = 0;
+    for (size_t i = 0; i < from.size(); i++) {
+        ChCollisionSystem::ChRayhitResult result;
+        if (collsys->RayHit(from[i], to[i], result))
+            num_hits_serial++;
+        ASSERT_EQ(results[i].hit, result.hit) << "ray " << i;
+        if (result.hit) {
+            EXPECT_EQ(results[i].hitModel, result.hitModel) << "ray " << i;
+            EXPECT_NEAR((results[i].abs_hitPoint - result.abs_hitPoint).Length(), 0, 1e-12) << "ray " << i;
+            EXPECT_NEAR((results[i].abs_hitNormal - result.abs_hitNormal).Length(), 0, 1e-12) << "ray " << i;
+        }
+    }
+    EXPECT_EQ(num_hits, num_hits_serial);
+}
@@ -0,0 +1,147 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Test for the sparse LDLT direct solver.
+// A pendulum chain (bodies connected through revolute joints and springs) is
+// simulated with the SparseLU and with the SparseLDLT solver, which must give
+// the same results. The symbolic analysis of the LDLT solver must be reused
+// while the sparsity pattern is locked, and redone when the pattern changes.
+//
+// =============================================================================
+
+#include "gtest/gtest.h"
+
+#include "chrono/physics/ChLinkLock.h"
+#include "chrono/physics/ChLinkTSDA.h"
+#include "chrono/physics/ChSystemSMC.h"
+#include "chrono/solver/ChDirectSolverLS.h"
+
+using namespace chrono;
+
+// Pendulum chain with N bodies.
+class Chain {
+  public:
+    Chain(std::shared_ptr<ChDirectSolverLS> solver, int N);
+
+    // Append a body to the chain.
+    void AddBody();
+
+    ChSystemSMC sys;
+    std::shared_ptr<ChBody> ground;
+    std::shared_ptr<ChBody> last;
+    int num_bodies;
+};
+
+Chain::Chain(std::shared_ptr<ChDirectSolverLS> solver, int N) : num_bodies(0) {
+    sys.Set_G_acc(ChVector<>(0, -9.81, 0));
+    sys.SetTimestepperType(ChTimestepper::Type::EULER_IMPLICIT_LINEARIZED);
+    sys.SetSolver(solver);
+
+    ground = chrono_types::make_shared<ChBody>();
+    ground->SetBodyFixed(true);
+    sys.AddBody(ground);
+
+    last = ground;
+    for (int i = 0; i < N; i++)
+        AddBody();
+}
+
+void Chain::AddBody() {
+    num_bodies++;
+    double x = 0.5 * num_bodies;
+
+    auto body = chrono_types::make_shared<ChBody>();
+    body->SetMass(1 + 0.1 * num_bodies);
+    body->SetInertiaXX(ChVector<>(0.1, 0.2, 0.1));
+    body->SetPos(ChVector<>(x, 0, 0));
+    sys.AddBody(body);
+
+    auto joint = chrono_types::make_shared<ChLinkLockRevolute>();
+    joint->Initialize(last, body, ChCoordsys<>(ChVector<>(x - 0.25, 0, 0)));
+    sys.AddLink(joint);
+
+    auto spring = chrono_types::make_shared<ChLinkTSDA>();
+    spring->Initialize(ground, body, false, ChVector<>(x, 1, 0), ChVector<>(x, 0, 0));
+    spring->SetSpringCoefficient(100);
+    spring->SetDampingCoefficient(5);
+    sys.AddLink(spring);
+
+    last = body;
+}
+
+// Maximum position difference between the bodies of two chains.
+static double MaxDiff(Chain& c1, Chain& c2) {
+    double diff = 0;
+    auto& bodies1 = c1.sys.Get_bodylist();
+    auto& bodies2 = c2.sys.Get_bodylist();
+    for (size_t i = 0; i < bodies1.size(); i++)
+        diff = std::max(diff, (bodies1[i]->GetPos() - bodies2[i]->GetPos()).Length());
+    return diff;
+}
+
+TEST(ChSolverSparseLDLT, solution) {
+    auto solver_lu = chrono_types::make_shared<ChSolverSparseLU>();
+    auto solver_ldlt = chrono_types::make_shared<ChSolverSparseLDLT>();
+
+    Chain chain_lu(solver_lu, 10);
+    Chain chain_ldlt(solver_ldlt, 10);
+
+    for (int i = 0; i < 100; i++) {
+        chain_lu.sys.DoStepDynamics(1e-3);
+        chain_ldlt.sys.DoStepDynamics(1e-3);
+    }
+
+    EXPECT_GT((chain_lu.last->GetPos() - ChVector<>(5, 0, 0)).Length(), 1e-3);
+    EXPECT_LT(MaxDiff(chain_lu, chain_ldlt), 1e-10);
+}
+
+TEST(ChSolverSparseLDLT, analysis_reuse) {
+    auto solver_lu = chrono_types::make_shared<ChSolverSparseLU>();
+    auto solver_locked = chrono_types::make_shared<ChSolverSparseLDLT>();
+    auto solver_unlocked = chrono_types::make_shared<ChSolverSparseLDLT>();
+    solver_lu->LockSparsityPattern(true);
+    solver_locked->LockSparsityPattern(true);
+    solver_unlocked->LockSparsityPattern(false);
+
+    Chain chain_lu(solver_lu, 10);
+    Chain chain_locked(solver_locked, 10);
+    Chain chain_unlocked(solver_unlocked, 10);
+
+    int num_steps = 50;
+    for (int i = 0; i < num_steps; i++) {
+        chain_lu.sys.DoStepDynamics(1e-3);
+        chain_locked.sys.DoStepDynamics(1e-3);
+        chain_unlocked.sys.DoStepDynamics(1e-3);
+    }
+
+    // Locked pattern: a single analysis; unlocked pattern: one analysis per Setup
+    EXPECT_EQ(solver_locked->GetNumAnalysisCalls(), 1);
+    EXPECT_EQ(solver_unlocked->GetNumAnalysisCalls(), solver_unlocked->GetNumSetupCalls());
+    EXPECT_EQ(solver_unlocked->GetNumSetupCalls(), num_steps);
+    EXPECT_LT(MaxDiff(chain_lu, chain_locked), 1e-10);
+    EXPECT_LT(MaxDiff(chain_lu, chain_unlocked), 1e-10);
+
+    // Change the problem (and therefore the sparsity pattern): the analysis is redone once
+    chain_lu.AddBody();
+    chain_locked.AddBody();
+    solver_lu->ForceSparsityPatternUpdate();
+    solver_locked->ForceSparsityPatternUpdate();
+    for (int i = 0; i < num_steps; i++) {
+        chain_lu.sys.DoStepDynamics(1e-3);
+        chain_locked.sys.DoStepDynamics(1e-3);
+    }
+
+    EXPECT_EQ(solver_locked->GetNumAnalysisCalls(), 2);
+    EXPECT_LT(MaxDiff(chain_lu, chain_locked), 1e-10);
+}
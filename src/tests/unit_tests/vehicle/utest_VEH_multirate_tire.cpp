@@ -0,0 +1,220 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Test for the multi-rate integration of deformable tires.
+// A loaded wheel with an ANCF toroidal tire, free to move only vertically, is
+// dropped on a rigid terrain patch and allowed to settle. This is done with the
+// tire simulated in the vehicle system (single-rate) and in a separate system
+// advanced with a smaller step size (multi-rate). In both cases, the vertical
+// tire force must balance the wheel load, and the two simulations must agree,
+// also for a wheel with a nonzero offset from the spindle center.
+// For the multi-rate tire, the motion of the rim body over a vehicle step must
+// follow the state of the wheel spindle at the beginning of that step.
+//
+// =============================================================================
+
+#include "gtest/gtest.h"
+
+#include "chrono/physics/ChLinkLock.h"
+#include "chrono/physics/ChSystemSMC.h"
+#include "chrono/solver/ChDirectSolverLS.h"
+
+#include "chrono_vehicle/terrain/RigidTerrain.h"
+#include "chrono_vehicle/wheeled_vehicle/ChWheel.h"
+#include "chrono_vehicle/wheeled_vehicle/tire/ANCFToroidalTire.h"
+
+using namespace chrono;
+using namespace chrono::vehicle;
+
+class TestWheel : public ChWheel {
+  public:
+    TestWheel() : ChWheel("wheel") {}
+    virtual double GetMass() const override { return 10; }
+    virtual ChVector<> GetInertia() const override { return ChVector<>(0.5, 1, 0.5); }
+};
+
+// Wheel with a deformable tire, attached to the ground through a vertical prismatic joint.
+struct TireRig {
+    TireRig(bool multirate, double step, double tire_step, double offset = 0);
+
+    // Advance the rig by one step, in the same order as a wheeled vehicle simulation.
+    void Advance();
+
+    // Vertical force exerted by the tire on the wheel spindle.
+    // For a multi-rate tire, this is the force applied to the spindle at the last synchronization.
+    double GetTireForce() const;
+
+    // Moment exerted by the tire on the wheel spindle, about the spindle center.
+    ChVector<> GetTireMoment() const;
+
+    bool multirate;
+    double step;
+    ChSystemSMC sys;
+    std::shared_ptr<ChBody> spindle;
+    std::shared_ptr<TestWheel> wheel;
+    std::shared_ptr<ANCFToroidalTire> tire;
+    std::shared_ptr<RigidTerrain> terrain;
+};
+
+const double spindle_mass = 150;
+const double gravity = 9.81;
+
+TireRig::TireRig(bool multirate, double step, double tire_step, double offset) : multirate(multirate), step(step) {
+    sys.Set_G_acc(ChVector<>(0, 0, -gravity));
+    sys.SetSolver(chrono_types::make_shared<ChSolverSparseLU>());
+    sys.SetTimestepperType(ChTimestepper::Type::EULER_IMPLICIT_LINEARIZED);
+    sys.SetContactForceModel(ChSystemSMC::ContactForceModel::Hooke);
+    sys.UseMaterialProperties(false);
+
+    auto ground = chrono_types::make_shared<ChBody>();
+    ground->SetBodyFixed(true);
+    sys.AddBody(ground);
+
+    spindle = chrono_types::make_shared<ChBody>();
+    spindle->SetMass(spindle_mass);
+    spindle->SetInertiaXX(ChVector<>(1, 1, 1));
+    spindle->SetPos(ChVector<>(0, 0, 0.52));
+    sys.AddBody(spindle);
+
+    auto prismatic = chrono_types::make_shared<ChLinkLockPrismatic>();
+    prismatic->Initialize(ground, spindle, ChCoordsys<>(ChVector<>(0, 0, 0.5), QUNIT));
+    sys.AddLink(prismatic);
+
+    wheel = chrono_types::make_shared<TestWheel>();
+    wheel->Initialize(spindle, LEFT, offset);
+
+    auto mat = chrono_types::make_shared<ChMaterialSurfaceSMC>();
+    mat->SetKn(2e5f);
+    mat->SetGn(2000);
+    mat->SetFriction(0.8f);
+
+    tire = chrono_types::make_shared<ANCFToroidalTire>("tire");
+    tire->SetRimRadius(0.35);
+    tire->SetHeight(0.15);
+    tire->SetThickness(0.015);
+    tire->SetDivCircumference(12);
+    tire->SetDivWidth(2);
+    tire->SetPressure(320e3);
+    tire->SetAlpha(0.15);
+    tire->SetContactMaterial(mat);
+    tire->SetContactSurfaceType(ChDeformableTire::NODE_CLOUD);
+    tire->SetContactNodeRadius(0.01);
+    tire->EnableMultirate(multirate);
+    tire->SetStepsize(tire_step);
+    wheel->SetTire(tire);
+    std::static_pointer_cast<ChTire>(tire)->Initialize(wheel);
+
+    terrain = chrono_types::make_shared<RigidTerrain>(&sys);
+    terrain->AddPatch(mat, ChVector<>(0, 0, 0), ChVector<>(0, 0, 1), 4, 4);
+    terrain->Initialize();
+}
+
+void TireRig::Advance() {
+    double time = sys.GetChTime();
+    terrain->Synchronize(time);
+    tire->Synchronize(time, *terrain);
+    spindle->Empty_forces_accumulators();
+    wheel->Synchronize();
+    terrain->Advance(step);
+    tire->Advance(step);
+    sys.DoStepDynamics(step);
+}
+
+double TireRig::GetTireForce() const {
+    return multirate ? spindle->Get_accumulated_force().z() : tire->ReportTireForce(terrain.get()).force.z();
+}
+
+ChVector<> TireRig::GetTireMoment() const {
+    // The spindle orientation is fixed, so the accumulated torque (in the spindle frame) is also the global one
+    return multirate ? spindle->Get_accumulated_torque() : tire->ReportTireForce(terrain.get()).moment;
+}
+
+// Let a loaded wheel settle with a single-rate and a multi-rate tire and compare the tire forces.
+static void CheckStaticLoad(double offset) {
+    double step = 1e-3;
+    TireRig single(false, step, step, offset);
+    TireRig multi(true, step, step / 4, offset);
+
+    for (int i = 0; i < 1000; i++) {
+        single.Advance();
+        multi.Advance();
+    }
+
+    // The wheel mass is added to the spindle at wheel initialization
+    double load = single.spindle->GetMass() * gravity;
+    double f_single = single.GetTireForce();
+    double f_multi = multi.GetTireForce();
+    EXPECT_NEAR(f_single, load, 0.05 * load);
+    EXPECT_NEAR(f_multi, load, 0.05 * load);
+    EXPECT_NEAR(f_multi, f_single, 0.01 * load);
+    EXPECT_NEAR(multi.spindle->GetPos().z(), single.spindle->GetPos().z(), 2e-3);
+    EXPECT_NEAR(multi.spindle->GetPos_dt().z(), 0, 1e-2);
+}
+
+TEST(ChDeformableTire, multirate_static_load) {
+    CheckStaticLoad(0);
+}
+
+TEST(ChDeformableTire, multirate_wheel_offset) {
+    CheckStaticLoad(0.1);
+
+    // The tire mesh is attached to the spindle, so the moment applied to the spindle by a multi-rate tire must not
+    // depend on the wheel offset (in particular, it must not include an offset x load torque).
+    double step = 1e-3;
+    TireRig centered(true, step, step / 4, 0);
+    TireRig offset(true, step, step / 4, 0.1);
+
+    for (int i = 0; i < 1000; i++) {
+        centered.Advance();
+        offset.Advance();
+    }
+
+    double load = centered.spindle->GetMass() * gravity;
+    EXPECT_NEAR((offset.GetTireMoment() - centered.GetTireMoment()).Length(), 0, 1e-6 * load);
+}
+
+TEST(ChDeformableTire, multirate_rim_motion) {
+    // The spindle is moved with prescribed (non-uniform) linear and angular velocities, without feedback of the tire
+    // force, so that the rim motion over each step can be compared with the spindle state at the beginning of the step.
+    double step = 1e-3;
+    TireRig multi(true, step, step / 4);
+
+    auto& bodies = multi.tire->GetMultirateSystem()->Get_bodylist();
+    ASSERT_EQ(bodies.size(), 2);
+    auto rim = bodies[1];
+    ASSERT_FALSE(rim->GetBodyFixed());
+
+    double time = 0;
+    for (int i = 0; i < 20; i++) {
+        multi.spindle->SetPos_dt(ChVector<>(0.5 + 0.1 * i, 0, 0.01 * i));
+        multi.spindle->SetWvel_loc(ChVector<>(0, -1 - 0.2 * i, 0.05 * i));
+        ChFrameMoving<> start = *multi.spindle;
+
+        multi.tire->Synchronize(time, *multi.terrain);
+        multi.tire->Advance(step);
+        time += step;
+
+        // The rim moves with the linear and angular velocities of the spindle at the beginning of the step
+        ChQuaternion<> drot;
+        drot.Q_from_Rotv(start.GetWvel_loc() * step);
+        EXPECT_NEAR((rim->GetPos() - (start.GetPos() + start.GetPos_dt() * step)).Length(), 0, 1e-10);
+        EXPECT_NEAR((rim->GetRot() - start.GetRot() * drot).Length(), 0, 1e-10);
+        EXPECT_NEAR((rim->GetPos_dt() - start.GetPos_dt()).Length(), 0, 1e-10);
+        EXPECT_NEAR((rim->GetWvel_par() - start.GetWvel_par()).Length(), 0, 1e-10);
+        EXPECT_NEAR(multi.tire->GetMultirateSystem()->GetChTime(), time, 1e-12);
+
+        multi.spindle->SetPos(rim->GetPos());
+        multi.spindle->SetRot(rim->GetRot());
+    }
+}
@@ -0,0 +1,159 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Test for the terrain queries on RigidTerrain mesh patches.
+// A mesh patch is created from a tilted roof-shaped mesh (two planar faces
+// meeting at a ridge, triangulated on a regular grid), translated and rotated
+// about the vertical. The height and normal reported by the terrain must match
+// the analytic values at points inside the triangles, on triangle edges and
+// vertices, and on the ridge. Points outside the mesh (including points inside
+// the bounding box of the rotated mesh) must not be found on the terrain.
+//
+// =============================================================================
+
+#include <cmath>
+#include <fstream>
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "chrono/physics/ChSystemNSC.h"
+#include "chrono_vehicle/terrain/RigidTerrain.h"
+
+using namespace chrono;
+using namespace chrono::vehicle;
+
+// Roof-shaped surface in the patch frame, over [0,4] x [0,3], with the ridge at x = 2.
+// The mesh vertices are exactly representable in single precision.
+static double RoofHeight(double x, double y) {
+    return 0.5 - 0.25 * std::abs(x - 2) + 0.125 * y;
+}
+
+// Write the roof mesh in a Wavefront OBJ file. Each grid cell is split in two triangles along its diagonal.
+static void WriteRoofMesh(const std::string& filename) {
+    std::ofstream obj(filename);
+    for (int j = 0; j <= 3; j++) {
+        for (int i = 0; i <= 4; i++)
+            obj << "v " << i << " " << j << " " << RoofHeight(i, j) << "\n";
+    }
+    for (int j = 0; j < 3; j++) {
+        for (int i = 0; i < 4; i++) {
+            int v0 = j * 5 + i + 1;
+            obj << "f " << v0 << " " << v0 + 1 << " " << v0 + 6 << "\n";
+            obj << "f " << v0 << " " << v0 + 6 << " " << v0 + 5 << "\n";
+        }
+    }
+}
+
+class RigidTerrainTest : public ::testing::Test {
+  protected:
+    RigidTerrainTest();
+
+    // Transform a point given in the patch frame (horizontal coordinates) into a query point above the terrain.
+    ChVector<> QueryPoint(double x, double y) const { return m_frame.TransformPointLocalToParent(ChVector<>(x, y, 10)); }
+
+    // Check the height and normal at the query point above the specified point (patch frame).
+    // Points on the ridge may report the normal of either face.
+    void Check(double x, double y) const;
+
+    ChSystemNSC m_sys;
+    RigidTerrain m_terrain;
+    ChFrame<> m_frame;
+};
+
+RigidTerrainTest::RigidTerrainTest() : m_terrain(&m_sys), m_frame(ChVector<>(1, 2, 0.3), Q_from_AngZ(0.4)) {
+    WriteRoofMesh("rigid_terrain_roof.obj");
+
+    auto mat = chrono_types::make_shared<ChMaterialSurfaceNSC>();
+    mat->SetFriction(0.7f);
+    m_terrain.AddPatch(mat, m_frame.GetCoord(), "rigid_terrain_roof.obj", "roof", 0, false);
+    m_terrain.Initialize();
+}
+
+void RigidTerrainTest::Check(double x, double y) const {
+    ChVector<> loc = QueryPoint(x, y);
+    double height = m_terrain.GetHeight(loc);
+    ChVector<> normal = m_terrain.GetNormal(loc);
+    EXPECT_NEAR(height, RoofHeight(x, y) + 0.3, 1e-12) << "x = " << x << "  y = " << y;
+
+    ChVector<> n_left = m_frame.TransformDirectionLocalToParent(ChVector<>(-0.25, -0.125, 1).GetNormalized());
+    ChVector<> n_right = m_frame.TransformDirectionLocalToParent(ChVector<>(0.25, -0.125, 1).GetNormalized());
+    if (x < 2)
+        EXPECT_NEAR((normal - n_left).Length(), 0, 1e-12) << "x = " << x << "  y = " << y;
+    else if (x > 2)
+        EXPECT_NEAR((normal - n_right).Length(), 0, 1e-12) << "x = " << x << "  y = " << y;
+    else
+        EXPECT_NEAR(std::min((normal - n_left).Length(), (normal - n_right).Length()), 0, 1e-12) << "y = " << y;
+
+    // Combined query
+    double p_height;
+    ChVector<> p_normal;
+    float p_friction;
+    m_terrain.GetProperties(loc, p_height, p_normal, p_friction);
+    EXPECT_EQ(p_height, height);
+    EXPECT_EQ(p_normal, normal);
+    EXPECT_FLOAT_EQ(p_friction, 0.7f);
+}
+
+TEST_F(RigidTerrainTest, inside) {
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> dx(0, 4);
+    std::uniform_real_distribution<double> dy(0, 3);
+    for (int i = 0; i < 1000; i++)
+        Check(dx(gen), dy(gen));
+}
+
+TEST_F(RigidTerrainTest, edges) {
+    for (int k = 0; k <= 40; k++) {
+        double t = k / 40.0;
+        // Grid lines (triangle edges parallel to the x and y axes), including the mesh boundary and the ridge
+        for (int i = 0; i <= 4; i++)
+            Check(i, 3 * t);
+        for (int j = 0; j <= 3; j++)
+            Check(4 * t, j);
+        // Cell diagonals
+        for (int j = 0; j < 3; j++) {
+            for (int i = 0; i < 4; i++)
+                Check(i + t, j + t);
+        }
+    }
+}
+
+TEST_F(RigidTerrainTest, outside) {
+    double eps = 1e-3;
+    std::vector<ChVector<>> points = {QueryPoint(-eps, 1.5), QueryPoint(4 + eps, 1.5), QueryPoint(2, -eps),
+                                      QueryPoint(2, 3 + eps), QueryPoint(-eps, -eps),  QueryPoint(4 + eps, 3 + eps),
+                                      QueryPoint(-1, 4),      QueryPoint(100, 100)};
+
+    // The first 4 points lie inside the horizontal bounding box of the rotated mesh
+    for (const auto& loc : points) {
+        double height;
+        ChVector<> normal;
+        float friction;
+        EXPECT_FALSE(m_terrain.FindPoint(loc, height, normal, friction)) << loc;
+        EXPECT_EQ(m_terrain.GetHeight(loc), 0);
+        EXPECT_EQ(m_terrain.GetNormal(loc), ChVector<>(0, 0, 1));
+    }
+
+    // Batch query, with points inside and outside the mesh
+    points.push_back(QueryPoint(1.5, 1.5));
+    std::vector<double> heights;
+    std::vector<ChVector<>> normals;
+    std::vector<float> frictions;
+    m_terrain.GetProperties(points, heights, normals, frictions);
+    ASSERT_EQ(heights.size(), points.size());
+    for (size_t i = 0; i < points.size() - 1; i++)
+        EXPECT_EQ(heights[i], 0);
+    EXPECT_NEAR(heights.back(), RoofHeight(1.5, 1.5) + 0.3, 1e-12);
+}
@@ -0,0 +1,126 @@
+// =============================================================================
+// PROJECT CHRONO - http://projectchrono.org
+//
+// Copyright (c) 2020 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution and at
+// http://projectchrono.org/license-chrono.txt.
+//
+// =============================================================================
+// Authors: Radu Serban
+// =============================================================================
+//
+// Test for the structured-grid storage mode of SCMDeformableTerrain.
+// A rigid box is dropped, with a horizontal velocity, on flat SCM soil
+// represented once with a regular mesh and once with a grid of the same
+// spacing. The contact forces on the box, its motion, and the final soil
+// heights must be the same in both cases, with and without bulldozing of the
+// displaced soil.
+//
+// =============================================================================
+
+#include <cmath>
+#include <map>
+#include <utility>
+
+#include "gtest/gtest.h"
+
+#include "chrono/physics/ChBodyEasy.h"
+#include "chrono/physics/ChSystemSMC.h"
+#include "chrono_vehicle/terrain/SCMDeformableTerrain.h"
+
+using namespace chrono;
+using namespace chrono::vehicle;
+
+// Box on SCM soil, with the soil stored as a mesh or as a grid.
+class BoxOnSoil {
+  public:
+    BoxOnSoil(bool grid, bool bulldozing);
+
+    // Soil heights at the vertices of the terrain visualization mesh, indexed by grid node.
+    std::map<std::pair<long, long>, double> Heights() const;
+
+    double delta;
+    ChSystemSMC sys;
+    std::shared_ptr<ChBody> box;
+    std::shared_ptr<SCMDeformableTerrain> terrain;
+};
+
+BoxOnSoil::BoxOnSoil(bool grid, bool bulldozing) {
+    const double size = 2;
+    const int div = 40;
+    delta = size / div;
+
+    sys.Set_G_acc(ChVector<>(0, 0, -9.81));
+
+    auto mat = chrono_types::make_shared<ChMaterialSurfaceSMC>();
+    box = chrono_types::make_shared<ChBodyEasyBox>(0.4, 0.3, 0.2, 1000, false, true, mat);
+    box->SetPos(ChVector<>(-0.2, 0.1, 0.11));
+    box->SetRot(Q_from_AngZ(0.2));
+    box->SetPos_dt(ChVector<>(0.5, 0, 0));
+    sys.AddBody(box);
+
+    terrain = chrono_types::make_shared<SCMDeformableTerrain>(&sys);
+    terrain->SetSoilParameters(0.2e6, 0, 1.1, 0, 30, 0.01, 4e7, 3e4);
+    if (bulldozing) {
+        // Use non-default numbers of erosion iterations and propagations (both affect the soil heights for this angle
+        // of repose)
+        terrain->SetBulldozingFlow(true);
+        terrain->SetBulldozingParameters(10, 1.4, 2, 2);
+    }
+    if (grid)
+        terrain->InitializeGrid(0, size, size, delta);
+    else
+        terrain->Initialize(0, size, size, div, div);
+}
+
+std::map<std::pair<long, long>, double> BoxOnSoil::Heights() const {
+    std::map<std::pair<long, long>, double> heights;
+    for (const auto& v : terrain->GetMesh()->GetMesh()->getCoordsVertices())
+        heights[std::make_pair(std::lround(v.x() / delta), std::lround(v.y() / delta))] = v.z();
+    return heights;
+}
+
+static void CompareGridMesh(bool bulldozing) {
+    BoxOnSoil mesh(false, bulldozing);
+    BoxOnSoil grid(true, bulldozing);
+
+    double step = 1e-3;
+    for (int i = 0; i < 200; i++) {
+        mesh.sys.DoStepDynamics(step);
+        grid.sys.DoStepDynamics(step);
+
+        TerrainForce f_mesh = mesh.terrain->GetContactForce(mesh.box);
+        TerrainForce f_grid = grid.terrain->GetContactForce(grid.box);
+        double scale = 1e-6 * (1 + f_mesh.force.Length());
+        ASSERT_NEAR((f_mesh.force - f_grid.force).Length(), 0, scale) << "step " << i;
+        ASSERT_NEAR((f_mesh.moment - f_grid.moment).Length(), 0, scale) << "step " << i;
+    }
+
+    // The box must have sunk in the soil and slid
+    EXPECT_LT(mesh.box->GetPos().z(), 0.1);
+    EXPECT_GT(mesh.box->GetPos().x(), -0.2);
+
+    EXPECT_NEAR((mesh.box->GetPos() - grid.box->GetPos()).Length(), 0, 1e-9);
+    EXPECT_NEAR((mesh.box->GetRot() - grid.box->GetRot()).Length(), 0, 1e-9);
+    EXPECT_NEAR((mesh.box->GetPos_dt() - grid.box->GetPos_dt()).Length(), 0, 1e-9);
+
+    // The grid visualization mesh only covers the tiles created so far; all its vertices must be on the regular mesh
+    auto h_mesh = mesh.Heights();
+    auto h_grid = grid.Heights();
+    for (const auto& h : h_grid) {
+        auto itr = h_mesh.find(h.first);
+        ASSERT_TRUE(itr != h_mesh.end()) << "node " << h.first.first << " " << h.first.second;
+        EXPECT_NEAR(itr->second, h.second, 1e-9) << "node " << h.first.first << " " << h.first.second;
+    }
+}
+
+TEST(SCMDeformableTerrain, grid_vs_mesh) {
+    CompareGridMesh(false);
+}
+
+TEST(SCMDeformableTerrain, grid_vs_mesh_bulldozing) {
+    CompareGridMesh(true);
+}